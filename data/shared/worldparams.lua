@@ -12,3 +12,7 @@ mountainNoiseLacunarity = 0.3
 mountainNoiseFrequency = 0.00075
 mountainNoiseGain = 0.5
 
+-- the server loads or generates the chunks around these world positions before a map is marked ready
+-- preload = {
+-- 	{ x = 0, z = 0, radius = 1 },
+-- }
@@ -3,7 +3,10 @@
  */
 
 #include "AnimationCache.h"
+#include "app/App.h"
 #include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/concurrent/ThreadPool.h"
 
 namespace animation {
 
@@ -16,33 +19,61 @@ bool AnimationCache::init() {
 }
 
 void AnimationCache::shutdown() {
+	core::DynamicArray<std::shared_future<AnimationModelPtr>> pending;
+	{
+		core::ScopedLock lock(_modelLock);
+		pending.reserve(_pendingModels.size());
+		for (const auto& e : _pendingModels) {
+			pending.push_back(e->value);
+		}
+	}
+	for (const std::shared_future<AnimationModelPtr>& future : pending) {
+		future.wait();
+	}
+	clearModels();
+	core::ScopedLock lock(_meshLock);
 	_meshCache->shutdown();
 }
 
-const voxel::Mesh* AnimationCache::getMesh(const char *fullPath) {
+voxelformat::MeshPtr AnimationCache::getMesh(const char *fullPath) {
+	core::ScopedLock lock(_meshLock);
 	return _meshCache->getMesh(fullPath);
 }
 
 bool AnimationCache::removeMesh(const char *fullPath) {
+	clearModels();
+	core::ScopedLock lock(_meshLock);
 	return _meshCache->removeMesh(fullPath);
 }
 
 bool AnimationCache::putMesh(const char* fullPath, const voxel::Mesh& mesh) {
 	removeMesh(fullPath);
-	return getMesh(fullPath) != nullptr;
+	return (bool)getMesh(fullPath);
+}
+
+void AnimationCache::clearModels() {
+	core::ScopedLock lock(_modelLock);
+	_models.clear();
+	_pendingModels.clear();
+	++_modelGeneration;
+}
+
+size_t AnimationCache::models() const {
+	core::ScopedLock lock(_modelLock);
+	return _models.size();
 }
 
-bool AnimationCache::load(const core::String& filename, size_t meshIndex, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES]) {
+bool AnimationCache::load(const core::String& filename, size_t meshIndex, voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES]) {
 	meshes[meshIndex] = getMesh(filename.c_str());
-	return meshes[meshIndex] != nullptr;
+	return (bool)meshes[meshIndex];
 }
 
-bool AnimationCache::getMeshes(const AnimationSettings& settings, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES],
-		const std::function<bool(const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES])>& loadAdditional) {
+bool AnimationCache::getMeshes(const AnimationSettings& settings, voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES],
+		const LoadAdditional& loadAdditional) {
 	int cnt = 0;
 	for (size_t i = 0; i < AnimationSettings::MAX_ENTRIES; ++i) {
 		if (settings.paths[i].empty()) {
-			meshes[i] = nullptr;
+			meshes[i] = voxelformat::MeshPtr();
 			continue;
 		}
 		const core::String& fullPath = settings.fullPath(i);
@@ -63,8 +94,8 @@ bool AnimationCache::getMeshes(const AnimationSettings& settings, const voxel::M
 }
 
 bool AnimationCache::getModel(const AnimationSettings& settings, const char *fullPath, BoneId boneId, Vertices& vertices, Indices& indices) {
-	const voxel::Mesh* mesh = getMesh(fullPath);
-	if (mesh == nullptr) {
+	const voxelformat::MeshPtr& mesh = getMesh(fullPath);
+	if (!mesh) {
 		return false;
 	}
 
@@ -91,9 +122,79 @@ bool AnimationCache::getModel(const AnimationSettings& settings, const char *ful
 	return true;
 }
 
-bool AnimationCache::getBoneModel(const AnimationSettings& settings, Vertices& vertices, Indices& indices,
-		const std::function<bool(const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES])>& loadAdditional) {
-	const voxel::Mesh* meshes[AnimationSettings::MAX_ENTRIES] {};
+core::String AnimationCache::modelKey(const AnimationSettings& settings) {
+	core::String key = AnimationSettings::TypeStrings[core::enumVal(settings.type())];
+	for (size_t i = 0; i < AnimationSettings::MAX_ENTRIES; ++i) {
+		if (settings.paths[i].empty()) {
+			continue;
+		}
+		key += core::string::format("|%i:%s", (int)i, settings.fullPath(i).c_str());
+		const BoneIds& bids = settings.boneIds(i);
+		for (uint8_t b = 0u; b < bids.num; ++b) {
+			key += core::string::format(":%i,%i,%i", (int)core::enumVal(bids.bones[b]),
+					(int)settings.mapBoneIdToArrayIndex(bids.bones[b]), bids.mirrored[b] ? 1 : 0);
+		}
+	}
+	return key;
+}
+
+AnimationModelPtr AnimationCache::assembleModel(const core::String& key, const AnimationSettings& settings,
+		const LoadAdditional& loadAdditional, uint32_t generation) {
+	core_trace_scoped(AssembleAnimationModel);
+	const std::shared_ptr<AnimationModel>& model = std::make_shared<AnimationModel>();
+	const bool success = assemble(settings, model->vertices, model->indices, loadAdditional);
+	core::ScopedLock lock(_modelLock);
+	if (generation == _modelGeneration) {
+		if (success) {
+			_models.put(key, model);
+		}
+		_pendingModels.remove(key);
+	}
+	if (!success) {
+		return AnimationModelPtr();
+	}
+	return model;
+}
+
+std::shared_future<AnimationModelPtr> AnimationCache::getBoneModelAsync(const AnimationSettings& settings, const LoadAdditional& loadAdditional) {
+	const core::String& key = modelKey(settings);
+	uint32_t generation;
+	{
+		core::ScopedLock lock(_modelLock);
+		AnimationModelPtr model;
+		if (_models.get(key, model)) {
+			std::promise<AnimationModelPtr> promise;
+			promise.set_value(model);
+			return promise.get_future().share();
+		}
+		std::shared_future<AnimationModelPtr> pending;
+		if (_pendingModels.get(key, pending)) {
+			return pending;
+		}
+		generation = _modelGeneration;
+		// the worker blocks on the model lock until the future was registered
+		std::future<AnimationModelPtr> future = app::App::getInstance()->threadPool().enqueue([=] () {
+			return assembleModel(key, settings, loadAdditional, generation);
+		});
+		if (future.valid()) {
+			pending = future.share();
+			_pendingModels.put(key, pending);
+			return pending;
+		}
+	}
+	// the thread pool was already shut down
+	std::promise<AnimationModelPtr> promise;
+	promise.set_value(assembleModel(key, settings, loadAdditional, generation));
+	return promise.get_future().share();
+}
+
+AnimationModelPtr AnimationCache::getBoneModel(const AnimationSettings& settings, const LoadAdditional& loadAdditional) {
+	return getBoneModelAsync(settings, loadAdditional).get();
+}
+
+bool AnimationCache::assemble(const AnimationSettings& settings, Vertices& vertices, Indices& indices,
+		const LoadAdditional& loadAdditional) {
+	voxelformat::MeshPtr meshes[AnimationSettings::MAX_ENTRIES];
 	getMeshes(settings, meshes, loadAdditional);
 
 	vertices.clear();
@@ -104,8 +205,8 @@ bool AnimationCache::getBoneModel(const AnimationSettings& settings, Vertices& v
 	int meshCount = 0;
 	// merge everything into one buffer
 	for (size_t i = 0; i < AnimationSettings::MAX_ENTRIES; ++i) {
-		const voxel::Mesh *mesh = meshes[i];
-		if (mesh == nullptr) {
+		const voxelformat::MeshPtr& mesh = meshes[i];
+		if (!mesh) {
 			continue;
 		}
 		const BoneIds& bids = settings.boneIds(i);
@@ -9,34 +9,77 @@
 #include "core/Assert.h"
 #include "Vertex.h"
 #include "core/String.h"
+#include "core/Trace.h"
+#include "core/collection/StringMap.h"
+#include "core/concurrent/Lock.h"
+#include <future>
 #include <memory>
 
 namespace animation {
 
+/**
+ * @brief The assembled vertices and indices of all the meshes of an @c AnimationEntity
+ * @note Shared between all entities with the same parts and bone mapping - never modified after it was assembled
+ * @ingroup Animation
+ */
+struct AnimationModel {
+	Vertices vertices;
+	Indices indices;
+};
+
+using AnimationModelPtr = std::shared_ptr<const AnimationModel>;
+
 /**
  * @brief Cache @c voxel::Mesh instances for @c AnimationEntity
  * @ingroup Animation
  */
 class AnimationCache : public core::IComponent {
+public:
+	using LoadAdditional = std::function<bool(voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES])>;
+
 protected:
 	/**
 	 * @brief Load from cache or file and extract the mesh
 	 */
-	bool load(const core::String& filename, size_t meshIndex, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES]);
+	bool load(const core::String& filename, size_t meshIndex, voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES]);
 
 	/**
 	 * @brief Load and cache the voxel meshes that are needed to assmble the model as
 	 * defined by the given AnimationSettings
 	 */
-	bool getMeshes(const AnimationSettings& settings, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES],
-			const std::function<bool(const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES])>& loadAdditional = {});
+	bool getMeshes(const AnimationSettings& settings, voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES],
+			const LoadAdditional& loadAdditional = {});
+
+	/**
+	 * @brief Map the bone indices to the vertices of the mesh and fill the vertex indices
+	 */
+	bool assemble(const AnimationSettings& settings, Vertices& vertices, Indices& indices, const LoadAdditional& loadAdditional);
+
+	/**
+	 * @brief The models are keyed by the settings type, the mesh paths and the bone mapping - this is everything
+	 * the assembled vertices depend on
+	 */
+	static core::String modelKey(const AnimationSettings& settings);
+	void clearModels();
+	AnimationModelPtr assembleModel(const core::String& key, const AnimationSettings& settings,
+			const LoadAdditional& loadAdditional, uint32_t generation);
 
 	voxelformat::MeshCachePtr _meshCache;
+	// the meshes are loaded from the worker threads that assemble the models
+	core_trace_mutex(core::Lock, _meshLock, "AnimationMeshCache");
+	core_trace_mutex(mutable core::Lock, _modelLock, "AnimationModelCache");
+	core::StringMap<AnimationModelPtr> _models;
+	core::StringMap<std::shared_future<AnimationModelPtr>> _pendingModels;
+	// models that were assembled for meshes that were modified in the meantime are not cached
+	uint32_t _modelGeneration = 0u;
 
 public:
 	AnimationCache(const voxelformat::MeshCachePtr& meshCache);
 
-	const voxel::Mesh* getMesh(const char *fullPath);
+	/**
+	 * @return The cached mesh - it stays valid even if it is removed from the cache in the meantime
+	 */
+	voxelformat::MeshPtr getMesh(const char *fullPath);
 	bool removeMesh(const char *fullPath);
 	bool putMesh(const char* fullPath, const voxel::Mesh& mesh);
 	bool init() override;
@@ -48,10 +91,24 @@ public:
 	bool getModel(const AnimationSettings& settings, const char *fullPath, BoneId boneId, Vertices& vertices, Indices& indices);
 
 	/**
-	 * @brief Map the bone indices to the vertices of the mesh and fill the vertex indices
+	 * @brief Get the shared model for the given settings - a new combination of meshes and bones is assembled on
+	 * the app thread pool.
+	 * @note The @c loadAdditional callback is executed on a worker thread and must stay valid until the future is ready.
+	 * The meshes it adds are not part of the cache key - they may only depend on the settings type.
+	 * @note Don't wait for the future from a thread pool worker
+	 */
+	std::shared_future<AnimationModelPtr> getBoneModelAsync(const AnimationSettings& settings, const LoadAdditional& loadAdditional = {});
+
+	/**
+	 * @brief Blocking version of @c getBoneModelAsync()
+	 * @return @c nullptr if the model could not get assembled
+	 */
+	AnimationModelPtr getBoneModel(const AnimationSettings& settings, const LoadAdditional& loadAdditional = {});
+
+	/**
+	 * @return The amount of assembled models in the cache
 	 */
-	bool getBoneModel(const AnimationSettings& settings, Vertices& vertices, Indices& indices,
-			const std::function<bool(const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES])>& loadAdditional = {});
+	size_t models() const;
 };
 
 using AnimationCachePtr = std::shared_ptr<AnimationCache>;
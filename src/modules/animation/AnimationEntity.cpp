@@ -15,7 +15,7 @@ bool AnimationEntity::updateAABB() {
 	skeleton().update(_settings, bones);
 	_aabb.setLowerCorner(glm::vec3(0.0f));
 	_aabb.setUpperCorner(glm::vec3(0.0f));
-	for (const auto& v : _vertices) {
+	for (const auto& v : vertices()) {
 		const glm::vec4& p = bones[v.boneId] * glm::vec4(v.pos, 1.0f);
 		_aabb.accumulate(p.x, p.y, p.z);
 	}
@@ -52,7 +52,48 @@ bool AnimationEntity::init(const AnimationCachePtr& cache, const core::String& l
 		Log::error("Could not set animation type");
 	}
 	setAnimation(animation::Animation::IDLE, false);
-	return updateAABB();
+	// the aabb is updated once the model is ready
+	return pollModel() || modelPending();
+}
+
+void AnimationEntity::requestModel(const AnimationCachePtr& cache, const AnimationCache::LoadAdditional& loadAdditional) {
+	_model = AnimationModelPtr();
+	_vertices.clear();
+	_indices.clear();
+	++_meshRevision;
+	_pendingModel = cache->getBoneModelAsync(_settings, loadAdditional);
+}
+
+bool AnimationEntity::pollModel() {
+	if (!_pendingModel.valid()) {
+		return (bool)_model;
+	}
+	if (_pendingModel.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return false;
+	}
+	_model = _pendingModel.get();
+	_pendingModel = std::shared_future<AnimationModelPtr>();
+	if (!_model) {
+		Log::warn("Failed to assemble the model");
+		return false;
+	}
+	++_meshRevision;
+	onModelReady();
+	if (!updateAABB()) {
+		Log::warn("Invalid aabb for the model");
+	}
+	return true;
+}
+
+bool AnimationEntity::waitForModel() {
+	if (_pendingModel.valid()) {
+		_pendingModel.wait();
+	}
+	return pollModel();
+}
+
+bool AnimationEntity::modelPending() const {
+	return _pendingModel.valid();
 }
 
 const math::AABB<float>& AnimationEntity::aabb() const {
@@ -79,13 +120,34 @@ void AnimationEntity::setAnimation(Animation animation, bool reset) {
 }
 
 const Vertices& AnimationEntity::vertices() const {
+	if (_model && _vertices.empty()) {
+		return _model->vertices;
+	}
 	return _vertices;
 }
 
 const Indices& AnimationEntity::indices() const {
+	if (_model && _indices.empty()) {
+		return _model->indices;
+	}
 	return _indices;
 }
 
+AnimationModelPtr AnimationEntity::sharedModel() const {
+	if (_vertices.empty()) {
+		return _model;
+	}
+	return AnimationModelPtr();
+}
+
+uint32_t AnimationEntity::meshRevision() const {
+	return _meshRevision;
+}
+
+size_t AnimationEntity::instanceMemory() const {
+	return _vertices.capacity() * sizeof(Vertex) + _indices.capacity() * sizeof(IndexType) + _lua.memoryInUse();
+}
+
 AnimationSettings& AnimationEntity::animationSettings() {
 	return _settings;
 }
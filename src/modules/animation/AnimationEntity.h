@@ -21,16 +21,23 @@ namespace animation {
 using AnimationTimes = core::Array<double, core::enumVal(Animation::MAX) + 1>;
 
 /**
- * Base class for animated entities that holds the vertices and indices
- * of the model
+ * Base class for animated entities that references the shared model and holds
+ * the per instance animation state
  * @ingroup Animation
  */
 class AnimationEntity {
 protected:
 	AnimationTimes _animationTimes;
 	AnimationSettings _settings;
+	// the shared model as assembled by the AnimationCache
+	AnimationModelPtr _model;
+	// the model that is still assembled on a worker thread - nothing is rendered until it is ready
+	std::shared_future<AnimationModelPtr> _pendingModel;
+	// only filled if the instance needs additional vertices to the shared model (e.g. for the active tool)
 	Vertices _vertices;
 	Indices _indices;
+	// increased whenever the vertices or indices are changed
+	uint32_t _meshRevision = 0u;
 	double _globalTimeSeconds = 0.0;
 	math::AABB<float> _aabb { -0.5f, 0.0f, -0.5f, 0.5f, 1.0f, 0.5f };
 	lua::LUA _lua;
@@ -40,6 +47,17 @@ protected:
 	 */
 	bool updateAABB();
 
+	/**
+	 * @brief Drops the current model and requests the model for the current settings from the cache
+	 * @sa pollModel()
+	 */
+	void requestModel(const AnimationCachePtr& cache, const AnimationCache::LoadAdditional& loadAdditional = {});
+
+	/**
+	 * @brief Called once the requested model is available
+	 */
+	virtual void onModelReady() {}
+
 public:
 	AnimationEntity();
 	virtual ~AnimationEntity();
@@ -72,6 +90,18 @@ public:
 	 * @brief The 'static' indices of the character mesh
 	 */
 	const Indices& indices() const;
+	/**
+	 * @return The shared model if the entity doesn't have any per instance vertices, @c nullptr otherwise
+	 */
+	AnimationModelPtr sharedModel() const;
+	/**
+	 * @brief Changes whenever the vertices or indices of the entity are changed
+	 */
+	uint32_t meshRevision() const;
+	/**
+	 * @return The heap memory in bytes that is owned by this instance - the shared model is not included
+	 */
+	virtual size_t instanceMemory() const;
 
 	/**
 	 * @brief The skeleton data for the vertices
@@ -80,6 +110,27 @@ public:
 	virtual const Skeleton& skeleton() const = 0;
 	virtual SkeletonAttribute& skeletonAttributes() = 0;
 
+	/**
+	 * @brief Takes over the model once it was assembled
+	 * @return @c true if the model is available, @c false if it is still pending or failed to assemble
+	 * @note Called by @c update() - the vertices are empty until this returned @c true
+	 */
+	bool pollModel();
+	/**
+	 * @brief Blocks until the requested model is available
+	 * @note Don't call this from a thread pool worker
+	 */
+	bool waitForModel();
+	/**
+	 * @return @c true if the model is still assembled on a worker thread
+	 */
+	bool modelPending() const;
+
+	/**
+	 * @brief Requests the (shared) model for the current settings - it is assembled on a worker thread
+	 * @return @c false if the model can't be requested
+	 * @sa pollModel()
+	 */
 	virtual bool initMesh(const AnimationCachePtr& cache) = 0;
 	/**
 	 * @note Updating the settings without updating the mesh afterwards is pointless.
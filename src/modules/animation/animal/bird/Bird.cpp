@@ -28,14 +28,12 @@ bool Bird::initSettings(const core::String& luaString) {
 }
 
 bool Bird::initMesh(const AnimationCachePtr& cache) {
-	if (!cache->getBoneModel(_settings, _vertices, _indices)) {
-		Log::warn("Failed to load the models");
-		return false;
-	}
+	requestModel(cache);
 	return true;
 }
 
 void Bird::update(double deltaSeconds, const attrib::ShadowAttributes& attrib) {
+	pollModel();
 	const BirdSkeleton old = _skeleton;
 	const double velocity = attrib.current(attrib::Type::SPEED);
 
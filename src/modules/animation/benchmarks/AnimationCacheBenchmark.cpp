@@ -0,0 +1,98 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "animation/AnimationCache.h"
+#include "animation/AnimationSystem.h"
+#include "animation/chr/Character.h"
+#include "voxel/MaterialColor.h"
+#include "voxelformat/MeshCache.h"
+
+/**
+ * @brief Compares spawning identical characters with an empty (cold) animation cache - every spawn assembles its
+ * own model - and a cache that already holds the shared model
+ *
+ * The voxel meshes are loaded once for both cases - only the model assembly differs.
+ */
+class AnimationCacheBenchmark: public app::AbstractBenchmark {
+protected:
+	static constexpr int Entities = 64;
+	voxelformat::MeshCachePtr _meshCache;
+	core::String _lua;
+
+public:
+	void onCleanupApp() override {
+		if (_meshCache) {
+			_meshCache->shutdown();
+		}
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		_lua = io::filesystem()->load("chr/human-male-knight.lua");
+		_meshCache = std::make_shared<voxelformat::MeshCache>();
+		return _meshCache->init();
+	}
+
+	/**
+	 * @param[in] cache The cache to spawn the characters with - or @c nullptr to use a new cache for every character
+	 * @return The heap memory of the spawned instances including the models they reference
+	 */
+	size_t spawn(const animation::AnimationCachePtr& cache) {
+		animation::Character characters[Entities];
+		animation::AnimationCachePtr caches[Entities];
+		size_t instanceMemory = 0u;
+		for (int i = 0; i < Entities; ++i) {
+			caches[i] = cache;
+			if (!caches[i]) {
+				caches[i] = std::make_shared<animation::AnimationCache>(_meshCache);
+				caches[i]->init();
+			}
+			characters[i].init(caches[i], _lua);
+			characters[i].waitForModel();
+			instanceMemory += characters[i].instanceMemory();
+			// the shared model is only counted once
+			if (!cache || i == 0) {
+				instanceMemory += characters[i].vertices().size() * sizeof(animation::Vertex)
+						+ characters[i].indices().size() * sizeof(animation::IndexType);
+			}
+		}
+		for (int i = 0; i < Entities; ++i) {
+			characters[i].shutdown();
+			if (!cache) {
+				caches[i]->shutdown();
+			}
+		}
+		return instanceMemory;
+	}
+};
+
+BENCHMARK_DEFINE_F(AnimationCacheBenchmark, cold) (benchmark::State& state) {
+	animation::AnimationSystem animationSystem;
+	animationSystem.init();
+	size_t memory = 0u;
+	while (state.KeepRunning()) {
+		memory = spawn(animation::AnimationCachePtr());
+	}
+	state.counters["bytesPerEntity"] = (double)memory / Entities;
+	animationSystem.shutdown();
+}
+
+BENCHMARK_DEFINE_F(AnimationCacheBenchmark, shared) (benchmark::State& state) {
+	animation::AnimationSystem animationSystem;
+	animationSystem.init();
+	const animation::AnimationCachePtr& cache = std::make_shared<animation::AnimationCache>(_meshCache);
+	cache->init();
+	size_t memory = 0u;
+	while (state.KeepRunning()) {
+		memory = spawn(cache);
+	}
+	state.counters["bytesPerEntity"] = (double)memory / Entities;
+	state.counters["models"] = (double)cache->models();
+	cache->shutdown();
+	animationSystem.shutdown();
+}
+
+BENCHMARK_REGISTER_F(AnimationCacheBenchmark, cold)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(AnimationCacheBenchmark, shared)->Unit(benchmark::kMillisecond);
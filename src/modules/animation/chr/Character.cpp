@@ -26,7 +26,7 @@ bool Character::initSettings(const core::String& luaString) {
 	return false;
 }
 
-bool Character::loadGlider(const AnimationCachePtr& cache, const AnimationSettings& settings, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES]) {
+bool Character::loadGlider(const AnimationCachePtr& cache, const AnimationSettings& settings, voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES]) {
 	const int idx = settings.getMeshTypeIdxForName("glider");
 	if (idx < 0 || idx >= (int)AnimationSettings::MAX_ENTRIES) {
 		return false;
@@ -34,7 +34,7 @@ bool Character::loadGlider(const AnimationCachePtr& cache, const AnimationSettin
 	// TODO: model via inventory
 	const char *fullPath = "models/glider";
 	meshes[idx] = cache->getMesh(fullPath);
-	if (meshes[idx] == nullptr) {
+	if (!meshes[idx]) {
 		Log::error("Failed to load glider");
 		return false;
 	}
@@ -42,22 +42,25 @@ bool Character::loadGlider(const AnimationCachePtr& cache, const AnimationSettin
 }
 
 bool Character::initMesh(const AnimationCachePtr& cache) {
-	if (!cache->getBoneModel(_settings, _vertices, _indices, [&] (const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES]) {
-		return loadGlider(cache, _settings, meshes);
-	})) {
-		Log::warn("Failed to load the character model");
-		return false;
-	}
-	_toolVerticesOffset = _vertices.size();
-	_toolIndicesOffset = _indices.size();
+	// the callback is executed on a worker thread - it must not reference this instance
+	requestModel(cache, [cache, settings = _settings] (voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES]) {
+		return loadGlider(cache, settings, meshes);
+	});
+	// the tool vertices are added again to the new model
+	_toolId = (stock::ItemId)-1;
+	return true;
+}
 
+void Character::onModelReady() {
+	_toolId = (stock::ItemId)-1;
 	// ensure the bones are in a sane state - needed for getting the aabb right
 	chr_idle_update(_globalTimeSeconds, &_skeleton, &_attributes);
-
-	return true;
 }
 
 bool Character::updateTool(const AnimationCachePtr& cache, const stock::Stock& stock) {
+	if (!pollModel()) {
+		return false;
+	}
 	const int containerId = stock.containerId("tool");
 	if (containerId < 0) {
 		return false;
@@ -96,21 +99,33 @@ bool Character::updateTool(const AnimationCachePtr& cache, const stock::Stock& s
 		return false;
 	}
 
-	_vertices.resize(_toolVerticesOffset + _toolVertices.size());
-	for (size_t i = 0; i < _toolVertices.size(); ++i) {
-		_vertices[_toolVerticesOffset + i] = _toolVertices[i];
-	}
-
-	_indices.resize(_toolIndicesOffset + _toolIndices.size());
-	for (size_t i = 0; i < _toolIndices.size(); ++i) {
-		_indices[_toolIndicesOffset + i] = _toolIndices[i] + _toolVerticesOffset;
+	// the shared model is immutable - the instance gets its own copy with the tool vertices attached
+	const Vertices& modelVertices = _model->vertices;
+	const Indices& modelIndices = _model->indices;
+	const size_t toolVerticesOffset = modelVertices.size();
+	_vertices.clear();
+	_vertices.reserve(toolVerticesOffset + _toolVertices.size());
+	_vertices.append(modelVertices.data(), modelVertices.size());
+	_vertices.append(_toolVertices.data(), _toolVertices.size());
+
+	_indices.clear();
+	_indices.reserve(modelIndices.size() + _toolIndices.size());
+	_indices.append(modelIndices.data(), modelIndices.size());
+	for (IndexType idx : _toolIndices) {
+		_indices.push_back(idx + (IndexType)toolVerticesOffset);
 	}
 
+	++_meshRevision;
 	Log::debug("Added %i vertices for the active tool", (int)_toolVertices.size());
 	return true;
 }
 
+size_t Character::instanceMemory() const {
+	return AnimationEntity::instanceMemory() + _toolVertices.capacity() * sizeof(Vertex) + _toolIndices.capacity() * sizeof(IndexType);
+}
+
 void Character::update(double deltaSeconds, const attrib::ShadowAttributes& attrib) {
+	pollModel();
 	const CharacterSkeleton old = _skeleton;
 
 	const double velocity = attrib.current(attrib::Type::SPEED);
@@ -163,8 +178,11 @@ void Character::update(double deltaSeconds, const attrib::ShadowAttributes& attr
 void Character::shutdown() {
 	_toolId = (stock::ItemId)-1;
 	_toolAnim = ToolAnimationType::Max;
-	_toolVerticesOffset = 0u;
-	_toolIndicesOffset = 0u;
+	_vertices.clear();
+	_indices.clear();
+	_model = AnimationModelPtr();
+	_pendingModel = std::shared_future<AnimationModelPtr>();
+	++_meshRevision;
 }
 
 const Skeleton& Character::skeleton() const {
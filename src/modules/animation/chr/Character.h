@@ -21,21 +21,19 @@ protected:
 	CharacterSkeleton _skeleton;
 	CharacterSkeletonAttribute _attributes;
 
-	// the offset where the tool starts at
-	size_t _toolVerticesOffset = 0u;
-	// the offset where the tool starts at
-	size_t _toolIndicesOffset = 0u;
 	Vertices _toolVertices;
 	Indices _toolIndices;
 	stock::ItemId _toolId = (stock::ItemId)-1;
 	ToolAnimationType _toolAnim = ToolAnimationType::None;
 
-	bool loadGlider(const AnimationCachePtr& cache, const AnimationSettings& settings, const voxel::Mesh* (&meshes)[AnimationSettings::MAX_ENTRIES]);
+	static bool loadGlider(const AnimationCachePtr& cache, const AnimationSettings& settings, voxelformat::MeshPtr (&meshes)[AnimationSettings::MAX_ENTRIES]);
+	void onModelReady() override;
 public:
 	void shutdown() override;
 	bool initMesh(const AnimationCachePtr& cache) override;
 	bool initSettings(const core::String& luaString) override;
 	void update(double deltaSeconds, const attrib::ShadowAttributes& attrib) override;
+	size_t instanceMemory() const override;
 	/**
 	 * @brief Updates the vertices and indices buffer whenever the character switched the active tool
 	 * @param[in] cache The cache that is used to resolve the item models
@@ -0,0 +1,134 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "animation/AnimationCache.h"
+#include "animation/AnimationSystem.h"
+#include "animation/chr/Character.h"
+#include "io/Filesystem.h"
+#include "voxel/MaterialColor.h"
+
+namespace animation {
+
+class AnimationCacheTest: public app::AbstractTest {
+protected:
+	static constexpr int Entities = 64;
+	AnimationSystem _animationSystem;
+	AnimationCachePtr _cache;
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		ASSERT_TRUE(voxel::initDefaultMaterialColors());
+		ASSERT_TRUE(_animationSystem.init());
+		_cache = std::make_shared<AnimationCache>(std::make_shared<voxelformat::MeshCache>());
+		ASSERT_TRUE(_cache->init());
+	}
+
+	void TearDown() override {
+		_cache->shutdown();
+		_cache = AnimationCachePtr();
+		_animationSystem.shutdown();
+		app::AbstractTest::TearDown();
+	}
+
+	static size_t modelSize(const AnimationEntity& entity) {
+		return entity.vertices().size() * sizeof(Vertex) + entity.indices().size() * sizeof(IndexType);
+	}
+};
+
+TEST_F(AnimationCacheTest, testSharedModel) {
+	const core::String& lua = io::filesystem()->load("chr/human-male-knight.lua");
+	ASSERT_FALSE(lua.empty());
+
+	Character first;
+	ASSERT_TRUE(first.init(_cache, lua));
+	ASSERT_TRUE(first.waitForModel());
+	ASSERT_FALSE(first.vertices().empty());
+	ASSERT_FALSE(first.indices().empty());
+	EXPECT_EQ(1u, _cache->models());
+
+	Character characters[Entities];
+	for (int i = 0; i < Entities; ++i) {
+		ASSERT_TRUE(characters[i].init(_cache, lua));
+		EXPECT_FALSE(characters[i].modelPending()) << "Expected the cached model to be available without waiting";
+		ASSERT_TRUE(characters[i].pollModel());
+	}
+
+	const size_t sharedBytes = modelSize(first);
+	for (int i = 0; i < Entities; ++i) {
+		EXPECT_EQ(first.vertices().data(), characters[i].vertices().data()) << "Entity " << i << " doesn't share the vertices";
+		EXPECT_EQ(first.indices().data(), characters[i].indices().data()) << "Entity " << i << " doesn't share the indices";
+		// the instance only owns its animation state - a private copy of the model would be included here
+		EXPECT_LT(characters[i].instanceMemory(), sharedBytes) << "Entity " << i << " allocated a private copy of the model";
+	}
+	EXPECT_EQ(1u, _cache->models());
+	for (int i = 0; i < Entities; ++i) {
+		characters[i].shutdown();
+	}
+	first.shutdown();
+}
+
+TEST_F(AnimationCacheTest, testDifferentSettings) {
+	const core::String& knight = io::filesystem()->load("chr/human-male-knight.lua");
+	const core::String& worker = io::filesystem()->load("chr/human-male-worker.lua");
+	Character a;
+	Character b;
+	ASSERT_TRUE(a.init(_cache, knight));
+	ASSERT_TRUE(b.init(_cache, worker));
+	ASSERT_TRUE(a.waitForModel());
+	ASSERT_TRUE(b.waitForModel());
+	EXPECT_NE(a.vertices().data(), b.vertices().data());
+	EXPECT_EQ(2u, _cache->models());
+	a.shutdown();
+	b.shutdown();
+}
+
+TEST_F(AnimationCacheTest, testAsync) {
+	const core::String& lua = io::filesystem()->load("chr/human-male-knight.lua");
+	Character chr;
+	ASSERT_TRUE(chr.initSettings(lua));
+	const std::shared_future<AnimationModelPtr>& future1 = _cache->getBoneModelAsync(chr.animationSettings());
+	const std::shared_future<AnimationModelPtr>& future2 = _cache->getBoneModelAsync(chr.animationSettings());
+	const AnimationModelPtr& model = future1.get();
+	ASSERT_TRUE(model);
+	EXPECT_EQ(model, future2.get());
+	EXPECT_EQ(model, _cache->getBoneModel(chr.animationSettings()));
+	EXPECT_EQ(1u, _cache->models());
+}
+
+TEST_F(AnimationCacheTest, testSpawnWhileAssembling) {
+	const core::String& lua = io::filesystem()->load("chr/human-male-knight.lua");
+	Character chr;
+	ASSERT_TRUE(chr.init(_cache, lua));
+	if (chr.modelPending()) {
+		EXPECT_TRUE(chr.vertices().empty()) << "Nothing should be rendered until the model is ready";
+	}
+	ASSERT_TRUE(chr.waitForModel());
+	EXPECT_FALSE(chr.modelPending());
+	EXPECT_FALSE(chr.vertices().empty());
+	EXPECT_TRUE(chr.aabb().isValid());
+	chr.shutdown();
+}
+
+TEST_F(AnimationCacheTest, testRemoveMesh) {
+	const core::String& lua = io::filesystem()->load("chr/human-male-knight.lua");
+	Character chr;
+	ASSERT_TRUE(chr.init(_cache, lua));
+	ASSERT_TRUE(chr.waitForModel());
+	EXPECT_EQ(1u, _cache->models());
+	const core::String& fullPath = chr.animationSettings().fullPath(0);
+	const voxelformat::MeshPtr& mesh = _cache->getMesh(fullPath.c_str());
+	ASSERT_TRUE(mesh);
+	const int vertices = mesh->getNoOfVertices();
+	_cache->removeMesh(chr.animationSettings().fullPath(0).c_str());
+	EXPECT_EQ(0u, _cache->models());
+	// the entity still holds a reference to the old model
+	EXPECT_FALSE(chr.vertices().empty());
+	// and the removed mesh is still valid for those that still reference it
+	EXPECT_EQ(vertices, mesh->getNoOfVertices());
+	EXPECT_NE(mesh, _cache->getMesh(fullPath.c_str()));
+	chr.shutdown();
+}
+
+}
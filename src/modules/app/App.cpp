@@ -16,6 +16,8 @@
 #include "core/Log.h"
 #include "core/Tokenizer.h"
 #include "core/concurrent/Concurrency.h"
+#include "core/concurrent/LockStats.h"
+#include "core/FrameArena.h"
 #include "util/VarUtil.h"
 #include <SDL.h>
 #include "engine-config.h"
@@ -177,6 +179,8 @@ void App::onFrame() {
 				core_trace_scoped(AppOnAfterRunning);
 				onAfterRunning();
 			}
+			// the per frame allocations of the main thread are released here
+			core::frameArena().reset();
 			const double framesPerSecondsCap = _framesPerSecondsCap->floatVal();
 			if (framesPerSecondsCap >= 1.0 && _nextFrameSeconds > now) {
 				const double delay = _nextFrameSeconds - now;
@@ -210,6 +214,8 @@ AppState App::onConstruct() {
 	core::VarPtr logVar = core::Var::get(cfg::CoreLogLevel, _initialLogLevel);
 	// this ensures that we are sleeping 1 millisecond if there is enough room for it
 	_framesPerSecondsCap = core::Var::get(cfg::CoreMaxFPS, "1000.0");
+	_lockStatsVar = core::Var::get(cfg::CoreLockStats, (int)core::LockStats::DefaultSampleRate);
+	core::LockStats::setSampleRate(_lockStatsVar->intVal());
 	registerArg("--loglevel").setShort("-l").setDescription("Change log level from 1 (trace) to 6 (only critical)");
 	const core::String& logLevelVal = getArgVal("--loglevel");
 	if (!logLevelVal.empty()) {
@@ -352,6 +358,8 @@ AppState App::onInit() {
 	Log::init();
 	_logLevelVar = core::Var::getSafe(cfg::CoreLogLevel);
 	_syslogVar = core::Var::getSafe(cfg::CoreSysLog);
+	// the config file might have changed the sample rate
+	core::LockStats::setSampleRate(_lockStatsVar->intVal());
 
 	core::Var::visit([&] (const core::VarPtr& var) {
 		var->markClean();
@@ -512,6 +520,10 @@ AppState App::onRunning() {
 		_logLevelVar->markClean();
 		_syslogVar->markClean();
 	}
+	if (_lockStatsVar->isDirty()) {
+		core::LockStats::setSampleRate(_lockStatsVar->intVal());
+		_lockStatsVar->markClean();
+	}
 
 	command::Command::update(_deltaFrameSeconds);
 
@@ -624,6 +636,11 @@ AppState App::onCleanup() {
 		Log::warn("don't save the config variables");
 	}
 
+	core::LockStats::log();
+	const core::FrameArena::Stats& frameArenaStats = core::frameArena().stats();
+	Log::debug("Frame arena: high water mark %i bytes, %i bytes reserved, %i blocks allocated in %i frames",
+			(int)frameArenaStats.highWaterMark, (int)frameArenaStats.reservedBytes,
+			(int)frameArenaStats.blockAllocations, (int)frameArenaStats.resets);
 	command::Command::shutdown();
 	core::Var::shutdown();
 
@@ -117,6 +117,7 @@ protected:
 	core::TimeProviderPtr _timeProvider;
 	core::VarPtr _logLevelVar;
 	core::VarPtr _syslogVar;
+	core::VarPtr _lockStatsVar;
 	metric::IMetricSenderPtr _metricSender;
 	metric::MetricPtr _metric;
 	// if you modify the tracing during the frame, we throw away the current frame information
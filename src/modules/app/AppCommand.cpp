@@ -8,6 +8,7 @@
 #include "util/VarUtil.h"
 #include "app/App.h"
 #include "core/Log.h"
+#include "core/concurrent/LockStats.h"
 #include "core/Var.h"
 #include <inttypes.h>
 
@@ -123,6 +124,14 @@ void init(const core::TimeProviderPtr& timeProvider) {
 		}
 	}).setHelp("Show the value of a variable");
 
+	command::Command::registerCommand("lockstats", [] (const command::CmdArgs& args) {
+		if (!args.empty() && args[0] == "reset") {
+			core::LockStats::reset();
+			return;
+		}
+		core::LockStats::log();
+	}).setHelp("Print the contention of the named locks - use 'reset' to reset the counters");
+
 	command::Command::registerCommand("timemillis", [&] (const command::CmdArgs& args) {
 		const uint64_t millis = timeProvider->tickNow();
 		Log::info("%" PRId64, millis);
@@ -68,7 +68,7 @@ bool Attributes::update(long dt) {
 		max.put(p->key, value);
 	}
 
-	core::ScopedReadLock scopedLock(_attribLock);
+	core::ScopedWriteLock scopedLock(_attribLock);
 	if (!_listeners.empty()) {
 		const TypeSet& diff = mapFindChangedValues(_max, max);
 		for (const Type& e : diff) {
@@ -3,7 +3,6 @@
  */
 
 #include "Entity.h"
-#include "core/collection/SetUtil.h"
 #include "core/ArrayLength.h"
 #include "core/Assert.h"
 #include "core/Log.h"
@@ -33,14 +32,14 @@ Entity::Entity(EntityId id,
 Entity::~Entity() {
 }
 
-void Entity::visibleAdd(const EntitySet& entities) {
+void Entity::visibleAdd(const FrameEntityList& entities) {
 	for (const EntityPtr& e : entities) {
 		Log::trace("entity %i is visible for %i", (int)e->id(), (int)id());
 		sendEntitySpawn(e);
 	}
 }
 
-void Entity::visibleRemove(const EntitySet& entities) {
+void Entity::visibleRemove(const FrameEntityList& entities) {
 	for (const EntityPtr& e : entities) {
 		Log::trace("entity %i is no longer visible for %i", (int)e->id(), (int)id());
 		sendEntityRemove(e);
@@ -66,27 +65,30 @@ bool Entity::attack(EntityId victimId) {
 
 void Entity::sendToVisible(flatbuffers::FlatBufferBuilder& fbb, network::ServerMsgType type,
 		flatbuffers::Offset<void> data, bool sendToSelf, uint32_t flags) const {
-	const EntitySet& visible = visibleCopy();
-	std::vector<ENetPeer*> peers;
-	peers.reserve(visible.size() + 1);
+	core::FrameArenaScope frameScope;
+	core::DynamicArray<ENetPeer*, 32u, core::FrameArenaAllocator> peers;
 	if (sendToSelf) {
 		ENetPeer* p = peer();
 		if (p != nullptr) {
 			peers.push_back(p);
 		}
 	}
-	for (const EntityPtr& e : visible) {
-		ENetPeer* peer = e->peer();
-		if (peer == nullptr) {
-			continue;
+	{
+		core::ScopedReadLock lock(_visibleLock);
+		peers.reserve(peers.size() + _visible.size());
+		for (const EntityPtr& e : _visible) {
+			ENetPeer* peer = e->peer();
+			if (peer == nullptr) {
+				continue;
+			}
+			peers.push_back(peer);
 		}
-		peers.push_back(peer);
 	}
 	if (peers.empty()) {
 		Log::debug("don't send message of type '%s' - no peers found", network::toString(type, network::EnumNamesServerMsgType()));
 		return;
 	}
-	if (!_messageSender->sendServerMessage(&peers[0], peers.size(), fbb, type, data, flags)) {
+	if (!_messageSender->sendServerMessage(&peers[0], (int)peers.size(), fbb, type, data, flags)) {
 		Log::debug("Could not send message of type '%s' to all desired peers",
 				network::toString(type, network::EnumNamesServerMsgType()));
 		return;
@@ -176,13 +178,24 @@ bool Entity::update(long dt) {
 	return true;
 }
 
-void Entity::updateVisible(const EntitySet& set) {
+void Entity::updateVisible(const FrameEntitySet& set) {
 	core_trace_scoped(UpdateVisible);
+	FrameEntityList add;
+	FrameEntityList remove;
 	_visibleLock.lockWrite();
-	const auto& stillVisible = core::setIntersection(set, _visible);
-	const EntitySet& remove = core::setDifference(stillVisible, _visible);
-	const EntitySet& add = core::setDifference(set, stillVisible);
-	_visible = core::setUnion(stillVisible, add);
+	for (auto i = _visible.begin(); i != _visible.end();) {
+		if (set.find(*i) == set.end()) {
+			remove.push_back(*i);
+			i = _visible.erase(i);
+		} else {
+			++i;
+		}
+	}
+	for (const EntityPtr& e : set) {
+		if (_visible.insert(e).second) {
+			add.push_back(e);
+		}
+	}
 	_visibleLock.unlockWrite();
 
 	for (const auto& e : _visible) {
@@ -13,6 +13,8 @@
 #include "ServerMessages_generated.h"
 #include "network/IProtocolHandler.h"
 #include "core/Trace.h"
+#include "core/FrameArena.h"
+#include "core/collection/DynamicArray.h"
 
 #include <unordered_set>
 #include <memory>
@@ -20,6 +22,11 @@
 namespace backend {
 
 typedef std::unordered_set<EntityPtr> EntitySet;
+/**
+ * @brief Entity containers that only live for the current tick - they are allocated from the @c core::FrameArena
+ */
+typedef std::unordered_set<EntityPtr, std::hash<EntityPtr>, std::equal_to<EntityPtr>, core::FrameAllocator<EntityPtr> > FrameEntitySet;
+typedef core::DynamicArray<EntityPtr, 32u, core::FrameArenaAllocator> FrameEntityList;
 
 /**
  * @brief Every actor in the world is an entity
@@ -60,13 +67,13 @@ protected:
 	float _size = 1.0f;
 
 	/**
-	 * @brief Called with the set of entities that just get visible for this entity
+	 * @brief Called with the entities that just get visible for this entity
 	 */
-	void visibleAdd(const EntitySet& entities);
+	void visibleAdd(const FrameEntityList& entities);
 	/**
-	 * @brief Called with the set of entities that just get invisible for this entity
+	 * @brief Called with the entities that just get invisible for this entity
 	 */
-	void visibleRemove(const EntitySet& entities);
+	void visibleRemove(const FrameEntityList& entities);
 
 	void broadcastAttribUpdate();
 	void sendEntityUpdate(const EntityPtr& entity) const;
@@ -147,7 +154,7 @@ public:
 	 * @note All entities have the same view range - see @c Entity::regionRect
 	 * @note This is thread safe
 	 */
-	void updateVisible(const EntitySet& set);
+	void updateVisible(const FrameEntitySet& set);
 
 	/**
 	 * @brief The tick of the entity
@@ -62,6 +62,13 @@ void Npc::init(const glm::ivec3* pos) {
 	init();
 }
 
+void Npc::setPosition(const glm::vec3& pos, float orientation) {
+	_aiChr->setPosition(pos);
+	_aiChr->setOrientation(orientation);
+	setPos(pos);
+	setOrientation(orientation);
+}
+
 double Npc::applyDamage(Entity* attacker, double damage) {
 	double health = current(attrib::Type::HEALTH);
 	if (health > 0.0) {
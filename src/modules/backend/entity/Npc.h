@@ -55,6 +55,10 @@ public:
 
 	void setHomePosition(const glm::ivec3& pos);
 	const glm::ivec3& homePosition() const;
+	/**
+	 * @brief Moves the npc and its @c AI character - e.g. to restore a snapshot
+	 */
+	void setPosition(const glm::vec3& pos, float orientation);
 	bool route(const glm::ivec3& target);
 	const AIPtr& ai();
 
@@ -8,6 +8,7 @@
 #include "common/Common.h"
 #include "core/concurrent/Lock.h"
 #include "core/Assert.h"
+#include "core/Common.h"
 #include "backend/entity/ai/AI.h"
 #include "core/Trace.h"
 #include "commonlua/LUAFunctions.h"
@@ -262,7 +263,8 @@ LUAAIRegistry::LUAAIRegistry() {
 	_s = _lua.state();
 	// TODO: random module
 
-	lua_gc(_s, LUA_GCSTOP, 0);
+	// the garbage is collected with a time budget in update()
+	_lua.setManualGC(true);
 
 	static const luaL_Reg registryFuncs[] = {
 		{"createNode", luaAI_createnode},
@@ -321,6 +323,16 @@ void LUAAIRegistry::shutdown() {
 	_s = nullptr;
 }
 
+void LUAAIRegistry::update(long dt) {
+	if (_s == nullptr) {
+		return;
+	}
+	core_trace_scoped(LUAAIRegistryUpdate);
+	const uint64_t tickMicros = dt > 0 ? (uint64_t)dt * 1000u : 0u;
+	const uint64_t budget = core_min(core_max(tickMicros * LUAGCBudgetPercent / 100u, LUAGCMinBudgetMicros), LUAGCMaxBudgetMicros);
+	_lua.gcStep(budget);
+}
+
 LUAAIRegistry::~LUAAIRegistry() {
 	shutdown();
 }
@@ -88,6 +88,16 @@ typedef std::map<core::String, LUASteeringFactoryPtr> SteeringFactoryMap;
  */
 class LUAAIRegistry : public AIRegistry {
 protected:
+	/**
+	 * @brief Share of the tick time (in percent) that is spent on collecting the lua garbage
+	 */
+	static constexpr uint64_t LUAGCBudgetPercent = 5u;
+	/**
+	 * @brief Bounds in microseconds for the garbage collector budget per tick
+	 */
+	static constexpr uint64_t LUAGCMinBudgetMicros = 100u;
+	static constexpr uint64_t LUAGCMaxBudgetMicros = 2000u;
+
 	lua::LUA _lua;
 	lua_State* _s = nullptr;
 
@@ -135,6 +145,18 @@ public:
 	 */
 	void shutdown();
 
+	/**
+	 * @brief Call this once per tick after the zones were updated - the lua garbage collector
+	 * is stepped here with a budget that scales with the tick time.
+	 * @param dt The tick time in milliseconds
+	 */
+	void update(long dt);
+
+	/**
+	 * @brief Access to the memory and garbage collector statistics of the lua state
+	 */
+	const lua::LUA& lua() const;
+
 	~LUAAIRegistry();
 
 	inline bool evaluate(const core::String& str) {
@@ -150,6 +172,10 @@ public:
 	bool evaluate(const char* luaBuffer, size_t size);
 };
 
+inline const lua::LUA& LUAAIRegistry::lua() const {
+	return _lua;
+}
+
 typedef std::shared_ptr<LUAAIRegistry> AIRegistryPtr;
 
 }
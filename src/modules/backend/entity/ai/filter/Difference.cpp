@@ -13,18 +13,20 @@
 namespace backend {
 
 void Difference::filter (const AIPtr& entity) {
+	// the intermediate results are released when the filter is done
+	core::FrameArenaScope frameScope;
 	FilteredEntities& filtered = getFilteredEntities(entity);
 	// create a copy
-	const FilteredEntities alreadyFiltered = filtered;
+	const FrameFilteredEntities alreadyFiltered(filtered.begin(), filtered.end());
 	// now clear the entity list
 	filtered.clear();
 
-	std::vector<FilteredEntities> filteredArray(_filters.size());
+	std::vector<FrameFilteredEntities, core::FrameAllocator<FrameFilteredEntities> > filteredArray(_filters.size());
 	int n = 0;
 	size_t max = 0u;
 	for (auto& f : _filters) {
 		f->filter(entity);
-		filteredArray[n++] = filtered;
+		filteredArray[n++].assign(filtered.begin(), filtered.end());
 		max = core_max(filtered.size(), max);
 		// safe and clear
 		filtered.clear();
@@ -34,14 +36,16 @@ void Difference::filter (const AIPtr& entity) {
 		std::sort(filteredArray[i].begin(), filteredArray[i].end());
 	}
 
-	FilteredEntities result(max);
+	FrameFilteredEntities result;
+	result.reserve(max);
 	std::set_difference(
 			filteredArray[0].begin(), filteredArray[0].end(),
 			filteredArray[1].begin(), filteredArray[1].end(),
 			std::back_inserter(result));
 
 	if (filteredArray.size() >= 2) {
-		FilteredEntities buffer(max);
+		FrameFilteredEntities buffer;
+		buffer.reserve(max);
 		for (size_t i = 2; i < filteredArray.size(); ++i) {
 			buffer.clear();
 			std::sort(result.begin(), result.end());
@@ -49,7 +53,7 @@ void Difference::filter (const AIPtr& entity) {
 					result.begin(), result.end(),
 					filteredArray[i].begin(), filteredArray[i].end(),
 					std::back_inserter(buffer));
-			core::exchange(result, buffer);
+			result.swap(buffer);
 		}
 	}
 
@@ -5,10 +5,15 @@
 #pragma once
 
 #include "ai-shared/common/CharacterId.h"
+#include "core/FrameArena.h"
 #include <vector>
 
 namespace backend {
 
 typedef std::vector<ai::CharacterId> FilteredEntities;
+/**
+ * @brief Intermediate filter results that are allocated from the @c core::FrameArena
+ */
+typedef std::vector<ai::CharacterId, core::FrameAllocator<ai::CharacterId> > FrameFilteredEntities;
 
 }
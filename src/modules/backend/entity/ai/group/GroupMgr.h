@@ -130,6 +130,19 @@ public:
 		}
 	}
 
+	/**
+	 * @brief Visit all groups - the functor gets the @ai{GroupId}, the leader and the members of each group
+	 *
+	 * @note This methods performs a read lock on the group manager
+	 */
+	template<typename Func>
+	void visitGroups(Func&& func) const {
+		core::ScopedLock scopedLock(_lock);
+		for (GroupsConstIter i = _groups.begin(); i != _groups.end(); ++i) {
+			func(i->first, i->second.leader, i->second.members);
+		}
+	}
+
 	/**
 	 * @return If the group doesn't exist, this method returns @c 0 - otherwise the amount of members
 	 * that must be bigger than @c 1
@@ -31,16 +31,21 @@ bool ITreeLoader::addTree(const core::String& name, const TreeNodePtr& root) {
 	if (!root) {
 		return false;
 	}
+	const core::StringId id(name);
 	core::ScopedLock scopedLock(_lock);
-	auto i = _treeMap.find(name);
+	auto i = _treeMap.find(id);
 	if (i != _treeMap.end()) {
 		return false;
 	}
-	_treeMap.put(name, root);
+	_treeMap.put(id, root);
 	return true;
 }
 
 TreeNodePtr ITreeLoader::load(const core::String &name) {
+	return load(core::StringId::find(name));
+}
+
+TreeNodePtr ITreeLoader::load(const core::StringId &name) {
 	core::ScopedLock scopedLock(_lock);
 	auto i = _treeMap.find(name);
 	if (i != _treeMap.end())
@@ -6,7 +6,7 @@
 #include "core/Trace.h"
 #include "core/concurrent/Lock.h"
 #include "core/String.h"
-#include "core/collection/StringMap.h"
+#include "core/StringId.h"
 #include "core/Common.h"
 #include <memory>
 
@@ -23,7 +23,7 @@ typedef std::shared_ptr<TreeNode> TreeNodePtr;
 class ITreeLoader {
 protected:
 	const IAIFactory& _aiFactory;
-	typedef core::StringMap<TreeNodePtr> TreeMap;
+	typedef core::StringIdMap<TreeNodePtr> TreeMap;
 	TreeMap _treeMap;
 	core_trace_mutex(core::Lock, _lock, "AITreeLoader");
 
@@ -54,6 +54,7 @@ public:
 	 * @brief Loads on particular behaviour tree.
 	 */
 	TreeNodePtr load(const core::String &name);
+	TreeNodePtr load(const core::StringId &name);
 
 	void setError(CORE_FORMAT_STRING const char* msg, ...) CORE_PRINTF_VARARG_FUNC(2);
 
@@ -17,6 +17,7 @@
 #include "backend/entity/ai/group/GroupMgr.h"
 #include "core/concurrent/ThreadPool.h"
 #include "core/concurrent/Lock.h"
+#include "core/FrameArena.h"
 #include "core/Trace.h"
 #include "ai-shared/common/CharacterId.h"
 
@@ -45,6 +46,10 @@ public:
 	typedef std::vector<ai::CharacterId> CharacterIdList;
 	typedef AIMap::const_iterator AIMapConstIter;
 	typedef AIMap::iterator AIMapIter;
+	/**
+	 * @brief Copy of the zone's @c AI instances that only lives for the current tick - see @c core::FrameArena
+	 */
+	typedef std::vector<AIPtr, core::FrameAllocator<AIPtr> > FrameAIList;
 
 protected:
 	const core::String _name;
@@ -78,6 +83,17 @@ protected:
 	 */
 	bool doDestroyAI(const ai::CharacterId& id);
 
+	/**
+	 * @brief Copies the @c AI instances while the zone is locked - they can then be executed without holding the lock
+	 */
+	void snapshot(FrameAIList& ais) const {
+		core::ScopedLock scopedLock(_lock);
+		ais.reserve(_ais.size());
+		for (auto i = _ais.begin(); i != _ais.end(); ++i) {
+			ais.push_back(i->second);
+		}
+	}
+
 public:
 	Zone(const core::String& name, int threadCount = 1) :
 			_name(name), _debug(false), _threadPool(threadCount) {
@@ -251,12 +267,12 @@ public:
 	template<typename Func>
 	void executeParallel(Func& func) {
 		core_trace_scoped(ZoneExecuteParallel);
-		std::vector<std::future<void> > results;
-		_lock.lock();
-		AIMap copy(_ais);
-		_lock.unlock();
-		for (auto i = copy.begin(); i != copy.end(); ++i) {
-			const AIPtr& ai = i->second;
+		core::FrameArenaScope frameScope;
+		FrameAIList ais;
+		snapshot(ais);
+		std::vector<std::future<void>, core::FrameAllocator<std::future<void> > > results;
+		results.reserve(ais.size());
+		for (const AIPtr& ai : ais) {
 			results.emplace_back(executeAsync(ai, func));
 		}
 		for (auto & result: results) {
@@ -274,12 +290,12 @@ public:
 	template<typename Func>
 	void executeParallel(const Func& func) const {
 		core_trace_scoped(ZoneExecuteParallel);
-		std::vector<std::future<void> > results;
-		_lock.lock();
-		AIMap copy(_ais);
-		_lock.unlock();
-		for (auto i = copy.begin(); i != copy.end(); ++i) {
-			const AIPtr& ai = i->second;
+		core::FrameArenaScope frameScope;
+		FrameAIList ais;
+		snapshot(ais);
+		std::vector<std::future<void>, core::FrameAllocator<std::future<void> > > results;
+		results.reserve(ais.size());
+		for (const AIPtr& ai : ais) {
 			results.emplace_back(executeAsync(ai, func));
 		}
 		for (auto & result: results) {
@@ -296,11 +312,10 @@ public:
 	template<typename Func>
 	void execute(const Func& func) const {
 		core_trace_scoped(ZoneExecute);
-		_lock.lock();
-		AIMap copy(_ais);
-		_lock.unlock();
-		for (auto i = copy.begin(); i != copy.end(); ++i) {
-			const AIPtr& ai = i->second;
+		core::FrameArenaScope frameScope;
+		FrameAIList ais;
+		snapshot(ais);
+		for (const AIPtr& ai : ais) {
 			func(ai);
 		}
 	}
@@ -314,11 +329,10 @@ public:
 	template<typename Func>
 	void execute(Func& func) {
 		core_trace_scoped(ZoneExecute);
-		_lock.lock();
-		AIMap copy(_ais);
-		_lock.unlock();
-		for (auto i = copy.begin(); i != copy.end(); ++i) {
-			const AIPtr& ai = i->second;
+		core::FrameArenaScope frameScope;
+		FrameAIList ais;
+		snapshot(ais);
+		for (const AIPtr& ai : ais) {
 			func(ai);
 		}
 	}
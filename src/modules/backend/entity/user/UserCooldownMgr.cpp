@@ -76,7 +76,8 @@ void UserCooldownMgr::sendCooldown(cooldown::Type type, bool started) const {
 
 bool UserCooldownMgr::getDirtyModels(Models& models) {
 	// TODO: what about deleting...
-	core::ScopedReadLock lock(_lock);
+	// the dirty models are written here - this needs exclusive access
+	core::ScopedWriteLock lock(_lock);
 	models.reserve(models.size() + _cooldowns.size());
 	for (const auto& e : _cooldowns) {
 		const cooldown::CooldownPtr& c = e->value;
@@ -7,6 +7,8 @@
 
 #include "command/Command.h"
 #include "core/Var.h"
+#include "core/FrameArena.h"
+#include "core/collection/DynamicArray.h"
 #include "core/Log.h"
 #include "app/App.h"
 #include "io/Filesystem.h"
@@ -444,7 +446,7 @@ void ServerLoop::update() {
 
 void ServerLoop::replicateVars() const {
 	core_trace_scoped(ReplicateVars);
-	core::DynamicArray<core::VarPtr> vars;
+	core::DynamicArray<core::VarPtr, 32u, core::FrameArenaAllocator> vars;
 	core::Var::visitDirtyReplicate([&vars] (const core::VarPtr& var) {
 		vars.push_back(var);
 	});
@@ -4,6 +4,8 @@
 
 #include "SpawnMgr.h"
 #include "core/Common.h"
+#include "core/Enum.h"
+#include "core/StringId.h"
 #include "core/Singleton.h"
 #include "core/Trace.h"
 #include "io/Filesystem.h"
@@ -21,6 +23,31 @@ namespace backend {
 
 static const long spawnTime = 15000L;
 
+namespace {
+
+/**
+ * @brief The behaviour trees are registered under the names of the entity types - intern them only once
+ */
+struct EntityTypeIds {
+	core::StringId ids[core::enumVal(network::EntityType::MAX) + 1];
+
+	EntityTypeIds() {
+		for (int i = 0; i <= core::enumVal(network::EntityType::MAX); ++i) {
+			ids[i] = core::StringId(network::EnumNamesEntityType()[i]);
+		}
+	}
+};
+
+core::StringId behaviourTreeName(network::EntityType type) {
+	static const EntityTypeIds entityTypeIds;
+	if (type < network::EntityType::MIN || type > network::EntityType::MAX) {
+		return core::StringId();
+	}
+	return entityTypeIds.ids[core::enumVal(type)];
+}
+
+}
+
 SpawnMgr::SpawnMgr(Map* map,
 		const io::FilesystemPtr& filesytem,
 		const EntityStoragePtr& entityStorage,
@@ -94,7 +121,7 @@ NpcPtr SpawnMgr::createNpc(network::EntityType type, const TreeNodePtr& behaviou
 
 NpcPtr SpawnMgr::spawn(network::EntityType type, const glm::ivec3* pos) {
 	const char *typeName = network::EnumNameEntityType(type);
-	const TreeNodePtr& behaviour = _loader->load(typeName);
+	const TreeNodePtr& behaviour = _loader->load(behaviourTreeName(type));
 	if (!behaviour) {
 		Log::error("could not load the behaviour tree %s", typeName);
 		return NpcPtr();
@@ -106,6 +133,22 @@ NpcPtr SpawnMgr::spawn(network::EntityType type, const glm::ivec3* pos) {
 	return npc;
 }
 
+NpcPtr SpawnMgr::respawn(network::EntityType type, const glm::vec3& pos, float orientation, const glm::ivec3& homePos) {
+	const TreeNodePtr& behaviour = _loader->load(behaviourTreeName(type));
+	if (!behaviour) {
+		Log::error("could not load the behaviour tree %s", network::EnumNameEntityType(type));
+		return NpcPtr();
+	}
+	const NpcPtr& npc = createNpc(type, behaviour);
+	npc->init(&homePos);
+	npc->setPosition(pos, orientation);
+	if (!_map->addNpc(npc, pos)) {
+		return NpcPtr();
+	}
+	_entityStorage->addNpc(npc);
+	return npc;
+}
+
 int SpawnMgr::spawn(network::EntityType type, int amount, const glm::ivec3* pos) {
 	const bool isAnimal = core::enumVal(type) > core::enumVal(network::EntityType::BEGIN_ANIMAL) && core::enumVal(type) < core::enumVal(network::EntityType::MAX_ANIMAL);
 	const bool isCharacter = core::enumVal(type) > core::enumVal(network::EntityType::BEGIN_CHARACTERS) && core::enumVal(type) < core::enumVal(network::EntityType::MAX_CHARACTERS);
@@ -115,7 +158,7 @@ int SpawnMgr::spawn(network::EntityType type, int amount, const glm::ivec3* pos)
 	}
 
 	const char *typeName = network::EnumNameEntityType(type);
-	const TreeNodePtr& behaviour = _loader->load(typeName);
+	const TreeNodePtr& behaviour = _loader->load(behaviourTreeName(type));
 	if (!behaviour) {
 		Log::error("could not load the behaviour tree %s", typeName);
 		return 0;
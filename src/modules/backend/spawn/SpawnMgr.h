@@ -45,6 +45,10 @@ public:
 
 	NpcPtr spawn(network::EntityType type, const glm::ivec3* pos = nullptr);
 	int spawn(network::EntityType type, int amount, const glm::ivec3* pos = nullptr);
+	/**
+	 * @brief Spawns an npc at exactly the given position - e.g. to restore a @c MapSnapshot
+	 */
+	NpcPtr respawn(network::EntityType type, const glm::vec3& pos, float orientation, const glm::ivec3& homePos);
 	void update(long dt);
 };
 
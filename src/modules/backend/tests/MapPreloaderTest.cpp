@@ -0,0 +1,116 @@
+/**
+ * @file
+ */
+
+#include "EntityTest.h"
+#include "backend/world/MapPreloader.h"
+#include "voxelworld/WorldMgr.h"
+
+namespace backend {
+
+class MapPreloaderTest: public EntityTest {
+private:
+	using Super = EntityTest;
+protected:
+	static constexpr MapId PreloadMapId = 43;
+	static constexpr int ChunkSideLength = 256;
+
+	MapPtr createMap(MapId id) {
+		return std::make_shared<Map>(id, eventBus, timeProvider, filesystem, entityStorage, messageSender,
+				volumeCache, loader, containerProvider, cooldownProvider, persistenceMgr,
+				std::make_shared<DBChunkPersister>(persistence::createDbHandlerMock(), id));
+	}
+
+	void SetUp() override {
+		Super::SetUp();
+		filesystem->removeFile(filesystem->homePath() + MapPreloader::densityFilename(PreloadMapId));
+	}
+
+	void TearDown() override {
+		filesystem->removeFile(filesystem->homePath() + MapPreloader::densityFilename(PreloadMapId));
+		Super::TearDown();
+	}
+};
+
+TEST_F(MapPreloaderTest, testAddAreas) {
+	MapPreloader preloader(PreloadMapId, filesystem);
+	preloader.init(ChunkSideLength);
+	const char *lua = R"(
+preload = {
+	{ x = 300, z = -10, radius = 2 },
+	{ x = 0, z = 0 },
+}
+)";
+	ASSERT_EQ(2, preloader.addAreas(lua, 1));
+	ASSERT_EQ(2u, preloader.areas().size());
+	EXPECT_EQ(glm::ivec2(1, -1), preloader.areas()[0].center);
+	EXPECT_EQ(2, preloader.areas()[0].radius);
+	EXPECT_EQ(glm::ivec2(0, 0), preloader.areas()[1].center);
+	EXPECT_EQ(1, preloader.areas()[1].radius);
+	EXPECT_EQ(0, preloader.addAreas("landscapeNoiseOctaves = 1", 1)) << "no preload table given";
+}
+
+TEST_F(MapPreloaderTest, testDensity) {
+	{
+		MapPreloader preloader(PreloadMapId, filesystem);
+		preloader.init(ChunkSideLength);
+		for (int i = 0; i < 10; ++i) {
+			preloader.recordPlayer(glm::vec3(-1.0f, 0.0f, 10.0f));
+		}
+		for (int i = 0; i < 4; ++i) {
+			preloader.recordPlayer(glm::vec3(600.0f, 0.0f, 10.0f));
+		}
+		EXPECT_EQ(10u, preloader.density(glm::vec3(-100.0f, 0.0f, 100.0f)));
+		ASSERT_TRUE(preloader.writeDensity());
+	}
+	MapPreloader preloader(PreloadMapId, filesystem);
+	preloader.init(ChunkSideLength);
+	ASSERT_EQ(1, preloader.addDensityAreas(1, 0));
+	EXPECT_EQ(glm::ivec2(-1, 0), preloader.areas()[0].center) << "the busiest column should be used first";
+	EXPECT_EQ(5u, preloader.density(glm::vec3(-1.0f, 0.0f, 10.0f))) << "the stored samples should be halved";
+	EXPECT_EQ(2u, preloader.density(glm::vec3(600.0f, 0.0f, 10.0f)));
+}
+
+TEST_F(MapPreloaderTest, testPreload) {
+	const MapPtr& map = createMap(PreloadMapId);
+	ASSERT_TRUE(map->init());
+	voxel::PagedVolume* volume = map->worldMgr()->volumeData();
+	ASSERT_EQ(ChunkSideLength, (int)volume->chunkSideLength());
+	const size_t chunks = volume->chunks();
+
+	MapPreloader& preloader = map->preloader();
+	// two touching areas are fetched with one query
+	preloader.addArea(glm::vec3(0.0f), 0);
+	preloader.addArea(glm::vec3(ChunkSideLength, 0.0f, 0.0f), 0);
+	preloader.addArea(glm::vec3(-3.0f * ChunkSideLength, 0.0f, 0.0f), 0);
+	const MapPreloader::Stats& stats = map->preload();
+	EXPECT_EQ(3, stats.requested);
+	EXPECT_EQ(0, stats.resident);
+	EXPECT_EQ(2, stats.queries);
+	EXPECT_EQ(3, stats.loaded + stats.generated);
+	EXPECT_EQ(chunks + 3u, volume->chunks());
+
+	const MapPreloader::Stats& again = map->preload();
+	EXPECT_EQ(3, again.resident);
+	EXPECT_EQ(0, again.queries);
+	EXPECT_EQ(0, again.generated);
+	EXPECT_EQ(chunks + 3u, volume->chunks());
+
+	{
+		// the generated chunk is the same that the pager would create
+		const voxel::PagedVolume::ChunkPtr& chunk = volume->createChunk(glm::ivec3(0));
+		voxel::PagedVolume::PagerContext ctx;
+		ctx.region = voxel::Region(glm::ivec3(0), glm::ivec3(ChunkSideLength - 1));
+		ctx.chunk = chunk;
+		map->pager()->generate(ctx);
+		const voxel::PagedVolume::ChunkPtr& preloaded = volume->chunk(glm::ivec3(0));
+		for (int y = 0; y < ChunkSideLength; y += 7) {
+			for (int x = 0; x < ChunkSideLength; x += 13) {
+				ASSERT_EQ(chunk->voxel(x, y, x), preloaded->voxel(x, y, x)) << x << ":" << y;
+			}
+		}
+	}
+	map->shutdown();
+}
+
+}
@@ -0,0 +1,194 @@
+/**
+ * @file
+ */
+
+#include "EntityTest.h"
+#include "backend/world/MapSnapshot.h"
+#include "backend/entity/Npc.h"
+#include "backend/entity/ai/AI.h"
+#include "backend/entity/ai/zone/Zone.h"
+#include "core/TimeProvider.h"
+#include "voxelworld/WorldMgr.h"
+
+namespace backend {
+
+class MapSnapshotTest: public EntityTest {
+private:
+	using Super = EntityTest;
+protected:
+	static constexpr MapId SnapshotMapId = 42;
+
+	struct StartupStats {
+		uint64_t readyMillis = 0u;
+		uint64_t firstTickMillis = 0u;
+		uint64_t minuteMillis = 0u;
+		uint64_t maxTickMillis = 0u;
+	};
+
+	MapPtr createMap(MapId id) {
+		return std::make_shared<Map>(id, eventBus, timeProvider, filesystem, entityStorage, messageSender,
+				volumeCache, loader, containerProvider, cooldownProvider, persistenceMgr,
+				std::make_shared<DBChunkPersister>(persistence::createDbHandlerMock(), id));
+	}
+
+	/**
+	 * @brief Simulates the first minute of the map with one tick per second
+	 */
+	void tickFirstMinute(const MapPtr& map, StartupStats& stats) {
+		for (int i = 0; i < 60; ++i) {
+			const uint64_t start = core::TimeProvider::systemMillis();
+			map->update(1000l);
+			const uint64_t delta = core::TimeProvider::systemMillis() - start;
+			if (i == 0) {
+				stats.firstTickMillis = delta;
+			}
+			stats.minuteMillis += delta;
+			stats.maxTickMillis = core_max(stats.maxTickMillis, delta);
+		}
+	}
+
+	/**
+	 * @brief The timings depend on the machine - they are recorded in the test report to compare the cold and
+	 * the warm start instead of being asserted
+	 */
+	void report(const char *name, const StartupStats& stats) {
+		Log::info("%s: ready after %i ms, first tick %i ms, first minute %i ms (max tick %i ms)", name,
+				(int)stats.readyMillis, (int)stats.firstTickMillis, (int)stats.minuteMillis, (int)stats.maxTickMillis);
+		const core::String prefix(name);
+		RecordProperty((prefix + "ReadyMillis").c_str(), (int)stats.readyMillis);
+		RecordProperty((prefix + "FirstTickMillis").c_str(), (int)stats.firstTickMillis);
+		RecordProperty((prefix + "MinuteMillis").c_str(), (int)stats.minuteMillis);
+		RecordProperty((prefix + "MaxTickMillis").c_str(), (int)stats.maxTickMillis);
+	}
+
+	void SetUp() override {
+		Super::SetUp();
+		filesystem->removeFile(filesystem->homePath() + MapSnapshot::filename(SnapshotMapId));
+	}
+
+	void TearDown() override {
+		filesystem->removeFile(filesystem->homePath() + MapSnapshot::filename(SnapshotMapId));
+		Super::TearDown();
+	}
+};
+
+TEST_F(MapSnapshotTest, testChunkKey) {
+	const glm::ivec3 positions[] = {glm::ivec3(0), glm::ivec3(-1, 0, -1), glm::ivec3(8388607, 32767, -8388608),
+			glm::ivec3(-8388608, -32768, 8388607), glm::ivec3(12, -3, -4711)};
+	for (const glm::ivec3& pos : positions) {
+		EXPECT_EQ(pos, MapSnapshot::chunkPos(MapSnapshot::chunkKey(pos)));
+	}
+	EXPECT_NE(MapSnapshot::chunkKey(glm::ivec3(1, 0, 0)), MapSnapshot::chunkKey(glm::ivec3(0, 0, 1)));
+}
+
+TEST_F(MapSnapshotTest, testWriteRead) {
+	const core::String& file = MapSnapshot::filename(SnapshotMapId);
+	MapSnapshot snapshot;
+	snapshot.seed = 1u;
+	snapshot.chunkSideLength = 256u;
+	const uint8_t data[] = {1, 2, 3, 4, 5};
+	snapshot.addChunk(glm::ivec3(-1, 0, 2), data, sizeof(data));
+	snapshot.addNpc(MapSnapshot::Npc{3, network::EntityType::ANIMAL_WOLF, glm::vec3(1.5f, 2.0f, -3.0f), glm::ivec3(1, 2, -3), 0.5f});
+	snapshot.addAggro(MapSnapshot::Aggro{3, 7, 10.0f});
+	snapshot.addGroupMember(MapSnapshot::GroupMember{1, 3});
+	ASSERT_TRUE(snapshot.write(filesystem, file));
+
+	MapSnapshot restored;
+	ASSERT_TRUE(restored.read(filesystem, file));
+	EXPECT_EQ(1u, restored.seed);
+	EXPECT_EQ(256u, restored.chunkSideLength);
+	ASSERT_EQ(1u, restored.chunks().size());
+	EXPECT_EQ(glm::ivec3(-1, 0, 2), MapSnapshot::chunkPos(restored.chunks()[0].key));
+	ASSERT_EQ(sizeof(data), restored.chunks()[0].size);
+	EXPECT_EQ(0, memcmp(data, restored.chunkData(restored.chunks()[0]), sizeof(data)));
+	ASSERT_EQ(1u, restored.npcs().size());
+	EXPECT_EQ(network::EntityType::ANIMAL_WOLF, restored.npcs()[0].type);
+	EXPECT_EQ(glm::vec3(1.5f, 2.0f, -3.0f), restored.npcs()[0].pos);
+	EXPECT_EQ(glm::ivec3(1, 2, -3), restored.npcs()[0].homePos);
+	ASSERT_EQ(1u, restored.aggro().size());
+	EXPECT_EQ(7, restored.aggro()[0].target);
+	ASSERT_EQ(1u, restored.groupMembers().size());
+	EXPECT_EQ(3, restored.groupMembers()[0].member);
+
+	// a broken file is ignored
+	const io::FilePtr& f = filesystem->open(file, io::FileMode::Read);
+	uint8_t *buf = nullptr;
+	const int size = f->read((void **)&buf);
+	ASSERT_GT(size, 0);
+	buf[size - 1] ^= 0xFF;
+	ASSERT_TRUE(filesystem->write(file, buf, size));
+	delete[] buf;
+	EXPECT_FALSE(restored.read(filesystem, file));
+}
+
+TEST_F(MapSnapshotTest, testWarmRestart) {
+	StartupStats coldStats;
+	int npcs = 0;
+	size_t chunks = 0u;
+	{
+		const uint64_t start = core::TimeProvider::systemMillis();
+		const MapPtr& cold = createMap(SnapshotMapId);
+		ASSERT_TRUE(cold->init());
+		EXPECT_FALSE(cold->restoreSnapshot());
+		coldStats.readyMillis = core::TimeProvider::systemMillis() - start;
+		// a cold start has to page in the chunks and to populate the map with the first updates
+		EXPECT_EQ(0u, cold->worldMgr()->volumeData()->chunks());
+		EXPECT_EQ(0, cold->npcCount());
+		// the spawn manager populates the map with the first update
+		tickFirstMinute(cold, coldStats);
+
+		const NpcPtr& wolf = cold->spawnMgr().spawn(network::EntityType::ANIMAL_WOLF);
+		const NpcPtr& rabbit = cold->spawnMgr().spawn(network::EntityType::ANIMAL_RABBIT);
+		ASSERT_TRUE(wolf && rabbit);
+		cold->zone()->update(0l);
+		ASSERT_TRUE(cold->zone()->getGroupMgr().add(1, wolf->ai()));
+		ASSERT_TRUE(cold->zone()->getGroupMgr().add(1, rabbit->ai()));
+		wolf->ai()->getAggroMgr().addAggro((ai::CharacterId)rabbit->id(), 1000.0f);
+
+		npcs = cold->npcCount();
+		chunks = cold->worldMgr()->volumeData()->chunks();
+		ASSERT_GT(chunks, 0u);
+		ASSERT_TRUE(cold->writeSnapshot());
+		cold->shutdown();
+	}
+
+	StartupStats warmStats;
+	const uint64_t start = core::TimeProvider::systemMillis();
+	const MapPtr& warm = createMap(SnapshotMapId);
+	ASSERT_TRUE(warm->init());
+	ASSERT_TRUE(warm->restoreSnapshot());
+	warmStats.readyMillis = core::TimeProvider::systemMillis() - start;
+	EXPECT_FALSE(filesystem->exists(MapSnapshot::filename(SnapshotMapId))) << "The snapshot must only be restored once";
+
+	// a warm start is ready without any update
+	EXPECT_EQ(npcs, warm->npcCount());
+	EXPECT_EQ(chunks, warm->worldMgr()->volumeData()->chunks());
+	const GroupMgr& groupMgr = warm->zone()->getGroupMgr();
+	ASSERT_EQ(2, groupMgr.getGroupSize(1));
+	const AIPtr& leader = groupMgr.getLeader(1);
+	ASSERT_TRUE(leader);
+	const NpcPtr& wolf = warm->npc(leader->getId());
+	ASSERT_TRUE(wolf);
+	EXPECT_EQ(network::EntityType::ANIMAL_WOLF, wolf->entityType());
+	const EntryPtr entry = wolf->ai()->getAggroMgr().getHighestEntry();
+	ASSERT_NE(nullptr, entry);
+	const NpcPtr& rabbit = warm->npc(entry->getCharacterId());
+	ASSERT_TRUE(rabbit) << "the aggro target wasn't mapped to the restored npc";
+	EXPECT_EQ(network::EntityType::ANIMAL_RABBIT, rabbit->entityType());
+
+	tickFirstMinute(warm, warmStats);
+	warm->shutdown();
+
+	report("cold", coldStats);
+	report("warm", warmStats);
+	// the cold start pages in the chunks and spawns the population with its first tick
+	EXPECT_LE(warmStats.firstTickMillis, coldStats.firstTickMillis);
+
+	// a crash before the next clean shutdown doesn't restore the stale snapshot again
+	const MapPtr& crashed = createMap(SnapshotMapId);
+	ASSERT_TRUE(crashed->init());
+	EXPECT_FALSE(crashed->restoreSnapshot());
+	crashed->shutdown();
+}
+
+}
@@ -50,6 +50,25 @@ persistence::Blob DBChunkPersister::load(int x, int y, int z, MapId mapId, unsig
 	return model.data();
 }
 
+bool DBChunkPersister::loadArea(const glm::ivec2& mins, const glm::ivec2& maxs, unsigned int seed,
+		const std::function<void(const glm::ivec3&, const uint8_t*, size_t)>& func) const {
+	core_trace_scoped(DBChunkPersisterLoadArea);
+	const db::DBConditionChunkModelMapid mapIdCond(_mapId);
+	const db::DBConditionChunkModelSeed seedCond((int32_t)seed);
+	const db::DBConditionChunkModelX minsXCond(mins.x, persistence::Comparator::BiggerOrEqual);
+	const db::DBConditionChunkModelX maxsXCond(maxs.x, persistence::Comparator::LessOrEqual);
+	const db::DBConditionChunkModelZ minsZCond(mins.y, persistence::Comparator::BiggerOrEqual);
+	const db::DBConditionChunkModelZ maxsZCond(maxs.y, persistence::Comparator::LessOrEqual);
+	const persistence::DBConditionMultiple condition(true, {&mapIdCond, &seedCond, &minsXCond, &maxsXCond, &minsZCond, &maxsZCond});
+	return _dbHandler->select(db::ChunkModel(), condition, [&] (db::ChunkModel&& model) {
+		persistence::Blob blob = model.data();
+		if (blob.length > 0) {
+			func(glm::ivec3(model.x(), model.y(), model.z()), blob.data, blob.length);
+		}
+		blob.release();
+	});
+}
+
 bool DBChunkPersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) {
 	core_trace_scoped(DBChunkPersisterLoad);
 	const glm::ivec3& region = chunk->chunkPos();
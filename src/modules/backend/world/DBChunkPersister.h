@@ -10,6 +10,8 @@
 #include "voxel/PagedVolume.h"
 #include "voxel/Region.h"
 #include "MapId.h"
+#include <functional>
+#include <glm/vec2.hpp>
 
 namespace backend {
 
@@ -24,6 +26,14 @@ public:
 	bool init() override;
 
 	persistence::Blob load(int x, int y, int z, MapId mapId, unsigned int seed) const;
+	/**
+	 * @brief Loads all persisted chunks of the given chunk space rectangle with one query
+	 * @param[in] mins The lower x and z chunk coordinates (inclusive)
+	 * @param[in] maxs The upper x and z chunk coordinates (inclusive)
+	 * @param[in] func Gets the chunk position and the compressed chunk data (see @c loadCompressed())
+	 */
+	bool loadArea(const glm::ivec2& mins, const glm::ivec2& maxs, unsigned int seed,
+			const std::function<void(const glm::ivec3&, const uint8_t*, size_t)>& func) const;
 	/**
 	 * @brief Removes all persisted chunks from the database for the given parameters
 	 */
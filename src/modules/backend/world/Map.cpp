@@ -3,12 +3,16 @@
  */
 
 #include "Map.h"
+#include "MapSnapshot.h"
 #include "voxelworld/WorldPager.h"
 #include "voxelworld/WorldMgr.h"
 #include "core/StringUtil.h"
 #include "core/EventBus.h"
 #include "app/App.h"
 #include "core/Trace.h"
+#include "core/ByteStream.h"
+#include "core/TimeProvider.h"
+#include "core/concurrent/Concurrency.h"
 #include "math/QuadTree.h"
 #include "io/Filesystem.h"
 #include "backend/entity/Npc.h"
@@ -46,7 +50,7 @@ Map::Map(MapId mapId,
 		_eventBus(eventBus), _filesystem(filesystem), _persistenceMgr(persistenceMgr),
 		_volumeCache(volumeCache), _attackMgr(this), _poiProvider(timeProvider), _spawnMgr(this, filesystem, entityStorage, messageSender,
 			timeProvider, loader, containerProvider, cooldownProvider),
-		_quadTree(math::RectFloat::getMaxRect(), 100.0f), _chunkPersister(chunkPersister) {
+		_quadTree(math::RectFloat::getMaxRect(), 100.0f), _chunkPersister(chunkPersister), _preloader(mapId, filesystem) {
 }
 
 Map::~Map() {
@@ -63,10 +67,11 @@ bool Map::updateEntity(const EntityPtr& entity, long dt) {
 		return false;
 	}
 	const math::RectFloat& rect = entity->viewRect();
-	// TODO: maybe move into the entity instance to reduce memory allocations.
-	math::QuadTree<QuadTreeNode, float>::Contents contents;
+	// the query results are only needed for this update
+	core::FrameArenaScope frameScope;
+	core::DynamicArray<QuadTreeNode, 32u, core::FrameArenaAllocator> contents;
 	_quadTree.query(rect, contents);
-	EntitySet set;
+	FrameEntitySet set;
 	set.reserve(contents.size());
 	for (const QuadTreeNode& node : contents) {
 		// TODO: check the distance - the rect might contain more than the circle would...
@@ -88,6 +93,7 @@ void Map::update(long dt) {
 	for (auto i = _users.begin(); i != _users.end();) {
 		UserPtr user = i->second;
 		if (updateEntity(user, dt)) {
+			_preloader.recordPlayer(user->pos());
 			++i;
 			continue;
 		}
@@ -142,12 +148,29 @@ bool Map::init() {
 		Log::error("Failed to init the spawn manager");
 		return false;
 	}
+	if (core::Var::get(cfg::ServerMapSnapshot, "false")->boolVal()) {
+		restoreSnapshot();
+	}
+
+	const int preloadRadius = core::Var::get(cfg::ServerPreloadRadius, "1")->intVal();
+	_preloader.init(_voxelWorldMgr->volumeData()->chunkSideLength());
+	_preloader.addAreas(worldParamData, preloadRadius);
+	_poiProvider.visit([&] (const glm::vec3& pos, poi::Type) {
+		_preloader.addArea(pos, preloadRadius);
+	});
+	_preloader.addDensityAreas(core::Var::get(cfg::ServerPreloadChunks, "16")->intVal(), preloadRadius);
+	preload();
 	return _persistenceMgr->registerSavable(FOURCC, this);
 }
 
 void Map::shutdown() {
+	if (_voxelWorldMgr != nullptr && core::Var::get(cfg::ServerMapSnapshot, "false")->boolVal()) {
+		writeSnapshot();
+	}
 	_attackMgr.shutdown();
 	_spawnMgr.shutdown();
+	_preloader.writeDensity();
+	_preloader.shutdown();
 	if (_pager != nullptr) {
 		_pager->shutdown();
 		_pager = voxelworld::WorldPagerPtr();
@@ -207,11 +230,14 @@ UserPtr Map::user(EntityId id) {
 }
 
 bool Map::addNpc(const NpcPtr& npc) {
+	return addNpc(npc, findStartPosition(npc));
+}
+
+bool Map::addNpc(const NpcPtr& npc, const glm::vec3& pos) {
 	auto i = _npcs.insert(std::make_pair(npc->id(), npc));
 	if (!i.second) {
 		return false;
 	}
-	const glm::vec3& pos = findStartPosition(npc);
 	npc->setMap(ptr(), pos);
 	_zone->addAI(npc->ai());
 	_quadTree.insert(QuadTreeNode { npc });
@@ -242,6 +268,132 @@ NpcPtr Map::npc(EntityId id) {
 	return i->second;
 }
 
+bool Map::writeSnapshot() {
+	if (_voxelWorldMgr == nullptr || _zone == nullptr) {
+		return false;
+	}
+	core_trace_scoped(MapWriteSnapshot);
+	MapSnapshot snapshot;
+	snapshot.seed = core::Var::getSafe(cfg::ServerSeed)->uintVal();
+	voxel::PagedVolume* volume = _voxelWorldMgr->volumeData();
+	snapshot.chunkSideLength = volume->chunkSideLength();
+
+	core::DynamicArray<voxel::PagedVolume::ChunkPtr> chunks;
+	volume->residentChunks(chunks);
+	core::ByteStream stream;
+	for (const voxel::PagedVolume::ChunkPtr& chunk : chunks) {
+		stream.clear();
+		if (!_chunkPersister->saveCompressed(chunk, stream)) {
+			continue;
+		}
+		snapshot.addChunk(chunk->chunkPos(), stream.getBuffer(), stream.getSize());
+	}
+
+	for (const auto& e : _npcs) {
+		const NpcPtr& npc = e.second;
+		const ai::CharacterId id = (ai::CharacterId)npc->id();
+		snapshot.addNpc(MapSnapshot::Npc{id, npc->entityType(), npc->pos(), npc->homePosition(), npc->orientation()});
+		for (const Entry& entry : npc->ai()->getAggroMgr().getEntries()) {
+			snapshot.addAggro(MapSnapshot::Aggro{id, entry.getCharacterId(), entry.getAggro()});
+		}
+	}
+
+	_zone->getGroupMgr().visitGroups([&] (GroupId groupId, const AIPtr& leader, const auto& members) {
+		snapshot.addGroupMember(MapSnapshot::GroupMember{groupId, leader->getId()});
+		for (const AIPtr& member : members) {
+			if (member != leader) {
+				snapshot.addGroupMember(MapSnapshot::GroupMember{groupId, member->getId()});
+			}
+		}
+	});
+	return snapshot.write(_filesystem, MapSnapshot::filename(_mapId));
+}
+
+bool Map::restoreSnapshot() {
+	core_trace_scoped(MapRestoreSnapshot);
+	const uint64_t start = core::TimeProvider::systemMillis();
+	MapSnapshot snapshot;
+	const core::String& filename = MapSnapshot::filename(_mapId);
+	if (!snapshot.read(_filesystem, filename)) {
+		return false;
+	}
+	const unsigned int seed = core::Var::getSafe(cfg::ServerSeed)->uintVal();
+	if (snapshot.seed != seed) {
+		Log::warn("Ignoring the snapshot of map %i - it was written for seed %u (current seed is %u)",
+				(int)_mapId, snapshot.seed, seed);
+		return false;
+	}
+	// the snapshot is only valid once - the state diverges from it from now on and a crash before the next
+	// clean shutdown must not restore it again over the newer database state
+	if (!_filesystem->removeFile(_filesystem->homePath() + filename)) {
+		Log::warn("Failed to remove the snapshot of map %i", (int)_mapId);
+	}
+
+	int chunks = 0;
+	voxel::PagedVolume* volume = _voxelWorldMgr->volumeData();
+	if (snapshot.chunkSideLength == volume->chunkSideLength()) {
+		for (const MapSnapshot::Chunk& c : snapshot.chunks()) {
+			const voxel::PagedVolume::ChunkPtr& chunk = volume->createChunk(MapSnapshot::chunkPos(c.key));
+			if (!_chunkPersister->loadCompressed(chunk, snapshot.chunkData(c), c.size)) {
+				continue;
+			}
+			if (volume->addChunk(chunk)) {
+				++chunks;
+			}
+		}
+	} else {
+		Log::warn("Ignoring the chunks of the snapshot of map %i - the chunk size doesn't match", (int)_mapId);
+	}
+
+	// the restored npcs get new ids - map them for the aggro and group state
+	std::unordered_map<ai::CharacterId, NpcPtr> npcs;
+	npcs.reserve(snapshot.npcs().size());
+	for (const MapSnapshot::Npc& n : snapshot.npcs()) {
+		const NpcPtr& npc = _spawnMgr.respawn(n.type, n.pos, n.orientation, n.homePos);
+		if (npc) {
+			npcs.insert(std::make_pair(n.id, npc));
+		}
+	}
+	// add the ai instances right away - the spawn manager would otherwise not count them with the next update
+	_zone->update(0l);
+	for (const MapSnapshot::Aggro& aggro : snapshot.aggro()) {
+		auto owner = npcs.find(aggro.owner);
+		if (owner == npcs.end()) {
+			continue;
+		}
+		auto target = npcs.find(aggro.target);
+		const ai::CharacterId targetId = target != npcs.end() ? (ai::CharacterId)target->second->id() : aggro.target;
+		owner->second->ai()->getAggroMgr().addAggro(targetId, aggro.aggro);
+	}
+	GroupMgr& groupMgr = _zone->getGroupMgr();
+	for (const MapSnapshot::GroupMember& member : snapshot.groupMembers()) {
+		auto i = npcs.find(member.member);
+		if (i != npcs.end()) {
+			groupMgr.add(member.group, i->second->ai());
+		}
+	}
+
+	Log::info("Restored map %i from the snapshot with %i chunks and %i npcs in %i ms", (int)_mapId, chunks,
+			(int)npcs.size(), (int)(core::TimeProvider::systemMillis() - start));
+	return true;
+}
+
+MapPreloader::Stats Map::preload() {
+	if (_voxelWorldMgr == nullptr) {
+		return MapPreloader::Stats();
+	}
+	const unsigned int seed = core::Var::getSafe(cfg::ServerSeed)->uintVal();
+	const int maxChunks = core::Var::get(cfg::ServerPreloadChunks, "16")->intVal();
+	const MapPreloader::Stats& stats = _preloader.preload(_voxelWorldMgr->volumeData(), *_pager.get(), *_chunkPersister, seed,
+			maxChunks, (int)core::cpus());
+	if (stats.requested > 0) {
+		Log::info("Preloaded map %i in %i ms: %i chunks requested, %i already resident, %i loaded with %i queries, "
+				"%i generated on %i threads", (int)_mapId, (int)stats.millis, stats.requested, stats.resident,
+				stats.loaded, stats.queries, stats.generated, stats.threads);
+	}
+	return stats;
+}
+
 voxelutil::FloorTraceResult Map::findFloor(const glm::ivec3& pos, int maxDistanceY) const {
 	return _voxelWorldMgr->findWalkableFloor(pos, maxDistanceY);
 }
@@ -19,6 +19,7 @@
 #include "backend/spawn/SpawnMgr.h"
 #include "voxel/Constants.h"
 #include "DBChunkPersister.h"
+#include "MapPreloader.h"
 #include "MapId.h"
 #include <memory>
 #include <unordered_map>
@@ -66,6 +67,7 @@ private:
 
 	math::QuadTree<QuadTreeNode, float> _quadTree;
 	DBChunkPersisterPtr _chunkPersister;
+	MapPreloader _preloader;
 	/**
 	 * @return @c false if the entity should be removed from the server.
 	 */
@@ -115,6 +117,10 @@ public:
 	UserPtr user(EntityId id);
 
 	bool addNpc(const NpcPtr& npc);
+	/**
+	 * @brief Adds the npc at the given position instead of searching a start position
+	 */
+	bool addNpc(const NpcPtr& npc, const glm::vec3& pos);
 	/**
 	 * @brief Remove npc from map but keep it in the world
 	 * @note The npc will keep this map set up to the point a new @c addNpc() was called on another map instance.
@@ -122,6 +128,27 @@ public:
 	bool removeNpc(EntityId id);
 	NpcPtr npc(EntityId id);
 
+	/**
+	 * @brief Writes the resident chunks, the npcs and their aggro and group state to the @c MapSnapshot file of this map
+	 * @note This is done automatically on shutdown if the @c sv_mapsnapshot cvar is set
+	 */
+	bool writeSnapshot();
+	/**
+	 * @brief Restores the state from the @c MapSnapshot file of this map - the file is removed once it was applied
+	 * @note This is done automatically in @c init() if the @c sv_mapsnapshot cvar is set - call it on an
+	 * initialized map without any npcs.
+	 * @return @c false if there is no valid snapshot for this map and seed
+	 */
+	bool restoreSnapshot();
+
+	/**
+	 * @brief Loads or generates the chunks of the areas of the @c MapPreloader
+	 * @note This is done automatically in @c init() for the points of interest, the @c preload table of the
+	 * @c worldparams.lua and the recorded player density - see the @c sv_preloadchunks and @c sv_preloadradius cvars
+	 */
+	MapPreloader::Stats preload();
+	MapPreloader& preloader();
+
 	const voxelworld::WorldPagerPtr& pager() const;
 	voxelworld::WorldMgr* worldMgr();
 	Zone* zone() const;
@@ -150,6 +177,10 @@ inline const DBChunkPersisterPtr& Map::chunkPersister() {
 	return _chunkPersister;
 }
 
+inline MapPreloader& Map::preloader() {
+	return _preloader;
+}
+
 inline const voxelworld::WorldPagerPtr& Map::pager() const {
 	return _pager;
 }
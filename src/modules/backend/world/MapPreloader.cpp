@@ -0,0 +1,320 @@
+/**
+ * @file
+ */
+
+#include "MapPreloader.h"
+#include "MapSnapshot.h"
+#include "commonlua/LUA.h"
+#include "core/ByteStream.h"
+#include "core/Common.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/TimeProvider.h"
+#include "core/Trace.h"
+#include "core/concurrent/ThreadPool.h"
+#include "io/MappedFile.h"
+#include "voxel/Region.h"
+#include <algorithm>
+#include <future>
+#include <unordered_set>
+#include <vector>
+
+namespace backend {
+
+namespace {
+constexpr uint32_t DensityMagic = FourCC('M', 'P', 'D', 'N');
+constexpr uint32_t DensityVersion = 1u;
+constexpr size_t DensityHeaderSize = 4u * sizeof(uint32_t);
+constexpr size_t DensityEntrySize = 3u * sizeof(int32_t);
+
+struct DensityEntry {
+	uint64_t key;
+	uint32_t samples;
+};
+
+inline uint64_t columnKey(const glm::ivec2& column) {
+	return MapSnapshot::chunkKey(glm::ivec3(column.x, 0, column.y));
+}
+
+/**
+ * @brief The chunk space rectangle that is fetched with one query
+ */
+struct Batch {
+	glm::ivec2 mins;
+	glm::ivec2 maxs;
+
+	bool touches(const Batch& other) const {
+		return mins.x <= other.maxs.x + 1 && other.mins.x <= maxs.x + 1 && mins.y <= other.maxs.y + 1
+				&& other.mins.y <= maxs.y + 1;
+	}
+
+	void merge(const Batch& other) {
+		mins = glm::min(mins, other.mins);
+		maxs = glm::max(maxs, other.maxs);
+	}
+};
+
+void addBatch(core::DynamicArray<Batch>& batches, Batch batch) {
+	// merging two batches can make them touch a third one
+	for (size_t i = 0; i < batches.size();) {
+		if (!batches[i].touches(batch)) {
+			++i;
+			continue;
+		}
+		batch.merge(batches[i]);
+		batches.erase(i);
+		i = 0;
+	}
+	batches.push_back(batch);
+}
+
+}
+
+MapPreloader::MapPreloader(MapId mapId, const io::FilesystemPtr& filesystem) :
+		_mapId(mapId), _filesystem(filesystem) {
+}
+
+void MapPreloader::init(int chunkSideLength) {
+	_chunkSideLength = chunkSideLength;
+}
+
+void MapPreloader::shutdown() {
+	_areas.clear();
+	_density.clear();
+	_chunkSideLength = 0;
+}
+
+core::String MapPreloader::densityFilename(MapId mapId) {
+	return core::string::format("stats/map-%i.density", (int)mapId);
+}
+
+glm::ivec2 MapPreloader::chunkColumn(const glm::vec3& pos) const {
+	const float size = (float)_chunkSideLength;
+	return glm::ivec2((int)glm::floor(pos.x / size), (int)glm::floor(pos.z / size));
+}
+
+void MapPreloader::addArea(const glm::vec3& pos, int radius) {
+	if (_chunkSideLength <= 0) {
+		return;
+	}
+	_areas.push_back(Area{chunkColumn(pos), core_max(0, radius)});
+}
+
+int MapPreloader::addAreas(const core::String& worldParamsLua, int radius) {
+	if (worldParamsLua.empty()) {
+		return 0;
+	}
+	lua::LUA lua;
+	if (!lua.load(worldParamsLua)) {
+		Log::warn("Could not load the preload areas: %s", lua.error().c_str());
+		return 0;
+	}
+	const int n = lua.intValue("#(preload or {})", 0);
+	for (int i = 1; i <= n; ++i) {
+		const float x = lua.floatValue(core::string::format("preload[%i].x", i));
+		const float z = lua.floatValue(core::string::format("preload[%i].z", i));
+		const int r = lua.intValue(core::string::format("preload[%i].radius", i), radius);
+		addArea(glm::vec3(x, 0.0f, z), r);
+	}
+	return n;
+}
+
+void MapPreloader::recordPlayer(const glm::vec3& pos) {
+	if (_chunkSideLength <= 0) {
+		return;
+	}
+	uint32_t& samples = _density[columnKey(chunkColumn(pos))];
+	if (samples < UINT32_MAX) {
+		++samples;
+	}
+}
+
+uint32_t MapPreloader::density(const glm::vec3& pos) const {
+	auto i = _density.find(columnKey(chunkColumn(pos)));
+	if (i == _density.end()) {
+		return 0u;
+	}
+	return i->second;
+}
+
+int MapPreloader::addDensityAreas(int maxAreas, int radius) {
+	const core::String& file = densityFilename(_mapId);
+	const io::MappedFile mappedFile(_filesystem->homePath() + file);
+	if (!mappedFile.valid() || mappedFile.size() < DensityHeaderSize) {
+		Log::debug("No player density found at %s", file.c_str());
+		return 0;
+	}
+	core::ByteStream stream = core::ByteStream::view(mappedFile.data(), mappedFile.size());
+	const uint32_t magic = stream.readInt();
+	const uint32_t version = stream.readInt();
+	const int32_t count = stream.readInt();
+	const uint32_t checksum = stream.readInt();
+	if (magic != DensityMagic || version != DensityVersion) {
+		Log::warn("Ignoring player density %s with version %u (expected %u)", file.c_str(), version, DensityVersion);
+		return 0;
+	}
+	if (count < 0 || (size_t)stream.getSize() != count * DensityEntrySize
+			|| core::hash(stream.getBuffer(), (int)stream.getSize()) != checksum) {
+		Log::warn("Ignoring broken player density %s", file.c_str());
+		return 0;
+	}
+	// the entries are sorted by the amount of samples
+	int added = 0;
+	for (int32_t i = 0; i < count; ++i) {
+		const int32_t x = stream.readInt();
+		const int32_t z = stream.readInt();
+		const uint32_t samples = (uint32_t)stream.readInt() / 2u;
+		if (samples > 0u) {
+			_density[columnKey(glm::ivec2(x, z))] += samples;
+		}
+		if (added < maxAreas) {
+			_areas.push_back(Area{glm::ivec2(x, z), core_max(0, radius)});
+			++added;
+		}
+	}
+	return added;
+}
+
+bool MapPreloader::writeDensity() const {
+	if (_density.empty()) {
+		return true;
+	}
+	core_trace_scoped(MapPreloaderWriteDensity);
+	core::DynamicArray<DensityEntry> entries;
+	entries.reserve(_density.size());
+	for (auto i = _density.begin(); i != _density.end(); ++i) {
+		entries.push_back(DensityEntry{i->first, i->second});
+	}
+	std::sort(entries.data(), entries.data() + entries.size(), [] (const DensityEntry& lhs, const DensityEntry& rhs) {
+		return lhs.samples > rhs.samples;
+	});
+	const int32_t count = (int32_t)core_min(entries.size(), (size_t)MaxDensityEntries);
+
+	core::ByteStream payload((int)(count * DensityEntrySize));
+	for (int32_t i = 0; i < count; ++i) {
+		const glm::ivec3& column = MapSnapshot::chunkPos(entries[i].key);
+		payload.addInt(column.x);
+		payload.addInt(column.z);
+		payload.addInt(entries[i].samples);
+	}
+	core::ByteStream stream((int)(DensityHeaderSize + payload.getSize()));
+	stream.addInt(DensityMagic);
+	stream.addInt(DensityVersion);
+	stream.addInt(count);
+	stream.addInt(core::hash(payload.getBuffer(), (int)payload.getSize()));
+	stream.append(payload.getBuffer(), payload.getSize());
+	const core::String& file = densityFilename(_mapId);
+	if (!_filesystem->write(file, stream.getBuffer(), stream.getSize())) {
+		Log::error("Failed to write the player density %s", file.c_str());
+		return false;
+	}
+	return true;
+}
+
+MapPreloader::Stats MapPreloader::preload(voxel::PagedVolume* volume, voxelworld::WorldPager& pager,
+		const DBChunkPersister& persister, unsigned int seed, int maxChunks, int threads) {
+	Stats stats;
+	if (volume == nullptr || _areas.empty() || maxChunks <= 0 || _chunkSideLength <= 0) {
+		return stats;
+	}
+	core_trace_scoped(MapPreload);
+	const uint64_t start = core::TimeProvider::systemMillis();
+
+	core::DynamicArray<voxel::PagedVolume::ChunkPtr> residentChunks;
+	volume->residentChunks(residentChunks);
+	std::unordered_set<uint64_t> resident;
+	resident.reserve(residentChunks.size());
+	for (const voxel::PagedVolume::ChunkPtr& chunk : residentChunks) {
+		const glm::ivec3& chunkPos = chunk->chunkPos();
+		resident.insert(columnKey(glm::ivec2(chunkPos.x, chunkPos.z)));
+	}
+
+	// the requested columns in the order of the areas - and the rectangles to fetch them from the database
+	core::DynamicArray<glm::ivec2> columns;
+	std::unordered_set<uint64_t> requested;
+	std::unordered_set<uint64_t> missing;
+	core::DynamicArray<Batch> batches;
+	for (const Area& area : _areas) {
+		if (stats.requested >= maxChunks) {
+			break;
+		}
+		bool fetch = false;
+		for (int z = area.center.y - area.radius; z <= area.center.y + area.radius && stats.requested < maxChunks; ++z) {
+			for (int x = area.center.x - area.radius; x <= area.center.x + area.radius && stats.requested < maxChunks; ++x) {
+				const glm::ivec2 column(x, z);
+				const uint64_t key = columnKey(column);
+				if (!requested.insert(key).second) {
+					continue;
+				}
+				++stats.requested;
+				if (resident.find(key) != resident.end()) {
+					++stats.resident;
+					continue;
+				}
+				columns.push_back(column);
+				missing.insert(key);
+				fetch = true;
+			}
+		}
+		if (fetch) {
+			addBatch(batches, Batch{area.center - area.radius, area.center + area.radius});
+		}
+	}
+
+	for (const Batch& batch : batches) {
+		++stats.queries;
+		persister.loadArea(batch.mins, batch.maxs, seed, [&] (const glm::ivec3& chunkPos, const uint8_t* data, size_t size) {
+			if (chunkPos.y != 0) {
+				return;
+			}
+			auto i = missing.find(columnKey(glm::ivec2(chunkPos.x, chunkPos.z)));
+			if (i == missing.end()) {
+				return;
+			}
+			const voxel::PagedVolume::ChunkPtr& chunk = volume->createChunk(chunkPos);
+			if (!persister.loadCompressed(chunk, data, size)) {
+				Log::warn("Failed to uncompress the chunk %i:%i:%i", chunkPos.x, chunkPos.y, chunkPos.z);
+				return;
+			}
+			volume->addChunk(chunk);
+			missing.erase(i);
+			++stats.loaded;
+		});
+	}
+
+	if (!missing.empty()) {
+		stats.threads = core_max(1, core_min(threads, (int)missing.size()));
+		core::ThreadPool threadPool(stats.threads, "MapPreload");
+		threadPool.init();
+		const int sideLength = _chunkSideLength;
+		std::vector<std::future<voxel::PagedVolume::ChunkPtr>> futures;
+		futures.reserve(missing.size());
+		for (const glm::ivec2& column : columns) {
+			if (missing.find(columnKey(column)) == missing.end()) {
+				continue;
+			}
+			futures.emplace_back(threadPool.enqueue([volume, &pager, column, sideLength] () {
+				const glm::ivec3 chunkPos(column.x, 0, column.y);
+				voxel::PagedVolume::PagerContext ctx;
+				const glm::ivec3& mins = chunkPos * sideLength;
+				ctx.region = voxel::Region(mins, mins + glm::ivec3(sideLength - 1));
+				ctx.chunk = volume->createChunk(chunkPos);
+				pager.generate(ctx);
+				return ctx.chunk;
+			}));
+		}
+		for (std::future<voxel::PagedVolume::ChunkPtr>& future : futures) {
+			if (volume->addChunk(future.get())) {
+				++stats.generated;
+			}
+		}
+		threadPool.shutdown(true);
+	}
+
+	stats.millis = core::TimeProvider::systemMillis() - start;
+	return stats;
+}
+
+}
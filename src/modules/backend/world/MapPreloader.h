@@ -0,0 +1,127 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include "io/Filesystem.h"
+#include "voxel/PagedVolume.h"
+#include "voxelworld/WorldPager.h"
+#include "DBChunkPersister.h"
+#include "MapId.h"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <unordered_map>
+#include <stdint.h>
+
+namespace backend {
+
+/**
+ * @brief Makes the chunks of the busy areas of a @c Map resident before the map is marked ready
+ *
+ * Without this, the first entity queries in an area pay for a synchronous chunk page in each. The areas are taken
+ * from the @c preload table of the @c worldparams.lua, the points of interest of the map and the player density that
+ * was recorded the last times the map was running.
+ *
+ * The stored chunks are fetched with one database query per connected area, the missing chunks are generated on
+ * worker threads and added to the volume afterwards.
+ *
+ * @code
+ * preload = {
+ *   { x = 0, z = 0, radius = 2 },
+ * }
+ * @endcode
+ */
+class MapPreloader {
+public:
+	/**
+	 * @brief A square of chunk columns around the center - in chunk space
+	 */
+	struct Area {
+		glm::ivec2 center;
+		int radius;
+	};
+
+	struct Stats {
+		int requested = 0;
+		/** @brief Already in memory - e.g. restored from a @c MapSnapshot */
+		int resident = 0;
+		int loaded = 0;
+		int generated = 0;
+		int queries = 0;
+		int threads = 0;
+		uint64_t millis = 0u;
+	};
+
+	/**
+	 * @brief Only the busiest chunk columns are kept in the density file
+	 */
+	static constexpr int MaxDensityEntries = 1024;
+
+private:
+	const MapId _mapId;
+	io::FilesystemPtr _filesystem;
+	int _chunkSideLength = 0;
+	core::DynamicArray<Area> _areas;
+	/** @brief The amount of player samples per chunk column */
+	std::unordered_map<uint64_t, uint32_t> _density;
+
+	glm::ivec2 chunkColumn(const glm::vec3& pos) const;
+
+public:
+	MapPreloader(MapId mapId, const io::FilesystemPtr& filesystem);
+
+	/**
+	 * @param[in] chunkSideLength The chunks are expected to cover the full height of the world
+	 */
+	void init(int chunkSideLength);
+	void shutdown();
+
+	/**
+	 * @param[in] pos World position
+	 * @param[in] radius The amount of chunks around the chunk of the given position
+	 */
+	void addArea(const glm::vec3& pos, int radius);
+	/**
+	 * @brief Adds the areas of the @c preload table of the given lua script
+	 * @param[in] radius Used for entries that don't specify a radius
+	 * @return The amount of added areas
+	 */
+	int addAreas(const core::String& worldParamsLua, int radius);
+	/**
+	 * @brief Adds the busiest chunk columns of the density file as areas
+	 * @note The stored samples are halved - the new samples of this run are added on top to give the
+	 * recent player positions a higher weight.
+	 * @return The amount of added areas
+	 */
+	int addDensityAreas(int maxAreas, int radius);
+	const core::DynamicArray<Area>& areas() const;
+
+	/**
+	 * @brief Records a player density sample for the given world position
+	 */
+	void recordPlayer(const glm::vec3& pos);
+	uint32_t density(const glm::vec3& pos) const;
+	bool writeDensity() const;
+
+	/**
+	 * @brief Loads or generates the chunks of all added areas and makes them resident in the given volume
+	 * @param[in] maxChunks Only the chunks of the first areas are loaded if there are more
+	 * @param[in] threads The amount of worker threads that generate the missing chunks
+	 */
+	Stats preload(voxel::PagedVolume* volume, voxelworld::WorldPager& pager, const DBChunkPersister& persister,
+			unsigned int seed, int maxChunks, int threads);
+
+	/**
+	 * @return The file name (relative to the home path) of the player density of the given map
+	 */
+	static core::String densityFilename(MapId mapId);
+};
+
+inline const core::DynamicArray<MapPreloader::Area>& MapPreloader::areas() const {
+	return _areas;
+}
+
+}
@@ -0,0 +1,214 @@
+/**
+ * @file
+ */
+
+#include "MapSnapshot.h"
+#include "core/ByteStream.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/Trace.h"
+#include "io/MappedFile.h"
+
+namespace backend {
+
+namespace {
+constexpr uint32_t SnapshotMagic = FourCC('M', 'S', 'N', 'P');
+constexpr size_t SnapshotHeaderSize = 4u * sizeof(uint32_t);
+constexpr size_t ChunkHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr size_t NpcSize = 2u * sizeof(int32_t) + 3u * sizeof(float) + 3u * sizeof(int32_t) + sizeof(float);
+constexpr size_t AggroSize = 2u * sizeof(int32_t) + sizeof(float);
+constexpr size_t GroupMemberSize = 2u * sizeof(int32_t);
+constexpr int64_t ChunkKeyMask24 = 0xFFFFFF;
+}
+
+uint64_t MapSnapshot::chunkKey(const glm::ivec3& chunkPos) {
+	const uint64_t x = (uint64_t)(chunkPos.x & ChunkKeyMask24);
+	const uint64_t y = (uint64_t)(chunkPos.y & 0xFFFF);
+	const uint64_t z = (uint64_t)(chunkPos.z & ChunkKeyMask24);
+	return (x << 40) | (y << 24) | z;
+}
+
+glm::ivec3 MapSnapshot::chunkPos(uint64_t key) {
+	// shift the values into the upper bits and back to restore the sign
+	const int32_t x = (int32_t)((uint32_t)(key >> 40) << 8) >> 8;
+	const int32_t y = (int16_t)(uint16_t)(key >> 24);
+	const int32_t z = (int32_t)((uint32_t)key << 8) >> 8;
+	return glm::ivec3(x, y, z);
+}
+
+core::String MapSnapshot::filename(MapId mapId) {
+	return core::string::format("snapshots/map-%i.snapshot", (int)mapId);
+}
+
+void MapSnapshot::addChunk(const glm::ivec3& chunkPos, const uint8_t* data, size_t size) {
+	_chunks.push_back(Chunk{chunkKey(chunkPos), (uint32_t)_chunkData.size(), (uint32_t)size});
+	_chunkData.append(data, size);
+}
+
+void MapSnapshot::addNpc(const Npc& npc) {
+	_npcs.push_back(npc);
+}
+
+void MapSnapshot::addAggro(const Aggro& aggro) {
+	_aggro.push_back(aggro);
+}
+
+void MapSnapshot::addGroupMember(const GroupMember& member) {
+	_groupMembers.push_back(member);
+}
+
+void MapSnapshot::clear() {
+	_chunkData.clear();
+	_chunks.clear();
+	_npcs.clear();
+	_aggro.clear();
+	_groupMembers.clear();
+}
+
+bool MapSnapshot::write(const io::FilesystemPtr& filesystem, const core::String& file) const {
+	core_trace_scoped(MapSnapshotWrite);
+	const size_t payloadSize = 2u * sizeof(uint32_t) + 4u * sizeof(uint32_t)
+			+ _chunks.size() * ChunkHeaderSize + _chunkData.size()
+			+ _npcs.size() * NpcSize + _aggro.size() * AggroSize + _groupMembers.size() * GroupMemberSize;
+	core::ByteStream payload((int)payloadSize);
+	payload.addInt((int32_t)seed);
+	payload.addInt((int32_t)chunkSideLength);
+	payload.addInt((int32_t)_chunks.size());
+	payload.addInt((int32_t)_npcs.size());
+	payload.addInt((int32_t)_aggro.size());
+	payload.addInt((int32_t)_groupMembers.size());
+	for (const Chunk& chunk : _chunks) {
+		payload.addLong((int64_t)chunk.key);
+		payload.addInt((int32_t)chunk.size);
+		payload.append(chunkData(chunk), chunk.size);
+	}
+	for (const Npc& npc : _npcs) {
+		payload.addInt(npc.id);
+		payload.addInt((int32_t)npc.type);
+		payload.addFloat(npc.pos.x);
+		payload.addFloat(npc.pos.y);
+		payload.addFloat(npc.pos.z);
+		payload.addInt(npc.homePos.x);
+		payload.addInt(npc.homePos.y);
+		payload.addInt(npc.homePos.z);
+		payload.addFloat(npc.orientation);
+	}
+	for (const Aggro& aggro : _aggro) {
+		payload.addInt(aggro.owner);
+		payload.addInt(aggro.target);
+		payload.addFloat(aggro.aggro);
+	}
+	for (const GroupMember& member : _groupMembers) {
+		payload.addInt(member.group);
+		payload.addInt(member.member);
+	}
+
+	core::ByteStream stream((int)(SnapshotHeaderSize + payload.getSize()));
+	stream.addInt(SnapshotMagic);
+	stream.addInt(Version);
+	stream.addInt((uint32_t)payload.getSize());
+	stream.addInt(core::hash(payload.getBuffer(), (int)payload.getSize()));
+	stream.append(payload.getBuffer(), payload.getSize());
+	if (!filesystem->write(file, stream.getBuffer(), stream.getSize())) {
+		Log::error("Failed to write the map snapshot %s", file.c_str());
+		return false;
+	}
+	Log::info("Wrote map snapshot %s with %i chunks and %i npcs (%i KB)", file.c_str(), (int)_chunks.size(),
+			(int)_npcs.size(), (int)(stream.getSize() / 1024u));
+	return true;
+}
+
+bool MapSnapshot::read(const io::FilesystemPtr& filesystem, const core::String& file) {
+	core_trace_scoped(MapSnapshotRead);
+	clear();
+	const io::MappedFile mappedFile(filesystem->homePath() + file);
+	if (!mappedFile.valid() || mappedFile.size() < SnapshotHeaderSize) {
+		Log::debug("No map snapshot found at %s", file.c_str());
+		return false;
+	}
+	core::ByteStream stream = core::ByteStream::view(mappedFile.data(), mappedFile.size());
+	const uint32_t magic = stream.readInt();
+	const uint32_t version = stream.readInt();
+	const uint32_t size = stream.readInt();
+	const uint32_t checksum = stream.readInt();
+	if (magic != SnapshotMagic || version != Version) {
+		Log::warn("Ignoring map snapshot %s with version %u (expected %u)", file.c_str(), version, Version);
+		return false;
+	}
+	if (size != (uint32_t)stream.getSize() || core::hash(stream.getBuffer(), (int)size) != checksum) {
+		Log::warn("Ignoring broken map snapshot %s", file.c_str());
+		return false;
+	}
+
+	seed = (unsigned int)stream.readInt();
+	chunkSideLength = (uint16_t)stream.readInt();
+	const int32_t chunks = stream.readInt();
+	const int32_t npcs = stream.readInt();
+	const int32_t aggro = stream.readInt();
+	const int32_t groupMembers = stream.readInt();
+	if (chunks < 0 || npcs < 0 || aggro < 0 || groupMembers < 0) {
+		Log::warn("Ignoring broken map snapshot %s", file.c_str());
+		return false;
+	}
+
+	_chunks.reserve(chunks);
+	_chunkData.reserve(stream.getSize());
+	for (int32_t i = 0; i < chunks; ++i) {
+		if ((size_t)stream.getSize() < ChunkHeaderSize) {
+			Log::warn("Ignoring truncated map snapshot %s", file.c_str());
+			clear();
+			return false;
+		}
+		const uint64_t key = (uint64_t)stream.readLong();
+		const uint32_t chunkSize = (uint32_t)stream.readInt();
+		if ((size_t)stream.getSize() < chunkSize) {
+			Log::warn("Ignoring truncated map snapshot %s", file.c_str());
+			clear();
+			return false;
+		}
+		_chunks.push_back(Chunk{key, (uint32_t)_chunkData.size(), chunkSize});
+		_chunkData.append(stream.getBuffer(), chunkSize);
+		stream.skip(chunkSize);
+	}
+
+	const size_t remaining = npcs * NpcSize + aggro * AggroSize + groupMembers * GroupMemberSize;
+	if ((size_t)stream.getSize() != remaining) {
+		Log::warn("Ignoring truncated map snapshot %s", file.c_str());
+		clear();
+		return false;
+	}
+	_npcs.reserve(npcs);
+	for (int32_t i = 0; i < npcs; ++i) {
+		Npc npc;
+		npc.id = stream.readInt();
+		npc.type = (network::EntityType)stream.readInt();
+		npc.pos.x = stream.readFloat();
+		npc.pos.y = stream.readFloat();
+		npc.pos.z = stream.readFloat();
+		npc.homePos.x = stream.readInt();
+		npc.homePos.y = stream.readInt();
+		npc.homePos.z = stream.readInt();
+		npc.orientation = stream.readFloat();
+		_npcs.push_back(npc);
+	}
+	_aggro.reserve(aggro);
+	for (int32_t i = 0; i < aggro; ++i) {
+		Aggro entry;
+		entry.owner = stream.readInt();
+		entry.target = stream.readInt();
+		entry.aggro = stream.readFloat();
+		_aggro.push_back(entry);
+	}
+	_groupMembers.reserve(groupMembers);
+	for (int32_t i = 0; i < groupMembers; ++i) {
+		GroupMember member;
+		member.group = stream.readInt();
+		member.member = stream.readInt();
+		_groupMembers.push_back(member);
+	}
+	return true;
+}
+
+}
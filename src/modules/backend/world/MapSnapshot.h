@@ -0,0 +1,132 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "ServerMessages_generated.h"
+#include "ai-shared/common/CharacterId.h"
+#include "backend/entity/ai/group/GroupId.h"
+#include "core/String.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include "io/Filesystem.h"
+#include "MapId.h"
+#include <glm/vec3.hpp>
+#include <stdint.h>
+
+namespace backend {
+
+/**
+ * @brief The state of a @c Map that is needed for a warm restart
+ *
+ * Contains the resident chunks (compact chunk keys plus the compressed voxels), the npc population with the
+ * positions and the aggro and group state of their @c AI instances. It is written on shutdown and restored in bulk
+ * at startup - before the server accepts connections.
+ *
+ * The file is versioned and has a checksum - if anything doesn't match, the snapshot is ignored and the map starts
+ * cold.
+ *
+ * @note The npc ids are only valid inside the snapshot - the restored npcs get new ids.
+ */
+class MapSnapshot {
+public:
+	static constexpr uint32_t Version = 1u;
+
+	struct Chunk {
+		uint64_t key;
+		/** @brief offset into the chunk data buffer */
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	struct Npc {
+		ai::CharacterId id;
+		network::EntityType type;
+		glm::vec3 pos;
+		glm::ivec3 homePos;
+		float orientation;
+	};
+
+	struct Aggro {
+		/** @brief the npc that has the aggro */
+		ai::CharacterId owner;
+		/** @brief an npc of the snapshot or any other entity (e.g. a user) */
+		ai::CharacterId target;
+		float aggro;
+	};
+
+	/**
+	 * @brief The leader is stored as the first member of a group
+	 */
+	struct GroupMember {
+		GroupId group;
+		ai::CharacterId member;
+	};
+
+private:
+	core::Buffer<uint8_t> _chunkData;
+	core::DynamicArray<Chunk> _chunks;
+	core::DynamicArray<Npc> _npcs;
+	core::DynamicArray<Aggro> _aggro;
+	core::DynamicArray<GroupMember> _groupMembers;
+
+public:
+	unsigned int seed = 0u;
+	uint16_t chunkSideLength = 0u;
+
+	/**
+	 * @brief Packs the chunk space position into one key - x and z with 24 bits and y with 16 bits
+	 */
+	static uint64_t chunkKey(const glm::ivec3& chunkPos);
+	static glm::ivec3 chunkPos(uint64_t key);
+
+	/**
+	 * @return The file name (relative to the home path) of the snapshot for the given map
+	 */
+	static core::String filename(MapId mapId);
+
+	/**
+	 * @param[in] data The chunk as written by @c voxelworld::ChunkPersister::saveCompressed()
+	 */
+	void addChunk(const glm::ivec3& chunkPos, const uint8_t* data, size_t size);
+	void addNpc(const Npc& npc);
+	void addAggro(const Aggro& aggro);
+	void addGroupMember(const GroupMember& member);
+
+	const core::DynamicArray<Chunk>& chunks() const;
+	const uint8_t* chunkData(const Chunk& chunk) const;
+	const core::DynamicArray<Npc>& npcs() const;
+	const core::DynamicArray<Aggro>& aggro() const;
+	const core::DynamicArray<GroupMember>& groupMembers() const;
+
+	void clear();
+
+	bool write(const io::FilesystemPtr& filesystem, const core::String& file) const;
+	/**
+	 * @return @c false if the file doesn't exist, has a different version or is broken
+	 */
+	bool read(const io::FilesystemPtr& filesystem, const core::String& file);
+};
+
+inline const core::DynamicArray<MapSnapshot::Chunk>& MapSnapshot::chunks() const {
+	return _chunks;
+}
+
+inline const uint8_t* MapSnapshot::chunkData(const Chunk& chunk) const {
+	return _chunkData.data() + chunk.offset;
+}
+
+inline const core::DynamicArray<MapSnapshot::Npc>& MapSnapshot::npcs() const {
+	return _npcs;
+}
+
+inline const core::DynamicArray<MapSnapshot::Aggro>& MapSnapshot::aggro() const {
+	return _aggro;
+}
+
+inline const core::DynamicArray<MapSnapshot::GroupMember>& MapSnapshot::groupMembers() const {
+	return _groupMembers;
+}
+
+}
@@ -38,6 +38,7 @@ void World::update(long dt) {
 		const MapPtr& map = e.second;
 		map->update(dt);
 	}
+	_registry->update(dt);
 	_aiServer->update(dt);
 }
 
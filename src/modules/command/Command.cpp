@@ -14,7 +14,12 @@ core::ReadWriteLock Command::_lock("Command");
 core::DynamicArray<core::String> Command::_delayedTokens;
 double Command::_delaySeconds = 0.0;
 size_t  Command::_sortedCommandListSize = 0u;
-Command* Command::_sortedCommandList[4096] {};
+Command* Command::_sortedCommandList[MaxCommands] {};
+core::AtomicPtr<Command> Command::_slots[MaxCommands] {};
+core::StringIdMap<uint32_t> Command::_slotIds;
+uint32_t Command::_slotCount = 0u;
+core::AtomicInt Command::_generation(1);
+core::DynamicArray<Command*> Command::_retired;
 
 ActionButtonCommands& ActionButtonCommands::setBindingContext(int context) {
 	Command::getCommand(first)->setBindingContext(context);
@@ -28,19 +33,59 @@ ActionButtonCommands& ActionButtonCommands::setHelp(const char* help) {
 	return *this;
 }
 
+uint32_t Command::slot(const core::StringId& name) {
+	uint32_t idx = 0u;
+	if (_slotIds.get(name, idx)) {
+		return idx;
+	}
+	if (_slotCount >= (uint32_t)MaxCommands) {
+		Log::error("Max command handles exceeded - can't resolve %s", name.c_str());
+		return (uint32_t)MaxCommands;
+	}
+	idx = _slotCount++;
+	_slotIds.put(name, idx);
+	return idx;
+}
+
+void Command::put(const core::StringId& name, Command* command) {
+	Command* old = nullptr;
+	if (_cmds.get(name, old)) {
+		_retired.push_back(old);
+	}
+	_cmds.put(name, command);
+	const uint32_t idx = slot(name);
+	if (idx < (uint32_t)MaxCommands) {
+		_slots[idx] = command;
+	}
+}
+
+bool Command::remove(const core::StringId& name) {
+	Command* old = nullptr;
+	if (!_cmds.get(name, old)) {
+		return false;
+	}
+	_cmds.remove(name);
+	const uint32_t idx = slot(name);
+	if (idx < (uint32_t)MaxCommands) {
+		_slots[idx] = nullptr;
+	}
+	_retired.push_back(old);
+	return true;
+}
+
 Command& Command::registerCommand(const char* name, FunctionType&& func) {
-	const core::String cname(name);
-	const Command c(cname, std::forward<FunctionType>(func));
+	const core::StringId id(name);
+	Command* c = new Command(id.str(), std::forward<FunctionType>(func));
 	core::ScopedWriteLock lock(_lock);
-	_cmds.put(cname, c);
+	put(id, c);
 	updateSortedList();
-	return (Command&)_cmds.find(cname)->value;
+	return *c;
 }
 
 bool Command::unregisterCommand(const char* name) {
-	const core::String cname(name);
+	const core::StringId id = core::StringId::find(name);
 	core::ScopedWriteLock lock(_lock);
-	const bool removed = _cmds.remove(cname);
+	const bool removed = remove(id);
 	if (removed) {
 		updateSortedList();
 	}
@@ -48,19 +93,24 @@ bool Command::unregisterCommand(const char* name) {
 }
 
 ActionButtonCommands Command::registerActionButton(const core::String& name, ActionButton& button) {
-	core::ScopedWriteLock lock(_lock);
-	const Command cPressed("+" + name, [&] (const command::CmdArgs& args) {
+	Command* cPressed = new Command("+" + name, [&] (const command::CmdArgs& args) {
 		const int32_t key = args.size() >= 1 ? args[0].toInt() : 0;
 		const double seconds = args.size() >= 2 ? core::string::toDouble(args[1]) : 0.0;
 		button.handleDown(key, seconds);
 	});
-	_cmds.put(cPressed.name(), cPressed);
-	const Command cReleased("-" + name, [&] (const command::CmdArgs& args) {
+	cPressed->_button = &button;
+	cPressed->_buttonDown = true;
+	Command* cReleased = new Command("-" + name, [&] (const command::CmdArgs& args) {
 		const int32_t key = args.size() >= 1 ? args[0].toInt() : 0;
 		const double seconds = args.size() >= 2 ? core::string::toDouble(args[1]) : 0.0;
 		button.handleUp(key, seconds);
 	});
-	_cmds.put(cReleased.name(), cReleased);
+	cReleased->_button = &button;
+	const core::StringId pressedId(cPressed->name());
+	const core::StringId releasedId(cReleased->name());
+	core::ScopedWriteLock lock(_lock);
+	put(pressedId, cPressed);
+	put(releasedId, cReleased);
 	updateSortedList();
 	return ActionButtonCommands("+" + name, "-" + name);
 }
@@ -69,8 +119,8 @@ bool Command::unregisterActionButton(const core::String& name) {
 	core::ScopedWriteLock lock(_lock);
 	const core::String downB("+" + name);
 	const core::String upB("-" + name);
-	int amount = _cmds.remove(downB);
-	amount += _cmds.remove(upB);
+	int amount = remove(core::StringId::find(downB));
+	amount += remove(core::StringId::find(upB));
 	updateSortedList();
 	return amount == 2;
 }
@@ -111,7 +161,7 @@ void Command::updateSortedList() {
 	core_assert((int)_cmds.size() < lengthof(_sortedCommandList));
 	_sortedCommandListSize = 0u;
 	for (auto i = _cmds.begin(); i != _cmds.end(); ++i) {
-		_sortedCommandList[_sortedCommandListSize++] = &i->value;
+		_sortedCommandList[_sortedCommandListSize++] = i->value;
 	}
 	SDL_qsort(_sortedCommandList, _sortedCommandListSize, sizeof(Command*), [] (const void *v1, const void *v2) {
 		return SDL_strcmp((*(const Command**)v1)->name(), (*(const Command**)v2)->name());
@@ -174,6 +224,27 @@ bool Command::isSuitableBindingContext(core::BindingContext context) {
 	return (core::bindingContext() & context) != 0;
 }
 
+bool Command::execute(Command* cmd, const CmdArgs& args) {
+	if (!isSuitableBindingContext(cmd->_bindingContext)) {
+		Log::trace("command '%s' has binding context  %i - but we are in %i", cmd->name(), (int) cmd->_bindingContext,
+				(int) core::bindingContext());
+		return false;
+	}
+	if (_delaySeconds > 0.0) {
+		core::String fullCmd = cmd->_name;
+		for (const core::String& arg : args) {
+			fullCmd.append(" ");
+			fullCmd.append(arg);
+		}
+		Log::debug("delay %s", fullCmd.c_str());
+		_delayedTokens.push_back(fullCmd);
+		return true;
+	}
+	Log::debug("execute %s with %i arguments", cmd->name(), (int)args.size());
+	cmd->_func(args);
+	return true;
+}
+
 bool Command::execute(const core::String& command, const CmdArgs& args) {
 	if (command == "wait") {
 		if (args.size() == 1) {
@@ -187,39 +258,132 @@ bool Command::execute(const core::String& command, const CmdArgs& args) {
 		Log::warn("Skip execution of %s - no arguments provided", command.c_str());
 		return false;
 	}
-	Command cmd;
-	{
-		core::ScopedReadLock scoped(_lock);
-		auto i = _cmds.find(command);
-		if (i == _cmds.end()) {
-			Log::debug("could not find command callback for %s", command.c_str());
-			return false;
+	Command* cmd = getCommand(command);
+	if (cmd == nullptr) {
+		Log::debug("could not find command callback for %s", command.c_str());
+		return false;
+	}
+	return execute(cmd, args);
+}
+
+CommandHandle Command::handle(const core::String& name) {
+	const CommandHandle handle(core::StringId{name});
+	resolve(handle);
+	return handle;
+}
+
+Command* Command::resolve(const CommandHandle& handle) {
+	if (!handle.valid()) {
+		return nullptr;
+	}
+	const int generation = _generation;
+	if (handle._generation != generation) {
+		core::ScopedWriteLock lock(_lock);
+		handle._slot = slot(handle._name);
+		handle._generation = generation;
+	}
+	if (handle._slot >= (uint32_t)MaxCommands) {
+		return nullptr;
+	}
+	return _slots[handle._slot];
+}
+
+bool Command::execute(const CommandHandle& handle, const CmdArgs& args) {
+	Command* cmd = resolve(handle);
+	if (cmd == nullptr) {
+		Log::debug("could not find command callback for %s", handle.name().c_str());
+		return false;
+	}
+	if (cmd->_button != nullptr && args.empty()) {
+		Log::warn("Skip execution of %s - no arguments provided", cmd->name());
+		return false;
+	}
+	return execute(cmd, args);
+}
+
+bool Command::execute(const CommandHandle& handle, int32_t key, double seconds) {
+	Command* cmd = resolve(handle);
+	if (cmd == nullptr) {
+		Log::debug("could not find command callback for %s", handle.name().c_str());
+		return false;
+	}
+	if (cmd->_button == nullptr || _delaySeconds > 0.0 || !isSuitableBindingContext(cmd->_bindingContext)) {
+		// not an action button - or it's not executed right now - use the string arguments
+		CmdArgs args;
+		args.push_back(core::string::toString(key));
+		args.push_back(core::string::toString(seconds));
+		return execute(cmd, args);
+	}
+	if (cmd->_buttonDown) {
+		cmd->_button->handleDown(key, seconds);
+	} else {
+		cmd->_button->handleUp(key, seconds);
+	}
+	return true;
+}
+
+bool Command::prepare(const core::String& commandLine, PreparedCommands& commands) {
+	commands.clear();
+	core::Tokenizer commandLineTokenizer(false, commandLine, ";\n");
+	while (commandLineTokenizer.hasNext()) {
+		const core::String& fullCmd = commandLineTokenizer.next();
+		if (fullCmd.empty()) {
+			continue;
+		}
+		if (fullCmd[0] == '#') {
+			continue;
+		}
+		if (fullCmd.size() >= 2 && fullCmd[0] == '/' && fullCmd[1] == '/') {
+			continue;
 		}
-		if (!isSuitableBindingContext(i->second._bindingContext)) {
-			Log::trace("command '%s' has binding context  %i - but we are in %i", command.c_str(), (int) i->second._bindingContext,
-					(int) core::bindingContext());
+		core::Tokenizer commandTokenizer(false, fullCmd, " ");
+		if (!commandTokenizer.hasNext()) {
+			continue;
+		}
+		const core::String& c = commandTokenizer.next();
+		if (c == "wait") {
+			// changes how the following commands are executed
+			commands.clear();
 			return false;
 		}
-		if (_delaySeconds > 0.0) {
-			core::String fullCmd = command;
-			for (const core::String& arg : args) {
-				fullCmd.append(" ");
-				fullCmd.append(arg);
-			}
-			Log::debug("delay %s", fullCmd.c_str());
-			_delayedTokens.push_back(fullCmd);
-			return true;
+		PreparedCommand prepared;
+		prepared.handle = handle(c);
+		while (commandTokenizer.hasNext()) {
+			prepared.args.push_back(commandTokenizer.next());
 		}
-		cmd = i->second;
+		commands.push_back(prepared);
 	}
-	Log::debug("execute %s with %i arguments", command.c_str(), (int)args.size());
-	cmd._func(args);
 	return true;
 }
 
+int Command::execute(const PreparedCommands& commands) {
+	int executed = 0;
+	for (const PreparedCommand& command : commands) {
+		if (execute(command.handle, command.args)) {
+			++executed;
+		}
+	}
+	return executed;
+}
+
 void Command::shutdown() {
 	core::ScopedWriteLock lock(_lock);
+	for (auto i = _cmds.begin(); i != _cmds.end(); ++i) {
+		delete i->value;
+	}
 	_cmds.clear();
+	for (Command* cmd : _retired) {
+		delete cmd;
+	}
+	_retired.clear();
+	for (uint32_t i = 0u; i < _slotCount; ++i) {
+		_slots[i] = nullptr;
+	}
+	_slotIds.clear();
+	_slotCount = 0u;
+	_sortedCommandListSize = 0u;
+	// the handles have to resolve their slot again
+	_generation.increment();
 }
 
 Command& Command::setHelp(const char* help) {
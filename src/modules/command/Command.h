@@ -7,8 +7,9 @@
 #include "core/String.h"
 #include "core/Common.h"
 #include "core/StringUtil.h"
-#include "core/collection/StringMap.h"
+#include "core/StringId.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
 #include "core/concurrent/ReadWriteLock.h"
 #include "command/ActionButton.h"
 #include <memory>
@@ -18,6 +19,48 @@ namespace command {
 
 typedef core::DynamicArray<core::String> CmdArgs;
 
+class Command;
+
+/**
+ * @brief A command name that is resolved once
+ *
+ * Executing a command by handle doesn't look up the name and doesn't take the command lock. The handle can be
+ * created before the command is registered, and it follows the command if it is unregistered and registered again.
+ *
+ * @sa Command::handle()
+ */
+class CommandHandle {
+private:
+	friend class Command;
+	core::StringId _name;
+	mutable uint32_t _slot = 0u;
+	mutable int _generation = 0;
+public:
+	CommandHandle() {
+	}
+	explicit CommandHandle(const core::StringId& name) :
+			_name(name) {
+	}
+
+	inline bool valid() const {
+		return _name.valid();
+	}
+
+	inline const core::StringId& name() const {
+		return _name;
+	}
+};
+
+/**
+ * @brief A single command of a command line with its already tokenized arguments
+ * @sa Command::prepare()
+ */
+struct PreparedCommand {
+	CommandHandle handle;
+	CmdArgs args;
+};
+typedef core::DynamicArray<PreparedCommand> PreparedCommands;
+
 struct ActionButtonCommands {
 	const core::String first;
 	const core::String second;
@@ -39,13 +82,28 @@ struct ActionButtonCommands {
  */
 class Command {
 private:
-	typedef core::StringMap<Command> CommandMap;
+	static constexpr int MaxCommands = 4096;
+	typedef core::StringIdMap<Command*> CommandMap;
 	typedef std::function<void(const CmdArgs&)> FunctionType;
 
 	static CommandMap _cmds;
 	static core::ReadWriteLock _lock;
 	static size_t _sortedCommandListSize;
-	static Command* _sortedCommandList[4096];
+	static Command* _sortedCommandList[MaxCommands];
+
+	/**
+	 * The handles point into this table. The slots are assigned per name and are only reset by shutdown(), which
+	 * also increases the generation to invalidate the resolved handles.
+	 */
+	static core::AtomicPtr<Command> _slots[MaxCommands];
+	static core::StringIdMap<uint32_t> _slotIds;
+	static uint32_t _slotCount;
+	static core::AtomicInt _generation;
+	/**
+	 * Replaced or unregistered commands - they are only deleted in shutdown() because a handle might still
+	 * execute them
+	 */
+	static core::DynamicArray<Command*> _retired;
 
 	static double _delaySeconds;
 	static core::DynamicArray<core::String> _delayedTokens;
@@ -56,6 +114,11 @@ private:
 	core::BindingContext _bindingContext = core::BindingContext::All;
 	typedef std::function<int(const core::String&, core::DynamicArray<core::String>& matches)> CompleteFunctionType;
 	mutable CompleteFunctionType _completer;
+	/**
+	 * The action button for the @c + and @c - commands - see registerActionButton()
+	 */
+	ActionButton* _button = nullptr;
+	bool _buttonDown = false;
 
 	Command() :
 		_name(""), _help(nullptr), _func() {
@@ -66,6 +129,20 @@ private:
 	}
 
 	static void updateSortedList();
+	/**
+	 * @note Requires the write lock
+	 */
+	static uint32_t slot(const core::StringId& name);
+	/**
+	 * @note Requires the write lock
+	 */
+	static void put(const core::StringId& name, Command* command);
+	/**
+	 * @note Requires the write lock
+	 */
+	static bool remove(const core::StringId& name);
+	static Command* resolve(const CommandHandle& handle);
+	static bool execute(Command* cmd, const CmdArgs& args);
 
 public:
 	static Command& registerCommand(const char* name, std::function<void(void)>& func) {
@@ -98,21 +175,48 @@ public:
 	static int execute(CORE_FORMAT_STRING const char* msg, ...) CORE_PRINTF_VARARG_FUNC(1);
 
 	static bool execute(const core::String& command, const CmdArgs& args);
+
+	/**
+	 * @brief Creates the handle for the given command name - the command doesn't need to be registered yet
+	 */
+	static CommandHandle handle(const core::String& name);
+	static bool execute(const CommandHandle& handle, const CmdArgs& args);
+	/**
+	 * @brief Executes the @c + or @c - command of an action button without converting the key and the time into
+	 * string arguments
+	 */
+	static bool execute(const CommandHandle& handle, int32_t key, double seconds);
+
+	/**
+	 * @brief Tokenizes the given command line once, for the commands that are executed often - like the key bindings
+	 * @return @c false if the command line can't be executed via handles (e.g. because it contains a @c wait)
+	 */
+	static bool prepare(const core::String& commandLine, PreparedCommands& commands);
+	/**
+	 * @return The amount of executed commands
+	 */
+	static int execute(const PreparedCommands& commands);
+
 	static bool isSuitableBindingContext(core::BindingContext context);
 
 	static Command* getCommand(const core::String& name) {
+		return getCommand(core::StringId::find(name));
+	}
+
+	static Command* getCommand(const core::StringId& name) {
+		core::ScopedReadLock lock(_lock);
 		auto i = _cmds.find(name);
 		if (i == _cmds.end()) {
 			return nullptr;
 		}
-		return (Command*)&i->value;
+		return i->value;
 	}
 
 	template<class Functor>
 	static void visit(Functor&& func) {
 		core::ScopedReadLock lock(_lock);
 		for (auto i = _cmds.begin(); i != _cmds.end(); ++i) {
-			func(i->value);
+			func(*i->value);
 		}
 	}
 
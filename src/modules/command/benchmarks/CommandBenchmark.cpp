@@ -0,0 +1,84 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "command/Command.h"
+#include "command/ActionButton.h"
+
+namespace {
+
+/**
+ * @brief Key binding of an action button - pressed and released via the string command
+ */
+void bindingDispatchString(benchmark::State& state) {
+	command::ActionButton button;
+	command::Command::registerActionButton("benchmark", button);
+	double seconds = 0.0;
+	for (auto _ : state) {
+		command::Command::execute("+benchmark %i %f", 1, seconds);
+		command::Command::execute("-benchmark %i %f", 1, seconds + 0.1);
+		seconds += 1.0;
+	}
+	command::Command::shutdown();
+}
+
+/**
+ * @brief Key binding of an action button - pressed and released via the resolved handles
+ */
+void bindingDispatchHandle(benchmark::State& state) {
+	command::ActionButton button;
+	command::Command::registerActionButton("benchmark", button);
+	const command::CommandHandle pressed = command::Command::handle("+benchmark");
+	const command::CommandHandle released = command::Command::handle("-benchmark");
+	double seconds = 0.0;
+	for (auto _ : state) {
+		command::Command::execute(pressed, 1, seconds);
+		command::Command::execute(released, 1, seconds + 0.1);
+		seconds += 1.0;
+	}
+	command::Command::shutdown();
+}
+
+const char *CommandLine = "benchmark 1 2;benchmark 3";
+
+/**
+ * @brief Console input - the command line is tokenized for each execution
+ */
+void consoleExecute(benchmark::State& state) {
+	int executed = 0;
+	command::Command::registerCommand("benchmark", [&] (const command::CmdArgs& args) {
+		executed += (int)args.size();
+	});
+	for (auto _ : state) {
+		command::Command::execute(CommandLine);
+	}
+	benchmark::DoNotOptimize(executed);
+	command::Command::shutdown();
+}
+
+/**
+ * @brief Bound command line - tokenized once
+ */
+void preparedExecute(benchmark::State& state) {
+	int executed = 0;
+	command::Command::registerCommand("benchmark", [&] (const command::CmdArgs& args) {
+		executed += (int)args.size();
+	});
+	command::PreparedCommands commands;
+	command::Command::prepare(CommandLine, commands);
+	for (auto _ : state) {
+		command::Command::execute(commands);
+	}
+	benchmark::DoNotOptimize(executed);
+	command::Command::shutdown();
+}
+
+}
+
+BENCHMARK(bindingDispatchString);
+BENCHMARK(bindingDispatchHandle);
+BENCHMARK(consoleExecute);
+BENCHMARK(preparedExecute);
+
+BENCHMARK_MAIN();
@@ -77,4 +77,80 @@ TEST_F(CommandTest, textExecuteSemicolonAsParameter) {
 	EXPECT_EQ(";", parameter);
 }
 
+TEST_F(CommandTest, testHandle) {
+	int executed = 0;
+	const command::CommandHandle handle = Command::handle("test");
+	EXPECT_FALSE(Command::execute(handle, CmdArgs()));
+	Command::registerCommand("test", [&] (const command::CmdArgs&) {
+		++executed;
+	});
+	EXPECT_TRUE(Command::execute(handle, CmdArgs()));
+	EXPECT_EQ(1, executed);
+	EXPECT_TRUE(Command::unregisterCommand("test"));
+	EXPECT_FALSE(Command::execute(handle, CmdArgs()));
+	Command::registerCommand("test", [&] (const command::CmdArgs&) {
+		executed += 10;
+	});
+	EXPECT_TRUE(Command::execute(handle, CmdArgs()));
+	EXPECT_EQ(11, executed);
+}
+
+TEST_F(CommandTest, testHandleAfterShutdown) {
+	int executed = 0;
+	Command::registerCommand("test", [&] (const command::CmdArgs&) {
+		++executed;
+	});
+	const command::CommandHandle handle = Command::handle("test");
+	Command::shutdown();
+	// the slot of the handle is assigned to another command now
+	Command::registerCommand("other", [&] (const command::CmdArgs&) {
+		executed += 100;
+	});
+	EXPECT_FALSE(Command::execute(handle, CmdArgs()));
+	Command::registerCommand("test", [&] (const command::CmdArgs&) {
+		executed += 10;
+	});
+	EXPECT_TRUE(Command::execute(handle, CmdArgs()));
+	EXPECT_EQ(10, executed);
+}
+
+TEST_F(CommandTest, testPrepare) {
+	core::String parameter;
+	int testExecuted = 0;
+	Command::registerCommand("test", [&] (const command::CmdArgs&) {
+		++testExecuted;
+	});
+	Command::registerCommand("testparameter", [&] (const command::CmdArgs& args) {
+		parameter = args.empty() ? "empty" : args[0];
+	});
+	PreparedCommands commands;
+	ASSERT_TRUE(Command::prepare("test;testparameter 42; test", commands));
+	ASSERT_EQ(3u, commands.size());
+	EXPECT_EQ(3, Command::execute(commands));
+	EXPECT_EQ(3, Command::execute(commands));
+	EXPECT_EQ(4, testExecuted);
+	EXPECT_EQ("42", parameter);
+	EXPECT_FALSE(Command::prepare("test;wait 1;test", commands));
+	EXPECT_TRUE(commands.empty());
+}
+
+TEST_F(CommandTest, testActionButtonHandle) {
+	ActionButton button;
+	Command::registerActionButton("testaction", button);
+	const command::CommandHandle pressed = Command::handle("+testaction");
+	const command::CommandHandle released = Command::handle("-testaction");
+	EXPECT_TRUE(Command::execute(pressed, 1, 1.0));
+	EXPECT_TRUE(button.pressed());
+	EXPECT_TRUE(Command::execute(released, 1, 1.5));
+	EXPECT_FALSE(button.pressed());
+	EXPECT_DOUBLE_EQ(0.5, button.durationSeconds);
+	// the string execution still works
+	EXPECT_EQ(1, Command::execute("+testaction 2 2.0"));
+	EXPECT_TRUE(button.pressed());
+	EXPECT_EQ(1, Command::execute("-testaction 2 2.0"));
+	EXPECT_FALSE(button.pressed());
+	EXPECT_TRUE(Command::unregisterActionButton("testaction"));
+	EXPECT_FALSE(Command::execute(pressed, 1, 3.0));
+}
+
 }
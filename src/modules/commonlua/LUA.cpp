@@ -6,6 +6,8 @@
 #include "core/Assert.h"
 #include "core/Log.h"
 #include "core/StringUtil.h"
+#include "core/TimeProvider.h"
+#include "core/Trace.h"
 #include "LUAFunctions.h"
 #include "Trace.h"
 #include "engine-config.h"
@@ -69,6 +71,7 @@ LUA::LUA(bool debug) :
 
 LUA::~LUA() {
 	closeState();
+	delete _allocator;
 }
 
 static int clua_print(lua_State *L) {
@@ -86,7 +89,11 @@ static int clua_print(lua_State *L) {
 void LUA::openState() {
 	_error.clear();
 
-	_state = luaL_newstate();
+	if (_allocator == nullptr) {
+		_allocator = new LUAAllocator();
+	}
+	_state = lua_newstate(LUAAllocator::alloc, _allocator);
+	_memoryAfterCycle = 0u;
 
 	luaL_openlibs(_state);
 
@@ -135,9 +142,60 @@ bool LUA::resetState() {
 
 	closeState();
 	openState();
+	setManualGC(_manualGC);
 	return true;
 }
 
+void LUA::setManualGC(bool manual) {
+	_manualGC = manual;
+	if (manual) {
+		lua_gc(_state, LUA_GCINC, 0, 0, 0);
+		lua_gc(_state, LUA_GCSTOP);
+		_memoryAfterCycle = memoryInUse();
+	} else {
+		lua_gc(_state, LUA_GCRESTART);
+	}
+}
+
+size_t LUA::memoryInUse() const {
+	return (size_t)lua_gc(_state, LUA_GCCOUNT) * 1024u + (size_t)lua_gc(_state, LUA_GCCOUNTB);
+}
+
+bool LUA::gcStep(uint64_t budgetMicros) {
+	core_trace_scoped(LUAGCStep);
+	const uint64_t resolution = core::TimeProvider::highResTimeResolution();
+	const uint64_t start = core::TimeProvider::highResTime();
+	const uint64_t budget = budgetMicros * resolution / 1000000u;
+	// safety net for states that allocate faster than the budget allows to collect
+	constexpr size_t EmergencyThreshold = 1024u * 1024u;
+	if (memoryInUse() > _memoryAfterCycle * 2u + EmergencyThreshold) {
+		lua_gc(_state, LUA_GCCOLLECT);
+		_memoryAfterCycle = memoryInUse();
+		const uint64_t micros = (core::TimeProvider::highResTime() - start) * 1000000u / resolution;
+		++_gcStats.emergencyCollections;
+		++_gcStats.cycles;
+		_gcStats.micros += micros;
+		_gcStats.maxStepMicros = core_max(_gcStats.maxStepMicros, micros);
+		return true;
+	}
+	bool finished = false;
+	uint64_t now = start;
+	do {
+		const uint64_t stepStart = now;
+		// a step size of 0 is a single basic step of the incremental collector
+		finished = lua_gc(_state, LUA_GCSTEP, 0) != 0;
+		now = core::TimeProvider::highResTime();
+		++_gcStats.steps;
+		_gcStats.maxStepMicros = core_max(_gcStats.maxStepMicros, (now - stepStart) * 1000000u / resolution);
+	} while (!finished && now - start < budget);
+	_gcStats.micros += (now - start) * 1000000u / resolution;
+	if (finished) {
+		++_gcStats.cycles;
+		_memoryAfterCycle = memoryInUse();
+	}
+	return finished;
+}
+
 void LUA::reg(const core::String& prefix, const luaL_Reg* funcs) {
 	const core::String metaTableName = META_PREFIX + prefix;
 	luaL_newmetatable(_state, metaTableName.c_str());
@@ -19,6 +19,7 @@ extern "C" {
 
 #include "core/String.h"
 #include "core/NonCopyable.h"
+#include "LUAAllocator.h"
 
 // https://wiki.gentoo.org/wiki/Lua/Porting_notes
 
@@ -50,11 +51,27 @@ struct LUAFunction {
 };
 
 class LUA : public core::NonCopyable {
+public:
+	struct GCStats {
+		uint64_t steps = 0u;
+		/** @brief the amount of finished collection cycles */
+		uint64_t cycles = 0u;
+		/** @brief full collections because the budget was too small to keep up with the allocations */
+		uint64_t emergencyCollections = 0u;
+		uint64_t micros = 0u;
+		uint64_t maxStepMicros = 0u;
+	};
 private:
 	lua_State *_state;
 	core::String _error;
 	bool _destroy;
 	bool _debug;
+	/** @brief only available if the state is managed by this instance */
+	LUAAllocator *_allocator = nullptr;
+	bool _manualGC = false;
+	/** @brief memory in use after the last finished collection cycle */
+	size_t _memoryAfterCycle = 0u;
+	GCStats _gcStats;
 
 	void openState();
 	void closeState();
@@ -75,6 +92,33 @@ public:
 	 */
 	bool resetState();
 
+	/**
+	 * @brief Stops the automatic garbage collector of lua. The owner of the state has to call @c gcStep()
+	 * regularly (e.g. once per frame or tick) to collect the garbage.
+	 */
+	void setManualGC(bool manual);
+	bool manualGC() const;
+	/**
+	 * @brief Performs incremental garbage collection steps until the time budget is used up or a collection
+	 * cycle is finished. At least one step is done.
+	 *
+	 * If the memory grows faster than the steps can collect, a full collection is done to put an upper bound
+	 * on the memory usage. See @c GCStats::emergencyCollections.
+	 *
+	 * @param[in] budgetMicros The time in microseconds that can be spent
+	 * @return @c true if a collection cycle was finished
+	 */
+	bool gcStep(uint64_t budgetMicros);
+	const GCStats& gcStats() const;
+	/**
+	 * @return The allocator statistics - or @c nullptr if the state is not managed by this instance
+	 */
+	const LUAAllocator::Stats* memoryStats() const;
+	/**
+	 * @return The amount of bytes lua has in use
+	 */
+	size_t memoryInUse() const;
+
 	template<class T>
 	static T* newGlobalData(lua_State *L, const core::String& prefix, T *userData) {
 		lua_pushlightuserdata(L, userData);
@@ -166,6 +210,21 @@ inline lua_State* LUA::state() const {
 	return _state;
 }
 
+inline bool LUA::manualGC() const {
+	return _manualGC;
+}
+
+inline const LUA::GCStats& LUA::gcStats() const {
+	return _gcStats;
+}
+
+inline const LUAAllocator::Stats* LUA::memoryStats() const {
+	if (_allocator == nullptr) {
+		return nullptr;
+	}
+	return &_allocator->stats();
+}
+
 inline void LUA::setError(const core::String& error) {
 	_error = error;
 }
@@ -0,0 +1,123 @@
+/**
+ * @file
+ */
+
+#include "LUAAllocator.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+
+namespace lua {
+
+namespace {
+// the slab header must not break the alignment of the blocks
+constexpr size_t SlabHeaderSize = LUAAllocator::Granularity;
+}
+
+LUAAllocator::~LUAAllocator() {
+	Slab* slab = _slabs;
+	while (slab != nullptr) {
+		Slab* next = slab->next;
+		core_free(slab);
+		slab = next;
+	}
+}
+
+bool LUAAllocator::fill(int sizeClass) {
+	Slab* slab = (Slab*)core_malloc(SlabSize);
+	if (slab == nullptr) {
+		return false;
+	}
+	slab->next = _slabs;
+	_slabs = slab;
+	_stats.slabBytes += SlabSize;
+
+	const size_t blockSize = (size_t)(sizeClass + 1) * Granularity;
+	uint8_t* begin = (uint8_t*)slab + SlabHeaderSize;
+	const size_t blocks = (SlabSize - SlabHeaderSize) / blockSize;
+	FreeBlock* head = _freeLists[sizeClass];
+	for (size_t i = blocks; i > 0u; --i) {
+		FreeBlock* block = (FreeBlock*)(begin + (i - 1u) * blockSize);
+		block->next = head;
+		head = block;
+	}
+	_freeLists[sizeClass] = head;
+	return true;
+}
+
+void* LUAAllocator::allocate(size_t size) {
+	void* ptr;
+	if (size <= MaxPooledSize) {
+		const int idx = sizeClass(size);
+		if (_freeLists[idx] == nullptr && !fill(idx)) {
+			return nullptr;
+		}
+		FreeBlock* block = _freeLists[idx];
+		_freeLists[idx] = block->next;
+		ptr = block;
+		++_stats.pooledAllocations;
+	} else {
+		ptr = core_malloc(size);
+		if (ptr == nullptr) {
+			return nullptr;
+		}
+	}
+	++_stats.allocations;
+	_stats.bytesInUse += size;
+	_stats.peakBytesInUse = core_max(_stats.peakBytesInUse, _stats.bytesInUse);
+	return ptr;
+}
+
+void LUAAllocator::release(void* ptr, size_t size) {
+	++_stats.frees;
+	_stats.bytesInUse -= size;
+	if (size <= MaxPooledSize) {
+		const int idx = sizeClass(size);
+		FreeBlock* block = (FreeBlock*)ptr;
+		block->next = _freeLists[idx];
+		_freeLists[idx] = block;
+		return;
+	}
+	core_free(ptr);
+}
+
+void* LUAAllocator::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+	LUAAllocator* allocator = (LUAAllocator*)ud;
+	// for new blocks osize is the type of the lua object - not a size
+	if (ptr == nullptr) {
+		if (nsize == 0u) {
+			return nullptr;
+		}
+		return allocator->allocate(nsize);
+	}
+	if (nsize == 0u) {
+		allocator->release(ptr, osize);
+		return nullptr;
+	}
+	if (osize > MaxPooledSize && nsize > MaxPooledSize) {
+		void* newPtr = core_realloc(ptr, nsize);
+		if (newPtr == nullptr) {
+			return nullptr;
+		}
+		Stats& stats = allocator->_stats;
+		stats.bytesInUse = stats.bytesInUse - osize + nsize;
+		stats.peakBytesInUse = core_max(stats.peakBytesInUse, stats.bytesInUse);
+		return newPtr;
+	}
+	if (osize <= MaxPooledSize && nsize <= MaxPooledSize && sizeClass(osize) == sizeClass(nsize)) {
+		Stats& stats = allocator->_stats;
+		stats.bytesInUse = stats.bytesInUse - osize + nsize;
+		stats.peakBytesInUse = core_max(stats.peakBytesInUse, stats.bytesInUse);
+		return ptr;
+	}
+	// moving between the pools and the system allocator
+	void* newPtr = allocator->allocate(nsize);
+	if (newPtr == nullptr) {
+		// lua expects the old block to stay valid if a shrinking request fails
+		return nullptr;
+	}
+	core_memcpy(newPtr, ptr, core_min(osize, nsize));
+	allocator->release(ptr, osize);
+	return newPtr;
+}
+
+}
@@ -0,0 +1,73 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/NonCopyable.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace lua {
+
+/**
+ * @brief Memory allocator for a single lua state
+ *
+ * Lua allocates lots of small objects (strings, tables, closures). Blocks up to @c MaxPooledSize bytes are served
+ * from per size class free lists that are filled from slabs - the slabs are only released when the allocator is
+ * destroyed. Bigger blocks go to the system allocator.
+ *
+ * A lua state is only used by one thread at a time - the allocator is not thread safe.
+ */
+class LUAAllocator : public core::NonCopyable {
+public:
+	static constexpr size_t Granularity = 16u;
+	static constexpr size_t MaxPooledSize = 256u;
+	static constexpr int SizeClasses = (int)(MaxPooledSize / Granularity);
+	static constexpr size_t SlabSize = 16384u;
+
+	struct Stats {
+		/** @brief the bytes lua requested and didn't free yet */
+		size_t bytesInUse = 0u;
+		size_t peakBytesInUse = 0u;
+		/** @brief the memory that was reserved for the size class pools */
+		size_t slabBytes = 0u;
+		uint64_t allocations = 0u;
+		uint64_t pooledAllocations = 0u;
+		uint64_t frees = 0u;
+	};
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+	struct Slab {
+		Slab* next;
+	};
+	FreeBlock* _freeLists[SizeClasses] {};
+	Slab* _slabs = nullptr;
+	Stats _stats;
+
+	static inline int sizeClass(size_t size) {
+		return (int)((size + Granularity - 1u) / Granularity) - 1;
+	}
+
+	void* allocate(size_t size);
+	void release(void* ptr, size_t size);
+	bool fill(int sizeClass);
+public:
+	~LUAAllocator();
+
+	/**
+	 * @brief The @c lua_Alloc function - the allocator instance is the user data
+	 */
+	static void* alloc(void *ud, void *ptr, size_t osize, size_t nsize);
+
+	const Stats& stats() const;
+};
+
+inline const LUAAllocator::Stats& LUAAllocator::stats() const {
+	return _stats;
+}
+
+}
@@ -0,0 +1,123 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "commonlua/LUA.h"
+
+namespace lua {
+
+class LUATest : public app::AbstractTest {
+protected:
+	static constexpr const char *GarbageScript = R"(
+		function garbage(n)
+			for i = 1, n do
+				local t = {i, i}
+			end
+		end
+	)";
+
+	void produceGarbage(LUA& lua, int amount) {
+		lua_getglobal(lua, "garbage");
+		lua_pushinteger(lua, amount);
+		ASSERT_EQ(LUA_OK, lua_pcall(lua, 1, 0, 0)) << lua_tostring(lua, -1);
+	}
+
+	void collect(LUA& lua) {
+		for (int i = 0; i < 1000; ++i) {
+			if (lua.gcStep(1000000u)) {
+				return;
+			}
+		}
+		FAIL() << "Garbage collection cycle didn't finish";
+	}
+};
+
+TEST_F(LUATest, testMemoryStats) {
+	LUA lua;
+	const LUAAllocator::Stats* stats = lua.memoryStats();
+	ASSERT_NE(nullptr, stats);
+	EXPECT_EQ(lua.memoryInUse(), stats->bytesInUse);
+	EXPECT_GE(stats->peakBytesInUse, stats->bytesInUse);
+	EXPECT_GT(stats->pooledAllocations, 0u);
+	EXPECT_GT(stats->slabBytes, 0u);
+}
+
+TEST_F(LUATest, testMemoryStatsExternalState) {
+	lua_State *state = luaL_newstate();
+	{
+		LUA lua(state);
+		EXPECT_EQ(nullptr, lua.memoryStats());
+		EXPECT_GT(lua.memoryInUse(), 0u);
+	}
+	lua_close(state);
+}
+
+TEST_F(LUATest, testManualGCDoesntCollect) {
+	LUA lua;
+	lua.setManualGC(true);
+	ASSERT_TRUE(lua.load(GarbageScript)) << lua.error();
+	const size_t before = lua.memoryInUse();
+	produceGarbage(lua, 1000);
+	const size_t garbage = lua.memoryInUse();
+	EXPECT_GT(garbage, before + 1000u * 32u);
+	EXPECT_EQ(0u, lua.gcStats().steps);
+
+	collect(lua);
+	EXPECT_LT(lua.memoryInUse(), garbage);
+	EXPECT_EQ(lua.memoryInUse(), lua.memoryStats()->bytesInUse);
+	EXPECT_EQ(1u, lua.gcStats().cycles);
+	EXPECT_EQ(0u, lua.gcStats().emergencyCollections);
+}
+
+TEST_F(LUATest, testGCStepZeroBudget) {
+	LUA lua;
+	lua.setManualGC(true);
+	ASSERT_TRUE(lua.load(GarbageScript)) << lua.error();
+	produceGarbage(lua, 1000);
+	lua.gcStep(0u);
+	EXPECT_EQ(1u, lua.gcStats().steps);
+	lua.gcStep(0u);
+	EXPECT_EQ(2u, lua.gcStats().steps);
+}
+
+TEST_F(LUATest, testEmergencyCollection) {
+	LUA lua;
+	lua.setManualGC(true);
+	ASSERT_TRUE(lua.load(GarbageScript)) << lua.error();
+	collect(lua);
+	// way more than the budget of a single step could collect
+	produceGarbage(lua, 50000);
+	const size_t garbage = lua.memoryInUse();
+	EXPECT_TRUE(lua.gcStep(0u));
+	EXPECT_EQ(1u, lua.gcStats().emergencyCollections);
+	EXPECT_LT(lua.memoryInUse() * 2u, garbage);
+}
+
+TEST_F(LUATest, testPoolReuse) {
+	LUA lua;
+	lua.setManualGC(true);
+	ASSERT_TRUE(lua.load(GarbageScript)) << lua.error();
+	produceGarbage(lua, 1000);
+	collect(lua);
+	const size_t slabBytes = lua.memoryStats()->slabBytes;
+	const uint64_t pooled = lua.memoryStats()->pooledAllocations;
+	produceGarbage(lua, 1000);
+	collect(lua);
+	// the freed blocks of the first run are reused
+	EXPECT_EQ(slabBytes, lua.memoryStats()->slabBytes);
+	EXPECT_GE(lua.memoryStats()->pooledAllocations, pooled + 1000u);
+}
+
+TEST_F(LUATest, testResetStateKeepsManualGC) {
+	LUA lua;
+	lua.setManualGC(true);
+	ASSERT_TRUE(lua.resetState());
+	EXPECT_TRUE(lua.manualGC());
+	ASSERT_TRUE(lua.load(GarbageScript)) << lua.error();
+	const size_t before = lua.memoryInUse();
+	produceGarbage(lua, 1000);
+	EXPECT_GT(lua.memoryInUse(), before + 1000u * 32u);
+}
+
+}
@@ -87,20 +87,19 @@ bool CooldownMgr::isCooldown(Type type) {
 
 void CooldownMgr::update() {
 	for (;;) {
-		_lock.lockRead();
-		if (_queue.empty()) {
-			_lock.unlockRead();
-			break;
+		CooldownPtr cooldown;
+		{
+			// check and pop under the same lock - another thread might pop in between otherwise
+			core::ScopedWriteLock lock(_lock);
+			if (_queue.empty()) {
+				break;
+			}
+			cooldown = _queue.top();
+			if (cooldown->running()) {
+				break;
+			}
+			_queue.pop();
 		}
-		CooldownPtr cooldown = _queue.top();
-		_lock.unlockRead();
-		if (cooldown->running()) {
-			break;
-		}
-
-		_lock.lockWrite();
-		_queue.pop();
-		_lock.unlockWrite();
 		Log::debug("Cooldown of type %i has just expired", core::enumVal(cooldown->type()));
 		cooldown->expire();
 	}
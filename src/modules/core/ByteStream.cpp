@@ -5,41 +5,148 @@
 #include "ByteStream.h"
 #include <SDL_stdinc.h>
 #include <stdarg.h>
+#include <string.h>
 
 namespace core {
 
 ByteStream::ByteStream(int size) {
-	_buffer.reserve(size);
+	if (size > 0) {
+		reserve(size);
+	}
+}
+
+ByteStream::ByteStream(const ByteStream &other) :
+		_pos(other._pos), _owned(other._owned) {
+	if (!_owned) {
+		_buffer = other._buffer;
+		_size = _capacity = other._size;
+		return;
+	}
+	if (other._size > 0u) {
+		_buffer = (uint8_t*)core_malloc(other._size);
+		core_memcpy(_buffer, other._buffer, other._size);
+	}
+	_size = _capacity = other._size;
+}
+
+ByteStream::ByteStream(ByteStream &&other) noexcept :
+		_buffer(other._buffer), _size(other._size), _capacity(other._capacity), _pos(other._pos), _owned(other._owned) {
+	other._buffer = nullptr;
+	other._size = other._capacity = other._pos = 0u;
+	other._owned = true;
+}
+
+ByteStream::~ByteStream() {
+	if (_owned) {
+		core_free(_buffer);
+	}
+}
+
+ByteStream &ByteStream::operator=(const ByteStream &other) {
+	if (&other == this) {
+		return *this;
+	}
+	ByteStream copy(other);
+	*this = core::move(copy);
+	return *this;
+}
+
+ByteStream &ByteStream::operator=(ByteStream &&other) noexcept {
+	if (&other == this) {
+		return *this;
+	}
+	if (_owned) {
+		core_free(_buffer);
+	}
+	_buffer = other._buffer;
+	_size = other._size;
+	_capacity = other._capacity;
+	_pos = other._pos;
+	_owned = other._owned;
+	other._buffer = nullptr;
+	other._size = other._capacity = other._pos = 0u;
+	other._owned = true;
+	return *this;
+}
+
+ByteStream ByteStream::view(const uint8_t *buf, size_t size) {
+	ByteStream stream;
+	stream._buffer = const_cast<uint8_t*>(buf);
+	stream._size = stream._capacity = size;
+	stream._owned = false;
+	return stream;
+}
+
+void ByteStream::grow(size_t amount) {
+	const size_t required = _size + amount;
+	if (_owned && required <= _capacity) {
+		return;
+	}
+	size_t newCapacity = core_max(_capacity + _capacity / 2u, (size_t)64u);
+	if (newCapacity < required) {
+		newCapacity = required;
+	}
+	if (_owned) {
+		_buffer = (uint8_t*)core_realloc(_buffer, newCapacity);
+	} else {
+		// copy-on-write for views
+		uint8_t *buf = (uint8_t*)core_malloc(newCapacity);
+		if (_size > 0u) {
+			core_memcpy(buf, _buffer, _size);
+		}
+		_buffer = buf;
+		_owned = true;
+	}
+	_capacity = newCapacity;
+}
+
+void ByteStream::resize(size_t size) {
+	if (size > _size) {
+		core_memset(extend(size - _size), 0, size - _size);
+		return;
+	}
+	_size = size;
+	if (_pos > _size) {
+		_pos = _size;
+	}
+}
+
+uint8_t *ByteStream::release(size_t &size) {
+	size = this->size();
+	uint8_t *buf;
+	if (!_owned || _pos > 0u) {
+		buf = size > 0u ? (uint8_t*)core_malloc(size) : nullptr;
+		if (size > 0u) {
+			core_memcpy(buf, getBuffer(), size);
+		}
+		if (_owned) {
+			core_free(_buffer);
+		}
+	} else {
+		buf = _buffer;
+	}
+	_buffer = nullptr;
+	_size = _capacity = _pos = 0u;
+	_owned = true;
+	return buf;
 }
 
 int32_t ByteStream::peekInt() const {
-	const int l = 4;
-	if (size() < l) {
+	if (size() < 4) {
 		return -1;
 	}
-	uint8_t buf[l];
-	VectorBuffer::const_iterator it = begin();
-	for (int i = 0; i < l; ++i) {
-		buf[i] = *it++;
-	}
-	const int32_t *word = (const int32_t*) (void*) buf;
-	const int32_t val = SDL_SwapLE32(*word);
-	return val;
+	int32_t word;
+	core_memcpy(&word, getBuffer(), 4);
+	return SDL_SwapLE32(word);
 }
 
 int16_t ByteStream::peekShort() const {
-	const int l = 2;
-	if (size() < l) {
+	if (size() < 2) {
 		return -1;
 	}
-	uint8_t buf[l];
-	VectorBuffer::const_iterator it = begin();
-	for (int i = 0; i < l; ++i) {
-		buf[i] = *it++;
-	}
-	const int16_t *word = reinterpret_cast<const int16_t*>(buf);
-	const int16_t val = SDL_SwapLE16(*word);
-	return val;
+	int16_t word;
+	core_memcpy(&word, getBuffer(), 2);
+	return SDL_SwapLE16(word);
 }
 
 void ByteStream::addFormat(const char *fmt, ...) {
@@ -99,16 +206,20 @@ void ByteStream::readFormat(const char *fmt, ...) {
 }
 
 core::String ByteStream::readString() {
-	core::String strbuff;
-	strbuff.reserve(64);
-	while (size() > 0) {
-		const int8_t chr = (int8_t)readByte();
-		if (chr == '\0') {
-			break;
-		}
-		strbuff += chr;
+	const uint8_t *start = getBuffer();
+	const size_t remaining = size();
+	if (remaining == 0u) {
+		return core::String();
+	}
+	const uint8_t *end = (const uint8_t*)memchr(start, '\0', remaining);
+	if (end == nullptr) {
+		// unterminated string - consume everything that is left
+		_pos += remaining;
+		return core::String((const char*)start, remaining);
 	}
-	return strbuff;
+	const size_t length = (size_t)(end - start);
+	_pos += length + 1u;
+	return core::String((const char*)start, length);
 }
 
 }
@@ -6,7 +6,6 @@
 
 #include <stdint.h>
 #include <stddef.h>
-#include <vector>
 #include "core/String.h"
 #include <SDL_endian.h>
 #include <limits.h>
@@ -19,26 +18,51 @@ namespace core {
 #define BYTE_MASK 0XFF
 #define WORD_MASK 0XFFFF
 
+/**
+ * @brief Little endian byte buffer with a read position
+ *
+ * The stream either owns its storage or is a read-only view of external memory (see @c view()). Writing into
+ * a view copies the data into owned storage first. Owned storage can be handed over with @c release().
+ */
 class ByteStream {
 private:
-	typedef std::vector<uint8_t> VectorBuffer;
-	VectorBuffer _buffer;
-	int _pos = 0;
-
-	inline int size() const {
-		return (int)(_buffer.size() - _pos);
+	uint8_t *_buffer = nullptr;
+	/** @brief the amount of written bytes - including the already read bytes in front of @c _pos */
+	size_t _size = 0u;
+	size_t _capacity = 0u;
+	size_t _pos = 0u;
+	bool _owned = true;
+
+	inline size_t size() const {
+		return _size - _pos;
 	}
 
-	inline VectorBuffer::const_iterator begin() const {
-		return _buffer.begin() + _pos;
-	}
+	/**
+	 * @brief Makes sure there is room for @c amount more bytes and that the storage is owned
+	 */
+	void grow(size_t amount);
+	/**
+	 * @return Pointer to @c amount writable bytes at the end of the stream - the size is already increased
+	 */
+	uint8_t *extend(size_t amount);
 
-	inline VectorBuffer::iterator begin() {
-		return _buffer.begin() + _pos;
-	}
+	template<class T>
+	static T swapLE(T value);
 
 public:
 	ByteStream(int size = 0);
+	ByteStream(const ByteStream &other);
+	ByteStream(ByteStream &&other) noexcept;
+	~ByteStream();
+
+	ByteStream &operator=(const ByteStream &other);
+	ByteStream &operator=(ByteStream &&other) noexcept;
+
+	/**
+	 * @brief Read-only stream over external memory - nothing is copied as long as the stream is only read.
+	 * @note The memory must stay valid for the lifetime of the stream
+	 */
+	static ByteStream view(const uint8_t *buf, size_t size);
 
 	void addBool(bool value, bool prepend = false);
 	void addByte(uint8_t byte, bool prepend = false);
@@ -48,6 +72,11 @@ public:
 	void addFloat(float value);
 	void addString(const core::String& string);
 	void addFormat(const char *fmt, ...);
+	/**
+	 * @brief Writes @c count integral or float values in little endian byte order
+	 */
+	template<class T>
+	void addArray(const T *values, size_t count);
 
 	bool readBool();
 	uint8_t readByte();
@@ -57,6 +86,17 @@ public:
 	float readFloat();
 	core::String readString();
 	void readFormat(const char *fmt, ...);
+	/**
+	 * @brief Reads @c count values that were written with @c addArray()
+	 * @return @c false if there are not enough bytes left - nothing is read in this case
+	 */
+	template<class T>
+	bool readArray(T *values, size_t count);
+	/**
+	 * @brief Advances the read position without copying the data
+	 * @return @c false if there are less than @c size bytes left
+	 */
+	bool skip(size_t size);
 
 	int32_t peekInt() const;
 	int16_t peekShort() const;
@@ -66,6 +106,13 @@ public:
 
 	void append(const uint8_t *buf, size_t size);
 
+	/**
+	 * @brief Gives access to at least @c size bytes of spare capacity at the end of the stream. Call @c commit() with
+	 * the amount of bytes that were really written.
+	 */
+	uint8_t *writeBuffer(size_t size);
+	void commit(size_t size);
+
 	bool empty() const;
 
 	// clear the buffer if it's no longer needed
@@ -74,8 +121,18 @@ public:
 	// return the amount of bytes in the buffer
 	size_t getSize() const;
 
+	size_t capacity() const;
+	void reserve(size_t size);
+
 	void resize(size_t size);
 
+	/**
+	 * @brief Hands the unread bytes over to the caller - the memory must be freed with @c core_free().
+	 * The stream is empty afterwards.
+	 * @param[out] size The amount of bytes in the returned memory
+	 */
+	uint8_t *release(size_t &size);
+
 	ByteStream &operator<<(const uint8_t &x) {
 		addByte(x, false);
 		return *this;
@@ -107,36 +164,86 @@ public:
 	}
 };
 
+template<class T>
+inline T ByteStream::swapLE(T value) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	uint8_t *bytes = (uint8_t*)&value;
+	for (size_t i = 0; i < sizeof(T) / 2; ++i) {
+		const uint8_t b = bytes[i];
+		bytes[i] = bytes[sizeof(T) - 1 - i];
+		bytes[sizeof(T) - 1 - i] = b;
+	}
+#endif
+	return value;
+}
+
 inline bool ByteStream::empty() const {
 	return size() <= 0;
 }
 
-inline void ByteStream::resize(size_t size) {
-	_buffer.resize(size);
+inline uint8_t *ByteStream::extend(size_t amount) {
+	if (_capacity - _size < amount || !_owned) {
+		grow(amount);
+	}
+	uint8_t *ptr = _buffer + _size;
+	_size += amount;
+	return ptr;
 }
 
 inline void ByteStream::append(const uint8_t *buf, size_t size) {
-	_buffer.reserve(_buffer.size() + size);
-	_buffer.insert(_buffer.end(), buf, buf + size);
+	if (size == 0u) {
+		return;
+	}
+	core_memcpy(extend(size), buf, size);
+}
+
+inline uint8_t *ByteStream::writeBuffer(size_t size) {
+	if (_capacity - _size < size || !_owned) {
+		grow(size);
+	}
+	return _buffer + _size;
+}
+
+inline void ByteStream::commit(size_t size) {
+	core_assert(_owned && _size + size <= _capacity);
+	_size += size;
 }
 
 inline const uint8_t* ByteStream::getBuffer() const {
-	return &_buffer[0] + _pos;
+	return _buffer + _pos;
 }
 
 inline void ByteStream::clear() {
-	_buffer.clear();
+	_size = 0u;
+	_pos = 0u;
+	if (!_owned) {
+		_buffer = nullptr;
+		_capacity = 0u;
+		_owned = true;
+	}
 }
 
 inline size_t ByteStream::getSize() const {
-	return _buffer.size() - _pos;
+	return size();
+}
+
+inline size_t ByteStream::capacity() const {
+	return _capacity;
+}
+
+inline void ByteStream::reserve(size_t size) {
+	if (size > _size) {
+		writeBuffer(size - _size);
+	}
 }
 
 inline void ByteStream::addByte(uint8_t byte, bool prepend) {
 	if (prepend) {
-		_buffer.insert(_buffer.begin(), byte);
+		extend(1u);
+		core_memmove(_buffer + _pos + 1, _buffer + _pos, size() - 1u);
+		_buffer[_pos] = byte;
 	} else {
-		_buffer.push_back(byte);
+		*extend(1u) = byte;
 	}
 }
 
@@ -146,41 +253,30 @@ inline void ByteStream::addBool(bool value, bool prepend) {
 
 inline void ByteStream::addString(const core::String& string) {
 	const size_t length = string.size();
-	for (size_t i = 0u; i < length; i++) {
-		addByte(uint8_t(string[i]));
-	}
-	addByte(uint8_t('\0'));
+	uint8_t *ptr = extend(length + 1u);
+	core_memcpy(ptr, string.c_str(), length);
+	ptr[length] = uint8_t('\0');
 }
 
 inline void ByteStream::addShort(int16_t word, bool prepend) {
 	const int16_t swappedWord = SDL_SwapLE16(word);
 	if (prepend) {
-		_buffer.insert(_buffer.begin(), uint8_t(swappedWord >> CHAR_BIT));
-		_buffer.insert(_buffer.begin(), uint8_t(swappedWord));
+		extend(2u);
+		core_memmove(_buffer + _pos + 2, _buffer + _pos, size() - 2u);
+		core_memcpy(_buffer + _pos, &swappedWord, 2);
 	} else {
-		_buffer.push_back(uint8_t(swappedWord));
-		_buffer.push_back(uint8_t(swappedWord >> CHAR_BIT));
+		core_memcpy(extend(2u), &swappedWord, 2);
 	}
 }
 
 inline void ByteStream::addInt(int32_t dword) {
-	int32_t swappedDWord = SDL_SwapLE32(dword);
-	_buffer.push_back(uint8_t(swappedDWord));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >> CHAR_BIT));
+	const int32_t swappedDWord = SDL_SwapLE32(dword);
+	core_memcpy(extend(4u), &swappedDWord, 4);
 }
 
 inline void ByteStream::addLong(int64_t dword) {
-	int64_t swappedDWord = SDL_SwapLE64(dword);
-	_buffer.push_back(uint8_t(swappedDWord));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >>= CHAR_BIT));
-	_buffer.push_back(uint8_t(swappedDWord >> CHAR_BIT));
+	const int64_t swappedDWord = SDL_SwapLE64(dword);
+	core_memcpy(extend(8u), &swappedDWord, 8);
 }
 
 inline void ByteStream::addFloat(float value) {
@@ -192,6 +288,22 @@ inline void ByteStream::addFloat(float value) {
 	addInt(tmp.i);
 }
 
+template<class T>
+inline void ByteStream::addArray(const T *values, size_t count) {
+	if (count == 0u) {
+		return;
+	}
+	uint8_t *ptr = extend(count * sizeof(T));
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	core_memcpy(ptr, values, count * sizeof(T));
+#else
+	for (size_t i = 0u; i < count; ++i) {
+		const T swapped = swapLE(values[i]);
+		core_memcpy(ptr + i * sizeof(T), &swapped, sizeof(T));
+	}
+#endif
+}
+
 inline uint8_t ByteStream::readByte() {
 	core_assert(size() > 0);
 	const uint8_t byte = _buffer[_pos];
@@ -240,4 +352,28 @@ inline int64_t ByteStream::readLong() {
 	return val;
 }
 
+template<class T>
+inline bool ByteStream::readArray(T *values, size_t count) {
+	const size_t bytes = count * sizeof(T);
+	if (size() < bytes) {
+		return false;
+	}
+	core_memcpy(values, getBuffer(), bytes);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	for (size_t i = 0u; i < count; ++i) {
+		values[i] = swapLE(values[i]);
+	}
+#endif
+	_pos += bytes;
+	return true;
+}
+
+inline bool ByteStream::skip(size_t size) {
+	if (this->size() < size) {
+		return false;
+	}
+	_pos += size;
+	return true;
+}
+
 }
@@ -4,6 +4,7 @@
 
 #include "EventBus.h"
 #include "core/Log.h"
+#include <vector>
 
 namespace core {
 
@@ -13,6 +14,9 @@ EventBus::EventBus(const int initialHandlerSize) :
 }
 
 EventBus::~EventBus() {
+	while (QueuedEvent* queued = _queue.pop()) {
+		delete queued;
+	}
 	_handlers.clear();
 }
 
@@ -52,9 +56,9 @@ int EventBus::unsubscribe(ClassTypeId index, void* handler, const IEventBusTopic
 int EventBus::update(int limit) {
 	core_trace_scoped(EventBusUpdate);
 	int i = 0;
-	IEventBusEventPtr event;
-	while (_queue.pop(event)) {
-		publish(*event);
+	while (QueuedEvent* queued = _queue.pop()) {
+		publish(*queued->event);
+		delete queued;
 		if (limit > 0 && ++i >= limit) {
 			break;
 		}
@@ -67,38 +71,40 @@ int EventBus::size() const {
 }
 
 void EventBus::enqueue(const IEventBusEventPtr& e) {
-	_queue.push(e);
+	_queue.push(new QueuedEvent(e));
 }
 
 int EventBus::publish(const IEventBusEvent& e) {
 	const ClassTypeId index = e.typeId();
-	// must be locked until the execution is done, because we are dealing with raw pointers here.
-	// that means nobody may unsubscribe/subscribe during a publish as we are iterating the list.
-	// if someone would unsubscribe he would maybe still get notified otherwise - or even worse,
-	// the pointer we are iterating over is already freed.
-	ScopedReadLock lock(_lock);
-	EventBusHandlerReferenceMap::iterator i = _handlers.find(index);
-	if (i == _handlers.end()) {
-		return 0;
-	}
-
-	int notifiedHandlers = 0;
-	EventBusHandlerReferences& handlers = i->second;
-	for (auto& r : handlers) {
-		if (r.getTopic() != nullptr) {
-			const IEventBusTopic* topic = e.getTopic();
-			if (topic == nullptr) {
-				continue;
-			}
-			if (!(*r.getTopic() == *topic)) {
-				continue;
+	// the handlers are collected under the lock but notified without it - this allows the handlers to
+	// subscribe or unsubscribe handlers (which needs the write lock) while the event is dispatched.
+	std::vector<IEventBusHandler<IEventBusEvent>*> notify;
+	{
+		ScopedReadLock lock(_lock);
+		EventBusHandlerReferenceMap::iterator i = _handlers.find(index);
+		if (i == _handlers.end()) {
+			return 0;
+		}
+		const EventBusHandlerReferences& handlers = i->second;
+		notify.reserve(handlers.size());
+		for (const auto& r : handlers) {
+			if (r.getTopic() != nullptr) {
+				const IEventBusTopic* topic = e.getTopic();
+				if (topic == nullptr) {
+					continue;
+				}
+				if (!(*r.getTopic() == *topic)) {
+					continue;
+				}
 			}
+			notify.push_back(r.getHandler());
 		}
-		IEventBusHandler<IEventBusEvent>* handler = r.getHandler();
+	}
+
+	for (IEventBusHandler<IEventBusEvent>* handler : notify) {
 		handler->dispatch(e);
-		++notifiedHandlers;
 	}
-	return notifiedHandlers;
+	return (int)notify.size();
 }
 
 }
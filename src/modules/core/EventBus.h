@@ -11,7 +11,7 @@
 #include "core/Log.h"
 #include "core/Common.h"
 #include "core/concurrent/ReadWriteLock.h"
-#include "core/collection/ConcurrentQueue.h"
+#include "core/collection/MPSCQueue.h"
 
 namespace core {
 
@@ -136,7 +136,12 @@ private:
 	typedef std::unordered_map<ClassTypeId, EventBusHandlerReferences> EventBusHandlerReferenceMap;
 	core::ReadWriteLock _lock;
 
-	core::ConcurrentQueue<IEventBusEventPtr, std::less<IEventBusEventPtr> > _queue;
+	struct QueuedEvent : public core::MPSCQueueNode {
+		IEventBusEventPtr event;
+		QueuedEvent(const IEventBusEventPtr& e) : event(e) {
+		}
+	};
+	core::MPSCQueue<QueuedEvent> _queue;
 
 	class EventBusHandlerReference {
 	private:
@@ -203,6 +208,10 @@ public:
 	 * @note Only those IEventBusHandler are notified that have registered with the same topic
 	 * that the event is publishing with (or if the handler was not registered with a topic at
 	 * all).
+	 * @note The handlers are notified without holding the lock - they may subscribe() or unsubscribe()
+	 * handlers while the event is dispatched. Changes only affect the next published event. A handler that is
+	 * unsubscribed from another thread while the event is dispatched might still get notified, so handlers
+	 * must be unsubscribed before they are destroyed and no publish() may be running at that time.
 	 * @return The amount of notified IEventBusHandler instances
 	 */
 	int publish(const IEventBusEvent& e);
@@ -0,0 +1,152 @@
+/**
+ * @file
+ */
+
+#include "FrameArena.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+
+namespace core {
+
+FrameArena& frameArena() {
+	static thread_local FrameArena arena;
+	return arena;
+}
+
+FrameArena::FrameArena(size_t blockSize) :
+		_blockSize(blockSize) {
+}
+
+FrameArena::~FrameArena() {
+	freeBlocks();
+}
+
+FrameArena::Block* FrameArena::createBlock(size_t size) {
+	Block* block = (Block*)core_malloc(HeaderSize + size);
+	if (block == nullptr) {
+		return nullptr;
+	}
+	block->next = nullptr;
+	block->size = size;
+	block->offset = 0u;
+	_stats.reservedBytes += size;
+	return block;
+}
+
+void FrameArena::freeBlocks() {
+	Block* block = _first;
+	while (block != nullptr) {
+		Block* next = block->next;
+		core_free(block);
+		block = next;
+	}
+	_first = _current = nullptr;
+	_stats.reservedBytes = 0u;
+}
+
+void FrameArena::poison(Block* block, size_t offset) {
+#ifdef DEBUG
+	if (block->offset > offset) {
+		core_memset(data(block) + offset, PoisonByte, block->offset - offset);
+	}
+#endif
+}
+
+void* FrameArena::allocateSlow(size_t size, size_t alignment) {
+	core_assert_msg((alignment & (alignment - 1u)) == 0u, "Alignment must be a power of two: %i", (int)alignment);
+	const size_t needed = size + alignment;
+	Block* next = _current != nullptr ? _current->next : _first;
+	if (next != nullptr && next->size >= needed) {
+		// reuse the blocks that were released by a rewind
+		_current = next;
+		return allocate(size, alignment);
+	}
+	Block* block = createBlock(core_max(_blockSize, needed));
+	if (block == nullptr) {
+		return nullptr;
+	}
+	block->next = next;
+	if (_current != nullptr) {
+		_current->next = block;
+	} else {
+		_first = block;
+	}
+	_current = block;
+	++_stats.blockAllocations;
+	return allocate(size, alignment);
+}
+
+void FrameArena::release(void* ptr, size_t size) {
+	Block* block = _current;
+	if (ptr == nullptr || block == nullptr) {
+		return;
+	}
+	uint8_t* p = (uint8_t*)ptr;
+	if (p + size != data(block) + block->offset) {
+		return;
+	}
+	const size_t offset = (size_t)(p - data(block));
+	poison(block, offset);
+	block->offset = offset;
+	_stats.bytesInUse -= size;
+}
+
+void FrameArena::reset() {
+	for (Block* block = _first; block != nullptr; block = block->next) {
+		poison(block, 0u);
+		block->offset = 0u;
+	}
+	_stats.lastFrameBytes = _stats.bytesInUse;
+	_stats.lastFrameAllocations = _stats.frameAllocations;
+	_stats.highWaterMark = core_max(_stats.highWaterMark, _stats.bytesInUse);
+	_stats.bytesInUse = 0u;
+	_stats.frameAllocations = 0u;
+	++_stats.resets;
+
+	if (_first != nullptr && _first->next != nullptr) {
+		// merge the chained blocks to serve the next frame from one block
+		const size_t size = _stats.reservedBytes;
+		freeBlocks();
+		_first = createBlock(size);
+	}
+	_current = _first;
+}
+
+FrameArena::Marker FrameArena::mark() const {
+	Marker marker;
+	marker.block = _current;
+	marker.offset = _current != nullptr ? _current->offset : 0u;
+	marker.bytesInUse = _stats.bytesInUse;
+	return marker;
+}
+
+void FrameArena::rewind(const Marker& marker) {
+	_stats.highWaterMark = core_max(_stats.highWaterMark, _stats.bytesInUse);
+	Block* block = (Block*)marker.block;
+	Block* first = block != nullptr ? block->next : _first;
+	for (Block* b = first; b != nullptr; b = b->next) {
+		poison(b, 0u);
+		b->offset = 0u;
+	}
+	if (block != nullptr) {
+		poison(block, marker.offset);
+		block->offset = marker.offset;
+		_current = block;
+	} else {
+		_current = _first;
+	}
+	_stats.bytesInUse = marker.bytesInUse;
+}
+
+bool FrameArena::owns(const void* ptr) const {
+	const uint8_t* p = (const uint8_t*)ptr;
+	for (Block* block = _first; block != nullptr; block = block->next) {
+		if (p >= data(block) && p < data(block) + block->size) {
+			return true;
+		}
+	}
+	return false;
+}
+
+}
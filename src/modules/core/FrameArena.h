@@ -0,0 +1,228 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/Assert.h"
+#include "core/NonCopyable.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace core {
+
+/**
+ * @brief Linear allocator for data that only lives until the end of the current tick or frame
+ *
+ * Allocating is a pointer bump, freeing a single allocation does nothing (unless it was the last one). All the
+ * memory is released at once with @c reset() at the tick or frame boundary - or with a @c FrameArenaScope for the
+ * allocations inside a scope. If a block is full, another one is chained. On @c reset() the chained blocks are
+ * merged into one block that is big enough for the whole frame - so the steady state doesn't hit the system
+ * allocator at all.
+ *
+ * There is one arena per thread - see @c frameArena(). The arena is not thread safe and the memory must not be
+ * handed over to other threads.
+ *
+ * In debug builds the released memory is filled with @c PoisonByte to make use-after-reset bugs visible.
+ *
+ * @sa FrameAllocator
+ * @sa FrameArenaAllocator
+ */
+class FrameArena : public core::NonCopyable {
+public:
+	static constexpr size_t Alignment = 16u;
+	static constexpr size_t DefaultBlockSize = 256u * 1024u;
+	static constexpr uint8_t PoisonByte = 0xDD;
+
+	struct Stats {
+		/** @brief the bytes that were handed out since the last reset */
+		size_t bytesInUse = 0u;
+		/** @brief the highest @c bytesInUse value of all frames */
+		size_t highWaterMark = 0u;
+		/** @brief the @c bytesInUse value at the last reset */
+		size_t lastFrameBytes = 0u;
+		/** @brief the memory of all blocks */
+		size_t reservedBytes = 0u;
+		uint64_t allocations = 0u;
+		/** @brief the allocations since the last reset */
+		uint64_t frameAllocations = 0u;
+		/** @brief the allocations of the last frame */
+		uint64_t lastFrameAllocations = 0u;
+		/** @brief how often a block had to be chained because the current block was full */
+		uint64_t blockAllocations = 0u;
+		uint64_t resets = 0u;
+	};
+
+	/**
+	 * @brief The arena state that can be restored with @c rewind()
+	 */
+	struct Marker {
+		const void* block = nullptr;
+		size_t offset = 0u;
+		size_t bytesInUse = 0u;
+	};
+
+private:
+	struct Block {
+		Block* next;
+		size_t size;
+		size_t offset;
+	};
+	Block* _first = nullptr;
+	Block* _current = nullptr;
+	size_t _blockSize;
+	Stats _stats;
+
+	// the header size keeps the data of the blocks aligned
+	static constexpr size_t HeaderSize = (sizeof(Block) + Alignment - 1u) & ~(Alignment - 1u);
+
+	static inline uint8_t* data(Block* block) {
+		return (uint8_t*)block + HeaderSize;
+	}
+	Block* createBlock(size_t size);
+	void poison(Block* block, size_t offset);
+	void freeBlocks();
+	void* allocateSlow(size_t size, size_t alignment);
+
+public:
+	explicit FrameArena(size_t blockSize = DefaultBlockSize);
+	~FrameArena();
+
+	/**
+	 * @param alignment Must be a power of two
+	 */
+	void* allocate(size_t size, size_t alignment = Alignment);
+
+	/**
+	 * @brief Gives the memory back if it was the last allocation - does nothing otherwise
+	 */
+	void release(void* ptr, size_t size);
+
+	/**
+	 * @brief Releases all allocations at once - call this at the tick or frame boundary
+	 * @note All the memory that was allocated since the last reset must not be used anymore
+	 */
+	void reset();
+
+	Marker mark() const;
+	/**
+	 * @brief Releases all allocations that were made after the given marker was taken
+	 */
+	void rewind(const Marker& marker);
+
+	/**
+	 * @return @c true if the given pointer was allocated by this arena
+	 */
+	bool owns(const void* ptr) const;
+
+	const Stats& stats() const;
+};
+
+inline const FrameArena::Stats& FrameArena::stats() const {
+	return _stats;
+}
+
+inline void* FrameArena::allocate(size_t size, size_t alignment) {
+	Block* block = _current;
+	if (block != nullptr) {
+		const uintptr_t base = (uintptr_t)data(block);
+		const uintptr_t aligned = (base + block->offset + alignment - 1u) & ~(uintptr_t)(alignment - 1u);
+		const size_t end = (size_t)(aligned - base) + size;
+		if (end <= block->size) {
+			_stats.bytesInUse += end - block->offset;
+			block->offset = end;
+			++_stats.allocations;
+			++_stats.frameAllocations;
+			return (void*)aligned;
+		}
+	}
+	return allocateSlow(size, alignment);
+}
+
+/**
+ * @return The arena of the calling thread
+ */
+extern FrameArena& frameArena();
+
+/**
+ * @brief Releases all allocations of the calling thread's arena that were made in the lifetime of the scope
+ *
+ * Use this on threads that don't reset their arena - or to release the memory of a nested step early.
+ * The containers that use the arena must be destroyed before the scope ends.
+ */
+class FrameArenaScope : public core::NonCopyable {
+private:
+	FrameArena& _arena;
+	const FrameArena::Marker _marker;
+public:
+	FrameArenaScope(FrameArena& arena = frameArena()) : _arena(arena), _marker(arena.mark()) {
+	}
+
+	~FrameArenaScope() {
+		_arena.rewind(_marker);
+	}
+};
+
+/**
+ * @brief STL compatible allocator that allocates from a @c FrameArena
+ *
+ * The allocator remembers the arena of the thread that created it.
+ */
+template<class T>
+class FrameAllocator {
+private:
+	template<class U>
+	friend class FrameAllocator;
+	FrameArena* _arena;
+public:
+	using value_type = T;
+
+	FrameAllocator() : _arena(&frameArena()) {
+	}
+
+	explicit FrameAllocator(FrameArena& arena) : _arena(&arena) {
+	}
+
+	template<class U>
+	FrameAllocator(const FrameAllocator<U>& other) : _arena(other._arena) {
+	}
+
+	T* allocate(size_t n) {
+		void* ptr = _arena->allocate(n * sizeof(T), alignof(T) > FrameArena::Alignment ? alignof(T) : FrameArena::Alignment);
+		core_assert_msg(ptr != nullptr, "Failed to allocate %i bytes", (int)(n * sizeof(T)));
+		return (T*)ptr;
+	}
+
+	void deallocate(T* ptr, size_t n) {
+		_arena->release(ptr, n * sizeof(T));
+	}
+
+	template<class U>
+	bool operator==(const FrameAllocator<U>& other) const {
+		return _arena == other._arena;
+	}
+
+	template<class U>
+	bool operator!=(const FrameAllocator<U>& other) const {
+		return _arena != other._arena;
+	}
+};
+
+/**
+ * @brief Allocator for the @c core::DynamicArray that allocates from the calling thread's @c FrameArena
+ *
+ * @code
+ * core::DynamicArray<core::VarPtr, 32u, core::FrameArenaAllocator> vars;
+ * @endcode
+ */
+struct FrameArenaAllocator {
+	static inline void* allocate(size_t size) {
+		return frameArena().allocate(size);
+	}
+
+	static inline void deallocate(void*) {
+		// the memory is released with the next reset
+	}
+};
+
+}
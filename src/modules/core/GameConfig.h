@@ -22,6 +22,8 @@ constexpr const char *ClientMultiSampleSamples = "cl_multisamplesamples";
 constexpr const char *ClientMultiSampleBuffers = "cl_multisamplebuffers";
 constexpr const char *ClientShadowMapSize = "cl_shadowmapsize";
 constexpr const char *ClientOpenGLVersion = "cl_openglversion";
+// cache the preprocessed shader sources and the linked program binaries in the home path
+constexpr const char *ClientShaderCache = "cl_shadercache";
 constexpr const char *ClientRenderUI = "cl_renderui";
 constexpr const char *ClientWindowWidth = "cl_width";
 constexpr const char *ClientWindowDisplay = "cl_display";
@@ -53,6 +55,12 @@ constexpr const char *ServerPostgresLib = "sv_postgreslib";
 constexpr const char *ServerHttpPort = "sv_httpport";
 // the download urls for the chunks
 constexpr const char *ServerChunkBaseUrl = "sv_httpchunkurl";
+// write a snapshot of each map on shutdown and restore it on startup
+constexpr const char *ServerMapSnapshot = "sv_mapsnapshot";
+// the maximum amount of chunks that are loaded or generated before a map is marked ready
+constexpr const char *ServerPreloadChunks = "sv_preloadchunks";
+// the amount of chunks around each preload area
+constexpr const char *ServerPreloadRadius = "sv_preloadradius";
 
 constexpr const char *ConsoleCurses = "con_curses";
 
@@ -60,6 +68,8 @@ constexpr const char *CoreMaxFPS = "core_maxfps";
 constexpr const char *CoreLogLevel = "core_loglevel";
 constexpr const char *CoreSysLog = "core_syslog";
 constexpr const char *CorePath = "core_path";
+// every n-th uncontended lock acquisition is sampled for the lock stats - 0 disables them
+constexpr const char *CoreLockStats = "core_lockstats";
 
 // The size of the chunk that is extracted with each step
 constexpr const char *VoxelMeshSize = "voxel_meshsize";
@@ -26,6 +26,10 @@
 #define core_memcpy SDL_memcpy
 #endif
 
+#ifndef core_memmove
+#define core_memmove SDL_memmove
+#endif
+
 #ifndef core_memcmp
 #define core_memcmp SDL_memcmp
 #endif
@@ -0,0 +1,165 @@
+/**
+ * @file
+ */
+
+#include "StringId.h"
+#include "core/Assert.h"
+#include "core/Hash.h"
+#include "core/StandardLib.h"
+#include "core/collection/Buffer.h"
+#include "core/concurrent/ReadWriteLock.h"
+#include <atomic>
+
+namespace core {
+
+namespace {
+
+struct Entry {
+	core::String str;
+	uint32_t hash;
+};
+
+/**
+ * @brief The entries are allocated in chunks that are never moved or freed - resolving an id to its string doesn't
+ * need the lock. The hash slots are an open addressing table with the ids of the entries.
+ *
+ * The table is created on first use and intentionally never freed - ids might be resolved during the static
+ * destruction.
+ */
+struct Table {
+	static constexpr uint32_t ChunkBits = 10u;
+	static constexpr uint32_t ChunkSize = 1u << ChunkBits;
+	static constexpr uint32_t MaxChunks = 4096u;
+
+	ReadWriteLock lock { "StringId" };
+	std::atomic<Entry*> chunks[MaxChunks] {};
+	/** @brief id @c 0 is the invalid id */
+	std::atomic<uint32_t> count { 1u };
+	core::Buffer<uint32_t> slots;
+	uint32_t mask = 0u;
+
+	Table() {
+		resizeSlots(1024u);
+	}
+
+	inline const Entry& entry(uint32_t id) const {
+		return chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (ChunkSize - 1u)];
+	}
+
+	void resizeSlots(uint32_t size) {
+		core::Buffer<uint32_t> newSlots;
+		newSlots.resize(size);
+		core_memset(newSlots.data(), 0, size * sizeof(uint32_t));
+		const uint32_t newMask = size - 1u;
+		for (size_t i = 0u; i < slots.size(); ++i) {
+			const uint32_t id = slots[i];
+			if (id == 0u) {
+				continue;
+			}
+			uint32_t slot = entry(id).hash & newMask;
+			while (newSlots[slot] != 0u) {
+				slot = (slot + 1u) & newMask;
+			}
+			newSlots[slot] = id;
+		}
+		slots = core::move(newSlots);
+		mask = newMask;
+	}
+
+	/**
+	 * @return The slot with the given string or the empty slot where it has to be inserted
+	 */
+	uint32_t probe(const char *str, size_t length, uint32_t hash) const {
+		uint32_t slot = hash & mask;
+		for (;;) {
+			const uint32_t id = slots[slot];
+			if (id == 0u) {
+				return slot;
+			}
+			const Entry& e = entry(id);
+			if (e.hash == hash && e.str.size() == length && core_memcmp(e.str.c_str(), str, length) == 0) {
+				return slot;
+			}
+			slot = (slot + 1u) & mask;
+		}
+	}
+
+	uint32_t add(const char *str, size_t length, uint32_t hash) {
+		const uint32_t id = count.load(std::memory_order_relaxed);
+		const uint32_t chunk = id >> ChunkBits;
+		core_assert_always(chunk < MaxChunks);
+		Entry* entries = chunks[chunk].load(std::memory_order_relaxed);
+		if (entries == nullptr) {
+			entries = new Entry[ChunkSize];
+		}
+		entries[id & (ChunkSize - 1u)].str = core::String(str, length);
+		entries[id & (ChunkSize - 1u)].hash = hash;
+		chunks[chunk].store(entries, std::memory_order_release);
+		count.store(id + 1u, std::memory_order_relaxed);
+		return id;
+	}
+};
+
+Table& table() {
+	static Table* t = new Table();
+	return *t;
+}
+
+const core::String EmptyString;
+
+}
+
+StringId StringId::intern(const char *str, size_t length, bool insert) {
+	const uint32_t hash = core::hash(str, (int)length);
+	Table& t = table();
+	{
+		ScopedReadLock scoped(t.lock);
+		const uint32_t id = t.slots[t.probe(str, length, hash)];
+		if (id != 0u || !insert) {
+			return StringId(id, id == 0u ? 0u : hash);
+		}
+	}
+	ScopedWriteLock scoped(t.lock);
+	// another thread might have added it in the meantime
+	uint32_t slot = t.probe(str, length, hash);
+	if (t.slots[slot] != 0u) {
+		return StringId(t.slots[slot], hash);
+	}
+	// keep the load factor below 50%
+	if ((t.count.load(std::memory_order_relaxed) + 1u) * 2u > t.mask + 1u) {
+		t.resizeSlots((t.mask + 1u) * 2u);
+		slot = t.probe(str, length, hash);
+	}
+	const uint32_t id = t.add(str, length, hash);
+	t.slots[slot] = id;
+	return StringId(id, hash);
+}
+
+StringId::StringId(const char *str) :
+		StringId(intern(str, SDL_strlen(str), true)) {
+}
+
+StringId::StringId(const core::String &str) :
+		StringId(intern(str.c_str(), str.size(), true)) {
+}
+
+StringId StringId::find(const char *str) {
+	return intern(str, SDL_strlen(str), false);
+}
+
+StringId StringId::find(const core::String &str) {
+	return intern(str.c_str(), str.size(), false);
+}
+
+size_t StringId::size() {
+	return table().count.load(std::memory_order_relaxed) - 1u;
+}
+
+const core::String &StringId::str() const {
+	if (_id == 0u) {
+		return EmptyString;
+	}
+	return table().entry(_id).str;
+}
+
+}
@@ -0,0 +1,109 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/collection/Map.h"
+#include <stdint.h>
+#include <stddef.h>
+
+namespace core {
+
+/**
+ * @brief Interned string
+ *
+ * Every distinct string gets a unique id from a global thread-safe table. The ids are stable for the lifetime of the
+ * application - the interned strings are never freed. Comparing two ids is an integer compare and the hash is
+ * computed only once when the string is interned.
+ *
+ * Create the id once (e.g. as member or function local static) and use it for the lookups in the hot paths:
+ * @code
+ * static const core::StringId name("update");
+ * @endcode
+ *
+ * @note The string compare is case sensitive
+ * @sa StringIdMap
+ */
+class StringId {
+private:
+	uint32_t _id = 0u;
+	uint32_t _hash = 0u;
+
+	constexpr StringId(uint32_t id, uint32_t hash) :
+			_id(id), _hash(hash) {
+	}
+
+	static StringId intern(const char *str, size_t length, bool insert);
+public:
+	/**
+	 * @brief The invalid id - this is not the id of the empty string
+	 */
+	constexpr StringId() {
+	}
+
+	explicit StringId(const char *str);
+	explicit StringId(const core::String &str);
+
+	/**
+	 * @brief Looks up the id of an already interned string - the string is not added to the table
+	 * @return An invalid id if the string wasn't interned yet
+	 */
+	static StringId find(const char *str);
+	static StringId find(const core::String &str);
+
+	/**
+	 * @return The amount of interned strings
+	 */
+	static size_t size();
+
+	inline bool valid() const {
+		return _id != 0u;
+	}
+
+	inline uint32_t id() const {
+		return _id;
+	}
+
+	inline size_t hash() const {
+		return (size_t)_hash;
+	}
+
+	/**
+	 * @return The interned string - an empty string for the invalid id
+	 */
+	const core::String &str() const;
+
+	inline const char *c_str() const {
+		return str().c_str();
+	}
+
+	inline bool operator==(const StringId &rhs) const {
+		return _id == rhs._id;
+	}
+
+	inline bool operator!=(const StringId &rhs) const {
+		return _id != rhs._id;
+	}
+
+	inline bool operator<(const StringId &rhs) const {
+		return _id < rhs._id;
+	}
+};
+
+struct StringIdHash {
+	inline size_t operator()(const StringId &id) const {
+		return id.hash();
+	}
+};
+
+/**
+ * @brief Hash map with interned string keys - the lookups don't touch the string data
+ * @sa core::StringMap
+ * @ingroup Collections
+ */
+template<class V, size_t SIZE = 11>
+using StringIdMap = core::Map<StringId, V, SIZE, StringIdHash>;
+
+}
@@ -67,7 +67,7 @@ extern void traceThread(const char* name);
 #define core_trace_shutdown() core::traceShutdown()
 #define core_trace_msg(message) core::traceMessage(message)
 #define core_trace_thread(name) core::traceThread(name)
-#define core_trace_mutex(type, varname, name) type varname
+#define core_trace_mutex(type, varname, name) type varname { name }
 
 #define core_trace_begin_frame(name) core::traceBeginFrame()
 #define core_trace_end_frame(name) core::traceEndFrame()
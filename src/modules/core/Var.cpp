@@ -82,13 +82,24 @@ glm::vec3 Var::vec3Val() const {
 	return glm::vec3(x, y, z);
 }
 
+VarPtr Var::get(const core::StringId& name) {
+	VarPtr var;
+	ScopedReadLock lock(_lock);
+	_vars.get(name, var);
+	return var;
+}
+
 VarPtr Var::get(const core::String& name, const char* value, int32_t flags, const char *help) {
 	VarMap::iterator i;
-	bool missing;
+	bool missing = true;
 	{
-		ScopedReadLock lock(_lock);
-		i = _vars.find(name);
-		missing = i == _vars.end();
+		// a name that was never interned can't be registered yet
+		const core::StringId id = core::StringId::find(name);
+		if (id.valid()) {
+			ScopedReadLock lock(_lock);
+			i = _vars.find(id);
+			missing = i == _vars.end();
+		}
 	}
 
 	uint32_t flagsMask = flags < 0 ? 0u : static_cast<uint32_t>(flags);
@@ -114,7 +125,7 @@ VarPtr Var::get(const core::String& name, const char* value, int32_t flags, cons
 
 		const VarPtr& p = core::make_shared<Var>(name, value, flagsMask, help);
 		ScopedWriteLock lock(_lock);
-		_vars.put(name, p);
+		_vars.put(core::StringId(name), p);
 		return p;
 	}
 	const VarPtr& v = i->second;
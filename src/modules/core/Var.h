@@ -8,6 +8,7 @@
 #include "core/GameConfig.h"
 #include "core/SharedPtr.h"
 #include "core/String.h"
+#include "core/StringId.h"
 #include "core/collection/Map.h"
 #include "core/collection/DynamicArray.h"
 #include <string.h>
@@ -60,7 +61,7 @@ typedef core::SharedPtr<Var> VarPtr;
 class Var {
 protected:
 	friend class SharedPtr<Var>;
-	typedef Map<core::String, VarPtr, 64, core::StringHash> VarMap;
+	typedef StringIdMap<VarPtr, 64> VarMap;
 	static VarMap _vars;
 	static ReadWriteLock _lock;
 
@@ -115,6 +116,13 @@ public:
 		return get(name, value.c_str(), flags, help);
 	}
 
+	/**
+	 * @brief Lookup of an existing var by its interned name - this doesn't touch the string data.
+	 * @return An empty pointer if no var with the given name exists. Unlike the string based @c get() this doesn't
+	 * create the var from an environment variable.
+	 */
+	static VarPtr get(const core::StringId& name);
+
 	/**
 	 * @note Same as get(), but uses @c core_assert if no var could be found with the given name.
 	 */
@@ -5,6 +5,9 @@
 #include "Zip.h"
 #include "Log.h"
 #include "Assert.h"
+#include "Common.h"
+#include "StandardLib.h"
+#include "Trace.h"
 extern "C" {
 #define MINIZ_NO_ZLIB_COMPATIBLE_NAMES 1
 #include "miniz.h"
@@ -13,61 +16,306 @@ extern "C" {
 namespace core {
 namespace zip {
 
-bool uncompress(const uint8_t *inputBuf, size_t inputBufSize,
-		uint8_t* outputBuf, size_t outputBufSize, size_t* finalBufSize) {
-	core_assert_msg(outputBufSize > 0, "Expected to get a outputBufSize > 0 - but got %i", (int)outputBufSize);
-	core_assert_msg(inputBufSize > 0, "Expected to get a inputBufSize > 0 - but got %i", (int)inputBufSize);
-	mz_ulong destLen = outputBufSize;
-	int ret = ::mz_uncompress((unsigned char*)outputBuf, &destLen, (const unsigned char*) inputBuf, (mz_ulong)inputBufSize);
-	if (ret == MZ_OK) {
-		if (finalBufSize != nullptr) {
-			*finalBufSize = (size_t)destLen;
+namespace {
+
+/**
+ * @brief Only the last 32k of the dictionary can be referenced by the compressed data
+ */
+inline void clampDictionary(const Dictionary *dictionary, const uint8_t *&data, size_t &size) {
+	data = nullptr;
+	size = 0u;
+	if (dictionary == nullptr || dictionary->data == nullptr || dictionary->size == 0u) {
+		return;
+	}
+	size = core_min(dictionary->size, (size_t)TDEFL_LZ_DICT_SIZE);
+	data = dictionary->data + dictionary->size - size;
+}
+
+}
+
+Compressor::Compressor() :
+		_state(tdefl_compressor_alloc()) {
+}
+
+Compressor::~Compressor() {
+	tdefl_compressor_free((tdefl_compressor*)_state);
+}
+
+bool Compressor::init(int level, const Dictionary *dictionary) {
+	const uint8_t *dictData;
+	size_t dictSize;
+	clampDictionary(dictionary, dictData, dictSize);
+	// with a dictionary we are writing a raw deflate stream - the zlib header would be part of the dictionary block
+	const int windowBits = dictSize > 0u ? -MZ_DEFAULT_WINDOW_BITS : MZ_DEFAULT_WINDOW_BITS;
+	const mz_uint flags = tdefl_create_comp_flags_from_zip_params(level, windowBits, MZ_DEFAULT_STRATEGY);
+	tdefl_compressor *state = (tdefl_compressor*)_state;
+	if (dictSize > 0u && _primedDictionary == dictData && _primedDictionarySize == dictSize && _primedLevel == level) {
+		// the state only has pointers into itself - so it can be restored as long as it's the same instance
+		core_memcpy(state, _primed.data(), sizeof(*state));
+		return true;
+	}
+	if (tdefl_init(state, nullptr, nullptr, (int)flags) != TDEFL_STATUS_OKAY) {
+		Log::error("Failed to initialize the compressor with level %i", level);
+		return false;
+	}
+	if (dictSize == 0u) {
+		return true;
+	}
+	// compress the dictionary and throw away the output - the sync flush aligns the stream to a byte boundary
+	// while keeping the dictionary, so the payload blocks start right after the discarded bytes
+	_scratch.resize(compressBound((uint32_t)dictSize) + 64u);
+	size_t inSize = dictSize;
+	size_t outSize = _scratch.size();
+	const tdefl_status status = tdefl_compress(state, dictData, &inSize, _scratch.data(), &outSize, TDEFL_SYNC_FLUSH);
+	if (status != TDEFL_STATUS_OKAY || inSize != dictSize) {
+		Log::error("Failed to apply the compression dictionary of size %i", (int)dictSize);
+		_primedDictionary = nullptr;
+		return false;
+	}
+	_primed.resize(sizeof(*state));
+	core_memcpy(_primed.data(), state, sizeof(*state));
+	_primedDictionary = dictData;
+	_primedDictionarySize = dictSize;
+	_primedLevel = level;
+	return true;
+}
+
+bool Compressor::deflate(const uint8_t *buf, size_t size, int flush) {
+	tdefl_compressor *state = (tdefl_compressor*)_state;
+	core::Buffer<uint8_t> &out = *_out;
+	for (;;) {
+		if (out.capacity() - out.size() < 1024u) {
+			out.reserve(core_max(out.capacity() * 2u, out.size() + 4096u));
 		}
+		size_t inSize = size;
+		size_t outSize = out.capacity() - out.size();
+		const size_t outPos = out.size();
+		out.resize(out.capacity());
+		const tdefl_status status = tdefl_compress(state, buf, &inSize, out.data() + outPos, &outSize, (tdefl_flush)flush);
+		out.resize(outPos + outSize);
+		buf += inSize;
+		size -= inSize;
+		if (status == TDEFL_STATUS_DONE) {
+			return true;
+		}
+		if (status != TDEFL_STATUS_OKAY) {
+			Log::error("Failed to compress the data: %i", (int)status);
+			return false;
+		}
+		// no flush requested and all input consumed - the compressor might still hold back output
+		if (size == 0u && flush == TDEFL_NO_FLUSH) {
+			return true;
+		}
+	}
+}
+
+bool Compressor::begin(core::Buffer<uint8_t> &out, int level, const Dictionary *dictionary) {
+	_out = &out;
+	_outStart = out.size();
+	return init(level, dictionary);
+}
+
+bool Compressor::write(const uint8_t *buf, size_t size) {
+	core_assert_msg(_out != nullptr, "Compressor::begin() wasn't called");
+	if (size == 0u) {
 		return true;
 	}
+	return deflate(buf, size, TDEFL_NO_FLUSH);
+}
 
-	if (ret == MZ_MEM_ERROR) {
-		Log::error("Failed to uncompress input buffer of size %i into output buffer of size %i - there was not enough memory",
-				(int)inputBufSize, (int)outputBufSize);
+bool Compressor::finish(size_t *compressedSize) {
+	core_assert_msg(_out != nullptr, "Compressor::begin() wasn't called");
+	const bool success = deflate(nullptr, 0u, TDEFL_FINISH);
+	if (compressedSize != nullptr) {
+		*compressedSize = _out->size() - _outStart;
 	}
-	if (ret == MZ_BUF_ERROR) {
-		Log::error("Failed to uncompress input buffer of size %i into output buffer of size %i - there was not enough room in the output buffer",
-				(int)inputBufSize, (int)outputBufSize);
+	_out = nullptr;
+	return success;
+}
+
+bool Compressor::compress(const uint8_t *inputBuf, size_t inputBufSize, core::Buffer<uint8_t> &out, int level,
+		const Dictionary *dictionary) {
+	core_trace_scoped(ZipCompress);
+	core_assert_msg(inputBufSize > 0, "Expected to get a inputBufSize > 0 - but got %i", (int)inputBufSize);
+	out.reserve(out.size() + compressBound((uint32_t)inputBufSize));
+	if (!begin(out, level, dictionary)) {
+		_out = nullptr;
+		return false;
 	}
-	if (ret == MZ_DATA_ERROR) {
-		Log::error("Failed to uncompress input buffer of size %i into output buffer of size %i - the input data was corrupted",
+	if (!write(inputBuf, inputBufSize)) {
+		_out = nullptr;
+		return false;
+	}
+	return finish();
+}
+
+bool Compressor::compress(const uint8_t *inputBuf, size_t inputBufSize, uint8_t *outputBuf, size_t outputBufSize,
+		size_t *finalBufSize, int level, const Dictionary *dictionary) {
+	core_trace_scoped(ZipCompress);
+	core_assert_msg(outputBufSize > 0, "Expected to get a outputBufSize > 0 - but got %i", (int)outputBufSize);
+	core_assert_msg(inputBufSize > 0, "Expected to get a inputBufSize > 0 - but got %i", (int)inputBufSize);
+	if (!init(level, dictionary)) {
+		return false;
+	}
+	size_t inSize = inputBufSize;
+	size_t outSize = outputBufSize;
+	const tdefl_status status = tdefl_compress((tdefl_compressor*)_state, inputBuf, &inSize, outputBuf, &outSize, TDEFL_FINISH);
+	if (status != TDEFL_STATUS_DONE) {
+		Log::error("Failed to compress input buffer of size %i into output buffer of size %i - there was not enough room in the output buffer",
 				(int)inputBufSize, (int)outputBufSize);
+		return false;
 	}
-	return false;
+	if (finalBufSize != nullptr) {
+		*finalBufSize = outSize;
+	}
+	return true;
 }
 
-uint32_t compressBound(uint32_t in) {
-	core_assert_msg(in > 0, "Expected to get a size > 0 - but got %i", (int)in);
-	return (uint32_t)::mz_compressBound((mz_ulong)in);
+Decompressor::Decompressor() :
+		_state(tinfl_decompressor_alloc()) {
 }
 
-bool compress(const uint8_t *inputBuf, size_t inputBufSize,
-		uint8_t* outputBuf, size_t outputBufSize, size_t* finalBufSize) {
+Decompressor::~Decompressor() {
+	tinfl_decompressor_free((tinfl_decompressor*)_state);
+}
+
+bool Decompressor::inflate(const uint8_t *inputBuf, size_t inputBufSize, core::Buffer<uint8_t> &out, size_t outStart,
+		size_t maxOutputSize, const Dictionary *dictionary) {
+	const uint8_t *dictData;
+	size_t dictSize;
+	clampDictionary(dictionary, dictData, dictSize);
+	// the inflater resolves the back references into the output buffer - so the dictionary must be right in
+	// front of the uncompressed data
+	if (dictSize > 0u) {
+		out.resize(outStart + dictSize);
+		core_memcpy(out.data() + outStart, dictData, dictSize);
+	}
+	const size_t dataStart = outStart + dictSize;
+	tinfl_decompressor *state = (tinfl_decompressor*)_state;
+	tinfl_init(state);
+	mz_uint32 flags = TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF;
+	if (dictSize == 0u) {
+		flags |= TINFL_FLAG_PARSE_ZLIB_HEADER;
+	}
+	for (;;) {
+		const size_t outPos = out.size();
+		if (outPos - dataStart >= maxOutputSize) {
+			Log::error("Failed to uncompress input buffer of size %i into output buffer of size %i - there was not enough room in the output buffer",
+					(int)inputBufSize, (int)maxOutputSize);
+			return false;
+		}
+		if (out.capacity() - outPos < 1024u) {
+			out.reserve(core_max(out.capacity() * 2u, outPos + 4096u));
+		}
+		size_t inSize = inputBufSize;
+		size_t outSize = core_min(out.capacity() - outPos, maxOutputSize - (outPos - dataStart));
+		out.resize(out.capacity());
+		const tinfl_status status = tinfl_decompress(state, inputBuf, &inSize, out.data() + outStart, out.data() + outPos, &outSize, flags);
+		out.resize(outPos + outSize);
+		inputBuf += inSize;
+		inputBufSize -= inSize;
+		if (status == TINFL_STATUS_DONE) {
+			return true;
+		}
+		if (status == TINFL_STATUS_HAS_MORE_OUTPUT) {
+			continue;
+		}
+		if (status == TINFL_STATUS_ADLER32_MISMATCH) {
+			Log::error("Failed to uncompress input buffer of size %i - checksum mismatch", (int)inputBufSize);
+		} else {
+			Log::error("Failed to uncompress input buffer of size %i - the input data was corrupted (%i)", (int)inputBufSize, (int)status);
+		}
+		return false;
+	}
+}
+
+bool Decompressor::uncompress(const uint8_t *inputBuf, size_t inputBufSize, core::Buffer<uint8_t> &out,
+		const Dictionary *dictionary) {
+	core_trace_scoped(ZipUncompress);
+	core_assert_msg(inputBufSize > 0, "Expected to get a inputBufSize > 0 - but got %i", (int)inputBufSize);
+	const size_t outStart = out.size();
+	if (!inflate(inputBuf, inputBufSize, out, outStart, SIZE_MAX, dictionary)) {
+		out.resize(outStart);
+		return false;
+	}
+	const uint8_t *dictData;
+	size_t dictSize;
+	clampDictionary(dictionary, dictData, dictSize);
+	if (dictSize > 0u) {
+		// remove the dictionary again
+		const size_t dataSize = out.size() - outStart - dictSize;
+		core_memmove(out.data() + outStart, out.data() + outStart + dictSize, dataSize);
+		out.resize(outStart + dataSize);
+	}
+	return true;
+}
+
+bool Decompressor::uncompress(const uint8_t *inputBuf, size_t inputBufSize, uint8_t *outputBuf, size_t outputBufSize,
+		size_t *finalBufSize, const Dictionary *dictionary) {
+	core_trace_scoped(ZipUncompress);
 	core_assert_msg(outputBufSize > 0, "Expected to get a outputBufSize > 0 - but got %i", (int)outputBufSize);
 	core_assert_msg(inputBufSize > 0, "Expected to get a inputBufSize > 0 - but got %i", (int)inputBufSize);
-	mz_ulong destLen = outputBufSize;
-	int ret = ::mz_compress((unsigned char*)outputBuf, &destLen, (const unsigned char*) inputBuf, (mz_ulong)inputBufSize);
-	if (ret == MZ_OK) {
+	const uint8_t *dictData;
+	size_t dictSize;
+	clampDictionary(dictionary, dictData, dictSize);
+	if (dictSize > 0u) {
+		_scratch.clear();
+		if (!inflate(inputBuf, inputBufSize, _scratch, 0u, outputBufSize, dictionary)) {
+			return false;
+		}
+		const size_t dataSize = _scratch.size() - dictSize;
+		core_memcpy(outputBuf, _scratch.data() + dictSize, dataSize);
 		if (finalBufSize != nullptr) {
-			*finalBufSize = (size_t)destLen;
+			*finalBufSize = dataSize;
 		}
 		return true;
 	}
-	if (ret == MZ_MEM_ERROR) {
-		Log::error("Failed to compress input buffer of size %i into output buffer of size %i - there was not enough memory",
-				(int)inputBufSize, (int)outputBufSize);
+	tinfl_decompressor *state = (tinfl_decompressor*)_state;
+	tinfl_init(state);
+	size_t inSize = inputBufSize;
+	size_t outSize = outputBufSize;
+	const tinfl_status status = tinfl_decompress(state, inputBuf, &inSize, outputBuf, outputBuf, &outSize,
+			TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF | TINFL_FLAG_PARSE_ZLIB_HEADER);
+	if (status == TINFL_STATUS_DONE) {
+		if (finalBufSize != nullptr) {
+			*finalBufSize = outSize;
+		}
+		return true;
 	}
-	if (ret == MZ_BUF_ERROR) {
-		Log::error("Failed to compress input buffer of size %i into output buffer of size %i - there was not enough room in the output buffer",
+	if (status == TINFL_STATUS_HAS_MORE_OUTPUT) {
+		Log::error("Failed to uncompress input buffer of size %i into output buffer of size %i - there was not enough room in the output buffer",
+				(int)inputBufSize, (int)outputBufSize);
+	} else {
+		Log::error("Failed to uncompress input buffer of size %i into output buffer of size %i - the input data was corrupted",
 				(int)inputBufSize, (int)outputBufSize);
 	}
 	return false;
 }
 
+Compressor& compressor() {
+	static thread_local Compressor c;
+	return c;
+}
+
+Decompressor& decompressor() {
+	static thread_local Decompressor d;
+	return d;
+}
+
+uint32_t compressBound(uint32_t in) {
+	core_assert_msg(in > 0, "Expected to get a size > 0 - but got %i", (int)in);
+	return (uint32_t)::mz_compressBound((mz_ulong)in);
+}
+
+bool uncompress(const uint8_t *inputBuf, size_t inputBufSize,
+		uint8_t* outputBuf, size_t outputBufSize, size_t* finalBufSize) {
+	return decompressor().uncompress(inputBuf, inputBufSize, outputBuf, outputBufSize, finalBufSize);
+}
+
+bool compress(const uint8_t *inputBuf, size_t inputBufSize,
+		uint8_t* outputBuf, size_t outputBufSize, size_t* finalBufSize) {
+	return compressor().compress(inputBuf, inputBufSize, outputBuf, outputBufSize, finalBufSize);
+}
+
 }
 }
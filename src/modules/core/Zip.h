@@ -4,15 +4,130 @@
 
 #pragma once
 
+#include "core/collection/Buffer.h"
 #include <stdint.h>
 #include <stddef.h>
 
 namespace core {
 namespace zip {
 
+constexpr int NoCompression = 0;
+constexpr int BestSpeed = 1;
+constexpr int DefaultCompression = 6;
+constexpr int BestCompression = 9;
+
+/**
+ * @brief Preset dictionary with data that is likely to appear in the compressed payloads. Small payloads
+ * compress much better if the dictionary already contains the common byte sequences.
+ * @note Only the last 32k of the dictionary are used. Data that was compressed with a dictionary must be
+ * uncompressed with the same dictionary.
+ */
+struct Dictionary {
+	const uint8_t *data = nullptr;
+	size_t size = 0u;
+};
+
+/**
+ * @brief Reusable deflate state. Setting up the deflate state of several hundred KB is more expensive than
+ * compressing a small payload - so keep the compressor around.
+ *
+ * Without a dictionary the output is a zlib stream, with a dictionary it is a raw deflate stream. The state after
+ * applying the dictionary is kept - compressing with the same dictionary again doesn't have to re-apply it. The
+ * dictionary is identified by its data pointer and size, so don't modify the dictionary data while using it.
+ *
+ * @note Not thread safe - use @c compressor() to get an instance for the current thread
+ */
+class Compressor {
+private:
+	void *_state;
+	core::Buffer<uint8_t> *_out = nullptr;
+	size_t _outStart = 0u;
+	core::Buffer<uint8_t> _scratch;
+	/** @brief snapshot of the deflate state right after the dictionary was applied */
+	core::Buffer<uint8_t> _primed;
+	const uint8_t *_primedDictionary = nullptr;
+	size_t _primedDictionarySize = 0u;
+	int _primedLevel = -1;
+
+	bool init(int level, const Dictionary *dictionary);
+	bool deflate(const uint8_t *buf, size_t size, int flush);
+public:
+	Compressor();
+	~Compressor();
+
+	Compressor(const Compressor &) = delete;
+	Compressor &operator=(const Compressor &) = delete;
+
+	/**
+	 * @brief Start a new stream - the compressed data is appended to the given buffer
+	 */
+	bool begin(core::Buffer<uint8_t> &out, int level = DefaultCompression, const Dictionary *dictionary = nullptr);
+	bool write(const uint8_t *buf, size_t size);
+	/**
+	 * @param[out] compressedSize The amount of bytes that were appended to the output buffer
+	 */
+	bool finish(size_t *compressedSize = nullptr);
+
+	/**
+	 * @brief Compress into a fixed size buffer
+	 */
+	bool compress(const uint8_t *inputBuf, size_t inputBufSize, uint8_t *outputBuf, size_t outputBufSize,
+			size_t *finalBufSize = nullptr, int level = DefaultCompression, const Dictionary *dictionary = nullptr);
+	/**
+	 * @brief Compress and append to the given buffer
+	 */
+	bool compress(const uint8_t *inputBuf, size_t inputBufSize, core::Buffer<uint8_t> &out,
+			int level = DefaultCompression, const Dictionary *dictionary = nullptr);
+};
+
+/**
+ * @brief Reusable inflate state
+ * @note Not thread safe - use @c decompressor() to get an instance for the current thread
+ */
+class Decompressor {
+private:
+	void *_state;
+	core::Buffer<uint8_t> _scratch;
+
+	bool inflate(const uint8_t *inputBuf, size_t inputBufSize, core::Buffer<uint8_t> &out, size_t outStart,
+			size_t maxOutputSize, const Dictionary *dictionary);
+public:
+	Decompressor();
+	~Decompressor();
+
+	Decompressor(const Decompressor &) = delete;
+	Decompressor &operator=(const Decompressor &) = delete;
+
+	/**
+	 * @brief Uncompress into a fixed size buffer
+	 */
+	bool uncompress(const uint8_t *inputBuf, size_t inputBufSize, uint8_t *outputBuf, size_t outputBufSize,
+			size_t *finalBufSize = nullptr, const Dictionary *dictionary = nullptr);
+	/**
+	 * @brief Uncompress and append to the given buffer - the buffer grows as needed
+	 */
+	bool uncompress(const uint8_t *inputBuf, size_t inputBufSize, core::Buffer<uint8_t> &out,
+			const Dictionary *dictionary = nullptr);
+};
+
+/**
+ * @return The compressor of the calling thread
+ */
+extern Compressor& compressor();
+/**
+ * @return The decompressor of the calling thread
+ */
+extern Decompressor& decompressor();
+
 extern uint32_t compressBound(uint32_t in);
+/**
+ * @brief Uses the compressor of the calling thread
+ */
 extern bool compress(const uint8_t *inputBuf, size_t inputBufSize,
 		uint8_t* outputBuf, size_t outputBufSize, size_t* finalBufSize = nullptr);
+/**
+ * @brief Uses the decompressor of the calling thread
+ */
 extern bool uncompress(const uint8_t *inputBuf, size_t inputBufSize,
 		uint8_t* outputBuf, size_t outputBufSize, size_t* finalBufSize = nullptr);
 
@@ -0,0 +1,112 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/ByteStream.h"
+#include "core/collection/Buffer.h"
+
+namespace {
+
+const int Values = 4096;
+
+void addInt(benchmark::State& state) {
+	for (auto _ : state) {
+		core::ByteStream stream;
+		for (int i = 0; i < Values; ++i) {
+			stream.addInt(i);
+		}
+		benchmark::DoNotOptimize(stream.getBuffer());
+	}
+	state.SetBytesProcessed(state.iterations() * Values * sizeof(int32_t));
+}
+
+void addIntReserved(benchmark::State& state) {
+	for (auto _ : state) {
+		core::ByteStream stream(Values * sizeof(int32_t));
+		for (int i = 0; i < Values; ++i) {
+			stream.addInt(i);
+		}
+		benchmark::DoNotOptimize(stream.getBuffer());
+	}
+	state.SetBytesProcessed(state.iterations() * Values * sizeof(int32_t));
+}
+
+void addArray(benchmark::State& state) {
+	core::Buffer<int32_t> values;
+	values.resize(Values);
+	for (int i = 0; i < Values; ++i) {
+		values[i] = i;
+	}
+	for (auto _ : state) {
+		core::ByteStream stream;
+		stream.addArray(values.data(), values.size());
+		benchmark::DoNotOptimize(stream.getBuffer());
+	}
+	state.SetBytesProcessed(state.iterations() * Values * sizeof(int32_t));
+}
+
+void readInt(benchmark::State& state) {
+	core::ByteStream source;
+	for (int i = 0; i < Values; ++i) {
+		source.addInt(i);
+	}
+	for (auto _ : state) {
+		core::ByteStream stream = core::ByteStream::view(source.getBuffer(), source.getSize());
+		int32_t sum = 0;
+		for (int i = 0; i < Values; ++i) {
+			sum += stream.readInt();
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * Values * sizeof(int32_t));
+}
+
+void readArray(benchmark::State& state) {
+	core::ByteStream source;
+	for (int i = 0; i < Values; ++i) {
+		source.addInt(i);
+	}
+	core::Buffer<int32_t> values;
+	values.resize(Values);
+	for (auto _ : state) {
+		core::ByteStream stream = core::ByteStream::view(source.getBuffer(), source.getSize());
+		stream.readArray(values.data(), values.size());
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetBytesProcessed(state.iterations() * Values * sizeof(int32_t));
+}
+
+/**
+ * @brief Parsing a header from external memory by copying it into the stream first
+ */
+void parseCopy(benchmark::State& state) {
+	core::Buffer<uint8_t> payload;
+	payload.resize((size_t)state.range(0));
+	for (auto _ : state) {
+		core::ByteStream stream;
+		stream.append(payload.data(), payload.size());
+		benchmark::DoNotOptimize(stream.readInt());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void parseView(benchmark::State& state) {
+	core::Buffer<uint8_t> payload;
+	payload.resize((size_t)state.range(0));
+	for (auto _ : state) {
+		core::ByteStream stream = core::ByteStream::view(payload.data(), payload.size());
+		benchmark::DoNotOptimize(stream.readInt());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+BENCHMARK(addInt);
+BENCHMARK(addIntReserved);
+BENCHMARK(addArray);
+BENCHMARK(readInt);
+BENCHMARK(readArray);
+BENCHMARK(parseCopy)->Arg(1024)->Arg(65536);
+BENCHMARK(parseView)->Arg(1024)->Arg(65536);
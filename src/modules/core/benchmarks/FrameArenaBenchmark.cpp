@@ -0,0 +1,111 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/FrameArena.h"
+#include "core/collection/DynamicArray.h"
+#include <list>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+constexpr int Entities = 256;
+constexpr int VisibleEntities = 32;
+
+uint64_t heapAllocations = 0u;
+
+/**
+ * @brief Counts the allocations of the containers that use the heap
+ */
+template<class T>
+struct CountingAllocator : public std::allocator<T> {
+	template<class U>
+	struct rebind {
+		using other = CountingAllocator<U>;
+	};
+	CountingAllocator() = default;
+	template<class U>
+	CountingAllocator(const CountingAllocator<U>&) {
+	}
+	T* allocate(size_t n) {
+		++heapAllocations;
+		return std::allocator<T>::allocate(n);
+	}
+};
+
+struct CountingDynamicArrayAllocator {
+	static inline void* allocate(size_t size) {
+		++heapAllocations;
+		return core_malloc(size);
+	}
+	static inline void deallocate(void* ptr) {
+		core_free(ptr);
+	}
+};
+
+/**
+ * @brief The per entity work of a server tick: query the neighbours, build the visible set and collect the changes
+ */
+template<template<class> class ALLOCATOR, class ARRAYALLOCATOR>
+int64_t tick() {
+	int64_t sum = 0;
+	for (int e = 0; e < Entities; ++e) {
+		std::list<int, ALLOCATOR<int>> contents;
+		for (int i = 0; i < VisibleEntities; ++i) {
+			contents.push_back((e + i * 7) % Entities);
+		}
+		std::unordered_set<int, std::hash<int>, std::equal_to<int>, ALLOCATOR<int>> visible;
+		visible.reserve(contents.size());
+		for (int id : contents) {
+			if (id != e) {
+				visible.insert(id);
+			}
+		}
+		std::vector<int, ALLOCATOR<int>> filtered;
+		for (int id : visible) {
+			if (id & 1) {
+				filtered.push_back(id);
+			}
+		}
+		core::DynamicArray<int, 32u, ARRAYALLOCATOR> changed;
+		for (int id : filtered) {
+			changed.push_back(id);
+		}
+		sum += (int64_t)changed.size();
+	}
+	return sum;
+}
+
+void heapTick(benchmark::State& state) {
+	int64_t sum = 0;
+	heapAllocations = 0u;
+	while (state.KeepRunning()) {
+		sum += tick<CountingAllocator, CountingDynamicArrayAllocator>();
+	}
+	benchmark::DoNotOptimize(sum);
+	state.counters["allocsPerTick"] = (double)heapAllocations / (double)state.iterations();
+}
+
+void frameArenaTick(benchmark::State& state) {
+	int64_t sum = 0;
+	core::FrameArena& arena = core::frameArena();
+	arena.reset();
+	const uint64_t blocks = arena.stats().blockAllocations;
+	while (state.KeepRunning()) {
+		sum += tick<core::FrameAllocator, core::FrameArenaAllocator>();
+		arena.reset();
+	}
+	benchmark::DoNotOptimize(sum);
+	// the arena only hits the heap if it has to chain a new block
+	state.counters["allocsPerTick"] = (double)(arena.stats().blockAllocations - blocks) / (double)state.iterations();
+	state.counters["arenaAllocsPerTick"] = (double)arena.stats().lastFrameAllocations;
+	state.counters["highWaterMark"] = (double)arena.stats().highWaterMark;
+}
+
+}
+
+BENCHMARK(heapTick);
+BENCHMARK(frameArenaTick);
@@ -0,0 +1,137 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/collection/ConcurrentPriorityQueue.h"
+#include "core/collection/MPMCQueue.h"
+#include "core/collection/MPSCQueue.h"
+#include "core/collection/SPSCQueue.h"
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int Items = 100000;
+constexpr size_t Capacity = 1024u;
+
+/**
+ * @brief The queue types only differ in the way the values are handed over - these adapters hide that
+ */
+struct PriorityQueueAdapter {
+	core::ConcurrentPriorityQueue<int> queue;
+	void push(int value) {
+		queue.push(value);
+	}
+	bool waitAndPop(int& value) {
+		return queue.waitAndPop(value);
+	}
+};
+
+struct SPSCQueueAdapter {
+	core::SPSCQueue<int> queue { Capacity };
+	void push(int value) {
+		queue.push(value);
+	}
+	bool waitAndPop(int& value) {
+		return queue.waitAndPop(value);
+	}
+};
+
+struct MPMCQueueAdapter {
+	core::MPMCQueue<int> queue { Capacity };
+	void push(int value) {
+		queue.push(value);
+	}
+	bool waitAndPop(int& value) {
+		return queue.waitAndPop(value);
+	}
+};
+
+struct MPSCQueueAdapter {
+	struct Node : public core::MPSCQueueNode {
+		int value;
+	};
+	core::MPSCQueue<Node> queue;
+	// every value is only in flight once - so it can pick its node by value
+	std::vector<Node> nodes { (size_t)Items };
+	void push(int value) {
+		Node* node = &nodes[value];
+		node->value = value;
+		queue.push(node);
+	}
+	bool waitAndPop(int& value) {
+		Node* node = queue.waitAndPop();
+		if (node == nullptr) {
+			return false;
+		}
+		value = node->value;
+		return true;
+	}
+};
+
+/**
+ * @brief state.range(0) producer threads push @c Items values to the benchmark thread
+ */
+template<class QUEUE>
+void throughput(benchmark::State& state) {
+	const int producers = (int)state.range(0);
+	const int perProducer = Items / producers;
+	int64_t sum = 0;
+	while (state.KeepRunning()) {
+		QUEUE queue;
+		std::vector<std::thread> threads;
+		for (int p = 0; p < producers; ++p) {
+			threads.emplace_back([&queue, p, perProducer] () {
+				for (int i = 0; i < perProducer; ++i) {
+					queue.push(p * perProducer + i);
+				}
+			});
+		}
+		for (int i = 0; i < producers * perProducer; ++i) {
+			int value;
+			queue.waitAndPop(value);
+			sum += value;
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations() * producers * perProducer);
+}
+
+/**
+ * @brief Measures the round trip of one value that is bounced back by another thread
+ */
+template<class QUEUE>
+void latency(benchmark::State& state) {
+	QUEUE ping;
+	QUEUE pong;
+	std::thread echo([&] () {
+		int value;
+		while (ping.waitAndPop(value) && value == 0) {
+			pong.push(value);
+		}
+	});
+	while (state.KeepRunning()) {
+		ping.push(0);
+		int value;
+		pong.waitAndPop(value);
+	}
+	// any other value stops the echo thread
+	ping.push(1);
+	echo.join();
+}
+
+}
+
+BENCHMARK_TEMPLATE(throughput, PriorityQueueAdapter)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(throughput, SPSCQueueAdapter)->Arg(1)->UseRealTime();
+BENCHMARK_TEMPLATE(throughput, MPMCQueueAdapter)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(throughput, MPSCQueueAdapter)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+BENCHMARK_TEMPLATE(latency, PriorityQueueAdapter)->UseRealTime();
+BENCHMARK_TEMPLATE(latency, SPSCQueueAdapter)->UseRealTime();
+BENCHMARK_TEMPLATE(latency, MPMCQueueAdapter)->UseRealTime();
+BENCHMARK_TEMPLATE(latency, MPSCQueueAdapter)->UseRealTime();
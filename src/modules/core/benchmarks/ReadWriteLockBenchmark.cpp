@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/concurrent/ReadWriteLock.h"
+#include <SDL_mutex.h>
+
+namespace {
+
+/**
+ * @brief The old exclusive lock implementation as a baseline
+ */
+class MutexLock {
+private:
+	SDL_mutex* _mutex;
+public:
+	MutexLock(const core::String&) : _mutex(SDL_CreateMutex()) {
+	}
+	~MutexLock() {
+		SDL_DestroyMutex(_mutex);
+	}
+	void lockRead() const {
+		SDL_LockMutex(_mutex);
+	}
+	void unlockRead() const {
+		SDL_UnlockMutex(_mutex);
+	}
+	void lockWrite() {
+		SDL_LockMutex(_mutex);
+	}
+	void unlockWrite() {
+		SDL_UnlockMutex(_mutex);
+	}
+};
+
+template<class LOCK>
+struct SharedData {
+	LOCK lock {"benchmark"};
+	int values[64] {};
+};
+
+/**
+ * @brief state.range(0) is the percentage of read operations
+ */
+template<class LOCK>
+void contention(benchmark::State& state) {
+	static SharedData<LOCK> data;
+	const uint32_t readPercentage = (uint32_t)state.range(0);
+	uint32_t rnd = 0x9e3779b9u * (uint32_t)(state.thread_index + 1);
+	int64_t sum = 0;
+	for (auto _ : state) {
+		rnd = rnd * 1664525u + 1013904223u;
+		if ((rnd >> 8) % 100u < readPercentage) {
+			core::ScopedReadLock scoped(data.lock);
+			for (int v : data.values) {
+				sum += v;
+			}
+		} else {
+			core::ScopedWriteLock scoped(data.lock);
+			++data.values[rnd % 64u];
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+#define LOCK_BENCHMARK(type) \
+	BENCHMARK_TEMPLATE(contention, type)->Arg(50)->Arg(90)->Arg(99)->Arg(100)->ThreadRange(1, 8)->UseRealTime()
+
+LOCK_BENCHMARK(MutexLock);
+LOCK_BENCHMARK(core::ReadWriteLock);
+LOCK_BENCHMARK(core::DistributedReadWriteLock);
@@ -0,0 +1,82 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/StringId.h"
+#include "core/StringUtil.h"
+#include "core/collection/StringMap.h"
+
+namespace {
+
+const int Entries = 256;
+
+core::String name(int i) {
+	return core::string::format("core_benchmark_variable_%i", i);
+}
+
+void stringMapLookup(benchmark::State& state) {
+	core::StringMap<int, 64> map;
+	for (int i = 0; i < Entries; ++i) {
+		map.put(name(i), i);
+	}
+	const core::String key = name(Entries / 2);
+	for (auto _ : state) {
+		int value = 0;
+		map.get(key, value);
+		benchmark::DoNotOptimize(value);
+	}
+}
+
+void stringIdMapLookup(benchmark::State& state) {
+	core::StringIdMap<int, 64> map;
+	for (int i = 0; i < Entries; ++i) {
+		map.put(core::StringId(name(i)), i);
+	}
+	const core::StringId key(name(Entries / 2));
+	for (auto _ : state) {
+		int value = 0;
+		map.get(key, value);
+		benchmark::DoNotOptimize(value);
+	}
+}
+
+/**
+ * @brief Lookup with a string that is resolved to its id first - e.g. console input
+ */
+void stringIdMapLookupByString(benchmark::State& state) {
+	core::StringIdMap<int, 64> map;
+	for (int i = 0; i < Entries; ++i) {
+		map.put(core::StringId(name(i)), i);
+	}
+	const core::String key = name(Entries / 2);
+	for (auto _ : state) {
+		int value = 0;
+		map.get(core::StringId::find(key), value);
+		benchmark::DoNotOptimize(value);
+	}
+}
+
+void stringCompare(benchmark::State& state) {
+	const core::String a = name(1);
+	const core::String b = name(1);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a == b);
+	}
+}
+
+void stringIdCompare(benchmark::State& state) {
+	const core::StringId a(name(1));
+	const core::StringId b(name(1));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a == b);
+	}
+}
+
+}
+
+BENCHMARK(stringMapLookup);
+BENCHMARK(stringIdMapLookup);
+BENCHMARK(stringIdMapLookupByString);
+BENCHMARK(stringCompare);
+BENCHMARK(stringIdCompare);
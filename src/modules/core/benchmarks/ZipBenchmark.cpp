@@ -0,0 +1,115 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/Zip.h"
+extern "C" {
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES 1
+#include "core/miniz.h"
+}
+
+namespace {
+
+/**
+ * @brief Looks like a run length encoded voxel chunk
+ */
+void fill(core::Buffer<uint8_t>& buf, size_t size) {
+	buf.resize(size);
+	uint32_t rnd = 1u;
+	for (size_t i = 0u; i < size;) {
+		rnd = rnd * 1664525u + 1013904223u;
+		const size_t run = (rnd >> 27) + 1u;
+		for (size_t n = 0u; n < run && i < size; ++n) {
+			buf[i++] = (uint8_t)((rnd >> 16) & 7u);
+		}
+	}
+}
+
+/**
+ * @brief The old way - a fresh deflate state and output buffer for each call
+ */
+void compressOneShot(benchmark::State& state) {
+	core::Buffer<uint8_t> input;
+	fill(input, (size_t)state.range(0));
+	for (auto _ : state) {
+		mz_ulong destLen = mz_compressBound((mz_ulong)input.size());
+		uint8_t *out = new uint8_t[destLen];
+		mz_compress(out, &destLen, input.data(), (mz_ulong)input.size());
+		benchmark::DoNotOptimize(out);
+		delete[] out;
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void compressReuse(benchmark::State& state) {
+	core::Buffer<uint8_t> input;
+	fill(input, (size_t)state.range(0));
+	core::zip::Compressor& compressor = core::zip::compressor();
+	core::Buffer<uint8_t> out;
+	for (auto _ : state) {
+		out.clear();
+		compressor.compress(input.data(), input.size(), out, (int)state.range(1));
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+	state.counters["ratio"] = (double)input.size() / (double)out.size();
+}
+
+void compressDictionary(benchmark::State& state) {
+	core::Buffer<uint8_t> dict;
+	fill(dict, 32768);
+	core::Buffer<uint8_t> input;
+	fill(input, (size_t)state.range(0));
+	const core::zip::Dictionary dictionary {dict.data(), dict.size()};
+	core::zip::Compressor& compressor = core::zip::compressor();
+	core::Buffer<uint8_t> out;
+	for (auto _ : state) {
+		out.clear();
+		compressor.compress(input.data(), input.size(), out, core::zip::DefaultCompression, &dictionary);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+	state.counters["ratio"] = (double)input.size() / (double)out.size();
+}
+
+void uncompressOneShot(benchmark::State& state) {
+	core::Buffer<uint8_t> input;
+	fill(input, (size_t)state.range(0));
+	core::Buffer<uint8_t> compressed;
+	core::zip::compressor().compress(input.data(), input.size(), compressed);
+	core::Buffer<uint8_t> out;
+	out.resize(input.size());
+	for (auto _ : state) {
+		mz_ulong destLen = (mz_ulong)out.size();
+		mz_uncompress(out.data(), &destLen, compressed.data(), (mz_ulong)compressed.size());
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void uncompressReuse(benchmark::State& state) {
+	core::Buffer<uint8_t> input;
+	fill(input, (size_t)state.range(0));
+	core::Buffer<uint8_t> compressed;
+	core::zip::compressor().compress(input.data(), input.size(), compressed);
+	core::Buffer<uint8_t> out;
+	out.resize(input.size());
+	core::zip::Decompressor& decompressor = core::zip::decompressor();
+	for (auto _ : state) {
+		decompressor.uncompress(compressed.data(), compressed.size(), out.data(), out.size());
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+// state.range(0) is the payload size - 64k are 32^3 voxels with two bytes each (the default PagedVolume chunk)
+BENCHMARK(compressOneShot)->Arg(1024)->Arg(8192)->Arg(65536);
+BENCHMARK(compressReuse)
+	->Args({1024, core::zip::BestSpeed})->Args({8192, core::zip::BestSpeed})->Args({65536, core::zip::BestSpeed})
+	->Args({1024, core::zip::DefaultCompression})->Args({8192, core::zip::DefaultCompression})->Args({65536, core::zip::DefaultCompression});
+BENCHMARK(compressDictionary)->Arg(1024)->Arg(8192);
+BENCHMARK(uncompressOneShot)->Arg(1024)->Arg(65536);
+BENCHMARK(uncompressReuse)->Arg(1024)->Arg(65536);
@@ -221,6 +221,14 @@ public:
 		checkBufferSize(size);
 	}
 
+	/**
+	 * @brief Changes the size of the buffer - new elements are not initialized
+	 */
+	void resize(size_t size) {
+		checkBufferSize(size);
+		_size = size;
+	}
+
 	void clear() {
 		_size = 0u;
 	}
@@ -15,26 +15,44 @@
 
 namespace core {
 
+/**
+ * @brief Unbounded priority queue that is guarded by a mutex
+ *
+ * The entries are kept in a heap - @c pop() returns the greatest entry according to the comparator. Use the
+ * lock-free @c SPSCQueue, @c MPMCQueue or @c MPSCQueue if you only need FIFO order.
+ *
+ * @ingroup Collections
+ */
 template<class Data, class Comparator = Less<Data>>
-class ConcurrentQueue {
+class ConcurrentPriorityQueue {
 private:
 	using Collection = std::vector<Data>;
 	Collection _data;
-	mutable core_trace_mutex(core::Lock,  _mutex, "ConcurrentQueue");
+	mutable core_trace_mutex(core::Lock, _mutex, "ConcurrentPriorityQueue");
 	core::ConditionVariable _conditionVariable;
 	core::AtomicBool _abort { false };
 	Comparator _comparator;
+
+	size_t popLocked(Data* poppedValues, size_t n) {
+		size_t amount = 0u;
+		while (amount < n && !_data.empty()) {
+			poppedValues[amount++] = core::move(_data.front());
+			std::pop_heap(_data.begin(), _data.end(), _comparator);
+			_data.pop_back();
+		}
+		return amount;
+	}
 public:
 	using value_type = Data;
 	using Key = Data;
 
-	ConcurrentQueue() :
+	ConcurrentPriorityQueue() :
 			_comparator(Comparator()) {
 	}
-	ConcurrentQueue(Comparator comparator) :
+	ConcurrentPriorityQueue(Comparator comparator) :
 			_comparator(comparator) {
 	}
-	~ConcurrentQueue() {
+	~ConcurrentPriorityQueue() {
 		abortWait();
 	}
 
@@ -84,6 +102,18 @@ public:
 		_conditionVariable.notify_one();
 	}
 
+	/**
+	 * @brief Pushes all the given values with only one lock
+	 */
+	void push(const Data* data, size_t n) {
+		core::ScopedLock lock(_mutex);
+		for (size_t i = 0u; i < n; ++i) {
+			_data.push_back(data[i]);
+			std::push_heap(_data.begin(), _data.end(), _comparator);
+		}
+		_conditionVariable.notify_all();
+	}
+
 	template<typename ... _Args>
 	void emplace(_Args&&... __args) {
 		core::ScopedLock lock(_mutex);
@@ -114,9 +144,18 @@ public:
 		return true;
 	}
 
+	/**
+	 * @brief Pops up to @c n values in priority order with only one lock
+	 * @return The amount of popped values
+	 */
+	size_t pop(Data* poppedValues, size_t n) {
+		core::ScopedLock lock(_mutex);
+		return popLocked(poppedValues, n);
+	}
+
 	bool waitAndPop(Data& poppedValue) {
 		core::ScopedLock lock(_mutex);
-		if (_data.empty()) {
+		while (_data.empty() && !_abort) {
 			_conditionVariable.wait(_mutex);
 		}
 		if (_abort) {
@@ -127,6 +166,21 @@ public:
 		_data.pop_back();
 		return true;
 	}
+
+	/**
+	 * @brief Blocks until at least one value is available
+	 * @return The amount of popped values - @c 0 if the wait was aborted
+	 */
+	size_t waitAndPop(Data* poppedValues, size_t n) {
+		core::ScopedLock lock(_mutex);
+		while (_data.empty() && !_abort) {
+			_conditionVariable.wait(_mutex);
+		}
+		if (_abort) {
+			return 0u;
+		}
+		return popLocked(poppedValues, n);
+	}
 };
 
 }
@@ -11,6 +11,20 @@
 
 namespace core {
 
+/**
+ * @brief Allocates the storage of the collections from the heap
+ * @sa FrameArenaAllocator
+ */
+struct DefaultAllocator {
+	static inline void* allocate(size_t size) {
+		return core_malloc(size);
+	}
+
+	static inline void deallocate(void* ptr) {
+		core_free(ptr);
+	}
+};
+
 /**
  * @brief Dynamically growing continuous storage buffer
  *
@@ -18,10 +32,11 @@ namespace core {
  * allocate new slots given by the @c INCREASE template parameter.
  *
  * @note Use a fixed size array to prevent memory allocations - where possible
+ * @note The @c ALLOCATOR provides the static functions @c allocate(size) and @c deallocate(ptr)
  * @sa Array
  * @ingroup Collections
  */
-template<class TYPE, size_t INCREASE = 32u>
+template<class TYPE, size_t INCREASE = 32u, class ALLOCATOR = DefaultAllocator>
 class DynamicArray {
 private:
 	TYPE* _buffer = nullptr;
@@ -38,12 +53,12 @@ private:
 			return;
 		}
 		_capacity = align(newSize);
-		TYPE* newBuffer = (TYPE*)core_malloc(_capacity * sizeof(TYPE));
+		TYPE* newBuffer = (TYPE*)ALLOCATOR::allocate(_capacity * sizeof(TYPE));
 		for (size_t i = 0u; i < _size; ++i) {
 			new ((void*)&newBuffer[i]) TYPE(core::move(_buffer[i]));
 			_buffer[i].~TYPE();
 		}
-		core_free(_buffer);
+		ALLOCATOR::deallocate(_buffer);
 		_buffer = newBuffer;
 	}
 public:
@@ -344,7 +359,7 @@ public:
 		for (size_t i = 0u; i < _size; ++i) {
 			_buffer[i].~TYPE();
 		}
-		core_free(_buffer);
+		ALLOCATOR::deallocate(_buffer);
 		_capacity = 0u;
 		_size = 0u;
 		_buffer = nullptr;
@@ -0,0 +1,305 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/QueueSignal.h"
+#include "core/Common.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace core {
+
+/**
+ * @brief Bounded lock-free multi producer multi consumer FIFO ring queue
+ *
+ * Every slot carries a sequence number that tells the producers and consumers whether it's their turn - see
+ * Dmitry Vyukov's bounded MPMC queue. The push and pop operations don't take any lock, the blocking variants only
+ * park the thread if the queue stays full or empty.
+ *
+ * The batch operations claim the slots one by one, but only wake up the other side once.
+ *
+ * @note The slots keep the moved-from values until they are overwritten.
+ * @sa SPSCQueue
+ * @ingroup Collections
+ */
+template<class Data>
+class MPMCQueue {
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		Data data;
+	};
+	Cell *_cells;
+	const size_t _mask;
+	alignas(64) std::atomic<size_t> _enqueuePos { 0u };
+	alignas(64) std::atomic<size_t> _dequeuePos { 0u };
+	QueueSignal _notEmpty;
+	QueueSignal _notFull;
+
+	static size_t roundCapacity(size_t capacity) {
+		size_t pow2 = 2u;
+		while (pow2 < capacity) {
+			pow2 <<= 1;
+		}
+		return pow2;
+	}
+
+	// the notifications are done by the callers - never while waiting on the other signal
+	template<class T>
+	bool enqueue(T&& data) {
+		Cell *cell;
+		size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &_cells[pos & _mask];
+			const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+			if (diff == 0) {
+				if (_enqueuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				// full
+				return false;
+			} else {
+				pos = _enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->data = core::forward<T>(data);
+		cell->sequence.store(pos + 1u, std::memory_order_release);
+		return true;
+	}
+
+	size_t enqueue(const Data* data, size_t n) {
+		size_t amount = 0u;
+		while (amount < n && enqueue(data[amount])) {
+			++amount;
+		}
+		return amount;
+	}
+
+	bool dequeue(Data& poppedValue) {
+		Cell *cell;
+		size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &_cells[pos & _mask];
+			const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1u);
+			if (diff == 0) {
+				if (_dequeuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				// empty
+				return false;
+			} else {
+				pos = _dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+		poppedValue = core::move(cell->data);
+		cell->sequence.store(pos + _mask + 1u, std::memory_order_release);
+		return true;
+	}
+
+	size_t dequeue(Data* poppedValues, size_t n) {
+		size_t amount = 0u;
+		while (amount < n && dequeue(poppedValues[amount])) {
+			++amount;
+		}
+		return amount;
+	}
+
+public:
+	using value_type = Data;
+
+	/**
+	 * @param capacity Rounded up to the next power of two
+	 */
+	explicit MPMCQueue(size_t capacity = 256u) :
+			_mask(roundCapacity(capacity) - 1u) {
+		_cells = new Cell[_mask + 1u];
+		for (size_t i = 0u; i <= _mask; ++i) {
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~MPMCQueue() {
+		abortWait();
+		delete[] _cells;
+	}
+
+	MPMCQueue(const MPMCQueue&) = delete;
+	MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+	inline size_t capacity() const {
+		return _mask + 1u;
+	}
+
+	/**
+	 * @note Only a snapshot if other threads are active - includes the values that are currently written or read
+	 */
+	inline uint32_t size() const {
+		const size_t dequeuePos = _dequeuePos.load(std::memory_order_acquire);
+		const size_t enqueuePos = _enqueuePos.load(std::memory_order_acquire);
+		if (enqueuePos < dequeuePos) {
+			return 0u;
+		}
+		return (uint32_t)(enqueuePos - dequeuePos);
+	}
+
+	inline bool empty() const {
+		return size() == 0u;
+	}
+
+	/**
+	 * @brief Wakes up all threads that are blocked in a push or pop call. They return @c false.
+	 * @sa reset()
+	 */
+	void abortWait() {
+		_notEmpty.abort();
+		_notFull.abort();
+	}
+
+	void reset() {
+		_notEmpty.reset();
+		_notFull.reset();
+	}
+
+	/**
+	 * @brief Drops all entries
+	 */
+	void clear() {
+		Data data;
+		while (dequeue(data)) {
+		}
+		_notFull.notify();
+	}
+
+	bool tryPush(const Data& data) {
+		if (!enqueue(data)) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	bool tryPush(Data&& data) {
+		if (!enqueue(core::move(data))) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Pushes as many of the given values as there are free slots
+	 * @return The amount of values that were pushed
+	 */
+	size_t tryPush(const Data* data, size_t n) {
+		const size_t amount = enqueue(data, n);
+		if (amount > 0u) {
+			_notEmpty.notify();
+		}
+		return amount;
+	}
+
+	/**
+	 * @brief Blocks while the queue is full
+	 * @return @c false if the wait was aborted
+	 */
+	bool push(const Data& data) {
+		if (!_notFull.wait([&] () { return enqueue(data); })) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	bool push(Data&& data) {
+		if (!_notFull.wait([&] () { return enqueue(core::move(data)); })) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Blocks until all values were pushed
+	 * @return @c false if the wait was aborted
+	 */
+	bool push(const Data* data, size_t n) {
+		size_t pushed = 0u;
+		while (pushed < n) {
+			size_t amount = 0u;
+			if (!_notFull.wait([&] () {
+				amount = enqueue(data + pushed, n - pushed);
+				return amount > 0u;
+			})) {
+				return false;
+			}
+			pushed += amount;
+			_notEmpty.notify();
+		}
+		return true;
+	}
+
+	template<typename ... _Args>
+	bool emplace(_Args&&... __args) {
+		return push(Data(core::forward<_Args>(__args)...));
+	}
+
+	/**
+	 * @return @c false if the queue is empty
+	 */
+	bool pop(Data& poppedValue) {
+		if (!dequeue(poppedValue)) {
+			return false;
+		}
+		_notFull.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Pops up to @c n values
+	 * @return The amount of popped values
+	 */
+	size_t pop(Data* poppedValues, size_t n) {
+		const size_t amount = dequeue(poppedValues, n);
+		if (amount > 0u) {
+			_notFull.notify();
+		}
+		return amount;
+	}
+
+	/**
+	 * @brief Blocks while the queue is empty
+	 * @return @c false if the wait was aborted
+	 */
+	bool waitAndPop(Data& poppedValue) {
+		if (!_notEmpty.wait([&] () { return dequeue(poppedValue); })) {
+			return false;
+		}
+		_notFull.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Blocks until at least one value is available
+	 * @return The amount of popped values - @c 0 if the wait was aborted
+	 */
+	size_t waitAndPop(Data* poppedValues, size_t n) {
+		size_t amount = 0u;
+		if (!_notEmpty.wait([&] () {
+			amount = dequeue(poppedValues, n);
+			return amount > 0u;
+		})) {
+			return 0u;
+		}
+		_notFull.notify();
+		return amount;
+	}
+};
+
+}
@@ -0,0 +1,184 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/QueueSignal.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace core {
+
+/**
+ * @brief Base class for the entries of a @c MPSCQueue
+ */
+struct MPSCQueueNode {
+	std::atomic<MPSCQueueNode*> next { nullptr };
+};
+
+/**
+ * @brief Unbounded lock-free intrusive multi producer single consumer FIFO queue
+ *
+ * The entries derive from @c MPSCQueueNode - the queue doesn't allocate and doesn't own them. Pushing is wait free
+ * and a batch of entries is linked with a single atomic exchange. See Dmitry Vyukov's intrusive MPSC queue.
+ *
+ * @note Only one thread may pop at a time
+ * @note A pop can miss an entry while a producer is in the middle of its push - it will be visible with the next pop
+ * @ingroup Collections
+ */
+template<class Node>
+class MPSCQueue {
+private:
+	alignas(64) std::atomic<MPSCQueueNode*> _head;
+	std::atomic<int> _size { 0 };
+	alignas(64) MPSCQueueNode* _tail;
+	MPSCQueueNode _stub;
+	QueueSignal _notEmpty;
+
+	void link(MPSCQueueNode* first, MPSCQueueNode* last) {
+		last->next.store(nullptr, std::memory_order_relaxed);
+		MPSCQueueNode* prev = _head.exchange(last, std::memory_order_acq_rel);
+		prev->next.store(first, std::memory_order_release);
+	}
+
+	Node* dequeue() {
+		MPSCQueueNode* tail = _tail;
+		MPSCQueueNode* next = tail->next.load(std::memory_order_acquire);
+		if (tail == &_stub) {
+			if (next == nullptr) {
+				return nullptr;
+			}
+			_tail = next;
+			tail = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+		if (next != nullptr) {
+			_tail = next;
+			_size.fetch_sub(1, std::memory_order_relaxed);
+			return static_cast<Node*>(tail);
+		}
+		if (tail != _head.load(std::memory_order_acquire)) {
+			// a producer is in the middle of linking its entry
+			return nullptr;
+		}
+		// the last entry can only be handed out if something is behind it
+		link(&_stub, &_stub);
+		next = tail->next.load(std::memory_order_acquire);
+		if (next != nullptr) {
+			_tail = next;
+			_size.fetch_sub(1, std::memory_order_relaxed);
+			return static_cast<Node*>(tail);
+		}
+		return nullptr;
+	}
+
+public:
+	using value_type = Node*;
+
+	MPSCQueue() : _head(&_stub), _tail(&_stub) {
+	}
+
+	~MPSCQueue() {
+		abortWait();
+	}
+
+	MPSCQueue(const MPSCQueue&) = delete;
+	MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+	/**
+	 * @note Only a snapshot if other threads are active
+	 */
+	inline uint32_t size() const {
+		const int size = _size.load(std::memory_order_acquire);
+		return size < 0 ? 0u : (uint32_t)size;
+	}
+
+	inline bool empty() const {
+		return size() == 0u;
+	}
+
+	/**
+	 * @brief Wakes up the consumer if it is blocked in @c waitAndPop()
+	 * @sa reset()
+	 */
+	void abortWait() {
+		_notEmpty.abort();
+	}
+
+	void reset() {
+		_notEmpty.reset();
+	}
+
+	void push(Node* node) {
+		_size.fetch_add(1, std::memory_order_relaxed);
+		link(node, node);
+		_notEmpty.notify();
+	}
+
+	/**
+	 * @brief Links all the given entries with one atomic operation - they are popped in the given order
+	 */
+	void push(Node** nodes, size_t n) {
+		if (n == 0u) {
+			return;
+		}
+		for (size_t i = 0u; i + 1u < n; ++i) {
+			nodes[i]->next.store(nodes[i + 1u], std::memory_order_relaxed);
+		}
+		_size.fetch_add((int)n, std::memory_order_relaxed);
+		link(nodes[0], nodes[n - 1u]);
+		_notEmpty.notify();
+	}
+
+	/**
+	 * @return @c nullptr if the queue is empty
+	 */
+	Node* pop() {
+		return dequeue();
+	}
+
+	/**
+	 * @return The amount of popped entries
+	 */
+	size_t pop(Node** nodes, size_t n) {
+		size_t amount = 0u;
+		while (amount < n) {
+			Node* node = dequeue();
+			if (node == nullptr) {
+				break;
+			}
+			nodes[amount++] = node;
+		}
+		return amount;
+	}
+
+	/**
+	 * @brief Blocks while the queue is empty
+	 * @return @c nullptr if the wait was aborted
+	 */
+	Node* waitAndPop() {
+		Node* node = nullptr;
+		_notEmpty.wait([&] () {
+			node = dequeue();
+			return node != nullptr;
+		});
+		return node;
+	}
+
+	/**
+	 * @brief Blocks until at least one entry is available
+	 * @return The amount of popped entries - @c 0 if the wait was aborted
+	 */
+	size_t waitAndPop(Node** nodes, size_t n) {
+		size_t amount = 0u;
+		_notEmpty.wait([&] () {
+			amount = pop(nodes, n);
+			return amount > 0u;
+		});
+		return amount;
+	}
+};
+
+}
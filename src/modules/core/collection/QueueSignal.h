@@ -0,0 +1,96 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/Trace.h"
+#include <atomic>
+
+namespace core {
+
+/**
+ * @brief Parks the threads that have to wait for a lock-free queue
+ *
+ * The queue operations themselves never touch the mutex. Only threads that have to wait take it - and the other
+ * side only takes it to wake them up if somebody is waiting.
+ *
+ * @ingroup Collections
+ */
+class QueueSignal {
+private:
+	static constexpr int SpinCount = 64;
+	core_trace_mutex(core::Lock, _mutex, "QueueSignal");
+	core::ConditionVariable _conditionVariable;
+	std::atomic<int> _waiters { 0 };
+	std::atomic<bool> _abort { false };
+
+public:
+	/**
+	 * @brief Blocks until the given operation succeeds or @c abort() was called
+	 * @param op Tries the queue operation, returns @c true on success
+	 * @return @c false if the wait was aborted
+	 */
+	template<class OP>
+	bool wait(OP&& op) {
+		for (int i = 0; i < SpinCount; ++i) {
+			if (op()) {
+				return true;
+			}
+			if (_abort.load(std::memory_order_relaxed)) {
+				return false;
+			}
+		}
+		core::ScopedLock lock(_mutex);
+		_waiters.fetch_add(1, std::memory_order_seq_cst);
+		// pairs with the fence in notify() - either we see the change or the other side sees the waiter
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		bool success;
+		for (;;) {
+			if (op()) {
+				success = true;
+				break;
+			}
+			if (_abort.load(std::memory_order_acquire)) {
+				success = false;
+				break;
+			}
+			_conditionVariable.wait(_mutex);
+		}
+		_waiters.fetch_sub(1, std::memory_order_relaxed);
+		return success;
+	}
+
+	/**
+	 * @brief Call this after the queue state changed in a way the waiting threads are interested in
+	 */
+	void notify() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_waiters.load(std::memory_order_relaxed) == 0) {
+			return;
+		}
+		core::ScopedLock lock(_mutex);
+		_conditionVariable.notify_all();
+	}
+
+	/**
+	 * @brief Wakes up all waiting threads - they return without performing their operation
+	 */
+	void abort() {
+		_abort.store(true, std::memory_order_release);
+		core::ScopedLock lock(_mutex);
+		_conditionVariable.notify_all();
+	}
+
+	void reset() {
+		_abort.store(false, std::memory_order_release);
+	}
+
+	bool aborted() const {
+		return _abort.load(std::memory_order_acquire);
+	}
+};
+
+}
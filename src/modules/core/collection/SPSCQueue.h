@@ -0,0 +1,304 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/QueueSignal.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include <atomic>
+#include <stddef.h>
+
+namespace core {
+
+/**
+ * @brief Bounded lock-free single producer single consumer FIFO ring queue
+ *
+ * Only one thread may push and only one thread may pop at a time. The push and pop operations don't take any lock,
+ * the blocking variants only park the thread if the queue stays full or empty.
+ *
+ * @note The slots keep the moved-from values until they are overwritten.
+ * @sa MPMCQueue
+ * @ingroup Collections
+ */
+template<class Data>
+class SPSCQueue {
+private:
+	Data *_data;
+	const size_t _mask;
+	alignas(64) std::atomic<size_t> _write { 0u };
+	/** @brief only accessed by the producer */
+	size_t _cachedRead = 0u;
+	alignas(64) std::atomic<size_t> _read { 0u };
+	/** @brief only accessed by the consumer */
+	size_t _cachedWrite = 0u;
+	QueueSignal _notEmpty;
+	QueueSignal _notFull;
+
+	static size_t roundCapacity(size_t capacity) {
+		size_t pow2 = 2u;
+		while (pow2 < capacity) {
+			pow2 <<= 1;
+		}
+		return pow2;
+	}
+
+	/**
+	 * @return The amount of slots the producer can write to - only refreshed if less than @c wanted are known
+	 */
+	size_t writable(size_t write, size_t wanted) {
+		size_t free = capacity() - (write - _cachedRead);
+		if (free < wanted) {
+			_cachedRead = _read.load(std::memory_order_acquire);
+			free = capacity() - (write - _cachedRead);
+		}
+		return free;
+	}
+
+	/**
+	 * @return The amount of slots the consumer can read from - only refreshed if less than @c wanted are known
+	 */
+	size_t readable(size_t read, size_t wanted) {
+		size_t available = _cachedWrite - read;
+		if (available < wanted) {
+			_cachedWrite = _write.load(std::memory_order_acquire);
+			available = _cachedWrite - read;
+		}
+		return available;
+	}
+
+	// the notifications are done by the callers - never while waiting on the other signal
+	template<class T>
+	bool enqueue(T&& data) {
+		const size_t write = _write.load(std::memory_order_relaxed);
+		if (writable(write, 1u) == 0u) {
+			return false;
+		}
+		_data[write & _mask] = core::forward<T>(data);
+		_write.store(write + 1u, std::memory_order_release);
+		return true;
+	}
+
+	size_t enqueue(const Data* data, size_t n) {
+		const size_t write = _write.load(std::memory_order_relaxed);
+		const size_t free = writable(write, n);
+		const size_t amount = core_min(free, n);
+		for (size_t i = 0u; i < amount; ++i) {
+			_data[(write + i) & _mask] = data[i];
+		}
+		if (amount > 0u) {
+			_write.store(write + amount, std::memory_order_release);
+		}
+		return amount;
+	}
+
+	bool dequeue(Data& poppedValue) {
+		const size_t read = _read.load(std::memory_order_relaxed);
+		if (readable(read, 1u) == 0u) {
+			return false;
+		}
+		poppedValue = core::move(_data[read & _mask]);
+		_read.store(read + 1u, std::memory_order_release);
+		return true;
+	}
+
+	size_t dequeue(Data* poppedValues, size_t n) {
+		const size_t read = _read.load(std::memory_order_relaxed);
+		const size_t available = readable(read, n);
+		const size_t amount = core_min(available, n);
+		for (size_t i = 0u; i < amount; ++i) {
+			poppedValues[i] = core::move(_data[(read + i) & _mask]);
+		}
+		if (amount > 0u) {
+			_read.store(read + amount, std::memory_order_release);
+		}
+		return amount;
+	}
+
+public:
+	using value_type = Data;
+
+	/**
+	 * @param capacity Rounded up to the next power of two
+	 */
+	explicit SPSCQueue(size_t capacity = 256u) :
+			_mask(roundCapacity(capacity) - 1u) {
+		_data = new Data[_mask + 1u];
+	}
+
+	~SPSCQueue() {
+		abortWait();
+		delete[] _data;
+	}
+
+	SPSCQueue(const SPSCQueue&) = delete;
+	SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+	inline size_t capacity() const {
+		return _mask + 1u;
+	}
+
+	/**
+	 * @note Only a snapshot if the other side is active
+	 */
+	inline uint32_t size() const {
+		const size_t read = _read.load(std::memory_order_acquire);
+		return (uint32_t)(_write.load(std::memory_order_acquire) - read);
+	}
+
+	inline bool empty() const {
+		return size() == 0u;
+	}
+
+	/**
+	 * @brief Wakes up all threads that are blocked in a push or pop call. They return @c false.
+	 * @sa reset()
+	 */
+	void abortWait() {
+		_notEmpty.abort();
+		_notFull.abort();
+	}
+
+	void reset() {
+		_notEmpty.reset();
+		_notFull.reset();
+	}
+
+	/**
+	 * @brief Drops all entries
+	 * @note Must be called by the consumer
+	 */
+	void clear() {
+		const size_t write = _write.load(std::memory_order_acquire);
+		_cachedWrite = write;
+		_read.store(write, std::memory_order_release);
+		_notFull.notify();
+	}
+
+	bool tryPush(const Data& data) {
+		if (!enqueue(data)) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	bool tryPush(Data&& data) {
+		if (!enqueue(core::move(data))) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Pushes as many of the given values as there are free slots - with only one publication
+	 * @return The amount of values that were pushed
+	 */
+	size_t tryPush(const Data* data, size_t n) {
+		const size_t amount = enqueue(data, n);
+		if (amount > 0u) {
+			_notEmpty.notify();
+		}
+		return amount;
+	}
+
+	/**
+	 * @brief Blocks while the queue is full
+	 * @return @c false if the wait was aborted
+	 */
+	bool push(const Data& data) {
+		if (!_notFull.wait([&] () { return enqueue(data); })) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	bool push(Data&& data) {
+		if (!_notFull.wait([&] () { return enqueue(core::move(data)); })) {
+			return false;
+		}
+		_notEmpty.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Blocks until all values were pushed
+	 * @return @c false if the wait was aborted
+	 */
+	bool push(const Data* data, size_t n) {
+		size_t pushed = 0u;
+		while (pushed < n) {
+			size_t amount = 0u;
+			if (!_notFull.wait([&] () {
+				amount = enqueue(data + pushed, n - pushed);
+				return amount > 0u;
+			})) {
+				return false;
+			}
+			pushed += amount;
+			_notEmpty.notify();
+		}
+		return true;
+	}
+
+	template<typename ... _Args>
+	bool emplace(_Args&&... __args) {
+		return push(Data(core::forward<_Args>(__args)...));
+	}
+
+	/**
+	 * @return @c false if the queue is empty
+	 */
+	bool pop(Data& poppedValue) {
+		if (!dequeue(poppedValue)) {
+			return false;
+		}
+		_notFull.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Pops up to @c n values with only one publication
+	 * @return The amount of popped values
+	 */
+	size_t pop(Data* poppedValues, size_t n) {
+		const size_t amount = dequeue(poppedValues, n);
+		if (amount > 0u) {
+			_notFull.notify();
+		}
+		return amount;
+	}
+
+	/**
+	 * @brief Blocks while the queue is empty
+	 * @return @c false if the wait was aborted
+	 */
+	bool waitAndPop(Data& poppedValue) {
+		if (!_notEmpty.wait([&] () { return dequeue(poppedValue); })) {
+			return false;
+		}
+		_notFull.notify();
+		return true;
+	}
+
+	/**
+	 * @brief Blocks until at least one value is available
+	 * @return The amount of popped values - @c 0 if the wait was aborted
+	 */
+	size_t waitAndPop(Data* poppedValues, size_t n) {
+		size_t amount = 0u;
+		if (!_notEmpty.wait([&] () {
+			amount = dequeue(poppedValues, n);
+			return amount > 0u;
+		})) {
+			return 0u;
+		}
+		_notFull.notify();
+		return amount;
+	}
+};
+
+}
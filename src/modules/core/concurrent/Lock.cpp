@@ -8,7 +8,8 @@
 namespace core {
 
 #ifdef TRACY_ENABLE
-Lock::Lock(const tracy::SourceLocationData& srcloc) : _mutex(SDL_CreateMutex()), _srcLoc(srcloc), _ctx(&_srcLoc) {
+Lock::Lock(const tracy::SourceLocationData& srcloc) :
+		_mutex(SDL_CreateMutex()), _stats(LockStats::entry(srcloc.name)), _srcLoc(srcloc), _ctx(&_srcLoc) {
 }
 
 void Lock::Mark(const tracy::SourceLocationData *srcloc) {
@@ -19,12 +20,13 @@ void Lock::CustomName(const char *name, size_t size) {
 	_ctx.CustomName(name, size);
 }
 #else
-Lock::Lock() :
-		_mutex(SDL_CreateMutex()) {
+Lock::Lock(const char *name) :
+		_mutex(SDL_CreateMutex()), _stats(LockStats::entry(name)) {
 }
 #endif
 
 Lock::~Lock() {
+	LockStats::release(_stats);
 	SDL_DestroyMutex(_mutex);
 }
 
@@ -32,19 +34,39 @@ SDL_mutex* Lock::handle() {
 	return _mutex;
 }
 
+void Lock::locked(uint64_t holdStart) const {
+	if (++_recursion == 1) {
+		_holdStart = holdStart;
+	}
+}
+
+void Lock::lockMutex() const {
+	if (SDL_TryLockMutex(_mutex) == 0) {
+		locked(LockStats::acquired(_stats));
+		return;
+	}
+	const uint64_t waitStart = LockStats::waitStart(_stats);
+	SDL_LockMutex(_mutex);
+	locked(LockStats::contended(_stats, waitStart));
+}
+
 void Lock::lock() const {
 #ifdef TRACY_ENABLE
 	const auto runAfter = _ctx.BeforeLock();
-	SDL_LockMutex(_mutex);
+	lockMutex();
 	if (runAfter) {
 		_ctx.AfterLock();
 	}
 #else
-	SDL_LockMutex(_mutex);
+	lockMutex();
 #endif
 }
 
 void Lock::unlock() const {
+	if (--_recursion == 0 && _holdStart != 0u) {
+		LockStats::released(_stats, _holdStart);
+		_holdStart = 0u;
+	}
 	SDL_UnlockMutex(_mutex);
 #ifdef TRACY_ENABLE
 	_ctx.AfterUnlock();
@@ -53,6 +75,9 @@ void Lock::unlock() const {
 
 bool Lock::try_lock() const {
 	const bool acquired = SDL_TryLockMutex(_mutex) == 0;
+	if (acquired) {
+		locked(LockStats::acquired(_stats));
+	}
 #ifdef TRACY_ENABLE
 	_ctx.AfterTryLock(acquired);
 #endif
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "core/concurrent/LockStats.h"
 #ifdef TRACY_ENABLE
 #include "core/tracy/Tracy.hpp"
 #endif
@@ -12,9 +13,20 @@ struct SDL_mutex;
 
 namespace core {
 
+/**
+ * @brief Recursive mutex - the contention is accounted in @c LockStats by the name of the lock
+ */
 class Lock {
 private:
 	mutable SDL_mutex* _mutex;
+	LockStats::Entry* _stats;
+	/** @brief only accessed by the thread that holds the lock */
+	mutable uint64_t _holdStart = 0u;
+	/** @brief only accessed by the thread that holds the lock - the hold time is measured for the outermost lock */
+	mutable int _recursion = 0;
+
+	void lockMutex() const;
+	void locked(uint64_t holdStart) const;
 public:
 #ifdef TRACY_ENABLE
 	const tracy::SourceLocationData _srcLoc;
@@ -23,7 +35,7 @@ public:
 	void Mark(const tracy::SourceLocationData *srcloc);
 	void CustomName(const char *name, size_t size);
 #else
-	Lock();
+	Lock(const char *name = nullptr);
 #endif
 	~Lock();
 
@@ -0,0 +1,200 @@
+/**
+ * @file
+ */
+
+#include "LockStats.h"
+#include "core/Algorithm.h"
+#include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/TimeProvider.h"
+#include <SDL_mutex.h>
+#include <SDL_stdinc.h>
+
+namespace core {
+
+std::atomic<uint32_t> LockStats::_sampleRate { LockStats::DefaultSampleRate };
+thread_local uint32_t LockStats::_sampleCounter = 0u;
+
+namespace {
+
+/**
+ * @brief The locks hold a pointer to their entry - the registry is created on first use (locks can be static)
+ * and intentionally never freed, as there might still be locks alive during the static destruction.
+ */
+struct Registry {
+	SDL_mutex* mutex = SDL_CreateMutex();
+	core::DynamicArray<LockStats::Entry*> entries;
+};
+
+Registry& registry() {
+	static Registry* r = new Registry();
+	return *r;
+}
+
+uint64_t toMicros(uint64_t delta) {
+	static const uint64_t resolution = core::TimeProvider::highResTimeResolution();
+	return delta * 1000000u / resolution;
+}
+
+int waitBucket(uint64_t micros) {
+	int bucket = 0;
+	while (micros > 0u && bucket < LockStats::WaitBuckets - 1) {
+		micros >>= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+void snapshot(const LockStats::Entry& entry, LockStats::Stats& stats) {
+	stats.name = entry.name;
+	stats.locks = entry.locks;
+	stats.acquisitions = entry.acquisitions;
+	stats.contended = entry.contended;
+	stats.waitMicros = entry.waitMicros;
+	stats.maxWaitMicros = entry.maxWaitMicros;
+	stats.maxHoldMicros = entry.maxHoldMicros;
+	for (int i = 0; i < LockStats::WaitBuckets; ++i) {
+		stats.waitHistogram[i] = entry.waitHistogram[i];
+	}
+}
+
+}
+
+LockStats::Entry* LockStats::entry(const char *name) {
+	if (name == nullptr || name[0] == '\0') {
+		return nullptr;
+	}
+	Registry& r = registry();
+	SDL_LockMutex(r.mutex);
+	Entry* found = nullptr;
+	for (Entry* e : r.entries) {
+		if (e->name == name) {
+			found = e;
+			break;
+		}
+	}
+	if (found == nullptr) {
+		found = new Entry();
+		found->name = name;
+		r.entries.push_back(found);
+	}
+	++found->locks;
+	SDL_UnlockMutex(r.mutex);
+	return found;
+}
+
+void LockStats::release(Entry* entry) {
+	if (entry != nullptr) {
+		--entry->locks;
+	}
+}
+
+uint64_t LockStats::now() {
+	return core::TimeProvider::highResTime();
+}
+
+void LockStats::updateMax(std::atomic<uint64_t>& value, uint64_t newValue) {
+	uint64_t current = value.load(std::memory_order_relaxed);
+	while (current < newValue && !value.compare_exchange_weak(current, newValue, std::memory_order_relaxed)) {
+	}
+}
+
+uint64_t LockStats::sampled(Entry* entry, uint32_t weight) {
+	entry->acquisitions.fetch_add(weight, std::memory_order_relaxed);
+	return now();
+}
+
+uint64_t LockStats::contended(Entry* entry, uint64_t waitStart) {
+	if (entry == nullptr || waitStart == 0u) {
+		return 0u;
+	}
+	const uint64_t holdStart = now();
+	const uint64_t micros = toMicros(holdStart - waitStart);
+	entry->acquisitions.fetch_add(1u, std::memory_order_relaxed);
+	entry->contended.fetch_add(1u, std::memory_order_relaxed);
+	entry->waitMicros.fetch_add(micros, std::memory_order_relaxed);
+	entry->waitHistogram[waitBucket(micros)].fetch_add(1u, std::memory_order_relaxed);
+	updateMax(entry->maxWaitMicros, micros);
+	return holdStart;
+}
+
+void LockStats::released(Entry* entry, uint64_t holdStart) {
+	if (entry == nullptr || holdStart == 0u) {
+		return;
+	}
+	updateMax(entry->maxHoldMicros, toMicros(now() - holdStart));
+}
+
+void LockStats::setSampleRate(uint32_t sampleRate) {
+	_sampleRate = sampleRate;
+}
+
+void LockStats::stats(core::DynamicArray<Stats>& stats) {
+	Registry& r = registry();
+	SDL_LockMutex(r.mutex);
+	stats.reserve(stats.size() + r.entries.size());
+	for (const Entry* e : r.entries) {
+		Stats s;
+		snapshot(*e, s);
+		stats.push_back(s);
+	}
+	SDL_UnlockMutex(r.mutex);
+	core::sort(stats.begin(), stats.end(), [] (const Stats& lhs, const Stats& rhs) {
+		return lhs.waitMicros > rhs.waitMicros;
+	});
+}
+
+bool LockStats::stats(const core::String& name, Stats& stats) {
+	Registry& r = registry();
+	SDL_LockMutex(r.mutex);
+	bool found = false;
+	for (const Entry* e : r.entries) {
+		if (e->name == name) {
+			snapshot(*e, stats);
+			found = true;
+			break;
+		}
+	}
+	SDL_UnlockMutex(r.mutex);
+	return found;
+}
+
+void LockStats::reset() {
+	Registry& r = registry();
+	SDL_LockMutex(r.mutex);
+	for (Entry* e : r.entries) {
+		e->acquisitions = 0u;
+		e->contended = 0u;
+		e->waitMicros = 0u;
+		e->maxWaitMicros = 0u;
+		e->maxHoldMicros = 0u;
+		for (int i = 0; i < WaitBuckets; ++i) {
+			e->waitHistogram[i] = 0u;
+		}
+	}
+	SDL_UnlockMutex(r.mutex);
+}
+
+void LockStats::log() {
+	if (sampleRate() == 0u) {
+		Log::info("Lock stats are disabled");
+		return;
+	}
+	core::DynamicArray<Stats> all;
+	stats(all);
+	Log::info("Lock stats (every %u. uncontended acquisition is sampled):", sampleRate());
+	for (const Stats& s : all) {
+		if (s.contended == 0u) {
+			continue;
+		}
+		core::String histogram;
+		for (int i = 0; i < WaitBuckets; ++i) {
+			histogram += core::string::format(i == 0 ? "%" SDL_PRIu64 : " %" SDL_PRIu64, s.waitHistogram[i]);
+		}
+		Log::info("%s (%i locks): acquisitions: ~%" SDL_PRIu64 ", contended: %" SDL_PRIu64 ", wait: %" SDL_PRIu64 "us (max %" SDL_PRIu64
+				"us), max hold: %" SDL_PRIu64 "us, wait histogram: [%s]", s.name.c_str(), s.locks, s.acquisitions, s.contended,
+				s.waitMicros, s.maxWaitMicros, s.maxHoldMicros, histogram.c_str());
+	}
+}
+
+}
@@ -0,0 +1,141 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include <atomic>
+#include <stdint.h>
+
+namespace core {
+
+/**
+ * @brief Contention accounting for the named locks
+ *
+ * All locks with the same name share one entry. The uncontended acquisitions are only sampled (every n-th
+ * acquisition of a thread is accounted with the weight n) to keep the overhead of the fast path to a thread local
+ * counter. Contended acquisitions are always accounted - the thread has to wait anyway.
+ *
+ * The hold times are measured for the sampled and the contended acquisitions of exclusive and write locks.
+ *
+ * @sa Lock
+ * @sa ReadWriteLock
+ */
+class LockStats {
+public:
+	/**
+	 * @brief Bucket @c 0 are waits below one microsecond, bucket @c i are waits in the range [2^(i-1), 2^i) microseconds.
+	 * The last bucket contains everything above.
+	 */
+	static constexpr int WaitBuckets = 16;
+	static constexpr uint32_t DefaultSampleRate = 16u;
+
+	struct Entry {
+		core::String name;
+		std::atomic<int> locks { 0 };
+		std::atomic<uint64_t> acquisitions { 0u };
+		std::atomic<uint64_t> contended { 0u };
+		std::atomic<uint64_t> waitMicros { 0u };
+		std::atomic<uint64_t> maxWaitMicros { 0u };
+		std::atomic<uint64_t> maxHoldMicros { 0u };
+		std::atomic<uint64_t> waitHistogram[WaitBuckets] {};
+	};
+
+	/**
+	 * @brief Snapshot of an @c Entry
+	 */
+	struct Stats {
+		core::String name;
+		int locks = 0;
+		/** @brief estimated from the samples */
+		uint64_t acquisitions = 0u;
+		uint64_t contended = 0u;
+		uint64_t waitMicros = 0u;
+		uint64_t maxWaitMicros = 0u;
+		uint64_t maxHoldMicros = 0u;
+		uint64_t waitHistogram[WaitBuckets] {};
+	};
+
+private:
+	static std::atomic<uint32_t> _sampleRate;
+	static thread_local uint32_t _sampleCounter;
+
+	static uint64_t sampled(Entry* entry, uint32_t weight);
+	static void updateMax(std::atomic<uint64_t>& value, uint64_t newValue);
+public:
+	/**
+	 * @brief Returns the entry for the given lock name - the entries are never freed
+	 * @return @c nullptr if the given name is @c nullptr or empty
+	 */
+	static Entry* entry(const char *name);
+	/**
+	 * @brief Tells the entry that a lock with this name was destroyed
+	 */
+	static void release(Entry* entry);
+
+	static uint64_t now();
+
+	/**
+	 * @brief Account an uncontended acquisition
+	 * @return The hold start time or @c 0 if this acquisition wasn't sampled
+	 */
+	static uint64_t acquired(Entry* entry);
+	/**
+	 * @return The timestamp to hand into @c contended() or @c 0 if nothing is accounted for the lock
+	 */
+	static uint64_t waitStart(Entry* entry);
+	/**
+	 * @brief Account a contended acquisition
+	 * @param[in] waitStart The value returned by @c waitStart()
+	 * @return The hold start time or @c 0
+	 */
+	static uint64_t contended(Entry* entry, uint64_t waitStart);
+	/**
+	 * @param[in] holdStart The value returned by @c acquired() or @c contended()
+	 */
+	static void released(Entry* entry, uint64_t holdStart);
+
+	/**
+	 * @brief Every n-th uncontended acquisition is sampled - @c 0 disables the accounting
+	 */
+	static void setSampleRate(uint32_t sampleRate);
+	static uint32_t sampleRate();
+
+	/**
+	 * @brief Snapshot of all entries - sorted by the accumulated wait time
+	 */
+	static void stats(core::DynamicArray<Stats>& stats);
+	static bool stats(const core::String& name, Stats& stats);
+	static void reset();
+	/**
+	 * @brief Logs the entries with contended acquisitions
+	 */
+	static void log();
+};
+
+inline uint32_t LockStats::sampleRate() {
+	return _sampleRate.load(std::memory_order_relaxed);
+}
+
+inline uint64_t LockStats::acquired(Entry* entry) {
+	if (entry == nullptr) {
+		return 0u;
+	}
+	const uint32_t rate = sampleRate();
+	if (rate == 0u || ++_sampleCounter < rate) {
+		return 0u;
+	}
+	_sampleCounter = 0u;
+	return sampled(entry, rate);
+}
+
+inline uint64_t LockStats::waitStart(Entry* entry) {
+	if (entry == nullptr || sampleRate() == 0u) {
+		return 0u;
+	}
+	return now();
+}
+
+}
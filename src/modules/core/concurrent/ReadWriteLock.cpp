@@ -3,32 +3,297 @@
  */
 
 #include "ReadWriteLock.h"
+#include "core/Assert.h"
 #include <SDL_mutex.h>
+#include <SDL_thread.h>
+#include <SDL_timer.h>
 
 namespace core {
 
-ReadWriteLock::ReadWriteLock(const core::String& name) :
-		_name(name), _mutex(SDL_CreateMutex()) {
+namespace {
+
+/**
+ * @brief The amount of @c ReadWriteLock read locks the current thread holds - on any lock. Threads that already hold
+ * a read lock don't wait for pending writers. Otherwise nested read locks would deadlock as soon as a writer is
+ * waiting. This only skips the writer preference - a lock that is owned by a writer is never entered.
+ */
+thread_local int readLocksHeld = 0;
+
+/**
+ * @brief The distributed read locks the current thread holds together with their recursion depth. Only the
+ * outermost read lock of a thread is counted in the slot - nested read locks on the same lock just increase the
+ * depth and never wait for a writer.
+ */
+struct HeldReadLock {
+	const void* lock;
+	int depth;
+};
+constexpr int MaxHeldReadLocks = 32;
+thread_local HeldReadLock heldReadLocks[MaxHeldReadLocks];
+thread_local int heldReadLockCnt = 0;
+
+inline HeldReadLock* findHeldReadLock(const void* lock) {
+	for (int i = 0; i < heldReadLockCnt; ++i) {
+		if (heldReadLocks[i].lock == lock) {
+			return &heldReadLocks[i];
+		}
+	}
+	return nullptr;
+}
+
+inline void* currentThread() {
+	return (void*)(uintptr_t)SDL_ThreadID();
+}
+
+inline void cpuRelax(int iteration) {
+	if (iteration > 16) {
+		SDL_Delay(0);
+	}
+}
+
+}
+
+ReadWriteLock::ReadWriteLock(const core::String& name, int spinCount) :
+		_name(name), _spinCount(spinCount), _stats(LockStats::entry(name.c_str())), _mutex(SDL_CreateMutex()),
+		_cond(SDL_CreateCond()) {
+	SDL_AtomicSet(&_state, 0);
+	SDL_AtomicSet(&_waitingWriters, 0);
+	SDL_AtomicSet(&_sleepers, 0);
 }
 
 ReadWriteLock::~ReadWriteLock() {
+	core_assert_msg(SDL_AtomicGet(&_state) == 0, "Lock %s is still in use", _name.c_str());
+	LockStats::release(_stats);
+	SDL_DestroyCond(_cond);
 	SDL_DestroyMutex(_mutex);
 }
 
+bool ReadWriteLock::ownsWriteLock() const {
+	return SDL_AtomicGetPtr(const_cast<void**>(&_writerThread)) == currentThread();
+}
+
+bool ReadWriteLock::tryLockRead(bool nested) const {
+	const int state = SDL_AtomicGet(&_state);
+	if ((state & WriterBit) != 0) {
+		return false;
+	}
+	if (!nested && SDL_AtomicGet(&_waitingWriters) > 0) {
+		return false;
+	}
+	return SDL_AtomicCAS(&_state, state, state + 1) == SDL_TRUE;
+}
+
+bool ReadWriteLock::tryLockWrite() {
+	return SDL_AtomicCAS(&_state, 0, WriterBit) == SDL_TRUE;
+}
+
+void ReadWriteLock::wakeup() const {
+	if (SDL_AtomicGet(&_sleepers) > 0) {
+		SDL_LockMutex(_mutex);
+		SDL_CondBroadcast(_cond);
+		SDL_UnlockMutex(_mutex);
+	}
+}
+
 void ReadWriteLock::lockRead() const {
+	if (ownsWriteLock()) {
+		++const_cast<ReadWriteLock*>(this)->_writerRecursion;
+		return;
+	}
+	const bool nested = readLocksHeld > 0;
+	++readLocksHeld;
+	if (tryLockRead(nested)) {
+		LockStats::acquired(_stats);
+		return;
+	}
+	const uint64_t waitStart = LockStats::waitStart(_stats);
+	for (int i = 0; i < _spinCount; ++i) {
+		cpuRelax(i);
+		if (tryLockRead(nested)) {
+			LockStats::contended(_stats, waitStart);
+			return;
+		}
+	}
 	SDL_LockMutex(_mutex);
+	SDL_AtomicIncRef(&_sleepers);
+	while (!tryLockRead(nested)) {
+		SDL_CondWait(_cond, _mutex);
+	}
+	SDL_AtomicAdd(&_sleepers, -1);
+	SDL_UnlockMutex(_mutex);
+	LockStats::contended(_stats, waitStart);
 }
 
 void ReadWriteLock::unlockRead() const {
-	SDL_UnlockMutex(_mutex);
+	if (ownsWriteLock()) {
+		--const_cast<ReadWriteLock*>(this)->_writerRecursion;
+		return;
+	}
+	--readLocksHeld;
+	if (SDL_AtomicAdd(&_state, -1) == 1) {
+		// the last reader is gone - a writer might be waiting
+		wakeup();
+	}
 }
 
 void ReadWriteLock::lockWrite() {
-	SDL_LockMutex(_mutex);
+	if (ownsWriteLock()) {
+		++_writerRecursion;
+		return;
+	}
+	if (tryLockWrite()) {
+		_holdStart = LockStats::acquired(_stats);
+	} else {
+		const uint64_t waitStart = LockStats::waitStart(_stats);
+		SDL_AtomicIncRef(&_waitingWriters);
+		bool acquired = false;
+		for (int i = 0; i < _spinCount; ++i) {
+			cpuRelax(i);
+			if (tryLockWrite()) {
+				acquired = true;
+				break;
+			}
+		}
+		if (!acquired) {
+			SDL_LockMutex(_mutex);
+			SDL_AtomicIncRef(&_sleepers);
+			while (!tryLockWrite()) {
+				SDL_CondWait(_cond, _mutex);
+			}
+			SDL_AtomicAdd(&_sleepers, -1);
+			SDL_UnlockMutex(_mutex);
+		}
+		SDL_AtomicAdd(&_waitingWriters, -1);
+		_holdStart = LockStats::contended(_stats, waitStart);
+	}
+	SDL_AtomicSetPtr(&_writerThread, currentThread());
+	_writerRecursion = 1;
 }
 
 void ReadWriteLock::unlockWrite() {
-	SDL_UnlockMutex(_mutex);
+	core_assert_msg(ownsWriteLock(), "Lock %s is not owned by this thread", _name.c_str());
+	if (--_writerRecursion > 0) {
+		return;
+	}
+	LockStats::released(_stats, _holdStart);
+	_holdStart = 0u;
+	SDL_AtomicSetPtr(&_writerThread, nullptr);
+	SDL_AtomicSet(&_state, 0);
+	wakeup();
+}
+
+DistributedReadWriteLock::DistributedReadWriteLock(const core::String& name) :
+		_name(name), _stats(LockStats::entry(name.c_str())), _writerMutex(SDL_CreateMutex()) {
+	for (int i = 0; i < Slots; ++i) {
+		SDL_AtomicSet(&_slots[i].readers, 0);
+	}
+	SDL_AtomicSet(&_writer, 0);
+}
+
+DistributedReadWriteLock::~DistributedReadWriteLock() {
+	LockStats::release(_stats);
+	SDL_DestroyMutex(_writerMutex);
+}
+
+DistributedReadWriteLock::Slot& DistributedReadWriteLock::slot() const {
+	static SDL_atomic_t nextSlot;
+	// the threads are distributed over the slots in the order they first acquire a read lock
+	thread_local const int threadSlot = SDL_AtomicAdd(&nextSlot, 1) % Slots;
+	return _slots[threadSlot];
+}
+
+bool DistributedReadWriteLock::ownsWriteLock() const {
+	return SDL_AtomicGetPtr(const_cast<void**>(&_writerThread)) == currentThread();
+}
+
+void DistributedReadWriteLock::lockRead() const {
+	if (ownsWriteLock()) {
+		++const_cast<DistributedReadWriteLock*>(this)->_writerRecursion;
+		return;
+	}
+	if (HeldReadLock* held = findHeldReadLock(this)) {
+		// this thread is already counted as a reader of this lock - a writer can't get in
+		++held->depth;
+		return;
+	}
+	core_assert_msg(heldReadLockCnt < MaxHeldReadLocks, "Too many distributed read locks held by one thread");
+	if (heldReadLockCnt < MaxHeldReadLocks) {
+		heldReadLocks[heldReadLockCnt++] = HeldReadLock{this, 1};
+	}
+	Slot& s = slot();
+	uint64_t waitStart = 0u;
+	for (int i = 0;; ++i) {
+		SDL_AtomicIncRef(&s.readers);
+		// a writer sets the flag before it waits for the readers to leave - if we still see the flag cleared
+		// after our increment, the writer will see our increment
+		if (SDL_AtomicGet(&_writer) == 0) {
+			if (i == 0) {
+				LockStats::acquired(_stats);
+			} else {
+				LockStats::contended(_stats, waitStart);
+			}
+			return;
+		}
+		if (i == 0) {
+			waitStart = LockStats::waitStart(_stats);
+		}
+		SDL_AtomicAdd(&s.readers, -1);
+		while (SDL_AtomicGet(&_writer) != 0) {
+			cpuRelax(i++);
+		}
+	}
+}
+
+void DistributedReadWriteLock::unlockRead() const {
+	if (ownsWriteLock()) {
+		--const_cast<DistributedReadWriteLock*>(this)->_writerRecursion;
+		return;
+	}
+	if (HeldReadLock* held = findHeldReadLock(this)) {
+		if (--held->depth > 0) {
+			return;
+		}
+		*held = heldReadLocks[--heldReadLockCnt];
+	}
+	SDL_AtomicAdd(&slot().readers, -1);
+}
+
+void DistributedReadWriteLock::lockWrite() {
+	if (ownsWriteLock()) {
+		++_writerRecursion;
+		return;
+	}
+	const uint64_t waitStart = LockStats::waitStart(_stats);
+	bool contended = SDL_TryLockMutex(_writerMutex) != 0;
+	if (contended) {
+		SDL_LockMutex(_writerMutex);
+	}
+	SDL_AtomicSet(&_writer, 1);
+	for (int i = 0; i < Slots; ++i) {
+		for (int n = 0; SDL_AtomicGet(&_slots[i].readers) != 0; ++n) {
+			contended = true;
+			cpuRelax(n);
+		}
+	}
+	if (contended) {
+		_holdStart = LockStats::contended(_stats, waitStart);
+	} else {
+		_holdStart = LockStats::acquired(_stats);
+	}
+	SDL_AtomicSetPtr(&_writerThread, currentThread());
+	_writerRecursion = 1;
+}
+
+void DistributedReadWriteLock::unlockWrite() {
+	core_assert_msg(ownsWriteLock(), "Lock %s is not owned by this thread", _name.c_str());
+	if (--_writerRecursion > 0) {
+		return;
+	}
+	LockStats::released(_stats, _holdStart);
+	_holdStart = 0u;
+	SDL_AtomicSetPtr(&_writerThread, nullptr);
+	SDL_AtomicSet(&_writer, 0);
+	SDL_UnlockMutex(_writerMutex);
 }
 
 }
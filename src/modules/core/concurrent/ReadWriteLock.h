@@ -5,19 +5,106 @@
 #pragma once
 
 #include "core/String.h"
+#include "core/concurrent/LockStats.h"
+#include <SDL_atomic.h>
+#include <stddef.h>
 
 struct SDL_mutex;
+struct SDL_cond;
 
 namespace core {
 
+/**
+ * @brief Shared reader/writer lock that prefers writers
+ *
+ * Any amount of readers can hold the lock at the same time. As soon as a writer is waiting, new readers
+ * are blocked until the writer is done - except for threads that already hold a read lock, to allow nested
+ * read locks without deadlocking.
+ *
+ * The lock is recursive for the thread that holds the write lock - this thread may also acquire read locks.
+ * Upgrading a read lock to a write lock is not supported.
+ *
+ * Before a thread is put to sleep, it spins @c spinCount times on the lock state.
+ *
+ * The contention is accounted in @c LockStats by the name of the lock.
+ */
 class ReadWriteLock {
 private:
+	static constexpr int WriterBit = 1 << 30;
 	const core::String _name;
+	const int _spinCount;
+	/** @brief the amount of active readers or @c WriterBit */
+	mutable SDL_atomic_t _state;
+	mutable SDL_atomic_t _waitingWriters;
+	mutable SDL_atomic_t _sleepers;
+	void* _writerThread = nullptr;
+	int _writerRecursion = 0;
+	LockStats::Entry* _stats;
+	uint64_t _holdStart = 0u;
 	mutable SDL_mutex* _mutex;
+	mutable SDL_cond* _cond;
+
+	bool tryLockRead(bool nested) const;
+	bool tryLockWrite();
+	bool ownsWriteLock() const;
+	void wakeup() const;
 public:
-	ReadWriteLock(const core::String& name);
+	static constexpr int DefaultSpinCount = 64;
+
+	ReadWriteLock(const core::String& name, int spinCount = DefaultSpinCount);
 	~ReadWriteLock();
 
+	ReadWriteLock(const ReadWriteLock &) = delete;
+	ReadWriteLock &operator=(const ReadWriteLock &) = delete;
+
+	void lockRead() const;
+
+	void unlockRead() const;
+
+	void lockWrite();
+
+	void unlockWrite();
+
+	const core::String& name() const;
+};
+
+inline const core::String& ReadWriteLock::name() const {
+	return _name;
+}
+
+/**
+ * @brief Reader/writer lock for data that is read very often but only rarely modified
+ *
+ * The readers are counted in several slots that are each on their own cache line. A reader only touches the slot that
+ * is assigned to its thread - readers on different cores don't have to fight for the same cache line. Writers have to
+ * check all slots and wait until the readers are gone, so writing is much more expensive than with @c ReadWriteLock.
+ *
+ * The same recursion rules as for @c ReadWriteLock apply.
+ */
+class DistributedReadWriteLock {
+private:
+	static constexpr int Slots = 16;
+	struct alignas(64) Slot {
+		SDL_atomic_t readers;
+	};
+	const core::String _name;
+	mutable Slot _slots[Slots];
+	mutable SDL_atomic_t _writer;
+	void* _writerThread = nullptr;
+	int _writerRecursion = 0;
+	LockStats::Entry* _stats;
+	uint64_t _holdStart = 0u;
+	SDL_mutex* _writerMutex;
+
+	Slot& slot() const;
+	bool ownsWriteLock() const;
+public:
+	DistributedReadWriteLock(const core::String& name);
+	~DistributedReadWriteLock();
+
+	DistributedReadWriteLock(const DistributedReadWriteLock &) = delete;
+	DistributedReadWriteLock &operator=(const DistributedReadWriteLock &) = delete;
+
 	void lockRead() const;
 
 	void unlockRead() const;
@@ -25,13 +112,20 @@ public:
 	void lockWrite();
 
 	void unlockWrite();
+
+	const core::String& name() const;
 };
 
+inline const core::String& DistributedReadWriteLock::name() const {
+	return _name;
+}
+
+template<class LOCK = ReadWriteLock>
 class ScopedReadLock {
 private:
-	const ReadWriteLock& _lock;
+	const LOCK& _lock;
 public:
-	inline ScopedReadLock(const ReadWriteLock& lock) : _lock(lock) {
+	inline ScopedReadLock(const LOCK& lock) : _lock(lock) {
 		_lock.lockRead();
 	}
 	inline ~ScopedReadLock() {
@@ -39,11 +133,12 @@ public:
 	}
 };
 
+template<class LOCK = ReadWriteLock>
 class ScopedWriteLock {
 private:
-	ReadWriteLock& _lock;
+	LOCK& _lock;
 public:
-	inline ScopedWriteLock(ReadWriteLock& lock) : _lock(lock) {
+	inline ScopedWriteLock(LOCK& lock) : _lock(lock) {
 		_lock.lockWrite();
 	}
 	inline ~ScopedWriteLock() {
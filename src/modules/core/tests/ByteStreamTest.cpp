@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 #include "core/ByteStream.h"
+#include "core/ArrayLength.h"
 #include <random>
 #include <stdlib.h>
 #include <limits.h>
@@ -11,6 +12,7 @@
 #include <SDL_timer.h>
 #include <stdlib.h>
 #include "core/String.h"
+#include <vector>
 
 namespace {
 const uint8_t BYTE_ADD = UCHAR_MAX;
@@ -97,6 +99,12 @@ TEST(ByteStreamTest, testWriteEmptyString) {
 	ASSERT_EQ(0u, byteStream.getSize());
 }
 
+TEST(ByteStreamTest, testReadStringFromEmptyStream) {
+	ByteStream byteStream;
+	ASSERT_EQ("", byteStream.readString());
+	ASSERT_EQ(0u, byteStream.getSize());
+}
+
 TEST(ByteStreamTest, testWriteInt) {
 	ByteStream byteStream;
 	const size_t previous = byteStream.getSize();
@@ -359,4 +367,147 @@ TEST(ByteStreamTest, testRandomReadWrite) {
 	ASSERT_EQ(byteStream.getSize(), size_t(0));
 }
 
+TEST(ByteStreamTest, testPrependAfterRead) {
+	ByteStream byteStream;
+	byteStream.addByte(1);
+	byteStream.addByte(2);
+	byteStream.addByte(3);
+	ASSERT_EQ(1, byteStream.readByte());
+	byteStream.addShort(SHORT_ADD, true);
+	ASSERT_EQ(4u, byteStream.getSize());
+	EXPECT_EQ(SHORT_ADD, byteStream.readShort());
+	EXPECT_EQ(2, byteStream.readByte());
+	EXPECT_EQ(3, byteStream.readByte());
+}
+
+TEST(ByteStreamTest, testReserve) {
+	ByteStream byteStream(16);
+	EXPECT_GE(byteStream.capacity(), 16u);
+	byteStream.reserve(1024);
+	const size_t capacity = byteStream.capacity();
+	EXPECT_GE(capacity, 1024u);
+	const uint8_t *buf = byteStream.getBuffer();
+	for (int i = 0; i < 256; ++i) {
+		byteStream.addInt(i);
+	}
+	EXPECT_EQ(capacity, byteStream.capacity());
+	EXPECT_EQ(buf, byteStream.getBuffer()) << "No reallocation expected";
+}
+
+TEST(ByteStreamTest, testWriteBuffer) {
+	ByteStream byteStream;
+	byteStream.addInt(INT_ADD);
+	uint8_t *buf = byteStream.writeBuffer(64);
+	ASSERT_GE(byteStream.capacity(), 68u);
+	for (int i = 0; i < 8; ++i) {
+		buf[i] = (uint8_t)i;
+	}
+	EXPECT_EQ(4u, byteStream.getSize());
+	byteStream.commit(8);
+	ASSERT_EQ(12u, byteStream.getSize());
+	EXPECT_EQ(INT_ADD, byteStream.readInt());
+	for (int i = 0; i < 8; ++i) {
+		EXPECT_EQ(i, byteStream.readByte());
+	}
+}
+
+TEST(ByteStreamTest, testArray) {
+	const int32_t ints[] = {INT_ADD, -1, 0, 42};
+	const int16_t shorts[] = {SHORT_ADD, -2};
+	const float floats[] = {0.5f, -1.25f};
+	ByteStream byteStream;
+	byteStream.addArray(ints, lengthof(ints));
+	byteStream.addArray(shorts, lengthof(shorts));
+	byteStream.addArray(floats, lengthof(floats));
+	ASSERT_EQ(sizeof(ints) + sizeof(shorts) + sizeof(floats), byteStream.getSize());
+	// the bulk write must be compatible with the single value functions
+	EXPECT_EQ(INT_ADD, byteStream.peekInt());
+
+	int32_t readInts[lengthof(ints)];
+	int16_t readShorts[lengthof(shorts)];
+	float readFloats[lengthof(floats)];
+	ASSERT_TRUE(byteStream.readArray(readInts, lengthof(readInts)));
+	ASSERT_TRUE(byteStream.readArray(readShorts, lengthof(readShorts)));
+	ASSERT_FALSE(byteStream.readArray(readFloats, lengthof(readFloats) + 1)) << "Not enough data left";
+	ASSERT_EQ(sizeof(floats), byteStream.getSize());
+	ASSERT_TRUE(byteStream.readArray(readFloats, lengthof(readFloats)));
+	for (int i = 0; i < lengthof(ints); ++i) {
+		EXPECT_EQ(ints[i], readInts[i]);
+	}
+	for (int i = 0; i < lengthof(shorts); ++i) {
+		EXPECT_EQ(shorts[i], readShorts[i]);
+	}
+	for (int i = 0; i < lengthof(floats); ++i) {
+		EXPECT_FLOAT_EQ(floats[i], readFloats[i]);
+	}
+	EXPECT_TRUE(byteStream.empty());
+}
+
+TEST(ByteStreamTest, testView) {
+	ByteStream source;
+	source.addInt(INT_ADD);
+	source.addString("view");
+	source.addLong(234L);
+
+	ByteStream view = ByteStream::view(source.getBuffer(), source.getSize());
+	EXPECT_EQ(source.getBuffer(), view.getBuffer()) << "A view must not copy the data";
+	EXPECT_EQ(INT_ADD, view.readInt());
+	EXPECT_EQ("view", view.readString());
+	ASSERT_TRUE(view.skip(8));
+	EXPECT_TRUE(view.empty());
+	EXPECT_FALSE(view.skip(1));
+}
+
+TEST(ByteStreamTest, testViewCopyOnWrite) {
+	const uint8_t data[] = {1, 2, 3, 4};
+	ByteStream view = ByteStream::view(data, sizeof(data));
+	EXPECT_EQ(1, view.readByte());
+	view.addByte(5);
+	EXPECT_NE(data + 1, view.getBuffer());
+	ASSERT_EQ(4u, view.getSize());
+	EXPECT_EQ(2, view.readByte());
+	EXPECT_EQ(3, view.readByte());
+	EXPECT_EQ(4, view.readByte());
+	EXPECT_EQ(5, view.readByte());
+	EXPECT_EQ(4, data[3]) << "The external memory must not be modified";
+}
+
+TEST(ByteStreamTest, testRelease) {
+	ByteStream byteStream;
+	byteStream.addInt(INT_ADD);
+	byteStream.addInt(42);
+	const uint8_t *buf = byteStream.getBuffer();
+	size_t size = 0u;
+	uint8_t *released = byteStream.release(size);
+	ASSERT_EQ(8u, size);
+	EXPECT_EQ(buf, released) << "Expected to hand over the storage without a copy";
+	EXPECT_TRUE(byteStream.empty());
+	EXPECT_EQ(0u, byteStream.capacity());
+
+	ByteStream view = ByteStream::view(released, size);
+	EXPECT_EQ(INT_ADD, view.readInt());
+	uint8_t *copy = view.release(size);
+	ASSERT_EQ(4u, size);
+	EXPECT_NE(released + 4, copy) << "A view doesn't own the memory - it must be copied";
+	int32_t value;
+	core_memcpy(&value, copy, sizeof(value));
+	EXPECT_EQ(42, SDL_SwapLE32(value));
+	core_free(copy);
+	core_free(released);
+}
+
+TEST(ByteStreamTest, testMoveAndCopy) {
+	ByteStream byteStream;
+	byteStream.addInt(1);
+	byteStream.addInt(2);
+	EXPECT_EQ(1, byteStream.readInt());
+	ByteStream copy = byteStream;
+	EXPECT_EQ(4u, copy.getSize());
+	EXPECT_NE(byteStream.getBuffer(), copy.getBuffer());
+	ByteStream moved = core::move(byteStream);
+	EXPECT_EQ(0u, byteStream.getSize());
+	EXPECT_EQ(2, moved.readInt());
+	EXPECT_EQ(2, copy.readInt());
+}
+
 }
@@ -3,16 +3,17 @@
  */
 
 #include <gtest/gtest.h>
-#include "core/collection/ConcurrentQueue.h"
+#include "core/collection/ConcurrentPriorityQueue.h"
+#include "core/ArrayLength.h"
 #include <thread>
 
 namespace collection {
 
-class ConcurrentQueueTest : public testing::Test {
+class ConcurrentPriorityQueueTest : public testing::Test {
 };
 
-TEST_F(ConcurrentQueueTest, testPushPop) {
-	core::ConcurrentQueue<int> queue;
+TEST_F(ConcurrentPriorityQueueTest, testPushPop) {
+	core::ConcurrentPriorityQueue<int> queue;
 	const int n = 1000;
 	for (int i = 0; i < n; ++i) {
 		queue.push(i);
@@ -25,8 +26,8 @@ TEST_F(ConcurrentQueueTest, testPushPop) {
 	}
 }
 
-TEST_F(ConcurrentQueueTest, testPushWaitAndPop) {
-	core::ConcurrentQueue<int> queue;
+TEST_F(ConcurrentPriorityQueueTest, testPushWaitAndPop) {
+	core::ConcurrentPriorityQueue<int> queue;
 	const int n = 1000;
 	for (int i = 0; i < n; ++i) {
 		queue.push(i);
@@ -39,8 +40,8 @@ TEST_F(ConcurrentQueueTest, testPushWaitAndPop) {
 	}
 }
 
-TEST_F(ConcurrentQueueTest, testPushWaitAndPopConcurrent) {
-	core::ConcurrentQueue<int> queue;
+TEST_F(ConcurrentPriorityQueueTest, testPushWaitAndPopConcurrent) {
+	core::ConcurrentPriorityQueue<int> queue;
 	const int n = 1000;
 	std::thread thread([&] () {
 		for (int i = 0; i < n; ++i) {
@@ -54,8 +55,8 @@ TEST_F(ConcurrentQueueTest, testPushWaitAndPopConcurrent) {
 	thread.join();
 }
 
-TEST_F(ConcurrentQueueTest, testPushWaitAndPopMultipleThreads) {
-	core::ConcurrentQueue<int> queue;
+TEST_F(ConcurrentPriorityQueueTest, testPushWaitAndPopMultipleThreads) {
+	core::ConcurrentPriorityQueue<int> queue;
 	const int n = 1000;
 	std::thread threadPush([&] () {
 		for (int i = 0; i < n; ++i) {
@@ -72,8 +73,24 @@ TEST_F(ConcurrentQueueTest, testPushWaitAndPopMultipleThreads) {
 	threadPop.join();
 }
 
-TEST_F(ConcurrentQueueTest, testAbortWait) {
-	core::ConcurrentQueue<int> queue;
+TEST_F(ConcurrentPriorityQueueTest, testBatchPushPop) {
+	core::ConcurrentPriorityQueue<int> queue;
+	const int values[] = {4, 1, 3, 0, 2};
+	queue.push(values, lengthof(values));
+	ASSERT_EQ(5u, queue.size());
+	int popped[3];
+	ASSERT_EQ(3u, queue.pop(popped, lengthof(popped)));
+	EXPECT_EQ(4, popped[0]);
+	EXPECT_EQ(3, popped[1]);
+	EXPECT_EQ(2, popped[2]);
+	ASSERT_EQ(2u, queue.waitAndPop(popped, lengthof(popped)));
+	EXPECT_EQ(1, popped[0]);
+	EXPECT_EQ(0, popped[1]);
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(ConcurrentPriorityQueueTest, testAbortWait) {
+	core::ConcurrentPriorityQueue<int> queue;
 	std::thread threadWait([&] () {
 		int v;
 		ASSERT_FALSE(queue.waitAndPop(v));
@@ -83,9 +100,9 @@ TEST_F(ConcurrentQueueTest, testAbortWait) {
 	threadWait.join();
 }
 
-TEST_F(ConcurrentQueueTest, testSort) {
+TEST_F(ConcurrentPriorityQueueTest, testSort) {
 	{
-		core::ConcurrentQueue<int> queue;
+		core::ConcurrentPriorityQueue<int> queue;
 		queue.push(1);
 		queue.push(3);
 		queue.push(2);
@@ -94,7 +111,7 @@ TEST_F(ConcurrentQueueTest, testSort) {
 		EXPECT_EQ(3, val);
 	}
 	{
-		core::ConcurrentQueue<int, std::greater<int>> queue;
+		core::ConcurrentPriorityQueue<int, std::greater<int>> queue;
 		queue.push(1);
 		queue.push(3);
 		queue.push(2);
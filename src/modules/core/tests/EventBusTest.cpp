@@ -155,4 +155,34 @@ TEST_F(EventBusTest, testMultipleTopics_1) {
 	ASSERT_EQ(3, handler.getCount()) << "Unexpected handler notification amount";
 }
 
+TEST_F(EventBusTest, testSubscribeFromHandler) {
+	class SubscribingHandler: public CountHandlerTest<TestEvent> {
+	private:
+		using Super = CountHandlerTest<TestEvent>;
+		EventBus& _eventBus;
+		HandlerTest& _other;
+	public:
+		SubscribingHandler(EventBus& eventBus, HandlerTest& other) : _eventBus(eventBus), _other(other) {}
+
+		void onEvent(const TestEvent& e) override {
+			Super::onEvent(e);
+			_eventBus.subscribe(_other);
+			_eventBus.unsubscribe(*this);
+		}
+	};
+	EventBus eventBus;
+	HandlerTest other;
+	SubscribingHandler handler(eventBus, other);
+	TestEvent event;
+
+	eventBus.subscribe(handler);
+	ASSERT_EQ(1, eventBus.publish(event)) << "Expected only the subscribing handler to be notified";
+	ASSERT_EQ(1, handler.getCount());
+	ASSERT_EQ(0, other.getCount()) << "Expected the new subscription to only affect the next event";
+
+	ASSERT_EQ(1, eventBus.publish(event)) << "Expected the handler to be replaced by the new subscription";
+	ASSERT_EQ(1, handler.getCount());
+	ASSERT_EQ(1, other.getCount());
+}
+
 }
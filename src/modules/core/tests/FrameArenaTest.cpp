@@ -0,0 +1,132 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/FrameArena.h"
+#include "core/collection/DynamicArray.h"
+#include <vector>
+#include <unordered_set>
+
+namespace core {
+
+class FrameArenaTest : public testing::Test {
+};
+
+TEST_F(FrameArenaTest, testAllocateAligned) {
+	FrameArena arena(1024u);
+	void* a = arena.allocate(3u);
+	void* b = arena.allocate(8u, 64u);
+	ASSERT_NE(nullptr, a);
+	ASSERT_NE(nullptr, b);
+	EXPECT_EQ(0u, (uintptr_t)a % FrameArena::Alignment);
+	EXPECT_EQ(0u, (uintptr_t)b % 64u);
+	EXPECT_TRUE(arena.owns(a));
+	EXPECT_TRUE(arena.owns(b));
+	EXPECT_EQ(2u, arena.stats().allocations);
+}
+
+TEST_F(FrameArenaTest, testReleaseLast) {
+	FrameArena arena(1024u);
+	void* a = arena.allocate(32u);
+	const size_t used = arena.stats().bytesInUse;
+	void* b = arena.allocate(32u);
+	arena.release(b, 32u);
+	EXPECT_EQ(used, arena.stats().bytesInUse);
+	// not the last allocation anymore - nothing happens
+	void* c = arena.allocate(32u);
+	EXPECT_EQ(b, c);
+	arena.release(a, 32u);
+	EXPECT_EQ(used + 32u, arena.stats().bytesInUse);
+}
+
+TEST_F(FrameArenaTest, testResetMergesBlocks) {
+	FrameArena arena(256u);
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_NE(nullptr, arena.allocate(200u));
+	}
+	EXPECT_EQ(10u, arena.stats().blockAllocations);
+	const size_t frameBytes = arena.stats().bytesInUse;
+	arena.reset();
+	EXPECT_EQ(0u, arena.stats().bytesInUse);
+	EXPECT_EQ(frameBytes, arena.stats().lastFrameBytes);
+	EXPECT_EQ(frameBytes, arena.stats().highWaterMark);
+	EXPECT_EQ(10u, arena.stats().lastFrameAllocations);
+	EXPECT_EQ(1u, arena.stats().resets);
+	// the second frame fits into the merged block
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_NE(nullptr, arena.allocate(200u));
+	}
+	EXPECT_EQ(10u, arena.stats().blockAllocations);
+	arena.reset();
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_NE(nullptr, arena.allocate(200u));
+	}
+	EXPECT_EQ(10u, arena.stats().blockAllocations);
+}
+
+TEST_F(FrameArenaTest, testScope) {
+	FrameArena arena(256u);
+	void* a = arena.allocate(16u);
+	const size_t used = arena.stats().bytesInUse;
+	{
+		FrameArenaScope scope(arena);
+		for (int i = 0; i < 10; ++i) {
+			ASSERT_NE(nullptr, arena.allocate(100u));
+		}
+	}
+	EXPECT_EQ(used, arena.stats().bytesInUse);
+	EXPECT_GT(arena.stats().highWaterMark, used);
+	// the chained blocks are reused
+	const uint64_t blocks = arena.stats().blockAllocations;
+	{
+		FrameArenaScope scope(arena);
+		for (int i = 0; i < 10; ++i) {
+			ASSERT_NE(nullptr, arena.allocate(100u));
+		}
+	}
+	EXPECT_EQ(blocks, arena.stats().blockAllocations);
+	EXPECT_TRUE(arena.owns(a));
+}
+
+#ifdef DEBUG
+TEST_F(FrameArenaTest, testPoison) {
+	FrameArena arena(256u);
+	uint8_t* a = (uint8_t*)arena.allocate(16u);
+	a[0] = 1u;
+	arena.reset();
+	EXPECT_EQ(FrameArena::PoisonByte, a[0]);
+}
+#endif
+
+TEST_F(FrameArenaTest, testStlAllocator) {
+	FrameArena arena(1024u);
+	{
+		std::vector<int, FrameAllocator<int>> v {FrameAllocator<int>(arena)};
+		for (int i = 0; i < 1000; ++i) {
+			v.push_back(i);
+		}
+		EXPECT_EQ(999, v.back());
+		EXPECT_TRUE(arena.owns(v.data()));
+
+		std::unordered_set<int, std::hash<int>, std::equal_to<int>, FrameAllocator<int>> set(16u, std::hash<int>(), std::equal_to<int>(), FrameAllocator<int>(arena));
+		set.insert(v.begin(), v.end());
+		EXPECT_EQ(1000u, set.size());
+	}
+	EXPECT_GT(arena.stats().allocations, 0u);
+	arena.reset();
+}
+
+TEST_F(FrameArenaTest, testDynamicArray) {
+	FrameArenaScope scope;
+	const uint64_t allocations = frameArena().stats().allocations;
+	DynamicArray<int, 32u, FrameArenaAllocator> array;
+	for (int i = 0; i < 100; ++i) {
+		array.push_back(i);
+	}
+	EXPECT_EQ(99, array.back());
+	EXPECT_TRUE(frameArena().owns(array.data()));
+	EXPECT_GT(frameArena().stats().allocations, allocations);
+}
+
+}
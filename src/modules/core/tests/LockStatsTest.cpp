@@ -0,0 +1,137 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/concurrent/LockStats.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/ReadWriteLock.h"
+#include "core/Trace.h"
+#include <SDL_timer.h>
+#include <future>
+
+namespace core {
+
+class LockStatsTest: public testing::Test {
+protected:
+	uint32_t _sampleRate = 0u;
+
+	void SetUp() override {
+		_sampleRate = LockStats::sampleRate();
+		// account every acquisition to get exact numbers
+		LockStats::setSampleRate(1u);
+		LockStats::reset();
+	}
+
+	void TearDown() override {
+		LockStats::setSampleRate(_sampleRate);
+	}
+};
+
+TEST_F(LockStatsTest, testUncontended) {
+	core_trace_mutex(core::Lock, lock, "lockstatstest-uncontended");
+	for (int i = 0; i < 10; ++i) {
+		core::ScopedLock scoped(lock);
+	}
+	LockStats::Stats stats;
+	ASSERT_TRUE(LockStats::stats("lockstatstest-uncontended", stats));
+	EXPECT_EQ(1, stats.locks);
+	EXPECT_EQ(10u, stats.acquisitions);
+	EXPECT_EQ(0u, stats.contended);
+	EXPECT_EQ(0u, stats.waitMicros);
+}
+
+TEST_F(LockStatsTest, testContended) {
+	core_trace_mutex(core::Lock, lock, "lockstatstest-contended");
+	std::future<void> future;
+	{
+		core::ScopedLock scoped(lock);
+		future = std::async(std::launch::async, [&] {
+			core::ScopedLock scopedThread(lock);
+		});
+		SDL_Delay(50);
+	}
+	future.wait();
+	LockStats::Stats stats;
+	ASSERT_TRUE(LockStats::stats("lockstatstest-contended", stats));
+	EXPECT_EQ(2u, stats.acquisitions);
+	EXPECT_EQ(1u, stats.contended);
+	EXPECT_GE(stats.maxWaitMicros, 10000u) << "The thread should have waited for ~50ms";
+	EXPECT_GE(stats.waitMicros, stats.maxWaitMicros);
+	EXPECT_GE(stats.maxHoldMicros, 10000u);
+	uint64_t histogram = 0u;
+	for (int i = 0; i < LockStats::WaitBuckets; ++i) {
+		histogram += stats.waitHistogram[i];
+	}
+	EXPECT_EQ(1u, histogram);
+	// 50ms are in the bucket [2^15, 2^16) microseconds
+	EXPECT_EQ(0u, stats.waitHistogram[0]);
+}
+
+TEST_F(LockStatsTest, testRecursiveHold) {
+	core_trace_mutex(core::Lock, lock, "lockstatstest-recursive");
+	{
+		core::ScopedLock scoped(lock);
+		SDL_Delay(20);
+		{
+			core::ScopedLock nested(lock);
+		}
+		SDL_Delay(20);
+	}
+	LockStats::Stats stats;
+	ASSERT_TRUE(LockStats::stats("lockstatstest-recursive", stats));
+	EXPECT_GE(stats.maxHoldMicros, 30000u) << "The hold time must be measured from the outermost lock";
+}
+
+TEST_F(LockStatsTest, testReadWriteLockContended) {
+	core::ReadWriteLock lock("lockstatstest-rwlock");
+	std::future<void> future;
+	{
+		core::ScopedWriteLock scoped(lock);
+		future = std::async(std::launch::async, [&] {
+			core::ScopedReadLock scopedThread(lock);
+		});
+		SDL_Delay(50);
+	}
+	future.wait();
+	{
+		core::ScopedReadLock scoped(lock);
+	}
+	LockStats::Stats stats;
+	ASSERT_TRUE(LockStats::stats("lockstatstest-rwlock", stats));
+	EXPECT_EQ(3u, stats.acquisitions);
+	EXPECT_EQ(1u, stats.contended);
+	EXPECT_GE(stats.maxWaitMicros, 10000u);
+	EXPECT_GE(stats.maxHoldMicros, 10000u);
+}
+
+TEST_F(LockStatsTest, testSharedName) {
+	core::ReadWriteLock lock1("lockstatstest-shared");
+	core::ReadWriteLock lock2("lockstatstest-shared");
+	LockStats::Stats stats;
+	ASSERT_TRUE(LockStats::stats("lockstatstest-shared", stats));
+	EXPECT_EQ(2, stats.locks);
+}
+
+TEST_F(LockStatsTest, testSampling) {
+	LockStats::setSampleRate(4u);
+	core::ReadWriteLock lock("lockstatstest-sampling");
+	for (int i = 0; i < 100; ++i) {
+		core::ScopedWriteLock scoped(lock);
+	}
+	LockStats::Stats stats;
+	ASSERT_TRUE(LockStats::stats("lockstatstest-sampling", stats));
+	// the thread local sample counter might not start at 0
+	EXPECT_GE(stats.acquisitions, 96u);
+	EXPECT_LE(stats.acquisitions, 100u);
+
+	LockStats::setSampleRate(0u);
+	LockStats::reset();
+	for (int i = 0; i < 100; ++i) {
+		core::ScopedWriteLock scoped(lock);
+	}
+	ASSERT_TRUE(LockStats::stats("lockstatstest-sampling", stats));
+	EXPECT_EQ(0u, stats.acquisitions);
+}
+
+}
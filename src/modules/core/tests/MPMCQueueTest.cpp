@@ -0,0 +1,110 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/collection/MPMCQueue.h"
+#include "core/ArrayLength.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace collection {
+
+class MPMCQueueTest : public testing::Test {
+};
+
+TEST_F(MPMCQueueTest, testPushPopFifo) {
+	core::MPMCQueue<int> queue(8);
+	EXPECT_EQ(8u, queue.capacity());
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_TRUE(queue.tryPush(i));
+	}
+	ASSERT_FALSE(queue.tryPush(8)) << "The queue should be full";
+	ASSERT_EQ(8u, queue.size());
+	for (int i = 0; i < 8; ++i) {
+		int v;
+		ASSERT_TRUE(queue.pop(v));
+		ASSERT_EQ(i, v);
+	}
+	int v;
+	ASSERT_FALSE(queue.pop(v));
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MPMCQueueTest, testBatch) {
+	core::MPMCQueue<int> queue(4);
+	const int values[] = {0, 1, 2, 3, 4, 5};
+	ASSERT_EQ(4u, queue.tryPush(values, lengthof(values)));
+	int popped[8];
+	ASSERT_EQ(4u, queue.pop(popped, lengthof(popped)));
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_EQ(i, popped[i]);
+	}
+}
+
+TEST_F(MPMCQueueTest, testClear) {
+	core::MPMCQueue<int> queue(4);
+	queue.push(1);
+	queue.push(2);
+	queue.clear();
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MPMCQueueTest, testMultipleProducersConsumers) {
+	core::MPMCQueue<int> queue(64);
+	const int producers = 4;
+	const int consumers = 4;
+	const int perProducer = 50000;
+	std::atomic<int64_t> sum { 0 };
+	std::atomic<int> count { 0 };
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p) {
+		threads.emplace_back([&, p] () {
+			for (int i = 0; i < perProducer; ++i) {
+				queue.push(p * perProducer + i);
+			}
+		});
+	}
+	for (int c = 0; c < consumers; ++c) {
+		threads.emplace_back([&] () {
+			int values[16];
+			for (;;) {
+				const size_t amount = queue.waitAndPop(values, lengthof(values));
+				if (amount == 0u) {
+					break;
+				}
+				for (size_t i = 0u; i < amount; ++i) {
+					sum += values[i];
+				}
+				count += (int)amount;
+			}
+		});
+	}
+	for (int p = 0; p < producers; ++p) {
+		threads[p].join();
+	}
+	while (count < producers * perProducer) {
+		std::this_thread::yield();
+	}
+	queue.abortWait();
+	for (int c = 0; c < consumers; ++c) {
+		threads[producers + c].join();
+	}
+	const int64_t n = producers * perProducer;
+	EXPECT_EQ(n, count);
+	EXPECT_EQ(n * (n - 1) / 2, sum);
+}
+
+TEST_F(MPMCQueueTest, testAbortWait) {
+	core::MPMCQueue<int> queue(2);
+	std::thread threadWait([&] () {
+		int v;
+		ASSERT_FALSE(queue.waitAndPop(v));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	queue.abortWait();
+	threadWait.join();
+}
+
+}
@@ -0,0 +1,104 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/collection/MPSCQueue.h"
+#include "core/ArrayLength.h"
+#include <thread>
+#include <vector>
+
+namespace collection {
+
+class MPSCQueueTest : public testing::Test {
+protected:
+	struct Node : public core::MPSCQueueNode {
+		int producer = 0;
+		int value = 0;
+	};
+};
+
+TEST_F(MPSCQueueTest, testPushPopFifo) {
+	core::MPSCQueue<Node> queue;
+	Node nodes[4];
+	for (int i = 0; i < lengthof(nodes); ++i) {
+		nodes[i].value = i;
+		queue.push(&nodes[i]);
+	}
+	ASSERT_EQ(4u, queue.size());
+	for (int i = 0; i < lengthof(nodes); ++i) {
+		Node* node = queue.pop();
+		ASSERT_EQ(&nodes[i], node);
+	}
+	EXPECT_EQ(nullptr, queue.pop());
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MPSCQueueTest, testReuseNodes) {
+	core::MPSCQueue<Node> queue;
+	Node node;
+	for (int i = 0; i < 10; ++i) {
+		queue.push(&node);
+		ASSERT_EQ(&node, queue.pop());
+		ASSERT_EQ(nullptr, queue.pop());
+	}
+}
+
+TEST_F(MPSCQueueTest, testBatch) {
+	core::MPSCQueue<Node> queue;
+	Node nodes[5];
+	Node* ptrs[5];
+	for (int i = 0; i < lengthof(nodes); ++i) {
+		nodes[i].value = i;
+		ptrs[i] = &nodes[i];
+	}
+	queue.push(ptrs, 3);
+	queue.push(ptrs + 3, 2);
+	ASSERT_EQ(5u, queue.size());
+	Node* popped[8];
+	ASSERT_EQ(5u, queue.pop(popped, lengthof(popped)));
+	for (int i = 0; i < lengthof(nodes); ++i) {
+		EXPECT_EQ(i, popped[i]->value);
+	}
+}
+
+TEST_F(MPSCQueueTest, testMultipleProducers) {
+	core::MPSCQueue<Node> queue;
+	const int producers = 4;
+	const int perProducer = 20000;
+	std::vector<Node> nodes(producers * perProducer);
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p) {
+		threads.emplace_back([&, p] () {
+			for (int i = 0; i < perProducer; ++i) {
+				Node& node = nodes[p * perProducer + i];
+				node.producer = p;
+				node.value = i;
+				queue.push(&node);
+			}
+		});
+	}
+	int expected[producers] {};
+	for (int i = 0; i < producers * perProducer; ++i) {
+		Node* node = queue.waitAndPop();
+		ASSERT_NE(nullptr, node);
+		// the order of each producer is kept
+		ASSERT_EQ(expected[node->producer]++, node->value);
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MPSCQueueTest, testAbortWait) {
+	core::MPSCQueue<Node> queue;
+	std::thread threadWait([&] () {
+		ASSERT_EQ(nullptr, queue.waitAndPop());
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	queue.abortWait();
+	threadWait.join();
+}
+
+}
@@ -5,6 +5,8 @@
 #include <gtest/gtest.h>
 #include "core/concurrent/ReadWriteLock.h"
 #include <future>
+#include <thread>
+#include <SDL_timer.h>
 
 namespace core {
 
@@ -77,4 +79,130 @@ TEST_F(ReadWriteLockTest, testMoreWritersThanReaders) {
 	EXPECT_EQ(n1, limit);
 }
 
+TEST_F(ReadWriteLockTest, testWriterRecursion) {
+	std::future<int> futureRead;
+	{
+		core::ScopedWriteLock scoped(_rwLock);
+		{
+			core::ScopedWriteLock nested(_rwLock);
+			core::ScopedReadLock nestedRead(_rwLock);
+			++_value;
+		}
+		futureRead = std::async(std::launch::async, [&] {return read(1);});
+		EXPECT_EQ(std::future_status::timeout, futureRead.wait_for(std::chrono::milliseconds(20)))
+			<< "Reader must block while the write lock is held";
+	}
+	EXPECT_EQ(1, futureRead.get());
+}
+
+TEST_F(ReadWriteLockTest, testSharedReaders) {
+	core::ScopedReadLock scoped(_rwLock);
+	auto futureRead = std::async(std::launch::async, [&] {return read(10);});
+	ASSERT_EQ(std::future_status::ready, futureRead.wait_for(std::chrono::seconds(10)))
+		<< "Readers must not block each other";
+	EXPECT_EQ(10, futureRead.get());
+}
+
+TEST_F(ReadWriteLockTest, testNestedReadWithWaitingWriter) {
+	std::future<void> futureWrite;
+	{
+		core::ScopedReadLock scoped(_rwLock);
+		futureWrite = std::async(std::launch::async, [=] {write(1);});
+		// give the writer the chance to queue up
+		SDL_Delay(20);
+		EXPECT_EQ(1, read(1)) << "A nested read lock must not wait for the pending writer";
+		EXPECT_EQ(std::future_status::timeout, futureWrite.wait_for(std::chrono::milliseconds(0)));
+	}
+	futureWrite.wait();
+	EXPECT_EQ(1, _value);
+}
+
+class DistributedReadWriteLockTest: public testing::Test {
+protected:
+	core::DistributedReadWriteLock _rwLock {"test"};
+	int _value = 0;
+	const int limit { 100000 };
+
+	int read(int loopLimit) {
+		int n = 0;
+		for (int i = 0; i < loopLimit; ++i) {
+			core::ScopedReadLock scoped(_rwLock);
+			if (_value >= 0) {
+				++n;
+			}
+		}
+		return n;
+	}
+
+	void write(int limit) {
+		for (int i = 0; i < limit; ++i) {
+			core::ScopedWriteLock scoped(_rwLock);
+			++_value;
+		}
+	}
+};
+
+TEST_F(DistributedReadWriteLockTest, testMoreReadersThanWriters) {
+	int n1 = 0, n2 = 0, n3 = 0;
+	auto futureRead1 = std::async(std::launch::async, [&] {n1 += read(limit);});
+	auto futureRead2 = std::async(std::launch::async, [&] {n2 += read(limit);});
+	auto futureRead3 = std::async(std::launch::async, [&] {n3 += read(limit);});
+	auto futureWrite1 = std::async(std::launch::async, [=] {write(limit / 10);});
+	auto futureWrite2 = std::async(std::launch::async, [=] {write(limit / 10);});
+	futureRead1.wait();
+	futureRead2.wait();
+	futureRead3.wait();
+	futureWrite1.wait();
+	futureWrite2.wait();
+	EXPECT_EQ(_value, limit / 10 * 2);
+	EXPECT_EQ(n1, limit);
+	EXPECT_EQ(n2, limit);
+	EXPECT_EQ(n3, limit);
+}
+
+TEST_F(DistributedReadWriteLockTest, testNestedReadWithWaitingWriter) {
+	std::future<void> futureWrite;
+	{
+		core::ScopedReadLock scoped(_rwLock);
+		futureWrite = std::async(std::launch::async, [=] {write(1);});
+		// give the writer the chance to queue up
+		SDL_Delay(20);
+		EXPECT_EQ(1, read(1)) << "A nested read lock must not wait for the pending writer";
+		EXPECT_EQ(std::future_status::timeout, futureWrite.wait_for(std::chrono::milliseconds(0)));
+	}
+	futureWrite.wait();
+	EXPECT_EQ(1, _value);
+}
+
+TEST_F(DistributedReadWriteLockTest, testReadLockOnOtherLockDoesNotBypassWriter) {
+	core::DistributedReadWriteLock other {"other"};
+	std::promise<void> writerLocked;
+	std::promise<void> releaseWriter;
+	auto futureWrite = std::async(std::launch::async, [&] {
+		core::ScopedWriteLock scoped(_rwLock);
+		writerLocked.set_value();
+		releaseWriter.get_future().wait();
+		++_value;
+	});
+	writerLocked.get_future().wait();
+	// a read lock on a different lock must not let this thread in while the writer owns the lock
+	auto futureRead = std::async(std::launch::async, [&] {
+		core::ScopedReadLock nestedOther(other);
+		return read(1);
+	});
+	EXPECT_EQ(std::future_status::timeout, futureRead.wait_for(std::chrono::milliseconds(50)));
+	releaseWriter.set_value();
+	futureWrite.wait();
+	EXPECT_EQ(1, futureRead.get());
+	EXPECT_EQ(1, _value);
+}
+
+TEST_F(DistributedReadWriteLockTest, testWriterRecursion) {
+	core::ScopedWriteLock scoped(_rwLock);
+	core::ScopedWriteLock nested(_rwLock);
+	core::ScopedReadLock nestedRead(_rwLock);
+	++_value;
+	EXPECT_EQ(1, _value);
+}
+
 }
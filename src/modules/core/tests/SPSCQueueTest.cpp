@@ -0,0 +1,134 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/collection/SPSCQueue.h"
+#include "core/ArrayLength.h"
+#include <memory>
+#include <thread>
+
+namespace collection {
+
+class SPSCQueueTest : public testing::Test {
+};
+
+TEST_F(SPSCQueueTest, testCapacity) {
+	core::SPSCQueue<int> queue(100);
+	EXPECT_EQ(128u, queue.capacity());
+}
+
+TEST_F(SPSCQueueTest, testPushPopFifo) {
+	core::SPSCQueue<int> queue(8);
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_TRUE(queue.tryPush(i));
+	}
+	ASSERT_FALSE(queue.tryPush(8)) << "The queue should be full";
+	ASSERT_EQ(8u, queue.size());
+	for (int i = 0; i < 8; ++i) {
+		int v;
+		ASSERT_TRUE(queue.pop(v));
+		ASSERT_EQ(i, v);
+	}
+	int v;
+	ASSERT_FALSE(queue.pop(v));
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(SPSCQueueTest, testBatch) {
+	core::SPSCQueue<int> queue(4);
+	const int values[] = {0, 1, 2, 3, 4, 5};
+	ASSERT_EQ(4u, queue.tryPush(values, lengthof(values)));
+	int popped[3];
+	ASSERT_EQ(3u, queue.pop(popped, lengthof(popped)));
+	EXPECT_EQ(0, popped[0]);
+	EXPECT_EQ(2, popped[2]);
+	ASSERT_EQ(2u, queue.tryPush(values + 4, 2));
+	ASSERT_EQ(3u, queue.pop(popped, lengthof(popped)));
+	EXPECT_EQ(3, popped[0]);
+	EXPECT_EQ(4, popped[1]);
+	EXPECT_EQ(5, popped[2]);
+}
+
+TEST_F(SPSCQueueTest, testMoveOnly) {
+	core::SPSCQueue<std::unique_ptr<int>> queue(2);
+	ASSERT_TRUE(queue.push(std::unique_ptr<int>(new int(42))));
+	std::unique_ptr<int> v;
+	ASSERT_TRUE(queue.pop(v));
+	ASSERT_NE(nullptr, v.get());
+	EXPECT_EQ(42, *v);
+}
+
+TEST_F(SPSCQueueTest, testClear) {
+	core::SPSCQueue<int> queue(4);
+	queue.push(1);
+	queue.push(2);
+	queue.clear();
+	EXPECT_TRUE(queue.empty());
+	ASSERT_TRUE(queue.push(3));
+	int v;
+	ASSERT_TRUE(queue.pop(v));
+	EXPECT_EQ(3, v);
+}
+
+TEST_F(SPSCQueueTest, testPushWaitAndPopConcurrent) {
+	core::SPSCQueue<int> queue(16);
+	const int n = 100000;
+	std::thread thread([&] () {
+		for (int i = 0; i < n; ++i) {
+			queue.push(i);
+		}
+	});
+	for (int i = 0; i < n; ++i) {
+		int v;
+		ASSERT_TRUE(queue.waitAndPop(v));
+		ASSERT_EQ(i, v);
+	}
+	thread.join();
+}
+
+TEST_F(SPSCQueueTest, testBatchConcurrent) {
+	core::SPSCQueue<int> queue(16);
+	const int n = 100000;
+	std::thread thread([&] () {
+		int values[10];
+		for (int i = 0; i < n; i += lengthof(values)) {
+			for (int j = 0; j < lengthof(values); ++j) {
+				values[j] = i + j;
+			}
+			queue.push(values, lengthof(values));
+		}
+	});
+	int expected = 0;
+	while (expected < n) {
+		int popped[7];
+		const size_t amount = queue.waitAndPop(popped, lengthof(popped));
+		ASSERT_GT(amount, 0u);
+		for (size_t i = 0u; i < amount; ++i) {
+			ASSERT_EQ(expected++, popped[i]);
+		}
+	}
+	thread.join();
+}
+
+TEST_F(SPSCQueueTest, testAbortWait) {
+	core::SPSCQueue<int> queue(2);
+	std::thread threadWait([&] () {
+		int v;
+		ASSERT_FALSE(queue.waitAndPop(v));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	queue.abortWait();
+	threadWait.join();
+	queue.reset();
+	ASSERT_TRUE(queue.push(1));
+	ASSERT_TRUE(queue.push(2));
+	std::thread threadPush([&] () {
+		ASSERT_FALSE(queue.push(3));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	queue.abortWait();
+	threadPush.join();
+}
+
+}
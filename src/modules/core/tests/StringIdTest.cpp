@@ -0,0 +1,97 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/StringId.h"
+#include "core/StringUtil.h"
+#include <future>
+#include <vector>
+
+namespace core {
+
+TEST(StringIdTest, testIntern) {
+	const StringId a("stringidtest-a");
+	const StringId b("stringidtest-b");
+	EXPECT_TRUE(a.valid());
+	EXPECT_TRUE(b.valid());
+	EXPECT_NE(a, b);
+	EXPECT_EQ(a, StringId(core::String("stringidtest-a")));
+	EXPECT_EQ(a.hash(), StringId("stringidtest-a").hash());
+	EXPECT_EQ("stringidtest-a", a.str());
+	EXPECT_STREQ("stringidtest-b", b.c_str());
+}
+
+TEST(StringIdTest, testCaseSensitive) {
+	EXPECT_NE(StringId("stringidtest-case"), StringId("STRINGIDTEST-CASE"));
+}
+
+TEST(StringIdTest, testFind) {
+	EXPECT_FALSE(StringId::find("stringidtest-find").valid());
+	const size_t size = StringId::size();
+	EXPECT_FALSE(StringId::find("stringidtest-find").valid());
+	EXPECT_EQ(size, StringId::size()) << "find() must not intern the string";
+	const StringId id("stringidtest-find");
+	EXPECT_EQ(size + 1u, StringId::size());
+	EXPECT_EQ(id, StringId::find("stringidtest-find"));
+}
+
+TEST(StringIdTest, testInvalid) {
+	const StringId invalid;
+	EXPECT_FALSE(invalid.valid());
+	EXPECT_EQ("", invalid.str());
+	const StringId empty("");
+	EXPECT_TRUE(empty.valid()) << "The empty string is a valid string";
+	EXPECT_NE(invalid, empty);
+}
+
+TEST(StringIdTest, testGrow) {
+	std::vector<StringId> ids;
+	for (int i = 0; i < 5000; ++i) {
+		ids.push_back(StringId(core::string::format("stringidtest-grow-%i", i)));
+	}
+	for (int i = 0; i < 5000; ++i) {
+		const core::String& str = core::string::format("stringidtest-grow-%i", i);
+		ASSERT_EQ(ids[i], StringId::find(str)) << str.c_str();
+		ASSERT_EQ(str, ids[i].str());
+	}
+}
+
+TEST(StringIdTest, testConcurrentIntern) {
+	const int threads = 4;
+	const int strings = 1000;
+	std::vector<std::future<std::vector<StringId>>> futures;
+	for (int t = 0; t < threads; ++t) {
+		futures.emplace_back(std::async(std::launch::async, [=] () {
+			std::vector<StringId> ids;
+			for (int i = 0; i < strings; ++i) {
+				ids.push_back(StringId(core::string::format("stringidtest-concurrent-%i", i)));
+			}
+			return ids;
+		}));
+	}
+	const std::vector<StringId>& expected = futures[0].get();
+	for (int t = 1; t < threads; ++t) {
+		const std::vector<StringId>& ids = futures[t].get();
+		ASSERT_EQ(expected.size(), ids.size());
+		for (int i = 0; i < strings; ++i) {
+			EXPECT_EQ(expected[i], ids[i]) << "All threads must get the same id for string " << i;
+		}
+	}
+}
+
+TEST(StringIdTest, testMap) {
+	StringIdMap<int> map;
+	const StringId a("stringidtest-map-a");
+	const StringId b("stringidtest-map-b");
+	map.put(a, 1);
+	map.put(b, 2);
+	int value = 0;
+	ASSERT_TRUE(map.get(a, value));
+	EXPECT_EQ(1, value);
+	ASSERT_TRUE(map.get(StringId("stringidtest-map-b"), value));
+	EXPECT_EQ(2, value);
+	EXPECT_FALSE(map.hasKey(StringId("stringidtest-map-c")));
+}
+
+}
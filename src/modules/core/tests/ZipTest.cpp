@@ -4,10 +4,27 @@
 
 #include <gtest/gtest.h>
 #include "core/Zip.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
 
 namespace core {
 
 class ZipTest: public testing::Test {
+protected:
+	/**
+	 * @brief Somewhat compressible data that looks like a run length encoded voxel chunk
+	 */
+	void fill(core::Buffer<uint8_t>& buf, size_t size, uint32_t seed) {
+		buf.resize(size);
+		uint32_t rnd = seed;
+		for (size_t i = 0u; i < size;) {
+			rnd = rnd * 1664525u + 1013904223u;
+			const size_t run = core_min((size_t)(rnd >> 28) + 1u, size - i);
+			for (size_t n = 0u; n < run; ++n) {
+				buf[i++] = (uint8_t)((rnd >> 16) & 7u);
+			}
+		}
+	}
 };
 
 TEST_F(ZipTest, testCompress) {
@@ -44,4 +61,98 @@ TEST_F(ZipTest, testUncompress) {
 	}
 }
 
+TEST_F(ZipTest, testCompressorReuse) {
+	core::Buffer<uint8_t> input;
+	fill(input, 65536, 1u);
+	zip::Compressor& compressor = zip::compressor();
+	zip::Decompressor& decompressor = zip::decompressor();
+	for (int level : {zip::NoCompression, zip::BestSpeed, zip::DefaultCompression, zip::BestCompression}) {
+		core::Buffer<uint8_t> compressed;
+		ASSERT_TRUE(compressor.compress(input.data(), input.size(), compressed, level)) << "level " << level;
+		core::Buffer<uint8_t> output;
+		ASSERT_TRUE(decompressor.uncompress(compressed.data(), compressed.size(), output)) << "level " << level;
+		ASSERT_EQ(input.size(), output.size());
+		EXPECT_EQ(0, core_memcmp(input.data(), output.data(), input.size())) << "level " << level;
+	}
+}
+
+TEST_F(ZipTest, testCompatibleWithOneShot) {
+	core::Buffer<uint8_t> input;
+	fill(input, 4096, 2u);
+	core::Buffer<uint8_t> compressed;
+	ASSERT_TRUE(zip::compressor().compress(input.data(), input.size(), compressed));
+	uint8_t output[4096];
+	size_t finalSize = 0u;
+	ASSERT_TRUE(zip::uncompress(compressed.data(), compressed.size(), output, sizeof(output), &finalSize));
+	EXPECT_EQ(input.size(), finalSize);
+	EXPECT_EQ(0, core_memcmp(input.data(), output, sizeof(output)));
+}
+
+TEST_F(ZipTest, testStreaming) {
+	core::Buffer<uint8_t> input;
+	fill(input, 100000, 3u);
+	core::Buffer<uint8_t> compressed;
+	compressed.push_back(42);
+	zip::Compressor& compressor = zip::compressor();
+	ASSERT_TRUE(compressor.begin(compressed, zip::BestSpeed));
+	for (size_t i = 0u; i < input.size(); i += 1000u) {
+		ASSERT_TRUE(compressor.write(input.data() + i, core_min((size_t)1000u, input.size() - i)));
+	}
+	size_t compressedSize = 0u;
+	ASSERT_TRUE(compressor.finish(&compressedSize));
+	EXPECT_EQ(compressed.size() - 1u, compressedSize);
+	EXPECT_EQ(42, compressed[0]) << "The compressed data must be appended";
+
+	core::Buffer<uint8_t> output;
+	ASSERT_TRUE(zip::decompressor().uncompress(compressed.data() + 1, compressedSize, output));
+	ASSERT_EQ(input.size(), output.size());
+	EXPECT_EQ(0, core_memcmp(input.data(), output.data(), input.size()));
+}
+
+TEST_F(ZipTest, testDictionary) {
+	// random bytes that can't be compressed on their own
+	core::Buffer<uint8_t> dict;
+	dict.resize(4096);
+	uint32_t rnd = 4u;
+	for (size_t i = 0u; i < dict.size(); ++i) {
+		rnd = rnd * 1664525u + 1013904223u;
+		dict[i] = (uint8_t)(rnd >> 24);
+	}
+	// a small payload that shares a lot with the dictionary
+	core::Buffer<uint8_t> input;
+	input.append(dict.data() + 1000, 200);
+	input.append(dict.data() + 3000, 200);
+	zip::Dictionary dictionary;
+	dictionary.data = dict.data();
+	dictionary.size = dict.size();
+
+	core::Buffer<uint8_t> withoutDict;
+	core::Buffer<uint8_t> withDict;
+	zip::Compressor& compressor = zip::compressor();
+	ASSERT_TRUE(compressor.compress(input.data(), input.size(), withoutDict));
+	ASSERT_TRUE(compressor.compress(input.data(), input.size(), withDict, zip::DefaultCompression, &dictionary));
+	EXPECT_LT(withDict.size() * 4u, withoutDict.size()) << "The dictionary should improve the compression of small payloads";
+
+	core::Buffer<uint8_t> output;
+	ASSERT_TRUE(zip::decompressor().uncompress(withDict.data(), withDict.size(), output, &dictionary));
+	ASSERT_EQ(input.size(), output.size());
+	EXPECT_EQ(0, core_memcmp(input.data(), output.data(), input.size()));
+
+	uint8_t fixedOutput[400];
+	size_t finalSize = 0u;
+	ASSERT_TRUE(zip::decompressor().uncompress(withDict.data(), withDict.size(), fixedOutput, sizeof(fixedOutput), &finalSize, &dictionary));
+	EXPECT_EQ(input.size(), finalSize);
+	EXPECT_EQ(0, core_memcmp(input.data(), fixedOutput, sizeof(fixedOutput)));
+}
+
+TEST_F(ZipTest, testOutputTooSmall) {
+	core::Buffer<uint8_t> input;
+	fill(input, 4096, 5u);
+	core::Buffer<uint8_t> compressed;
+	ASSERT_TRUE(zip::compressor().compress(input.data(), input.size(), compressed));
+	uint8_t output[1024];
+	EXPECT_FALSE(zip::uncompress(compressed.data(), compressed.size(), output, sizeof(output)));
+	EXPECT_FALSE(zip::compress(input.data(), input.size(), output, 16));
+}
+
 }
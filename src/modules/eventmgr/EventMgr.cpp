@@ -13,6 +13,13 @@
 
 namespace eventmgr {
 
+/**
+ * @brief Time in microseconds that is spent on collecting the lua garbage per update
+ */
+static constexpr uint64_t LUAGCBudgetMicros = 100u;
+
+static_assert(EventMgr::RefreshIntervalMillis < EventProvider::LookAheadMillis, "Events would be loaded too late");
+
 EventMgr::EventMgr(const EventProviderPtr& eventProvider, const core::TimeProviderPtr& timeProvider) :
 		_eventProvider(eventProvider), _timeProvider(timeProvider) {
 }
@@ -46,47 +53,70 @@ bool EventMgr::init(const core::String& luaScript) {
 		Log::error("%s", _lua.error().c_str());
 		return false;
 	}
+	// the garbage is collected in small steps in update()
+	_lua.setManualGC(true);
+
+	if (!refresh(_timeProvider->tickNow())) {
+		Log::error("Failed to load the events");
+		return false;
+	}
+
+	return true;
+}
 
+bool EventMgr::refresh(uint64_t currentMillis) {
+	core_trace_scoped(EventMgrRefresh);
+	_nextRefreshMillis = currentMillis + RefreshIntervalMillis;
+	_added.clear();
+	if (!_eventProvider->refresh(currentMillis, _added)) {
+		return false;
+	}
+	for (const db::EventModelPtr& model : _added) {
+		const uint64_t endMillis = model->enddate().millis();
+		if (endMillis <= currentMillis) {
+			continue;
+		}
+		_timeline.add(model->id(), model->startdate().millis(), endMillis);
+	}
 	return true;
 }
 
 void EventMgr::update(long dt) {
 	core_trace_scoped(EventMgrUpdate);
-	const auto currentMillis = _timeProvider->tickNow();
-	const EventProvider::EventData& eventData = _eventProvider->eventData();
-	for (const auto& entry : eventData) {
-		const db::EventModelPtr& data = entry.second;
-		const auto i = _events.find(data->id());
-		const persistence::Timestamp& endTime = data->enddate();
-		if (endTime.millis() < currentMillis) {
+	const uint64_t currentMillis = _timeProvider->tickNow();
+	if (currentMillis >= _nextRefreshMillis && !refresh(currentMillis)) {
+		Log::warn("Failed to load the events from the database");
+	}
+	_starts.clear();
+	_stops.clear();
+	_timeline.advance(currentMillis, _starts, _stops);
+	for (EventId id : _starts) {
+		const db::EventModelPtr& data = _eventProvider->get(id);
+		if (!data || data->enddate().millis() <= currentMillis) {
 			continue;
 		}
-		if (i == _events.end()) {
-			const persistence::Timestamp& startTime = data->startdate();
-			const auto eventStartMillis = startTime.millis();
-			const long delta = eventStartMillis - currentMillis;
-			if (delta <= 0) {
-				core_trace_scoped(EventStart);
-				startEvent(data);
-			}
+		if (_events.find(id) != _events.end()) {
 			continue;
 		}
-
-		const auto eventEndMillis = endTime.millis();
-		if (eventEndMillis <= currentMillis) {
-			core_trace_scoped(EventStop);
-			const EventPtr& event = i->second;
-			Log::info("Stop event of type " PRIEventId, (EventId)data->id());
-			event->stop();
-			_events.erase(i);
+		core_trace_scoped(EventStart);
+		startEvent(data);
+	}
+	for (EventId id : _stops) {
+		auto i = _events.find(id);
+		if (i == _events.end()) {
 			continue;
 		}
+		core_trace_scoped(EventStop);
+		Log::info("Stop event of type " PRIEventId, id);
+		i->second->stop();
+		_events.erase(i);
 	}
 	for (auto i = _events.begin(); i != _events.end(); ++i)  {
 		Log::debug("Tick event %i", (int)i->first);
 		core_trace_scoped(EventUpdate);
 		i->second->update(dt);
 	}
+	_lua.gcStep(LUAGCBudgetMicros);
 }
 
 EventPtr EventMgr::runningEvent(EventId id) const {
@@ -102,6 +132,8 @@ void EventMgr::shutdown() {
 		e.second->shutdown();
 	}
 	_events.clear();
+	_timeline.clear();
+	_nextRefreshMillis = 0u;
 	_eventProvider->shutdown();
 }
 
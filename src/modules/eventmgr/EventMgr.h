@@ -5,6 +5,7 @@
 #include "EventConfigurationData.h"
 #include "Event.h"
 #include "EventProvider.h"
+#include "EventTimeline.h"
 #include "EventType.h"
 #include "persistence/DBHandler.h"
 #include "commonlua/LUA.h"
@@ -28,6 +29,12 @@ namespace eventmgr {
  * @brief The event manager deals with starting, ticking and ending game events.
  */
 class EventMgr {
+public:
+	/**
+	 * @brief Interval for loading new events from the database. Must be smaller than the look ahead
+	 * window of the @c EventProvider to start the events in time.
+	 */
+	static constexpr uint64_t RefreshIntervalMillis = 60u * 1000u;
 private:
 	std::unordered_map<core::String, EventConfigurationDataPtr, core::StringHash> _eventData;
 	std::unordered_map<EventId, EventPtr> _events;
@@ -36,16 +43,28 @@ private:
 	core::TimeProviderPtr _timeProvider;
 	lua::LUA _lua;
 
+	EventTimeline _timeline;
+	uint64_t _nextRefreshMillis = 0u;
+	// reused in every update to not allocate memory
+	core::DynamicArray<db::EventModelPtr> _added;
+	core::DynamicArray<EventId> _starts;
+	core::DynamicArray<EventId> _stops;
+
 	EventPtr createEvent(const core::String& nameId, EventId id) const;
 
 	bool startEvent(const db::EventModelPtr& model);
+	/**
+	 * @brief Loads the new events of the active time window from the @c EventProvider and puts them into the timeline
+	 */
+	bool refresh(uint64_t currentMillis);
 public:
 	EventMgr(const EventProviderPtr& eventProvider, const core::TimeProviderPtr& timeProvider);
 
 	bool init(const core::String& luaScript);
 	/**
 	 * @brief Call this in your main loop
-	 * Starts all events that are configured to run at the current time of the @c core::TimeProvider
+	 * Starts all events that are configured to run at the current time of the @c core::TimeProvider and stops
+	 * the events that are over. Only the events that start or stop in this tick are touched.
 	 */
 	void update(long dt);
 	/**
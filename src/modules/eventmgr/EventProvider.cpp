@@ -6,6 +6,7 @@
 #include "app/App.h"
 #include "core/ArrayLength.h"
 #include "core/Common.h"
+#include "core/Trace.h"
 #include "persistence/DBHandler.h"
 #include "io/Filesystem.h"
 #include "EventMgrModels.h"
@@ -25,10 +26,32 @@ bool EventProvider::init() {
 		Log::error("Failed to create event point table");
 		return false;
 	}
+	return true;
+}
+
+bool EventProvider::refresh(uint64_t nowMillis, core::DynamicArray<db::EventModelPtr>& added) {
+	core_trace_scoped(EventProviderRefresh);
+	for (auto i = _eventData.begin(); i != _eventData.end();) {
+		if (i->second->enddate().millis() <= nowMillis) {
+			i = _eventData.erase(i);
+		} else {
+			++i;
+		}
+	}
 
-	return _dbHandler->select(db::EventModel(), persistence::DBConditionOne(), [this] (db::EventModel&& model) {
+	const persistence::Timestamp now(nowMillis / 1000u);
+	const persistence::Timestamp lookAhead((nowMillis + LookAheadMillis) / 1000u);
+	const db::DBConditionEventModelEnddate notOver(now, persistence::Comparator::Bigger);
+	const db::DBConditionEventModelStartdate startsSoon(lookAhead, persistence::Comparator::LessOrEqual);
+	const persistence::DBConditionMultiple window(true, {&notOver, &startsSoon});
+	return _dbHandler->select(db::EventModel(), window, [this, &added] (db::EventModel&& model) {
+		const EventId id = (EventId)model.id();
+		if (_eventData.find(id) != _eventData.end()) {
+			return;
+		}
 		const db::EventModelPtr& modelPtr = std::make_shared<db::EventModel>(std::forward<db::EventModel>(model));
-		_eventData.insert(std::make_pair((EventId)modelPtr->id(), modelPtr));
+		_eventData.insert(std::make_pair(id, modelPtr));
+		added.push_back(modelPtr);
 	});
 }
 
@@ -9,6 +9,7 @@
 #include "core/IComponent.h"
 #include "EventId.h"
 #include "EventType.h"
+#include "core/collection/DynamicArray.h"
 #include <memory>
 #include <unordered_map>
 
@@ -21,11 +22,15 @@ namespace eventmgr {
 
 /**
  * @brief Provides configured events via EventData
+ *
+ * Only the events of the active time window are loaded - that is everything that isn't over yet and starts
+ * within the next @c LookAheadMillis. Call @c refresh() regularly to move the window.
  * @ingroup Events
  */
 class EventProvider : public core::IComponent {
 public:
 	typedef std::unordered_map<EventId, db::EventModelPtr> EventData;
+	static constexpr uint64_t LookAheadMillis = 60u * 60u * 1000u;
 private:
 	persistence::DBHandlerPtr _dbHandler;
 	EventData _eventData;
@@ -34,9 +39,19 @@ public:
 
 	const EventData& eventData() const;
 
+	/**
+	 * @brief Creates the tables - the events are loaded with @c refresh()
+	 */
 	bool init() override;
 	void shutdown() override;
 
+	/**
+	 * @brief Loads the events of the time window around @c nowMillis that are not yet known and removes the
+	 * events that are over.
+	 * @param[out] added The newly loaded events
+	 */
+	bool refresh(uint64_t nowMillis, core::DynamicArray<db::EventModelPtr>& added);
+
 	db::EventModelPtr get(EventId id) const;
 };
 
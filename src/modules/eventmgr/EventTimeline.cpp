@@ -0,0 +1,42 @@
+/**
+ * @file
+ */
+
+#include "EventTimeline.h"
+#include "core/Common.h"
+
+namespace eventmgr {
+
+void EventTimeline::add(EventId id, uint64_t startMillis, uint64_t endMillis) {
+	_starts.push(Entry{startMillis, id});
+	_stops.push(Entry{endMillis, id});
+}
+
+void EventTimeline::advance(uint64_t nowMillis, core::DynamicArray<EventId>& starts, core::DynamicArray<EventId>& stops) {
+	while (!_starts.empty() && _starts.top().millis <= nowMillis) {
+		starts.push_back(_starts.top().id);
+		_starts.pop();
+	}
+	while (!_stops.empty() && _stops.top().millis <= nowMillis) {
+		stops.push_back(_stops.top().id);
+		_stops.pop();
+	}
+}
+
+uint64_t EventTimeline::next() const {
+	uint64_t millis = UINT64_MAX;
+	if (!_starts.empty()) {
+		millis = _starts.top().millis;
+	}
+	if (!_stops.empty()) {
+		millis = core_min(millis, _stops.top().millis);
+	}
+	return millis;
+}
+
+void EventTimeline::clear() {
+	_starts = Queue();
+	_stops = Queue();
+}
+
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "EventId.h"
+#include "core/collection/DynamicArray.h"
+#include <queue>
+#include <vector>
+#include <stdint.h>
+
+namespace eventmgr {
+
+/**
+ * @brief Orders the events by their start and end time. Only the events that start or stop at the given
+ * time are touched when advancing the timeline - the amount of known events doesn't matter.
+ * @ingroup Events
+ */
+class EventTimeline {
+private:
+	struct Entry {
+		uint64_t millis;
+		EventId id;
+	};
+	struct EntryComparatorGreater {
+		inline bool operator()(const Entry& lhs, const Entry& rhs) const {
+			return lhs.millis > rhs.millis;
+		}
+	};
+	typedef std::priority_queue<Entry, std::vector<Entry>, EntryComparatorGreater> Queue;
+	Queue _starts;
+	Queue _stops;
+public:
+	/**
+	 * @brief Adds an event that is started at @c startMillis and stopped at @c endMillis
+	 */
+	void add(EventId id, uint64_t startMillis, uint64_t endMillis);
+
+	/**
+	 * @brief Removes all the entries that are due at the given time from the timeline.
+	 * @param[out] starts The events that should get started. This also includes events that should be stopped
+	 * in the same call - the caller is responsible to handle the stops after the starts.
+	 * @param[out] stops The events that should get stopped.
+	 */
+	void advance(uint64_t nowMillis, core::DynamicArray<EventId>& starts, core::DynamicArray<EventId>& stops);
+
+	/**
+	 * @return The time of the next start or stop - or @c UINT64_MAX if there is nothing scheduled
+	 */
+	uint64_t next() const;
+
+	size_t size() const;
+	bool empty() const;
+	void clear();
+};
+
+inline size_t EventTimeline::size() const {
+	return _stops.size();
+}
+
+inline bool EventTimeline::empty() const {
+	return _stops.empty();
+}
+
+}
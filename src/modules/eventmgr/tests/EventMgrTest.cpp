@@ -189,4 +189,60 @@ TEST_F(EventMgrTest, testEventMgrUpdateStartStop) {
 	mgr.shutdown();
 }
 
+TEST_F(EventMgrTest, testEventMgrLoadsOnlyActiveWindow) {
+	if (!_supported) {
+		return;
+	}
+	const core::TimeProviderPtr& timeProvider = _testApp->timeProvider();
+	const uint64_t nowSeconds = 100000UL;
+	timeProvider->setTickTime(nowSeconds * 1000UL);
+
+	EventId over;
+	createEvent(Type::GENERIC, over, nowSeconds - 100, nowSeconds - 50);
+	EventId running;
+	createEvent(Type::GENERIC, running, nowSeconds - 100, nowSeconds + 50);
+	EventId future;
+	createEvent(Type::GENERIC, future, nowSeconds + EventProvider::LookAheadMillis / 1000UL * 2, nowSeconds + EventProvider::LookAheadMillis / 1000UL * 3);
+
+	EventMgr mgr(_eventProvider, timeProvider);
+	const core::String& events = _testApp->filesystem()->load("test-events.lua");
+	ASSERT_TRUE(mgr.init(events)) << "Could not initialize eventmgr from: " << events;
+	EXPECT_FALSE(_eventProvider->get(over));
+	EXPECT_TRUE(_eventProvider->get(running));
+	EXPECT_FALSE(_eventProvider->get(future));
+
+	mgr.update(0L);
+	EXPECT_EQ(1, mgr.runningEvents());
+	EXPECT_TRUE(mgr.runningEvent(running));
+
+	mgr.shutdown();
+}
+
+TEST_F(EventMgrTest, testEventMgrRefresh) {
+	if (!_supported) {
+		return;
+	}
+	const core::TimeProviderPtr& timeProvider = _testApp->timeProvider();
+	const uint64_t nowSeconds = 100000UL;
+	timeProvider->setTickTime(nowSeconds * 1000UL);
+
+	EventMgr mgr(_eventProvider, timeProvider);
+	const core::String& events = _testApp->filesystem()->load("test-events.lua");
+	ASSERT_TRUE(mgr.init(events)) << "Could not initialize eventmgr from: " << events;
+	mgr.update(0L);
+	ASSERT_EQ(0, mgr.runningEvents());
+
+	// added while the event manager is running
+	EventId id;
+	createEvent(Type::GENERIC, id, nowSeconds, nowSeconds + 500);
+	mgr.update(0L);
+	EXPECT_EQ(0, mgr.runningEvents()) << "The event should only be loaded after the refresh interval";
+
+	timeProvider->setTickTime(nowSeconds * 1000UL + EventMgr::RefreshIntervalMillis);
+	mgr.update(0L);
+	EXPECT_EQ(1, mgr.runningEvents());
+
+	mgr.shutdown();
+}
+
 }
@@ -0,0 +1,96 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "eventmgr/EventTimeline.h"
+#include "core/TimeProvider.h"
+
+namespace eventmgr {
+
+class EventTimelineTest : public testing::Test {
+protected:
+	core::TimeProvider _timeProvider;
+	EventTimeline _timeline;
+	core::DynamicArray<EventId> _starts;
+	core::DynamicArray<EventId> _stops;
+
+	void advance(uint64_t millis) {
+		_timeProvider.setTickTime(millis);
+		_starts.clear();
+		_stops.clear();
+		_timeline.advance(_timeProvider.tickNow(), _starts, _stops);
+	}
+};
+
+TEST_F(EventTimelineTest, testEmpty) {
+	EXPECT_TRUE(_timeline.empty());
+	EXPECT_EQ(UINT64_MAX, _timeline.next());
+	advance(1000u);
+	EXPECT_TRUE(_starts.empty());
+	EXPECT_TRUE(_stops.empty());
+}
+
+TEST_F(EventTimelineTest, testStartStop) {
+	_timeline.add(1, 2000u, 52000u);
+	EXPECT_EQ(1u, _timeline.size());
+	EXPECT_EQ(2000u, _timeline.next());
+
+	advance(1000u);
+	EXPECT_TRUE(_starts.empty());
+	EXPECT_TRUE(_stops.empty());
+
+	advance(2000u);
+	ASSERT_EQ(1u, _starts.size());
+	EXPECT_EQ(1, _starts[0]);
+	EXPECT_TRUE(_stops.empty());
+	EXPECT_EQ(52000u, _timeline.next());
+
+	advance(51999u);
+	EXPECT_TRUE(_starts.empty());
+	EXPECT_TRUE(_stops.empty());
+
+	advance(52000u);
+	EXPECT_TRUE(_starts.empty());
+	ASSERT_EQ(1u, _stops.size());
+	EXPECT_EQ(1, _stops[0]);
+	EXPECT_TRUE(_timeline.empty());
+}
+
+TEST_F(EventTimelineTest, testOrder) {
+	_timeline.add(3, 3000u, 9000u);
+	_timeline.add(1, 1000u, 4000u);
+	_timeline.add(2, 2000u, 5000u);
+
+	advance(2500u);
+	ASSERT_EQ(2u, _starts.size());
+	EXPECT_EQ(1, _starts[0]);
+	EXPECT_EQ(2, _starts[1]);
+
+	advance(5000u);
+	ASSERT_EQ(1u, _starts.size());
+	EXPECT_EQ(3, _starts[0]);
+	ASSERT_EQ(2u, _stops.size());
+	EXPECT_EQ(1, _stops[0]);
+	EXPECT_EQ(2, _stops[1]);
+	EXPECT_EQ(9000u, _timeline.next());
+}
+
+TEST_F(EventTimelineTest, testStartAndStopInOneTick) {
+	_timeline.add(1, 1000u, 2000u);
+	advance(10000u);
+	ASSERT_EQ(1u, _starts.size());
+	ASSERT_EQ(1u, _stops.size());
+	EXPECT_TRUE(_timeline.empty());
+}
+
+TEST_F(EventTimelineTest, testClear) {
+	_timeline.add(1, 1000u, 2000u);
+	_timeline.clear();
+	EXPECT_TRUE(_timeline.empty());
+	advance(10000u);
+	EXPECT_TRUE(_starts.empty());
+	EXPECT_TRUE(_stops.empty());
+}
+
+}
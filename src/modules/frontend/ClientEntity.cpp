@@ -89,10 +89,13 @@ uint32_t ClientEntity::bindVertexBuffers(const shader::SkeletonShader& chrShader
 		_vbo.addAttribute(ambientOcclusion);
 	}
 
-	const animation::Indices& i = _character.indices();
-	const animation::Vertices& v = _character.vertices();
-	core_assert_always(_vbo.update(_indices, &i.front(), i.size() * sizeof(animation::IndexType)));
-	core_assert_always(_vbo.update(_vertices, &v.front(), v.size() * sizeof(animation::Vertex)));
+	if (_uploadedMeshRevision != _character.meshRevision()) {
+		const animation::Indices& i = _character.indices();
+		const animation::Vertices& v = _character.vertices();
+		core_assert_always(_vbo.update(_indices, &i.front(), i.size() * sizeof(animation::IndexType)));
+		core_assert_always(_vbo.update(_vertices, &v.front(), v.size() * sizeof(animation::Vertex)));
+		_uploadedMeshRevision = _character.meshRevision();
+	}
 
 	_vbo.bind();
 	return _vbo.elements(_indices, 1, sizeof(animation::IndexType));
@@ -46,6 +46,8 @@ private:
 	video::Buffer _vbo;
 	int32_t _vertices = -1;
 	int32_t _indices = -1;
+	// the mesh revision of the character that was uploaded to the vertex buffers
+	uint32_t _uploadedMeshRevision = 0u;
 	core::StringMap<core::String> _userinfo;
 public:
 	ClientEntity(const stock::StockDataProviderPtr& provider, const animation::AnimationCachePtr& animationCache,
@@ -61,10 +63,15 @@ public:
 	void userinfo(const core::String& key, const core::String& value);
 
 	const glm::mat4& modelMatrix() const;
-	const core::Array<glm::mat4, shader::SkeletonShaderConstants::getMaxBones()> bones() const;
+	const core::Array<glm::mat4, shader::SkeletonShaderConstants::getMaxBones()>& bones() const;
 
 	bool operator==(const ClientEntity& other) const;
 
+	/**
+	 * @brief Binds the per instance vertex buffers - they are only uploaded again if the mesh of the character changed
+	 * @note The renderer uses shared buffers for the characters that don't have any per instance vertices
+	 * @sa animation::AnimationEntity::sharedModel()
+	 */
 	uint32_t bindVertexBuffers(const shader::SkeletonShader& chrShader);
 	void unbindVertexBuffers();
 
@@ -80,7 +87,7 @@ public:
 	animation::Character& character();
 };
 
-inline const core::Array<glm::mat4, shader::SkeletonShaderConstants::getMaxBones()> ClientEntity::bones() const {
+inline const core::Array<glm::mat4, shader::SkeletonShaderConstants::getMaxBones()>& ClientEntity::bones() const {
 	return _bones;
 }
 
@@ -17,6 +17,7 @@
 #include "render/Shadow.h"
 #include "core/Trace.h"
 #include "core/StandardLib.h"
+#include "core/Common.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/transform.hpp>
@@ -79,6 +80,11 @@ bool ClientEntityRenderer::init() {
 }
 
 void ClientEntityRenderer::shutdown() {
+	removeMeshBuffers(true);
+	_frameMeshes.clear();
+	_drawEntities.clear();
+	_drawListBuilder.clear();
+	_drawList.clear();
 	_chrShader.shutdown();
 	_skeletonShadowMapShader.shutdown();
 	_skeletondepthmapShader.shutdown();
@@ -91,21 +97,133 @@ void ClientEntityRenderer::update(const glm::vec3& focusPos, float seconds) {
 	_seconds = seconds;
 }
 
-void ClientEntityRenderer::renderShadows(const core::List<ClientEntity*>& entities, render::Shadow& shadow) {
+uint32_t ClientEntityRenderer::meshId(const animation::AnimationModelPtr& model) {
+	MeshBuffer* meshBuffer = nullptr;
+	if (!_meshBuffers.get(model.get(), meshBuffer)) {
+		meshBuffer = new MeshBuffer();
+		meshBuffer->model = model;
+		meshBuffer->vertices = meshBuffer->vbo.create(&model->vertices.front(), model->vertices.size() * sizeof(animation::Vertex));
+		meshBuffer->indices = meshBuffer->vbo.create(&model->indices.front(), model->indices.size() * sizeof(animation::IndexType),
+				video::BufferType::IndexBuffer);
+		meshBuffer->vbo.addAttribute(_chrShader.getPosAttribute(meshBuffer->vertices, &animation::Vertex::pos));
+		video::Attribute color = _chrShader.getColorIndexAttribute(meshBuffer->vertices, &animation::Vertex::colorIndex);
+		color.typeIsInt = true;
+		meshBuffer->vbo.addAttribute(color);
+		video::Attribute boneId = _chrShader.getBoneIdAttribute(meshBuffer->vertices, &animation::Vertex::boneId);
+		boneId.typeIsInt = true;
+		meshBuffer->vbo.addAttribute(boneId);
+		video::Attribute ambientOcclusion = _chrShader.getAmbientOcclusionAttribute(meshBuffer->vertices, &animation::Vertex::ambientOcclusion);
+		ambientOcclusion.typeIsInt = true;
+		meshBuffer->vbo.addAttribute(ambientOcclusion);
+		meshBuffer->elements = meshBuffer->vbo.elements(meshBuffer->indices, 1, sizeof(animation::IndexType));
+		_meshBuffers.put(model.get(), meshBuffer);
+	}
+	if (meshBuffer->frame != _frame) {
+		meshBuffer->frame = _frame;
+		meshBuffer->id = (uint32_t)_frameMeshes.size();
+		_frameMeshes.push_back(meshBuffer);
+	}
+	return meshBuffer->id;
+}
+
+void ClientEntityRenderer::removeMeshBuffers(bool all) {
+	core::DynamicArray<const animation::AnimationModel*> unused;
+	for (const auto& e : _meshBuffers) {
+		if (all || e->value->frame != _frame) {
+			unused.push_back(e->key);
+		}
+	}
+	for (const animation::AnimationModel* model : unused) {
+		MeshBuffer* meshBuffer = nullptr;
+		_meshBuffers.get(model, meshBuffer);
+		meshBuffer->vbo.shutdown();
+		delete meshBuffer;
+		_meshBuffers.remove(model);
+	}
+}
+
+void ClientEntityRenderer::prepare(const core::List<ClientEntity*>& entities) {
+	core_trace_scoped(ClientEntityRendererPrepare);
+	++_frame;
+	_drawListBuilder.clear();
+	_drawEntities.clear();
+	_frameMeshes.clear();
+	for (ClientEntity* ent : entities) {
+		const animation::Character& chr = ent->character();
+		if (chr.indices().empty()) {
+			continue;
+		}
+		// the aabb doesn't include the orientation - extend it to cover every rotation around the up axis
+		const math::AABB<float>& aabb = chr.aabb();
+		const glm::vec3& mins = aabb.getLowerCorner();
+		const glm::vec3& maxs = aabb.getUpperCorner();
+		const float radius = core_max(core_max(glm::abs(mins.x), glm::abs(maxs.x)), core_max(glm::abs(mins.z), glm::abs(maxs.z)));
+		DrawListBuilder::Drawable drawable;
+		drawable.mins = ent->position() + glm::vec3(-radius, mins.y, -radius);
+		drawable.maxs = ent->position() + glm::vec3(radius, maxs.y, radius);
+		const animation::AnimationModelPtr& model = chr.sharedModel();
+		if (model) {
+			drawable.mesh = meshId(model);
+		} else {
+			drawable.mesh = InstanceMesh | (uint32_t)_drawEntities.size();
+		}
+		// all entities are rendered with the same shaders and material block
+		drawable.shader = 0u;
+		drawable.material = 0u;
+		_drawListBuilder.add(drawable);
+		_drawEntities.push_back(ent);
+	}
+	// free the buffers of the models that are no longer used
+	removeMeshBuffers(false);
+}
+
+template<class SHADER>
+int ClientEntityRenderer::draw(SHADER& shader, const DrawList& list) {
+	const video::Buffer* bound = nullptr;
+	uint32_t boundMesh = 0u;
+	uint32_t elements = 0u;
+	for (const DrawCommand& cmd : list.commands()) {
+		const uint32_t mesh = _drawListBuilder.drawable(cmd.drawable).mesh;
+		ClientEntity* ent = _drawEntities[cmd.drawable];
+		shader.setModel(ent->modelMatrix());
+		core_assert_always(shader.setBones(ent->bones()._items));
+		if (bound == nullptr || mesh != boundMesh) {
+			if ((mesh & InstanceMesh) != 0u) {
+				elements = ent->bindVertexBuffers(_chrShader);
+				bound = nullptr;
+			} else {
+				MeshBuffer* meshBuffer = _frameMeshes[mesh];
+				meshBuffer->vbo.bind();
+				elements = meshBuffer->elements;
+				bound = &meshBuffer->vbo;
+			}
+			boundMesh = mesh;
+		}
+		video::drawElements<animation::IndexType>(video::Primitive::Triangles, elements);
+		if (bound == nullptr) {
+			ent->unbindVertexBuffers();
+		}
+	}
+	if (bound != nullptr) {
+		bound->unbind();
+	}
+	return (int)list.commands().size();
+}
+
+int ClientEntityRenderer::renderShadows(render::Shadow& shadow) {
 	core_trace_scoped(RenderEntityShadows);
+	int drawCalls = 0;
+	_culled[(int)DrawPass::Shadow] = 0;
 	_skeletonShadowMapShader.activate();
-	shadow.render([this, entities] (int i, const glm::mat4& lightViewProjection) {
+	shadow.render([this, &drawCalls] (int i, const glm::mat4& lightViewProjection) {
+		_drawListBuilder.build(lightViewProjection, _drawList);
+		_culled[(int)DrawPass::Shadow] += _drawList.culled();
 		_skeletonShadowMapShader.setLightviewprojection(lightViewProjection);
-		for (const auto& ent : entities) {
-			_skeletonShadowMapShader.setBones(ent->bones()._items);
-			_skeletonShadowMapShader.setModel(ent->modelMatrix());
-			const uint32_t numIndices = ent->bindVertexBuffers(_chrShader);
-			video::drawElements<animation::IndexType>(video::Primitive::Triangles, numIndices);
-			ent->unbindVertexBuffers();
-		}
+		drawCalls += draw(_skeletonShadowMapShader, _drawList);
 		return true;
 	}, true);
 	_skeletonShadowMapShader.deactivate();
+	return drawCalls;
 }
 
 int ClientEntityRenderer::renderEntityDetails(const core::List<ClientEntity*>& entities, const video::Camera& camera) {
@@ -137,34 +255,34 @@ void ClientEntityRenderer::bindEntitiesDepthBuffer(video::TextureUnit texunit) {
 	video::bindTexture(texunit, _entitiesDepthBuffer, video::FrameBufferAttachment::Depth);
 }
 
-int ClientEntityRenderer::renderEntitiesToDepthMap(const core::List<ClientEntity*>& entities, const glm::mat4& viewProjectionMatrix) {
+int ClientEntityRenderer::renderEntitiesToDepthMap(const glm::mat4& viewProjectionMatrix) {
 	video_trace_scoped(RenderEntitiesToDepthMap);
+	_drawListBuilder.build(viewProjectionMatrix, _drawList);
+	_culled[(int)DrawPass::Depth] = _drawList.culled();
+
 	_entitiesDepthBuffer.bind(true);
 	video::colorMask(false, false, false, false);
 
 	video::ScopedState blend(video::State::Blend, false);
 	video::ScopedShader scoped(_skeletondepthmapShader);
 	_skeletondepthmapShader.setViewprojection(viewProjectionMatrix);
-	for (const auto& ent : entities) {
-		_skeletondepthmapShader.setBones(ent->bones()._items);
-		_skeletondepthmapShader.setModel(ent->modelMatrix());
-		const uint32_t numIndices = ent->bindVertexBuffers(_chrShader);
-		video::drawElements<animation::IndexType>(video::Primitive::Triangles, numIndices);
-		ent->unbindVertexBuffers();
-	}
+	const int drawCalls = draw(_skeletondepthmapShader, _drawList);
 
 	video::colorMask(true, true, true, true);
 	_entitiesDepthBuffer.unbind();
-	return 0;
+	return drawCalls;
 }
 
-int ClientEntityRenderer::renderEntities(const core::List<ClientEntity*>& entities, const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane, const render::Shadow& shadow) {
-	if (entities.empty()) {
+int ClientEntityRenderer::renderEntities(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane, const render::Shadow& shadow) {
+	if (_drawListBuilder.size() == 0u) {
 		return 0;
 	}
 	video_trace_scoped(ClientEntityRendererEntities);
-
-	int drawCallsEntities = 0;
+	_drawListBuilder.build(viewProjectionMatrix, clipPlane, _drawList);
+	_culled[(int)DrawPass::Color] = _drawList.culled();
+	if (_drawList.commands().empty()) {
+		return 0;
+	}
 
 	video::enable(video::State::DepthTest);
 	video::ScopedShader scoped(_chrShader);
@@ -191,16 +309,7 @@ int ClientEntityRenderer::renderEntities(const core::List<ClientEntity*>& entiti
 		_chrShader.setCascades(shadow.cascades());
 		_chrShader.setDistances(shadow.distances());
 	}
-	for (frontend::ClientEntity* ent : entities) {
-		// TODO: apply the clipping plane to the entity frustum culling
-		_chrShader.setModel(ent->modelMatrix());
-		core_assert_always(_chrShader.setBones(ent->bones()._items));
-		const uint32_t numIndices = ent->bindVertexBuffers(_chrShader);
-		++drawCallsEntities;
-		video::drawElements<animation::IndexType>(video::Primitive::Triangles, numIndices);
-		ent->unbindVertexBuffers();
-	}
-	return drawCallsEntities;
+	return draw(_chrShader, _drawList);
 }
 
 }
@@ -5,8 +5,13 @@
 #pragma once
 
 #include "AnimationShaders.h"
+#include "DrawList.h"
+#include "animation/AnimationCache.h"
 #include "animation/AnimationSystem.h"
 #include "core/IComponent.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/Map.h"
+#include "video/Buffer.h"
 #include "video/FrameBuffer.h"
 #include "core/Var.h"
 
@@ -27,8 +32,39 @@ namespace frontend {
 
 class ClientEntity;
 
+enum class DrawPass {
+	Shadow, Depth, Color, Max
+};
+
 class ClientEntityRenderer : public core::IComponent {
 private:
+	/**
+	 * @brief The gpu buffers for a model that is shared between several entities
+	 */
+	struct MeshBuffer {
+		// keeps the model alive as long as the buffers are in use
+		animation::AnimationModelPtr model;
+		video::Buffer vbo;
+		int32_t vertices = -1;
+		int32_t indices = -1;
+		uint32_t elements = 0u;
+		// the mesh id in the draw list of the frame
+		uint32_t id = 0u;
+		uint32_t frame = 0u;
+	};
+	// the mesh ids of entities with their own vertex buffers
+	static constexpr uint32_t InstanceMesh = 0x80000000u;
+
+	core::Map<const animation::AnimationModel*, MeshBuffer*, 64> _meshBuffers;
+	// the shared mesh buffers that are used in the current frame - indexed by the mesh id
+	core::DynamicArray<MeshBuffer*> _frameMeshes;
+	// the entities of the current frame - indexed like the drawables of the draw list builder
+	core::DynamicArray<ClientEntity*> _drawEntities;
+	DrawListBuilder _drawListBuilder;
+	DrawList _drawList;
+	int _culled[(int)DrawPass::Max] {};
+	uint32_t _frame = 0u;
+
 	shader::SkeletonShader _chrShader;
 	shader::SkeletonData _materialBlock;
 	shader::SkeletonshadowmapShader& _skeletonShadowMapShader;
@@ -44,6 +80,16 @@ private:
 	glm::vec3 _focusPos { 0.0f };
 
 	core::VarPtr _shadowMap;
+
+	uint32_t meshId(const animation::AnimationModelPtr& model);
+	void removeMeshBuffers(bool all);
+
+	/**
+	 * @brief Issues the draw calls for the sorted commands - the vertex buffers are only bound again if the
+	 * mesh changes between two commands
+	 */
+	template<class SHADER>
+	int draw(SHADER& shader, const DrawList& list);
 public:
 	ClientEntityRenderer();
 	virtual ~ClientEntityRenderer() = default;
@@ -56,15 +102,30 @@ public:
 
 	void bindEntitiesDepthBuffer(video::TextureUnit texunit);
 
-	int renderEntitiesToDepthMap(const core::List<ClientEntity*>& entities, const glm::mat4& viewProjectionMatrix);
-	int renderEntities(const core::List<ClientEntity*>& entities, const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane, const render::Shadow& shadow);
+	/**
+	 * @brief Collects the entities for the render passes of this frame. Each pass culls them against its own frustum.
+	 */
+	void prepare(const core::List<ClientEntity*>& entities);
+
+	int renderEntitiesToDepthMap(const glm::mat4& viewProjectionMatrix);
+	int renderEntities(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane, const render::Shadow& shadow);
 	int renderEntityDetails(const core::List<ClientEntity*>& entities, const video::Camera& camera);
 
 	void setViewDistance(float viewDistance, float fogRange);
 	video::FrameBuffer &entitiesBuffer();
-	void renderShadows(const core::List<ClientEntity*>& entities, render::Shadow& shadow);
+	int renderShadows(render::Shadow& shadow);
+
+	/**
+	 * @return The amount of entities that were culled in the last execution of the given pass - for the shadows this
+	 * is the sum over all cascades
+	 */
+	int culled(DrawPass pass) const;
 };
 
+inline int ClientEntityRenderer::culled(DrawPass pass) const {
+	return _culled[(int)pass];
+}
+
 inline void ClientEntityRenderer::setViewDistance(float viewDistance, float fogRange) {
 	_viewDistance = viewDistance;
 	_fogRange = fogRange;
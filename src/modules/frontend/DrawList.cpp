@@ -0,0 +1,56 @@
+/**
+ * @file
+ */
+
+#include "DrawList.h"
+#include "core/Algorithm.h"
+#include "core/Trace.h"
+#include "math/Frustum.h"
+
+namespace frontend {
+
+void DrawListBuilder::clear() {
+	_drawables.clear();
+}
+
+uint32_t DrawListBuilder::add(const Drawable& drawable) {
+	const uint32_t idx = (uint32_t)_drawables.size();
+	_drawables.push_back(drawable);
+	return idx;
+}
+
+static inline bool isClipped(const glm::vec4& clipPlane, const glm::vec3& mins, const glm::vec3& maxs) {
+	// the corner that is the farthest along the plane normal
+	const glm::vec3 corner(clipPlane.x >= 0.0f ? maxs.x : mins.x,
+			clipPlane.y >= 0.0f ? maxs.y : mins.y,
+			clipPlane.z >= 0.0f ? maxs.z : mins.z);
+	return glm::dot(glm::vec3(clipPlane), corner) + clipPlane.w < 0.0f;
+}
+
+int DrawListBuilder::build(const glm::mat4& viewProjection, const glm::vec4& clipPlane, DrawList& list) const {
+	core_trace_scoped(DrawListBuild);
+	list.clear();
+	list._commands.reserve(_drawables.size());
+
+	math::Frustum frustum;
+	frustum.updatePlanes(glm::mat4(1.0f), viewProjection);
+	const bool clip = clipPlane != glm::vec4(0.0f);
+	const uint32_t n = (uint32_t)_drawables.size();
+	for (uint32_t i = 0u; i < n; ++i) {
+		const Drawable& d = _drawables[i];
+		if (!frustum.isVisible(d.mins, d.maxs) || (clip && isClipped(clipPlane, d.mins, d.maxs))) {
+			++list._culled;
+			continue;
+		}
+		list._commands.push_back(DrawCommand{sortKey(d.shader, d.mesh, d.material), i});
+	}
+	core::sort(list._commands.begin(), list._commands.end(), [] (const DrawCommand& a, const DrawCommand& b) {
+		if (a.key != b.key) {
+			return a.key < b.key;
+		}
+		return a.drawable < b.drawable;
+	});
+	return (int)list._commands.size();
+}
+
+}
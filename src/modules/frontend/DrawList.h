@@ -0,0 +1,109 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <stdint.h>
+
+namespace frontend {
+
+/**
+ * @brief A single draw call of a render pass. The commands are sorted by their key - the shader, the mesh and the
+ * material - to minimize the state changes between the draw calls.
+ */
+struct DrawCommand {
+	uint64_t key;
+	// index of the drawable in the DrawListBuilder
+	uint32_t drawable;
+};
+
+/**
+ * @brief The culled and sorted draw commands for one render pass (e.g. a shadow cascade or the camera view)
+ */
+class DrawList {
+private:
+	friend class DrawListBuilder;
+	core::DynamicArray<DrawCommand> _commands;
+	int _culled = 0;
+public:
+	const core::DynamicArray<DrawCommand>& commands() const;
+	/**
+	 * @return The amount of drawables that were culled for this pass
+	 */
+	int culled() const;
+	void clear();
+};
+
+inline const core::DynamicArray<DrawCommand>& DrawList::commands() const {
+	return _commands;
+}
+
+inline int DrawList::culled() const {
+	return _culled;
+}
+
+inline void DrawList::clear() {
+	_commands.clear();
+	_culled = 0;
+}
+
+/**
+ * @brief Collects the drawables of a frame once and builds the culled and sorted draw lists for each render pass
+ *
+ * @note This doesn't touch any renderer state - the draw lists are consumed by the renderer
+ */
+class DrawListBuilder {
+public:
+	struct Drawable {
+		// world space bounding box
+		glm::vec3 mins;
+		glm::vec3 maxs;
+		uint32_t mesh;
+		uint16_t shader;
+		uint16_t material;
+	};
+
+	static constexpr uint64_t sortKey(uint16_t shader, uint32_t mesh, uint16_t material) {
+		return ((uint64_t)shader << 48) | ((uint64_t)mesh << 16) | (uint64_t)material;
+	}
+
+	void clear();
+	/**
+	 * @return The index of the drawable that is referenced by the @c DrawCommand
+	 */
+	uint32_t add(const Drawable& drawable);
+	const Drawable& drawable(uint32_t idx) const;
+	size_t size() const;
+
+	/**
+	 * @brief Cull the drawables against the frustum of the given view projection matrix and sort the visible ones
+	 * @param[in] clipPlane Drawables that are completely on the negative side of the plane are culled, too. A zero
+	 * vector disables the plane test.
+	 * @param[out] list The draw list that is filled with the commands for the visible drawables
+	 * @return The amount of visible drawables
+	 */
+	int build(const glm::mat4& viewProjection, const glm::vec4& clipPlane, DrawList& list) const;
+	int build(const glm::mat4& viewProjection, DrawList& list) const;
+
+private:
+	core::DynamicArray<Drawable> _drawables;
+};
+
+inline const DrawListBuilder::Drawable& DrawListBuilder::drawable(uint32_t idx) const {
+	return _drawables[idx];
+}
+
+inline size_t DrawListBuilder::size() const {
+	return _drawables.size();
+}
+
+inline int DrawListBuilder::build(const glm::mat4& viewProjection, DrawList& list) const {
+	return build(viewProjection, glm::vec4(0.0f), list);
+}
+
+}
@@ -0,0 +1,110 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "frontend/DrawList.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace frontend {
+
+class DrawListTest: public app::AbstractTest {
+protected:
+	// looking from the origin along the negative z axis
+	const glm::mat4 _viewProjection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+
+	static DrawListBuilder::Drawable drawable(const glm::vec3& pos, uint32_t mesh, uint16_t shader = 0u, uint16_t material = 0u) {
+		DrawListBuilder::Drawable d;
+		d.mins = pos - glm::vec3(0.5f);
+		d.maxs = pos + glm::vec3(0.5f);
+		d.mesh = mesh;
+		d.shader = shader;
+		d.material = material;
+		return d;
+	}
+};
+
+TEST_F(DrawListTest, testCull) {
+	DrawListBuilder builder;
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -10.0f), 0u));
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, 10.0f), 0u));
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -200.0f), 0u));
+	builder.add(drawable(glm::vec3(50.0f, 0.0f, -10.0f), 0u));
+	builder.add(drawable(glm::vec3(1.0f, 1.0f, -20.0f), 0u));
+
+	DrawList list;
+	EXPECT_EQ(2, builder.build(_viewProjection, list));
+	EXPECT_EQ(3, list.culled());
+	ASSERT_EQ(2u, list.commands().size());
+	EXPECT_EQ(0u, list.commands()[0].drawable);
+	EXPECT_EQ(4u, list.commands()[1].drawable);
+}
+
+TEST_F(DrawListTest, testClipPlane) {
+	DrawListBuilder builder;
+	builder.add(drawable(glm::vec3(0.0f, 2.0f, -10.0f), 0u));
+	builder.add(drawable(glm::vec3(0.0f, -2.0f, -10.0f), 0u));
+	// intersects the plane
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -10.0f), 0u));
+
+	DrawList list;
+	EXPECT_EQ(3, builder.build(_viewProjection, list));
+	EXPECT_EQ(0, list.culled());
+
+	// keep everything above y = 0
+	EXPECT_EQ(2, builder.build(_viewProjection, glm::vec4(0.0f, 1.0f, 0.0f, 0.0f), list));
+	EXPECT_EQ(1, list.culled());
+	for (const DrawCommand& cmd : list.commands()) {
+		EXPECT_NE(1u, cmd.drawable);
+	}
+}
+
+TEST_F(DrawListTest, testPerPass) {
+	DrawListBuilder builder;
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -10.0f), 0u));
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, 10.0f), 0u));
+
+	const glm::mat4& back = _viewProjection * glm::rotate(glm::mat4(1.0f), glm::pi<float>(), glm::vec3(0.0f, 1.0f, 0.0f));
+	DrawList front;
+	DrawList behind;
+	EXPECT_EQ(1, builder.build(_viewProjection, front));
+	EXPECT_EQ(1, builder.build(back, behind));
+	EXPECT_EQ(1, front.culled());
+	EXPECT_EQ(1, behind.culled());
+	EXPECT_EQ(0u, front.commands()[0].drawable);
+	EXPECT_EQ(1u, behind.commands()[0].drawable);
+}
+
+TEST_F(DrawListTest, testSort) {
+	DrawListBuilder builder;
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -10.0f), 2u, 1u));
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -11.0f), 1u, 1u, 3u));
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -12.0f), 2u, 0u));
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -13.0f), 1u, 1u, 1u));
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, -14.0f), 2u, 0u));
+
+	DrawList list;
+	ASSERT_EQ(5, builder.build(_viewProjection, list));
+	const uint32_t expected[] = {2u, 4u, 3u, 1u, 0u};
+	for (int i = 0; i < 5; ++i) {
+		EXPECT_EQ(expected[i], list.commands()[i].drawable) << "Unexpected order at " << i;
+	}
+	for (size_t i = 1; i < list.commands().size(); ++i) {
+		EXPECT_LE(list.commands()[i - 1].key, list.commands()[i].key);
+	}
+}
+
+TEST_F(DrawListTest, testClear) {
+	DrawListBuilder builder;
+	builder.add(drawable(glm::vec3(0.0f, 0.0f, 10.0f), 0u));
+	DrawList list;
+	builder.build(_viewProjection, list);
+	EXPECT_EQ(1, list.culled());
+	builder.clear();
+	EXPECT_EQ(0u, builder.size());
+	EXPECT_EQ(0, builder.build(_viewProjection, list));
+	EXPECT_EQ(0, list.culled());
+	EXPECT_TRUE(list.commands().empty());
+}
+
+}
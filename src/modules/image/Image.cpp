@@ -3,12 +3,18 @@
  */
 
 #include "Image.h"
+#include "ImageCache.h"
 #include "core/Log.h"
 #include "app/App.h"
+#include "core/concurrent/Lock.h"
 #include "core/concurrent/ThreadPool.h"
+#include "core/collection/StringMap.h"
 #include "core/Assert.h"
+#include "core/Trace.h"
 #include "io/Filesystem.h"
+#include "io/MappedFile.h"
 #include "core/StandardLib.h"
+#include <SDL_rwops.h>
 
 #define STBI_ASSERT core_assert
 #define STBI_MALLOC core_malloc
@@ -49,23 +55,122 @@ Image::~Image() {
 	}
 }
 
+namespace {
+
+struct InFlightLoad {
+	ImagePtr image;
+	std::shared_future<void> done;
+	bool async = false;
+};
+
+/**
+ * @brief The images that are currently loaded - requesting them again doesn't decode them twice
+ */
+struct InFlightLoads {
+	core::Lock lock {"ImageLoads"};
+	core::StringMap<InFlightLoad> loads;
+};
+
+InFlightLoads& inFlightLoads() {
+	static InFlightLoads loads;
+	return loads;
+}
+
+void finishLoad(const core::String& name) {
+	InFlightLoads& loads = inFlightLoads();
+	core::ScopedLock lock(loads.lock);
+	loads.loads.remove(name);
+}
+
+struct ReadInfoContext {
+	io::File *file;
+	long length;
+};
+
+int readInfoRead(void *user, char *data, int size) {
+	ReadInfoContext *ctx = (ReadInfoContext *)user;
+	const int n = ctx->file->read(data, 1, size);
+	return n < 0 ? 0 : n;
+}
+
+void readInfoSkip(void *user, int n) {
+	ReadInfoContext *ctx = (ReadInfoContext *)user;
+	ctx->file->seek(n, RW_SEEK_CUR);
+}
+
+int readInfoEof(void *user) {
+	ReadInfoContext *ctx = (ReadInfoContext *)user;
+	return ctx->file->tell() >= ctx->length;
+}
+
+}
+
 bool Image::load(const io::FilePtr& file) {
-	uint8_t* buffer;
-	const int length = file->read((void**) &buffer);
-	const bool status = load(buffer, length);
-	delete[] buffer;
-	return status;
+	core_trace_scoped(ImageLoadFile);
+	const io::MappedFile mapped(file->name());
+	if (!mapped.valid()) {
+		_state = io::IOSTATE_FAILED;
+		Log::debug("Failed to load image %s: could not read file", _name.c_str());
+		return false;
+	}
+	return load(mapped.data(), (int)mapped.size());
+}
+
+bool Image::readInfo(const io::FilePtr& file, int& width, int& height, int& components) {
+	const long length = file->length();
+	if (length <= 0) {
+		return false;
+	}
+	file->seek(0, RW_SEEK_SET);
+	ReadInfoContext ctx { file.get(), length };
+	const stbi_io_callbacks callbacks { readInfoRead, readInfoSkip, readInfoEof };
+	return stbi_info_from_callbacks(&callbacks, &ctx, &width, &height, &components) != 0;
 }
 
 ImagePtr loadImage(const io::FilePtr& file, bool async) {
-	const ImagePtr& i = createEmptyImage(file->name());
-	if (async) {
-		app::App::getInstance()->threadPool().enqueue([=] () { i->load(file); });
-	} else {
-		if (!i->load(file)) {
-			Log::warn("Failed to load image %s", i->name().c_str());
+	const core::String& name = file->name();
+	InFlightLoads& loads = inFlightLoads();
+	InFlightLoad inFlight;
+	ImagePtr i;
+	std::promise<void> done;
+	bool registered = false;
+	{
+		core::ScopedLock lock(loads.lock);
+		const bool loading = loads.loads.get(name, inFlight);
+		if (loading && async) {
+			return inFlight.image;
+		}
+		// a synchronous request must not wait for the thread pool - but another synchronous load is running
+		// right now on a different thread
+		if (!loading || inFlight.async) {
+			i = createEmptyImage(name);
+			if (async) {
+				std::future<void> future = app::App::getInstance()->threadPool().enqueue([=] () {
+					i->load(file);
+					finishLoad(name);
+				});
+				if (future.valid()) {
+					loads.loads.put(name, InFlightLoad{i, future.share(), true});
+				}
+				return i;
+			}
+			if (!loading) {
+				loads.loads.put(name, InFlightLoad{i, done.get_future().share(), false});
+				registered = true;
+			}
 		}
 	}
+	if (!i) {
+		inFlight.done.wait();
+		return inFlight.image;
+	}
+	if (!i->load(file)) {
+		Log::warn("Failed to load image %s", i->name().c_str());
+	}
+	if (registered) {
+		finishLoad(name);
+		done.set_value();
+	}
 	return i;
 }
 
@@ -82,8 +187,23 @@ bool Image::load(const uint8_t* buffer, int length) {
 	}
 	if (_data) {
 		stbi_image_free(_data);
+		_data = nullptr;
+	}
+	const bool cache = (size_t)length >= ImageCache::MinSourceSize && ImageCache::enabled();
+	core::String cacheKey;
+	if (cache) {
+		cacheKey = ImageCache::key(buffer, length);
+		_data = ImageCache::load(cacheKey, _width, _height, _depth);
+		if (_data != nullptr) {
+			Log::debug("Loaded image %s from cache", _name.c_str());
+			_state = io::IOSTATE_LOADED;
+			return true;
+		}
+	}
+	{
+		core_trace_scoped(ImageDecode);
+		_data = stbi_load_from_memory(buffer, length, &_width, &_height, &_depth, STBI_rgb_alpha);
 	}
-	_data = stbi_load_from_memory(buffer, length, &_width, &_height, &_depth, STBI_rgb_alpha);
 	// we are always using rgba
 	_depth = 4;
 	if (_data == nullptr) {
@@ -91,6 +211,24 @@ bool Image::load(const uint8_t* buffer, int length) {
 		Log::debug("Failed to load image %s: unsupported format", _name.c_str());
 		return false;
 	}
+	if (cache) {
+		const size_t size = (size_t)_width * _height * _depth;
+		uint8_t *pixels = (uint8_t *)core_malloc(size);
+		core_memcpy(pixels, _data, size);
+		const int w = _width;
+		const int h = _height;
+		const int d = _depth;
+		// the cache entry is written in the background to not slow down the first start
+		const std::future<void>& future = app::App::getInstance()->threadPool().enqueue([=] () {
+			if (!ImageCache::store(cacheKey, pixels, w, h, d)) {
+				Log::debug("Failed to write image cache entry %s", cacheKey.c_str());
+			}
+			core_free(pixels);
+		});
+		if (!future.valid()) {
+			core_free(pixels);
+		}
+	}
 	Log::debug("Loaded image %s", _name.c_str());
 	_state = io::IOSTATE_LOADED;
 	return true;
@@ -121,6 +259,25 @@ bool Image::writePng(const char *name, const uint8_t* buffer, int width, int hei
 	return stbi_write_png(name, width, height, depth, (const void*)buffer, width * depth) != 0;
 }
 
+std::future<bool> Image::writePngAsync(const core::String& name, const uint8_t* buffer, int width, int height, int depth) {
+	const size_t size = (size_t)width * height * depth;
+	uint8_t *pixels = (uint8_t *)core_malloc(size);
+	core_memcpy(pixels, buffer, size);
+	std::future<bool> future = app::App::getInstance()->threadPool().enqueue([=] () {
+		core_trace_scoped(ImageWritePng);
+		const bool success = writePng(name.c_str(), pixels, width, height, depth);
+		if (!success) {
+			Log::warn("Failed to write image %s", name.c_str());
+		}
+		core_free(pixels);
+		return success;
+	});
+	if (!future.valid()) {
+		core_free(pixels);
+	}
+	return future;
+}
+
 bool Image::writePng() const {
 	if (_state != io::IOSTATE_LOADED) {
 		return false;
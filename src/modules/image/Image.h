@@ -7,6 +7,7 @@
 #include "io/IOResource.h"
 #include "io/File.h"
 #include "core/SharedPtr.h"
+#include <future>
 
 namespace image {
 
@@ -25,11 +26,25 @@ public:
 	Image(const core::String& name);
 	~Image();
 
+	/**
+	 * @brief Loads the image from the memory mapped file - or from the @c ImageCache if the file was
+	 * already decoded before
+	 */
 	bool load(const io::FilePtr& file);
 	bool load(const uint8_t* buffer, int length);
 
+	/**
+	 * @brief Only reads the header of the image file - the image is not decoded
+	 * @param[out] components The amount of components in the file - the loaded image is always rgba
+	 */
+	static bool readInfo(const io::FilePtr& file, int& width, int& height, int& components);
+
 	static void flipVerticalRGBA(uint8_t *pixels, int w, int h);
 	static bool writePng(const char *name, const uint8_t *buffer, int width, int height, int depth);
+	/**
+	 * @brief Encodes and writes the png in the thread pool of the application. The buffer is copied.
+	 */
+	static std::future<bool> writePngAsync(const core::String& name, const uint8_t *buffer, int width, int height, int depth);
 	bool writePng() const;
 
 	const uint8_t* at(int x, int y) const;
@@ -62,6 +77,11 @@ inline ImagePtr createEmptyImage(const core::String& name) {
 	return core::make_shared<Image>(name);
 }
 
+/**
+ * @brief Loads the image - requesting an image that is already being loaded returns the same instance
+ * @note A synchronous request for an image that is loaded asynchronously loads the image again to not wait
+ * for the thread pool
+ */
 extern ImagePtr loadImage(const io::FilePtr& file, bool async = true);
 extern ImagePtr loadImage(const core::String& filename, bool async = true);
 
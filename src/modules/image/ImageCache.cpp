@@ -0,0 +1,191 @@
+/**
+ * @file
+ */
+
+#include "ImageCache.h"
+#include "core/Algorithm.h"
+#include "core/ByteStream.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/StringUtil.h"
+#include "core/Trace.h"
+#include "core/Var.h"
+#include "core/Zip.h"
+#include "app/App.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Lock.h"
+#include "io/Filesystem.h"
+#include "io/MappedFile.h"
+
+namespace image {
+
+namespace {
+constexpr uint32_t CacheMagic = FourCC('I', 'M', 'G', 'C');
+constexpr uint32_t CacheVersion = 2u;
+constexpr size_t CacheHeaderSize = 6u * sizeof(uint32_t);
+const char *CacheDir = "imagecache/";
+
+/**
+ * @brief The size of all entries - only the first store lists the cache directory to get it
+ */
+struct CacheSize {
+	core::Lock lock {"ImageCacheSize"};
+	bool known = false;
+	uint64_t bytes = 0u;
+};
+
+CacheSize& cacheSize() {
+	static CacheSize size;
+	return size;
+}
+
+uint64_t listEntries(core::DynamicArray<io::Filesystem::DirEntry>& entries) {
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	filesystem->list(filesystem->homePath() + CacheDir, entries);
+	uint64_t total = 0u;
+	for (const io::Filesystem::DirEntry& entry : entries) {
+		if (entry.type == io::Filesystem::DirEntry::Type::file) {
+			total += entry.size;
+		}
+	}
+	return total;
+}
+
+}
+
+bool ImageCache::enabled() {
+	return core::Var::get("image_cache", "true", -1, "Cache the decoded images on disk")->boolVal();
+}
+
+core::String ImageCache::key(const uint8_t *source, size_t length) {
+	core_trace_scoped(ImageCacheKey);
+	// two differently seeded 32 bit hashes - a collision would serve the wrong image
+	const uint32_t lo = core::hash(source, (int)length);
+	const uint32_t hi = core::hash(source, (int)length, 0x9e3779b9u);
+	return core::string::format("%08x%08x%08x", hi, lo, (uint32_t)length);
+}
+
+size_t ImageCache::maxSize() {
+	const int megabytes = core::Var::get("image_cachesize", "64", -1, "Max size of the on-disk image cache in megabytes")->intVal();
+	return (size_t)core_max(0, megabytes) * 1024u * 1024u;
+}
+
+size_t ImageCache::lowWaterMark() {
+	return maxSize() / 4u * 3u;
+}
+
+void ImageCache::evict(size_t maxBytes) {
+	core_trace_scoped(ImageCacheEvict);
+	CacheSize& size = cacheSize();
+	core::ScopedLock lock(size.lock);
+	core::DynamicArray<io::Filesystem::DirEntry> entries;
+	uint64_t total = listEntries(entries);
+	size.known = true;
+	size.bytes = total;
+	if (total <= maxBytes) {
+		return;
+	}
+	core::DynamicArray<const io::Filesystem::DirEntry*> files;
+	files.reserve(entries.size());
+	for (const io::Filesystem::DirEntry& entry : entries) {
+		if (entry.type == io::Filesystem::DirEntry::Type::file) {
+			files.push_back(&entry);
+		}
+	}
+	// the oldest entries are removed first
+	core::sort(files.begin(), files.end(), [] (const io::Filesystem::DirEntry* a, const io::Filesystem::DirEntry* b) {
+		return a->mtime < b->mtime;
+	});
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	const core::String& dir = filesystem->homePath() + CacheDir;
+	for (const io::Filesystem::DirEntry* e : files) {
+		if (total <= maxBytes) {
+			break;
+		}
+		const core::String& path = dir + e->name;
+		Log::debug("Evict image cache entry %s", path.c_str());
+		if (filesystem->removeFile(path)) {
+			total -= e->size;
+		}
+	}
+	size.bytes = total;
+}
+
+uint8_t *ImageCache::load(const core::String &key, int &width, int &height, int &depth) {
+	core_trace_scoped(ImageCacheLoad);
+	const io::MappedFile file(io::filesystem()->homePath() + CacheDir + key);
+	if (!file.valid() || file.size() < CacheHeaderSize) {
+		return nullptr;
+	}
+	core::ByteStream stream = core::ByteStream::view(file.data(), file.size());
+	const uint32_t magic = stream.readInt();
+	const uint32_t version = stream.readInt();
+	const int w = stream.readInt();
+	const int h = stream.readInt();
+	const int d = stream.readInt();
+	const uint32_t size = stream.readInt();
+	if (magic != CacheMagic || version != CacheVersion || w <= 0 || h <= 0 || d <= 0
+			|| (uint64_t)w * (uint64_t)h * (uint64_t)d != size) {
+		Log::debug("Invalid image cache entry %s", key.c_str());
+		return nullptr;
+	}
+	uint8_t *pixels = (uint8_t *)core_malloc(size);
+	size_t uncompressed = 0u;
+	if (!core::zip::uncompress(stream.getBuffer(), stream.getSize(), pixels, size, &uncompressed)
+			|| uncompressed != size) {
+		Log::debug("Failed to uncompress image cache entry %s", key.c_str());
+		core_free(pixels);
+		return nullptr;
+	}
+	width = w;
+	height = h;
+	depth = d;
+	return pixels;
+}
+
+bool ImageCache::store(const core::String &key, const uint8_t *pixels, int width, int height, int depth) {
+	core_trace_scoped(ImageCacheStore);
+	const uint32_t size = (uint32_t)width * (uint32_t)height * (uint32_t)depth;
+	core::ByteStream stream((int)(CacheHeaderSize + core::zip::compressBound(size)));
+	stream.addInt(CacheMagic);
+	stream.addInt(CacheVersion);
+	stream.addInt(width);
+	stream.addInt(height);
+	stream.addInt(depth);
+	stream.addInt(size);
+	const size_t bound = core::zip::compressBound(size);
+	size_t compressed = 0u;
+	if (!core::zip::compressor().compress(pixels, size, stream.writeBuffer(bound), bound, &compressed,
+			core::zip::BestSpeed)) {
+		Log::debug("Failed to compress image cache entry %s", key.c_str());
+		return false;
+	}
+	stream.commit(compressed);
+	if (!io::filesystem()->write(CacheDir + key, stream.getBuffer(), stream.getSize())) {
+		Log::debug("Failed to write image cache entry %s", key.c_str());
+		return false;
+	}
+	bool full;
+	{
+		CacheSize& size = cacheSize();
+		core::ScopedLock lock(size.lock);
+		if (!size.known) {
+			// the listing already contains the new entry
+			core::DynamicArray<io::Filesystem::DirEntry> entries;
+			size.bytes = listEntries(entries);
+			size.known = true;
+		} else {
+			size.bytes += stream.getSize();
+		}
+		full = size.bytes > maxSize();
+	}
+	if (full) {
+		// make some room to not evict again with the next store
+		evict(lowWaterMark());
+	}
+	return true;
+}
+
+}
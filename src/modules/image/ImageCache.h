@@ -0,0 +1,57 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include <stdint.h>
+#include <stddef.h>
+
+namespace image {
+
+/**
+ * @brief On-disk cache of decoded images
+ *
+ * The decoded pixels are stored compressed in the home directory. The entries are keyed by the hash of the
+ * encoded source data - a modified image file just gets a new entry, there is no invalidation needed. The
+ * oldest entries are evicted down to the @c lowWaterMark() once the cache grows beyond @c image_cachesize megabytes.
+ *
+ * Can be disabled with the @c image_cache cvar.
+ */
+class ImageCache {
+public:
+	/**
+	 * @brief Images with less encoded data are decoded faster than the cache entry could be loaded
+	 */
+	static constexpr size_t MinSourceSize = 4096u;
+
+	static bool enabled();
+
+	/**
+	 * @return The cache key for the encoded image data - a 64 bit hash and the length of the data
+	 */
+	static core::String key(const uint8_t *source, size_t length);
+
+	/**
+	 * @return The max size of the cache in bytes as configured by the @c image_cachesize cvar
+	 */
+	static size_t maxSize();
+	/**
+	 * @return The size in bytes the cache is reduced to once a store exceeds @c maxSize()
+	 */
+	static size_t lowWaterMark();
+	/**
+	 * @brief Removes the oldest entries until the cache doesn't exceed the given size
+	 * @note Lists the cache directory - @c store() only calls this if the tracked size exceeds @c maxSize()
+	 */
+	static void evict(size_t maxBytes);
+
+	/**
+	 * @return The decoded pixels - allocated with @c core_malloc() - or @c nullptr if there is no valid cache entry
+	 */
+	static uint8_t *load(const core::String &key, int &width, int &height, int &depth);
+	static bool store(const core::String &key, const uint8_t *pixels, int width, int height, int depth);
+};
+
+}
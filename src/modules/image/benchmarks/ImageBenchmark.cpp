@@ -0,0 +1,87 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "image/Image.h"
+#include "image/ImageCache.h"
+#include "core/Var.h"
+#include "core/collection/Buffer.h"
+#include "io/Filesystem.h"
+#include <thread>
+#include <chrono>
+
+/**
+ * @brief Compares the cold start (decoding the image) with the warm start (loading the decoded pixels from
+ * the image cache)
+ */
+class ImageBenchmark : public app::AbstractBenchmark {
+protected:
+	static constexpr int Size = 512;
+	io::FilePtr _file;
+public:
+	bool onInitApp() override {
+		core::Buffer<uint8_t> pixels;
+		pixels.resize(Size * Size * 4);
+		uint32_t seed = 1337u;
+		for (int y = 0; y < Size; ++y) {
+			for (int x = 0; x < Size; ++x) {
+				seed = seed * 1664525u + 1013904223u;
+				uint8_t *p = &pixels[(y * Size + x) * 4];
+				// gradients with a bit of noise - compresses like a texture
+				p[0] = (uint8_t)x;
+				p[1] = (uint8_t)y;
+				p[2] = (uint8_t)((x ^ y) + (seed >> 29));
+				p[3] = 255u;
+			}
+		}
+		const core::String path = io::filesystem()->homePath() + "imagebenchmark.png";
+		if (!image::Image::writePng(path.c_str(), pixels.data(), Size, Size, 4)) {
+			return false;
+		}
+		_file = io::filesystem()->open(path, io::FileMode::SysRead);
+		return true;
+	}
+
+	void onCleanupApp() override {
+		_file = io::FilePtr();
+	}
+};
+
+BENCHMARK_DEFINE_F(ImageBenchmark, LoadCold)(benchmark::State &state) {
+	core::Var::get("image_cache", "true")->setVal(false);
+	for (auto _ : state) {
+		image::Image img(_file->name());
+		benchmark::DoNotOptimize(img.load(_file));
+	}
+	core::Var::get("image_cache", "true")->setVal(true);
+}
+
+BENCHMARK_DEFINE_F(ImageBenchmark, LoadWarm)(benchmark::State &state) {
+	core::Var::get("image_cache", "true")->setVal(true);
+	{
+		image::Image img(_file->name());
+		img.load(_file);
+	}
+	// wait for the cache entry that is written in the background
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	for (auto _ : state) {
+		image::Image img(_file->name());
+		benchmark::DoNotOptimize(img.load(_file));
+	}
+}
+
+BENCHMARK_DEFINE_F(ImageBenchmark, ReadInfo)(benchmark::State &state) {
+	int width;
+	int height;
+	int components;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(image::Image::readInfo(_file, width, height, components));
+	}
+}
+
+BENCHMARK_REGISTER_F(ImageBenchmark, LoadCold);
+BENCHMARK_REGISTER_F(ImageBenchmark, LoadWarm);
+BENCHMARK_REGISTER_F(ImageBenchmark, ReadInfo);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,204 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "image/Image.h"
+#include "image/ImageCache.h"
+#include "core/StandardLib.h"
+#include "core/Var.h"
+#include "io/Filesystem.h"
+#include <thread>
+#include <chrono>
+
+namespace image {
+
+class ImageTest : public app::AbstractTest {
+protected:
+	static constexpr int Width = 128;
+	static constexpr int Height = 64;
+	uint8_t _pixels[Width * Height * 4];
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		uint32_t seed = 1337u;
+		for (size_t i = 0u; i < sizeof(_pixels); ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			_pixels[i] = (uint8_t)(seed >> 24);
+		}
+	}
+
+	io::FilePtr writeTestImage(const char *name, int depth = 4) {
+		const core::String path = io::filesystem()->homePath() + name;
+		EXPECT_TRUE(Image::writePng(path.c_str(), _pixels, Width, Height, depth));
+		return io::filesystem()->open(path, io::FileMode::SysRead);
+	}
+};
+
+TEST_F(ImageTest, testReadInfo) {
+	const io::FilePtr& file = writeTestImage("imagetest-info.png", 3);
+	int width = 0;
+	int height = 0;
+	int components = 0;
+	ASSERT_TRUE(Image::readInfo(file, width, height, components));
+	EXPECT_EQ(Width, width);
+	EXPECT_EQ(Height, height);
+	EXPECT_EQ(3, components);
+}
+
+TEST_F(ImageTest, testLoad) {
+	core::Var::get("image_cache", "true")->setVal(false);
+	const io::FilePtr& file = writeTestImage("imagetest-load.png");
+	const ImagePtr& img = loadImage(file, false);
+	ASSERT_TRUE(img->isLoaded());
+	EXPECT_EQ(Width, img->width());
+	EXPECT_EQ(Height, img->height());
+	EXPECT_EQ(4, img->depth());
+	EXPECT_EQ(0, core_memcmp(_pixels, img->data(), sizeof(_pixels)));
+	core::Var::get("image_cache", "true")->setVal(true);
+}
+
+TEST_F(ImageTest, testLoadMissingFile) {
+	const ImagePtr& img = loadImage(io::filesystem()->open("imagetest-does-not-exist.png"), false);
+	EXPECT_TRUE(img->isFailed());
+}
+
+TEST_F(ImageTest, testCacheRoundTrip) {
+	const core::String& key = ImageCache::key(_pixels, sizeof(_pixels));
+	ASSERT_TRUE(ImageCache::store(key, _pixels, Width, Height, 4));
+	int width = 0;
+	int height = 0;
+	int depth = 0;
+	uint8_t *pixels = ImageCache::load(key, width, height, depth);
+	ASSERT_NE(nullptr, pixels);
+	EXPECT_EQ(Width, width);
+	EXPECT_EQ(Height, height);
+	EXPECT_EQ(4, depth);
+	EXPECT_EQ(0, core_memcmp(_pixels, pixels, sizeof(_pixels)));
+	core_free(pixels);
+}
+
+TEST_F(ImageTest, testCacheKey) {
+	const core::String& key1 = ImageCache::key(_pixels, sizeof(_pixels));
+	const core::String& key2 = ImageCache::key(_pixels, sizeof(_pixels) - 1);
+	_pixels[0]++;
+	const core::String& key3 = ImageCache::key(_pixels, sizeof(_pixels));
+	EXPECT_NE(key1, key2);
+	EXPECT_NE(key1, key3);
+}
+
+TEST_F(ImageTest, testCacheEvict) {
+	const core::String& key = ImageCache::key(_pixels, sizeof(_pixels));
+	ASSERT_TRUE(ImageCache::store(key, _pixels, Width, Height, 4));
+	int width = 0;
+	int height = 0;
+	int depth = 0;
+	ImageCache::evict(ImageCache::maxSize());
+	uint8_t *pixels = ImageCache::load(key, width, height, depth);
+	ASSERT_NE(nullptr, pixels) << "The entry must survive if the cache doesn't exceed the limit";
+	core_free(pixels);
+	ImageCache::evict(0u);
+	EXPECT_EQ(nullptr, ImageCache::load(key, width, height, depth));
+}
+
+TEST_F(ImageTest, testCacheStoreEvictsToLowWaterMark) {
+	const core::VarPtr& cacheSize = core::Var::get("image_cachesize", "64");
+	const core::String oldCacheSize = cacheSize->strVal();
+	cacheSize->setVal(1);
+	ImageCache::evict(0u);
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	const core::String& dir = filesystem->homePath() + "imagecache/";
+	// the random pixels don't compress - every entry is a little bit larger than the pixels
+	const int maxEntries = (int)(ImageCache::maxSize() / sizeof(_pixels));
+	core::String firstKey;
+	core::String lastKey;
+	int stored = 0;
+	for (; stored <= maxEntries; ++stored) {
+		_pixels[0] = (uint8_t)stored;
+		_pixels[1] = (uint8_t)(stored >> 8);
+		lastKey = ImageCache::key(_pixels, sizeof(_pixels));
+		if (stored == 0) {
+			firstKey = lastKey;
+		}
+		ASSERT_TRUE(ImageCache::store(lastKey, _pixels, Width, Height, 4));
+		if (!filesystem->exists(dir + firstKey)) {
+			break;
+		}
+	}
+	ASSERT_LE(stored, maxEntries) << "The oldest entry should be evicted once the cache exceeds the limit";
+	EXPECT_GE((stored + 1) * sizeof(_pixels), ImageCache::lowWaterMark()) << "Evicted before the cache was full";
+
+	core::DynamicArray<io::Filesystem::DirEntry> listing;
+	filesystem->list(dir, listing);
+	uint64_t total = 0u;
+	for (const io::Filesystem::DirEntry& entry : listing) {
+		total += entry.size;
+	}
+	EXPECT_LE(total, ImageCache::lowWaterMark()) << "Expected to evict down to the low-water mark";
+
+	int width = 0;
+	int height = 0;
+	int depth = 0;
+	uint8_t *pixels = ImageCache::load(lastKey, width, height, depth);
+	EXPECT_NE(nullptr, pixels) << "The newest entry should survive";
+	core_free(pixels);
+
+	ImageCache::evict(0u);
+	cacheSize->setVal(oldCacheSize);
+}
+
+TEST_F(ImageTest, testCacheInvalidEntry) {
+	const core::String& key = ImageCache::key(_pixels, 16);
+	ASSERT_TRUE(io::filesystem()->write("imagecache/" + key, "no image cache entry"));
+	int width = 0;
+	int height = 0;
+	int depth = 0;
+	EXPECT_EQ(nullptr, ImageCache::load(key, width, height, depth));
+	EXPECT_EQ(nullptr, ImageCache::load("missing", width, height, depth));
+}
+
+TEST_F(ImageTest, testLoadFromCache) {
+	const io::FilePtr& file = writeTestImage("imagetest-cache.png");
+	core::String key;
+	{
+		const io::FilePtr& f = io::filesystem()->open(file->name(), io::FileMode::SysRead);
+		const core::String& content = f->load();
+		key = ImageCache::key((const uint8_t*)content.c_str(), content.size());
+	}
+	const core::String& cachePath = "imagecache/" + key;
+	const ImagePtr& decoded = loadImage(file, false);
+	ASSERT_TRUE(decoded->isLoaded());
+	// the cache entry is written by the thread pool
+	for (int i = 0; i < 500 && !io::filesystem()->exists(io::filesystem()->homePath() + cachePath); ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	int width = 0;
+	int height = 0;
+	int depth = 0;
+	uint8_t *pixels = ImageCache::load(key, width, height, depth);
+	ASSERT_NE(nullptr, pixels) << "No cache entry was written";
+	core_free(pixels);
+
+	const ImagePtr& cached = loadImage(file, false);
+	ASSERT_TRUE(cached->isLoaded());
+	EXPECT_EQ(Width, cached->width());
+	EXPECT_EQ(Height, cached->height());
+	EXPECT_EQ(0, core_memcmp(decoded->data(), cached->data(), sizeof(_pixels)));
+}
+
+TEST_F(ImageTest, testWritePngAsync) {
+	const core::String path = io::filesystem()->homePath() + "imagetest-async.png";
+	std::future<bool> future = Image::writePngAsync(path, _pixels, Width, Height, 4);
+	ASSERT_TRUE(future.valid());
+	// the buffer was copied
+	core_memset(_pixels, 0, sizeof(_pixels));
+	ASSERT_TRUE(future.get());
+	int width = 0;
+	int height = 0;
+	int components = 0;
+	ASSERT_TRUE(Image::readInfo(io::filesystem()->open(path, io::FileMode::SysRead), width, height, components));
+	EXPECT_EQ(Width, width);
+	EXPECT_EQ(Height, height);
+}
+
+}
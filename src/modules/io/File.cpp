@@ -6,6 +6,7 @@
 #include "core/Log.h"
 #include "core/StringUtil.h"
 #include <SDL.h>
+#include <uv.h>
 
 namespace io {
 
@@ -131,6 +132,17 @@ long File::length() const {
 	return end;
 }
 
+uint64_t File::mtime() const {
+	uv_fs_t req;
+	if (uv_fs_stat(nullptr, &req, _rawPath.c_str(), nullptr) != 0) {
+		uv_fs_req_cleanup(&req);
+		return 0u;
+	}
+	const uv_timespec_t& time = uv_fs_get_statbuf(&req)->st_mtim;
+	uv_fs_req_cleanup(&req);
+	return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
 int File::read(void **buffer) {
 	*buffer = nullptr;
 	const long len = length();
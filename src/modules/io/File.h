@@ -64,6 +64,11 @@ public:
 	 * @return -1 on error, otherwise the length of the file
 	 */
 	long length() const;
+	/**
+	 * @return The last modification time of the file in nanoseconds - or @c 0 if the file doesn't exist.
+	 * @note The resolution depends on the filesystem and might be much coarser
+	 */
+	uint64_t mtime() const;
 	/**
 	 * @return The extension of the file - or en ampty string
 	 * if no extension was found
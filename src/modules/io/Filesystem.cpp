@@ -9,6 +9,8 @@
 #include "core/Common.h"
 #include "core/StringUtil.h"
 #include "core/GameConfig.h"
+#include "core/Trace.h"
+#include "core/concurrent/ThreadPool.h"
 #include "engine-config.h"
 #include <SDL.h>
 #ifndef __WINDOWS__
@@ -18,6 +20,19 @@
 
 namespace io {
 
+static bool closeFileWatchHandle(uv_fs_event_t* fshandle) {
+	uv_fs_event_stop(fshandle);
+	uv_handle_t* handle = (uv_handle_t*)fshandle;
+	if (uv_handle_get_type(handle) == UV_UNKNOWN_HANDLE) {
+		return false;
+	}
+	if (uv_is_closing(handle)) {
+		return true;
+	}
+	uv_close(handle, [](uv_handle_t *handle) { delete (uv_fs_event_t*)handle; });
+	return true;
+}
+
 Filesystem::~Filesystem() {
 	shutdown();
 }
@@ -29,6 +44,7 @@ bool Filesystem::init(const core::String& organisation, const core::String& appn
 
 	_loop = new uv_loop_t;
 	uv_loop_init(_loop);
+	_loopThread = std::this_thread::get_id();
 
 	char *path = SDL_GetBasePath();
 	if (path == nullptr) {
@@ -73,6 +89,7 @@ bool Filesystem::removeFile(const core::String& file) const {
 	if (file.empty()) {
 		return false;
 	}
+	invalidateList(file);
 	uv_fs_t req;
 	return uv_fs_unlink(_loop, &req, file.c_str(), nullptr) == 0;
 }
@@ -83,6 +100,7 @@ bool Filesystem::removeDir(const core::String& dir, bool recursive) const {
 	}
 
 	if (!recursive) {
+		invalidateList(dir);
 		uv_fs_t req;
 		return uv_fs_rmdir(_loop, &req, dir.c_str(), nullptr) == 0;
 	}
@@ -94,6 +112,7 @@ bool Filesystem::createDir(const core::String& dir, bool recursive) const {
 	if (dir.empty()) {
 		return false;
 	}
+	invalidateList(dir);
 
 	if (!recursive) {
 		uv_fs_t req;
@@ -137,6 +156,11 @@ bool Filesystem::createDir(const core::String& dir, bool recursive) const {
 	return lastResult;
 }
 
+static uint64_t statMTime(const uv_fs_t& statsReq) {
+	const uv_timespec_t& time = statsReq.statbuf.st_mtim;
+	return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
 bool Filesystem::_list(const core::String& directory, core::DynamicArray<DirEntry>& entities, const core::String& filter) {
 	uv_fs_t req;
 	const int amount = uv_fs_scandir(nullptr, &req, directory.c_str(), 0, nullptr);
@@ -179,7 +203,7 @@ bool Filesystem::_list(const core::String& directory, core::DynamicArray<DirEntr
 				continue;
 			}
 			const bool dir = (uv_fs_get_statbuf(&statsReq)->st_mode & S_IFDIR) != 0;
-			entities.push_back(DirEntry{ent.name, dir ? DirEntry::Type::dir : DirEntry::Type::file, statsReq.statbuf.st_size});
+			entities.push_back(DirEntry{ent.name, dir ? DirEntry::Type::dir : DirEntry::Type::file, statsReq.statbuf.st_size, statMTime(statsReq)});
 			uv_fs_req_cleanup(&statsReq);
 		} else {
 			Log::debug("Unknown directory entry found: %s", ent.name);
@@ -195,25 +219,283 @@ bool Filesystem::_list(const core::String& directory, core::DynamicArray<DirEntr
 		if (uv_fs_stat(nullptr, &statsReq, fullPath.c_str(), nullptr) != 0) {
 			Log::warn("Could not stat file %s", fullPath.c_str());
 		}
-		entities.push_back(DirEntry{ent.name, type, statsReq.statbuf.st_size});
+		entities.push_back(DirEntry{ent.name, type, statsReq.statbuf.st_size, statMTime(statsReq)});
 		uv_fs_req_cleanup(&statsReq);
 	}
 	uv_fs_req_cleanup(&req);
 	return true;
 }
 
+void Filesystem::ScanResult::clear() {
+	entries.clear();
+	paths.clear();
+}
+
+void Filesystem::ScanResult::add(const core::String& path, DirEntry::Type type, uint64_t size) {
+	entries.push_back(Entry{(uint32_t)paths.size(), type, size});
+	paths.append(path.c_str(), path.size() + 1);
+}
+
+/**
+ * @brief Directory cache key - the trailing separator is stripped
+ */
+static core::String listCacheKey(const core::String& directory) {
+	size_t len = directory.size();
+	while (len > 1u && directory[len - 1u] == '/') {
+		--len;
+	}
+	return directory.substr(0, len);
+}
+
+void Filesystem::onListChanged(uv_fs_event_t *handle, const char *filename, int events, int status) {
+	Filesystem* fs = (Filesystem*)handle->data;
+	char path[1024];
+	size_t size = sizeof(path) - 1;
+	if (uv_fs_event_getpath(handle, path, &size) != 0) {
+		return;
+	}
+	path[size] = '\0';
+	Log::debug("Directory %s changed", path);
+	core::ScopedLock lock(fs->_listLock);
+	uv_fs_event_t* current = nullptr;
+	if (!fs->_listWatches.get(path, current) || current != handle) {
+		// the watch was already dropped and is queued to get closed in update()
+		return;
+	}
+	fs->_listCache.remove(path);
+	fs->_listWatches.remove(path);
+	closeFileWatchHandle(handle);
+}
+
+void Filesystem::invalidateList(const core::String& path) const {
+	core::ScopedLock lock(_listLock);
+	if (_listCache.empty()) {
+		return;
+	}
+	if (isRelativePath(path)) {
+		// we don't know which of the cached directories is affected
+		_clearListCache();
+		return;
+	}
+	// the entry itself if it's a directory, and the directory it is listed in
+	const core::String& key = listCacheKey(path);
+	const core::String& parent = listCacheKey(core::string::extractPath(key));
+	for (const core::String& dir : {key, parent}) {
+		uv_fs_event_t* handle = nullptr;
+		if (_listWatches.get(dir, handle)) {
+			_closeListWatches.push_back(handle);
+			_listWatches.remove(dir);
+		}
+		_listCache.remove(dir);
+	}
+}
+
+void Filesystem::clearListCache() {
+	core::ScopedLock lock(_listLock);
+	_clearListCache();
+}
+
+void Filesystem::_clearListCache() const {
+	for (const auto& e : _listWatches) {
+		_closeListWatches.push_back(e->value);
+	}
+	_listWatches.clear();
+	_listCache.clear();
+}
+
+bool Filesystem::cachedList(const core::String& directory, core::DynamicArray<DirEntry>& entities, const core::String& filter) const {
+	const core::String& key = listCacheKey(directory);
+	{
+		core::ScopedLock lock(_listLock);
+		auto i = _listCache.find(key);
+		if (i != _listCache.end()) {
+			for (const DirEntry& e : i->value) {
+				if (filter.empty() || core::string::matches(filter, e.name)) {
+					entities.push_back(e);
+				}
+			}
+			return true;
+		}
+	}
+
+	core::DynamicArray<DirEntry> listing;
+	if (!_list(directory, listing)) {
+		return false;
+	}
+	for (const DirEntry& e : listing) {
+		if (filter.empty() || core::string::matches(filter, e.name)) {
+			entities.push_back(e);
+		}
+	}
+
+	// the watches can only be registered on the thread that runs the event loop
+	if (_loop == nullptr || std::this_thread::get_id() != _loopThread) {
+		return true;
+	}
+	core::ScopedLock lock(_listLock);
+	if ((int)_listCache.size() >= MaxListCacheSize) {
+		return true;
+	}
+	uv_fs_event_t* fsEvent = new uv_fs_event_t;
+	if (uv_fs_event_init(_loop, fsEvent) != 0) {
+		delete fsEvent;
+		return true;
+	}
+	fsEvent->data = (void*)this;
+	if (uv_fs_event_start(fsEvent, onListChanged, key.c_str(), 0U) != 0) {
+		if (!closeFileWatchHandle(fsEvent)) {
+			delete fsEvent;
+		}
+		return true;
+	}
+	_listWatches.put(key, fsEvent);
+	_listCache.put(key, listing);
+	return true;
+}
+
 bool Filesystem::list(const core::String& directory, core::DynamicArray<DirEntry>& entities, const core::String& filter) const {
+	core_trace_scoped(FilesystemList);
 	if (isRelativePath(directory)) {
 		for (const core::String& p : _paths) {
-			_list(p + directory, entities, filter);
+			cachedList(p + directory, entities, filter);
 		}
 	} else {
-		_list(directory, entities, filter);
+		cachedList(directory, entities, filter);
+	}
+	return true;
+}
+
+bool Filesystem::_scan(const core::String& root, const core::String& directory, ScanResult& result, core::DynamicArray<core::String>& dirs, const core::String& filter) {
+	uv_fs_t req;
+	const core::String& fullDir = root + directory;
+	if (uv_fs_scandir(nullptr, &req, fullDir.c_str(), 0, nullptr) < 0) {
+		uv_fs_req_cleanup(&req);
+		return false;
+	}
+	uv_dirent_t ent;
+	core_memset(&ent, 0, sizeof(ent));
+	while (uv_fs_scandir_next(&req, &ent) != UV_EOF) {
+		const core::String& path = directory + ent.name;
+		const bool matches = filter.empty() || core::string::matches(filter, ent.name);
+		if (ent.type == UV_DIRENT_DIR) {
+			dirs.push_back(path + "/");
+			if (matches) {
+				result.add(path, DirEntry::Type::dir, 0u);
+			}
+			continue;
+		}
+		if (!matches && ent.type == UV_DIRENT_FILE) {
+			// filtered before the stat call
+			continue;
+		}
+		uv_fs_t statsReq;
+		const core::String& fullPath = root + path;
+		if (uv_fs_stat(nullptr, &statsReq, fullPath.c_str(), nullptr) != 0) {
+			Log::debug("Could not stat file %s", fullPath.c_str());
+			uv_fs_req_cleanup(&statsReq);
+			continue;
+		}
+		const bool dir = (uv_fs_get_statbuf(&statsReq)->st_mode & S_IFDIR) != 0;
+		const uint64_t size = uv_fs_get_statbuf(&statsReq)->st_size;
+		uv_fs_req_cleanup(&statsReq);
+		if (dir && ent.type == UV_DIRENT_UNKNOWN) {
+			// some filesystems don't report the type - but symlinks are not followed
+			dirs.push_back(path + "/");
+		}
+		if (matches) {
+			result.add(path, dir ? DirEntry::Type::dir : DirEntry::Type::file, dir ? 0u : size);
+		}
 	}
+	uv_fs_req_cleanup(&req);
 	return true;
 }
 
+bool Filesystem::scan(core::ThreadPool& threadPool, const core::String& directory, ScanResult& result, const core::String& filter) {
+	core_trace_scoped(FilesystemScan);
+	// directories per task - scanning a directory is cheap compared to the task overhead
+	constexpr size_t DirsPerTask = 8u;
+	struct Chunk {
+		ScanResult result;
+		core::DynamicArray<core::String> dirs;
+	};
+
+	core::String root = directory;
+	if (!root.empty() && root.last() != '/') {
+		root += '/';
+	}
+	core::DynamicArray<core::String> level;
+	if (!_scan(root, "", result, level, filter)) {
+		return false;
+	}
+	core::DynamicArray<core::String> next;
+	core::DynamicArray<Chunk> chunks;
+	core::DynamicArray<std::future<void>> futures;
+	while (!level.empty()) {
+		const size_t chunkCount = (level.size() + DirsPerTask - 1u) / DirsPerTask;
+		chunks.clear();
+		chunks.resize(chunkCount);
+		futures.clear();
+		for (size_t c = 0u; c < chunkCount; ++c) {
+			auto func = [&, c] () {
+				Chunk& chunk = chunks[c];
+				const size_t end = core_min((c + 1u) * DirsPerTask, level.size());
+				for (size_t i = c * DirsPerTask; i < end; ++i) {
+					_scan(root, level[i], chunk.result, chunk.dirs, filter);
+				}
+			};
+			if (chunkCount == 1u) {
+				func();
+				continue;
+			}
+			std::future<void> future = threadPool.enqueue(func);
+			if (!future.valid()) {
+				// the pool is shut down
+				func();
+				continue;
+			}
+			futures.emplace_back(core::move(future));
+		}
+		for (std::future<void>& future : futures) {
+			future.wait();
+		}
+
+		size_t entries = result.entries.size();
+		size_t paths = result.paths.size();
+		next.clear();
+		for (const Chunk& chunk : chunks) {
+			entries += chunk.result.entries.size();
+			paths += chunk.result.paths.size();
+		}
+		result.entries.reserve(entries);
+		result.paths.reserve(paths);
+		for (const Chunk& chunk : chunks) {
+			const uint32_t offset = (uint32_t)result.paths.size();
+			for (const ScanResult::Entry& e : chunk.result.entries) {
+				result.entries.push_back(ScanResult::Entry{e.path + offset, e.type, e.size});
+			}
+			result.paths.append(chunk.result.paths.data(), chunk.result.paths.size());
+			for (const core::String& dir : chunk.dirs) {
+				next.push_back(dir);
+			}
+		}
+		level = core::move(next);
+	}
+	return true;
+}
+
+void Filesystem::closeListWatches() {
+	core::DynamicArray<uv_fs_event_t*> handles;
+	{
+		core::ScopedLock lock(_listLock);
+		handles = core::move(_closeListWatches);
+	}
+	for (uv_fs_event_t* handle : handles) {
+		closeFileWatchHandle(handle);
+	}
+}
+
 void Filesystem::update() {
+	closeListWatches();
 	uv_run(_loop, UV_RUN_NOWAIT);
 }
 
@@ -222,6 +504,8 @@ bool Filesystem::chdir(const core::String& directory) {
 }
 
 void Filesystem::shutdown() {
+	clearListCache();
+	closeListWatches();
 	for (const auto& e : _watches) {
 		uv_fs_event_stop(e->value);
 	}
@@ -294,19 +578,6 @@ bool Filesystem::registerPath(const core::String& path) {
 	return true;
 }
 
-static bool closeFileWatchHandle(uv_fs_event_t* fshandle) {
-	uv_fs_event_stop(fshandle);
-	uv_handle_t* handle = (uv_handle_t*)fshandle;
-	if (uv_handle_get_type(handle) == UV_UNKNOWN_HANDLE) {
-		return false;
-	}
-	if (uv_is_closing(handle)) {
-		return true;
-	}
-	uv_close(handle, [](uv_handle_t *handle) { delete (uv_fs_event_t*)handle; });
-	return true;
-}
-
 bool Filesystem::unwatch(const core::String& path) {
 	auto i = _watches.find(path);
 	if (i == _watches.end()) {
@@ -439,6 +710,7 @@ bool Filesystem::write(const core::String& filename, const uint8_t* content, siz
 	const core::String& fullPath = _homePath + filename;
 	const core::String path(core::string::extractPath(fullPath.c_str()));
 	createDir(path, true);
+	invalidateList(fullPath);
 	io::File f(fullPath, FileMode::Write);
 	return f.write(content, length) == static_cast<long>(length);
 }
@@ -451,6 +723,7 @@ bool Filesystem::write(const core::String& filename, const core::String& string)
 bool Filesystem::syswrite(const core::String& filename, const uint8_t* content, size_t length) const {
 	io::File f(filename, FileMode::SysWrite);
 	createDir(f.path());
+	invalidateList(filename);
 	return f.write(content, length) == static_cast<long>(length);
 }
 
@@ -6,11 +6,15 @@
 
 #include "File.h"
 #include "core/String.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/Stack.h"
 #include "core/collection/StringMap.h"
 #include "core/Common.h"
+#include "core/Trace.h"
+#include "core/concurrent/Lock.h"
 #include <memory>
+#include <thread>
 #include <stdarg.h>
 #include <SDL_stdinc.h>
 
@@ -20,6 +24,10 @@ typedef struct uv_fs_event_s uv_fs_event_t;
 struct uv_loop_s;
 typedef struct uv_loop_s uv_loop_t;
 
+namespace core {
+class ThreadPool;
+}
+
 namespace io {
 
 struct FileWatcher {
@@ -50,6 +58,78 @@ private:
 	core::Stack<core::String, 32> _dirStack;
 	core::StringMap<uv_fs_event_t*> _watches;
 	uv_loop_t *_loop = nullptr;
+	std::thread::id _loopThread;
+
+public:
+	struct DirEntry {
+		core::String name;
+		enum class Type : uint8_t {
+			file,
+			dir,
+			unknown
+		};
+		Type type;
+		uint64_t size;
+		/**
+		 * @brief Modification time in nanoseconds - see @c File::mtime()
+		 */
+		uint64_t mtime = 0u;
+	};
+
+	/**
+	 * @brief Compact result of a recursive directory scan
+	 *
+	 * The paths are relative to the scanned directory and are stored zero terminated in one pool - there is
+	 * no allocation per entry.
+	 */
+	struct ScanResult {
+		struct Entry {
+			/**
+			 * @brief Offset of the path in the pool
+			 */
+			uint32_t path;
+			DirEntry::Type type;
+			uint64_t size;
+		};
+		core::Buffer<Entry, 4096> entries;
+		core::Buffer<char, 65536> paths;
+
+		inline const char *path(const Entry& entry) const {
+			return paths.data() + entry.path;
+		}
+		inline size_t size() const {
+			return entries.size();
+		}
+		inline bool empty() const {
+			return entries.empty();
+		}
+		void clear();
+		void add(const core::String& path, DirEntry::Type type, uint64_t size);
+	};
+
+	/**
+	 * @brief Amount of directories whose listing is kept in memory
+	 */
+	static constexpr int MaxListCacheSize = 512;
+
+private:
+	/**
+	 * The unfiltered listings of the directories that were given to list() - each cached directory is
+	 * watched and dropped from the cache once it changes. The events are delivered in update().
+	 */
+	mutable core::StringMap<core::DynamicArray<DirEntry>> _listCache;
+	mutable core::StringMap<uv_fs_event_t*> _listWatches;
+	/**
+	 * The libuv handles are not thread safe - the watches that are dropped on other threads are closed in update()
+	 */
+	mutable core::DynamicArray<uv_fs_event_t*> _closeListWatches;
+	core_trace_mutex(mutable core::Lock, _listLock, "ListCache");
+
+	static void onListChanged(uv_fs_event_t *handle, const char *filename, int events, int status);
+	bool cachedList(const core::String& directory, core::DynamicArray<DirEntry>& entities, const core::String& filter) const;
+	void invalidateList(const core::String& path) const;
+	void _clearListCache() const;
+	void closeListWatches();
 
 public:
 	~Filesystem();
@@ -90,18 +170,28 @@ public:
 
 	bool exists(const core::String& filename) const;
 
-	struct DirEntry {
-		core::String name;
-		enum class Type : uint8_t {
-			file,
-			dir,
-			unknown
-		};
-		Type type;
-		uint64_t size;
-	};
-
+	/**
+	 * @brief Lists the entries of the given directory in all registered paths
+	 *
+	 * The listings are cached and kept coherent by watching the directories. Changes that are not done via this
+	 * class are picked up in update().
+	 */
 	bool list(const core::String& directory, core::DynamicArray<DirEntry>& entities, const core::String& filter = "") const;
+	/**
+	 * @brief Drop all cached directory listings
+	 */
+	void clearListCache();
+
+	/**
+	 * @brief Recursively collects all entries below the given directory
+	 *
+	 * The sub directories of each level are scanned in parallel. The filter is applied while scanning - only the
+	 * matching entries are stat'ed and stored - but all directories are descended into. Symlinked directories are
+	 * not followed.
+	 *
+	 * @note Don't call this from a task of the given thread pool
+	 */
+	static bool scan(core::ThreadPool& threadPool, const core::String& directory, ScanResult& result, const core::String& filter = "");
 
 	static bool isReadableDir(const core::String& name);
 	static bool isRelativePath(const core::String& name);
@@ -152,6 +242,7 @@ public:
 	bool removeDir(const core::String& dir, bool recursive = false) const;
 	bool removeFile(const core::String& file) const;
 private:
+	static bool _scan(const core::String& root, const core::String& directory, ScanResult& result, core::DynamicArray<core::String>& dirs, const core::String& filter);
 	static bool _list(const core::String& directory, core::DynamicArray<DirEntry>& entities, const core::String& filter = "");
 };
 
@@ -0,0 +1,115 @@
+/**
+ * @file
+ */
+
+#include "MappedFile.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include <SDL.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+MappedFile::MappedFile(const core::String& path) {
+	if (!map(path) && !read(path)) {
+		Log::debug("Failed to open %s", path.c_str());
+	}
+}
+
+MappedFile::~MappedFile() {
+	if (_data == nullptr) {
+		return;
+	}
+	if (!_mapped) {
+		core_free(_data);
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle((HANDLE)_mapping);
+	CloseHandle((HANDLE)_file);
+#else
+	munmap(_data, _size);
+#endif
+}
+
+bool MappedFile::map(const core::String& path) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		return false;
+	}
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	_file = file;
+	_mapping = mapping;
+	_data = (uint8_t *)data;
+	_size = (size_t)size.QuadPart;
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return false;
+	}
+	void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after the descriptor is closed
+	close(fd);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+	_data = (uint8_t *)data;
+	_size = (size_t)st.st_size;
+#endif
+	_mapped = true;
+	return true;
+}
+
+bool MappedFile::read(const core::String& path) {
+	SDL_RWops *rwops = SDL_RWFromFile(path.c_str(), "rb");
+	if (rwops == nullptr) {
+		return false;
+	}
+	const Sint64 size = SDL_RWsize(rwops);
+	if (size <= 0) {
+		SDL_RWclose(rwops);
+		return false;
+	}
+	uint8_t *data = (uint8_t *)core_malloc((size_t)size);
+	if (SDL_RWread(rwops, data, 1, (size_t)size) != (size_t)size) {
+		core_free(data);
+		SDL_RWclose(rwops);
+		return false;
+	}
+	SDL_RWclose(rwops);
+	_data = data;
+	_size = (size_t)size;
+	return true;
+}
+
+}
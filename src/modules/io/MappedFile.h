@@ -0,0 +1,66 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/NonCopyable.h"
+#include <stdint.h>
+#include <stddef.h>
+
+namespace io {
+
+/**
+ * @brief Read-only view of the content of a file
+ *
+ * The file is mapped into memory - the pages are only read from the disk if they are accessed, and nothing is
+ * copied into a heap buffer. If the platform doesn't support mapping the file, the content is read into memory.
+ *
+ * @note Use the path of an already resolved @c io::File (see @c io::File::name())
+ */
+class MappedFile : public core::NonCopyable {
+private:
+	uint8_t *_data = nullptr;
+	size_t _size = 0u;
+	bool _mapped = false;
+#ifdef _WIN32
+	void *_file = nullptr;
+	void *_mapping = nullptr;
+#endif
+
+	bool map(const core::String& path);
+	bool read(const core::String& path);
+public:
+	explicit MappedFile(const core::String& path);
+	~MappedFile();
+
+	/**
+	 * @return @c false if the file couldn't be opened or is empty
+	 */
+	bool valid() const;
+	/**
+	 * @return @c true if the data is memory mapped and not read into a heap buffer
+	 */
+	bool mapped() const;
+	const uint8_t *data() const;
+	size_t size() const;
+};
+
+inline bool MappedFile::valid() const {
+	return _data != nullptr;
+}
+
+inline bool MappedFile::mapped() const {
+	return _mapped;
+}
+
+inline const uint8_t *MappedFile::data() const {
+	return _data;
+}
+
+inline size_t MappedFile::size() const {
+	return _size;
+}
+
+}
@@ -0,0 +1,128 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "app/App.h"
+#include "core/StringUtil.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/ThreadPool.h"
+#include "io/Filesystem.h"
+#include <SDL_rwops.h>
+#include <thread>
+
+/**
+ * @brief Lists and scans a synthetic tree of 100k files
+ *
+ * The tree is created once in the home directory and reused by later runs.
+ */
+class FilesystemBenchmark : public app::AbstractBenchmark {
+protected:
+	static constexpr int TopDirs = 100;
+	static constexpr int SubDirs = 10;
+	static constexpr int Files = 100;
+	core::String _root;
+	core::DynamicArray<core::String> _leafDirs;
+
+	bool createTree() {
+		const io::FilesystemPtr& fs = io::filesystem();
+		const core::String marker = _root + "complete";
+		if (fs->open(marker, io::FileMode::SysRead)->exists()) {
+			return true;
+		}
+		Log::info("Creating %i files in %s", TopDirs * SubDirs * Files, _root.c_str());
+		for (const core::String& dir : _leafDirs) {
+			if (!fs->createDir(dir)) {
+				return false;
+			}
+			for (int f = 0; f < Files; ++f) {
+				// every 100th file is a script - used for the filtered scan
+				const char *ext = f == 0 ? "lua" : "vox";
+				const core::String& file = core::string::format("%sfile%03i.%s", dir.c_str(), f, ext);
+				SDL_RWops *rwops = SDL_RWFromFile(file.c_str(), "wb");
+				if (rwops == nullptr) {
+					return false;
+				}
+				SDL_RWwrite(rwops, file.c_str(), 1, file.size());
+				SDL_RWclose(rwops);
+			}
+		}
+		return fs->syswrite(marker, "1");
+	}
+public:
+	bool onInitApp() override {
+		_root = io::filesystem()->homePath() + "scanbenchmark/";
+		for (int t = 0; t < TopDirs; ++t) {
+			for (int s = 0; s < SubDirs; ++s) {
+				_leafDirs.push_back(core::string::format("%sdir%03i/sub%02i/", _root.c_str(), t, s));
+			}
+		}
+		return createTree();
+	}
+
+	void onCleanupApp() override {
+		_leafDirs.clear();
+	}
+};
+
+BENCHMARK_DEFINE_F(FilesystemBenchmark, ListUncached)(benchmark::State &state) {
+	const io::FilesystemPtr& fs = io::filesystem();
+	core::DynamicArray<io::Filesystem::DirEntry> entities;
+	size_t i = 0;
+	for (auto _ : state) {
+		state.PauseTiming();
+		fs->clearListCache();
+		fs->update();
+		entities.clear();
+		state.ResumeTiming();
+		fs->list(_leafDirs[i++ % _leafDirs.size()], entities);
+		benchmark::DoNotOptimize(entities.size());
+	}
+}
+
+BENCHMARK_DEFINE_F(FilesystemBenchmark, ListCached)(benchmark::State &state) {
+	const io::FilesystemPtr& fs = io::filesystem();
+	core::DynamicArray<io::Filesystem::DirEntry> entities;
+	for (int i = 0; i < io::Filesystem::MaxListCacheSize; ++i) {
+		fs->list(_leafDirs[i], entities);
+	}
+	size_t i = 0;
+	for (auto _ : state) {
+		entities.clear();
+		fs->list(_leafDirs[i++ % io::Filesystem::MaxListCacheSize], entities);
+		benchmark::DoNotOptimize(entities.size());
+	}
+	fs->clearListCache();
+	fs->update();
+}
+
+BENCHMARK_DEFINE_F(FilesystemBenchmark, Scan)(benchmark::State &state) {
+	core::ThreadPool threadPool(state.range(0), "scan");
+	threadPool.init();
+	io::Filesystem::ScanResult result;
+	for (auto _ : state) {
+		result.clear();
+		io::Filesystem::scan(threadPool, _root, result);
+	}
+	state.counters["entries"] = (double)result.size();
+	threadPool.shutdown();
+}
+
+BENCHMARK_DEFINE_F(FilesystemBenchmark, ScanFiltered)(benchmark::State &state) {
+	core::ThreadPool threadPool(state.range(0), "scan");
+	threadPool.init();
+	io::Filesystem::ScanResult result;
+	for (auto _ : state) {
+		result.clear();
+		io::Filesystem::scan(threadPool, _root, result, "*.lua");
+	}
+	state.counters["entries"] = (double)result.size();
+	threadPool.shutdown();
+}
+
+BENCHMARK_REGISTER_F(FilesystemBenchmark, ListUncached);
+BENCHMARK_REGISTER_F(FilesystemBenchmark, ListCached);
+BENCHMARK_REGISTER_F(FilesystemBenchmark, Scan)->Arg(1)->Arg(std::thread::hardware_concurrency())->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(FilesystemBenchmark, ScanFiltered)->Arg(1)->Arg(std::thread::hardware_concurrency())->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -18,4 +18,13 @@ TEST_F(FileTest, testGetPath) {
 	ASSERT_FALSE(file->exists());
 }
 
+TEST_F(FileTest, testMTime) {
+	io::Filesystem fs;
+	fs.init("test", "test");
+	EXPECT_EQ(0u, fs.open("foobar/1.txt", io::FileMode::Read)->mtime());
+	ASSERT_TRUE(fs.write("filetest-mtime.txt", "foo"));
+	EXPECT_NE(0u, fs.open("filetest-mtime.txt", io::FileMode::Read)->mtime());
+	fs.shutdown();
+}
+
 }
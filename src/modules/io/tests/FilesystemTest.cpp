@@ -6,7 +6,11 @@
 #include "io/Filesystem.h"
 #include "core/Enum.h"
 #include "core/Algorithm.h"
+#include "core/StringUtil.h"
 #include "core/tests/TestHelper.h"
+#include "core/concurrent/ThreadPool.h"
+#include <SDL_timer.h>
+#include <thread>
 
 namespace io {
 
@@ -148,4 +152,100 @@ TEST_F(FilesystemTest, testCreateDirNonRecursiveFail) {
 	fs.shutdown();
 }
 
+TEST_F(FilesystemTest, testListCacheWrite) {
+	io::Filesystem fs;
+	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
+	EXPECT_TRUE(fs.createDir("listcachetest"));
+	EXPECT_TRUE(fs.syswrite("listcachetest/file1", "1"));
+	core::DynamicArray<io::Filesystem::DirEntry> entities;
+	fs.list("listcachetest/", entities);
+	EXPECT_EQ(1u, entities.size()) << entities;
+	EXPECT_TRUE(fs.syswrite("listcachetest/file2", "2"));
+	entities.clear();
+	fs.list("listcachetest/", entities);
+	EXPECT_EQ(2u, entities.size()) << entities;
+	EXPECT_TRUE(fs.removeFile("listcachetest/file2"));
+	entities.clear();
+	fs.list("listcachetest/", entities);
+	EXPECT_EQ(1u, entities.size()) << entities;
+	fs.shutdown();
+}
+
+TEST_F(FilesystemTest, testListCacheWriteFromOtherThread) {
+	io::Filesystem fs;
+	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
+	const core::String& dir = fs.homePath() + "listcachethread";
+	EXPECT_TRUE(fs.createDir(dir));
+	fs.removeFile(dir + "/file");
+	core::DynamicArray<io::Filesystem::DirEntry> entities;
+	// registers the watch on the loop thread
+	fs.list(dir, entities);
+	const size_t before = entities.size();
+	// the watch is only dropped here - it's closed on the loop thread in update()
+	std::thread writer([&fs] () { EXPECT_TRUE(fs.write("listcachethread/file", "1")); });
+	writer.join();
+	fs.update();
+	entities.clear();
+	fs.list(dir, entities);
+	EXPECT_EQ(before + 1u, entities.size()) << entities;
+	fs.removeFile(dir + "/file");
+	fs.shutdown();
+}
+
+TEST_F(FilesystemTest, testListCacheExternalChange) {
+	io::Filesystem fs;
+	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
+	EXPECT_TRUE(fs.createDir("listcacheexternal"));
+	const core::String& dir = fs.absolutePath("listcacheexternal");
+	ASSERT_NE("", dir);
+	const core::String& filename = dir + "/external";
+	fs.removeFile(filename);
+	core::DynamicArray<io::Filesystem::DirEntry> entities;
+	fs.list(dir, entities);
+	const size_t before = entities.size();
+	// bypass the filesystem - the change is only noticed by the directory watch
+	const io::FilePtr& file = fs.open(filename, io::FileMode::SysWrite);
+	EXPECT_EQ(1, file->write((const uint8_t*)"1", 1));
+	file->close();
+	for (int i = 0; i < 100 && entities.size() == before; ++i) {
+		SDL_Delay(10);
+		fs.update();
+		entities.clear();
+		fs.list(dir, entities);
+	}
+	EXPECT_EQ(before + 1u, entities.size()) << entities;
+	fs.removeFile(filename);
+	fs.shutdown();
+}
+
+TEST_F(FilesystemTest, testScan) {
+	io::Filesystem fs;
+	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
+	for (int d = 0; d < 20; ++d) {
+		EXPECT_TRUE(fs.createDir(core::string::format("scantest/dir%i/sub", d)));
+		for (int f = 0; f < 5; ++f) {
+			const core::String& name = core::string::format("scantest/dir%i/sub/file%i.%s", d, f, f == 0 ? "lua" : "txt");
+			EXPECT_TRUE(fs.syswrite(name, "123"));
+		}
+	}
+	core::ThreadPool threadPool(2, "scan");
+	threadPool.init();
+	io::Filesystem::ScanResult result;
+	ASSERT_TRUE(io::Filesystem::scan(threadPool, "scantest", result));
+	// 20 dirs, 20 sub dirs, 100 files
+	EXPECT_EQ(140u, result.size());
+
+	result.clear();
+	ASSERT_TRUE(io::Filesystem::scan(threadPool, "scantest/", result, "*.lua"));
+	ASSERT_EQ(20u, result.size());
+	for (const io::Filesystem::ScanResult::Entry& e : result.entries) {
+		EXPECT_EQ(io::Filesystem::DirEntry::Type::file, e.type);
+		EXPECT_EQ(3u, e.size);
+		EXPECT_TRUE(core::string::endsWith(result.path(e), "/sub/file0.lua")) << result.path(e);
+	}
+	EXPECT_FALSE(io::Filesystem::scan(threadPool, "scantest/doesnotexist", result));
+	threadPool.shutdown();
+	fs.shutdown();
+}
+
 }
@@ -0,0 +1,34 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "io/Filesystem.h"
+#include "io/MappedFile.h"
+
+namespace io {
+
+class MappedFileTest: public testing::Test {
+};
+
+TEST_F(MappedFileTest, testMap) {
+	io::Filesystem fs;
+	ASSERT_TRUE(fs.init("test", "test"));
+	const core::String content = "mapped file content";
+	ASSERT_TRUE(fs.write("mappedfiletest.txt", content));
+	const io::FilePtr& file = fs.open(fs.homePath() + "mappedfiletest.txt", io::FileMode::SysRead);
+	ASSERT_TRUE(file->exists());
+	MappedFile mapped(file->name());
+	ASSERT_TRUE(mapped.valid());
+	ASSERT_EQ(content.size(), mapped.size());
+	EXPECT_EQ(0, SDL_memcmp(content.c_str(), mapped.data(), content.size()));
+	fs.shutdown();
+}
+
+TEST_F(MappedFileTest, testMissingFile) {
+	MappedFile mapped("does-not-exist.txt");
+	EXPECT_FALSE(mapped.valid());
+	EXPECT_EQ(0u, mapped.size());
+}
+
+}
@@ -5,11 +5,10 @@
 #pragma once
 
 #include <vector>
-#include <list>
-#include <algorithm>
-#include <iterator>
+#include <type_traits>
 #include "AABB.h"
 #include "Frustum.h"
+#include "core/Assert.h"
 #include "core/Trace.h"
 #include <glm/vec3.hpp>
 
@@ -18,12 +17,23 @@ namespace math {
 extern math::AABB<int> computeAABB(const Frustum& area, const glm::vec3& gridSize);
 
 /**
+ * @brief Loose octree with a flat node pool
+ *
+ * The nodes are stored in one array and are linked by index - the eight children of a node are
+ * allocated as one consecutive block. Each node keeps its items together with the bounds they were
+ * inserted with in contiguous arrays. Removing an item swaps it with the last item of the node.
+ *
+ * The loose bounds of a node are the node bounds grown by half of the node size in each direction.
+ * An item is put into the deepest node that contains the item center and whose loose bounds contain
+ * the whole item. Leaves are only split once they hold @c MaxLeafItems items. This allows to move an item with @c update() without relocating it as long as it
+ * doesn't leave the loose bounds of its node.
+ *
  * @note Given NODE type must implement @c aabb() and return math::AABB<TYPE>
  */
 template<class NODE, typename TYPE = int>
 class Octree {
 public:
-	typedef typename std::list<NODE> Contents;
+	typedef typename std::vector<NODE> Contents;
 
 	class OctreeNode;
 	struct IOctreeListener {
@@ -97,45 +107,28 @@ public:
 			result[7] = AABB<TYPE>(mins7, maxs7);
 		}
 
-		int _maxDepth;
+		AABB<TYPE> _aabb;
+		AABB<TYPE> _looseAABB;
 		int _depth;
-		const Octree* _octree;
-		const AABB<TYPE> _aabb;
+		int _parent;
+		// index of the first of the eight children in the node pool or -1 for a leaf
+		int _children = -1;
+		// amount of items in this node and all of its children
+		int _count = 0;
 		Contents _contents;
-		std::vector<OctreeNode> _nodes;
-
-		template<class FUNC>
-		inline void visit(FUNC&& func) const {
-			core_trace_scoped(OctreeNodeVisit);
-			func(*this);
-			for (const OctreeNode& node : _nodes) {
-				node.visit(func);
-			}
-		}
-
-		void createNodes() {
-			core_trace_scoped(OctreeNodeCreateNodes);
-			if (_depth >= _maxDepth) {
-				return;
-			}
+		std::vector<AABB<TYPE>> _contentsAABB;
 
-			const auto& _aabb = aabb();
-			const glm::tvec3<TYPE>& _aabbSize = _aabb.getWidth();
-			const constexpr glm::tvec3<TYPE> one((TYPE)1);
-			if (_aabbSize.x <= one.x && _aabbSize.y <= one.y && _aabbSize.z <= one.z) {
-				return;
-			}
+		static AABB<TYPE> loose(const AABB<TYPE>& bounds) {
+			const glm::tvec3<TYPE> half = bounds.getWidth() / (TYPE)2;
+			return AABB<TYPE>(bounds.mins() - half, bounds.maxs() + half);
+		}
 
-			AABB<TYPE> subareas[8];
-			split(_aabb, subareas);
-			_nodes.reserve(8);
-			for (size_t i = 0u; i < 8; ++i) {
-				_nodes.emplace_back(OctreeNode(subareas[i], _maxDepth, _depth + 1, _octree));
-				if (_octree->_listener != nullptr) {
-					_octree->_listener->onNodeCreated(*this, _nodes.back());
-				}
-			}
+		int octant(const AABB<TYPE>& area) const {
+			const glm::tvec3<TYPE>& center = _aabb.getCenter();
+			const glm::tvec3<TYPE>& areaCenter = area.getCenter();
+			return (areaCenter.x >= center.x ? 4 : 0) | (areaCenter.y >= center.y ? 2 : 0) | (areaCenter.z >= center.z ? 1 : 0);
 		}
+
 	public:
 		static inline AABB<TYPE> aabb(const typename std::remove_pointer<NODE>::type* item) {
 			return item->aabb();
@@ -145,169 +138,342 @@ public:
 			return item.aabb();
 		}
 
-		OctreeNode(const AABB<TYPE>& bounds, int maxDepth, int depth, const Octree* octree) :
-				_maxDepth(maxDepth), _depth(depth), _octree(octree), _aabb(bounds) {
+		OctreeNode(const AABB<TYPE>& bounds, const AABB<TYPE>& looseBounds, int depth, int parent) :
+				_aabb(bounds), _looseAABB(looseBounds), _depth(depth), _parent(parent) {
 		}
 
 		inline int depth() const {
 			return _depth;
 		}
 
+		/**
+		 * @return The amount of items in this node and all of its children
+		 */
 		inline int count() const {
-			core_trace_scoped(OctreeNodeCount);
-			int count = 0;
-			for (const typename Octree<NODE, TYPE>::OctreeNode& node : _nodes) {
-				count += (int)node.count();
-			}
-			count += _contents.size();
-			return count;
+			return _count;
 		}
 
 		inline const AABB<TYPE>& aabb() const {
 			return _aabb;
 		}
 
+		/**
+		 * @brief The bounds that all items of this node and its children are contained in
+		 */
+		inline const AABB<TYPE>& looseAABB() const {
+			return _looseAABB;
+		}
+
+		/**
+		 * @return Only the items of this node - not those of the children
+		 */
 		inline const Contents& getContents() const {
 			return _contents;
 		}
 
-		void getAllContents(Contents& results) const {
-			core_trace_scoped(OctreeNodeGetAllContents);
-			for (const typename Octree<NODE, TYPE>::OctreeNode& node : _nodes) {
-				if (node.isEmpty()) {
-					continue;
-				}
-				node.getAllContents(results);
-			}
+		inline bool isLeaf() const {
+			return _children == -1;
+		}
 
-			// faster for list - but slower for vector
-			std::copy(_contents.begin(), _contents.end(), std::back_inserter(results));
+		inline bool hasContent() const {
+			return !_contents.empty();
 		}
 
-		bool remove(const NODE& item) {
-			core_trace_scoped(OctreeNodeRemove);
-			const AABB<TYPE>& area = aabb(item);
-			if (!aabb().containsAABB(area)) {
-				return false;
+		inline bool isEmpty() const {
+			return _count == 0;
+		}
+	};
+	/**
+	 * @brief A leaf is split into its eight children once it holds this amount of items
+	 */
+	static constexpr int MaxLeafItems = 8;
+private:
+	std::vector<OctreeNode> _nodes;
+	// the first nodes of the blocks of eight children that were released by collapse() and can be reused
+	std::vector<int> _freeBlocks;
+	int _maxDepth;
+	// dirty flag can be used for query caches
+	bool _dirty = false;
+	const IOctreeListener* _listener = nullptr;
+
+	bool canSplit(const OctreeNode& node) const {
+		if (node._depth >= _maxDepth) {
+			return false;
+		}
+		const glm::tvec3<TYPE>& size = node._aabb.getWidth();
+		const constexpr glm::tvec3<TYPE> one((TYPE)1);
+		return size.x > one.x || size.y > one.y || size.z > one.z;
+	}
+
+	void createNodes(int nodeIdx) {
+		core_trace_scoped(OctreeCreateNodes);
+		AABB<TYPE> subareas[8];
+		OctreeNode::split(_nodes[nodeIdx]._aabb, subareas);
+		const int depth = _nodes[nodeIdx]._depth + 1;
+		int children;
+		if (_freeBlocks.empty()) {
+			children = (int)_nodes.size();
+			for (int i = 0; i < 8; ++i) {
+				_nodes.emplace_back(subareas[i], OctreeNode::loose(subareas[i]), depth, nodeIdx);
 			}
-			for (typename Octree<NODE, TYPE>::OctreeNode& node : _nodes) {
-				if (!node.remove(item)) {
-					continue;
-				}
-				return true;
+		} else {
+			children = _freeBlocks.back();
+			_freeBlocks.pop_back();
+			for (int i = 0; i < 8; ++i) {
+				_nodes[children + i] = OctreeNode(subareas[i], OctreeNode::loose(subareas[i]), depth, nodeIdx);
 			}
-
-			typename Contents::iterator i = std::find(_contents.begin(), _contents.end(), item);
-			if (i == _contents.end()) {
-				return false;
+		}
+		_nodes[nodeIdx]._children = children;
+		if (_listener != nullptr) {
+			for (int i = 0; i < 8; ++i) {
+				_listener->onNodeCreated(_nodes[nodeIdx], _nodes[children + i]);
 			}
-			_contents.erase(i);
-			return true;
 		}
+	}
 
-		bool insert(const NODE& item) {
-			core_trace_scoped(OctreeNodeInsert);
-			const AABB<TYPE>& area = aabb(item);
-			if (!aabb().containsAABB(area)) {
-				return false;
+	/**
+	 * @brief Moves the items of the given leaf into the newly created children - as far as they fit
+	 */
+	void splitLeaf(int nodeIdx) {
+		core_trace_scoped(OctreeSplitLeaf);
+		createNodes(nodeIdx);
+		Contents contents;
+		std::vector<AABB<TYPE>> contentsAABB;
+		contents.swap(_nodes[nodeIdx]._contents);
+		contentsAABB.swap(_nodes[nodeIdx]._contentsAABB);
+		for (size_t i = 0; i < contents.size(); ++i) {
+			const AABB<TYPE>& area = contentsAABB[i];
+			OctreeNode& node = _nodes[nodeIdx];
+			const int childIdx = node._children + node.octant(area);
+			OctreeNode& child = _nodes[childIdx];
+			OctreeNode& target = child._looseAABB.containsAABB(area) ? child : node;
+			target._contents.push_back(contents[i]);
+			target._contentsAABB.push_back(area);
+			if (&target == &child) {
+				++child._count;
 			}
+		}
+	}
 
-			if (_nodes.empty()) {
-				createNodes();
+	/**
+	 * @brief Walks down the tree along the path that an item with the given bounds would be inserted into
+	 * @return The index of the deepest node on the path
+	 */
+	template<class FUNC>
+	int descend(const AABB<TYPE>& area, FUNC&& func) const {
+		int nodeIdx = 0;
+		for (;;) {
+			if (func(nodeIdx)) {
+				return nodeIdx;
 			}
-
-			for (typename Octree<NODE, TYPE>::OctreeNode& node : _nodes) {
-				if (!node.insert(item)) {
-					continue;
-				}
-				return true;
+			const OctreeNode& node = _nodes[nodeIdx];
+			if (node._children == -1) {
+				return nodeIdx;
 			}
-
-			_contents.push_back(item);
-			return true;
+			const int child = node._children + node.octant(area);
+			if (!_nodes[child]._looseAABB.containsAABB(area)) {
+				return nodeIdx;
+			}
+			nodeIdx = child;
 		}
+	}
 
-		inline bool isLeaf() const {
-			return _nodes.empty();
+	void addCount(int nodeIdx, int delta) {
+		for (; nodeIdx != -1; nodeIdx = _nodes[nodeIdx]._parent) {
+			_nodes[nodeIdx]._count += delta;
 		}
+	}
 
-		inline bool hasContent() const {
-			return !_contents.empty();
+	bool insert(const NODE& item, const AABB<TYPE>& area) {
+		if (!_nodes[0]._aabb.containsAABB(area)) {
+			return false;
 		}
-
-		inline bool isEmpty() const {
-			return isLeaf() && _contents.empty();
+		int nodeIdx = 0;
+		for (;;) {
+			if (_nodes[nodeIdx]._children == -1) {
+				// leaves are only split if they hold enough items
+				if ((int)_nodes[nodeIdx]._contents.size() < MaxLeafItems || !canSplit(_nodes[nodeIdx])) {
+					break;
+				}
+				splitLeaf(nodeIdx);
+			}
+			const OctreeNode& parent = _nodes[nodeIdx];
+			const int child = parent._children + parent.octant(area);
+			if (!_nodes[child]._looseAABB.containsAABB(area)) {
+				break;
+			}
+			nodeIdx = child;
 		}
+		OctreeNode& node = _nodes[nodeIdx];
+		node._contents.push_back(item);
+		node._contentsAABB.push_back(area);
+		addCount(nodeIdx, 1);
+		_dirty = true;
+		return true;
+	}
 
-		void query(const AABB<TYPE>& queryArea, Contents& results) const {
-			core_trace_scoped(OctreeNodeQueryAABB);
-			for (const NODE& item : _contents) {
-				if (intersects(queryArea, aabb(item))) {
-					results.push_back(item);
+	bool find(const NODE& item, int& nodeIdx, int& slot) {
+		auto findInNode = [&] (int idx) {
+			const Contents& contents = _nodes[idx]._contents;
+			for (size_t i = 0; i < contents.size(); ++i) {
+				if (contents[i] == item) {
+					nodeIdx = idx;
+					slot = (int)i;
+					return true;
 				}
 			}
+			return false;
+		};
+		const AABB<TYPE>& area = OctreeNode::aabb(item);
+		if (_nodes[0]._aabb.containsAABB(area)) {
+			const int idx = descend(area, findInNode);
+			if (nodeIdx == idx && slot != -1) {
+				return true;
+			}
+		}
+		// the bounds of the item were changed without calling update()
+		for (int idx = 0; idx < (int)_nodes.size(); ++idx) {
+			if (findInNode(idx)) {
+				return true;
+			}
+		}
+		return false;
+	}
 
-			for (const typename Octree<NODE, TYPE>::OctreeNode& node : _nodes) {
-				if (node.isEmpty()) {
-					continue;
-				}
+	/**
+	 * @brief Releases the children of the given node (and their children) for reuse
+	 * @note The children must not hold any items
+	 */
+	void collapse(int nodeIdx) {
+		const int children = _nodes[nodeIdx]._children;
+		for (int i = 0; i < 8; ++i) {
+			core_assert(_nodes[children + i]._count == 0);
+			if (_nodes[children + i]._children != -1) {
+				collapse(children + i);
+			}
+		}
+		_nodes[nodeIdx]._children = -1;
+		_freeBlocks.push_back(children);
+	}
 
-				const AABB<TYPE>& aabb = node.aabb();
-				if (aabb.containsAABB(queryArea)) {
-					node.query(queryArea, results);
-					// the queried area is completely part of the node - so no other node can be involved
-					break;
-				}
+	/**
+	 * @brief Whether the children of the node are split but don't hold any items anymore
+	 */
+	inline bool isCollapsible(int nodeIdx) const {
+		const OctreeNode& node = _nodes[nodeIdx];
+		return node._children != -1 && node._count == (int)node._contents.size();
+	}
 
-				if (queryArea.containsAABB(aabb)) {
-					node.getAllContents(results);
-					// the whole node content is part of the query
-					continue;
-				}
+	void removeAt(int nodeIdx, int slot) {
+		OctreeNode& node = _nodes[nodeIdx];
+		const int last = (int)node._contents.size() - 1;
+		if (slot != last) {
+			node._contents[slot] = node._contents[last];
+			node._contentsAABB[slot] = node._contentsAABB[last];
+		}
+		node._contents.pop_back();
+		node._contentsAABB.pop_back();
+		addCount(nodeIdx, -1);
+		_dirty = true;
 
-				if (intersects(aabb, queryArea)) {
-					node.query(queryArea, results);
-				}
-			}
+		// merge the empty leaves back into the topmost node whose children became empty
+		int collapseIdx = -1;
+		for (int idx = _nodes[nodeIdx]._children == -1 ? _nodes[nodeIdx]._parent : nodeIdx; idx != -1 && isCollapsible(idx); idx = _nodes[idx]._parent) {
+			collapseIdx = idx;
+		}
+		if (collapseIdx != -1) {
+			collapse(collapseIdx);
 		}
+	}
 
-		void query(const Frustum& queryArea, const AABB<TYPE>& queryAreaAABB, Contents& results) const {
-			core_trace_scoped(OctreeNodeQueryFrustum);
-			for (const NODE& item : _contents) {
-				const auto& itemAABB = aabb(item);
-				if (queryArea.isVisible(itemAABB.mins(), itemAABB.maxs())) {
-					results.push_back(item);
-				}
+	/**
+	 * @brief Checks whether an item with the given bounds would still be found in the given node
+	 */
+	bool isOnPath(int nodeIdx, const AABB<TYPE>& area) const {
+		if (!_nodes[nodeIdx]._looseAABB.containsAABB(area)) {
+			return false;
+		}
+		for (int idx = nodeIdx; _nodes[idx]._parent != -1; idx = _nodes[idx]._parent) {
+			const OctreeNode& parent = _nodes[_nodes[idx]._parent];
+			if (parent._children + parent.octant(area) != idx) {
+				return false;
 			}
+		}
+		return true;
+	}
 
-			for (const typename Octree<NODE, TYPE>::OctreeNode& node : _nodes) {
-				if (node.isEmpty()) {
-					continue;
-				}
+	template<class VISITOR>
+	void visitAll(int nodeIdx, VISITOR& visitor) const {
+		const OctreeNode& node = _nodes[nodeIdx];
+		for (const NODE& item : node._contents) {
+			visitor(item);
+		}
+		if (node._children == -1) {
+			return;
+		}
+		for (int i = 0; i < 8; ++i) {
+			if (_nodes[node._children + i]._count > 0) {
+				visitAll(node._children + i, visitor);
+			}
+		}
+	}
 
-				const AABB<TYPE>& aabb = node.aabb();
-				if (aabb.containsAABB(queryAreaAABB)) {
-					node.query(queryArea, queryAreaAABB, results);
-					// the queried area is completely part of the node - so no other node can be involved
-					break;
-				}
+	template<class VISITOR>
+	void query(int nodeIdx, const AABB<TYPE>& area, VISITOR& visitor) const {
+		const OctreeNode& node = _nodes[nodeIdx];
+		const size_t n = node._contents.size();
+		for (size_t i = 0; i < n; ++i) {
+			if (intersects(area, node._contentsAABB[i])) {
+				visitor(node._contents[i]);
+			}
+		}
+		if (node._children == -1) {
+			return;
+		}
+		for (int i = 0; i < 8; ++i) {
+			const int childIdx = node._children + i;
+			const OctreeNode& child = _nodes[childIdx];
+			if (child._count == 0 || !intersects(child._looseAABB, area)) {
+				continue;
+			}
+			if (area.containsAABB(child._looseAABB)) {
+				// the whole node content is part of the query
+				visitAll(childIdx, visitor);
+			} else {
+				query(childIdx, area, visitor);
+			}
+		}
+	}
 
-				const FrustumResult result = queryArea.test(aabb.mins(), aabb.maxs());
-				if (FrustumResult::Intersect == result) {
-					// some children might be visible - but other nodes might also still contribute
-					node.query(queryArea, queryAreaAABB, results);
-				} else if (FrustumResult::Inside == result) {
-					// the whole node content is part of the query
-					node.getAllContents(results);
-				}
+	template<class VISITOR>
+	void query(int nodeIdx, const Frustum& area, VISITOR& visitor) const {
+		const OctreeNode& node = _nodes[nodeIdx];
+		const size_t n = node._contents.size();
+		for (size_t i = 0; i < n; ++i) {
+			const AABB<TYPE>& itemAABB = node._contentsAABB[i];
+			if (area.isVisible(itemAABB.mins(), itemAABB.maxs())) {
+				visitor(node._contents[i]);
 			}
 		}
-	};
-private:
-	OctreeNode _root;
-	// dirty flag can be used for query caches
-	bool _dirty = false;
-	const IOctreeListener* _listener = nullptr;
+		if (node._children == -1) {
+			return;
+		}
+		for (int i = 0; i < 8; ++i) {
+			const int childIdx = node._children + i;
+			const OctreeNode& child = _nodes[childIdx];
+			if (child._count == 0) {
+				continue;
+			}
+			const FrustumResult result = area.test(child._looseAABB.mins(), child._looseAABB.maxs());
+			if (FrustumResult::Intersect == result) {
+				// some children might be visible - but other nodes might also still contribute
+				query(childIdx, area, visitor);
+			} else if (FrustumResult::Inside == result) {
+				// the whole node content is part of the query
+				visitAll(childIdx, visitor);
+			}
+		}
+	}
 
 	template<class VISITOR>
 	void visit(const Frustum& queryArea, const AABB<TYPE>& queryAABB, VISITOR&& visitor, const glm::vec<3, TYPE>& minSize) const {
@@ -335,46 +501,115 @@ private:
 
 public:
 	Octree(const AABB<TYPE>& aabb, int maxDepth = 10) :
-			_root(aabb, maxDepth, 0, this) {
+			_maxDepth(maxDepth) {
+		// the root node has no loose bounds - items must be completely inside the tree
+		_nodes.emplace_back(aabb, aabb, 0, -1);
 	}
 
 	inline int count() const {
-		core_trace_scoped(OctreeCount);
-		return _root.count();
+		return _nodes[0]._count;
+	}
+
+	/**
+	 * @return The amount of allocated nodes in the pool - nodes that were released because their items were
+	 * removed are reused for the next splits
+	 */
+	inline int nodes() const {
+		return (int)_nodes.size();
+	}
+
+	/**
+	 * @return The amount of nodes that are currently part of the tree
+	 */
+	inline int activeNodes() const {
+		return (int)(_nodes.size() - _freeBlocks.size() * 8u);
 	}
 
 	inline bool insert(const NODE& item) {
 		core_trace_scoped(OctreeInsert);
-		if (_root.insert(item)) {
-			_dirty = true;
-			return true;
-		}
-		return false;
+		return insert(item, OctreeNode::aabb(item));
 	}
 
 	inline bool remove(const NODE& item) {
 		core_trace_scoped(OctreeRemove);
-		if (_root.remove(item)) {
+		int nodeIdx = -1;
+		int slot = -1;
+		if (!find(item, nodeIdx, slot)) {
+			return false;
+		}
+		removeAt(nodeIdx, slot);
+		return true;
+	}
+
+	/**
+	 * @brief Moves the given item to the new bounds
+	 *
+	 * The item is only relocated in the tree if it leaves the loose bounds of its current node.
+	 * Call this before the item's @c aabb() returns the new bounds - otherwise the lookup of the
+	 * item falls back to a linear search.
+	 *
+	 * @return @c false if the item wasn't found or the new bounds are outside of the tree - the item is kept at
+	 * its old bounds in that case
+	 */
+	bool update(const NODE& item, const AABB<TYPE>& newAABB) {
+		core_trace_scoped(OctreeUpdate);
+		if (!_nodes[0]._aabb.containsAABB(newAABB)) {
+			return false;
+		}
+		int nodeIdx = -1;
+		int slot = -1;
+		if (!find(item, nodeIdx, slot)) {
+			return false;
+		}
+		if (isOnPath(nodeIdx, newAABB)) {
+			_nodes[nodeIdx]._contentsAABB[slot] = newAABB;
 			_dirty = true;
 			return true;
 		}
-		return false;
+		removeAt(nodeIdx, slot);
+		const bool inserted = insert(item, newAABB);
+		core_assert(inserted);
+		return inserted;
 	}
 
 	inline const AABB<TYPE>& aabb() const {
-		core_trace_scoped(OctreeAABB);
-		return _root.aabb();
+		return _nodes[0]._aabb;
 	}
 
-	inline void query(const AABB<TYPE>& area, Contents& results) const {
+	/**
+	 * @brief Calls the visitor for every item that intersects the given area. Nothing is allocated here.
+	 */
+	template<class VISITOR>
+	inline void query(const AABB<TYPE>& area, VISITOR&& visitor) const {
 		core_trace_scoped(OctreeQuery);
-		_root.query(area, results);
+		if (_nodes[0]._count == 0) {
+			return;
+		}
+		query(0, area, visitor);
 	}
 
-	inline void query(const Frustum& area, Contents& results) const {
+	/**
+	 * @brief Calls the visitor for every item that is visible in the given frustum. Nothing is allocated here.
+	 */
+	template<class VISITOR>
+	inline void query(const Frustum& area, VISITOR&& visitor) const {
 		core_trace_scoped(OctreeQuery);
-		const AABB<float>& areaAABB = area.aabb();
-		_root.query(area, AABB<TYPE>(areaAABB.mins(), areaAABB.maxs()), results);
+		if (_nodes[0]._count == 0) {
+			return;
+		}
+		query(0, area, visitor);
+	}
+
+	inline void query(const AABB<TYPE>& area, Contents& results) const {
+		query(area, [&] (const NODE& item) {
+			results.push_back(item);
+		});
+	}
+
+	inline void query(const Frustum& area, Contents& results) const {
+		query(area, [&] (const NODE& item) {
+			results.push_back(item);
+		});
 	}
 
 	/**
@@ -416,9 +651,13 @@ public:
 
 	void clear() {
 		_dirty = true;
-		_root._contents.clear();
-		_root._nodes.clear();
-		_root._nodes.reserve(4);
+		_nodes.erase(_nodes.begin() + 1, _nodes.end());
+		_freeBlocks.clear();
+		OctreeNode& root = _nodes[0];
+		root._contents.clear();
+		root._contentsAABB.clear();
+		root._children = -1;
+		root._count = 0;
 	}
 
 	inline void markAsClean() {
@@ -432,12 +671,32 @@ public:
 	inline void getContents(Contents& results) const {
 		results.clear();
 		results.reserve(count());
-		_root.getAllContents(results);
+		auto visitor = [&] (const NODE& item) {
+			results.push_back(item);
+		};
+		visitAll(0, visitor);
 	}
 
+	/**
+	 * @brief Visits all nodes of the tree - parents before their children
+	 */
 	template<class FUNC>
 	void visit(FUNC&& func) {
-		_root.visit(func);
+		visitNode(0, func);
+	}
+
+private:
+	template<class FUNC>
+	void visitNode(int nodeIdx, FUNC& func) const {
+		core_trace_scoped(OctreeNodeVisit);
+		const OctreeNode& node = _nodes[nodeIdx];
+		func(node);
+		if (node._children == -1) {
+			return;
+		}
+		for (int i = 0; i < 8; ++i) {
+			visitNode(node._children + i, func);
+		}
 	}
 };
 
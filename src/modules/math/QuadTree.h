@@ -118,7 +118,8 @@ private:
 			return _contents;
 		}
 
-		void getAllContents(Contents& results) const {
+		template<class RESULTS>
+		void getAllContents(RESULTS& results) const {
 			for (const QuadTreeNode& node : _nodes) {
 				if (node.isEmpty()) {
 					continue;
@@ -175,7 +176,8 @@ private:
 			return _nodes.empty() && _contents.empty();
 		}
 
-		void query(const Rect<TYPE>& queryArea, Contents& results) const {
+		template<class RESULTS>
+		void query(const Rect<TYPE>& queryArea, RESULTS& results) const {
 			for (const NODE& item : _contents) {
 				const Rect<TYPE>& area = rect(item);
 				if (queryArea.intersectsWith(area)) {
@@ -235,7 +237,12 @@ public:
 		return false;
 	}
 
-	inline void query(const Rect<TYPE>& area, Contents& results) const {
+	/**
+	 * @param[out] results Any container with @c push_back() - e.g. a @c core::DynamicArray with the
+	 * @c core::FrameArenaAllocator for per tick queries
+	 */
+	template<class RESULTS>
+	inline void query(const Rect<TYPE>& area, RESULTS& results) const {
 		core_trace_scoped(QuadTreeQuery);
 		_root.query(area, results);
 	}
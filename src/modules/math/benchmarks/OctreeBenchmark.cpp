@@ -0,0 +1,140 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "math/Octree.h"
+#include "math/Random.h"
+#include <glm/common.hpp>
+#include <vector>
+
+namespace {
+
+class Item {
+private:
+	math::AABB<int> _bounds;
+	int _id;
+public:
+	Item(const math::AABB<int>& bounds, int id) :
+			_bounds(bounds), _id(id) {
+	}
+
+	inline const math::AABB<int>& aabb() const {
+		return _bounds;
+	}
+
+	inline void setAABB(const math::AABB<int>& bounds) {
+		_bounds = bounds;
+	}
+
+	inline bool operator==(const Item& rhs) const {
+		return rhs._id == _id;
+	}
+};
+
+using Tree = math::Octree<Item*>;
+static const math::AABB<int> TreeBounds(0, 0, 0, 4096, 256, 4096);
+
+}
+
+class OctreeBenchmark : public app::AbstractBenchmark {
+protected:
+	std::vector<Item> _items;
+	math::Random _random {1};
+
+	void fill(Tree& tree, int amount) {
+		_items.clear();
+		_items.reserve(amount);
+		for (int i = 0; i < amount; ++i) {
+			const glm::ivec3 pos(_random.random(0, 4000), _random.random(0, 200), _random.random(0, 4000));
+			_items.emplace_back(math::AABB<int>(pos, pos + _random.random(1, 32)), i);
+		}
+		for (Item& item : _items) {
+			tree.insert(&item);
+		}
+	}
+
+	math::AABB<int> move(const Item& item) const {
+		const glm::ivec3 delta(_random.random(-4, 4), 0, _random.random(-4, 4));
+		const glm::ivec3 mins = glm::clamp(item.aabb().mins() + delta, glm::ivec3(0), glm::ivec3(4000, 200, 4000));
+		return math::AABB<int>(mins, mins + item.aabb().getWidth());
+	}
+};
+
+BENCHMARK_DEFINE_F(OctreeBenchmark, Insert) (benchmark::State& state) {
+	for (auto _ : state) {
+		Tree tree(TreeBounds);
+		fill(tree, (int)state.range(0));
+	}
+}
+
+BENCHMARK_DEFINE_F(OctreeBenchmark, QueryContents) (benchmark::State& state) {
+	Tree tree(TreeBounds);
+	fill(tree, (int)state.range(0));
+	const math::AABB<int> area(1000, 0, 1000, 1500, 256, 1500);
+	for (auto _ : state) {
+		Tree::Contents contents;
+		tree.query(area, contents);
+		benchmark::DoNotOptimize(contents.data());
+	}
+}
+
+BENCHMARK_DEFINE_F(OctreeBenchmark, QueryVisitor) (benchmark::State& state) {
+	Tree tree(TreeBounds);
+	fill(tree, (int)state.range(0));
+	const math::AABB<int> area(1000, 0, 1000, 1500, 256, 1500);
+	for (auto _ : state) {
+		int found = 0;
+		tree.query(area, [&] (Item*) {
+			++found;
+		});
+		benchmark::DoNotOptimize(found);
+	}
+}
+
+BENCHMARK_DEFINE_F(OctreeBenchmark, QueryFrustum) (benchmark::State& state) {
+	Tree tree(TreeBounds);
+	fill(tree, (int)state.range(0));
+	const math::Frustum frustum(glm::vec3(1000.0f, 0.0f, 1000.0f), glm::vec3(1500.0f, 256.0f, 1500.0f));
+	for (auto _ : state) {
+		int found = 0;
+		tree.query(frustum, [&] (Item*) {
+			++found;
+		});
+		benchmark::DoNotOptimize(found);
+	}
+}
+
+BENCHMARK_DEFINE_F(OctreeBenchmark, Update) (benchmark::State& state) {
+	Tree tree(TreeBounds);
+	fill(tree, (int)state.range(0));
+	for (auto _ : state) {
+		for (Item& item : _items) {
+			const math::AABB<int>& aabb = move(item);
+			tree.update(&item, aabb);
+			item.setAABB(aabb);
+		}
+	}
+}
+
+BENCHMARK_DEFINE_F(OctreeBenchmark, RemoveInsert) (benchmark::State& state) {
+	Tree tree(TreeBounds);
+	fill(tree, (int)state.range(0));
+	for (auto _ : state) {
+		for (Item& item : _items) {
+			const math::AABB<int>& aabb = move(item);
+			tree.remove(&item);
+			item.setAABB(aabb);
+			tree.insert(&item);
+		}
+	}
+}
+
+BENCHMARK_REGISTER_F(OctreeBenchmark, Insert)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_REGISTER_F(OctreeBenchmark, QueryContents)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_REGISTER_F(OctreeBenchmark, QueryVisitor)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_REGISTER_F(OctreeBenchmark, QueryFrustum)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_REGISTER_F(OctreeBenchmark, Update)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_REGISTER_F(OctreeBenchmark, RemoveInsert)->RangeMultiplier(4)->Range(256, 16384);
+
+BENCHMARK_MAIN();
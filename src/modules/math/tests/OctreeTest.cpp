@@ -9,6 +9,7 @@
 #include "core/Log.h"
 #include "core/GLM.h"
 #include "math/OctreeCache.h"
+#include "math/Random.h"
 #include <glm/gtc/round.hpp>
 
 namespace math {
@@ -27,6 +28,14 @@ public:
 		return _bounds;
 	}
 
+	void setAABB(const AABB<int>& bounds) {
+		_bounds = bounds;
+	}
+
+	int id() const {
+		return _id;
+	}
+
 	bool operator==(const Item& rhs) const {
 		return rhs._id == _id;
 	}
@@ -255,4 +264,156 @@ TEST_F(OctreeTest, testOctreeVisitOrthoFrustumNoPerfectMatchBigAndUneven) {
 	EXPECT_EQ(n, 18) << "Expected to get some bboxes not visited, because they are outside of the original frustum";
 }
 
+TEST_F(OctreeTest, testRemoveSwap) {
+	Octree<oc::Item, int> octree({0, 0, 0, 100, 100, 100}, 0);
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_TRUE(octree.insert({{i, i, i, i + 1, i + 1, i + 1}, i}));
+	}
+	EXPECT_EQ(1, octree.nodes()) << "Expected to have all items in the root node";
+	EXPECT_TRUE(octree.remove({{0, 0, 0, 1, 1, 1}, 0}));
+	EXPECT_FALSE(octree.remove({{0, 0, 0, 1, 1, 1}, 0}));
+	EXPECT_TRUE(octree.remove({{5, 5, 5, 6, 6, 6}, 5}));
+	EXPECT_EQ(8, octree.count());
+	Octree<oc::Item, int>::Contents contents;
+	octree.getContents(contents);
+	ASSERT_EQ(8u, contents.size());
+	for (const oc::Item& item : contents) {
+		EXPECT_NE(0, item.id());
+		EXPECT_NE(5, item.id());
+	}
+}
+
+TEST_F(OctreeTest, testQueryVisitor) {
+	Octree<oc::Item, int> octree({0, 0, 0, 128, 128, 128});
+	for (int i = 0; i < 64; ++i) {
+		const int p = i * 2;
+		EXPECT_TRUE(octree.insert({{p, p, p, p + 1, p + 1, p + 1}, i}));
+	}
+	int found = 0;
+	octree.query(AABB<int>(0, 0, 0, 15, 15, 15), [&] (const oc::Item& item) {
+		EXPECT_LT(item.id(), 8);
+		++found;
+	});
+	EXPECT_EQ(8, found);
+	found = 0;
+	octree.query(octree.aabb(), [&] (const oc::Item& item) {
+		++found;
+	});
+	EXPECT_EQ(64, found);
+}
+
+TEST_F(OctreeTest, testQueryFrustum) {
+	Octree<oc::Item, int> octree({0, 0, 0, 128, 128, 128});
+	EXPECT_TRUE(octree.insert({{10, 10, 10, 12, 12, 12}, 1}));
+	EXPECT_TRUE(octree.insert({{100, 100, 100, 102, 102, 102}, 2}));
+	const math::Frustum frustum(glm::vec3(0.0f), glm::vec3(50.0f));
+	Octree<oc::Item, int>::Contents contents;
+	octree.query(frustum, contents);
+	ASSERT_EQ(1u, contents.size());
+	EXPECT_EQ(1, contents[0].id());
+}
+
+TEST_F(OctreeTest, testUpdate) {
+	Octree<oc::Item, int> octree({0, 0, 0, 128, 128, 128}, 3);
+	oc::Item item({10, 10, 10, 12, 12, 12}, 1);
+	EXPECT_TRUE(octree.insert(item));
+	// force a split of the root node
+	for (int i = 0; i < Octree<oc::Item, int>::MaxLeafItems; ++i) {
+		EXPECT_TRUE(octree.insert({{100 + i, 100, 100, 102 + i, 102, 102}, 2 + i}));
+	}
+	const int count = octree.count();
+	const int nodes = octree.nodes();
+	ASSERT_GT(nodes, 1);
+
+	// a small move stays inside of the loose bounds of the node
+	const AABB<int> moved(11, 11, 11, 13, 13, 13);
+	EXPECT_TRUE(octree.update(item, moved));
+	item.setAABB(moved);
+	EXPECT_EQ(nodes, octree.nodes()) << "Expected to not relocate the item";
+	EXPECT_EQ(count, octree.count());
+
+	// a big move relocates the item
+	const AABB<int> relocated(90, 10, 90, 92, 12, 92);
+	EXPECT_TRUE(octree.update(item, relocated));
+	item.setAABB(relocated);
+	EXPECT_EQ(count, octree.count());
+	Octree<oc::Item, int>::Contents contents;
+	octree.query(AABB<int>(0, 0, 0, 20, 20, 20), contents);
+	EXPECT_TRUE(contents.empty()) << "The item was moved away";
+	octree.query(relocated, contents);
+	ASSERT_EQ(1u, contents.size());
+	EXPECT_EQ(1, contents[0].id());
+
+	EXPECT_FALSE(octree.update(item, AABB<int>(200, 200, 200, 201, 201, 201))) << "Expected to fail for bounds outside of the tree";
+	EXPECT_EQ(count, octree.count());
+	contents.clear();
+	octree.query(relocated, contents);
+	ASSERT_EQ(1u, contents.size()) << "Expected to keep the item at its old bounds";
+	EXPECT_EQ(1, contents[0].id());
+}
+
+TEST_F(OctreeTest, testCollapseEmptyLeaves) {
+	Octree<oc::Item, int> octree({0, 0, 0, 128, 128, 128}, 3);
+	std::vector<oc::Item> items;
+	for (int i = 0; i < Octree<oc::Item, int>::MaxLeafItems * 4; ++i) {
+		items.emplace_back(AABB<int>(i, i, i, i + 1, i + 1, i + 1), i);
+		ASSERT_TRUE(octree.insert(items.back()));
+	}
+	const int nodes = octree.nodes();
+	ASSERT_GT(nodes, 1);
+	EXPECT_EQ(nodes, octree.activeNodes());
+	for (const oc::Item& item : items) {
+		ASSERT_TRUE(octree.remove(item));
+	}
+	EXPECT_EQ(0, octree.count());
+	EXPECT_EQ(1, octree.activeNodes()) << "Expected the empty leaves to be merged into the root";
+
+	// the released nodes are reused
+	for (const oc::Item& item : items) {
+		ASSERT_TRUE(octree.insert(item));
+	}
+	EXPECT_EQ(nodes, octree.nodes());
+	EXPECT_EQ(nodes, octree.activeNodes());
+	Octree<oc::Item, int>::Contents contents;
+	octree.query(octree.aabb(), contents);
+	EXPECT_EQ(items.size(), contents.size());
+}
+
+TEST_F(OctreeTest, testUpdateMatchesRebuild) {
+	const AABB<int> bounds(0, 0, 0, 256, 256, 256);
+	Octree<oc::Item, int> octree(bounds);
+	std::vector<oc::Item> items;
+	math::Random random(42);
+	for (int i = 0; i < 200; ++i) {
+		const glm::ivec3 pos(random.random(0, 250), random.random(0, 250), random.random(0, 250));
+		items.emplace_back(AABB<int>(pos, pos + random.random(1, 5)), i);
+		ASSERT_TRUE(octree.insert(items.back()));
+	}
+	for (int step = 0; step < 10; ++step) {
+		for (oc::Item& item : items) {
+			const glm::ivec3 delta(random.random(-8, 8), random.random(-8, 8), random.random(-8, 8));
+			const glm::ivec3 mins = glm::clamp(item.aabb().mins() + delta, glm::ivec3(0), glm::ivec3(250));
+			const AABB<int> aabb(mins, mins + item.aabb().getWidth());
+			ASSERT_TRUE(octree.update(item, aabb));
+			item.setAABB(aabb);
+		}
+		ASSERT_EQ((int)items.size(), octree.count());
+		const glm::ivec3 qmins(random.random(0, 200), random.random(0, 200), random.random(0, 200));
+		const AABB<int> area(qmins, qmins + 50);
+		int expected = 0;
+		for (const oc::Item& item : items) {
+			if (intersects(area, item.aabb())) {
+				++expected;
+			}
+		}
+		int found = 0;
+		octree.query(area, [&] (const oc::Item& item) {
+			// the items are stored by value - the bounds of the copy are not updated
+			EXPECT_TRUE(intersects(area, items[item.id()].aabb()));
+			++found;
+		});
+		EXPECT_EQ(expected, found);
+	}
+}
+
 }
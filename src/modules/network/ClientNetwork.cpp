@@ -5,11 +5,37 @@
 #include "ServerMessages_generated.h"
 #include "ClientNetwork.h"
 #include "core/Assert.h"
+#include "core/Enum.h"
 #include "core/Trace.h"
 #include "core/Log.h"
 
 namespace network {
 
+namespace {
+
+/**
+ * @brief The handlers are registered under the names of the message types - intern them only once
+ */
+struct ServerMsgTypeIds {
+	core::StringId ids[core::enumVal(ServerMsgType::MAX) + 1];
+
+	ServerMsgTypeIds() {
+		for (int i = 0; i <= core::enumVal(ServerMsgType::MAX); ++i) {
+			ids[i] = core::StringId(EnumNamesServerMsgType()[i]);
+		}
+	}
+};
+
+core::StringId msgTypeId(ServerMsgType type) {
+	static const ServerMsgTypeIds msgTypeIds;
+	if (type > ServerMsgType::MAX) {
+		return core::StringId();
+	}
+	return msgTypeIds.ids[core::enumVal(type)];
+}
+
+}
+
 ClientNetwork::ClientNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry, const core::EventBusPtr& eventBus) :
 		Super(protocolHandlerRegistry, eventBus) {
 }
@@ -29,7 +55,7 @@ bool ClientNetwork::packetReceived(ENetEvent& event) {
 	}
 	const ServerMessage *req = GetServerMessage(event.packet->data);
 	ServerMsgType type = req->data_type();
-	ProtocolHandlerPtr handler = _protocolHandlerRegistry->getHandler(EnumNameServerMsgType(type));
+	ProtocolHandlerPtr handler = _protocolHandlerRegistry->getHandler(msgTypeId(type));
 	if (!handler) {
 		Log::error("No handler for server msg type %s", EnumNameServerMsgType(type));
 		return false;
@@ -15,13 +15,15 @@ void ProtocolHandlerRegistry::shutdown() {
 }
 
 ProtocolHandlerPtr ProtocolHandlerRegistry::getHandler(const char* type) {
-	ProtocolHandlers::iterator i = _registry.find(type);
-	if (i != _registry.end()) {
-		return i->second;
-	}
+	return getHandler(core::StringId::find(type));
+}
 
-	::Log::error("Failed to get protocol handler for %s", type);
-	return ProtocolHandlerPtr();
+ProtocolHandlerPtr ProtocolHandlerRegistry::getHandler(const core::StringId& type) {
+	ProtocolHandlerPtr handler;
+	if (!_registry.get(type, handler)) {
+		::Log::error("Failed to get protocol handler for %s", type.c_str());
+	}
+	return handler;
 }
 
 }
@@ -5,14 +5,14 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include "IProtocolHandler.h"
+#include "core/StringId.h"
 
 namespace network {
 
 class ProtocolHandlerRegistry {
 private:
-	typedef std::unordered_map<const char*, ProtocolHandlerPtr> ProtocolHandlers;
+	typedef core::StringIdMap<ProtocolHandlerPtr, 64> ProtocolHandlers;
 	ProtocolHandlers _registry;
 
 public:
@@ -22,9 +22,13 @@ public:
 	void shutdown();
 
 	ProtocolHandlerPtr getHandler(const char* type);
+	ProtocolHandlerPtr getHandler(const core::StringId& type);
 
 	inline void registerHandler(const char* type, const ProtocolHandlerPtr& handler) {
-		_registry.insert(std::make_pair(type, handler));
+		const core::StringId id(type);
+		if (!_registry.hasKey(id)) {
+			_registry.put(id, handler);
+		}
 	}
 };
 
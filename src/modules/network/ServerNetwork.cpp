@@ -4,11 +4,37 @@
 
 #include "ClientMessages_generated.h"
 #include "ServerNetwork.h"
+#include "core/Enum.h"
 #include "core/Trace.h"
 #include "core/Log.h"
 
 namespace network {
 
+namespace {
+
+/**
+ * @brief The handlers are registered under the names of the message types - intern them only once
+ */
+struct ClientMsgTypeIds {
+	core::StringId ids[core::enumVal(ClientMsgType::MAX) + 1];
+
+	ClientMsgTypeIds() {
+		for (int i = 0; i <= core::enumVal(ClientMsgType::MAX); ++i) {
+			ids[i] = core::StringId(EnumNamesClientMsgType()[i]);
+		}
+	}
+};
+
+core::StringId msgTypeId(ClientMsgType type) {
+	static const ClientMsgTypeIds msgTypeIds;
+	if (type > ClientMsgType::MAX) {
+		return core::StringId();
+	}
+	return msgTypeIds.ids[core::enumVal(type)];
+}
+
+}
+
 ServerNetwork::ServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry,
 		const core::EventBusPtr& eventBus, const metric::MetricPtr& metric) :
 		Super(protocolHandlerRegistry, eventBus), _metric(metric) {
@@ -24,7 +50,7 @@ bool ServerNetwork::packetReceived(ENetEvent& event) {
 	const ClientMessage *req = GetClientMessage(event.packet->data);
 	ClientMsgType type = req->data_type();
 	const char *clientMsgType = EnumNameClientMsgType(type);
-	ProtocolHandlerPtr handler = _protocolHandlerRegistry->getHandler(clientMsgType);
+	ProtocolHandlerPtr handler = _protocolHandlerRegistry->getHandler(msgTypeId(type));
 	if (!handler) {
 		Log::error("No handler for client msg type %s", clientMsgType);
 		return false;
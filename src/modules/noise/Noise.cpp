@@ -8,6 +8,7 @@
 #include "core/Log.h"
 #include "core/Common.h"
 #include "core/collection/Buffer.h"
+#include "core/concurrent/ThreadPool.h"
 #include <glm/gtc/constants.hpp>
 #include <glm/trigonometric.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -160,43 +161,67 @@ float Noise::sphereNoise(float longitude, float latitude) {
 #endif
 }
 
-void Noise::seamlessNoise(uint8_t* buffer, int size, int octaves, float persistence, float frequency, float amplitude) const {
-	core_trace_scoped(seamlessNoise);
+void Noise::seamlessNoiseRows(uint8_t* buffer, int size, int startRow, int endRow, int octaves, float persistence, float amplitude, int seed) const {
+	core_trace_scoped(SeamlessNoiseRows);
 	const int components = 3;
-	if (canUseShader()) {
-		const glm::ivec2 workSize(size);
-		_shader.seamlessNoise(buffer, size * size * components, size, components, octaves, persistence, amplitude, workSize);
-		return;
-	}
-	core::Buffer<uint8_t> bufferChannel(size * size);
+	// seamless noise: https://www.gamedev.net/blog/33/entry-2138456-seamless-noise/
+	// the 2d texture coordinates are mapped onto a 4d torus - the circle positions only depend on the column or row
 	const float pi2 = glm::two_pi<float>();
 	const float d = 1.0f / (float)size;
-	for (int channel = 0; channel < components; ++channel) {
-		// seamless noise: https://www.gamedev.net/blog/33/entry-2138456-seamless-noise/
-		float s = 0.0f;
-		for (int x = 0; x < size; x++, s += d) {
-			const float s_pi2 = s * pi2;
-			const float nx = glm::cos(s_pi2);
-			const float nz = glm::sin(s_pi2);
-			float t = 0.0f;
-			for (int y = 0; y < size; y++, t += d) {
-				const float t_pi2 = t * pi2;
-				const float ny = glm::cos(t_pi2);
-				const float nw = glm::sin(t_pi2);
-				float noise = fBm(glm::vec4(nx, ny, nz, nw) + glm::vec4(channel), octaves, persistence, amplitude);
-				noise = norm(noise);
-				const unsigned char color = (unsigned char) (noise * 255.0f);
-				const int channelIndex = y * size + x;
-				bufferChannel[channelIndex] = color;
-			}
-		}
-		int index = 0;
+	core::Buffer<glm::vec2> columns(size);
+	for (int x = 0; x < size; ++x) {
+		const float s_pi2 = (float)x * d * pi2;
+		columns[x] = glm::vec2(glm::cos(s_pi2), glm::sin(s_pi2));
+	}
+	for (int y = startRow; y < endRow; ++y) {
+		const float t_pi2 = (float)y * d * pi2;
+		const float ny = glm::cos(t_pi2);
+		const float nw = glm::sin(t_pi2);
+		uint8_t *row = buffer + (size_t)y * size * components;
 		for (int x = 0; x < size; ++x) {
-			for (int y = 0; y < size; ++y, ++index) {
-				buffer[index * components + channel] = bufferChannel[index];
+			const glm::vec4 pos(columns[x].x, ny, columns[x].y, nw);
+			for (int channel = 0; channel < components; ++channel) {
+				const float offset = (float)(channel + seed * components);
+				const float noise = norm(fBm(pos + glm::vec4(offset), octaves, persistence, amplitude));
+				row[x * components + channel] = (uint8_t)(noise * 255.0f);
 			}
 		}
 	}
 }
 
+int Noise::seamlessNoiseTileRows(int size) {
+	return core_max(1, core_min(size, 32));
+}
+
+void Noise::seamlessNoise(uint8_t* buffer, int size, int octaves, float persistence, float frequency, float amplitude, int seed) const {
+	core_trace_scoped(seamlessNoise);
+	const int components = 3;
+	if (canUseShader() && seed == 0) {
+		const glm::ivec2 workSize(size);
+		_shader.seamlessNoise(buffer, size * size * components, size, components, octaves, persistence, amplitude, workSize);
+		return;
+	}
+	seamlessNoiseRows(buffer, size, 0, size, octaves, persistence, amplitude, seed);
+}
+
+void Noise::seamlessNoise(core::ThreadPool& threadPool, uint8_t* buffer, int size, int octaves, float persistence, float frequency, float amplitude, int seed) const {
+	core_trace_scoped(seamlessNoiseParallel);
+	if (canUseShader() && seed == 0) {
+		seamlessNoise(buffer, size, octaves, persistence, frequency, amplitude, seed);
+		return;
+	}
+	const int tileRows = seamlessNoiseTileRows(size);
+	std::vector<std::future<void>> futures;
+	futures.reserve(size / tileRows + 1);
+	for (int startRow = 0; startRow < size; startRow += tileRows) {
+		const int endRow = core_min(startRow + tileRows, size);
+		futures.emplace_back(threadPool.enqueue([=] () {
+			seamlessNoiseRows(buffer, size, startRow, endRow, octaves, persistence, amplitude, seed);
+		}));
+	}
+	for (std::future<void>& future : futures) {
+		future.wait();
+	}
+}
+
 }
@@ -12,6 +12,10 @@ namespace compute {
 class NoiseShader;
 }
 
+namespace core {
+class ThreadPool;
+}
+
 namespace noise {
 
 /**
@@ -57,14 +61,35 @@ public:
 	 * @brief Fills the given target buffer with RGB values for the noise.
 	 * @param[in] buffer pointer to the target buffer - must be of size @c width * height * 3
 	 * @param[in] size the width and height of the image. Make sure that the target buffer has enough space to
-	 * store the needed data for the dimensions you specify here.
+	 * store the needed data for the dimensions you specify here. The noise is sampled in normalized coordinates - that
+	 * means that a smaller @c size gives a lower resolution version of the same texture. This can be used for a
+	 * progressive result.
 	 * @param[in] octaves the amount of noise calls that contribute to the final result
 	 * @param[in] persistence the persistence defines how much of the amplitude will be applied to the next noise call (only makes
 	 * sense if you have @c octaves > 1). The higher this value is (ranges from 0-1) the more each new octave will add to the result.
 	 * @param[in] frequency the higher the @c frequency the more deviation you get in your noise (wavelength).
 	 * @param[in] amplitude the amplitude defines how high the noise will be.
+	 * @param[in] seed Offsets the noise input - different seeds give different textures
+	 */
+	void seamlessNoise(uint8_t* buffer, int size, int octaves = 1, float persistence = 1.0f, float frequency = 1.0f, float amplitude = 1.0f, int seed = 0) const;
+
+	/**
+	 * @brief Same as above, but the rows of the texture are split into tiles that are generated in parallel on the given thread pool.
+	 * The result is the same as for the single threaded version. This blocks until all tiles are generated.
+	 * @note Don't call this from a task of the given thread pool
+	 */
+	void seamlessNoise(core::ThreadPool& threadPool, uint8_t* buffer, int size, int octaves = 1, float persistence = 1.0f, float frequency = 1.0f, float amplitude = 1.0f, int seed = 0) const;
+
+	/**
+	 * @brief Only generates the rows [@c startRow, @c endRow) of the texture. This is the cpu path of @c seamlessNoise() and allows
+	 * the caller to schedule the tiles on its own. The buffer must still have the size of the whole texture.
+	 */
+	void seamlessNoiseRows(uint8_t* buffer, int size, int startRow, int endRow, int octaves = 1, float persistence = 1.0f, float amplitude = 1.0f, int seed = 0) const;
+
+	/**
+	 * @brief The amount of rows that are generated by one task in the parallel version of @c seamlessNoise()
 	 */
-	void seamlessNoise(uint8_t* buffer, int size, int octaves = 1, float persistence = 1.0f, float frequency = 1.0f, float amplitude = 1.0f) const;
+	static int seamlessNoiseTileRows(int size);
 
 	/**
 	 * @return Range [-+2147483647,+2147483647].
@@ -7,7 +7,11 @@
 #include "noise/Noise.h"
 #include "image/Image.h"
 #include "core/GLM.h"
+#include "core/Log.h"
 #include "core/StringUtil.h"
+#include "core/TimeProvider.h"
+#include "core/collection/Buffer.h"
+#include "core/concurrent/ThreadPool.h"
 
 namespace noise {
 
@@ -42,8 +46,77 @@ protected:
 		EXPECT_TRUE(image::Image::writePng(target.c_str(), buffer, width, height, components));
 		noise.shutdown();
 	}
+
+	static constexpr int Size = 128;
+	static constexpr int Components = 3;
+	static constexpr int Octaves = 2;
+	static constexpr float Persistence = 0.3f;
+	static constexpr float Frequency = 0.7f;
+	static constexpr float Amplitude = 1.0f;
 };
 
+TEST_F(NoiseTest, testSeamlessNoiseParallelIsDeterministic) {
+	noise::Noise noise;
+	ASSERT_TRUE(noise.init());
+	noise.useShader(false);
+	core::Buffer<uint8_t> expected(Size * Size * Components);
+	uint64_t start = core::TimeProvider::highResTime();
+	noise.seamlessNoise(expected.data(), Size, Octaves, Persistence, Frequency, Amplitude);
+	const double resolution = (double)core::TimeProvider::highResTimeResolution();
+	Log::info("seamless noise with 0 threads: %fms", (double)(core::TimeProvider::highResTime() - start) * 1000.0 / resolution);
+
+	for (int threads : {1, 2, 4}) {
+		core::ThreadPool threadPool(threads, "noisetest");
+		threadPool.init();
+		core::Buffer<uint8_t> buffer(Size * Size * Components);
+		start = core::TimeProvider::highResTime();
+		noise.seamlessNoise(threadPool, buffer.data(), Size, Octaves, Persistence, Frequency, Amplitude);
+		Log::info("seamless noise with %i threads: %fms", threads, (double)(core::TimeProvider::highResTime() - start) * 1000.0 / resolution);
+		for (int i = 0; i < Size * Size * Components; ++i) {
+			ASSERT_EQ(expected[i], buffer[i]) << "Mismatch at " << i << " with " << threads << " threads";
+		}
+		threadPool.shutdown();
+	}
+	noise.shutdown();
+}
+
+TEST_F(NoiseTest, testSeamlessNoiseSeed) {
+	noise::Noise noise;
+	ASSERT_TRUE(noise.init());
+	noise.useShader(false);
+	const int size = 16;
+	uint8_t seed0[size * size * Components];
+	uint8_t seed1[size * size * Components];
+	noise.seamlessNoise(seed0, size, Octaves, Persistence, Frequency, Amplitude, 0);
+	noise.seamlessNoise(seed1, size, Octaves, Persistence, Frequency, Amplitude, 1);
+	EXPECT_NE(0, memcmp(seed0, seed1, sizeof(seed0)));
+	noise.seamlessNoise(seed1, size, Octaves, Persistence, Frequency, Amplitude, 0);
+	EXPECT_EQ(0, memcmp(seed0, seed1, sizeof(seed0)));
+	noise.shutdown();
+}
+
+TEST_F(NoiseTest, testSeamlessNoiseProgressive) {
+	noise::Noise noise;
+	ASSERT_TRUE(noise.init());
+	noise.useShader(false);
+	const int previewSize = Size / 4;
+	core::Buffer<uint8_t> preview(previewSize * previewSize * Components);
+	core::Buffer<uint8_t> full(Size * Size * Components);
+	noise.seamlessNoise(preview.data(), previewSize, Octaves, Persistence, Frequency, Amplitude);
+	noise.seamlessNoise(full.data(), Size, Octaves, Persistence, Frequency, Amplitude);
+	// the lower resolution version samples a subset of the full resolution texture
+	for (int y = 0; y < previewSize; ++y) {
+		for (int x = 0; x < previewSize; ++x) {
+			for (int c = 0; c < Components; ++c) {
+				const int previewIndex = (y * previewSize + x) * Components + c;
+				const int fullIndex = (y * 4 * Size + x * 4) * Components + c;
+				ASSERT_EQ(full[fullIndex], preview[previewIndex]) << x << ":" << y;
+			}
+		}
+	}
+	noise.shutdown();
+}
+
 TEST_F(NoiseTest, testSeamlessNoiseShader) {
 	seamlessNoise(true);
 }
@@ -23,6 +23,10 @@ bool ConnectionPool::init() {
 
 	_min = _minConnections->intVal();
 	_max = _maxConnections->intVal();
+	if (_max > MaxConnections) {
+		Log::warn("Limit the max connection amount to %i", MaxConnections);
+		_max = MaxConnections;
+	}
 
 	if (_min > _max) {
 		Log::error("The min connection amount must be smaller or equal to the max connection amount");
@@ -126,7 +130,7 @@ Connection* ConnectionPool::connection() {
 
 	if (_maxConnections->isDirty()) {
 		const int newMax = _maxConnections->intVal();
-		if (newMax > 0 && newMax >= _min) {
+		if (newMax > 0 && newMax >= _min && newMax <= MaxConnections) {
 			_max = newMax;
 		}
 		_maxConnections->markClean();
@@ -7,7 +7,7 @@
 #include "Connection.h"
 #include "core/Var.h"
 #include "core/Trace.h"
-#include "core/collection/ConcurrentQueue.h"
+#include "core/collection/MPMCQueue.h"
 #include "core/IComponent.h"
 #include "core/concurrent/Atomic.h"
 
@@ -20,6 +20,10 @@ class ConnectionPool : public core::IComponent {
 	friend class Connection;
 	friend class ScopedConnection;
 protected:
+	/**
+	 * @brief Upper limit for the max connections cvar - the pool never has to wait for a free slot
+	 */
+	static constexpr int MaxConnections = 256;
 	int _min = -1;
 	int _max = -1;
 	core::AtomicInt _connectionAmount { 0 };
@@ -31,7 +35,7 @@ protected:
 	core::VarPtr _minConnections;
 	core::VarPtr _maxConnections;
 
-	core::ConcurrentQueue<Connection*> _connections;
+	core::MPMCQueue<Connection*> _connections { (size_t)MaxConnections };
 
 public:
 	ConnectionPool();
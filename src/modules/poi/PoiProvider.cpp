@@ -55,6 +55,7 @@ PoiResult PoiProvider::query(Type type) const {
 		return empty;
 	}
 	if (type == Type::NONE) {
+		core::ScopedLock randomLock(_randomLock);
 		return PoiResult{_random.randomElement(_pois.begin(), _pois.end())->pos, true};
 	}
 	auto i = std::find_if(_pois.begin(), _pois.end(), [=] (const Poi& poi) {return poi.type == type;});
@@ -6,6 +6,8 @@
 
 #include "backend/ForwardDecl.h"
 #include "core/concurrent/ReadWriteLock.h"
+#include "core/concurrent/Lock.h"
+#include "core/Trace.h"
 #include "math/Random.h"
 #include "Type.h"
 #include <glm/fwd.hpp>
@@ -41,6 +43,10 @@ private:
 
 	core::TimeProviderPtr _timeProvider;
 	core::ReadWriteLock _lock;
+	/**
+	 * The random engine is modified by every query - several readers may query at the same time
+	 */
+	mutable core_trace_mutex(core::Lock, _randomLock, "PoiRandom");
 	math::Random _random;
 public:
 	PoiProvider(const core::TimeProviderPtr& timeProvider);
@@ -63,6 +69,17 @@ public:
 	 * @param[in] type If @c Type::NONE is given here we are just looking for any type of POI
 	 */
 	PoiResult query(Type type = Type::NONE) const;
+
+	/**
+	 * @brief Calls the functor with the position and the type of each POI
+	 */
+	template<class FUNC>
+	void visit(FUNC&& func) const {
+		core::ScopedReadLock scoped(_lock);
+		for (const Poi& poi : _pois) {
+			func(poi.pos, poi.type);
+		}
+	}
 };
 
 }
@@ -4,37 +4,136 @@
 #include "RandomColorTexture.h"
 #include "app/App.h"
 #include "core/concurrent/ThreadPool.h"
+#include "core/ByteStream.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
 #include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/Trace.h"
+#include "io/Filesystem.h"
 
 namespace render {
 
+namespace {
+const int ColorTextureSize = 256;
+const int ColorTexturePreviewSize = 32;
+const int ColorTextureOctaves = 2;
+const int ColorTextureDepth = 3;
+const int ColorTextureSeed = 0;
+const float ColorTexturePersistence = 0.3f;
+const float ColorTextureFrequency = 0.7f;
+const float ColorTextureAmplitude = 1.0f;
+const uint32_t ColorTextureMagic = FourCC('R', 'C', 'T', 'X');
+const int ColorTextureVersion = 1;
+const int ColorTextureBytes = ColorTextureSize * ColorTextureSize * ColorTextureDepth;
+
+uint32_t cacheKey() {
+	const struct {
+		int version = ColorTextureVersion;
+		int size = ColorTextureSize;
+		int octaves = ColorTextureOctaves;
+		int seed = ColorTextureSeed;
+		float persistence = ColorTexturePersistence;
+		float frequency = ColorTextureFrequency;
+		float amplitude = ColorTextureAmplitude;
+	} params;
+	return core::hash(&params, (int)sizeof(params));
+}
+
+}
+
 bool RandomColorTexture::init() {
 	if (!_noise.init()) {
 		return false;
 	}
 	_colorTexture = video::createEmptyTexture("**colortexture**");
-	const int ColorTextureSize = 256;
-	const int ColorTextureOctaves = 2;
-	const int ColorTextureDepth = 3;
-	const float persistence = 0.3f;
-	const float frequency = 0.7f;
-	const float amplitude = 1.0f;
+	const video::TextureFormat format = video::TextureFormat::RGB;
 	if (_noise.canUseShader()) {
-		uint8_t *colorTexture = new uint8_t[ColorTextureSize * ColorTextureSize * ColorTextureDepth];
-		_noise.seamlessNoise(colorTexture, ColorTextureSize, ColorTextureOctaves, persistence, frequency, amplitude);
-		video::TextureFormat format = video::TextureFormat::RGB;
+		uint8_t *colorTexture = new uint8_t[ColorTextureBytes];
+		_noise.seamlessNoise(colorTexture, ColorTextureSize, ColorTextureOctaves, ColorTexturePersistence, ColorTextureFrequency, ColorTextureAmplitude);
 		_colorTexture->upload(format, ColorTextureSize, ColorTextureSize, colorTexture);
 		delete[] colorTexture;
 		return true;
 	}
-	_noiseFuture.emplace_back(app::App::getInstance()->threadPool().enqueue([=] () {
-		uint8_t *colorTexture = new uint8_t[ColorTextureSize * ColorTextureSize * ColorTextureDepth];
-		_noise.seamlessNoise(colorTexture, ColorTextureSize, ColorTextureOctaves, persistence, frequency, amplitude);
-		return NoiseGenerationTask(colorTexture, ColorTextureSize, ColorTextureSize, ColorTextureDepth);
-	}));
+	_cacheFile = core::string::format("noise/colortexture-%08x.bin", cacheKey());
+	if (loadCache()) {
+		return true;
+	}
+
+	// the noise is sampled in normalized coordinates - a lower resolution version can be used until
+	// the full texture is generated
+	uint8_t preview[ColorTexturePreviewSize * ColorTexturePreviewSize * ColorTextureDepth];
+	_noise.seamlessNoise(preview, ColorTexturePreviewSize, ColorTextureOctaves, ColorTexturePersistence, ColorTextureFrequency,
+			ColorTextureAmplitude, ColorTextureSeed);
+	_colorTexture->upload(format, ColorTexturePreviewSize, ColorTexturePreviewSize, preview);
+
+	_buffer = new uint8_t[ColorTextureBytes];
+	core::ThreadPool& threadPool = app::App::getInstance()->threadPool();
+	const int tileRows = noise::Noise::seamlessNoiseTileRows(ColorTextureSize);
+	for (int startRow = 0; startRow < ColorTextureSize; startRow += tileRows) {
+		const int endRow = core_min(startRow + tileRows, ColorTextureSize);
+		uint8_t *buffer = _buffer;
+		_tiles.emplace_back(threadPool.enqueue([this, buffer, startRow, endRow] () {
+			_noise.seamlessNoiseRows(buffer, ColorTextureSize, startRow, endRow, ColorTextureOctaves, ColorTexturePersistence,
+					ColorTextureAmplitude, ColorTextureSeed);
+		}));
+	}
+	return true;
+}
+
+bool RandomColorTexture::loadCache() {
+	core_trace_scoped(RandomColorTextureLoadCache);
+	const io::FilesystemPtr& fs = io::filesystem();
+	if (!fs || !fs->exists(_cacheFile)) {
+		return false;
+	}
+	const io::FilePtr& file = fs->open(_cacheFile);
+	const int len = ColorTextureBytes + 2 * (int)sizeof(int32_t);
+	core::ByteStream stream(len);
+	if (file->length() != len || file->read(stream.writeBuffer(len), len) != len) {
+		Log::debug("Invalid color texture cache %s", _cacheFile.c_str());
+		return false;
+	}
+	stream.commit(len);
+	if ((uint32_t)stream.readInt() != ColorTextureMagic || stream.readInt() != ColorTextureVersion) {
+		Log::debug("Outdated color texture cache %s", _cacheFile.c_str());
+		return false;
+	}
+	_colorTexture->upload(video::TextureFormat::RGB, ColorTextureSize, ColorTextureSize, stream.getBuffer());
+	Log::debug("Loaded color texture from %s", _cacheFile.c_str());
 	return true;
 }
 
+void RandomColorTexture::saveCache() const {
+	const io::FilesystemPtr& fs = io::filesystem();
+	if (!fs) {
+		return;
+	}
+	core::ByteStream stream(ColorTextureBytes + 2 * (int)sizeof(int32_t));
+	stream.addInt((int32_t)ColorTextureMagic);
+	stream.addInt(ColorTextureVersion);
+	stream.append(_buffer, ColorTextureBytes);
+	if (!fs->write(_cacheFile, stream.getBuffer(), stream.getSize())) {
+		Log::warn("Failed to write color texture cache %s", _cacheFile.c_str());
+	}
+}
+
+bool RandomColorTexture::tilesReady() const {
+	for (const std::future<void>& tile : _tiles) {
+		if (tile.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void RandomColorTexture::waitForTiles() {
+	for (std::future<void>& tile : _tiles) {
+		tile.wait();
+	}
+	_tiles.clear();
+}
+
 video::Id RandomColorTexture::handle() const {
 	if (!_colorTexture) {
 		return video::InvalidId;
@@ -43,21 +142,13 @@ video::Id RandomColorTexture::handle() const {
 }
 
 void RandomColorTexture::bind(video::TextureUnit unit) {
-	if (!_noiseFuture.empty()) {
-		NoiseFuture& future = _noiseFuture.front();
-		if (future.valid()) {
-			NoiseGenerationTask c = future.get();
-			Log::trace("Noise texture ready - upload it");
-			video::TextureFormat format;
-			if (c.depth == 4) {
-				format = video::TextureFormat::RGBA;
-			} else {
-				format = video::TextureFormat::RGB;
-			}
-			_colorTexture->upload(format, c.width, c.height, c.buffer);
-			delete[] c.buffer;
-			_noiseFuture.clear();
-		}
+	if (_buffer != nullptr && tilesReady()) {
+		waitForTiles();
+		Log::trace("Noise texture ready - upload it");
+		_colorTexture->upload(video::TextureFormat::RGB, ColorTextureSize, ColorTextureSize, _buffer);
+		saveCache();
+		delete[] _buffer;
+		_buffer = nullptr;
 	}
 	_colorTexture->bind(unit);
 }
@@ -67,19 +158,13 @@ void RandomColorTexture::unbind() {
 }
 
 void RandomColorTexture::shutdown() {
-	while (!_noiseFuture.empty()) {
-		NoiseFuture& future = _noiseFuture.front();
-		if (future.valid()) {
-			NoiseGenerationTask c = future.get();
-			delete[] c.buffer;
-			_noiseFuture.clear();
-		}
-	}
+	waitForTiles();
+	delete[] _buffer;
+	_buffer = nullptr;
 	if (_colorTexture) {
 		_colorTexture->shutdown();
 		_colorTexture = video::TexturePtr();
 	}
-	_noiseFuture.clear();
 	_noise.shutdown();
 }
 
@@ -3,39 +3,38 @@
  */
 #pragma once
 
-#include "core/collection/Vector.h"
 #include "video/Texture.h"
 #include "noise/Noise.h"
 #include "video/Types.h"
 #include "core/IComponent.h"
+#include "core/String.h"
 
 #include <future>
+#include <vector>
 
 namespace render {
 
 /**
  * @brief Generates a seamless random colored texture
+ *
+ * If the noise can't be generated on the gpu, the texture is generated in tiles on the thread pool
+ * of the application. Until the tiles are finished, a low resolution version of the texture is bound.
+ * The final texture is cached on disk - keyed by the noise parameters.
  */
 class RandomColorTexture : public core::IComponent {
 private:
 	video::TexturePtr _colorTexture;
 	noise::Noise _noise;
 
-	struct NoiseGenerationTask {
-		NoiseGenerationTask() : buffer(nullptr), width(0), height(0), depth(0) {
-		}
-		NoiseGenerationTask(uint8_t *_buffer, int _width, int _height, int _depth) :
-				buffer(_buffer), width(_width), height(_height), depth(_depth) {
-		}
-		/** @brief pointer to preallocated buffer that was hand into the noise task */
-		uint8_t *buffer;
-		int width;
-		int height;
-		int depth;
-	};
-
-	typedef std::future<NoiseGenerationTask> NoiseFuture;
-	core::Vector<NoiseFuture, 1> _noiseFuture;
+	/** @brief preallocated buffer for the full resolution texture that is filled by the tile tasks */
+	uint8_t *_buffer = nullptr;
+	std::vector<std::future<void>> _tiles;
+	core::String _cacheFile;
+
+	bool tilesReady() const;
+	void waitForTiles();
+	bool loadCache();
+	void saveCache() const;
 public:
 	bool init() override;
 	void shutdown() override;
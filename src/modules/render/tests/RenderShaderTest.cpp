@@ -16,7 +16,8 @@ TEST_P(RenderShaderTest, testTextureShader) {
 		return;
 	}
 	shader::TextureShader shader;
-	EXPECT_TRUE(shader.setup());
+	ASSERT_TRUE(shader.setup());
+	EXPECT_TRUE(shader.link());
 	shader.shutdown();
 }
 
@@ -25,7 +26,8 @@ TEST_P(RenderShaderTest, testColorShader) {
 		return;
 	}
 	shader::ColorShader shader;
-	EXPECT_TRUE(shader.setup());
+	ASSERT_TRUE(shader.setup());
+	EXPECT_TRUE(shader.link());
 	shader.shutdown();
 }
 
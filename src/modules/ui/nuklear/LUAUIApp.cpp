@@ -13,6 +13,11 @@
 namespace ui {
 namespace nuklear {
 
+/**
+ * @brief Time in microseconds that is spent on collecting the lua garbage per frame
+ */
+static constexpr uint64_t LUAGCBudgetMicros = 250u;
+
 LUAUIApp::LUAUIApp(const metric::MetricPtr& metric,
 		const io::FilesystemPtr& filesystem,
 		const core::EventBusPtr& eventBus,
@@ -36,6 +41,8 @@ app::AppState LUAUIApp::onInit() {
 	const core::String& path = core::string::format("ui/%s.lua", appname().c_str());
 	_uiScriptPath = core::Var::get("ui_script", path)->strVal();
 
+	// the ui scripts produce garbage every frame - collect it in small steps in onRenderUI()
+	_lua.setManualGC(true);
 	if (!reload()) {
 		return app::AppState::InitFailure;
 	}
@@ -114,6 +121,7 @@ bool LUAUIApp::onRenderUI() {
 			break;
 		}
 	}
+	_lua.gcStep(LUAGCBudgetMicros);
 	return true;
 }
 
@@ -53,6 +53,9 @@ Console::Console() :
 
 Console::~Console() {
 	SDL_LogSetOutputFunction(_logFunction, _logUserData);
+	while (LogLine* msg = _messageQueue.pop()) {
+		delete msg;
+	}
 }
 
 core::String Console::getColor(ConsoleColor color) {
@@ -536,7 +539,7 @@ void Console::logConsole(void *userdata, int category, SDL_LogPriority priority,
 	Console* console = (Console*)userdata;
 	if (std::this_thread::get_id() != console->_mainThread) {
 		core_assert(message);
-		console->_messageQueue.emplace(category, priority, message);
+		console->_messageQueue.push(new LogLine(category, priority, message));
 		return;
 	}
 	console->addLogLine(category, priority, message);
@@ -570,12 +573,12 @@ bool Console::toggle() {
 
 void Console::update(double /*deltaFrameSeconds*/) {
 	core_assert(_mainThread == std::this_thread::get_id());
-	LogLine msg;
 	bool toggleConsole = false;
-	while (_messageQueue.pop(msg)) {
-		core_assert(msg.message);
-		addLogLine(msg.category, msg.priority, msg.message);
-		toggleConsole |= msg.priority >= SDL_LOG_PRIORITY_ERROR;
+	while (LogLine* msg = _messageQueue.pop()) {
+		core_assert(msg->message);
+		addLogLine(msg->category, msg->priority, msg->message);
+		toggleConsole |= msg->priority >= SDL_LOG_PRIORITY_ERROR;
+		delete msg;
 	}
 	if (toggleConsole) {
 		return;
@@ -12,7 +12,7 @@
 #include "core/IComponent.h"
 #include "core/collection/DynamicArray.h"
 #include "math/Rect.h"
-#include "core/collection/ConcurrentQueue.h"
+#include "core/collection/MPSCQueue.h"
 #include <thread>
 
 namespace util {
@@ -45,52 +45,21 @@ protected:
 	/**
 	 * @brief Data structure to store a log entry call from a different thread.
 	 */
-	struct LogLine {
-		LogLine(int _category = 0, SDL_LogPriority _priority = (SDL_LogPriority)0, const char* _message = nullptr) :
-				category(_category), priority(_priority), message(_message ? SDL_strdup(_message) : nullptr) {
+	struct LogLine : public core::MPSCQueueNode {
+		LogLine(int _category, SDL_LogPriority _priority, const char* _message) :
+				category(_category), priority(_priority), message(SDL_strdup(_message)) {
 		}
 		~LogLine() {
 			SDL_free(message);
-			message = (char*)(intptr_t)0xdeadbeef;
-		}
-		LogLine(LogLine&& o) noexcept {
-			category = o.category;
-			priority = o.priority;
-			message = o.message;
-			o.message = nullptr;
 		}
+		LogLine(const LogLine&) = delete;
+		LogLine& operator=(const LogLine&) = delete;
+
 		int category;
 		SDL_LogPriority priority;
 		char* message;
-
-		LogLine& operator=(LogLine&& o) noexcept {
-			if (this != &o) {
-				category = o.category;
-				priority = o.priority;
-				message = o.message;
-				o.message = nullptr;
-			}
-			return *this;
-		}
-
-		LogLine& operator=(const LogLine& o) {
-			if (&o == this) {
-				return *this;
-			}
-			category = o.category;
-			priority = o.priority;
-			if (message) {
-				SDL_free(message);
-			}
-			message = SDL_strdup(o.message);
-			return *this;
-		}
-
-		inline bool operator<(const LogLine& logLine) const {
-			return category < logLine.category && priority < logLine.priority && message < logLine.message;
-		}
 	};
-	core::ConcurrentQueue<LogLine> _messageQueue;
+	core::MPSCQueue<LogLine> _messageQueue;
 	Messages _history;
 	uint32_t _historyPos = 0;
 	const std::thread::id _mainThread;
@@ -74,7 +74,7 @@ static bool executeCommandsForBinding(const BindMap& bindings, int32_t key, int1
 		}
 		Log::trace("Execute the command %s for key %i", command.c_str(), key);
 		if (command[0] == '+') {
-			if (command::Command::execute("%s %i %f", command.c_str(), key, nowSeconds) == 1) {
+			if (command::Command::execute(i->second.pressed, key, nowSeconds)) {
 				Log::trace("The tracking command was executed");
 				handled = true;
 				continue;
@@ -82,7 +82,11 @@ static bool executeCommandsForBinding(const BindMap& bindings, int32_t key, int1
 			Log::trace("Failed to execute the tracking command %s", command.c_str());
 			continue;
 		}
-		handled |= command::Command::execute(command) > 0;
+		if (i->second.prepared) {
+			handled |= command::Command::execute(i->second.commands) > 0;
+		} else {
+			handled |= command::Command::execute(command) > 0;
+		}
 	}
 	return handled;
 }
@@ -130,7 +134,7 @@ void KeyBindingHandler::construct() {
 			bool found = false;
 			for (auto it = range.first; it != range.second; ++it) {
 				if (it->second.modifier == pair.modifier) {
-					it->second.command = pair.command;
+					it->second = pair;
 					found = true;
 					Log::info("Updated binding for key %s", args[0].c_str());
 					break;
@@ -294,7 +298,7 @@ bool KeyBindingHandler::execute(int32_t key, int16_t modifier, bool pressed, dou
 				if (!isValidForBinding(modifier, pair.modifier)) {
 					continue;
 				}
-				command::Command::execute("%s %i %f", pair.command.c_str(), commandKey, nowSeconds);
+				command::Command::execute(pair.pressed, commandKey, nowSeconds);
 				recheck.insert(commandKey);
 			}
 			// for those keys that were activated because only a modifier was pressed (bound to e.g. left_shift),
@@ -306,7 +310,7 @@ bool KeyBindingHandler::execute(int32_t key, int16_t modifier, bool pressed, dou
 					if (pair.modifier != 0) {
 						continue;
 					}
-					command::Command::execute("-%s %i %f", &(pair.command.c_str()[1]), checkKey, nowSeconds);
+					command::Command::execute(pair.released, checkKey, nowSeconds);
 				}
 			}
 		}
@@ -331,7 +335,7 @@ bool KeyBindingHandler::execute(int32_t key, int16_t modifier, bool pressed, dou
 			if (!isPressed(commandKey)) {
 				continue;
 			}
-			command::Command::execute("-%s %i %f", &(pair.command.c_str()[1]), commandKey, nowSeconds);
+			command::Command::execute(pair.released, commandKey, nowSeconds);
 			executeCommands(commandKey, modifier, nowSeconds);
 		}
 		_pressedModifierMask &= ~(uint32_t)code;
@@ -340,7 +344,7 @@ bool KeyBindingHandler::execute(int32_t key, int16_t modifier, bool pressed, dou
 	for (auto i = range.first; i != range.second; ++i) {
 		const core::String& command = i->second.command;
 		if (command[0] == '+') {
-			command::Command::execute("-%s %i %f", &(command.c_str()[1]), key, nowSeconds);
+			command::Command::execute(i->second.released, key, nowSeconds);
 			handled = true;
 		}
 	}
@@ -11,6 +11,19 @@
 
 namespace util {
 
+CommandModifierPair::CommandModifierPair(const core::String& _command, int16_t _modifier) :
+		command(_command), modifier(_modifier) {
+	if (command.empty()) {
+		return;
+	}
+	if (command[0] == '+') {
+		pressed = command::Command::handle(command);
+		released = command::Command::handle("-" + command.substr(1));
+		return;
+	}
+	prepared = command::Command::prepare(command, commands);
+}
+
 void KeybindingParser::parseKeyAndCommand(core::String key, const core::String& command) {
 	int modifier = KMOD_NONE;
 	if (key.size() > 1) {
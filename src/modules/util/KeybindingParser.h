@@ -5,16 +5,28 @@
 #pragma once
 
 #include "core/Tokenizer.h"
+#include "command/Command.h"
 #include <unordered_map>
 
 namespace util {
 
+/**
+ * @brief A bound command line - it is resolved into command handles once, the key events don't have to parse it again
+ */
 struct CommandModifierPair {
-	inline CommandModifierPair(const core::String& _command, int16_t _modifier) :
-			command(_command), modifier(_modifier) {
-	}
+	CommandModifierPair(const core::String& _command, int16_t _modifier);
 	core::String command;
 	int16_t modifier;
+	/**
+	 * @brief The @c + and @c - commands of action button bindings
+	 */
+	command::CommandHandle pressed;
+	command::CommandHandle released;
+	/**
+	 * @brief Only valid if @c prepared is @c true - otherwise the command string must be executed
+	 */
+	command::PreparedCommands commands;
+	bool prepared = false;
 };
 typedef std::unordered_multimap<int32_t, CommandModifierPair> BindMap;
 
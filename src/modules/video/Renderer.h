@@ -17,6 +17,7 @@
 #include "RenderBuffer.h"
 #include "core/SharedPtr.h"
 #include "core/collection/List.h"
+#include "core/collection/DynamicArray.h"
 #include <type_traits>
 
 struct SDL_Window;
@@ -318,7 +319,7 @@ extern bool setupFramebuffer(const TexturePtr (&colorTextures)[core::enumVal(Fra
 extern void setupTexture(const TextureConfig& config);
 extern void uploadTexture(video::TextureType type, video::TextureFormat format, int width, int height, const uint8_t* data, int index);
 extern void drawElements(Primitive mode, size_t numIndices, DataType type, void* offset = nullptr);
-extern void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, size_t amount);
+extern void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, size_t amount, void* offset = nullptr);
 extern void drawElementsBaseVertex(Primitive mode, size_t numIndices, DataType type, size_t indexSize, int baseIndex, int baseVertex);
 extern void drawElementsIndirect(Primitive mode, DataType type, void* offset);
 inline void drawMultiElementsIndirect(Primitive mode, DataType type, void* offset, size_t commandSize, size_t stride = 0u);
@@ -330,8 +331,44 @@ extern void disableDebug();
 extern bool hasFeature(Feature feature);
 extern void enableDebug(DebugSeverity severity);
 extern bool compileShader(Id id, ShaderType shaderType, const core::String& source, const core::String& name);
+/**
+ * @brief Hands the source over to the driver and starts the compilation without waiting for the result.
+ * @note Use @c checkCompileShader() to get the result. With @c Feature::ParallelShaderCompile the driver
+ * can compile several shaders at once until the status is queried.
+ */
+extern bool startCompileShader(Id id, const core::String& source);
+extern bool checkCompileShader(Id id, ShaderType shaderType, const core::String& source, const core::String& name);
+/**
+ * @brief Retrieve the driver specific binary of a linked program
+ * @sa Feature::ProgramBinary
+ */
+extern bool getProgramBinary(Id program, uint32_t& format, core::DynamicArray<uint8_t>& binary);
+/**
+ * @brief Restore a program from a binary that was retrieved by @c getProgramBinary()
+ * @return @c false if the driver rejected the binary - the program must be compiled and linked from source then
+ */
+extern bool programBinary(Id program, uint32_t format, const uint8_t* binary, size_t length);
 extern bool linkShader(Id program, Id vert, Id frag, Id geom, const core::String& name);
 extern bool linkComputeShader(Id program, Id comp, const core::String& name);
+/**
+ * @brief Attaches the shaders and starts linking the program without waiting for the result.
+ * @note Use @c checkLinkShader() to get the result. With @c Feature::ParallelShaderCompile the driver
+ * compiles and links in the background until the status is queried.
+ */
+extern bool startLinkShader(Id program, Id vert, Id frag, Id geom);
+extern bool startLinkComputeShader(Id program, Id comp);
+/**
+ * @brief Queries the link status of a program started with @c startLinkShader() and detaches the shaders
+ * @note Blocks until the driver finished linking. The program is deleted if linking failed.
+ */
+extern bool checkLinkShader(Id program, Id vert, Id frag, Id geom, const core::String& name);
+extern bool checkLinkComputeShader(Id program, Id comp, const core::String& name);
+/**
+ * @brief Polls @c GL_COMPLETION_STATUS_KHR of the program without blocking
+ * @return @c true if the driver finished compiling and linking the program - always
+ * @c true without @c Feature::ParallelShaderCompile
+ */
+extern bool isProgramLinked(Id program);
 extern bool bindImage(Id handle, AccessMode mode, ImageFormat format);
 extern bool runShader(Id program, const glm::uvec3& workGroups, bool wait = false);
 extern int fetchUniforms(Id program, ShaderUniforms& uniforms, const core::String& name);
@@ -369,8 +406,8 @@ inline void drawMultiElementsIndirect(Primitive mode, void* offset, size_t comma
 }
 
 template<class IndexType>
-inline void drawElementsInstanced(Primitive mode, size_t numIndices, size_t amount) {
-	drawElementsInstanced(mode, numIndices, mapType<IndexType>(), amount);
+inline void drawElementsInstanced(Primitive mode, size_t numIndices, size_t amount, void* offset = nullptr) {
+	drawElementsInstanced(mode, numIndices, mapType<IndexType>(), amount, offset);
 }
 
 template<class IndexType>
@@ -17,6 +17,9 @@
 #include "core/Singleton.h"
 #include "core/StringUtil.h"
 #include "ShaderManager.h"
+#include "ShaderCache.h"
+#include "core/GameConfig.h"
+#include "core/Trace.h"
 #include "UniformBuffer.h"
 #include "video/Renderer.h"
 #include "util/IncludeUtil.h"
@@ -94,14 +97,17 @@ int Shader::getAttributeComponents(const core::String& name) const {
 }
 
 bool Shader::hasAttribute(const core::String& name) const {
+	link();
 	return _attributes.find(name) != _attributes.end();
 }
 
 bool Shader::hasUniform(const core::String& name) const {
+	link();
 	return _uniforms.find(name) != _uniforms.end();
 }
 
 bool Shader::isUniformBlock(const core::String& name) const {
+	link();
 	auto i = _uniforms.find(name);
 	if (i == _uniforms.end()) {
 		return false;
@@ -162,6 +168,10 @@ void Shader::shutdown() {
 	for (auto& shader : _shader) {
 		video::deleteShader(shader);
 	}
+	releaseSources();
+	_compute = false;
+	_linkState = LinkState::None;
+	_binaryKey = 0u;
 	_uniformStateMap.clear();
 	video::deleteProgram(_program);
 	_initialized = false;
@@ -185,25 +195,122 @@ bool Shader::load(const core::String& name, const core::String& buffer, ShaderTy
 		return false;
 	}
 	_name = name;
-	const core::String& source = getSource(shaderType, buffer);
+	_sources[(int)shaderType] = getSource(shaderType, buffer, true, nullptr, &_sourceKeys[(int)shaderType]);
+	return !_sources[(int)shaderType].empty();
+}
+
+void Shader::releaseSources() {
+	ShaderCache& shaderCache = core::Singleton<ShaderCache>::getInstance();
+	for (int i = 0; i < (int)ShaderType::Max; ++i) {
+		_sources[i] = core::String();
+		if (_sourceKeys[i] != 0u) {
+			shaderCache.releaseSource(_sourceKeys[i]);
+			_sourceKeys[i] = 0u;
+		}
+	}
+}
 
-	Id id = getShader(shaderType);
-	if (id == InvalidId) {
-		id = video::genShader(shaderType);
+bool Shader::startLinking() {
+	core_trace_scoped(ShaderStartLinking);
+	for (int i = 0; i < (int)ShaderType::Max; ++i) {
+		if (_sources[i].empty()) {
+			continue;
+		}
+		const ShaderType shaderType = (ShaderType)i;
+		Id id = getShader(shaderType);
 		if (id == InvalidId) {
-			Log::error("Failed to generate shader handle for %s\n", name.c_str());
-			return false;
+			id = video::genShader(shaderType);
+			if (id == InvalidId) {
+				Log::error("Failed to generate shader handle for %s", _name.c_str());
+				return false;
+			}
+			_shader[i] = id;
+		}
+		video::startCompileShader(id, _sources[i]);
+	}
+	if (_compute) {
+		return video::startLinkComputeShader(_program, getShader(ShaderType::Compute));
+	}
+	const Id vert = getShader(ShaderType::Vertex);
+	const Id frag = getShader(ShaderType::Fragment);
+	const Id geom = getShader(ShaderType::Geometry);
+	return video::startLinkShader(_program, vert, frag, geom);
+}
+
+bool Shader::finishLinking() {
+	core_trace_scoped(ShaderFinishLinking);
+	bool linked;
+	if (_compute) {
+		linked = video::checkLinkComputeShader(_program, getShader(ShaderType::Compute), _name);
+	} else {
+		const Id vert = getShader(ShaderType::Vertex);
+		const Id frag = getShader(ShaderType::Fragment);
+		const Id geom = getShader(ShaderType::Geometry);
+		linked = video::checkLinkShader(_program, vert, frag, geom, _name);
+	}
+	if (!linked) {
+		// a successful link implies that all stages compiled - only look for the reason if it failed
+		for (int i = 0; i < (int)ShaderType::Max; ++i) {
+			if (_shader[i] == InvalidId || _sources[i].empty()) {
+				continue;
+			}
+			if (!video::checkCompileShader(_shader[i], (ShaderType)i, _sources[i], _name)) {
+				_shader[i] = InvalidId;
+				Log::error("Failed to compile shader for %s", _name.c_str());
+			}
+		}
+		return false;
+	}
+	if (_binaryKey != 0u) {
+		uint32_t format = 0u;
+		core::DynamicArray<uint8_t> binary;
+		if (video::getProgramBinary(_program, format, binary)) {
+			core::Singleton<ShaderCache>::getInstance().saveBinary(_binaryKey, format, binary.data(), binary.size());
 		}
-		_shader[(int)shaderType] = id;
 	}
-	if (!video::compileShader(id, shaderType, source, _name)) {
-		_shader[(int)shaderType] = InvalidId;
-		Log::error("Failed to compile shader for %s\n", name.c_str());
+	return true;
+}
+
+bool Shader::link() const {
+	switch (_linkState) {
+	case LinkState::Linked:
+		return true;
+	case LinkState::None:
+	case LinkState::Failed:
+		return false;
+	default:
+		break;
+	}
+	core_trace_scoped(ShaderLink);
+	Shader* self = const_cast<Shader*>(this);
+	bool linked;
+	if (_linkState == LinkState::Deferred) {
+		linked = self->startLinking() && self->finishLinking();
+	} else {
+		linked = self->finishLinking();
+	}
+	self->releaseSources();
+	if (!linked) {
+		// the program was already deleted by the failed link
+		self->_program = InvalidId;
+		self->_linkState = LinkState::Failed;
+		Log::error("Failed to link shader %s", _name.c_str());
 		return false;
 	}
+	self->_linkState = LinkState::Linked;
+	self->fetchAttributes();
+	self->fetchUniforms();
+	self->onLinked();
 	return true;
 }
 
+void Shader::pollLink() {
+	if (_linkState != LinkState::Linking || !video::isProgramLinked(_program)) {
+		return;
+	}
+	link();
+}
+
 bool Shader::loadFromFile(const core::String& filename, ShaderType shaderType) {
 	const core::String& buffer = io::filesystem()->load(filename);
 	if (buffer.empty()) {
@@ -242,14 +349,23 @@ bool Shader::reload() {
 }
 
 bool Shader::init() {
-	createProgramFromShaders();
-	const bool success = _program != InvalidId;
+	core_trace_scoped(ShaderInit);
+	const bool success = createProgramFromShaders() && _program != InvalidId;
+	if (!success) {
+		releaseSources();
+		_linkState = LinkState::None;
+	}
 	_initialized = success;
 	if (_initialized) {
-		fetchAttributes();
-		fetchUniforms();
 		Log::info("Register shader: %s", _name.c_str());
 		core::Singleton<ShaderManager>::getInstance().registerShader(this);
+		if (_linkState == LinkState::Linked) {
+			// restored from the binary cache
+			releaseSources();
+			fetchAttributes();
+			fetchUniforms();
+			onLinked();
+		}
 	}
 	return success;
 }
@@ -268,6 +384,9 @@ bool Shader::isActive() const {
 }
 
 bool Shader::activate() const {
+	if (!link()) {
+		return false;
+	}
 	video::useProgram(_program);
 	_active = true;
 	return _active;
@@ -305,6 +424,7 @@ int Shader::getAttributeLocation(const core::String& name) const {
 }
 
 int Shader::checkAttributeLocation(const core::String& name) const {
+	link();
 	auto i = _attributes.find(name);
 	if (i == _attributes.end()) {
 		return -1;
@@ -336,6 +456,7 @@ int Shader::getUniformLocation(const core::String& name) const {
 }
 
 const Uniform* Shader::getUniform(const core::String& name) const {
+	link();
 	auto i = _uniforms.find(name);
 	if (i == _uniforms.end()) {
 		Log::debug("can't find uniform %s in shader %s", name.c_str(), _name.c_str());
@@ -364,7 +485,7 @@ core::String Shader::validPreprocessorName(const core::String& name) {
 	return core::string::replaceAll(name, "_", "");
 }
 
-core::String Shader::getSource(ShaderType shaderType, const core::String& buffer, bool finalize, core::List<core::String>* includedFiles) const {
+core::String Shader::getSource(ShaderType shaderType, const core::String& buffer, bool finalize, core::List<core::String>* includedFiles, uint64_t* cacheKey) const {
 	if (buffer.empty()) {
 		return "";
 	}
@@ -405,13 +526,32 @@ core::String Shader::getSource(ShaderType shaderType, const core::String& buffer
 		src.append("#endif\n");
 	}
 
+	// everything up to here is cheap to generate - the prefix and the buffer are the key
+	// for the cached result of the include handling and the replacements below
+	const bool cache = core::Var::boolean(cfg::ClientShaderCache);
+	uint64_t key = 0u;
+	core::List<core::String> cacheIncludes;
+	if (cache) {
+		key = ShaderCache::sourceKey(_name, src, buffer, finalize);
+	}
+	if (cacheKey != nullptr) {
+		*cacheKey = key;
+	}
+	if (cache) {
+		core::String cached;
+		if (core::Singleton<ShaderCache>::getInstance().source(key, cached, includedFiles)) {
+			return cached;
+		}
+	}
+	core::List<core::String>* includes = cache ? &cacheIncludes : includedFiles;
+
 	core::List<core::String> includeDirs;
 	includeDirs.insert(core::String(core::string::extractPath(_name)));
-	const std::pair<core::String, bool>& includesFirst = util::handleIncludes(_name, buffer, includeDirs, includedFiles);
+	const std::pair<core::String, bool>& includesFirst = util::handleIncludes(_name, buffer, includeDirs, includes);
 	src += includesFirst.first;
 	int level = 0;
 	while (core::string::contains(src, "#include")) {
-		const std::pair<core::String, bool>& includesRecurse = util::handleIncludes(_name, src, includeDirs, includedFiles);
+		const std::pair<core::String, bool>& includesRecurse = util::handleIncludes(_name, src, includeDirs, includes);
 		src += includesRecurse.first;
 		++level;
 		if (level >= 10) {
@@ -467,6 +607,14 @@ core::String Shader::getSource(ShaderType shaderType, const core::String& buffer
 		src = core::string::replaceAll(src, "$texture3D", replaceTexture3D);
 		src = core::string::replaceAll(src, "$shadow2D", replaceShadow2D);
 	}
+	if (cache) {
+		core::Singleton<ShaderCache>::getInstance().putSource(key, src, cacheIncludes, true);
+		if (includedFiles != nullptr) {
+			for (const core::String& include : cacheIncludes) {
+				includedFiles->insert(include);
+			}
+		}
+	}
 	return src;
 }
 
@@ -475,25 +623,55 @@ bool Shader::createProgramFromShaders() {
 		_program = video::genProgram();
 	}
 
-	const Id comp = getShader(ShaderType::Compute);
-	if (comp != InvalidId) {
-		return video::linkComputeShader(_program, comp, _name);
+	_compute = !_sources[(int)ShaderType::Compute].empty();
+	const bool compute = _compute;
+	if (!compute && !bindTransformFeedbackVaryings(_program, _transformFormat, _transformVaryings)) {
+		_transformFormat = TransformFeedbackCaptureMode::Max;
 	}
 
-	const Id vert = getShader(ShaderType::Vertex);
-	const Id frag = getShader(ShaderType::Fragment);
-	const Id geom = getShader(ShaderType::Geometry);
-
-	if (!bindTransformFeedbackVaryings(_program, _transformFormat, _transformVaryings)) {
-		_transformFormat = TransformFeedbackCaptureMode::Max;
+	const bool binaryCache = core::Var::boolean(cfg::ClientShaderCache) && video::hasFeature(Feature::ProgramBinary);
+	_binaryKey = 0u;
+	if (binaryCache) {
+		ShaderCache& shaderCache = core::Singleton<ShaderCache>::getInstance();
+		core::DynamicArray<core::String> sources;
+		for (const core::String& source : _sources) {
+			sources.push_back(source);
+		}
+		core::String extra = core::string::toString(core::enumVal(_transformFormat));
+		for (const core::String& varying : _transformVaryings) {
+			extra += varying;
+		}
+		const uint64_t key = shaderCache.programKey(sources, extra);
+		uint32_t format = 0u;
+		core::DynamicArray<uint8_t> binary;
+		if (shaderCache.loadBinary(key, format, binary)) {
+			if (video::programBinary(_program, format, binary.data(), binary.size())) {
+				Log::debug("Restored shader %s from the program binary cache", _name.c_str());
+				_linkState = LinkState::Linked;
+				return true;
+			}
+			Log::debug("Program binary for %s was rejected by the driver", _name.c_str());
+			shaderCache.removeBinary(key);
+		}
+		_binaryKey = key;
 	}
 
-	return video::linkShader(_program, vert, frag, geom, _name);
+	if (!video::hasFeature(Feature::ParallelShaderCompile)) {
+		// compiling now would block - do it when the program is used the first time
+		_linkState = LinkState::Deferred;
+		return true;
+	}
+	if (!startLinking()) {
+		video::deleteProgram(_program);
+		return false;
+	}
+	_linkState = LinkState::Linking;
+	return true;
 }
 
 bool Shader::run(const glm::uvec3& workGroups, bool wait) {
-	const Id comp = getShader(ShaderType::Compute);
-	if (comp == InvalidId) {
+	// the stage shader handle might not exist if the program was restored from the binary cache
+	if (!_compute || !link()) {
 		return false;
 	}
 	return video::runShader(_program, workGroups, wait);
@@ -45,10 +45,42 @@ class Shader : public core::NonCopyable {
 protected:
 	typedef core::Array<Id, (int)ShaderType::Max> ShaderArray;
 	ShaderArray _shader { InvalidId, InvalidId, InvalidId, InvalidId };
+	/**
+	 * The preprocessed sources of the stages - the compilation is deferred until @c init() is called
+	 * (or until the program is used the first time, if the driver can't compile in the background).
+	 * They are released once the program is linked.
+	 */
+	typedef core::Array<core::String, (int)ShaderType::Max> SourceArray;
+	SourceArray _sources;
+	/**
+	 * The @c ShaderCache keys of the preprocessed sources - @c 0 if the cache is disabled
+	 */
+	typedef core::Array<uint64_t, (int)ShaderType::Max> SourceKeyArray;
+	SourceKeyArray _sourceKeys { 0u, 0u, 0u, 0u };
+	bool _compute = false;
 
 	typedef core::Map<int, uint32_t, 8> UniformStateMap;
 	mutable UniformStateMap _uniformStateMap;
 
+	/**
+	 * @brief The program is linked on the first use - with @c Feature::ParallelShaderCompile the driver
+	 * already compiles and links in the background since @c init()
+	 */
+	enum class LinkState {
+		None,
+		/** the compilation is not yet started - the driver can't compile in the background */
+		Deferred,
+		/** compile and link were issued, the result was not yet queried */
+		Linking,
+		Linked,
+		Failed
+	};
+	LinkState _linkState = LinkState::None;
+	/**
+	 * The @c ShaderCache key of the program binary - @c 0 if the binary cache is not used
+	 */
+	uint64_t _binaryKey = 0u;
+
 	Id _program = InvalidId;
 	bool _initialized = false;
 	mutable bool _active = false;
@@ -85,8 +117,32 @@ protected:
 
 	int fetchAttributes();
 
+	/**
+	 * @brief Issues the compilation of all loaded stages and the link of the program without
+	 * querying any status. This allows the driver to compile them in parallel (@c KHR_parallel_shader_compile)
+	 */
+	bool startLinking();
+	/**
+	 * @brief Queries the link result (blocks until the driver is done) and puts the binary into the cache.
+	 */
+	bool finishLinking();
+
+	/**
+	 * @brief Try to restore the program from the binary cache - otherwise start to compile and link it
+	 * or defer this to the first use if the driver can't do it in the background.
+	 */
 	bool createProgramFromShaders();
 
+	/**
+	 * @brief Called once the program is linked - the attributes and uniforms are available from here on
+	 */
+	virtual void onLinked() {
+	}
+	/**
+	 * @brief The sources are not needed anymore once the program is linked
+	 */
+	void releaseSources();
+
 	/**
 	 * @param[in] location The uniform location in the shader
 	 * @param[in] value The buffer with the data
@@ -104,19 +160,38 @@ public:
 
 	virtual void shutdown();
 
+	/**
+	 * @brief Preprocesses the given buffer for the given stage. The compilation is done in @c init()
+	 */
 	bool load(const core::String& name, const core::String& buffer, ShaderType shaderType);
 
-	core::String getSource(ShaderType shaderType, const core::String& buffer, bool finalize = true, core::List<core::String>* includedFiles = nullptr) const;
+	/**
+	 * @param[out] cacheKey If not @c nullptr this is set to the @c ShaderCache key of the source - or @c 0 if the cache is disabled
+	 */
+	core::String getSource(ShaderType shaderType, const core::String& buffer, bool finalize = true, core::List<core::String>* includedFiles = nullptr, uint64_t* cacheKey = nullptr) const;
 
 	Id handle() const;
 
 	/**
 	 * If the shaders were loaded manually via @c ::load, then you have to initialize the shader manually, too
+	 * @note The program is linked on the first use - see @c link()
 	 */
 	bool init();
 
 	bool isInitialized() const;
 
+	/**
+	 * @brief Finishes the compilation and link of the program. This is done automatically on the first use.
+	 * @note Blocks until the driver is done
+	 * @return @c false if the program could not get linked
+	 */
+	bool link() const;
+	/**
+	 * @brief Finishes the link if the driver completed it in the background - never blocks
+	 * @sa ShaderManager::update()
+	 */
+	void pollLink();
+
 	/**
 	 * @brief The dirty state can be used to determine whether you have to set some
 	 * uniforms again because the shader was reinitialized. This must be used manually
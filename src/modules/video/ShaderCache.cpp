@@ -0,0 +1,296 @@
+/**
+ * @file
+ */
+
+#include "ShaderCache.h"
+#include "app/App.h"
+#include "core/ByteStream.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/Trace.h"
+#include "io/Filesystem.h"
+
+namespace video {
+
+namespace {
+const uint32_t SourceMagic = FourCC('S', 'H', 'S', 'C');
+const uint32_t BinaryMagic = FourCC('S', 'H', 'P', 'B');
+
+bool readFile(const core::String& filename, core::ByteStream& stream) {
+	const io::FilesystemPtr& fs = io::filesystem();
+	if (!fs || !fs->exists(filename)) {
+		return false;
+	}
+	const io::FilePtr& file = fs->open(filename);
+	const long len = file->length();
+	if (len <= 0) {
+		return false;
+	}
+	// read directly into the stream storage
+	if (file->read(stream.writeBuffer(len), (int)len) != (int)len) {
+		return false;
+	}
+	stream.commit(len);
+	return true;
+}
+
+bool readHeader(core::ByteStream& stream, uint32_t magic) {
+	if (stream.getSize() < 2 * sizeof(int32_t)) {
+		return false;
+	}
+	if ((uint32_t)stream.readInt() != magic) {
+		return false;
+	}
+	return stream.readInt() == ShaderCache::Version;
+}
+
+}
+
+uint64_t ShaderCache::hash(const void *data, size_t length, uint64_t seed) {
+	const uint32_t lo = core::hash(data, (int)length, (uint32_t)seed);
+	const uint32_t hi = core::hash(data, (int)length, (uint32_t)(seed >> 32) ^ 0x9e3779b9u);
+	return ((uint64_t)hi << 32) | (uint64_t)lo;
+}
+
+uint64_t ShaderCache::hash(const core::String& data, uint64_t seed) {
+	return hash(data.c_str(), data.size(), seed);
+}
+
+uint64_t ShaderCache::sourceKey(const core::String& name, const core::String& prefix, const core::String& buffer, bool finalize) {
+	uint64_t key = hash(name, finalize ? 1u : 0u);
+	key = hash(prefix, key);
+	key = hash(buffer, key);
+	return key;
+}
+
+uint64_t ShaderCache::programKey(const core::DynamicArray<core::String>& sources, const core::String& extra) const {
+	uint64_t key = hash(_driver, (uint64_t)Version);
+	for (const core::String& source : sources) {
+		key = hash(source, key);
+	}
+	return hash(extra, key);
+}
+
+void ShaderCache::setDriver(const core::String& driver) {
+	_driver = driver;
+}
+
+void ShaderCache::setDirectory(const core::String& directory) {
+	_directory = directory;
+	if (!_directory.empty() && _directory.last() != '/') {
+		_directory += "/";
+	}
+}
+
+core::String ShaderCache::filename(uint64_t key, const char *extension) const {
+	return core::string::format("%s%08x%08x.%s", _directory.c_str(), (uint32_t)(key >> 32), (uint32_t)key, extension);
+}
+
+namespace {
+
+core::String includeStamp(const core::String& path, uint64_t mtime, long size) {
+	return core::string::format("%s|%" SDL_PRIu64 "|%li", path.c_str(), mtime, size);
+}
+
+core::String includeRecord(const core::String& stamp, const core::String& content) {
+	return core::string::format("%s|%016" SDL_PRIX64, stamp.c_str(), ShaderCache::hash(content));
+}
+
+/**
+ * @return The path of a @c path|mtime|size|hash record
+ */
+core::String includePath(const core::String& record) {
+	int separators = 0;
+	for (size_t i = record.size(); i > 0u; --i) {
+		if (record[i - 1] == '|' && ++separators == 3) {
+			return record.substr(0, i - 1);
+		}
+	}
+	return "";
+}
+
+}
+
+bool ShaderCache::validate(SourceEntry& entry, bool& refreshed) const {
+	const io::FilesystemPtr& fs = io::filesystem();
+	core::List<core::String> includes;
+	refreshed = false;
+	for (const core::String& include : entry.includes) {
+		const core::String& path = includePath(include);
+		if (path.empty()) {
+			return false;
+		}
+		const size_t hashSep = include.rfind('|');
+		const io::FilePtr& file = fs->open(path);
+		const uint64_t mtime = file->mtime();
+		const core::String& stamp = includeStamp(path, mtime, file->length());
+		if (mtime != 0u && stamp == include.substr(0, hashSep)) {
+			includes.insert(include);
+			continue;
+		}
+		const core::String& record = includeRecord(stamp, file->load());
+		if (record.substr(record.rfind('|')) != include.substr(hashSep)) {
+			Log::debug("Shader include %s was modified", path.c_str());
+			return false;
+		}
+		includes.insert(record);
+		refreshed = true;
+	}
+	if (refreshed) {
+		entry.includes = includes;
+	}
+	return true;
+}
+
+bool ShaderCache::loadSourceFromDisk(uint64_t key, SourceEntry& entry) const {
+	core::ByteStream stream;
+	if (!readFile(filename(key, "glsl"), stream)) {
+		return false;
+	}
+	if (!readHeader(stream, SourceMagic)) {
+		return false;
+	}
+	if (stream.getSize() < sizeof(int32_t)) {
+		return false;
+	}
+	const int32_t includes = stream.readInt();
+	for (int32_t i = 0; i < includes; ++i) {
+		if (stream.empty()) {
+			return false;
+		}
+		entry.includes.insert(stream.readString());
+	}
+	if (stream.empty()) {
+		return false;
+	}
+	entry.source = stream.readString();
+	entry.persist = true;
+	return true;
+}
+
+void ShaderCache::writeSourceToDisk(uint64_t key, const SourceEntry& entry) const {
+	const io::FilesystemPtr& fs = io::filesystem();
+	if (!fs) {
+		return;
+	}
+	core::ByteStream stream;
+	stream.addInt((int32_t)SourceMagic);
+	stream.addInt(Version);
+	stream.addInt((int32_t)entry.includes.size());
+	for (const core::String& include : entry.includes) {
+		stream.addString(include);
+	}
+	stream.addString(entry.source);
+	const core::String& file = filename(key, "glsl");
+	if (!fs->write(file, stream.getBuffer(), stream.getSize())) {
+		Log::warn("Failed to write shader cache file %s", file.c_str());
+	}
+}
+
+bool ShaderCache::source(uint64_t key, core::String& source, core::List<core::String>* includedFiles) {
+	core_trace_scoped(ShaderCacheSource);
+	SourceEntry entry;
+	bool found = _sources.get(key, entry);
+	if (!found && loadSourceFromDisk(key, entry)) {
+		found = true;
+		_sources.put(key, entry);
+	}
+	bool refreshed = false;
+	if (!found || !validate(entry, refreshed)) {
+		++_stats.sourceMisses;
+		return false;
+	}
+	if (refreshed) {
+		// only the modification time changed - store it to skip hashing the include next time
+		_sources.put(key, entry);
+		if (entry.persist) {
+			writeSourceToDisk(key, entry);
+		}
+	}
+	++_stats.sourceHits;
+	source = entry.source;
+	if (includedFiles != nullptr) {
+		for (const core::String& include : entry.includes) {
+			includedFiles->insert(includePath(include));
+		}
+	}
+	return true;
+}
+
+void ShaderCache::putSource(uint64_t key, const core::String& source, const core::List<core::String>& includedFiles, bool persist) {
+	core_trace_scoped(ShaderCachePutSource);
+	SourceEntry entry;
+	entry.source = source;
+	entry.persist = persist;
+	const io::FilesystemPtr& fs = io::filesystem();
+	for (const core::String& include : includedFiles) {
+		const io::FilePtr& file = fs->open(include);
+		entry.includes.insert(includeRecord(includeStamp(include, file->mtime(), file->length()), file->load()));
+	}
+	_sources.put(key, entry);
+	if (persist) {
+		writeSourceToDisk(key, entry);
+	}
+}
+
+void ShaderCache::releaseSource(uint64_t key) {
+	_sources.remove(key);
+}
+
+bool ShaderCache::loadBinary(uint64_t key, uint32_t& format, core::DynamicArray<uint8_t>& data) {
+	core_trace_scoped(ShaderCacheLoadBinary);
+	core::ByteStream stream;
+	if (!readFile(filename(key, "bin"), stream) || !readHeader(stream, BinaryMagic)
+			|| stream.getSize() < 2 * sizeof(int32_t)) {
+		++_stats.binaryMisses;
+		return false;
+	}
+	format = (uint32_t)stream.readInt();
+	const int32_t length = stream.readInt();
+	if (length <= 0 || (size_t)length != stream.getSize()) {
+		Log::warn("Invalid program binary cache entry for key %08x%08x", (uint32_t)(key >> 32), (uint32_t)key);
+		++_stats.binaryMisses;
+		return false;
+	}
+	data.resize(length);
+	core_memcpy(data.data(), stream.getBuffer(), length);
+	++_stats.binaryHits;
+	return true;
+}
+
+bool ShaderCache::saveBinary(uint64_t key, uint32_t format, const uint8_t* data, size_t length) {
+	core_trace_scoped(ShaderCacheSaveBinary);
+	const io::FilesystemPtr& fs = io::filesystem();
+	if (!fs || data == nullptr || length == 0u) {
+		return false;
+	}
+	core::ByteStream stream((int)(length + 4 * sizeof(int32_t)));
+	stream.addInt((int32_t)BinaryMagic);
+	stream.addInt(Version);
+	stream.addInt((int32_t)format);
+	stream.addInt((int32_t)length);
+	stream.append(data, length);
+	const core::String& file = filename(key, "bin");
+	if (!fs->write(file, stream.getBuffer(), stream.getSize())) {
+		Log::warn("Failed to write program binary %s", file.c_str());
+		return false;
+	}
+	return true;
+}
+
+void ShaderCache::removeBinary(uint64_t key) {
+	const io::FilesystemPtr& fs = io::filesystem();
+	if (!fs) {
+		return;
+	}
+	fs->removeFile(fs->writePath(filename(key, "bin").c_str()));
+}
+
+void ShaderCache::clear() {
+	_sources.clear();
+	_stats = Stats();
+}
+
+}
@@ -0,0 +1,148 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/collection/List.h"
+#include "core/collection/Map.h"
+#include "core/collection/DynamicArray.h"
+#include <stdint.h>
+
+namespace video {
+
+/**
+ * @brief Caches the preprocessed shader sources and the linked program binaries
+ *
+ * The preprocessed sources are keyed by the shader name, the raw shader buffer and the
+ * generated prefix (glsl version, shader cvars and defines). The included files are stored
+ * alongside the source together with their modification time, size and content hash. A lookup
+ * only stats the includes - the content is just hashed again if the modification time or the
+ * size changed.
+ *
+ * The program binaries are keyed by the final stage sources and the driver string. This class
+ * doesn't need a graphics context - the renderer hands in the driver string and the binary blobs.
+ *
+ * @sa Shader::getSource()
+ * @ingroup Video
+ */
+class ShaderCache {
+public:
+	static constexpr int Version = 2;
+
+	struct Stats {
+		int sourceHits = 0;
+		int sourceMisses = 0;
+		int binaryHits = 0;
+		int binaryMisses = 0;
+	};
+private:
+	struct SourceEntry {
+		core::String source;
+		/**
+		 * @c path|mtime|size|hash records of the included files
+		 */
+		core::List<core::String> includes;
+		bool persist = false;
+	};
+	typedef core::Map<uint64_t, SourceEntry, 64> Sources;
+	Sources _sources;
+	core::String _driver;
+	core::String _directory = "shadercache/";
+	Stats _stats;
+
+	core::String filename(uint64_t key, const char *extension) const;
+	bool loadSourceFromDisk(uint64_t key, SourceEntry& entry) const;
+	void writeSourceToDisk(uint64_t key, const SourceEntry& entry) const;
+	/**
+	 * @param[out] refreshed Set to @c true if an include was touched but its content didn't change. The
+	 * records of the entry are updated then.
+	 */
+	bool validate(SourceEntry& entry, bool& refreshed) const;
+public:
+	/**
+	 * @brief 64 bit hash of the given data - used to build the cache keys
+	 */
+	static uint64_t hash(const void *data, size_t length, uint64_t seed = 0u);
+	static uint64_t hash(const core::String& data, uint64_t seed = 0u);
+
+	/**
+	 * @brief The key for the preprocessed source of a single shader stage
+	 * @param[in] name The shader name - also defines the include directory
+	 * @param[in] prefix Everything that is put in front of the shader buffer (version, defines, ...)
+	 * @param[in] buffer The raw shader buffer
+	 * @param[in] finalize Whether the glsl version dependent replacements were applied
+	 */
+	static uint64_t sourceKey(const core::String& name, const core::String& prefix, const core::String& buffer, bool finalize);
+
+	/**
+	 * @brief The key for a linked program binary - this includes the driver string
+	 * @param[in] sources The final sources of all stages of the program
+	 * @param[in] extra Any other state that has an influence on the link step (e.g. transform feedback varyings)
+	 */
+	uint64_t programKey(const core::DynamicArray<core::String>& sources, const core::String& extra = "") const;
+
+	/**
+	 * @brief The driver string is part of the program binary key. A driver update invalidates all binaries.
+	 */
+	void setDriver(const core::String& driver);
+	const core::String& driver() const;
+
+	/**
+	 * @brief Relative to the home path of the application
+	 */
+	void setDirectory(const core::String& directory);
+	const core::String& directory() const;
+
+	/**
+	 * @brief Lookup a preprocessed source in memory or on disk.
+	 * @param[out] includedFiles If not @c nullptr, the files that were included by the source are added here
+	 * @return @c false if the source wasn't found or one of the included files was changed
+	 */
+	bool source(uint64_t key, core::String& source, core::List<core::String>* includedFiles = nullptr);
+	/**
+	 * @brief Put the preprocessed source into the cache
+	 * @param[in] includedFiles The files that were included while preprocessing the source. They are
+	 * validated before a cached source is handed out again.
+	 * @param[in] persist Write the source to disk
+	 */
+	void putSource(uint64_t key, const core::String& source, const core::List<core::String>& includedFiles, bool persist);
+	/**
+	 * @brief Drops the in-memory copy of a source once the program was linked. Persisted sources are
+	 * loaded from disk again on the next lookup.
+	 */
+	void releaseSource(uint64_t key);
+
+	/**
+	 * @brief Loads a program binary blob from disk
+	 * @param[out] format The driver specific binary format
+	 */
+	bool loadBinary(uint64_t key, uint32_t& format, core::DynamicArray<uint8_t>& data);
+	bool saveBinary(uint64_t key, uint32_t format, const uint8_t* data, size_t length);
+	/**
+	 * @brief Removes a program binary from disk - e.g. if the driver rejected it
+	 */
+	void removeBinary(uint64_t key);
+
+	/**
+	 * @brief Drops all in-memory entries - the disk cache is not touched
+	 */
+	void clear();
+
+	const Stats& stats() const;
+};
+
+inline const core::String& ShaderCache::driver() const {
+	return _driver;
+}
+
+inline const core::String& ShaderCache::directory() const {
+	return _directory;
+}
+
+inline const ShaderCache::Stats& ShaderCache::stats() const {
+	return _stats;
+}
+
+}
@@ -26,6 +26,10 @@ void ShaderManager::unregisterShader(Shader* shader) {
 void ShaderManager::update() {
 	core_trace_scoped(ShaderManagerUpdate);
 	if (!core::Var::hasDirtyShaderVars()) {
+		// pick up the programs the driver finished linking in the background
+		for (Shader* shader : _shaders) {
+			shader->pollLink();
+		}
 		return;
 	}
 
@@ -25,6 +25,8 @@ public:
 
 	/**
 	 * @brief Checks whether a shader var was changed, and recompile all shaders if needed.
+	 * Otherwise the shaders that were linked in the background are finished.
+	 * @sa Shader::pollLink()
 	 */
 	void update();
 };
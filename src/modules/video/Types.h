@@ -384,6 +384,8 @@ enum class Feature {
 	ComputeShaders,
 	TransformFeedback,
 	ShaderStorageBufferObject,
+	ProgramBinary,
+	ParallelShaderCompile,
 
 	Max
 };
@@ -393,6 +393,7 @@ app::AppState WindowedApp::onConstruct() {
 	core::Var::get(cfg::ClientGamma, "2.2", core::CV_SHADER)->setHelp("Gamma correction");
 	core::Var::get(cfg::ClientWindowDisplay, 0);
 	core::Var::get(cfg::ClientOpenGLVersion, "3.3", core::CV_READONLY);
+	core::Var::get(cfg::ClientShaderCache, "true")->setHelp("Cache the preprocessed shader sources and program binaries");
 	core::Var::get(cfg::ClientMouseRotationSpeed, "0.01");
 	core::Var::get(cfg::RenderOutline, "false", core::CV_SHADER);
 	core::Var::get(cfg::ClientVSync, "true")->setHelp("Limit the framerate to the monitor refresh rate");
@@ -229,7 +229,9 @@ void setupFeatures() {
 		{"GL_ARB_multi_draw_indirect"},
 		{"GL_ARB_compute_shader"},
 		{"GL_ARB_transform_feedback2"},
-		{"GL_ARB_shader_storage_buffer_object"}
+		{"GL_ARB_shader_storage_buffer_object"},
+		{"GL_ARB_get_program_binary"},
+		{"GL_KHR_parallel_shader_compile"}
 	};
 	static_assert(core::enumVal(Feature::Max) == (int)SDL_arraysize(extensionArray), "Array sizes don't match for Feature enum");
 
@@ -261,6 +263,23 @@ void setupFeatures() {
 		}
 	}
 
+	if (renderState().features[core::enumVal(Feature::ProgramBinary)]) {
+		// the extension might be exposed without supporting a single binary format
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		renderState().features[core::enumVal(Feature::ProgramBinary)] = formats > 0;
+		Log::info("Program binary formats: %i", formats);
+	}
+
+	if (renderState().features[core::enumVal(Feature::ParallelShaderCompile)]) {
+		if (glMaxShaderCompilerThreadsKHR != nullptr) {
+			// let the driver pick the amount of compiler threads
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+		} else {
+			renderState().features[core::enumVal(Feature::ParallelShaderCompile)] = false;
+		}
+	}
+
 #ifdef GL_CLIP_ORIGIN
 	GLenum clipOrigin = 0; glGetIntegerv(GL_CLIP_ORIGIN, (GLint*)&clipOrigin); // Support for GL 4.5's glClipControl(GL_UPPER_LEFT)
 	if (clipOrigin == GL_UPPER_LEFT) {
@@ -11,6 +11,7 @@
 #include "GLMapping.h"
 #include "GLHelper.h"
 #include "video/Shader.h"
+#include "video/ShaderCache.h"
 #include "video/Texture.h"
 #include "video/TextureConfig.h"
 #include "video/StencilConfig.h"
@@ -24,6 +25,7 @@
 #include "core/StringUtil.h"
 #include "core/StandardLib.h"
 #include "core/Algorithm.h"
+#include "core/Singleton.h"
 #include <glm/fwd.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
@@ -48,6 +50,27 @@ static RenderState s;
 #define SANITY_CHECKS_GL 0
 #define DIRECT_STATE_ACCESS 0
 
+static bool checkLinkStatus(Id program, const core::String& name) {
+	const GLuint lid = (GLuint)program;
+	GLint status = 0;
+	glGetProgramiv(lid, GL_LINK_STATUS, &status);
+	checkError();
+	if (status == GL_FALSE) {
+		GLint infoLogLength = 0;
+		glGetProgramiv(lid, GL_INFO_LOG_LENGTH, &infoLogLength);
+		checkError();
+		if (infoLogLength > 1) {
+			GLchar* strInfoLog = new GLchar[infoLogLength + 1];
+			glGetProgramInfoLog(lid, infoLogLength, nullptr, strInfoLog);
+			checkError();
+			const core::String linkLog(strInfoLog, static_cast<size_t>(infoLogLength));
+			Log::error("Failed to link: %s\n%s", name.c_str(), linkLog.c_str());
+			delete[] strInfoLog;
+		}
+	}
+	return status == GL_TRUE;
+}
+
 static void validate(Id handle) {
 #ifdef DEBUG
 	const GLuint lid = (GLuint)handle;
@@ -1477,7 +1500,7 @@ void drawElements(Primitive mode, size_t numIndices, DataType type, void* offset
 	checkError();
 }
 
-void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, size_t amount) {
+void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, size_t amount, void* offset) {
 	video_trace_scoped(DrawElementsInstanced);
 	if (numIndices <= 0) {
 		return;
@@ -1489,7 +1512,7 @@ void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, siz
 	const GLenum glType = _priv::DataTypes[core::enumVal(type)];
 	core_assert_msg(_priv::s.vertexArrayHandle != InvalidId, "No vertex buffer is bound for this draw call");
 	video::validate(_priv::s.programHandle);
-	glDrawElementsInstanced(glMode, (GLsizei)numIndices, glType, nullptr, (GLsizei)amount);
+	glDrawElementsInstanced(glMode, (GLsizei)numIndices, glType, (GLvoid*)offset, (GLsizei)amount);
 	checkError();
 }
 
@@ -1571,6 +1594,14 @@ void enableDebug(DebugSeverity severity) {
 
 bool compileShader(Id id, ShaderType shaderType, const core::String& source, const core::String& name) {
 	video_trace_scoped(CompileShader);
+	if (!startCompileShader(id, source)) {
+		return false;
+	}
+	return checkCompileShader(id, shaderType, source, name);
+}
+
+bool startCompileShader(Id id, const core::String& source) {
+	video_trace_scoped(StartCompileShader);
 	if (id == InvalidId) {
 		return false;
 	}
@@ -1581,7 +1612,15 @@ bool compileShader(Id id, ShaderType shaderType, const core::String& source, con
 	video::checkError();
 	glCompileShader(lid);
 	video::checkError();
+	return true;
+}
 
+bool checkCompileShader(Id id, ShaderType shaderType, const core::String& source, const core::String& name) {
+	video_trace_scoped(CheckCompileShader);
+	if (id == InvalidId) {
+		return false;
+	}
+	const GLuint lid = (GLuint)id;
 	GLint status = 0;
 	glGetShaderiv(lid, GL_COMPILE_STATUS, &status);
 	video::checkError();
@@ -1649,43 +1688,91 @@ bool bindTransformFeedbackVaryings(Id program, TransformFeedbackCaptureMode mode
 	return true;
 }
 
-bool linkComputeShader(Id program, Id comp, const core::String& name) {
-	video_trace_scoped(LinkComputeShader);
+bool startLinkComputeShader(Id program, Id comp) {
+	video_trace_scoped(StartLinkComputeShader);
+	if (program == InvalidId || comp == InvalidId) {
+		return false;
+	}
 	const GLuint lid = (GLuint)program;
 	glAttachShader(lid, comp);
 	video::checkError();
+	if (hasFeature(Feature::ProgramBinary)) {
+		glProgramParameteri(lid, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		video::checkError();
+	}
 	glLinkProgram(lid);
-	GLint status = 0;
-	glGetProgramiv(lid, GL_LINK_STATUS, &status);
 	video::checkError();
-	if (status == GL_FALSE) {
-		GLint infoLogLength = 0;
-		glGetProgramiv(lid, GL_INFO_LOG_LENGTH, &infoLogLength);
-		video::checkError();
+	return true;
+}
 
-		if (infoLogLength > 1) {
-			GLchar* strInfoLog = new GLchar[infoLogLength + 1];
-			glGetShaderInfoLog(lid, infoLogLength, nullptr, strInfoLog);
-			video::checkError();
-			const core::String linkLog(strInfoLog, static_cast<size_t>(infoLogLength));
-			if (status != GL_TRUE) {
-				Log::error("Failed to link: %s\n%s", name.c_str(), linkLog.c_str());
-			} else {
-				Log::info("%s: %s", name.c_str(), linkLog.c_str());
-			}
-			delete[] strInfoLog;
-		}
-	}
-	glDetachShader(lid, comp);
+bool checkLinkComputeShader(Id program, Id comp, const core::String& name) {
+	video_trace_scoped(CheckLinkComputeShader);
+	const bool linked = checkLinkStatus(program, name);
+	glDetachShader((GLuint)program, comp);
 	video::checkError();
-	if (status != GL_TRUE) {
+	if (!linked) {
 		deleteProgram(program);
 		return false;
 	}
+	return true;
+}
 
+bool linkComputeShader(Id program, Id comp, const core::String& name) {
+	video_trace_scoped(LinkComputeShader);
+	if (!startLinkComputeShader(program, comp)) {
+		return false;
+	}
+	return checkLinkComputeShader(program, comp, name);
+}
+
+bool isProgramLinked(Id program) {
+	if (program == InvalidId || !hasFeature(Feature::ParallelShaderCompile)) {
+		return true;
+	}
+	GLint status = GL_FALSE;
+	glGetProgramiv((GLuint)program, GL_COMPLETION_STATUS_KHR, &status);
+	checkError();
+	return status == GL_TRUE;
+}
+
+bool getProgramBinary(Id program, uint32_t& format, core::DynamicArray<uint8_t>& binary) {
+	video_trace_scoped(GetProgramBinary);
+	if (!hasFeature(Feature::ProgramBinary) || program == InvalidId) {
+		return false;
+	}
+	const GLuint lid = (GLuint)program;
+	GLint length = 0;
+	glGetProgramiv(lid, GL_PROGRAM_BINARY_LENGTH, &length);
+	checkError();
+	if (length <= 0) {
+		return false;
+	}
+	binary.resize(length);
+	GLenum binaryFormat = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(lid, (GLsizei)length, &written, &binaryFormat, binary.data());
+	if (checkError() || written <= 0) {
+		return false;
+	}
+	binary.resize(written);
+	format = (uint32_t)binaryFormat;
 	return true;
 }
 
+bool programBinary(Id program, uint32_t format, const uint8_t* binary, size_t length) {
+	video_trace_scoped(ProgramBinary);
+	if (!hasFeature(Feature::ProgramBinary) || program == InvalidId) {
+		return false;
+	}
+	const GLuint lid = (GLuint)program;
+	glProgramBinary(lid, (GLenum)format, binary, (GLsizei)length);
+	checkError(false);
+	GLint status = 0;
+	glGetProgramiv(lid, GL_LINK_STATUS, &status);
+	checkError();
+	return status == GL_TRUE;
+}
+
 bool bindImage(Id textureHandle, AccessMode mode, ImageFormat format) {
 	if (_priv::s.imageHandle == textureHandle && _priv::s.imageFormat == format && _priv::s.imageAccessMode == mode) {
 		return false;
@@ -1727,8 +1814,11 @@ bool runShader(Id program, const glm::uvec3& workGroups, bool wait) {
 	return false;
 }
 
-bool linkShader(Id program, Id vert, Id frag, Id geom, const core::String& name) {
-	video_trace_scoped(LinkShader);
+bool startLinkShader(Id program, Id vert, Id frag, Id geom) {
+	video_trace_scoped(StartLinkShader);
+	if (program == InvalidId || vert == InvalidId || frag == InvalidId) {
+		return false;
+	}
 	const GLuint lid = (GLuint)program;
 	glAttachShader(lid, (GLuint)vert);
 	checkError();
@@ -1738,30 +1828,20 @@ bool linkShader(Id program, Id vert, Id frag, Id geom, const core::String& name)
 		glAttachShader(lid, (GLuint)geom);
 		checkError();
 	}
+	if (hasFeature(Feature::ProgramBinary)) {
+		glProgramParameteri(lid, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		checkError();
+	}
 
 	glLinkProgram(lid);
 	checkError();
-	GLint status = 0;
-	glGetProgramiv(lid, GL_LINK_STATUS, &status);
-	checkError();
-	if (status == GL_FALSE) {
-		GLint infoLogLength = 0;
-		glGetProgramiv(lid, GL_INFO_LOG_LENGTH, &infoLogLength);
-		checkError();
+	return true;
+}
 
-		if (infoLogLength > 1) {
-			GLchar* strInfoLog = new GLchar[infoLogLength + 1];
-			glGetShaderInfoLog(lid, infoLogLength, nullptr, strInfoLog);
-			checkError();
-			const core::String linkLog(strInfoLog, static_cast<size_t>(infoLogLength));
-			if (status != GL_TRUE) {
-				Log::error("Failed to link: %s\n%s", name.c_str(), linkLog.c_str());
-			} else {
-				Log::info("%s: %s", name.c_str(), linkLog.c_str());
-			}
-			delete[] strInfoLog;
-		}
-	}
+bool checkLinkShader(Id program, Id vert, Id frag, Id geom, const core::String& name) {
+	video_trace_scoped(CheckLinkShader);
+	const GLuint lid = (GLuint)program;
+	const bool linked = checkLinkStatus(program, name);
 	glDetachShader(lid, (GLuint)vert);
 	video::checkError();
 	glDetachShader(lid, (GLuint)frag);
@@ -1770,7 +1850,7 @@ bool linkShader(Id program, Id vert, Id frag, Id geom, const core::String& name)
 		glDetachShader(lid, (GLuint)geom);
 		video::checkError();
 	}
-	if (status != GL_TRUE) {
+	if (!linked) {
 		deleteProgram(program);
 		return false;
 	}
@@ -1778,6 +1858,14 @@ bool linkShader(Id program, Id vert, Id frag, Id geom, const core::String& name)
 	return true;
 }
 
+bool linkShader(Id program, Id vert, Id frag, Id geom, const core::String& name) {
+	video_trace_scoped(LinkShader);
+	if (!startLinkShader(program, vert, frag, geom)) {
+		return false;
+	}
+	return checkLinkShader(program, vert, frag, geom, name);
+}
+
 int fetchUniforms(Id program, ShaderUniforms& uniforms, const core::String& name) {
 	video_trace_scoped(FetchUniforms);
 	int n = _priv::fillUniforms(program, uniforms, name, GL_ACTIVE_UNIFORMS, GL_ACTIVE_UNIFORM_MAX_LENGTH, glGetActiveUniformName, glGetUniformLocation, false);
@@ -1902,6 +1990,8 @@ bool init(int windowWidth, int windowHeight, float scaleFactor) {
 	Log::info("GL_VENDOR: %s", glvendor);
 	Log::info("GL_RENDERER: %s", glrenderer);
 	Log::info("GL_VERSION: %s", glversion);
+	core::Singleton<ShaderCache>::getInstance().setDriver(core::string::format("%s|%s|%s",
+			glvendor != nullptr ? glvendor : "", glrenderer != nullptr ? glrenderer : "", glversion != nullptr ? glversion : ""));
 	if (glvendor != nullptr) {
 		const core::String vendor(glvendor);
 		for (int i = 0; i < core::enumVal(Vendor::Max); ++i) {
@@ -1125,6 +1125,18 @@ typedef void (APIENTRY *GLDEBUGPROCARB)(GLenum source,GLenum type,GLuint id,GLen
 #define GL_MAX_COMBINED_SHADER_OUTPUT_RESOURCES 0x8F39
 #define GL_MAX_COMBINED_IMAGE_UNITS_AND_FRAGMENT_OUTPUTS 0x8F39
 
+/* GL_ARB_get_program_binary */
+
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+
+/* GL_KHR_parallel_shader_compile */
+
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
 /* --------------------------- FUNCTION PROTOTYPES --------------------------- */
 
 
@@ -1476,6 +1488,21 @@ GLAPI PFNGLDRAWELEMENTSINDIRECT_PROC* glpfDrawElementsIndirect;
 #define glDrawElementsIndirect glpfDrawElementsIndirect
 
 
+/* GL_ARB_get_program_binary */
+
+typedef void (APIENTRY PFNGLGETPROGRAMBINARY_PROC (GLuint program, GLsizei bufSize, GLsizei * length, GLenum * binaryFormat, void * binary));
+typedef void (APIENTRY PFNGLPROGRAMBINARY_PROC (GLuint program, GLenum binaryFormat, const void * binary, GLsizei length));
+typedef void (APIENTRY PFNGLPROGRAMPARAMETERI_PROC (GLuint program, GLenum pname, GLint value));
+
+GLAPI PFNGLGETPROGRAMBINARY_PROC* glpfGetProgramBinary;
+GLAPI PFNGLPROGRAMBINARY_PROC* glpfProgramBinary;
+GLAPI PFNGLPROGRAMPARAMETERI_PROC* glpfProgramParameteri;
+
+#define glGetProgramBinary glpfGetProgramBinary
+#define glProgramBinary glpfProgramBinary
+#define glProgramParameteri glpfProgramParameteri
+
+
 /* GL_ARB_instanced_arrays */
 
 typedef void (APIENTRY PFNGLVERTEXATTRIBDIVISORARB_PROC (GLuint index, GLuint divisor));
@@ -1545,6 +1572,15 @@ GLAPI PFNGLRESUMETRANSFORMFEEDBACK_PROC* glpfResumeTransformFeedback;
 #define glResumeTransformFeedback glpfResumeTransformFeedback
 
 
+/* GL_KHR_parallel_shader_compile */
+
+typedef void (APIENTRY PFNGLMAXSHADERCOMPILERTHREADSKHR_PROC (GLuint count));
+
+GLAPI PFNGLMAXSHADERCOMPILERTHREADSKHR_PROC* glpfMaxShaderCompilerThreadsKHR;
+
+#define glMaxShaderCompilerThreadsKHR glpfMaxShaderCompilerThreadsKHR
+
+
 /* GL_VERSION_1_0 */
 
 typedef void (APIENTRY PFNGLBLENDFUNC_PROC (GLenum sfactor, GLenum dfactor));
@@ -2656,11 +2692,13 @@ GLAPI PFNGLVERTEXATTRIBP4UIV_PROC* glpfVertexAttribP4uiv;
 #define GL_ARB_debug_output
 #define GL_ARB_direct_state_access
 #define GL_ARB_draw_indirect
+#define GL_ARB_get_program_binary
 #define GL_ARB_instanced_arrays
 #define GL_ARB_multi_draw_indirect
 #define GL_ARB_shader_image_load_store
 #define GL_ARB_shader_storage_buffer_object
 #define GL_ARB_transform_feedback2
+#define GL_KHR_parallel_shader_compile
 #define GL_VERSION_1_0
 #define GL_VERSION_1_1
 #define GL_VERSION_1_2
@@ -2687,6 +2725,8 @@ extern int FLEXT_ARB_compute_shader;
 extern int FLEXT_ARB_shader_image_load_store;
 extern int FLEXT_ARB_transform_feedback2;
 extern int FLEXT_ARB_shader_storage_buffer_object;
+extern int FLEXT_ARB_get_program_binary;
+extern int FLEXT_KHR_parallel_shader_compile;
 
 int flextInit(void);
 
@@ -0,0 +1,141 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "video/ShaderCache.h"
+#include "video/Shader.h"
+#include "io/Filesystem.h"
+#include "core/GameConfig.h"
+#include "core/Singleton.h"
+#include "core/StringUtil.h"
+#include "core/Var.h"
+
+namespace video {
+
+class ShaderCacheTest : public app::AbstractTest {
+protected:
+	ShaderCache _cache;
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		_cache.setDirectory("shadercachetest");
+	}
+};
+
+TEST_F(ShaderCacheTest, testSourceKey) {
+	const uint64_t key = ShaderCache::sourceKey("foo.vert", "#version 330\n", "void main() {}", true);
+	EXPECT_EQ(key, ShaderCache::sourceKey("foo.vert", "#version 330\n", "void main() {}", true));
+	EXPECT_NE(key, ShaderCache::sourceKey("bar.vert", "#version 330\n", "void main() {}", true));
+	EXPECT_NE(key, ShaderCache::sourceKey("foo.vert", "#version 430\n", "void main() {}", true));
+	EXPECT_NE(key, ShaderCache::sourceKey("foo.vert", "#version 330\n", "void main() { }", true));
+	EXPECT_NE(key, ShaderCache::sourceKey("foo.vert", "#version 330\n", "void main() {}", false));
+}
+
+TEST_F(ShaderCacheTest, testProgramKey) {
+	core::DynamicArray<core::String> sources;
+	sources.push_back("vertex");
+	sources.push_back("fragment");
+	_cache.setDriver("vendor|renderer|1.0");
+	const uint64_t key = _cache.programKey(sources);
+	EXPECT_EQ(key, _cache.programKey(sources));
+	EXPECT_NE(key, _cache.programKey(sources, "varyings"));
+	_cache.setDriver("vendor|renderer|1.1");
+	EXPECT_NE(key, _cache.programKey(sources)) << "A driver update must invalidate the program binaries";
+}
+
+TEST_F(ShaderCacheTest, testSourceFromDisk) {
+	const uint64_t key = ShaderCache::sourceKey("testSourceFromDisk", "prefix", "buffer", true);
+	_cache.putSource(key, "preprocessed", core::List<core::String>(), true);
+	_cache.clear();
+	core::String source;
+	ASSERT_TRUE(_cache.source(key, source));
+	EXPECT_EQ("preprocessed", source);
+	EXPECT_EQ(1, _cache.stats().sourceHits);
+}
+
+TEST_F(ShaderCacheTest, testIncludeModified) {
+	const io::FilesystemPtr& filesystem = _testApp->filesystem();
+	ASSERT_TRUE(filesystem->write("shadercachetest_include.glsl", "#define FIRST"));
+	core::List<core::String> includes;
+	includes.insert("shadercachetest_include.glsl");
+	const uint64_t key = ShaderCache::sourceKey("testIncludeModified", "prefix", "buffer", true);
+	_cache.putSource(key, "#define FIRST", includes, false);
+
+	core::String source;
+	core::List<core::String> includedFiles;
+	ASSERT_TRUE(_cache.source(key, source, &includedFiles));
+	EXPECT_EQ(1u, includedFiles.size());
+
+	ASSERT_TRUE(filesystem->write("shadercachetest_include.glsl", "#define SECOND"));
+	EXPECT_FALSE(_cache.source(key, source)) << "The cached source must be invalid after an include was modified";
+	EXPECT_EQ(1, _cache.stats().sourceMisses);
+}
+
+TEST_F(ShaderCacheTest, testIncludeTouched) {
+	const io::FilesystemPtr& filesystem = _testApp->filesystem();
+	ASSERT_TRUE(filesystem->write("shadercachetest_touched.glsl", "#define FIRST"));
+	core::List<core::String> includes;
+	includes.insert("shadercachetest_touched.glsl");
+	const uint64_t key = ShaderCache::sourceKey("testIncludeTouched", "prefix", "buffer", true);
+	_cache.putSource(key, "#define FIRST", includes, false);
+
+	// same content - only the modification time changes
+	ASSERT_TRUE(filesystem->write("shadercachetest_touched.glsl", "#define FIRST"));
+	core::String source;
+	EXPECT_TRUE(_cache.source(key, source)) << "The content of the include didn't change";
+	EXPECT_TRUE(_cache.source(key, source));
+	EXPECT_EQ(2, _cache.stats().sourceHits);
+}
+
+TEST_F(ShaderCacheTest, testReleaseSource) {
+	const uint64_t transientKey = ShaderCache::sourceKey("testReleaseSource", "prefix", "transient", true);
+	_cache.putSource(transientKey, "transient", core::List<core::String>(), false);
+	_cache.releaseSource(transientKey);
+	core::String source;
+	EXPECT_FALSE(_cache.source(transientKey, source));
+
+	const uint64_t key = ShaderCache::sourceKey("testReleaseSource", "prefix", "persisted", true);
+	_cache.putSource(key, "persisted", core::List<core::String>(), true);
+	_cache.releaseSource(key);
+	ASSERT_TRUE(_cache.source(key, source)) << "Persisted sources are loaded from disk again";
+	EXPECT_EQ("persisted", source);
+}
+
+TEST_F(ShaderCacheTest, testBinary) {
+	const uint8_t blob[] = {1, 2, 3, 4, 5, 6, 7};
+	const uint64_t key = 0x1234567890abcdefull;
+	ASSERT_TRUE(_cache.saveBinary(key, 42u, blob, sizeof(blob)));
+	uint32_t format = 0u;
+	core::DynamicArray<uint8_t> data;
+	ASSERT_TRUE(_cache.loadBinary(key, format, data));
+	EXPECT_EQ(42u, format);
+	ASSERT_EQ(sizeof(blob), data.size());
+	for (size_t i = 0; i < sizeof(blob); ++i) {
+		EXPECT_EQ(blob[i], data[i]);
+	}
+	_cache.removeBinary(key);
+	EXPECT_FALSE(_cache.loadBinary(key, format, data));
+}
+
+TEST_F(ShaderCacheTest, testShaderSource) {
+	const core::VarPtr& var = core::Var::get(cfg::ClientShaderCache, "true");
+	const io::FilesystemPtr& filesystem = _testApp->filesystem();
+	ASSERT_TRUE(filesystem->write("shadercachetest.vert", "#define FIRST"));
+	ShaderCache& cache = core::Singleton<ShaderCache>::getInstance();
+	cache.clear();
+
+	Shader s;
+	const core::String& first = s.getSource(ShaderType::Vertex, "#include \"shadercachetest.vert\"");
+	ASSERT_TRUE(core::string::contains(first, "FIRST")) << first;
+	const int hits = cache.stats().sourceHits;
+	EXPECT_EQ(first, s.getSource(ShaderType::Vertex, "#include \"shadercachetest.vert\""));
+	EXPECT_EQ(hits + 1, cache.stats().sourceHits);
+
+	ASSERT_TRUE(filesystem->write("shadercachetest.vert", "#define SECOND"));
+	const core::String& second = s.getSource(ShaderType::Vertex, "#include \"shadercachetest.vert\"");
+	EXPECT_TRUE(core::string::contains(second, "SECOND")) << second;
+	var->setVal("false");
+}
+
+}
@@ -13,41 +13,47 @@
 #include "core/Assert.h"
 #include "core/collection/Map.h"
 #include "core/collection/Array.h"
+#include "core/ByteStream.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
+#include "core/Trace.h"
 #include "commonlua/LUA.h"
 #include "commonlua/LUAFunctions.h"
 #include "voxel/Voxel.h"
 
 namespace voxel {
 
+namespace {
+const uint32_t BlobMagic = FourCC('M', 'C', 'O', 'L');
+const int32_t BlobVersion = 2;
+}
+
+/**
+ * @brief The palette colors and the voxel type to color index mapping
+ *
+ * All lookup tables are built once after the lua script was executed (or loaded from a
+ * cached blob) and are immutable afterwards. A lookup is an array access - no hashing and
+ * no rng construction is involved.
+ */
 class MaterialColor {
 private:
 	MaterialColorArray _materialColors;
-	core::Map<VoxelType, MaterialColorIndices, 8, EnumClassHash> _colorMapping;
+	core::Array<MaterialColorIndices, (int)VoxelType::Max> _colorMapping;
+	core::DynamicArray<uint32_t> _rgba;
 	bool _initialized = false;
 	bool _dirty = false;
-public:
-	MaterialColor() {
-	}
 
-	bool initialized() const {
-		return _initialized;
-	}
-
-	bool init(const uint8_t* paletteBuffer, size_t paletteBufferSize, const core::String& luaString) {
-		if (_initialized) {
-			Log::debug("MaterialColors are already initialized");
-			return true;
-		}
-		_initialized = true;
-		_dirty = true;
+	bool addColors(const uint8_t* paletteBuffer, size_t paletteBufferSize) {
 		_materialColors.reserve(256);
 		const size_t colors = paletteBufferSize / 4;
 		if (colors != _materialColors.capacity()) {
 			Log::error("Palette image has invalid dimensions - we need 256x1(depth: 4)");
 			return false;
 		}
+		_rgba.reserve(colors);
 		const uint32_t* paletteData = (const uint32_t*)paletteBuffer;
 		for (size_t i = 0; i < colors; ++i) {
+			_rgba.push_back(*paletteData);
 			_materialColors.emplace_back(core::Color::fromRGBA(*paletteData));
 			++paletteData;
 		}
@@ -57,13 +63,46 @@ public:
 			Log::warn("Color amount mismatch");
 			return false;
 		}
+		return true;
+	}
+
+	bool validateMapping() const {
+		for (int j = (int)voxel::VoxelType::Air + 1; j < (int)voxel::VoxelType::Max; ++j) {
+			if (_colorMapping[j].empty()) {
+				Log::error("No colors are defined for VoxelType: %s", voxel::VoxelTypeStr[j]);
+				return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	MaterialColor() {
+	}
+
+	bool initialized() const {
+		return _initialized;
+	}
+
+	bool init(const uint8_t* paletteBuffer, size_t paletteBufferSize, const core::String& luaString) {
+		if (_initialized) {
+			Log::debug("MaterialColors are already initialized");
+			return true;
+		}
+		core_trace_scoped(MaterialColorInit);
+		_initialized = true;
+		_dirty = true;
+		if (!addColors(paletteBuffer, paletteBufferSize)) {
+			return false;
+		}
+		const size_t colors = _materialColors.size();
 
 		MaterialColorIndices generic;
 		generic.reserve(colors);
 		for (size_t i = 0; i < colors; ++i) {
 			generic.push_back(i);
 		}
-		_colorMapping.put(voxel::VoxelType::Generic, generic);
+		_colorMapping[(int)voxel::VoxelType::Generic] = generic;
 
 		if (luaString.empty()) {
 			Log::warn("No materials defined in lua script");
@@ -86,14 +125,7 @@ public:
 				core_assert_always(status == 1);
 				for (int j = (int)voxel::VoxelType::Air + 1; j < (int)voxel::VoxelType::Max; ++j) {
 					if (SDL_strcmp(voxel::VoxelTypeStr[j], entry.name) == 0) {
-						auto i = mc->_colorMapping.find((VoxelType)j);
-						if (i == mc->_colorMapping.end()) {
-							MaterialColorIndices indices;
-							indices.push_back(index);
-							mc->_colorMapping.put((VoxelType)j, indices);
-						} else {
-							i->value.push_back(index);
-						}
+						mc->_colorMapping[j].push_back(index);
 						break;
 					}
 				}
@@ -132,20 +164,95 @@ public:
 			return false;
 		}
 
-		for (int j = (int)voxel::VoxelType::Air + 1; j < (int)voxel::VoxelType::Max; ++j) {
-			const auto& i = _colorMapping.find((voxel::VoxelType)j);
-			if (i == _colorMapping.end() || i->value.empty()) {
-				Log::error("No colors are defined for VoxelType: %s", voxel::VoxelTypeStr[j]);
-				return false;
+		return validateMapping();
+	}
+
+	/**
+	 * @brief Serializes the lookup tables - see @c load()
+	 */
+	void save(core::ByteStream& stream) const {
+		core_assert_msg(_initialized, "Material colors are not yet initialized");
+		stream.addInt((int32_t)BlobMagic);
+		stream.addInt(BlobVersion);
+		stream.addShort((int16_t)_materialColors.size());
+		for (uint32_t rgba : _rgba) {
+			stream.addInt((int32_t)rgba);
+		}
+		stream.addShort((int16_t)_colorMapping.size());
+		for (const MaterialColorIndices& indices : _colorMapping) {
+			stream.addShort((int16_t)indices.size());
+			for (uint8_t index : indices) {
+				stream.addByte(index);
 			}
 		}
+	}
 
+	/**
+	 * @brief Initializes the lookup tables from a blob that was created by @c save(). This skips
+	 * the palette image decoding and the lua script execution.
+	 * @return @c false if the blob is invalid or doesn't define colors for every voxel type
+	 */
+	bool load(core::ByteStream& stream) {
+		core_trace_scoped(MaterialColorLoad);
+		if (_initialized) {
+			Log::debug("MaterialColors are already initialized");
+			return true;
+		}
+		if (stream.getSize() < 2 * sizeof(int32_t) + sizeof(int16_t)) {
+			return false;
+		}
+		if ((uint32_t)stream.readInt() != BlobMagic || stream.readInt() != BlobVersion) {
+			Log::debug("Material color blob has an invalid header");
+			return false;
+		}
+		const int colors = stream.readShort();
+		if (colors != 256 || stream.getSize() < colors * sizeof(int32_t) + sizeof(int16_t)) {
+			return false;
+		}
+		core::DynamicArray<uint32_t> palette;
+		palette.reserve(colors);
+		for (int i = 0; i < colors; ++i) {
+			palette.push_back((uint32_t)stream.readInt());
+		}
+		const int types = stream.readShort();
+		if (types != (int)_colorMapping.size()) {
+			return false;
+		}
+		_initialized = true;
+		_dirty = true;
+		if (!addColors((const uint8_t*)palette.data(), palette.size() * sizeof(uint32_t))) {
+			shutdown();
+			return false;
+		}
+		for (MaterialColorIndices& indices : _colorMapping) {
+			if (stream.getSize() < sizeof(int16_t)) {
+				shutdown();
+				return false;
+			}
+			const int amount = stream.readShort();
+			if (amount < 0 || stream.getSize() < (size_t)amount) {
+				shutdown();
+				return false;
+			}
+			indices.reserve(amount);
+			for (int i = 0; i < amount; ++i) {
+				indices.push_back(stream.readByte());
+			}
+		}
+		// a stale or corrupt blob must not install a mapping the lua script would not have created
+		if (_colorMapping[(int)VoxelType::Generic].empty() || !validateMapping()) {
+			shutdown();
+			return false;
+		}
 		return true;
 	}
 
 	void shutdown() {
 		_materialColors.clear();
-		_colorMapping.clear();
+		_rgba.clear();
+		for (MaterialColorIndices& indices : _colorMapping) {
+			indices.clear();
+		}
 		_initialized = false;
 		_dirty = false;
 	}
@@ -165,34 +272,28 @@ public:
 	}
 
 	inline const MaterialColorIndices& getColorIndices(VoxelType type) const {
-		auto i = _colorMapping.find(type);
-		if (i == _colorMapping.end()) {
+		const MaterialColorIndices& indices = _colorMapping[(int)type];
+		if (indices.empty()) {
 			Log::warn("Could not find color indices for voxel type %s - use generic", VoxelTypeStr[(int)type]);
-			i = _colorMapping.find(VoxelType::Generic);
-			if (i == _colorMapping.end()) {
+			const MaterialColorIndices& generic = _colorMapping[(int)VoxelType::Generic];
+			if (generic.empty()) {
 				Log::error("Could not find color indices for voxel type generic");
-				static MaterialColorIndices Empty(0);
-				return Empty;
 			}
+			return generic;
 		}
-		return i->second;
+		return indices;
 	}
 
-	inline Voxel createColorVoxel(VoxelType type, uint32_t colorIndex) {
+	inline Voxel createColorVoxel(VoxelType type, uint32_t colorIndex) const {
 		core_assert_msg(_initialized, "Material colors are not yet initialized");
 		uint8_t index = 0;
 		if (type != VoxelType::Air) {
-			auto i = _colorMapping.find(type);
-			if (i == _colorMapping.end()) {
+			const MaterialColorIndices& indices = _colorMapping[(int)type];
+			if (indices.empty()) {
 				Log::error("Failed to get color indices for voxel type %s", VoxelTypeStr[(int)type]);
 			} else {
-				const MaterialColorIndices& indices = i->second;
-				if (indices.empty()) {
-					Log::error("Failed to get color indices for voxel type %s", VoxelTypeStr[(int)type]);
-				} else {
-					colorIndex %= (uint32_t)indices.size();
-					index = indices[colorIndex];
-				}
+				colorIndex %= (uint32_t)indices.size();
+				index = indices[colorIndex];
 			}
 		}
 		return voxel::createVoxel(type, index);
@@ -202,18 +303,13 @@ public:
 		core_assert_msg(_initialized, "Material colors are not yet initialized");
 		uint8_t index = 0;
 		if (type != VoxelType::Air) {
-			auto i = _colorMapping.find(type);
-			if (i == _colorMapping.end()) {
+			const MaterialColorIndices& indices = _colorMapping[(int)type];
+			if (indices.empty()) {
 				Log::error("Failed to get color indices for voxel type %s", VoxelTypeStr[(int)type]);
+			} else if (indices.size() == 1) {
+				index = indices.front();
 			} else {
-				const MaterialColorIndices& indices = i->second;
-				if (indices.empty()) {
-					Log::error("Failed to get color indices for voxel type %s", VoxelTypeStr[(int)type]);
-				} else if (indices.size() == 1) {
-					index = indices.front();
-				} else {
-					index = *random.randomElement(indices.begin(), indices.end());
-				}
+				index = *random.randomElement(indices.begin(), indices.end());
 			}
 		}
 		return voxel::createVoxel(type, index);
@@ -284,6 +380,21 @@ bool initMinecraftMaterialColors() {
 	return getInstance().init((const uint8_t* )palette, sizeof(palette), "");
 }
 
+/**
+ * @brief Every change of the palette or the lua script leads to a new blob - only the current one is kept
+ */
+static void removeStaleBlobs(const io::FilesystemPtr& filesystem, const core::String& blobFile) {
+	core::DynamicArray<io::Filesystem::DirEntry> entries;
+	filesystem->list(filesystem->homePath(), entries, "materialcolors-*.bin");
+	for (const io::Filesystem::DirEntry& entry : entries) {
+		if (entry.type != io::Filesystem::DirEntry::Type::file || entry.name == blobFile) {
+			continue;
+		}
+		Log::debug("Remove stale material color blob %s", entry.name.c_str());
+		filesystem->removeFile(filesystem->homePath() + entry.name);
+	}
+}
+
 bool initMaterialColors(const io::FilePtr& paletteFile, const io::FilePtr& luaFile) {
 	if (!paletteFile->exists()) {
 		Log::error("%s doesn't exist", paletteFile->name().c_str());
@@ -302,12 +413,45 @@ bool initMaterialColors(const io::FilePtr& paletteFile, const io::FilePtr& luaFi
 	} else {
 		Log::warn("No lua material definition file given");
 	}
+	// the key is built from the raw palette file and the lua script - any change in one of them leads to a new blob
+	const core::String& paletteData = paletteFile->load();
+	uint32_t key = core::hash(paletteData.c_str(), (int)paletteData.size());
+	key = core::hash(luaString.c_str(), (int)luaString.size(), key);
+	const core::String& blobFile = core::string::format("materialcolors-%08x.bin", key);
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	if (filesystem && filesystem->exists(blobFile)) {
+		const io::FilePtr& file = filesystem->open(blobFile);
+		uint8_t *buf = nullptr;
+		const int len = file->read((void **)&buf);
+		core::ByteStream stream;
+		if (len > 0 && buf != nullptr) {
+			stream.append(buf, len);
+		}
+		delete[] buf;
+		if (loadMaterialColors(stream)) {
+			Log::debug("Loaded material colors from %s", blobFile.c_str());
+			return true;
+		}
+		Log::warn("Failed to load the material color blob %s - rebuild it", blobFile.c_str());
+	}
 	const image::ImagePtr& img = image::loadImage(paletteFile, false);
 	if (!img->isLoaded()) {
 		Log::error("Failed to load image %s", paletteFile->name().c_str());
 		return false;
 	}
-	return initMaterialColors(img->data(), img->width() * img->height() * img->depth(), luaString);
+	if (!initMaterialColors(img->data(), img->width() * img->height() * img->depth(), luaString)) {
+		return false;
+	}
+	// without lua definitions the mapping is incomplete and the blob would be rejected by loadMaterialColors()
+	if (filesystem && !luaString.empty()) {
+		core::ByteStream stream;
+		saveMaterialColors(stream);
+		if (!filesystem->write(blobFile, stream.getBuffer(), stream.getSize())) {
+			Log::debug("Failed to write the material color blob %s", blobFile.c_str());
+		}
+		removeStaleBlobs(filesystem, blobFile);
+	}
+	return true;
 }
 
 bool overrideMaterialColors(const io::FilePtr& paletteFile, const io::FilePtr& luaFile) {
@@ -362,9 +506,21 @@ const MaterialColorIndices& getMaterialIndices(VoxelType type) {
 	return getInstance().getColorIndices(type);
 }
 
-Voxel createRandomColorVoxel(VoxelType type) {
-	math::Random random;
-	return createRandomColorVoxel(type, random);
+bool saveMaterialColors(core::ByteStream& stream) {
+	const MaterialColor& mc = getInstance();
+	if (!mc.initialized()) {
+		return false;
+	}
+	mc.save(stream);
+	return true;
+}
+
+bool loadMaterialColors(core::ByteStream& stream) {
+	return getInstance().load(stream);
+}
+
+Voxel createColorVoxel(VoxelType type, const glm::ivec3& pos, uint32_t seed) {
+	return getInstance().createColorVoxel(type, positionHash(pos, seed));
 }
 
 Voxel createColorVoxel(VoxelType type, uint32_t colorIndex) {
@@ -8,6 +8,7 @@
 #include "io/File.h"
 #include "image/Image.h"
 
+#include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include "core/String.h"
 #include "core/collection/DynamicArray.h"
@@ -16,6 +17,10 @@ namespace math {
 class Random;
 }
 
+namespace core {
+class ByteStream;
+}
+
 namespace voxel {
 
 // this size must match the color uniform size in the shader
@@ -34,6 +39,19 @@ extern bool overrideMaterialColors(const uint8_t* paletteBuffer, size_t paletteB
 extern void shutdownMaterialColors();
 extern void materialColorMarkClean();
 extern bool materialColorChanged();
+/**
+ * @brief Serializes the precomputed lookup tables (colors and type to index mapping)
+ * @return @c false if the material colors are not yet initialized
+ */
+extern bool saveMaterialColors(core::ByteStream& stream);
+/**
+ * @brief Initializes the material colors from a blob that was created by @c saveMaterialColors()
+ * @return @c false if the blob is invalid or doesn't define colors for every voxel type - the file based
+ * @c initMaterialColors() rebuilds the blob from the palette and the lua script then
+ * @note The file based @c initMaterialColors() keeps such a blob in the home path and uses it to
+ * skip the image decoding and the lua execution on the next start.
+ */
+extern bool loadMaterialColors(core::ByteStream& stream);
 extern const MaterialColorArray& getMaterialColors();
 extern const glm::vec4& getMaterialColor(const Voxel& voxel);
 
@@ -46,12 +64,29 @@ extern bool createPaletteFile(const image::ImagePtr& image, const char *paletteF
  * @return Indices to the MaterialColorArray for the given VoxelType
  */
 extern const MaterialColorIndices& getMaterialIndices(VoxelType type);
-extern Voxel createRandomColorVoxel(VoxelType type);
 extern Voxel createRandomColorVoxel(VoxelType type, math::Random& random);
 /**
  * @brief Creates a voxel of the given type with the fixed colorindex that is relative to the
  * valid color indices for this type.
  */
 extern Voxel createColorVoxel(VoxelType type, uint32_t colorIndex);
+/**
+ * @brief Creates a voxel of the given type with a color index that only depends on the position and the seed.
+ * This is cheaper than picking a random color and leads to reproducible results.
+ */
+extern Voxel createColorVoxel(VoxelType type, const glm::ivec3& pos, uint32_t seed = 0u);
+
+/**
+ * @brief Deterministic hash of the given position that can be used to select an entry from the @c MaterialColorIndices
+ */
+inline uint32_t positionHash(const glm::ivec3& pos, uint32_t seed = 0u) {
+	uint32_t h = seed ^ ((uint32_t)pos.x * 73856093u) ^ ((uint32_t)pos.y * 19349663u) ^ ((uint32_t)pos.z * 83492791u);
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
 
 }
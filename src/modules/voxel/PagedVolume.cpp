@@ -173,6 +173,55 @@ void PagedVolume::flushAll() {
 	_chunks.clear();
 }
 
+size_t PagedVolume::chunks() const {
+	core::ScopedReadLock readLock(_volumeLock);
+	return _chunks.size();
+}
+
+void PagedVolume::residentChunks(core::DynamicArray<ChunkPtr>& chunks) const {
+	core::ScopedReadLock readLock(_volumeLock);
+	chunks.reserve(chunks.size() + _chunks.size());
+	for (auto i = _chunks.begin(); i != _chunks.end(); ++i) {
+		chunks.push_back(i->second);
+	}
+}
+
+bool PagedVolume::modified(const Region& region) const {
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::ivec3& maxs = region.getUpperCorner();
+	core::ScopedReadLock readLock(_volumeLock);
+	for (int32_t z = mins.z >> _chunkSideLengthPower; z <= maxs.z >> _chunkSideLengthPower; ++z) {
+		for (int32_t y = mins.y >> _chunkSideLengthPower; y <= maxs.y >> _chunkSideLengthPower; ++y) {
+			for (int32_t x = mins.x >> _chunkSideLengthPower; x <= maxs.x >> _chunkSideLengthPower; ++x) {
+				auto i = _chunks.find(glm::ivec3(x, y, z));
+				if (i != _chunks.end() && i->second->modified()) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+PagedVolume::ChunkPtr PagedVolume::createChunk(const glm::ivec3& chunkPos) const {
+	return core::make_shared<Chunk>(chunkPos, _chunkSideLength, _pager);
+}
+
+bool PagedVolume::addChunk(const ChunkPtr& chunk) {
+	core_assert_msg((uint16_t)chunk->sideLength() == _chunkSideLength, "Chunk side length doesn't match the volume");
+	core::ScopedWriteLock writeLock(_volumeLock);
+	const glm::ivec3& pos = chunk->chunkPos();
+	if (_chunks.find(pos) != _chunks.end()) {
+		return false;
+	}
+	chunk->_chunkLastAccessed = ++_timestamper;
+	_chunks.put(pos, chunk);
+	if (_chunks.size() >= _chunkCountLimit) {
+		deleteOldestChunkIfNeeded();
+	}
+	return true;
+}
+
 /**
  * As we have added a chunk we may have exceeded our target chunk limit. Search through the array to
  * determine how many chunks we have, as well as finding the oldest timestamp. Note that this is potentially
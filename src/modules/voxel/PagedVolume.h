@@ -12,6 +12,7 @@
 #include "core/concurrent/ReadWriteLock.h"
 #include "core/concurrent/Atomic.h"
 #include "core/collection/Map.h"
+#include "core/collection/DynamicArray.h"
 #include "core/SharedPtr.h"
 
 namespace voxel {
@@ -60,6 +61,10 @@ public:
 
 		const glm::ivec3& chunkPos() const;
 		int16_t sideLength() const;
+		/**
+		 * @return @c true if the voxels were changed after the chunk was paged in
+		 */
+		bool modified() const;
 
 	private:
 		// This is updated by the PagedVolume and used to discard the least recently used chunks.
@@ -237,6 +242,28 @@ public:
 	/** @brief Removes all voxels from memory */
 	void flushAll();
 
+	/** @return The amount of chunks that are currently in memory */
+	size_t chunks() const;
+	/** @brief Collects the chunks that are currently in memory */
+	void residentChunks(core::DynamicArray<ChunkPtr>& chunks) const;
+	/**
+	 * @return @c true if one of the chunks in memory that intersect the given region was modified after it was paged in
+	 * @note Chunks that are not in memory are not paged in
+	 */
+	bool modified(const Region& region) const;
+
+	/**
+	 * @brief Creates a chunk without asking the pager for the data and without adding it to the volume
+	 * @param chunkPos The position in chunk space
+	 * @sa addChunk()
+	 */
+	ChunkPtr createChunk(const glm::ivec3& chunkPos) const;
+	/**
+	 * @brief Makes a chunk that was filled elsewhere (e.g. restored from a snapshot) resident
+	 * @return @c false if there is already a chunk at this position
+	 */
+	bool addChunk(const ChunkPtr& chunk);
+
 	ChunkPtr chunk(const glm::ivec3& pos) const;
 
 	glm::ivec3 chunkPos(int x, int y, int z) const;
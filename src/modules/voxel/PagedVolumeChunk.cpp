@@ -112,6 +112,10 @@ const glm::ivec3& PagedVolume::Chunk::chunkPos() const {
 	return _chunkSpacePosition;
 }
 
+bool PagedVolume::Chunk::modified() const {
+	return _dataModified;
+}
+
 void PagedVolume::Chunk::setVoxel(const glm::i16vec3& pos, const Voxel& value) {
 	setVoxel(pos.x, pos.y, pos.z, value);
 }
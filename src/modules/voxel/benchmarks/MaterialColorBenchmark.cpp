@@ -0,0 +1,69 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/RandomVoxel.h"
+#include "core/ByteStream.h"
+#include "core/StringUtil.h"
+#include "math/Random.h"
+
+class MaterialColorBenchmark : public app::AbstractBenchmark {
+public:
+	bool onInitApp() override {
+		return voxel::initDefaultMaterialColors();
+	}
+};
+
+BENCHMARK_DEFINE_F(MaterialColorBenchmark, CreateRandomColorVoxelRandom)(benchmark::State &state) {
+	math::Random random;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(voxel::createRandomColorVoxel(voxel::VoxelType::Grass, random));
+	}
+}
+
+BENCHMARK_DEFINE_F(MaterialColorBenchmark, RandomVoxel)(benchmark::State &state) {
+	math::Random random;
+	const voxel::RandomVoxel randomVoxel(voxel::VoxelType::Grass, random);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize((voxel::Voxel)randomVoxel);
+	}
+}
+
+BENCHMARK_DEFINE_F(MaterialColorBenchmark, CreateColorVoxelPosition)(benchmark::State &state) {
+	glm::ivec3 pos(0);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(voxel::createColorVoxel(voxel::VoxelType::Grass, pos));
+		++pos.y;
+	}
+}
+
+BENCHMARK_DEFINE_F(MaterialColorBenchmark, InitFromImage)(benchmark::State &state) {
+	const io::FilesystemPtr& fs = io::filesystem();
+	const io::FilePtr& paletteFile = fs->open(core::string::format("palette-%s.png", voxel::getDefaultPaletteName()));
+	const io::FilePtr& luaFile = fs->open(core::string::format("palette-%s.lua", voxel::getDefaultPaletteName()));
+	const image::ImagePtr& img = image::loadImage(paletteFile, false);
+	const core::String& luaString = luaFile->load();
+	for (auto _ : state) {
+		voxel::shutdownMaterialColors();
+		voxel::initMaterialColors(img->data(), img->width() * img->height() * img->depth(), luaString);
+	}
+}
+
+BENCHMARK_DEFINE_F(MaterialColorBenchmark, InitFromBlob)(benchmark::State &state) {
+	core::ByteStream blob;
+	voxel::saveMaterialColors(blob);
+	for (auto _ : state) {
+		voxel::shutdownMaterialColors();
+		core::ByteStream stream;
+		stream.append(blob.getBuffer(), blob.getSize());
+		voxel::loadMaterialColors(stream);
+	}
+}
+
+BENCHMARK_REGISTER_F(MaterialColorBenchmark, CreateRandomColorVoxelRandom);
+BENCHMARK_REGISTER_F(MaterialColorBenchmark, RandomVoxel);
+BENCHMARK_REGISTER_F(MaterialColorBenchmark, CreateColorVoxelPosition);
+BENCHMARK_REGISTER_F(MaterialColorBenchmark, InitFromImage);
+BENCHMARK_REGISTER_F(MaterialColorBenchmark, InitFromBlob);
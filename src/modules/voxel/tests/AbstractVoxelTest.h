@@ -35,7 +35,7 @@ protected:
 					const float distance = glm::distance(pos, center);
 					Voxel uVoxelValue;
 					if (distance <= 30.0f) {
-						uVoxelValue = createRandomColorVoxel(VoxelType::Grass);
+						uVoxelValue = createColorVoxel(VoxelType::Grass, region.getLowerCorner() + glm::ivec3(x, y, z));
 					}
 
 					chunk->setVoxel(x, y, z, uVoxelValue);
@@ -0,0 +1,127 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "voxel/MaterialColor.h"
+#include "core/ByteStream.h"
+#include "core/Color.h"
+#include "core/FourCC.h"
+#include "io/Filesystem.h"
+
+namespace voxel {
+
+class MaterialColorTest: public AbstractVoxelTest {
+protected:
+	static bool contains(const MaterialColorIndices& indices, uint8_t index) {
+		for (uint8_t i : indices) {
+			if (i == index) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void compare(const MaterialColorIndices& expected, const MaterialColorIndices& actual) {
+		ASSERT_EQ(expected.size(), actual.size());
+		for (size_t i = 0; i < expected.size(); ++i) {
+			EXPECT_EQ(expected[i], actual[i]);
+		}
+	}
+};
+
+TEST_F(MaterialColorTest, testPositionHash) {
+	const MaterialColorIndices& indices = getMaterialIndices(VoxelType::Generic);
+	ASSERT_GT(indices.size(), 1u);
+	bool differs = false;
+	const Voxel& first = createColorVoxel(VoxelType::Generic, glm::ivec3(0));
+	for (int i = 0; i < 64; ++i) {
+		const glm::ivec3 pos(i, -i, i * 3);
+		const Voxel& voxel = createColorVoxel(VoxelType::Generic, pos);
+		EXPECT_TRUE(voxel.isSame(createColorVoxel(VoxelType::Generic, pos))) << "The color must only depend on the position";
+		EXPECT_EQ(VoxelType::Generic, voxel.getMaterial());
+		EXPECT_TRUE(contains(indices, voxel.getColor()));
+		differs |= !voxel.isSame(first);
+	}
+	EXPECT_TRUE(differs) << "Expected to get different colors for different positions";
+}
+
+TEST_F(MaterialColorTest, testSaveLoad) {
+	const MaterialColorArray colors = getMaterialColors();
+	const MaterialColorIndices leaf = getMaterialIndices(VoxelType::Leaf);
+	core::ByteStream stream;
+	ASSERT_TRUE(saveMaterialColors(stream));
+	shutdownMaterialColors();
+	ASSERT_TRUE(loadMaterialColors(stream));
+	EXPECT_TRUE(stream.empty());
+	ASSERT_EQ(colors.size(), getMaterialColors().size());
+	for (size_t i = 0; i < colors.size(); ++i) {
+		EXPECT_EQ(colors[i], getMaterialColors()[i]);
+	}
+	compare(leaf, getMaterialIndices(VoxelType::Leaf));
+}
+
+TEST_F(MaterialColorTest, testRemoveStaleBlobs) {
+	const io::FilesystemPtr& filesystem = _testApp->filesystem();
+	core::DynamicArray<io::Filesystem::DirEntry> entries;
+	filesystem->list(filesystem->homePath(), entries, "materialcolors-*.bin");
+	for (const io::Filesystem::DirEntry& entry : entries) {
+		filesystem->removeFile(filesystem->homePath() + entry.name);
+	}
+	ASSERT_TRUE(filesystem->write("materialcolors-00000000.bin", "stale"));
+	shutdownMaterialColors();
+	ASSERT_TRUE(initDefaultMaterialColors());
+	EXPECT_FALSE(filesystem->exists("materialcolors-00000000.bin"));
+	entries.clear();
+	filesystem->list(filesystem->homePath(), entries, "materialcolors-*.bin");
+	EXPECT_EQ(1u, entries.size()) << "Only the blob of the current palette should be kept";
+}
+
+TEST_F(MaterialColorTest, testLoadInvalid) {
+	core::ByteStream stream;
+	ASSERT_TRUE(saveMaterialColors(stream));
+	shutdownMaterialColors();
+	core::ByteStream truncated;
+	truncated.append(stream.getBuffer(), stream.getSize() / 2);
+	EXPECT_FALSE(loadMaterialColors(truncated));
+	EXPECT_TRUE(initDefaultMaterialColors());
+}
+
+TEST_F(MaterialColorTest, testLoadIncompleteMapping) {
+	const io::FilesystemPtr& filesystem = _testApp->filesystem();
+	core::DynamicArray<io::Filesystem::DirEntry> entries;
+	filesystem->list(filesystem->homePath(), entries, "materialcolors-*.bin");
+	ASSERT_EQ(1u, entries.size());
+	const core::String blobFile = entries[0].name;
+
+	// a blob with a valid header and palette - but only the generic colors are mapped
+	const MaterialColorArray& colors = getMaterialColors();
+	core::ByteStream stream;
+	stream.addInt((int32_t)FourCC('M', 'C', 'O', 'L'));
+	stream.addInt(2);
+	stream.addShort((int16_t)colors.size());
+	for (const glm::vec4& color : colors) {
+		stream.addInt((int32_t)core::Color::getRGBA(color));
+	}
+	stream.addShort((int16_t)VoxelType::Max);
+	for (int i = 0; i < (int)VoxelType::Max; ++i) {
+		if (i == (int)VoxelType::Generic) {
+			stream.addShort(1);
+			stream.addByte(1);
+		} else {
+			stream.addShort(0);
+		}
+	}
+	ASSERT_TRUE(filesystem->write(blobFile, stream.getBuffer(), stream.getSize()));
+	shutdownMaterialColors();
+	core::ByteStream copy;
+	copy.append(stream.getBuffer(), stream.getSize());
+	EXPECT_FALSE(loadMaterialColors(copy));
+
+	ASSERT_TRUE(initDefaultMaterialColors()) << "Expected to rebuild the material colors from the palette";
+	EXPECT_FALSE(getMaterialIndices(VoxelType::Leaf).empty());
+	const io::FilePtr& file = filesystem->open(blobFile);
+	EXPECT_GT((size_t)file->length(), stream.getSize()) << "Expected the rebuilt blob to replace the incomplete one";
+}
+
+}
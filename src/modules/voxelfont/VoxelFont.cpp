@@ -8,6 +8,7 @@
 #include "io/Filesystem.h"
 #include "core/Common.h"
 #include "core/StandardLib.h"
+#include "core/Trace.h"
 #include "voxel/Mesh.h"
 
 #ifdef __clang__
@@ -33,24 +34,10 @@
 namespace voxel {
 
 VoxelFont::~VoxelFont() {
-	core_assert_always(_cache.empty());
+	core_assert_always(_glyphs.empty());
 	shutdown();
 }
 
-void VoxelFont::getGlyphMetrics(int c, int& advance, int& xOffset, int& yOffset, int& ascent) {
-	int advanceWidth, leftSideBearing;
-	stbtt_GetCodepointHMetrics(_font, c, &advanceWidth, &leftSideBearing);
-	advance = (int) (advanceWidth * _scale + 0.5f);
-	int ix0, iy0, ix1, iy1;
-	stbtt_GetCodepointBitmapBox(_font, c, 0, _scale, &ix0, &iy0, &ix1, &iy1);
-	xOffset = ix0;
-	yOffset = iy0;
-
-	int descent, lineGap;
-	stbtt_GetFontVMetrics(_font, &ascent, &descent, &lineGap);
-	ascent = (int) (ascent * _scale + 0.5f);
-}
-
 int VoxelFont::stringWidth(const char *str, int len) const {
 	int width = 0;
 	int i = 0;
@@ -69,6 +56,7 @@ int VoxelFont::stringWidth(const char *str, int len) const {
 
 bool VoxelFont::init(const char* filename, uint8_t size, int thickness, uint8_t optionMask, const char* glyphs) {
 	_optionMask = optionMask;
+	_layouts.clear();
 	core_assert_msg(size < 255, "size %i exceeds max vertices position due to limited data type in Vertex class", size);
 	core_assert_msg(size > 0, "size must be > 0, but is %i", size);
 	const io::FilePtr& file = io::filesystem()->open(filename);
@@ -105,10 +93,12 @@ bool VoxelFont::init(const char* filename, uint8_t size, int thickness, uint8_t
 }
 
 void VoxelFont::shutdown() {
-	for (auto e : _cache) {
-		delete e.second;
+	for (const Glyph& glyph : _glyphs) {
+		delete glyph.mesh;
 	}
-	_cache.clear();
+	_glyphs.clear();
+	_glyphIndices.clear();
+	_layouts.clear();
 
 	delete _font;
 	_font = nullptr;
@@ -177,10 +167,15 @@ bool VoxelFont::renderGlyphs(const char* string) {
 		voxel::Mesh* mesh = new voxel::Mesh(8, 8, true);
 		voxel::extractCubicMesh(&v, region, mesh, voxel::IsQuadNeeded(), region.getLowerCorner(), mergeQuads, mergeQuads);
 		if (mesh->getNoOfIndices() > 0) {
-			_cache[c] = mesh;
+			int advanceWidth, leftSideBearing;
+			stbtt_GetCodepointHMetrics(_font, c, &advanceWidth, &leftSideBearing);
+			const int advance = (int) (advanceWidth * _scale + 0.5f);
+			_glyphIndices[c] = (uint32_t)_glyphs.size();
+			_glyphs.push_back(Glyph{mesh, advance, ix0, iy0});
 			++chars;
 		} else {
 			Log::debug("Could not extract mesh for character %i", c);
+			delete mesh;
 		}
 	}
 	if (_spaceWidth == 0 && chars > 0) {
@@ -189,6 +184,58 @@ bool VoxelFont::renderGlyphs(const char* string) {
 	return true;
 }
 
+int VoxelFont::layout(const char* string, TextLayout& out) const {
+	core_trace_scoped(VoxelFontLayout);
+	const char **s = &string;
+	const int newlines = core::string::count(string, '\n');
+
+	int xBase = 0;
+	int yBase = newlines * lineHeight();
+
+	int charCount = 0;
+
+	for (int c = core::utf8::next(s); c != -1; c = core::utf8::next(s), ++charCount) {
+		if (c == ' ') {
+			xBase += _spaceWidth;
+			continue;
+		}
+		if (c == '\n') {
+			xBase = 0;
+			yBase -= lineHeight();
+			continue;
+		}
+
+		auto iter = _glyphIndices.find(c);
+		if (iter == _glyphIndices.end()) {
+			xBase += _spaceWidth;
+			Log::trace("Could not find character glyph cache for %i", c);
+			continue;
+		}
+
+		const Glyph& glyph = _glyphs[iter->second];
+		out.glyphs.push_back(GlyphInstance{xBase + glyph.xOffset, yBase + glyph.yOffset + _ascent, iter->second});
+		xBase += glyph.advance;
+	}
+	out.charCount += charCount;
+	return charCount;
+}
+
+const TextLayout& VoxelFont::cachedLayout(const char* string) {
+	core_trace_scoped(VoxelFontCachedLayout);
+	const core::String key(string);
+	auto iter = _layouts.find(key);
+	if (iter != _layouts.end()) {
+		return iter->value;
+	}
+	if (_layouts.size() >= MaxLayouts) {
+		_layouts.clear();
+	}
+	_layouts.put(key, TextLayout());
+	iter = _layouts.find(key);
+	layout(string, iter->value);
+	return iter->value;
+}
+
 int VoxelFont::render(const char* string, core::DynamicArray<glm::vec4>& pos, voxel::IndexArray& indices) {
 	return render(string, pos, indices, [] (const voxel::VoxelVertex& vertex, core::DynamicArray<glm::vec4>& pos, int x, int y) {
 		glm::vec4 vp(vertex.position, 1.0f);
@@ -8,6 +8,7 @@
 #include "core/Log.h"
 #include "core/Assert.h"
 #include "core/collection/DynamicArray.h"
+#include "core/collection/StringMap.h"
 #include "voxel/Mesh.h"
 #include <unordered_map>
 #include "core/UTF8.h"
@@ -17,12 +18,53 @@ struct stbtt_fontinfo;
 
 namespace voxel {
 
+/**
+ * @brief A glyph placed by @c VoxelFont::layout()
+ *
+ * @c x and @c y are the offsets of the glyph mesh, @c glyph is the index into @c VoxelFont::glyphMesh()
+ */
+struct GlyphInstance {
+	int32_t x;
+	int32_t y;
+	uint32_t glyph;
+};
+
+/**
+ * @brief The glyphs of a laid out string
+ */
+struct TextLayout {
+	core::DynamicArray<GlyphInstance> glyphs;
+	/**
+	 * @brief The amount of characters - including spaces and newlines
+	 */
+	int charCount = 0;
+};
+
 /**
  * @brief Will take any TTF font and rasterizes into voxels
+ *
+ * Every glyph is rasterized into its own mesh at @c init() time. A string is laid out into one @c GlyphInstance
+ * per visible glyph, which allows renderers to upload the glyph meshes once and only draw the instances.
  */
 class VoxelFont {
+public:
+	/**
+	 * @brief The amount of cached layouts - the cache is cleared once it gets full
+	 */
+	static constexpr size_t MaxLayouts = 1024u;
 private:
-	std::unordered_map<uint32_t, voxel::Mesh*> _cache;
+	struct Glyph {
+		voxel::Mesh* mesh;
+		int advance;
+		int xOffset;
+		int yOffset;
+	};
+	core::DynamicArray<Glyph> _glyphs;
+	/**
+	 * @brief Maps the codepoint to the index in @c _glyphs
+	 */
+	std::unordered_map<uint32_t, uint32_t> _glyphIndices;
+	core::StringMap<TextLayout, 257> _layouts { (int)MaxLayouts };
 	stbtt_fontinfo* _font = nullptr;
 	uint8_t *_ttfBuffer = nullptr;
 	int _size = 0;
@@ -43,8 +85,6 @@ private:
 
 	bool renderGlyphs(const char* string);
 
-	void getGlyphMetrics(int c, int& advance, int& xOffset, int& yOffset, int& ascent);
-
 public:
 	~VoxelFont();
 
@@ -60,43 +100,45 @@ public:
 		return _size;
 	}
 
-	template<class T, class FUNC>
-	int render(const char* string, core::DynamicArray<T>& out, voxel::IndexArray& indices, FUNC&& func) {
-		const char **s = &string;
-		const int newlines = core::string::count(string, '\n');
-
-		int xBase = 0;
-		int yBase = newlines * lineHeight();
-
-		int charCount = 0;
+	/**
+	 * @return The amount of glyph meshes
+	 */
+	inline size_t glyphs() const {
+		return _glyphs.size();
+	}
 
-		for (int c = core::utf8::next(s); c != -1; c = core::utf8::next(s), ++charCount) {
-			if (c == ' ') {
-				xBase += _spaceWidth;
-				continue;
-			}
-			if (c == '\n') {
-				xBase = 0;
-				yBase -= lineHeight();
-				continue;
-			}
+	inline const voxel::Mesh* glyphMesh(uint32_t glyph) const {
+		return _glyphs[glyph].mesh;
+	}
 
-			auto iter = _cache.find(c);
-			if (iter == _cache.end()) {
-				xBase += _spaceWidth;
-				Log::trace("Could not find character glyph cache for %i", c);
-				continue;
-			}
+	/**
+	 * @brief Places the glyphs of the given string - the result is appended to the given layout
+	 * @return The amount of characters - including spaces and newlines
+	 */
+	int layout(const char* string, TextLayout& out) const;
 
-			int advance;
-			int xOffset, yOffset;
-			int ascent;
-			getGlyphMetrics(c, advance, xOffset, yOffset, ascent);
+	/**
+	 * @brief Cached version of @c layout() - the font settings are fixed between @c init() and @c shutdown(),
+	 * so the string is the only key.
+	 * @note The returned reference is valid until the next call
+	 */
+	const TextLayout& cachedLayout(const char* string);
 
-			const int x = xBase + xOffset;
-			const int y = yBase + yOffset + ascent;
+	/**
+	 * @return The amount of cached layouts
+	 */
+	inline size_t cachedLayouts() const {
+		return _layouts.size();
+	}
 
-			const voxel::Mesh* mesh = iter->second;
+	/**
+	 * @brief Expands the glyph meshes of the laid out string into the given vertex and index buffers
+	 */
+	template<class T, class FUNC>
+	int render(const char* string, core::DynamicArray<T>& out, voxel::IndexArray& indices, FUNC&& func) {
+		const TextLayout& textLayout = cachedLayout(string);
+		for (const GlyphInstance& instance : textLayout.glyphs) {
+			const voxel::Mesh* mesh = _glyphs[instance.glyph].mesh;
 			const voxel::IndexType* meshIndices = mesh->getRawIndexData();
 			const voxel::VoxelVertex* meshVertices = mesh->getRawVertexData();
 
@@ -112,16 +154,14 @@ public:
 
 			for (size_t mv = 0; mv < meshNumberVertices; ++mv) {
 				const voxel::VoxelVertex& vp = meshVertices[mv];
-				func(vp, out, x, y);
+				func(vp, out, instance.x, instance.y);
 			}
 			for (size_t mi = 0; mi < meshNumberIndices; ++mi) {
 				// offset by the already added vertices
 				indices.push_back(meshIndices[mi] + positionSize);
 			}
-
-			xBase += advance;
 		}
-		return charCount;
+		return textLayout.charCount;
 	}
 
 	int render(const char* string, core::DynamicArray<glm::vec4>& pos, voxel::IndexArray& indices);
@@ -0,0 +1,61 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "voxelfont/VoxelFont.h"
+#include "voxel/MaterialColor.h"
+
+class VoxelFontBenchmark: public app::AbstractBenchmark {
+protected:
+	voxel::VoxelFont _font;
+	const char *_text = "FPS: 60 - Drawcalls: 1234\nPosition: 128, 64, -512\nHello World!";
+
+public:
+	void onCleanupApp() override {
+		_font.shutdown();
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		return _font.init("font.ttf", 14, 4, voxel::VoxelFont::MergeQuads | voxel::VoxelFont::OriginUpperLeft,
+				" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~");
+	}
+};
+
+BENCHMARK_DEFINE_F(VoxelFontBenchmark, render) (benchmark::State& state) {
+	core::DynamicArray<glm::vec4> positions;
+	voxel::IndexArray indices;
+	for (auto _ : state) {
+		positions.clear();
+		indices.clear();
+		benchmark::DoNotOptimize(_font.render(_text, positions, indices));
+	}
+	state.SetBytesProcessed(state.iterations() * (positions.size() * sizeof(glm::vec4) + indices.size() * sizeof(voxel::IndexType)));
+}
+
+BENCHMARK_DEFINE_F(VoxelFontBenchmark, layout) (benchmark::State& state) {
+	voxel::TextLayout layout;
+	for (auto _ : state) {
+		layout.glyphs.clear();
+		layout.charCount = 0;
+		benchmark::DoNotOptimize(_font.layout(_text, layout));
+	}
+	state.SetBytesProcessed(state.iterations() * layout.glyphs.size() * sizeof(voxel::GlyphInstance));
+}
+
+BENCHMARK_DEFINE_F(VoxelFontBenchmark, cachedLayout) (benchmark::State& state) {
+	size_t glyphs = 0u;
+	for (auto _ : state) {
+		const voxel::TextLayout& layout = _font.cachedLayout(_text);
+		glyphs = layout.glyphs.size();
+		benchmark::DoNotOptimize(layout.glyphs.data());
+	}
+	state.SetBytesProcessed(state.iterations() * glyphs * sizeof(voxel::GlyphInstance));
+}
+
+BENCHMARK_REGISTER_F(VoxelFontBenchmark, render);
+BENCHMARK_REGISTER_F(VoxelFontBenchmark, layout);
+BENCHMARK_REGISTER_F(VoxelFontBenchmark, cachedLayout);
+
+BENCHMARK_MAIN();
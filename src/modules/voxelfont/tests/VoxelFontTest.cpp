@@ -0,0 +1,104 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxelfont/VoxelFont.h"
+#include "voxel/MaterialColor.h"
+
+namespace voxel {
+
+class VoxelFontTest: public app::AbstractTest {
+protected:
+	VoxelFont _font;
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		ASSERT_TRUE(voxel::initDefaultMaterialColors());
+		ASSERT_TRUE(_font.init("font.ttf", 14, 1, VoxelFont::MergeQuads, " HWelowrd!"));
+	}
+
+	void TearDown() override {
+		_font.shutdown();
+		app::AbstractTest::TearDown();
+	}
+};
+
+TEST_F(VoxelFontTest, testLayout) {
+	TextLayout layout;
+	EXPECT_EQ(12, _font.layout("Hello World!", layout));
+	EXPECT_EQ(12, layout.charCount);
+	// the space is not a glyph
+	ASSERT_EQ(11u, layout.glyphs.size());
+	for (size_t i = 1; i < layout.glyphs.size(); ++i) {
+		EXPECT_GT(layout.glyphs[i].x, layout.glyphs[i - 1].x);
+		EXPECT_LT(layout.glyphs[i].glyph, _font.glyphs());
+	}
+	// same character, same glyph mesh
+	EXPECT_EQ(layout.glyphs[2].glyph, layout.glyphs[3].glyph);
+	EXPECT_EQ(layout.glyphs[4].glyph, layout.glyphs[6].glyph);
+}
+
+TEST_F(VoxelFontTest, testLayoutNewline) {
+	TextLayout layout;
+	EXPECT_EQ(5, _font.layout("He\nlo", layout));
+	ASSERT_EQ(4u, layout.glyphs.size());
+	// the second line starts at the left again
+	EXPECT_LT(layout.glyphs[2].x, layout.glyphs[1].x);
+	// the first line is above the second one
+	EXPECT_GT(layout.glyphs[0].y - layout.glyphs[2].y, _font.lineHeight() / 2);
+}
+
+TEST_F(VoxelFontTest, testLayoutMatchesRender) {
+	const char *text = "Hello\nWorld!";
+	TextLayout layout;
+	_font.layout(text, layout);
+
+	core::DynamicArray<glm::vec4> positions;
+	voxel::IndexArray indices;
+	EXPECT_EQ(layout.charCount, _font.render(text, positions, indices));
+
+	size_t vertexOffset = 0u;
+	for (const GlyphInstance& glyph : layout.glyphs) {
+		const voxel::Mesh* mesh = _font.glyphMesh(glyph.glyph);
+		const voxel::VoxelVertex* vertices = mesh->getRawVertexData();
+		for (size_t i = 0; i < mesh->getNoOfVertices(); ++i) {
+			const glm::vec4& pos = positions[vertexOffset + i];
+			ASSERT_FLOAT_EQ(vertices[i].position.x + glyph.x, pos.x);
+			ASSERT_FLOAT_EQ(vertices[i].position.y + glyph.y, pos.y);
+			ASSERT_FLOAT_EQ(vertices[i].position.z, pos.z);
+		}
+		vertexOffset += mesh->getNoOfVertices();
+	}
+	EXPECT_EQ(vertexOffset, positions.size());
+}
+
+TEST_F(VoxelFontTest, testCachedLayout) {
+	const TextLayout& layout = _font.cachedLayout("Hello");
+	EXPECT_EQ(1u, _font.cachedLayouts());
+	EXPECT_EQ(&layout, &_font.cachedLayout("Hello"));
+	EXPECT_EQ(1u, _font.cachedLayouts());
+	_font.cachedLayout("World");
+	EXPECT_EQ(2u, _font.cachedLayouts());
+
+	TextLayout uncached;
+	_font.layout("Hello", uncached);
+	const TextLayout& cached = _font.cachedLayout("Hello");
+	ASSERT_EQ(uncached.glyphs.size(), cached.glyphs.size());
+	for (size_t i = 0; i < cached.glyphs.size(); ++i) {
+		EXPECT_EQ(uncached.glyphs[i].x, cached.glyphs[i].x);
+		EXPECT_EQ(uncached.glyphs[i].y, cached.glyphs[i].y);
+		EXPECT_EQ(uncached.glyphs[i].glyph, cached.glyphs[i].glyph);
+	}
+}
+
+TEST_F(VoxelFontTest, testCachedLayoutLimit) {
+	for (size_t i = 0; i < VoxelFont::MaxLayouts; ++i) {
+		_font.cachedLayout(core::string::toString((int)i).c_str());
+	}
+	EXPECT_EQ(VoxelFont::MaxLayouts, _font.cachedLayouts());
+	_font.cachedLayout("Hello");
+	EXPECT_EQ(1u, _font.cachedLayouts());
+}
+
+}
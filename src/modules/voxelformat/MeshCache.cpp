@@ -19,36 +19,34 @@ MeshCache::~MeshCache() {
 	core_assert_msg(_initCalls == 0, "MeshCache wasn't shut down properly: %i", _initCalls);
 }
 
-voxel::Mesh& MeshCache::cacheEntry(const char *fullPath) {
+const std::shared_ptr<voxel::Mesh>& MeshCache::cacheEntry(const char *fullPath) {
 	auto i = _meshes.find(fullPath);
 	if (i == _meshes.end()) {
-		voxel::Mesh* mesh = new voxel::Mesh();
-		_meshes.put(fullPath, mesh);
+		_meshes.put(fullPath, std::make_shared<voxel::Mesh>());
 		Log::debug("New mesh cache entry for path %s", fullPath);
-		return *mesh;
+		i = _meshes.find(fullPath);
 	}
-	return *i->second;
+	return i->second;
 }
 
 bool MeshCache::removeMesh(const char *fullPath) {
 	auto i = _meshes.find(fullPath);
 	if (i != _meshes.end()) {
-		delete i->second;
 		_meshes.erase(i);
 		return true;
 	}
 	return false;
 }
 
-const voxel::Mesh* MeshCache::getMesh(const char *fullPath) {
-	voxel::Mesh &cachedMesh = cacheEntry(fullPath);
-	if (cachedMesh.getNoOfVertices() > 0) {
-		return &cachedMesh;
+MeshPtr MeshCache::getMesh(const char *fullPath) {
+	const std::shared_ptr<voxel::Mesh> &cachedMesh = cacheEntry(fullPath);
+	if (cachedMesh->getNoOfVertices() > 0) {
+		return cachedMesh;
 	}
-	if (loadMesh(fullPath, cachedMesh)) {
-		return &cachedMesh;
+	if (loadMesh(fullPath, *cachedMesh)) {
+		return cachedMesh;
 	}
-	return nullptr;
+	return MeshPtr();
 }
 
 bool MeshCache::loadMesh(const char* fullPath, voxel::Mesh& mesh) {
@@ -103,9 +101,6 @@ void MeshCache::shutdown() {
 	if (_initCalls > 0) {
 		return;
 	}
-	for (const auto & e : _meshes) {
-		delete e->value;
-	}
 	_meshes.clear();
 }
 
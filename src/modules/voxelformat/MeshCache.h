@@ -12,19 +12,24 @@
 
 namespace voxelformat {
 
+/**
+ * @brief A cached mesh stays alive as long as somebody references it - even if it was removed from the cache
+ */
+using MeshPtr = std::shared_ptr<const voxel::Mesh>;
+
 /**
  * @brief Cache @c voxel::Mesh instances by their name
  */
 class MeshCache : public core::IComponent {
 protected:
-	core::StringMap<voxel::Mesh*> _meshes;
+	core::StringMap<std::shared_ptr<voxel::Mesh>> _meshes;
 	int _initCalls = 0;
 
-	voxel::Mesh& cacheEntry(const char *fullPath);
+	const std::shared_ptr<voxel::Mesh>& cacheEntry(const char *fullPath);
 	bool loadMesh(const char* fullPath, voxel::Mesh& mesh);
 public:
 	~MeshCache();
-	const voxel::Mesh* getMesh(const char *fullPath);
+	MeshPtr getMesh(const char *fullPath);
 	bool removeMesh(const char *fullPath);
 	bool init() override;
 	void shutdown() override;
@@ -26,7 +26,6 @@ static const bool MergeCompounds = true;
 #define wrapSaveFree(write) \
 	if (write == false) { \
 		Log::error("Could not save qbt file: " CORE_STRINGIFY(write) " failed"); \
-		delete[] compressedBuf; \
 		delete[] zlibBuffer; \
 		return false; \
 	}
@@ -52,8 +51,7 @@ bool QBTFormat::saveMatrix(io::FileStream& stream, const VoxelVolume& volume, bo
 	const int zlibBufSize = size.x * size.y * size.z * sizeof(uint32_t);
 	core_assert(zlibBufSize > 0);
 	uint8_t * const zlibBuffer = new uint8_t[zlibBufSize];
-	const uint32_t compressedBufSize = core::zip::compressBound(zlibBufSize);
-	uint8_t *compressedBuf = new uint8_t[compressedBufSize];
+	core::Buffer<uint8_t> compressedBuf;
 
 	uint8_t* zlibBuf = zlibBuffer;
 	for (int x = mins.x; x <= maxs.x; ++x) {
@@ -87,13 +85,12 @@ bool QBTFormat::saveMatrix(io::FileStream& stream, const VoxelVolume& volume, bo
 		}
 	}
 
-	size_t realBufSize = 0;
-	if (!core::zip::compress(zlibBuffer, zlibBufSize, compressedBuf, compressedBufSize, &realBufSize)) {
-		delete[] compressedBuf;
+	if (!core::zip::compressor().compress(zlibBuffer, zlibBufSize, compressedBuf)) {
 		delete[] zlibBuffer;
 		return false;
 	}
 
+	const size_t realBufSize = compressedBuf.size();
 	wrapSaveFree(stream.addInt(0)); // node type matrix
 	const int nameLength = volume.name.size();
 	const int nameSize = sizeof(uint32_t) + nameLength;
@@ -129,10 +126,9 @@ bool QBTFormat::saveMatrix(io::FileStream& stream, const VoxelVolume& volume, bo
 
 	Log::debug("save %i compressed bytes", (int)realBufSize);
 	wrapSaveFree(stream.addInt(realBufSize));
-	wrapSaveFree(stream.append(compressedBuf, realBufSize));
+	wrapSaveFree(stream.append(compressedBuf.data(), realBufSize));
 	const size_t chunkEndPos = stream.pos();
 
-	delete[] compressedBuf;
 	delete[] zlibBuffer;
 
 	return (size_t)datasize == chunkEndPos - chunkStartPos;
@@ -27,11 +27,12 @@ bool CachedMeshRenderer::removeMesh(int index) {
 }
 
 int CachedMeshRenderer::addMesh(const char *fullpath, const glm::mat4& model) {
-	const voxel::Mesh* mesh = _meshCache->getMesh(fullpath);
-	if (mesh == nullptr) {
+	// the meshes are never removed from this cache - the renderer may keep the raw pointer
+	const voxelformat::MeshPtr& mesh = _meshCache->getMesh(fullpath);
+	if (!mesh) {
 		return -1;
 	}
-	return _meshRenderer.addMesh(mesh, model);
+	return _meshRenderer.addMesh(mesh.get(), model);
 }
 
 bool CachedMeshRenderer::setModelMatrix(int idx, const glm::mat4& model) {
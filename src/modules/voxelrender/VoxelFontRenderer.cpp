@@ -3,17 +3,19 @@
  */
 
 #include "VoxelFontRenderer.h"
+#include "core/Algorithm.h"
+#include "core/Trace.h"
 #include "core/collection/DynamicArray.h"
 
 namespace voxelrender {
 
 VoxelFontRenderer::VoxelFontRenderer(int fontSize, int depth, uint8_t optionMask) :
-		_colorShader(shader::ColorShader::getInstance()), _fontSize(fontSize), _depth(depth), _optionMask(optionMask) {
+		_voxelFontShader(shader::VoxelFontShader::getInstance()), _fontSize(fontSize), _depth(depth), _optionMask(optionMask) {
 }
 
 bool VoxelFontRenderer::init() {
-	if (!_colorShader.setup()) {
-		Log::error("Failed to init color shader");
+	if (!_voxelFontShader.setup()) {
+		Log::error("Failed to init voxel font shader");
 		return false;
 	}
 
@@ -39,38 +41,97 @@ bool VoxelFontRenderer::init() {
 		Log::error("Failed to create vertex buffer");
 		return false;
 	}
-	_vertexBuffer.setMode(_vertexBufferId, video::BufferMode::Dynamic);
 	_vertexBufferIndexId = _vertexBuffer.create(nullptr, 0, video::BufferType::IndexBuffer);
 	if (_vertexBufferIndexId < 0) {
 		Log::error("Failed to create index buffer");
 		return false;
 	}
+	_instanceBufferId = _vertexBuffer.create();
+	if (_instanceBufferId < 0) {
+		Log::error("Failed to create instance buffer");
+		return false;
+	}
+	_vertexBuffer.setMode(_instanceBufferId, video::BufferMode::Dynamic);
 
-	const video::Attribute& attribPos = _colorShader.getPosAttribute(_vertexBufferId, &VertexData::AttributeData::vertex);
-	if (!_vertexBuffer.addAttribute(attribPos)) {
-		Log::error("Failed to add position attribute");
+	if (!uploadGlyphs()) {
+		Log::error("Failed to upload the glyph meshes");
+		return false;
+	}
+
+	_posAttribute = _voxelFontShader.getPosAttribute(_vertexBufferId, &GlyphVertex::pos);
+	_offsetAttribute = _voxelFontShader.getOffsetAttribute(_instanceBufferId, &TextInstance::offset);
+	_offsetAttribute.divisor = 1;
+	_colorAttribute = _voxelFontShader.getColorAttribute(_instanceBufferId, &TextInstance::color);
+	_colorAttribute.divisor = 1;
+	return setupAttributes(0u);
+}
+
+bool VoxelFontRenderer::uploadGlyphs() {
+	core::DynamicArray<GlyphVertex> vertices;
+	core::DynamicArray<uint32_t> indices;
+	const size_t glyphs = _voxelFont.glyphs();
+	_glyphRanges.reserve(glyphs);
+	for (size_t i = 0; i < glyphs; ++i) {
+		const voxel::Mesh* mesh = _voxelFont.glyphMesh((uint32_t)i);
+		const voxel::VoxelVertex* meshVertices = mesh->getRawVertexData();
+		const voxel::IndexType* meshIndices = mesh->getRawIndexData();
+		const size_t meshNumberVertices = mesh->getNoOfVertices();
+		const size_t meshNumberIndices = mesh->getNoOfIndices();
+		const uint32_t baseVertex = (uint32_t)vertices.size();
+		_glyphRanges.push_back(GlyphRange{(uint32_t)indices.size(), (uint32_t)meshNumberIndices});
+		vertices.reserve(vertices.size() + meshNumberVertices);
+		indices.reserve(indices.size() + meshNumberIndices);
+		for (size_t mv = 0; mv < meshNumberVertices; ++mv) {
+			vertices.push_back(GlyphVertex{glm::vec4(meshVertices[mv].position, 1.0f)});
+		}
+		for (size_t mi = 0; mi < meshNumberIndices; ++mi) {
+			// offset by the already added vertices
+			indices.push_back(meshIndices[mi] + baseVertex);
+		}
+	}
+	if (vertices.empty()) {
 		return false;
 	}
+	if (!_vertexBuffer.update(_vertexBufferId, vertices.data(), vertices.size() * sizeof(GlyphVertex))) {
+		return false;
+	}
+	return _vertexBuffer.update(_vertexBufferIndexId, indices.data(), indices.size() * sizeof(uint32_t));
+}
 
-	const video::Attribute& attribColor = _colorShader.getColorAttribute(_vertexBufferId, &VertexData::AttributeData::color);
+bool VoxelFontRenderer::setupAttributes(uint32_t firstInstance) {
+	_vertexBuffer.clearAttributes();
+	if (!_vertexBuffer.addAttribute(_posAttribute)) {
+		Log::error("Failed to add position attribute");
+		return false;
+	}
+	video::Attribute attribOffset = _offsetAttribute;
+	attribOffset.offset += firstInstance * sizeof(TextInstance);
+	if (!_vertexBuffer.addAttribute(attribOffset)) {
+		Log::error("Failed to add offset attribute");
+		return false;
+	}
+	video::Attribute attribColor = _colorAttribute;
+	attribColor.offset += firstInstance * sizeof(TextInstance);
 	if (!_vertexBuffer.addAttribute(attribColor)) {
 		Log::error("Failed to add color attribute");
 		return false;
 	}
-
 	return true;
 }
 
 void VoxelFontRenderer::shutdown() {
-	_colorShader.shutdown();
+	_voxelFontShader.shutdown();
 	_vertexBuffer.shutdown();
 	_voxelFont.shutdown();
 
 	_vertexBufferId = -1;
 	_vertexBufferIndexId = -1;
+	_instanceBufferId = -1;
 
-	_indices.clear();
-	_data.vertices.clear();
+	_glyphRanges.clear();
+	_instances.clear();
+	_uploadedInstances.clear();
+	_runs.clear();
 	_modelMatrix = glm::mat4(1.0f);
 	_viewProjectionMatrix = glm::mat4(1.0f);
 }
@@ -85,33 +146,56 @@ void VoxelFontRenderer::text(const glm::ivec3& pos, const glm::vec4& color, cons
 	buf[sizeof(buf) - 1] = '\0';
 	va_end(ap);
 
-	_voxelFont.render(buf, _data.vertices, _indices, [&] (const voxel::VoxelVertex& vertex, core::DynamicArray<VertexData::AttributeData>& data, int x, int y) {
-		const VertexData::AttributeData vp{glm::vec4(vertex.position.x + x + pos.x, vertex.position.y + y + pos.y, vertex.position.z + pos.z, 1.0f), color};
-		data.push_back(vp);
-	});
+	const voxel::TextLayout& layout = _voxelFont.cachedLayout(buf);
+	_instances.reserve(_instances.size() + layout.glyphs.size());
+	for (const voxel::GlyphInstance& glyph : layout.glyphs) {
+		const glm::vec3 offset(glyph.x + pos.x, glyph.y + pos.y, pos.z);
+		_instances.push_back(TextInstance{offset, color, glyph.glyph});
+	}
 }
 
 void VoxelFontRenderer::swapBuffers() {
-	// TODO: the vertices should only be uploaded once for the whole glyph set. only the ibo should be dynamic and re-uploaded
-	_vertexBuffer.update(_vertexBufferId, &_data.vertices.front(), _data.vertices.size() * sizeof(voxel::VertexArray::value_type));
-	_vertexBuffer.update(_vertexBufferIndexId, &_indices.front(), _indices.size() * sizeof(voxel::IndexArray::value_type));
+	core_trace_scoped(VoxelFontRendererSwapBuffers);
+	core::sort(_instances.begin(), _instances.end(), [] (const TextInstance& lhs, const TextInstance& rhs) {
+		return lhs.glyph < rhs.glyph;
+	});
 
-	_indices.clear();
-	_data.vertices.clear();
+	const bool changed = _instances.size() != _uploadedInstances.size()
+			|| (!_instances.empty() && SDL_memcmp(_instances.data(), _uploadedInstances.data(), _instances.size() * sizeof(TextInstance)) != 0);
+	if (changed) {
+		_runs.clear();
+		for (size_t i = 0; i < _instances.size(); ++i) {
+			const uint32_t glyph = _instances[i].glyph;
+			if (_runs.empty() || _runs.back().glyph != glyph) {
+				_runs.push_back(GlyphRun{glyph, (uint32_t)i, 0u});
+			}
+			++_runs.back().instances;
+		}
+		if (!_instances.empty()) {
+			_vertexBuffer.update(_instanceBufferId, _instances.data(), _instances.size() * sizeof(TextInstance));
+		}
+		_uploadedInstances = _instances;
+	}
+
+	_instances.clear();
 }
 
 void VoxelFontRenderer::render() {
-	const size_t elements = _vertexBuffer.elements(_vertexBufferIndexId, 1, sizeof(uint32_t));
-	if (elements <= 0u) {
+	if (_runs.empty()) {
 		return;
 	}
 
-	video::ScopedShader scoped(_colorShader);
-	_colorShader.setViewprojection(_viewProjectionMatrix);
-	_colorShader.setModel(_modelMatrix);
+	video::ScopedShader scoped(_voxelFontShader);
+	_voxelFontShader.setViewprojection(_viewProjectionMatrix);
+	_voxelFontShader.setModel(_modelMatrix);
 
-	video::ScopedBuffer scopedBuf(_vertexBuffer);
-	video::drawElements<uint32_t>(video::Primitive::Triangles, elements);
+	for (const GlyphRun& run : _runs) {
+		setupAttributes(run.firstInstance);
+		const GlyphRange& range = _glyphRanges[run.glyph];
+		video::ScopedBuffer scopedBuf(_vertexBuffer);
+		video::drawElementsInstanced<uint32_t>(video::Primitive::Triangles, range.indices, run.instances,
+				(void*)(intptr_t)(range.firstIndex * sizeof(uint32_t)));
+	}
 }
 
 }
@@ -11,36 +11,67 @@
 #include "video/Camera.h"
 #include "video/Buffer.h"
 #include "voxelfont/VoxelFont.h"
-#include "RenderShaders.h"
+#include "VoxelrenderShaders.h"
 
 namespace voxelrender {
 
+/**
+ * @brief Renders text with a @c voxel::VoxelFont
+ *
+ * The glyph meshes are uploaded once at @c init() time. Every visible character of a text is a small instance
+ * record (offset, color and glyph) and one instanced draw call is issued per glyph.
+ */
 class VoxelFontRenderer : public core::IComponent {
 private:
-	struct VertexData {
-		struct AttributeData {
-			glm::vec4 vertex;
-			glm::vec3 color {core::Color::Red};
-		};
-		core::DynamicArray<AttributeData> vertices;
-
-		inline void reserve(size_t amount) {
-			vertices.resize(amount);
-		}
+	struct GlyphVertex {
+		glm::vec4 pos;
+	};
+	struct TextInstance {
+		glm::vec3 offset;
+		glm::vec4 color;
+		uint32_t glyph;
+	};
+	/**
+	 * @brief The indices of a glyph mesh in the shared index buffer
+	 */
+	struct GlyphRange {
+		uint32_t firstIndex;
+		uint32_t indices;
+	};
+	/**
+	 * @brief Consecutive instances of the same glyph
+	 */
+	struct GlyphRun {
+		uint32_t glyph;
+		uint32_t firstInstance;
+		uint32_t instances;
 	};
 
 	voxel::VoxelFont _voxelFont;
-	shader::ColorShader& _colorShader;
+	shader::VoxelFontShader& _voxelFontShader;
 	video::Buffer _vertexBuffer;
 	int32_t _vertexBufferId = -1;
 	int32_t _vertexBufferIndexId = -1;
+	int32_t _instanceBufferId = -1;
 	glm::mat4 _viewProjectionMatrix { 1.0f };
 	glm::mat4 _modelMatrix { 1.0f };
-	voxel::IndexArray _indices;
-	VertexData _data;
+	core::DynamicArray<GlyphRange> _glyphRanges;
+	core::DynamicArray<TextInstance> _instances;
+	core::DynamicArray<TextInstance> _uploadedInstances;
+	core::DynamicArray<GlyphRun> _runs;
+	video::Attribute _posAttribute;
+	video::Attribute _offsetAttribute;
+	video::Attribute _colorAttribute;
 	const int _fontSize;
 	const int _depth;
 	const uint8_t _optionMask;
+
+	bool uploadGlyphs();
+	/**
+	 * @brief Let the per instance attributes start at the given instance - there is no base instance support
+	 * for instanced draw calls
+	 */
+	bool setupAttributes(uint32_t firstInstance);
 public:
 	VoxelFontRenderer(int fontSize, int depth = 4, uint8_t optionMask = voxel::VoxelFont::OriginUpperLeft | voxel::VoxelFont::MergeQuads);
 
@@ -51,13 +82,14 @@ public:
 	void setModelMatrix(const glm::mat4& modelMatrix);
 
 	/**
-	 * @brief Add the indices and vertices data to the local buffers to render the given string
+	 * @brief Add the glyph instances of the given string to the local buffer - the layouts are cached
 	 * @note Before rendering the buffers, you have to call @c swapBuffers()
 	 */
 	void text(const glm::ivec3& pos, const glm::vec4& color, CORE_FORMAT_STRING const char *string, ...) CORE_PRINTF_VARARG_FUNC(4);
 
 	/**
-	 * @brief Update the gpu buffers and reset local vertex and index buffers for the next usage
+	 * @brief Update the instance buffer and reset the local buffer for the next usage
+	 * @note The instances are only uploaded if they differ from the last call
 	 */
 	void swapBuffers();
 
@@ -0,0 +1,15 @@
+uniform mat4 u_viewprojection;
+uniform mat4 u_model;
+
+layout(location = 0) $in vec4 a_pos;
+// per glyph instance
+layout(location = 1) $in vec3 a_offset;
+layout(location = 2) $in vec4 a_color;
+
+$out vec4 v_color;
+
+void main()
+{
+	v_color = a_color;
+	gl_Position = u_viewprojection * u_model * (a_pos + vec4(a_offset, 0.0));
+}
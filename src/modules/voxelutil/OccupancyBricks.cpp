@@ -0,0 +1,138 @@
+/**
+ * @file
+ */
+
+#include "OccupancyBricks.h"
+#include "core/Trace.h"
+#include "core/Common.h"
+
+namespace voxel {
+
+void OccupancyBricks::clear() {
+	_volume = nullptr;
+	_region = Region::InvalidRegion;
+	_dirtyRegion = Region::InvalidRegion;
+	_bricks = glm::ivec3(0);
+	_superBricks = glm::ivec3(0);
+	_brickBits.clear();
+	_superBrickCounts.clear();
+	_occupiedBricks = 0;
+	++_generation;
+}
+
+void OccupancyBricks::build(const RawVolume* volume) {
+	core_trace_scoped(OccupancyBricksBuild);
+	clear();
+	if (volume == nullptr) {
+		return;
+	}
+	_volume = volume;
+	_region = volume->region();
+	_borderEmpty = isAir(volume->borderValue().getMaterial());
+	const glm::ivec3& dim = _region.getDimensionsInVoxels();
+	_bricks = (dim + (BrickSize - 1)) >> BrickShift;
+	_superBricks = (_bricks + (BrickSize - 1)) >> BrickShift;
+	const int brickCount = _bricks.x * _bricks.y * _bricks.z;
+	_brickBits.resize((brickCount + 63) / 64);
+	_superBrickCounts.resize(_superBricks.x * _superBricks.y * _superBricks.z);
+	updateBricks(_region);
+}
+
+bool OccupancyBricks::scanBrick(int bx, int by, int bz) const {
+	const int width = _region.getWidthInVoxels();
+	const int height = _region.getHeightInVoxels();
+	const int lx = bx << BrickShift;
+	const int ly = by << BrickShift;
+	const int lz = bz << BrickShift;
+	const int ux = core_min(lx + BrickSize, width);
+	const int uy = core_min(ly + BrickSize, height);
+	const int uz = core_min(lz + BrickSize, _region.getDepthInVoxels());
+	const Voxel* data = (const Voxel*)_volume->data();
+	for (int z = lz; z < uz; ++z) {
+		for (int y = ly; y < uy; ++y) {
+			const Voxel* row = data + (size_t)z * width * height + (size_t)y * width;
+			for (int x = lx; x < ux; ++x) {
+				if (!isAir(row[x].getMaterial())) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void OccupancyBricks::setBrick(int bx, int by, int bz, bool occupied) {
+	const int idx = brickIndex(bx, by, bz);
+	const uint64_t mask = UINT64_C(1) << (idx & 63);
+	uint64_t& bits = _brickBits[idx >> 6];
+	const bool wasOccupied = (bits & mask) != 0u;
+	if (wasOccupied == occupied) {
+		return;
+	}
+	uint16_t& cnt = _superBrickCounts[superBrickIndex(bx >> BrickShift, by >> BrickShift, bz >> BrickShift)];
+	if (occupied) {
+		bits |= mask;
+		++cnt;
+		++_occupiedBricks;
+	} else {
+		bits &= ~mask;
+		--cnt;
+		--_occupiedBricks;
+	}
+}
+
+void OccupancyBricks::updateBricks(const Region& region) {
+	Region r = region;
+	r.cropTo(_region);
+	if (!r.isValid()) {
+		return;
+	}
+	const glm::ivec3& mins = (r.getLowerCorner() - _region.getLowerCorner()) >> BrickShift;
+	const glm::ivec3& maxs = (r.getUpperCorner() - _region.getLowerCorner()) >> BrickShift;
+	for (int bz = mins.z; bz <= maxs.z; ++bz) {
+		for (int by = mins.y; by <= maxs.y; ++by) {
+			for (int bx = mins.x; bx <= maxs.x; ++bx) {
+				setBrick(bx, by, bz, scanBrick(bx, by, bz));
+			}
+		}
+	}
+	++_generation;
+}
+
+void OccupancyBricks::update(const Region& region) {
+	core_trace_scoped(OccupancyBricksUpdate);
+	if (_volume == nullptr || !region.isValid()) {
+		return;
+	}
+	updateBricks(region);
+}
+
+void OccupancyBricks::markDirty(const Region& region) {
+	if (!region.isValid()) {
+		return;
+	}
+	if (!_dirtyRegion.isValid()) {
+		_dirtyRegion = region;
+	} else {
+		_dirtyRegion.accumulate(region);
+	}
+}
+
+bool OccupancyBricks::sync(const RawVolume* volume) {
+	if (volume == nullptr) {
+		clear();
+		return false;
+	}
+	if (volume != _volume || volume->region() != _region
+			|| _borderEmpty != isAir(volume->borderValue().getMaterial())) {
+		build(volume);
+		return true;
+	}
+	if (_dirtyRegion.isValid()) {
+		update(_dirtyRegion);
+		_dirtyRegion = Region::InvalidRegion;
+	}
+	return true;
+}
+
+}
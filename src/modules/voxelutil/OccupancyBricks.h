@@ -0,0 +1,152 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Region.h"
+#include <stdint.h>
+
+namespace voxel {
+
+/**
+ * @brief Coarse occupancy information for a @c RawVolume
+ *
+ * The volume is divided into bricks of @c BrickSize^3 voxels. Each brick has a single bit that
+ * tells whether at least one non-air voxel is inside of it. On top of that, @c BrickSize^3 bricks
+ * are combined into a super brick that holds the amount of occupied bricks. This two level pyramid
+ * allows ray traversals to step over large empty areas without sampling the volume.
+ *
+ * The structure is kept up to date incrementally by marking modified regions as dirty and calling
+ * @c sync() before the next query. Only the bricks that intersect the dirty region are re-scanned.
+ *
+ * @sa raycastWithEndpoints()
+ */
+class OccupancyBricks {
+public:
+	static constexpr int BrickShift = 3;
+	static constexpr int BrickSize = 1 << BrickShift;
+	static constexpr int SuperBrickShift = BrickShift + BrickShift;
+private:
+	const RawVolume* _volume = nullptr;
+	Region _region = Region::InvalidRegion;
+	Region _dirtyRegion = Region::InvalidRegion;
+	glm::ivec3 _bricks { 0 };
+	glm::ivec3 _superBricks { 0 };
+	/** one bit per brick */
+	core::DynamicArray<uint64_t> _brickBits;
+	/** amount of occupied bricks per super brick */
+	core::DynamicArray<uint16_t> _superBrickCounts;
+	int _occupiedBricks = 0;
+	uint32_t _generation = 0u;
+	bool _borderEmpty = true;
+
+	inline int brickIndex(int bx, int by, int bz) const {
+		return bx + by * _bricks.x + bz * _bricks.x * _bricks.y;
+	}
+	inline int superBrickIndex(int sx, int sy, int sz) const {
+		return sx + sy * _superBricks.x + sz * _superBricks.x * _superBricks.y;
+	}
+	bool scanBrick(int bx, int by, int bz) const;
+	void setBrick(int bx, int by, int bz, bool occupied);
+	void updateBricks(const Region& region);
+public:
+	/**
+	 * @brief Scans the whole volume and rebuilds all bricks
+	 */
+	void build(const RawVolume* volume);
+	/**
+	 * @brief Re-scans all bricks that intersect the given region of the already known volume
+	 */
+	void update(const Region& region);
+	/**
+	 * @brief Remembers the given region to be re-scanned on the next @c sync() call
+	 */
+	void markDirty(const Region& region);
+	/**
+	 * @brief Makes sure that the bricks reflect the current state of the given volume.
+	 *
+	 * If the volume or its region changed, the bricks are rebuilt - otherwise only the dirty region
+	 * is updated.
+	 * @return @c false if the given volume is @c nullptr
+	 */
+	bool sync(const RawVolume* volume);
+	/**
+	 * @brief Forget about the volume - the next @c sync() call will do a full rebuild
+	 */
+	void clear();
+
+	/**
+	 * @return @c true if the brick that contains the given voxel position doesn't have any solid voxel.
+	 * Positions outside the volume are empty as long as the border value of the volume is air.
+	 */
+	bool empty(int32_t x, int32_t y, int32_t z) const;
+	/**
+	 * @return @c true if the super brick that contains the given voxel position doesn't have any solid voxel.
+	 * Like the bricks, the super bricks are aligned to the lower corner of the volume region.
+	 */
+	bool superBrickEmpty(int32_t x, int32_t y, int32_t z) const;
+
+	const RawVolume* volume() const;
+	const Region& region() const;
+	/**
+	 * @return @c true if the border value of the volume is air - the space outside of the volume is empty then
+	 */
+	bool borderEmpty() const;
+	int occupiedBricks() const;
+	int bricks() const;
+	/**
+	 * @brief Increased every time the occupancy information was changed. Can be used to detect whether
+	 * cached query results are still valid.
+	 */
+	uint32_t generation() const;
+};
+
+inline const RawVolume* OccupancyBricks::volume() const {
+	return _volume;
+}
+
+inline const Region& OccupancyBricks::region() const {
+	return _region;
+}
+
+inline bool OccupancyBricks::borderEmpty() const {
+	return _borderEmpty;
+}
+
+inline int OccupancyBricks::occupiedBricks() const {
+	return _occupiedBricks;
+}
+
+inline int OccupancyBricks::bricks() const {
+	return _bricks.x * _bricks.y * _bricks.z;
+}
+
+inline uint32_t OccupancyBricks::generation() const {
+	return _generation;
+}
+
+inline bool OccupancyBricks::empty(int32_t x, int32_t y, int32_t z) const {
+	if (!_region.containsPoint(x, y, z)) {
+		return _borderEmpty;
+	}
+	const int bx = (x - _region.getLowerX()) >> BrickShift;
+	const int by = (y - _region.getLowerY()) >> BrickShift;
+	const int bz = (z - _region.getLowerZ()) >> BrickShift;
+	const int idx = brickIndex(bx, by, bz);
+	return (_brickBits[idx >> 6] & (UINT64_C(1) << (idx & 63))) == 0u;
+}
+
+inline bool OccupancyBricks::superBrickEmpty(int32_t x, int32_t y, int32_t z) const {
+	if (!_region.containsPoint(x, y, z)) {
+		return _borderEmpty;
+	}
+	const int sx = (x - _region.getLowerX()) >> SuperBrickShift;
+	const int sy = (y - _region.getLowerY()) >> SuperBrickShift;
+	const int sz = (z - _region.getLowerZ()) >> SuperBrickShift;
+	return _superBrickCounts[superBrickIndex(sx, sy, sz)] == 0u;
+}
+
+}
@@ -85,4 +85,25 @@ PickResult pickVoxel(const VolumeType* volData, const glm::vec3& v3dStart, const
 	return functor._result;
 }
 
+/**
+ * Pick the first solid voxel along a vector - but don't sample the voxels of empty bricks
+ * @note The bricks must be in sync with the volume
+ */
+template<typename VolumeType>
+PickResult pickVoxel(const VolumeType* volData, const OccupancyBricks& bricks, const glm::vec3& v3dStart, const glm::vec3& v3dDirectionAndLength) {
+	core_trace_scoped(pickVoxelBricks);
+	static constexpr Voxel air;
+	RaycastPickingFunctor<VolumeType> functor(air);
+	const Region& region = volData->region();
+	raycastWithDirection(volData, bricks, v3dStart, v3dDirectionAndLength, functor, [&] (const glm::ivec3& first, const glm::ivec3& last) {
+		// a span of empty voxels is either completely inside or completely outside of the region
+		if (region.containsPoint(last)) {
+			functor._result.validPreviousPosition = true;
+			functor._result.previousPosition = last;
+		}
+		return true;
+	});
+	return functor._result;
+}
+
 }
@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include "core/Assert.h"
 #include "core/Trace.h"
 #include "voxel/PagedVolume.h"
 #include "voxel/RawVolume.h"
+#include "voxelutil/OccupancyBricks.h"
 #include "core/Common.h"
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/common.hpp>
@@ -206,6 +208,273 @@ inline RaycastResult raycastWithEndpointsVolume(const RawVolume* volData, const
 	return raycastWithEndpoints(volData, v3dStart, v3dEnd, callback);
 }
 
+namespace priv {
+
+/**
+ * @brief One axis of the voxel traversal
+ *
+ * The step @c m (starting at @c 0) on this axis happens at the time @c t0 + m * dt. After @c steps steps the
+ * end of the ray is reached on this axis - the traversal ends as soon as it would step any further.
+ */
+struct RaycastAxis {
+	int start;
+	int dir;
+	int steps;
+	float t0;
+	float dt;
+
+	inline float time(int m) const {
+		return t0 + (float)m * dt;
+	}
+};
+
+/**
+ * @brief The step @c m on the given axis. Steps that happen at the same time are ordered by their axis - just
+ * like the plain traversal prefers x over y over z.
+ */
+struct RaycastStep {
+	float t;
+	int axis;
+	int m;
+
+	inline bool operator<(const RaycastStep& other) const {
+		if (t != other.t) {
+			return t < other.t;
+		}
+		if (axis != other.axis) {
+			return axis < other.axis;
+		}
+		return m < other.m;
+	}
+};
+
+inline RaycastStep raycastStep(const RaycastAxis* axes, int axis, int m) {
+	return RaycastStep{axes[axis].time(m), axis, m};
+}
+
+/**
+ * @return The amount of steps on the given axis that happen before @a step
+ */
+inline int raycastStepsBefore(const RaycastAxis* axes, int axis, const RaycastStep& step, int current) {
+	if (axis == step.axis) {
+		return step.m;
+	}
+	const RaycastAxis& a = axes[axis];
+	// start with an estimate and correct it with the exact step times
+	const float estimate = (step.t - a.t0) / a.dt;
+	int n = current;
+	if (estimate >= (float)a.steps) {
+		n = a.steps;
+	} else if (estimate > (float)current) {
+		n = (int)estimate;
+	}
+	while (n > current && !(raycastStep(axes, axis, n - 1) < step)) {
+		--n;
+	}
+	while (n < a.steps && raycastStep(axes, axis, n) < step) {
+		++n;
+	}
+	return n;
+}
+
+/**
+ * @return The next step on the given axis that would leave the given range of voxel coordinates
+ */
+inline int raycastLeaveStep(const RaycastAxis& a, int lower, int upper) {
+	if (a.dir > 0) {
+		return upper - a.start;
+	}
+	if (a.dir < 0) {
+		return a.start - lower;
+	}
+	return a.steps;
+}
+
+}
+
+/**
+ * Cast a ray through a volume by specifying the start and end positions and skip over empty bricks
+ *
+ * This visits the same voxels in the same order as the @c raycastWithEndpoints() version without
+ * @c OccupancyBricks. But the traversal steps over empty super bricks, empty bricks and the empty space
+ * outside of the volume in one go. Instead of calling @a callback for each voxel of such an empty span,
+ * @a skipCallback is called once with the first and the last voxel of the span. A span is either completely
+ * inside or completely outside of the volume region. Both callbacks can interrupt the trace by returning @c false.
+ *
+ * @note The bricks must be in sync with the given volume
+ * @note The step times are computed instead of accumulated. For rays that are very close to a voxel corner
+ * the order of the visited voxels might differ from the plain version.
+ * @sa OccupancyBricks::sync()
+ *
+ * @param volData The volume to pass the ray though
+ * @param bricks The occupancy information for @a volData
+ * @param v3dStart The start position in the volume
+ * @param v3dEnd The end position in the volume
+ * @param callback The callback to call for each voxel in an occupied brick
+ * @param skipCallback The callback to call for each span of empty voxels - gets the first and the last voxel
+ *
+ * @return A RaycastResults designating whether the ray hit anything or not
+ */
+template<typename Callback, typename SkipCallback>
+RaycastResult raycastWithEndpoints(const RawVolume* volData, const OccupancyBricks& bricks, const glm::vec3& v3dStart, const glm::vec3& v3dEnd, Callback&& callback, SkipCallback&& skipCallback) {
+	core_trace_scoped(raycastWithEndpointsBricks);
+	core_assert(bricks.volume() == volData);
+	RawVolume::Sampler sampler(volData);
+
+	priv::RaycastAxis axes[3];
+	for (int a = 0; a < 3; ++a) {
+		const float p1 = v3dStart[a];
+		const float p2 = v3dEnd[a];
+		const float dist = glm::abs(p2 - p1);
+		const float minp = floorf(p1);
+		priv::RaycastAxis& axis = axes[a];
+		axis.start = (int)minp;
+		axis.dir = ((p1 < p2) ? 1 : ((p1 > p2) ? -1 : 0));
+		axis.steps = glm::abs((int)floorf(p2) - axis.start);
+		axis.dt = dist < glm::epsilon<float>() ? 1.0f : 1.0f / dist;
+		axis.t0 = ((p1 > p2) ? (p1 - minp) : (minp + 1.0f - p1)) * axis.dt;
+	}
+
+	const Region& region = bricks.region();
+	const glm::ivec3& lower = region.getLowerCorner();
+	const glm::ivec3& upper = region.getUpperCorner();
+	// the termination of the ray is the first step on an axis that already reached its end
+	priv::RaycastStep end = priv::raycastStep(axes, 0, axes[0].steps);
+	for (int a = 1; a < 3; ++a) {
+		const priv::RaycastStep& s = priv::raycastStep(axes, a, axes[a].steps);
+		if (s < end) {
+			end = s;
+		}
+	}
+
+	glm::ivec3 n(0);
+	bool samplerValid = false;
+	for (;;) {
+		const glm::ivec3 pos(axes[0].start + axes[0].dir * n.x, axes[1].start + axes[1].dir * n.y, axes[2].start + axes[2].dir * n.z);
+		const bool inside = region.containsPoint(pos);
+		if (inside ? bricks.empty(pos.x, pos.y, pos.z) : bricks.borderEmpty()) {
+			// find the step that leaves the empty span - or the end of the ray
+			priv::RaycastStep leave = end;
+			if (inside) {
+				const int shift = bricks.superBrickEmpty(pos.x, pos.y, pos.z) ? OccupancyBricks::SuperBrickShift : OccupancyBricks::BrickShift;
+				const glm::ivec3& boxLower = lower + (((pos - lower) >> shift) << shift);
+				const glm::ivec3& boxUpper = glm::min(boxLower + ((1 << shift) - 1), upper);
+				for (int a = 0; a < 3; ++a) {
+					const int m = priv::raycastLeaveStep(axes[a], boxLower[a], boxUpper[a]);
+					if (m < axes[a].steps) {
+						const priv::RaycastStep& s = priv::raycastStep(axes, a, m);
+						if (s < leave) {
+							leave = s;
+						}
+					}
+				}
+			} else {
+				// the step that enters the region is the last of the steps that move each axis into its slab
+				bool enters = true;
+				glm::ivec3 slabEnd(0);
+				priv::RaycastStep enterStep { -1.0f, -1, -1 };
+				for (int a = 0; a < 3; ++a) {
+					const priv::RaycastAxis& axis = axes[a];
+					int lo, hi;
+					if (axis.dir > 0) {
+						lo = lower[a] - axis.start;
+						hi = upper[a] - axis.start;
+					} else if (axis.dir < 0) {
+						lo = axis.start - upper[a];
+						hi = axis.start - lower[a];
+					} else {
+						lo = axis.start >= lower[a] && axis.start <= upper[a] ? 0 : 1;
+						hi = 0;
+					}
+					lo = core_max(lo, 0);
+					hi = core_min(hi, axis.steps);
+					if (lo > hi || n[a] > hi) {
+						enters = false;
+						break;
+					}
+					slabEnd[a] = hi;
+					if (n[a] < lo) {
+						const priv::RaycastStep& s = priv::raycastStep(axes, a, lo - 1);
+						if (enterStep.axis == -1 || enterStep < s) {
+							enterStep = s;
+						}
+					}
+				}
+				if (enters && enterStep.axis != -1 && enterStep < end) {
+					// the other axes must not have left their slab until then
+					for (int a = 0; a < 3; ++a) {
+						const int steps = priv::raycastStepsBefore(axes, a, enterStep, n[a]) + (a == enterStep.axis ? 1 : 0);
+						if (steps > slabEnd[a]) {
+							enters = false;
+							break;
+						}
+					}
+					if (enters) {
+						leave = enterStep;
+					}
+				}
+			}
+			glm::ivec3 last;
+			for (int a = 0; a < 3; ++a) {
+				n[a] = priv::raycastStepsBefore(axes, a, leave, n[a]);
+				last[a] = axes[a].start + axes[a].dir * n[a];
+			}
+			if (!skipCallback(pos, last)) {
+				return RaycastResults::Interupted;
+			}
+			if (!(leave < end)) {
+				break;
+			}
+			++n[leave.axis];
+			samplerValid = false;
+			continue;
+		}
+
+		if (!samplerValid) {
+			sampler.setPosition(pos.x, pos.y, pos.z);
+			samplerValid = true;
+		}
+		if (!callback(sampler)) {
+			return RaycastResults::Interupted;
+		}
+
+		int a = 0;
+		priv::RaycastStep next = priv::raycastStep(axes, 0, n.x);
+		for (int b = 1; b < 3; ++b) {
+			const priv::RaycastStep& s = priv::raycastStep(axes, b, n[b]);
+			if (s < next) {
+				next = s;
+				a = b;
+			}
+		}
+		if (n[a] == axes[a].steps) {
+			break;
+		}
+		++n[a];
+		if (a == 0) {
+			if (axes[0].dir == 1) {
+				sampler.movePositiveX();
+			} else {
+				sampler.moveNegativeX();
+			}
+		} else if (a == 1) {
+			if (axes[1].dir == 1) {
+				sampler.movePositiveY();
+			} else {
+				sampler.moveNegativeY();
+			}
+		} else {
+			if (axes[2].dir == 1) {
+				sampler.movePositiveZ();
+			} else {
+				sampler.moveNegativeZ();
+			}
+		}
+	}
+
+	return RaycastResults::Completed;
+}
+
 /**
  * Cast a ray through a volume by specifying the start and a direction
  *
@@ -236,4 +505,16 @@ RaycastResult raycastWithDirection(const Volume* volData, const glm::vec3& v3dSt
 	return raycastWithEndpoints<Callback, Volume>(volData, v3dStart, v3dEnd, core::forward<Callback>(callback));
 }
 
+/**
+ * Cast a ray through a volume by specifying the start and a direction and skip over empty bricks
+ *
+ * @sa raycastWithEndpoints()
+ * @sa OccupancyBricks
+ */
+template<typename Callback, typename SkipCallback>
+RaycastResult raycastWithDirection(const RawVolume* volData, const OccupancyBricks& bricks, const glm::vec3& v3dStart, const glm::vec3& v3dDirectionAndLength, Callback&& callback, SkipCallback&& skipCallback) {
+	const glm::vec3 v3dEnd = v3dStart + v3dDirectionAndLength;
+	return raycastWithEndpoints(volData, bricks, v3dStart, v3dEnd, core::forward<Callback>(callback), core::forward<SkipCallback>(skipCallback));
+}
+
 }
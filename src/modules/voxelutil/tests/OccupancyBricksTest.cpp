@@ -0,0 +1,179 @@
+/**
+ * @file
+ */
+
+#include "voxel/tests/AbstractVoxelTest.h"
+#include "voxelutil/OccupancyBricks.h"
+#include "voxelutil/Picking.h"
+#include "math/Random.h"
+
+namespace voxel {
+
+class OccupancyBricksTest: public AbstractVoxelTest {
+protected:
+	void fillRandom(RawVolume& v, int amount, unsigned int seed) {
+		const math::Random rnd(seed);
+		const Region& region = v.region();
+		for (int i = 0; i < amount; ++i) {
+			const int x = rnd.random(region.getLowerX(), region.getUpperX());
+			const int y = rnd.random(region.getLowerY(), region.getUpperY());
+			const int z = rnd.random(region.getLowerZ(), region.getUpperZ());
+			v.setVoxel(x, y, z, createVoxel(VoxelType::Grass, 0));
+		}
+	}
+
+	void comparePicking(const RawVolume& v, const OccupancyBricks& bricks, unsigned int seed, int rays) {
+		const math::Random rnd(seed);
+		const Region& region = v.region();
+		const glm::vec3 mins = glm::vec3(region.getLowerCorner()) - 20.0f;
+		const glm::vec3 maxs = glm::vec3(region.getUpperCorner()) + 20.0f;
+		for (int i = 0; i < rays; ++i) {
+			const glm::vec3 start(rnd.randomf(mins.x, maxs.x), rnd.randomf(mins.y, maxs.y), rnd.randomf(mins.z, maxs.z));
+			const glm::vec3 target(rnd.randomf(mins.x, maxs.x), rnd.randomf(mins.y, maxs.y), rnd.randomf(mins.z, maxs.z));
+			const glm::vec3 dir = (target - start) * 2.0f;
+			const PickResult& expected = pickVoxel(&v, start, dir, Voxel());
+			const PickResult& result = pickVoxel(&v, bricks, start, dir);
+			ASSERT_EQ(expected.didHit, result.didHit) << "ray " << i;
+			ASSERT_EQ(expected.validPreviousPosition, result.validPreviousPosition) << "ray " << i;
+			if (expected.didHit) {
+				ASSERT_EQ(expected.hitVoxel, result.hitVoxel) << "ray " << i;
+			}
+			if (expected.validPreviousPosition) {
+				ASSERT_EQ(expected.previousPosition, result.previousPosition) << "ray " << i;
+			}
+		}
+	}
+};
+
+TEST_F(OccupancyBricksTest, testBuild) {
+	RawVolume v(Region(glm::ivec3(-5), glm::ivec3(20)));
+	OccupancyBricks bricks;
+	ASSERT_TRUE(bricks.sync(&v));
+	EXPECT_EQ(64, bricks.bricks());
+	EXPECT_EQ(0, bricks.occupiedBricks());
+	EXPECT_TRUE(bricks.empty(0, 0, 0));
+	v.setVoxel(glm::ivec3(4), createVoxel(VoxelType::Grass, 0));
+	bricks.markDirty(Region(glm::ivec3(4), glm::ivec3(4)));
+	ASSERT_TRUE(bricks.sync(&v));
+	EXPECT_EQ(1, bricks.occupiedBricks());
+	// the bricks are aligned to the lower corner of the volume region
+	EXPECT_FALSE(bricks.empty(4, 4, 4));
+	EXPECT_FALSE(bricks.empty(3, 3, 3));
+	EXPECT_FALSE(bricks.empty(10, 10, 10));
+	EXPECT_TRUE(bricks.empty(2, 2, 2));
+	EXPECT_TRUE(bricks.empty(11, 11, 11));
+	EXPECT_FALSE(bricks.superBrickEmpty(20, 20, 20));
+	EXPECT_TRUE(bricks.empty(100, 100, 100));
+}
+
+TEST_F(OccupancyBricksTest, testIncrementalUpdate) {
+	RawVolume v(Region(0, 63));
+	fillRandom(v, 50, 1u);
+	OccupancyBricks bricks;
+	ASSERT_TRUE(bricks.sync(&v));
+	const int occupied = bricks.occupiedBricks();
+	ASSERT_GT(occupied, 0);
+
+	const Region modified(glm::ivec3(10), glm::ivec3(30));
+	for (int x = modified.getLowerX(); x <= modified.getUpperX(); ++x) {
+		for (int y = modified.getLowerY(); y <= modified.getUpperY(); ++y) {
+			for (int z = modified.getLowerZ(); z <= modified.getUpperZ(); ++z) {
+				v.setVoxel(x, y, z, Voxel());
+			}
+		}
+	}
+	bricks.markDirty(modified);
+	const uint32_t generation = bricks.generation();
+	ASSERT_TRUE(bricks.sync(&v));
+	EXPECT_NE(generation, bricks.generation());
+
+	OccupancyBricks rebuilt;
+	rebuilt.build(&v);
+	EXPECT_EQ(rebuilt.occupiedBricks(), bricks.occupiedBricks());
+	for (int x = 0; x < 64; x += OccupancyBricks::BrickSize) {
+		for (int y = 0; y < 64; y += OccupancyBricks::BrickSize) {
+			for (int z = 0; z < 64; z += OccupancyBricks::BrickSize) {
+				EXPECT_EQ(rebuilt.empty(x, y, z), bricks.empty(x, y, z));
+			}
+		}
+	}
+}
+
+TEST_F(OccupancyBricksTest, testPickingMatchesRaycast) {
+	RawVolume v(Region(glm::ivec3(-13, 0, 5), glm::ivec3(50, 37, 70)));
+	fillRandom(v, 40, 2u);
+	OccupancyBricks bricks;
+	ASSERT_TRUE(bricks.sync(&v));
+	comparePicking(v, bricks, 3u, 2000);
+}
+
+TEST_F(OccupancyBricksTest, testPickingMatchesRaycastDense) {
+	RawVolume v(Region(0, 31));
+	fillRandom(v, 2000, 4u);
+	OccupancyBricks bricks;
+	ASSERT_TRUE(bricks.sync(&v));
+	comparePicking(v, bricks, 5u, 2000);
+}
+
+TEST_F(OccupancyBricksTest, testPickingAfterModification) {
+	RawVolume v(Region(0, 63));
+	OccupancyBricks bricks;
+	ASSERT_TRUE(bricks.sync(&v));
+	const PickResult& miss = pickVoxel(&v, bricks, glm::vec3(32.5f, 100.0f, 32.5f), glm::down * 200.0f);
+	EXPECT_FALSE(miss.didHit);
+	EXPECT_TRUE(miss.validPreviousPosition);
+	EXPECT_EQ(glm::ivec3(32, 0, 32), miss.previousPosition);
+
+	v.setVoxel(glm::ivec3(32, 10, 32), createVoxel(VoxelType::Grass, 0));
+	bricks.markDirty(Region(glm::ivec3(32, 10, 32), glm::ivec3(32, 10, 32)));
+	ASSERT_TRUE(bricks.sync(&v));
+	const PickResult& hit = pickVoxel(&v, bricks, glm::vec3(32.5f, 100.0f, 32.5f), glm::down * 200.0f);
+	ASSERT_TRUE(hit.didHit);
+	EXPECT_EQ(glm::ivec3(32, 10, 32), hit.hitVoxel);
+	EXPECT_EQ(glm::ivec3(32, 11, 32), hit.previousPosition);
+}
+
+TEST_F(OccupancyBricksTest, testPickingAtUnalignedBorder) {
+	// the dimensions are no multiple of the brick size - the last bricks are only partially inside the volume
+	RawVolume v(Region(glm::ivec3(0), glm::ivec3(20, 12, 9)));
+	v.setVoxel(glm::ivec3(20, 5, 5), createVoxel(VoxelType::Grass, 0));
+	v.setVoxel(glm::ivec3(3, 12, 9), createVoxel(VoxelType::Grass, 0));
+	OccupancyBricks bricks;
+	ASSERT_TRUE(bricks.sync(&v));
+	const PickResult& hitX = pickVoxel(&v, bricks, glm::vec3(22.5f, 5.5f, 5.5f), glm::left * 30.0f);
+	ASSERT_TRUE(hitX.didHit);
+	EXPECT_EQ(glm::ivec3(20, 5, 5), hitX.hitVoxel);
+	EXPECT_FALSE(hitX.validPreviousPosition);
+	const PickResult& hitY = pickVoxel(&v, bricks, glm::vec3(3.5f, 14.5f, 9.5f), glm::down * 30.0f);
+	ASSERT_TRUE(hitY.didHit);
+	EXPECT_EQ(glm::ivec3(3, 12, 9), hitY.hitVoxel);
+	comparePicking(v, bricks, 6u, 2000);
+}
+
+TEST_F(OccupancyBricksTest, testSkipEmptyBricks) {
+	RawVolume v(Region(0, 127));
+	v.setVoxel(glm::ivec3(120, 64, 64), createVoxel(VoxelType::Grass, 0));
+	OccupancyBricks bricks;
+	ASSERT_TRUE(bricks.sync(&v));
+	int sampled = 0;
+	int spans = 0;
+	glm::ivec3 hit(-1);
+	raycastWithEndpoints(&v, bricks, glm::vec3(-50.5f, 64.5f, 64.5f), glm::vec3(200.5f, 64.6f, 64.6f), [&] (RawVolume::Sampler& sampler) {
+		++sampled;
+		if (!isAir(sampler.voxel().getMaterial())) {
+			hit = sampler.position();
+			return false;
+		}
+		return true;
+	}, [&] (const glm::ivec3& first, const glm::ivec3& last) {
+		++spans;
+		return true;
+	});
+	EXPECT_EQ(glm::ivec3(120, 64, 64), hit);
+	// the hit voxel is the first voxel of the only occupied brick
+	EXPECT_EQ(1, sampled);
+	// the space in front of the volume, the first (empty) super brick and the seven empty bricks in front of the hit
+	EXPECT_EQ(1 + 1 + 7, spans);
+}
+
+}
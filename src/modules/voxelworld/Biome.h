@@ -45,6 +45,10 @@ public:
 
 	voxel::Voxel voxel(math::Random& random) const;
 	voxel::Voxel voxel(uint8_t colorIndex) const;
+	/**
+	 * @brief The color index only depends on the given position - see @c voxel::positionHash()
+	 */
+	voxel::Voxel voxel(const glm::ivec3& pos, uint32_t seed = 0u) const;
 	voxel::Voxel voxel() const;
 };
 
@@ -72,6 +76,11 @@ inline voxel::Voxel Biome::voxel(uint8_t colorIndex) const {
 	return voxel::Voxel(type, glm::clamp(colorIndex, min, max));
 }
 
+inline voxel::Voxel Biome::voxel(const glm::ivec3& pos, uint32_t seed) const {
+	core_assert(!indices.empty());
+	return voxel::Voxel(type, indices[voxel::positionHash(pos, seed) % (uint32_t)indices.size()]);
+}
+
 inline voxel::Voxel Biome::voxel() const {
 	thread_local math::Random random;
 	return voxel(random);
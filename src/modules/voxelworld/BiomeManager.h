@@ -79,7 +79,7 @@ public:
 	inline voxel::Voxel getVoxel(const glm::ivec3& pos, bool underground = false) const {
 		core_trace_scoped(BiomeGetVoxel);
 		const Biome* biome = getBiome(pos, underground);
-		return biome->voxel();
+		return biome->voxel(pos);
 	}
 
 	inline voxel::Voxel getVoxel(int x, int y, int z, bool underground = false) const {
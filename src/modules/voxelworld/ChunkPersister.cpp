@@ -18,23 +18,23 @@ bool ChunkPersister::saveCompressed(const voxel::PagedVolume::ChunkPtr& chunk, c
 	// save the stuff
 	const voxel::Voxel* voxelBuf = chunk->data();
 	const int voxelSize = chunk->dataSizeInBytes();
-	uint32_t neededVoxelBufLen = core::zip::compressBound(voxelSize);
-	uint8_t* compressedVoxelBuf = new uint8_t[neededVoxelBufLen];
-	std::unique_ptr<uint8_t[]> smartBuf(compressedVoxelBuf);
-	size_t finalBufferSize;
+	const uint32_t maxCompressedSize = core::zip::compressBound(voxelSize);
+	const size_t headerSize = sizeof(int32_t) + sizeof(uint8_t);
 	{
 		core_trace_scoped(ChunkPersisterCompress);
-		const bool success = core::zip::compress((const uint8_t*)voxelBuf, voxelSize, compressedVoxelBuf, neededVoxelBufLen, &finalBufferSize);
-		if (!success) {
+		// compress directly into the spare capacity of the stream - behind the space
+		// that is reserved for the header. The header is only written once the
+		// compression succeeded to not leave a partial entry in the stream.
+		size_t compressedSize = 0u;
+		uint8_t *out = outStream.writeBuffer(headerSize + maxCompressedSize);
+		if (!core::zip::compressor().compress((const uint8_t*)voxelBuf, voxelSize, out + headerSize, maxCompressedSize, &compressedSize)) {
 			Log::error("Failed to compress the voxel data");
 			return false;
 		}
-	}
-	{
-		core_trace_scoped(ChunkPersisterSaveCompressed);
+		// the capacity is already reserved - this doesn't reallocate and fills the gap in front of the data
 		outStream.addInt(voxelSize);
 		outStream.addByte(WORLD_FILE_VERSION);
-		outStream.append(compressedVoxelBuf, finalBufferSize);
+		outStream.commit(compressedSize);
 	}
 	return true;
 }
@@ -45,8 +45,7 @@ bool ChunkPersister::loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, c
 	if (!fileBuf || fileLen <= headerSize) {
 		return false;
 	}
-	core::ByteStream bs(headerSize);
-	bs.append(fileBuf, headerSize);
+	core::ByteStream bs = core::ByteStream::view(fileBuf, headerSize);
 	const int len = bs.readInt();
 	const int version = bs.readByte();
 
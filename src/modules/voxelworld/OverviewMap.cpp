@@ -0,0 +1,131 @@
+/**
+ * @file
+ */
+
+#include "OverviewMap.h"
+#include "core/Color.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+#include "core/collection/Buffer.h"
+#include "voxel/Constants.h"
+#include "voxel/MaterialColor.h"
+#include <glm/common.hpp>
+#include <vector>
+
+namespace voxelworld {
+
+namespace {
+constexpr size_t TilePixels = (size_t)OverviewMap::TileSize * OverviewMap::TileSize;
+constexpr size_t TilePayloadSize = TilePixels * (sizeof(uint8_t) + sizeof(glm::u8vec4) + sizeof(uint8_t));
+}
+
+OverviewMap::OverviewMap(const WorldPagerPtr& pager, size_t threads) :
+		_pager(pager), _threadPool(threads, "OverviewMap") {
+}
+
+bool OverviewMap::init() {
+	_threadPool.init();
+	return _pager != nullptr;
+}
+
+void OverviewMap::shutdown() {
+	_threadPool.shutdown(true);
+}
+
+glm::ivec2 OverviewMap::tilePos(int zoom, const glm::ivec2& worldPos) {
+	const int size = voxelsPerTile(zoom);
+	return glm::ivec2((int)glm::floor((float)worldPos.x / (float)size), (int)glm::floor((float)worldPos.y / (float)size));
+}
+
+void OverviewMap::generate(Tile& tile) const {
+	core_trace_scoped(OverviewMapGenerate);
+	const int step = 1 << tile.zoom;
+	// sample the center of the area that is covered by a pixel
+	const glm::ivec2 origin = tile.pos * voxelsPerTile(tile.zoom) + step / 2;
+	for (int z = 0; z < TileSize; ++z) {
+		for (int x = 0; x < TileSize; ++x) {
+			const int index = z * TileSize + x;
+			int height;
+			const voxel::Voxel& surface = _pager->surfaceVoxel(origin.x + x * step, origin.y + z * step, height);
+			tile.heights[index] = (uint8_t)height;
+			tile.biomes[index] = (uint8_t)surface.getMaterial();
+			const float shade = 0.6f + 0.4f * (float)height / (float)voxel::MAX_TERRAIN_HEIGHT;
+			const glm::vec4& color = voxel::getMaterialColor(surface);
+			tile.colors[index] = core::Color::getRGBAVec(glm::vec4(glm::vec3(color) * shade, 1.0f));
+		}
+	}
+}
+
+bool OverviewMap::load(Tile& tile) const {
+	const WorldCachePtr& worldCache = _pager->worldCache();
+	if (!worldCache) {
+		return false;
+	}
+	core::Buffer<uint8_t> payload;
+	if (!worldCache->loadTile(TileSize, tile.zoom, tile.pos, payload) || payload.size() != TilePayloadSize) {
+		return false;
+	}
+	const uint8_t *data = payload.data();
+	core_memcpy(tile.heights, data, sizeof(tile.heights));
+	data += sizeof(tile.heights);
+	core_memcpy(tile.colors, data, sizeof(tile.colors));
+	data += sizeof(tile.colors);
+	core_memcpy(tile.biomes, data, sizeof(tile.biomes));
+	return true;
+}
+
+void OverviewMap::store(const Tile& tile) const {
+	const WorldCachePtr& worldCache = _pager->worldCache();
+	if (!worldCache || !worldCache->enabled()) {
+		return;
+	}
+	core::Buffer<uint8_t> payload;
+	payload.reserve(TilePayloadSize);
+	payload.append(tile.heights, sizeof(tile.heights));
+	payload.append((const uint8_t*)tile.colors, sizeof(tile.colors));
+	payload.append(tile.biomes, sizeof(tile.biomes));
+	worldCache->storeTile(TileSize, tile.zoom, tile.pos, payload.data(), payload.size());
+}
+
+OverviewMap::TilePtr OverviewMap::tile(int zoom, const glm::ivec2& tilePos) {
+	core_trace_scoped(OverviewMapTile);
+	const TilePtr& tile = std::make_shared<Tile>();
+	tile->zoom = glm::clamp(zoom, 0, MaxZoom);
+	tile->pos = tilePos;
+	if (load(*tile)) {
+		++_cached;
+		return tile;
+	}
+	generate(*tile);
+	store(*tile);
+	++_generated;
+	return tile;
+}
+
+std::future<OverviewMap::TilePtr> OverviewMap::tileAsync(int zoom, const glm::ivec2& tilePos) {
+	return _threadPool.enqueue([this, zoom, tilePos] () {
+		return tile(zoom, tilePos);
+	});
+}
+
+int OverviewMap::tiles(int zoom, const glm::ivec2& worldMins, const glm::ivec2& worldMaxs, core::DynamicArray<TilePtr>& tiles) {
+	core_trace_scoped(OverviewMapTiles);
+	zoom = glm::clamp(zoom, 0, MaxZoom);
+	const glm::ivec2& mins = tilePos(zoom, worldMins);
+	const glm::ivec2& maxs = tilePos(zoom, worldMaxs);
+	std::vector<std::future<TilePtr>> futures;
+	futures.reserve((size_t)(maxs.x - mins.x + 1) * (size_t)(maxs.y - mins.y + 1));
+	for (int z = mins.y; z <= maxs.y; ++z) {
+		for (int x = mins.x; x <= maxs.x; ++x) {
+			futures.emplace_back(tileAsync(zoom, glm::ivec2(x, z)));
+		}
+	}
+	tiles.reserve(tiles.size() + futures.size());
+	for (std::future<TilePtr>& future : futures) {
+		tiles.push_back(future.get());
+	}
+	return maxs.x - mins.x + 1;
+}
+
+}
@@ -0,0 +1,114 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "WorldPager.h"
+#include "core/IComponent.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <future>
+#include <memory>
+#include <stdint.h>
+
+namespace voxelworld {
+
+/**
+ * @brief 2D overview of the generated world - height, color and biome tiles at several zoom levels
+ *
+ * The tiles are sampled from the terrain functions of the @c WorldPager and the @c BiomeManager. No chunk is paged in
+ * and nothing is meshed. A pixel of a tile at zoom level @c n covers @c 2^n voxels in each direction - the costs of a
+ * tile don't depend on the zoom level. Trees and plants are not part of the overview.
+ *
+ * The tiles are generated on a thread pool and stored in the @c WorldCache of the pager (if there is one).
+ *
+ * @note The pager must be initialized before tiles can be requested.
+ */
+class OverviewMap : public core::IComponent {
+public:
+	static constexpr int TileSize = 128;
+	static constexpr int MaxZoom = 12;
+
+	struct Tile {
+		int zoom = 0;
+		/** @brief The tile position - the world position of the tile is @c pos * @c voxelsPerTile(zoom) */
+		glm::ivec2 pos { 0 };
+		/** @brief The height of the surface (terrain or water) for each pixel */
+		uint8_t heights[TileSize * TileSize];
+		/** @brief RGBA color of the surface for each pixel - shaded by the height */
+		glm::u8vec4 colors[TileSize * TileSize];
+		/** @brief The @c voxel::VoxelType of the surface for each pixel */
+		uint8_t biomes[TileSize * TileSize];
+	};
+	typedef std::shared_ptr<Tile> TilePtr;
+
+private:
+	WorldPagerPtr _pager;
+	core::ThreadPool _threadPool;
+	core::AtomicInt _generated { 0 };
+	core::AtomicInt _cached { 0 };
+
+	void generate(Tile& tile) const;
+	bool load(Tile& tile) const;
+	void store(const Tile& tile) const;
+
+public:
+	/**
+	 * @param[in] threads The amount of threads that generate the tiles in parallel
+	 */
+	OverviewMap(const WorldPagerPtr& pager, size_t threads);
+
+	bool init() override;
+	void shutdown() override;
+
+	/**
+	 * @brief Loads the tile from the world cache or generates it on the calling thread
+	 */
+	TilePtr tile(int zoom, const glm::ivec2& tilePos);
+	/**
+	 * @brief Loads the tile from the world cache or generates it on the thread pool
+	 */
+	std::future<TilePtr> tileAsync(int zoom, const glm::ivec2& tilePos);
+	/**
+	 * @brief Loads or generates all tiles that cover the given world rectangle (x and z) in parallel
+	 * @param[out] tiles The tiles row by row
+	 * @return The amount of tiles per row
+	 */
+	int tiles(int zoom, const glm::ivec2& worldMins, const glm::ivec2& worldMaxs, core::DynamicArray<TilePtr>& tiles);
+
+	/**
+	 * @return The amount of voxels in each direction that a tile of the given zoom level covers
+	 */
+	static int voxelsPerTile(int zoom);
+	/**
+	 * @return The position of the tile that contains the given world position (x and z)
+	 */
+	static glm::ivec2 tilePos(int zoom, const glm::ivec2& worldPos);
+
+	/**
+	 * @brief The amount of generated tiles - without the tiles that were loaded from the world cache
+	 */
+	int generated() const;
+	int cached() const;
+};
+
+inline int OverviewMap::voxelsPerTile(int zoom) {
+	return TileSize << zoom;
+}
+
+inline int OverviewMap::generated() const {
+	return _generated;
+}
+
+inline int OverviewMap::cached() const {
+	return _cached;
+}
+
+typedef std::shared_ptr<OverviewMap> OverviewMapPtr;
+
+}
@@ -0,0 +1,411 @@
+/**
+ * @file
+ */
+
+#include "WorldCache.h"
+#include "core/Algorithm.h"
+#include "core/ByteStream.h"
+#include "core/FourCC.h"
+#include "core/Hash.h"
+#include "core/Log.h"
+#include "core/StringUtil.h"
+#include "core/Zip.h"
+#include "core/collection/DynamicArray.h"
+#include "app/App.h"
+#include "io/Filesystem.h"
+#include "io/MappedFile.h"
+#include "voxel/Mesh.h"
+#include <SDL_stdinc.h>
+
+namespace voxelworld {
+
+namespace {
+constexpr uint32_t CacheMagic = FourCC('W', 'C', 'C', 'E');
+constexpr uint32_t CacheVersion = 1u;
+constexpr size_t CacheHeaderSize = 5u * sizeof(uint32_t);
+constexpr size_t MeshHeaderSize = 5u * sizeof(uint32_t);
+const char *CacheDir = "worldcache/";
+const char *IndexFile = "index";
+}
+
+core::String WorldCache::key(unsigned int seed, uint32_t paramsHash, uint32_t generatorVersion) {
+	return core::string::format("%u_%08x_%u", seed, paramsHash, generatorVersion);
+}
+
+bool WorldCache::init() {
+	_enabled = core::Var::get("world_cache", "true", -1, "Cache the generated chunks and meshes on disk");
+	_maxSize = core::Var::get("world_cache_size", "512", -1, "Max size of the world cache on disk in megabytes");
+
+	core::ScopedLock lock(_lock);
+	_entries.clear();
+	_totalSize = 0u;
+	_tick = 0u;
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	core::DynamicArray<io::Filesystem::DirEntry> dirEntries;
+	filesystem->list(filesystem->homePath() + CacheDir, dirEntries);
+	for (const io::Filesystem::DirEntry& dirEntry : dirEntries) {
+		if (dirEntry.type != io::Filesystem::DirEntry::Type::file || dirEntry.name == IndexFile) {
+			continue;
+		}
+		if ((int)_entries.size() >= MaxEntries) {
+			break;
+		}
+		_entries.put(dirEntry.name, Entry{dirEntry.size, 0u});
+		_totalSize += dirEntry.size;
+	}
+
+	// entries that are not part of the index are treated as the oldest ones
+	const core::String& index = filesystem->load(core::String(CacheDir) + IndexFile);
+	core::DynamicArray<core::String> names;
+	core::string::splitString(index, names, "\n");
+	for (const core::String& name : names) {
+		auto i = _entries.find(name);
+		if (i != _entries.end()) {
+			i->value.lastUsed = ++_tick;
+		}
+	}
+	evict((uint64_t)_maxSize->intVal() * 1024u * 1024u);
+	Log::debug("World cache with %i entries and %u KB", (int)_entries.size(), (uint32_t)(_totalSize / 1024u));
+	return true;
+}
+
+void WorldCache::shutdown() {
+	core::ScopedLock lock(_lock);
+	if (!_entries.empty()) {
+		writeIndex();
+	}
+	_entries.clear();
+	_totalSize = 0u;
+	_tick = 0u;
+}
+
+void WorldCache::writeIndex() const {
+	struct IndexEntry {
+		const core::String* name;
+		uint64_t lastUsed;
+	};
+	core::DynamicArray<IndexEntry> sorted;
+	sorted.reserve(_entries.size());
+	for (auto i = _entries.begin(); i != _entries.end(); ++i) {
+		sorted.push_back(IndexEntry{&i->key, i->value.lastUsed});
+	}
+	core::sort(sorted.begin(), sorted.end(), [] (const IndexEntry& lhs, const IndexEntry& rhs) {
+		return lhs.lastUsed < rhs.lastUsed;
+	});
+	core::String index;
+	for (const IndexEntry& entry : sorted) {
+		index += *entry.name;
+		index += "\n";
+	}
+	io::filesystem()->write(core::String(CacheDir) + IndexFile, index);
+}
+
+bool WorldCache::enabled() const {
+	return _enabled && _enabled->boolVal() && !_key.empty();
+}
+
+void WorldCache::setKey(const core::String& key) {
+	_key = key;
+}
+
+core::String WorldCache::chunkName(const voxel::PagedVolume::ChunkPtr& chunk) const {
+	const glm::ivec3& pos = chunk->chunkPos();
+	return core::string::format("%s_c%i_%i_%i_%i", _key.c_str(), (int)chunk->sideLength(), pos.x, pos.y, pos.z);
+}
+
+core::String WorldCache::meshName(const voxel::Region& region) const {
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::ivec3& maxs = region.getUpperCorner();
+	return core::string::format("%s_m%i_%i_%i_%i_%i_%i", _key.c_str(), mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
+}
+
+core::String WorldCache::tileName(int tileSize, int zoom, const glm::ivec2& pos) const {
+	return core::string::format("%s_t%i_%i_%i_%i", _key.c_str(), tileSize, zoom, pos.x, pos.y);
+}
+
+size_t WorldCache::entries() const {
+	core::ScopedLock lock(_lock);
+	return _entries.size();
+}
+
+uint64_t WorldCache::size() const {
+	core::ScopedLock lock(_lock);
+	return _totalSize;
+}
+
+void WorldCache::touch(const core::String& name, uint64_t size) {
+	core::ScopedLock lock(_lock);
+	auto i = _entries.find(name);
+	if (i != _entries.end()) {
+		_totalSize -= i->value.size;
+		i->value = Entry{size, ++_tick};
+	} else {
+		if ((int)_entries.size() >= MaxEntries) {
+			// make room for the new entry
+			evict(_totalSize - 1u);
+		}
+		_entries.put(name, Entry{size, ++_tick});
+	}
+	_totalSize += size;
+	evict((uint64_t)_maxSize->intVal() * 1024u * 1024u);
+}
+
+void WorldCache::remove(const core::String& name) {
+	core::ScopedLock lock(_lock);
+	auto i = _entries.find(name);
+	if (i != _entries.end()) {
+		_totalSize -= i->value.size;
+		_entries.erase(i);
+	}
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	filesystem->removeFile(filesystem->homePath() + CacheDir + name);
+}
+
+void WorldCache::invalidate(const voxel::Region& region) {
+	if (_key.empty()) {
+		return;
+	}
+	core_trace_scoped(WorldCacheInvalidate);
+	const core::String& chunkPrefix = _key + "_c";
+	const core::String& meshPrefix = _key + "_m";
+	core::ScopedLock lock(_lock);
+	core::DynamicArray<core::String> names;
+	for (auto i = _entries.begin(); i != _entries.end(); ++i) {
+		const core::String& name = i->key;
+		glm::ivec3 mins;
+		glm::ivec3 maxs;
+		if (core::string::startsWith(name, chunkPrefix)) {
+			int sideLength;
+			if (SDL_sscanf(name.c_str() + chunkPrefix.size(), "%i_%i_%i_%i", &sideLength, &mins.x, &mins.y, &mins.z) != 4) {
+				continue;
+			}
+			mins *= sideLength;
+			maxs = mins + glm::ivec3(sideLength - 1);
+		} else if (core::string::startsWith(name, meshPrefix)) {
+			if (SDL_sscanf(name.c_str() + meshPrefix.size(), "%i_%i_%i_%i_%i_%i", &mins.x, &mins.y, &mins.z, &maxs.x, &maxs.y, &maxs.z) != 6) {
+				continue;
+			}
+			// the mesh extraction looks at the neighbouring voxels, too
+			mins -= 1;
+			maxs += 1;
+		} else {
+			continue;
+		}
+		if (voxel::intersects(region, voxel::Region(mins, maxs))) {
+			names.push_back(name);
+		}
+	}
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	for (const core::String& name : names) {
+		auto i = _entries.find(name);
+		_totalSize -= i->value.size;
+		_entries.erase(i);
+		filesystem->removeFile(filesystem->homePath() + CacheDir + name);
+	}
+	if (!names.empty()) {
+		Log::debug("Invalidated %i world cache entries", (int)names.size());
+	}
+}
+
+void WorldCache::evict(uint64_t maxSize) {
+	if (_totalSize <= maxSize && (int)_entries.size() < MaxEntries) {
+		return;
+	}
+	core_trace_scoped(WorldCacheEvict);
+	struct EvictEntry {
+		core::String name;
+		uint64_t size;
+		uint64_t lastUsed;
+	};
+	core::DynamicArray<EvictEntry> sorted;
+	sorted.reserve(_entries.size());
+	for (auto i = _entries.begin(); i != _entries.end(); ++i) {
+		sorted.push_back(EvictEntry{i->key, i->value.size, i->value.lastUsed});
+	}
+	core::sort(sorted.begin(), sorted.end(), [] (const EvictEntry& lhs, const EvictEntry& rhs) {
+		return lhs.lastUsed < rhs.lastUsed;
+	});
+	// evict a bit more than needed to not evict with every new entry
+	const uint64_t targetSize = maxSize - maxSize / 8u;
+	const int targetEntries = MaxEntries - MaxEntries / 8;
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	for (const EvictEntry& entry : sorted) {
+		if (_totalSize <= targetSize && (int)_entries.size() <= targetEntries) {
+			break;
+		}
+		filesystem->removeFile(filesystem->homePath() + CacheDir + entry.name);
+		_entries.remove(entry.name);
+		_totalSize -= entry.size;
+	}
+	Log::debug("Evicted world cache entries - %i entries with %u KB left", (int)_entries.size(), (uint32_t)(_totalSize / 1024u));
+}
+
+void WorldCache::clear() {
+	core::ScopedLock lock(_lock);
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	for (auto i = _entries.begin(); i != _entries.end(); ++i) {
+		filesystem->removeFile(filesystem->homePath() + CacheDir + i->key);
+	}
+	filesystem->removeFile(filesystem->homePath() + CacheDir + IndexFile);
+	_entries.clear();
+	_totalSize = 0u;
+}
+
+bool WorldCache::read(const core::String& name, core::Buffer<uint8_t>& payload) {
+	core_trace_scoped(WorldCacheRead);
+	{
+		// don't hit the filesystem for entries that were never written
+		core::ScopedLock lock(_lock);
+		if (_entries.find(name) == _entries.end()) {
+			++_misses;
+			return false;
+		}
+	}
+	uint64_t fileSize = 0u;
+	bool broken = false;
+	{
+		const io::MappedFile file(io::filesystem()->homePath() + CacheDir + name);
+		if (!file.valid() || file.size() < CacheHeaderSize) {
+			++_misses;
+			return false;
+		}
+		fileSize = file.size();
+		core::ByteStream stream = core::ByteStream::view(file.data(), file.size());
+		const uint32_t magic = stream.readInt();
+		const uint32_t version = stream.readInt();
+		const uint32_t size = stream.readInt();
+		const uint32_t compressedSize = stream.readInt();
+		const uint32_t checksum = stream.readInt();
+		if (magic != CacheMagic || version != CacheVersion || compressedSize != (uint32_t)stream.getSize()
+				|| core::hash(stream.getBuffer(), (int)compressedSize) != checksum) {
+			Log::warn("Removing invalid world cache entry %s", name.c_str());
+			broken = true;
+		} else {
+			payload.clear();
+			payload.reserve(size);
+			if (!core::zip::decompressor().uncompress(stream.getBuffer(), compressedSize, payload) || payload.size() != size) {
+				Log::warn("Removing broken world cache entry %s", name.c_str());
+				broken = true;
+			}
+		}
+	}
+	if (broken) {
+		// the file is unmapped here - a mapped file can't be removed on every platform
+		remove(name);
+		++_misses;
+		return false;
+	}
+	touch(name, fileSize);
+	++_hits;
+	return true;
+}
+
+bool WorldCache::write(const core::String& name, const uint8_t* payload, size_t size) {
+	core_trace_scoped(WorldCacheWrite);
+	core::Buffer<uint8_t> compressed;
+	if (!core::zip::compressor().compress(payload, size, compressed, core::zip::BestSpeed)) {
+		Log::debug("Failed to compress world cache entry %s", name.c_str());
+		return false;
+	}
+	core::ByteStream stream((int)(CacheHeaderSize + compressed.size()));
+	stream.addInt(CacheMagic);
+	stream.addInt(CacheVersion);
+	stream.addInt((uint32_t)size);
+	stream.addInt((uint32_t)compressed.size());
+	stream.addInt(core::hash(compressed.data(), (int)compressed.size()));
+	stream.append(compressed.data(), compressed.size());
+	if (!io::filesystem()->write(CacheDir + name, stream.getBuffer(), stream.getSize())) {
+		Log::debug("Failed to write world cache entry %s", name.c_str());
+		return false;
+	}
+	touch(name, stream.getSize());
+	return true;
+}
+
+bool WorldCache::loadChunk(const voxel::PagedVolume::ChunkPtr& chunk) {
+	if (!enabled()) {
+		return false;
+	}
+	core_trace_scoped(WorldCacheLoadChunk);
+	core::Buffer<uint8_t> payload;
+	if (!read(chunkName(chunk), payload)) {
+		return false;
+	}
+	if (payload.size() != chunk->dataSizeInBytes()) {
+		return false;
+	}
+	core_memcpy(chunk->data(), payload.data(), payload.size());
+	return true;
+}
+
+bool WorldCache::storeChunk(const voxel::PagedVolume::ChunkPtr& chunk) {
+	if (!enabled()) {
+		return false;
+	}
+	core_trace_scoped(WorldCacheStoreChunk);
+	return write(chunkName(chunk), (const uint8_t*)chunk->data(), chunk->dataSizeInBytes());
+}
+
+bool WorldCache::loadMesh(const voxel::Region& region, voxel::Mesh& mesh) {
+	if (!enabled()) {
+		return false;
+	}
+	core_trace_scoped(WorldCacheLoadMesh);
+	core::Buffer<uint8_t> payload;
+	if (!read(meshName(region), payload) || payload.size() < MeshHeaderSize) {
+		return false;
+	}
+	core::ByteStream stream = core::ByteStream::view(payload.data(), payload.size());
+	glm::ivec3 offset;
+	offset.x = stream.readInt();
+	offset.y = stream.readInt();
+	offset.z = stream.readInt();
+	const uint32_t vertices = stream.readInt();
+	const uint32_t indices = stream.readInt();
+	if ((size_t)stream.getSize() != vertices * sizeof(voxel::VoxelVertex) + indices * sizeof(voxel::IndexType)) {
+		return false;
+	}
+	const uint8_t *data = stream.getBuffer();
+	mesh.clear();
+	mesh.getVertexVector().append((const voxel::VoxelVertex*)data, vertices);
+	mesh.getIndexVector().append((const voxel::IndexType*)(data + vertices * sizeof(voxel::VoxelVertex)), indices);
+	mesh.setOffset(offset);
+	return true;
+}
+
+bool WorldCache::storeMesh(const voxel::Region& region, const voxel::Mesh& mesh) {
+	if (!enabled()) {
+		return false;
+	}
+	core_trace_scoped(WorldCacheStoreMesh);
+	const size_t vertexSize = mesh.getNoOfVertices() * sizeof(voxel::VoxelVertex);
+	const size_t indexSize = mesh.getNoOfIndices() * sizeof(voxel::IndexType);
+	core::ByteStream stream((int)(MeshHeaderSize + vertexSize + indexSize));
+	const glm::ivec3& offset = mesh.getOffset();
+	stream.addInt(offset.x);
+	stream.addInt(offset.y);
+	stream.addInt(offset.z);
+	stream.addInt((uint32_t)mesh.getNoOfVertices());
+	stream.addInt((uint32_t)mesh.getNoOfIndices());
+	stream.append((const uint8_t*)mesh.getRawVertexData(), vertexSize);
+	stream.append((const uint8_t*)mesh.getRawIndexData(), indexSize);
+	return write(meshName(region), stream.getBuffer(), stream.getSize());
+}
+
+bool WorldCache::loadTile(int tileSize, int zoom, const glm::ivec2& pos, core::Buffer<uint8_t>& payload) {
+	if (!enabled()) {
+		return false;
+	}
+	core_trace_scoped(WorldCacheLoadTile);
+	return read(tileName(tileSize, zoom, pos), payload);
+}
+
+bool WorldCache::storeTile(int tileSize, int zoom, const glm::ivec2& pos, const uint8_t* payload, size_t size) {
+	if (!enabled()) {
+		return false;
+	}
+	core_trace_scoped(WorldCacheStoreTile);
+	return write(tileName(tileSize, zoom, pos), payload, size);
+}
+
+}
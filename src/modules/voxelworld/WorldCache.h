@@ -0,0 +1,151 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/IComponent.h"
+#include "core/String.h"
+#include "core/Var.h"
+#include "core/Trace.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/StringMap.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
+#include "voxel/PagedVolume.h"
+#include "voxel/Region.h"
+#include <glm/vec2.hpp>
+#include <memory>
+
+namespace voxel {
+class Mesh;
+}
+
+namespace voxelworld {
+
+/**
+ * @brief On-disk cache of generated chunks, the meshes that were extracted from them and the overview map tiles
+ *
+ * Generating a chunk or extracting a mesh gives the same result for the same seed, world parameters and generator
+ * version - the cache key is built from those values. Changing any of them just leads to new entries, the old ones
+ * age out. The entries are stored compressed in the home directory together with a checksum. Broken entries are
+ * removed and treated like a cache miss.
+ *
+ * The size of all entries is limited by the @c world_cache_size cvar (in megabytes) - the least recently used
+ * entries are evicted first. The usage order survives restarts in an index file that is written on shutdown.
+ *
+ * Modified chunks have to be passed to invalidate() - the mesh extraction doesn't use the cache for
+ * regions with modified chunks in memory.
+ *
+ * Can be disabled with the @c world_cache cvar.
+ *
+ * @note The load and store methods are thread safe.
+ */
+class WorldCache : public core::IComponent {
+public:
+	static constexpr int MaxEntries = 16384;
+
+private:
+	struct Entry {
+		uint64_t size;
+		uint64_t lastUsed;
+	};
+	mutable core_trace_mutex(core::Lock, _lock, "WorldCache");
+	core::StringMap<Entry, 1031> _entries { MaxEntries };
+	core::String _key;
+	uint64_t _totalSize = 0u;
+	uint64_t _tick = 0u;
+	core::VarPtr _enabled;
+	core::VarPtr _maxSize;
+	core::AtomicInt _hits { 0 };
+	core::AtomicInt _misses { 0 };
+
+	core::String chunkName(const voxel::PagedVolume::ChunkPtr& chunk) const;
+	core::String meshName(const voxel::Region& region) const;
+	core::String tileName(int tileSize, int zoom, const glm::ivec2& pos) const;
+
+	bool read(const core::String& name, core::Buffer<uint8_t>& payload);
+	bool write(const core::String& name, const uint8_t* payload, size_t size);
+	void remove(const core::String& name);
+	void touch(const core::String& name, uint64_t size);
+	/**
+	 * @note Expects the lock to be held
+	 */
+	void evict(uint64_t maxSize);
+	void writeIndex() const;
+
+public:
+	/**
+	 * @brief Builds the cache key for a generated world
+	 * @param[in] paramsHash Hash over all the parameters that have an influence on the generation
+	 */
+	static core::String key(unsigned int seed, uint32_t paramsHash, uint32_t generatorVersion);
+
+	/**
+	 * @brief Collects the existing entries and restores their usage order
+	 */
+	bool init() override;
+	/**
+	 * @brief Persists the usage order of the entries
+	 */
+	void shutdown() override;
+
+	bool enabled() const;
+
+	/**
+	 * @brief Selects the world the chunks and meshes are loaded for and stored to
+	 * @sa key()
+	 */
+	void setKey(const core::String& key);
+	const core::String& currentKey() const;
+
+	bool loadChunk(const voxel::PagedVolume::ChunkPtr& chunk);
+	bool storeChunk(const voxel::PagedVolume::ChunkPtr& chunk);
+
+	/**
+	 * @param[in] region The region the mesh was extracted for
+	 */
+	bool loadMesh(const voxel::Region& region, voxel::Mesh& mesh);
+	bool storeMesh(const voxel::Region& region, const voxel::Mesh& mesh);
+
+	/**
+	 * @brief Overview map tiles - the payload is not interpreted by the cache
+	 * @sa OverviewMap
+	 */
+	bool loadTile(int tileSize, int zoom, const glm::ivec2& pos, core::Buffer<uint8_t>& payload);
+	bool storeTile(int tileSize, int zoom, const glm::ivec2& pos, const uint8_t* payload, size_t size);
+
+	/**
+	 * @brief Removes the chunk and mesh entries of the current world that are affected by changes in the given region
+	 */
+	void invalidate(const voxel::Region& region);
+
+	/**
+	 * @brief Removes all entries of all worlds
+	 */
+	void clear();
+
+	size_t entries() const;
+	/**
+	 * @return The size of all entries on disk in bytes
+	 */
+	uint64_t size() const;
+	int hits() const;
+	int misses() const;
+};
+
+inline const core::String& WorldCache::currentKey() const {
+	return _key;
+}
+
+inline int WorldCache::hits() const {
+	return _hits;
+}
+
+inline int WorldCache::misses() const {
+	return _misses;
+}
+
+typedef std::shared_ptr<WorldCache> WorldCachePtr;
+
+}
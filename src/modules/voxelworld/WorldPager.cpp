@@ -8,6 +8,7 @@
 #include "voxelutil/Raycast.h"
 #include "noise/Simplex.h"
 #include "core/Common.h"
+#include "core/Hash.h"
 #include "core/StringUtil.h"
 #include "core/collection/Array.h"
 
@@ -19,6 +20,9 @@ WorldPager::WorldPager(const voxelformat::VolumeCachePtr& volumeCache, const Chu
 
 void WorldPager::erase(const voxel::Region& region) {
 	_chunkPersister->erase(region, _seed);
+	if (_worldCache) {
+		_worldCache->invalidate(region);
+	}
 }
 
 bool WorldPager::pageIn(voxel::PagedVolume::PagerContext& pctx) {
@@ -29,6 +33,16 @@ bool WorldPager::pageIn(voxel::PagedVolume::PagerContext& pctx) {
 	if (_chunkPersister->load(pctx.chunk, _seed)) {
 		return false;
 	}
+	// a generated chunk is already persisted and cached - only later changes lead to a pageOut()
+	generate(pctx);
+	return false;
+}
+
+bool WorldPager::generate(voxel::PagedVolume::PagerContext& pctx) {
+	core_assert(_volumeData != nullptr);
+	if (_worldCache && _worldCache->loadChunk(pctx.chunk)) {
+		return false;
+	}
 	voxel::PagedVolumeWrapper wrapper(_volumeData, pctx.chunk, pctx.region);
 	//if (pctx.region.getLowerX() == 0 && pctx.region.getLowerZ() == 0) {
 	core_trace_scoped(CreateWorld);
@@ -36,20 +50,48 @@ bool WorldPager::pageIn(voxel::PagedVolume::PagerContext& pctx) {
 	createWorld(wrapper);
 	placeTrees(pctx);
 	_chunkPersister->save(pctx.chunk, _seed);
+	if (_worldCache) {
+		_worldCache->storeChunk(pctx.chunk);
+	}
 	//}
 	return true;
 }
 
 void WorldPager::pageOut(voxel::PagedVolume::Chunk* chunk) {
-	// currently chunks are not modifiable and are saved directly after creating the chunk
+	// the chunk was modified after it was paged in - the cached chunk and the meshes are outdated
+	if (_worldCache) {
+		const int sideLength = chunk->sideLength();
+		const glm::ivec3& mins = chunk->chunkPos() * sideLength;
+		_worldCache->invalidate(voxel::Region(mins, mins + glm::ivec3(sideLength - 1)));
+	}
 }
 
 void WorldPager::setSeed(unsigned int seed) {
 	_seed = seed;
+	updateCacheKey();
 }
 
 void WorldPager::setNoiseOffset(const glm::vec2& noiseOffset) {
 	_noiseSeedOffset = noiseOffset;
+	updateCacheKey();
+}
+
+void WorldPager::setWorldCache(const WorldCachePtr& worldCache) {
+	_worldCache = worldCache;
+	updateCacheKey();
+}
+
+void WorldPager::updateCacheKey() {
+	if (!_worldCache) {
+		return;
+	}
+	if (_volumeData == nullptr) {
+		// not yet initialized - there is nothing to cache
+		_worldCache->setKey("");
+		return;
+	}
+	const uint32_t hash = core::hash(&_noiseSeedOffset, (int)sizeof(_noiseSeedOffset), _paramsHash);
+	_worldCache->setKey(WorldCache::key(_seed, hash, GeneratorVersion));
 }
 
 bool WorldPager::init(voxel::PagedVolume *volumeData, const core::String& worldParamsLua, const core::String& biomesLua) {
@@ -60,6 +102,7 @@ bool WorldPager::init(voxel::PagedVolume *volumeData, const core::String& worldP
 	if (!_worldCtx.load(worldParamsLua)) {
 		return false;
 	}
+	_paramsHash = core::hash(biomesLua.c_str(), (int)biomesLua.size(), core::hash(worldParamsLua.c_str(), (int)worldParamsLua.size()));
 	if (!_noise.init()) {
 		return false;
 	}
@@ -67,6 +110,7 @@ bool WorldPager::init(voxel::PagedVolume *volumeData, const core::String& worldP
 		return false;
 	}
 	_volumeData = volumeData;
+	updateCacheKey();
 	return _volumeData != nullptr;
 }
 
@@ -79,6 +123,7 @@ void WorldPager::shutdown() {
 	_volumeData = nullptr;
 	_biomeManager.shutdown();
 	_worldCtx = WorldContext();
+	updateCacheKey();
 }
 
 // use a 2d noise to switch between different noises - to generate steep mountains
@@ -196,6 +241,19 @@ int WorldPager::fillVoxels(int x, int minsY, int z, voxel::Voxel* voxels) const
 	return core_max(ni - minsY, voxel::MAX_WATER_HEIGHT - minsY);
 }
 
+voxel::Voxel WorldPager::surfaceVoxel(int x, int z, int& height) const {
+	core_trace_scoped(SurfaceVoxel);
+	// createWorld() fills blocks of 2x2 columns with the values of the even column
+	const glm::ivec3 pos(x & ~1, 0, z & ~1);
+	const int ni = terrainHeight(pos.x, 0, pos.z);
+	if (ni < voxel::MAX_WATER_HEIGHT) {
+		height = voxel::MAX_WATER_HEIGHT;
+		return createColorVoxel(voxel::VoxelType::Water, _seed);
+	}
+	height = ni;
+	return _biomeManager.getVoxel(glm::ivec3(pos.x, ni - 1, pos.z), false);
+}
+
 void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx) {
 	// expand region to all surrounding regions by half of the region size.
 	// we do this to be able to limit the generation on the current chunk. Otherwise
@@ -13,6 +13,7 @@
 #include "BiomeManager.h"
 #include "core/SharedPtr.h"
 #include "ChunkPersister.h"
+#include "WorldCache.h"
 #include "TreeVolumeCache.h"
 #include "voxelutil/RawVolumeRotateWrapper.h"
 
@@ -32,7 +33,7 @@ namespace voxelworld {
 class WorldPager: public voxel::PagedVolume::Pager {
 private:
 	unsigned int _seed = 0l;
-	glm::vec2 _noiseSeedOffset;
+	glm::vec2 _noiseSeedOffset { 0.0f };
 
 	voxel::PagedVolume *_volumeData = nullptr;
 	BiomeManager _biomeManager;
@@ -40,6 +41,8 @@ private:
 	noise::Noise _noise;
 	TreeVolumeCache _volumeCache;
 	ChunkPersisterPtr _chunkPersister;
+	WorldCachePtr _worldCache;
+	uint32_t _paramsHash = 0u;
 
 	void createWorld(voxel::PagedVolumeWrapper& volume) const;
 	void placeTrees(voxel::PagedVolume::PagerContext& pagerCtx);
@@ -55,7 +58,14 @@ private:
 	float getNoiseValue(float x, float z) const;
 	float getDensity(float x, float y, float z, float n) const;
 
+	void updateCacheKey();
+
 public:
+	/**
+	 * @brief Bump this whenever the generation code produces different results - this invalidates the world cache
+	 */
+	static constexpr uint32_t GeneratorVersion = 1u;
+
 	WorldPager(const voxelformat::VolumeCachePtr& volumeCache, const ChunkPersisterPtr& chunkPersister);
 	/**
 	 * @brief Initializes the pager
@@ -73,6 +83,13 @@ public:
 
 	const ChunkPersisterPtr& chunkPersister() const;
 
+	/**
+	 * @brief Generated chunks are looked up in and stored to the given cache
+	 * @note The cache is not initialized by the pager
+	 */
+	void setWorldCache(const WorldCachePtr& worldCache);
+	const WorldCachePtr& worldCache() const;
+
 	/**
 	 * @brief The ssed that is going to be used for creating the world
 	 */
@@ -82,9 +99,23 @@ public:
 
 	void erase(const voxel::Region& region);
 	/**
-	 * @return @c true if the chunk was modified (created), @c false if it was just loaded
+	 * @return Always @c false - a generated chunk is persisted right away, so only chunks that were modified
+	 * afterwards are handed to pageOut()
 	 */
 	bool pageIn(voxel::PagedVolume::PagerContext& ctx) override;
+	/**
+	 * @brief Fills the chunk from the world cache or generates it - the chunk persister is not asked
+	 * @note The chunk doesn't have to be resident in the volume (see @c voxel::PagedVolume::createChunk()). This
+	 * allows to generate several full height chunks in parallel.
+	 * @return @c true if the chunk was generated, @c false if it was loaded from the cache
+	 */
+	bool generate(voxel::PagedVolume::PagerContext& ctx);
+	/**
+	 * @brief The topmost voxel of the terrain (or the water above it) at the given column - without trees
+	 * @note Nothing is paged in - this is evaluated from the noise and the biomes only
+	 * @param[out] height The height of the surface - the returned voxel is located at @c height - 1
+	 */
+	voxel::Voxel surfaceVoxel(int x, int z, int& height) const;
 	void pageOut(voxel::PagedVolume::Chunk* chunk) override;
 };
 
@@ -92,6 +123,10 @@ inline const ChunkPersisterPtr& WorldPager::chunkPersister() const {
 	return _chunkPersister;
 }
 
+inline const WorldCachePtr& WorldPager::worldCache() const {
+	return _worldCache;
+}
+
 typedef core::SharedPtr<WorldPager> WorldPagerPtr;
 
 }
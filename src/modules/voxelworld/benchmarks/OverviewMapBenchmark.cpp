@@ -0,0 +1,115 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/concurrent/Concurrency.h"
+#include "voxelworld/OverviewMap.h"
+#include "voxelworld/WorldCache.h"
+#include "voxelworld/WorldPager.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/PagedVolume.h"
+#include "voxelformat/VolumeCache.h"
+
+/**
+ * @brief Generates overview map tiles at several zoom levels
+ *
+ * The costs of a tile should not depend on the zoom level - a pixel is always one sample of the terrain functions.
+ */
+class OverviewMapBenchmark: public app::AbstractBenchmark {
+protected:
+	static constexpr int AreaTiles = 4;
+
+	voxelformat::VolumeCachePtr _volumeCache;
+	voxelworld::WorldCachePtr _worldCache;
+	voxelworld::WorldPagerPtr _pager;
+	voxel::PagedVolume *_volume = nullptr;
+
+public:
+	void onCleanupApp() override {
+		if (_volume != nullptr) {
+			_volume->flushAll();
+		}
+		if (_pager) {
+			_pager->shutdown();
+		}
+		delete _volume;
+		_volume = nullptr;
+		_pager = voxelworld::WorldPagerPtr();
+		if (_worldCache) {
+			_worldCache->clear();
+			_worldCache->shutdown();
+		}
+		if (_volumeCache) {
+			_volumeCache->shutdown();
+		}
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		_worldCache = std::make_shared<voxelworld::WorldCache>();
+		if (!_worldCache->init()) {
+			return false;
+		}
+		_volumeCache = std::make_shared<voxelformat::VolumeCache>();
+		if (!_volumeCache->init()) {
+			return false;
+		}
+		_pager = core::make_shared<voxelworld::WorldPager>(_volumeCache, std::make_shared<voxelworld::ChunkPersister>());
+		_volume = new voxel::PagedVolume(_pager.get(), 1024 * 1024 * 1024, 256);
+		_pager->setSeed(0u);
+		return _pager->init(_volume, io::filesystem()->load("worldparams.lua"), io::filesystem()->load("biomes.lua"));
+	}
+};
+
+BENCHMARK_DEFINE_F(OverviewMapBenchmark, tile) (benchmark::State& state) {
+	const int zoom = (int)state.range(0);
+	_pager->setWorldCache(voxelworld::WorldCachePtr());
+	voxelworld::OverviewMap overviewMap(_pager, 1);
+	overviewMap.init();
+	int x = 0;
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(overviewMap.tile(zoom, glm::ivec2(x++, 0)));
+	}
+	overviewMap.shutdown();
+	state.SetItemsProcessed(state.iterations() * voxelworld::OverviewMap::TileSize * voxelworld::OverviewMap::TileSize);
+	state.counters["voxels/tile"] = (double)voxelworld::OverviewMap::voxelsPerTile(zoom) * voxelworld::OverviewMap::voxelsPerTile(zoom);
+}
+
+BENCHMARK_DEFINE_F(OverviewMapBenchmark, tilesParallel) (benchmark::State& state) {
+	const int zoom = (int)state.range(0);
+	_pager->setWorldCache(voxelworld::WorldCachePtr());
+	voxelworld::OverviewMap overviewMap(_pager, core::cpus());
+	overviewMap.init();
+	const int size = voxelworld::OverviewMap::voxelsPerTile(zoom) * AreaTiles;
+	int x = 0;
+	while (state.KeepRunning()) {
+		core::DynamicArray<voxelworld::OverviewMap::TilePtr> tiles;
+		overviewMap.tiles(zoom, glm::ivec2(x, 0), glm::ivec2(x + size - 1, size - 1), tiles);
+		benchmark::DoNotOptimize(tiles);
+		x += size;
+	}
+	overviewMap.shutdown();
+	state.SetItemsProcessed(state.iterations() * AreaTiles * AreaTiles);
+	state.counters["threads"] = core::cpus();
+}
+
+BENCHMARK_DEFINE_F(OverviewMapBenchmark, tileCached) (benchmark::State& state) {
+	const int zoom = (int)state.range(0);
+	_worldCache->clear();
+	_pager->setWorldCache(_worldCache);
+	voxelworld::OverviewMap overviewMap(_pager, 1);
+	overviewMap.init();
+	overviewMap.tile(zoom, glm::ivec2(0));
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(overviewMap.tile(zoom, glm::ivec2(0)));
+	}
+	overviewMap.shutdown();
+	_pager->setWorldCache(voxelworld::WorldCachePtr());
+	state.counters["generated"] = overviewMap.generated();
+	state.counters["cached"] = overviewMap.cached();
+}
+
+BENCHMARK_REGISTER_F(OverviewMapBenchmark, tile)->Arg(0)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(OverviewMapBenchmark, tilesParallel)->Arg(0)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(OverviewMapBenchmark, tileCached)->Arg(0)->Arg(8)->Unit(benchmark::kMillisecond);
@@ -43,6 +43,20 @@ BENCHMARK_DEFINE_F(PagedVolumeBenchmark, pageIn) (benchmark::State& state) {
 	}
 }
 
+BENCHMARK_DEFINE_F(PagedVolumeBenchmark, biomeVoxel) (benchmark::State& state) {
+	voxelworld::BiomeManager biomeManager;
+	biomeManager.init(io::filesystem()->load("biomes.lua"));
+	glm::ivec3 pos(0);
+	while (state.KeepRunning()) {
+		for (pos.y = 0; pos.y < voxel::MAX_TERRAIN_HEIGHT; ++pos.y) {
+			benchmark::DoNotOptimize(biomeManager.getVoxel(pos));
+		}
+		++pos.x;
+	}
+	state.SetItemsProcessed(state.iterations() * voxel::MAX_TERRAIN_HEIGHT);
+}
+
 BENCHMARK_REGISTER_F(PagedVolumeBenchmark, pageIn);
+BENCHMARK_REGISTER_F(PagedVolumeBenchmark, biomeVoxel);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "voxelworld/WorldCache.h"
+#include "voxelworld/WorldPager.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/Mesh.h"
+#include "voxel/PagedVolume.h"
+#include "voxel/Constants.h"
+#include "voxelformat/VolumeCache.h"
+
+/**
+ * @brief Compares loading an area of the world with an empty (cold) and a filled (warm) world cache
+ *
+ * Loading means paging in the chunk and extracting the meshes for the area - the same steps the world renderer
+ * performs with the world cache.
+ */
+class WorldCacheBenchmark: public app::AbstractBenchmark {
+protected:
+	static constexpr int ChunkSideLength = 256;
+	static constexpr int MeshSize = 32;
+	static constexpr int AreaSize = 64;
+
+	voxelformat::VolumeCachePtr _volumeCache;
+	voxelworld::WorldCachePtr _worldCache;
+	core::String _luaParameters;
+	core::String _luaBiomes;
+
+public:
+	void onCleanupApp() override {
+		if (_worldCache) {
+			_worldCache->clear();
+			_worldCache->shutdown();
+		}
+		if (_volumeCache) {
+			_volumeCache->shutdown();
+		}
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		_luaParameters = io::filesystem()->load("worldparams.lua");
+		_luaBiomes = io::filesystem()->load("biomes.lua");
+		_worldCache = std::make_shared<voxelworld::WorldCache>();
+		if (!_worldCache->init()) {
+			return false;
+		}
+		_volumeCache = std::make_shared<voxelformat::VolumeCache>();
+		return _volumeCache->init();
+	}
+
+	/**
+	 * @return The amount of extracted vertices
+	 */
+	size_t load() {
+		voxelworld::WorldPager pager(_volumeCache, std::make_shared<voxelworld::ChunkPersister>());
+		pager.setWorldCache(_worldCache);
+		pager.setSeed(0u);
+		voxel::PagedVolume volume(&pager, 1024 * 1024 * 1024, ChunkSideLength);
+		pager.init(&volume, _luaParameters, _luaBiomes);
+		size_t vertices = 0u;
+		for (int z = 0; z < AreaSize; z += MeshSize) {
+			for (int x = 0; x < AreaSize; x += MeshSize) {
+				const voxel::Region region(glm::ivec3(x, 0, z), glm::ivec3(x + MeshSize - 1, voxel::MAX_MESH_CHUNK_HEIGHT - 2, z + MeshSize - 1));
+				voxel::Mesh mesh(MeshSize * MeshSize * 64, MeshSize * MeshSize * 64);
+				if (!_worldCache->loadMesh(region, mesh)) {
+					voxel::extractCubicMesh(&volume, region, &mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
+					_worldCache->storeMesh(region, mesh);
+				}
+				vertices += mesh.getNoOfVertices();
+			}
+		}
+		volume.flushAll();
+		pager.shutdown();
+		return vertices;
+	}
+};
+
+BENCHMARK_DEFINE_F(WorldCacheBenchmark, cold) (benchmark::State& state) {
+	while (state.KeepRunning()) {
+		state.PauseTiming();
+		_worldCache->clear();
+		state.ResumeTiming();
+		benchmark::DoNotOptimize(load());
+	}
+}
+
+BENCHMARK_DEFINE_F(WorldCacheBenchmark, warm) (benchmark::State& state) {
+	_worldCache->clear();
+	load();
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(load());
+	}
+	state.counters["hits"] = _worldCache->hits();
+	state.counters["misses"] = _worldCache->misses();
+}
+
+BENCHMARK_REGISTER_F(WorldCacheBenchmark, cold)->Iterations(3)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(WorldCacheBenchmark, warm)->Iterations(3)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,112 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxelworld/OverviewMap.h"
+#include "voxelworld/WorldCache.h"
+#include "voxelworld/WorldPager.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/PagedVolume.h"
+#include "voxelformat/VolumeCache.h"
+#include "io/Filesystem.h"
+
+namespace voxelworld {
+
+class OverviewMapTest: public app::AbstractTest {
+protected:
+	voxelformat::VolumeCachePtr _volumeCache;
+	WorldCachePtr _worldCache;
+	WorldPagerPtr _pager;
+	voxel::PagedVolume* _volume = nullptr;
+
+	void SetUp() override {
+		app::AbstractTest::SetUp();
+		ASSERT_TRUE(voxel::initDefaultMaterialColors());
+		core::Var::get("world_cache", "true")->setVal(true);
+		core::Var::get("world_cache_size", "512")->setVal(512);
+		_worldCache = std::make_shared<WorldCache>();
+		ASSERT_TRUE(_worldCache->init());
+		_worldCache->clear();
+		_volumeCache = std::make_shared<voxelformat::VolumeCache>();
+		ASSERT_TRUE(_volumeCache->init());
+		_pager = core::make_shared<WorldPager>(_volumeCache, std::make_shared<ChunkPersister>());
+		_volume = new voxel::PagedVolume(_pager.get(), 1024 * 1024 * 1024, 256);
+		_pager->setSeed(1u);
+		ASSERT_TRUE(_pager->init(_volume, io::filesystem()->load("worldparams.lua"), io::filesystem()->load("biomes.lua")));
+		_pager->setWorldCache(_worldCache);
+	}
+
+	void TearDown() override {
+		_volume->flushAll();
+		_pager->shutdown();
+		delete _volume;
+		_volume = nullptr;
+		_pager = WorldPagerPtr();
+		_worldCache->clear();
+		_worldCache->shutdown();
+		_volumeCache->shutdown();
+		app::AbstractTest::TearDown();
+	}
+};
+
+TEST_F(OverviewMapTest, testTilePos) {
+	EXPECT_EQ(OverviewMap::TileSize * 4, OverviewMap::voxelsPerTile(2));
+	EXPECT_EQ(glm::ivec2(-1, 1), OverviewMap::tilePos(0, glm::ivec2(-1, OverviewMap::TileSize)));
+	EXPECT_EQ(glm::ivec2(0, -1), OverviewMap::tilePos(2, glm::ivec2(OverviewMap::TileSize * 4 - 1, -1)));
+}
+
+TEST_F(OverviewMapTest, testSurfaceMatchesVolume) {
+	OverviewMap overviewMap(_pager, 2);
+	ASSERT_TRUE(overviewMap.init());
+	const OverviewMap::TilePtr& tile = overviewMap.tile(0, glm::ivec2(0));
+	ASSERT_TRUE(tile);
+	// at zoom level 0 each pixel is one voxel column
+	for (int z = 0; z < OverviewMap::TileSize; z += 5) {
+		for (int x = 0; x < OverviewMap::TileSize; x += 5) {
+			const int index = z * OverviewMap::TileSize + x;
+			const int height = tile->heights[index];
+			ASSERT_GT(height, 0);
+			const voxel::Voxel& surface = _volume->voxel(x, height - 1, z);
+			const voxel::VoxelType material = surface.getMaterial();
+			if (!voxel::isAir(_volume->voxel(x, height, z).getMaterial()) || voxel::isWood(material) || material == voxel::VoxelType::Generic) {
+				// trees are not part of the overview
+				continue;
+			}
+			EXPECT_EQ((int)material, (int)tile->biomes[index]) << "at " << x << ":" << z << " with height " << height;
+		}
+	}
+	overviewMap.shutdown();
+}
+
+TEST_F(OverviewMapTest, testCache) {
+	OverviewMap overviewMap(_pager, 2);
+	ASSERT_TRUE(overviewMap.init());
+	const OverviewMap::TilePtr& generated = overviewMap.tile(3, glm::ivec2(-1, 2));
+	EXPECT_EQ(1, overviewMap.generated());
+	EXPECT_EQ(0, overviewMap.cached());
+	const OverviewMap::TilePtr& cached = overviewMap.tile(3, glm::ivec2(-1, 2));
+	EXPECT_EQ(1, overviewMap.generated());
+	EXPECT_EQ(1, overviewMap.cached());
+	EXPECT_EQ(0, memcmp(generated->heights, cached->heights, sizeof(generated->heights)));
+	EXPECT_EQ(0, memcmp(generated->colors, cached->colors, sizeof(generated->colors)));
+	EXPECT_EQ(0, memcmp(generated->biomes, cached->biomes, sizeof(generated->biomes)));
+	overviewMap.shutdown();
+}
+
+TEST_F(OverviewMapTest, testTiles) {
+	OverviewMap overviewMap(_pager, 4);
+	ASSERT_TRUE(overviewMap.init());
+	const int size = OverviewMap::voxelsPerTile(4);
+	core::DynamicArray<OverviewMap::TilePtr> tiles;
+	ASSERT_EQ(3, overviewMap.tiles(4, glm::ivec2(-size, 0), glm::ivec2(size + 1, size - 1), tiles));
+	ASSERT_EQ(3u, tiles.size());
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_EQ(glm::ivec2(i - 1, 0), tiles[i]->pos);
+		EXPECT_EQ(4, tiles[i]->zoom);
+	}
+	EXPECT_EQ(3, overviewMap.generated());
+	overviewMap.shutdown();
+}
+
+}
@@ -0,0 +1,164 @@
+/**
+ * @file
+ */
+
+#include "voxelworld/WorldCache.h"
+#include "voxel/Mesh.h"
+#include "io/Filesystem.h"
+#include "core/StringUtil.h"
+
+#include "AbstractVoxelTest.h"
+
+namespace voxelworld {
+
+class WorldCacheTest: public AbstractVoxelTest {
+protected:
+	WorldCache _cache;
+
+	void SetUp() override {
+		AbstractVoxelTest::SetUp();
+		core::Var::get("world_cache", "true")->setVal(true);
+		core::Var::get("world_cache_size", "512")->setVal(512);
+		ASSERT_TRUE(_cache.init());
+		_cache.clear();
+		_cache.setKey(WorldCache::key(_seed, 42u, 1u));
+	}
+
+	void TearDown() override {
+		_cache.clear();
+		_cache.shutdown();
+		AbstractVoxelTest::TearDown();
+	}
+
+	/**
+	 * @brief Creates a mesh that doesn't compress well
+	 */
+	voxel::Mesh randomMesh(int vertices) {
+		voxel::Mesh mesh(vertices, vertices, true);
+		for (int i = 0; i < vertices; ++i) {
+			voxel::VoxelVertex vertex;
+			vertex.position = glm::i16vec3(_random.random(-32768, 32767), _random.random(-32768, 32767), _random.random(-32768, 32767));
+			vertex.ambientOcclusion = (uint8_t)_random.random(0, 3);
+			vertex.colorIndex = (uint8_t)_random.random(0, 255);
+			mesh.addVertex(vertex);
+		}
+		for (int i = 0; i + 2 < vertices; i += 3) {
+			mesh.addTriangle(i, i + 1, i + 2);
+		}
+		return mesh;
+	}
+
+	static voxel::Region meshRegion(int i) {
+		return voxel::Region(glm::ivec3(i * 32, 0, 0), glm::ivec3(i * 32 + 31, 254, 31));
+	}
+};
+
+TEST_F(WorldCacheTest, testChunk) {
+	ASSERT_TRUE(_cache.storeChunk(_ctx.chunk()));
+	_volData.flushAll();
+	const voxel::PagedVolume::ChunkPtr& chunk = _volData.chunk(_region.getCenter());
+	chunk->setVoxel(32, 32, 32, voxel::Voxel());
+	ASSERT_TRUE(_cache.loadChunk(chunk));
+	EXPECT_EQ(voxel::VoxelType::Grass, chunk->voxel(32, 32, 32).getMaterial());
+	EXPECT_EQ(1, _cache.hits());
+	EXPECT_EQ(1u, _cache.entries());
+}
+
+TEST_F(WorldCacheTest, testMesh) {
+	voxel::Mesh mesh = randomMesh(300);
+	mesh.setOffset(glm::ivec3(32, 0, 64));
+	const voxel::Region& region = meshRegion(1);
+	ASSERT_TRUE(_cache.storeMesh(region, mesh));
+	voxel::Mesh loaded;
+	ASSERT_TRUE(_cache.loadMesh(region, loaded));
+	EXPECT_EQ(mesh.getOffset(), loaded.getOffset());
+	ASSERT_EQ(mesh.getNoOfVertices(), loaded.getNoOfVertices());
+	ASSERT_EQ(mesh.getNoOfIndices(), loaded.getNoOfIndices());
+	EXPECT_EQ(0, SDL_memcmp(mesh.getRawVertexData(), loaded.getRawVertexData(), mesh.getNoOfVertices() * sizeof(voxel::VoxelVertex)));
+	EXPECT_EQ(0, SDL_memcmp(mesh.getRawIndexData(), loaded.getRawIndexData(), mesh.getNoOfIndices() * sizeof(voxel::IndexType)));
+	EXPECT_FALSE(_cache.loadMesh(meshRegion(2), loaded));
+}
+
+TEST_F(WorldCacheTest, testKey) {
+	const voxel::Region& region = meshRegion(0);
+	ASSERT_TRUE(_cache.storeMesh(region, randomMesh(30)));
+	voxel::Mesh loaded;
+	_cache.setKey(WorldCache::key(_seed + 1, 42u, 1u));
+	EXPECT_FALSE(_cache.loadMesh(region, loaded));
+	_cache.setKey(WorldCache::key(_seed, 42u, 2u));
+	EXPECT_FALSE(_cache.loadMesh(region, loaded));
+	_cache.setKey(WorldCache::key(_seed, 42u, 1u));
+	EXPECT_TRUE(_cache.loadMesh(region, loaded));
+}
+
+TEST_F(WorldCacheTest, testInvalidate) {
+	ASSERT_TRUE(_cache.storeChunk(_ctx.chunk()));
+	ASSERT_TRUE(_cache.storeMesh(meshRegion(0), randomMesh(30)));
+	ASSERT_TRUE(_cache.storeMesh(meshRegion(3), randomMesh(30)));
+	ASSERT_EQ(3u, _cache.entries());
+	// a modified voxel in the first mesh region and the chunk at the origin
+	_cache.invalidate(voxel::Region(glm::ivec3(10), glm::ivec3(10)));
+	EXPECT_EQ(1u, _cache.entries());
+	voxel::Mesh loaded;
+	EXPECT_FALSE(_cache.loadMesh(meshRegion(0), loaded));
+	EXPECT_FALSE(_cache.loadChunk(_ctx.chunk()));
+	EXPECT_TRUE(_cache.loadMesh(meshRegion(3), loaded));
+	// the border voxel of the neighbouring mesh region
+	_cache.invalidate(voxel::Region(glm::ivec3(95, 10, 10), glm::ivec3(95, 10, 10)));
+	EXPECT_FALSE(_cache.loadMesh(meshRegion(3), loaded));
+}
+
+TEST_F(WorldCacheTest, testCorruptedEntry) {
+	ASSERT_TRUE(_cache.storeChunk(_ctx.chunk()));
+	ASSERT_EQ(1u, _cache.entries());
+	const core::String path = core::string::format("worldcache/%s_c64_0_0_0", _cache.currentKey().c_str());
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	uint8_t *content = nullptr;
+	const int contentLength = filesystem->open(path)->read((void **)&content);
+	ASSERT_GT(contentLength, 0) << "Could not find the cache entry " << path;
+	++content[contentLength - 1];
+	ASSERT_TRUE(filesystem->write(path, content, contentLength));
+	EXPECT_FALSE(_cache.loadChunk(_ctx.chunk()));
+	EXPECT_EQ(0u, _cache.entries()) << "The corrupted entry should have been removed";
+	EXPECT_FALSE(filesystem->exists(path));
+
+	ASSERT_TRUE(_cache.storeChunk(_ctx.chunk()));
+	ASSERT_TRUE(filesystem->write(path, content, contentLength / 2));
+	EXPECT_FALSE(_cache.loadChunk(_ctx.chunk())) << "Truncated entries must not be loaded";
+	EXPECT_EQ(0u, _cache.entries());
+	delete[] content;
+}
+
+TEST_F(WorldCacheTest, testEviction) {
+	core::Var::getSafe("world_cache_size")->setVal(1);
+	// ~200KB per entry
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_TRUE(_cache.storeMesh(meshRegion(i), randomMesh(20000)));
+	}
+	EXPECT_LE(_cache.size(), 1024u * 1024u);
+	voxel::Mesh loaded;
+	EXPECT_FALSE(_cache.loadMesh(meshRegion(0), loaded)) << "The oldest entry should have been evicted";
+	EXPECT_TRUE(_cache.loadMesh(meshRegion(7), loaded));
+}
+
+TEST_F(WorldCacheTest, testUsageOrderSurvivesRestart) {
+	core::Var::getSafe("world_cache_size")->setVal(2);
+	for (int i = 0; i < 8; ++i) {
+		ASSERT_TRUE(_cache.storeMesh(meshRegion(i), randomMesh(20000)));
+	}
+	ASSERT_GT(_cache.size(), 1024u * 1024u) << "The entries are too small to test the eviction";
+	voxel::Mesh loaded;
+	// the oldest entry is now the most recently used one
+	ASSERT_TRUE(_cache.loadMesh(meshRegion(0), loaded));
+	_cache.shutdown();
+
+	core::Var::getSafe("world_cache_size")->setVal(1);
+	ASSERT_TRUE(_cache.init());
+	_cache.setKey(WorldCache::key(_seed, 42u, 1u));
+	EXPECT_LE(_cache.size(), 1024u * 1024u);
+	EXPECT_TRUE(_cache.loadMesh(meshRegion(0), loaded));
+	EXPECT_FALSE(_cache.loadMesh(meshRegion(1), loaded));
+	EXPECT_TRUE(_cache.loadMesh(meshRegion(7), loaded));
+}
+
+}
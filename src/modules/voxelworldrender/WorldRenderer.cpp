@@ -170,7 +170,7 @@ int WorldRenderer::renderToShadowMap(const video::Camera& camera) {
 	core_trace_scoped(WorldRendererRenderShadow);
 
 	// render the entities
-	_entityRenderer.renderShadows(_entityMgr.visibleEntities(), _shadow);
+	int drawCalls = _entityRenderer.renderShadows(_shadow);
 
 	// render the terrain
 	_shadowMapShader.activate();
@@ -181,7 +181,7 @@ int WorldRenderer::renderToShadowMap(const video::Camera& camera) {
 		return true;
 	}, false);
 	_shadowMapShader.deactivate();
-	return (int)_entityMgr.visibleEntities().size() + 1;
+	return drawCalls + 1;
 }
 
 int WorldRenderer::renderToFrameBuffer(const video::Camera& camera) {
@@ -197,6 +197,8 @@ int WorldRenderer::renderToFrameBuffer(const video::Camera& camera) {
 
 	int drawCallsWorld = 0;
 
+	_entityRenderer.prepare(_entityMgr.visibleEntities());
+
 	// render depth buffers
 	drawCallsWorld += renderEntitiesToDepthMap(camera);
 	drawCallsWorld += renderToShadowMap(camera);
@@ -321,11 +323,11 @@ int WorldRenderer::renderAll(const video::Camera& camera) {
 }
 
 int WorldRenderer::renderEntitiesToDepthMap(const video::Camera& camera) {
-	return _entityRenderer.renderEntitiesToDepthMap(_entityMgr.visibleEntities(), camera.viewProjectionMatrix());
+	return _entityRenderer.renderEntitiesToDepthMap(camera.viewProjectionMatrix());
 }
 
 int WorldRenderer::renderEntities(const glm::mat4& viewProjectionMatrix, const glm::vec4& clipPlane) {
-	return _entityRenderer.renderEntities(_entityMgr.visibleEntities(), viewProjectionMatrix, clipPlane, _shadow);
+	return _entityRenderer.renderEntities(viewProjectionMatrix, clipPlane, _shadow);
 }
 
 int WorldRenderer::renderEntityDetails(const video::Camera& camera) {
@@ -521,4 +523,8 @@ void WorldRenderer::extractMeshes(const video::Camera &camera) {
 	_worldChunkMgr.extractMeshes(camera);
 }
 
+void WorldRenderer::setWorldCache(const voxelworld::WorldCachePtr& worldCache) {
+	_worldChunkMgr.setWorldCache(worldCache);
+}
+
 }
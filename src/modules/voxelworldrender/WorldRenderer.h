@@ -128,6 +128,11 @@ public:
 
 	void extractMesh(const glm::ivec3 &pos);
 	void extractMeshes(const video::Camera &camera);
+	/**
+	 * @brief Extracted meshes are looked up in and stored to the given cache
+	 * @note Only use this for worlds that are not modified after they were generated
+	 */
+	void setWorldCache(const voxelworld::WorldCachePtr& worldCache);
 
 	float getViewDistance() const;
 	void setViewDistance(float viewDistance);
@@ -0,0 +1,333 @@
+/**
+ * @file
+ * @brief Replays scripted camera paths over a seeded world without opening a window
+ *
+ * The pager, the mesh extraction and the chunk manager are driven like in the client - only the upload of the
+ * extracted meshes is replaced by a counting sink. Use @c --benchmark_out=<file> @c --benchmark_out_format=json
+ * to record the counters for regression tracking.
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ArrayLength.h"
+#include "core/Common.h"
+#include "core/GameConfig.h"
+#include "core/TimeProvider.h"
+#include "core/Var.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
+#include "io/Filesystem.h"
+#include "video/Camera.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/PagedVolume.h"
+#include "voxelformat/VolumeCache.h"
+#include "voxelworld/WorldPager.h"
+#include "voxelworldrender/worldrenderer/WorldChunkMgr.h"
+#include <memory>
+
+namespace {
+
+constexpr double FrameSeconds = 1.0 / 60.0;
+constexpr float FarPlane = 128.0f;
+constexpr uint16_t ChunkSideLength = 256;
+constexpr uint32_t VolumeMemory = 1024 * 1024 * 1024;
+/**
+ * @brief Don't wait forever for a complete view if the streaming stalls
+ */
+constexpr double MaxSettleSeconds = 120.0;
+
+class CountingPager : public voxelworld::WorldPager {
+public:
+	core::AtomicInt pageIns;
+
+	CountingPager(const voxelformat::VolumeCachePtr& volumeCache, const voxelworld::ChunkPersisterPtr& chunkPersister) :
+			voxelworld::WorldPager(volumeCache, chunkPersister) {
+	}
+
+	bool pageIn(voxel::PagedVolume::PagerContext& ctx) override {
+		const bool modified = voxelworld::WorldPager::pageIn(ctx);
+		++pageIns;
+		return modified;
+	}
+};
+
+/**
+ * @brief Counts the meshes instead of uploading them to the gpu
+ */
+class CountingChunkMgr : public voxelworldrender::WorldChunkMgr {
+private:
+	size_t _meshBytes[MAX_CHUNKBUFFERS] {};
+
+protected:
+	bool uploadMesh(ChunkBuffer& chunkBuffer, const voxel::Mesh& mesh) override {
+		const size_t bytes = mesh.getNoOfVertices() * sizeof(voxel::VoxelVertex) + mesh.getNoOfIndices() * mesh.compressedIndexSize();
+		_meshBytes[&chunkBuffer - _chunkBuffers] = bytes;
+		uploadedBytes += bytes;
+		++uploads;
+		return true;
+	}
+
+public:
+	int uploads = 0;
+	size_t uploadedBytes = 0u;
+
+	CountingChunkMgr(core::ThreadPool& threadPool) :
+			voxelworldrender::WorldChunkMgr(threadPool) {
+	}
+
+	size_t residentMeshBytes() const {
+		size_t bytes = 0u;
+		for (int i = 0; i < MAX_CHUNKBUFFERS; ++i) {
+			if (_chunkBuffers[i].inuse) {
+				bytes += _meshBytes[i];
+			}
+		}
+		return bytes;
+	}
+
+	size_t pendingExtractions() const {
+		return _meshExtractor.pendingExtractions();
+	}
+
+	size_t extractedMeshes() const {
+		return _meshExtractor.extractedMeshes();
+	}
+
+	bool idle() const {
+		return _meshExtractor.idle();
+	}
+};
+
+struct Waypoint {
+	glm::vec3 pos;
+	/**
+	 * @brief Jump to the waypoint instead of moving there
+	 */
+	bool teleport;
+};
+
+struct CameraPath {
+	/**
+	 * @brief Units per second
+	 */
+	float speed;
+	core::DynamicArray<Waypoint> waypoints;
+};
+
+}
+
+class WorldStreamingBenchmark: public app::AbstractBenchmark {
+protected:
+	voxelformat::VolumeCachePtr _volumeCache;
+	core::String _worldParams;
+	core::String _biomes;
+
+	struct Stats {
+		int frames = 0;
+		uint64_t maxPendingExtractions = 0u;
+		uint64_t sumPendingExtractions = 0u;
+		uint64_t maxExtractedMeshes = 0u;
+		uint64_t peakMemory = 0u;
+		double settleMillis = 0.0;
+		int settles = 0;
+		int incompleteViews = 0;
+		core::DynamicArray<uint64_t> memory;
+	};
+
+	static uint64_t memory(const voxel::PagedVolume& volume, const CountingChunkMgr& chunkMgr) {
+		const uint64_t chunkBytes = (uint64_t)ChunkSideLength * ChunkSideLength * ChunkSideLength * sizeof(voxel::Voxel);
+		return (uint64_t)volume.chunks() * chunkBytes + chunkMgr.residentMeshBytes();
+	}
+
+	static void frame(video::Camera& camera, const voxel::PagedVolume& volume, CountingChunkMgr& chunkMgr, Stats& stats) {
+		camera.update(FrameSeconds);
+		chunkMgr.extractMeshes(camera);
+		glm::vec3 focusPos = camera.position();
+		focusPos.y = 0.0f;
+		chunkMgr.update(FrameSeconds, camera, focusPos);
+
+		const uint64_t pending = chunkMgr.pendingExtractions();
+		const uint64_t extracted = chunkMgr.extractedMeshes();
+		const uint64_t mem = memory(volume, chunkMgr);
+		stats.maxPendingExtractions = core_max(stats.maxPendingExtractions, pending);
+		stats.sumPendingExtractions += pending;
+		stats.maxExtractedMeshes = core_max(stats.maxExtractedMeshes, extracted);
+		stats.peakMemory = core_max(stats.peakMemory, mem);
+		stats.memory.push_back(mem);
+		++stats.frames;
+	}
+
+	/**
+	 * @brief Run frames until every visible chunk was extracted and handed over to the sink
+	 */
+	static void settle(video::Camera& camera, const voxel::PagedVolume& volume, CountingChunkMgr& chunkMgr, Stats& stats) {
+		const uint64_t start = core::TimeProvider::highResTime();
+		const uint64_t timeout = start + (uint64_t)(MaxSettleSeconds * (double)core::TimeProvider::highResTimeResolution());
+		uint64_t now;
+		do {
+			frame(camera, volume, chunkMgr, stats);
+			now = core::TimeProvider::highResTime();
+		} while (!chunkMgr.idle() && now < timeout);
+		if (!chunkMgr.idle()) {
+			++stats.incompleteViews;
+		}
+		stats.settleMillis += (double)(now - start) * 1000.0 / (double)core::TimeProvider::highResTimeResolution();
+		++stats.settles;
+	}
+
+	static void place(video::Camera& camera, const glm::vec3& pos, const glm::vec3& direction) {
+		camera.setPosition(pos);
+		camera.lookAt(pos + glm::vec3(direction.x, -0.5f, direction.z));
+	}
+
+	static void replay(const CameraPath& path, video::Camera& camera, const voxel::PagedVolume& volume, CountingChunkMgr& chunkMgr, Stats& stats) {
+		glm::vec3 pos = path.waypoints[0].pos;
+		glm::vec3 direction(1.0f, 0.0f, 0.0f);
+		place(camera, pos, direction);
+		settle(camera, volume, chunkMgr, stats);
+		bool moved = false;
+		for (size_t i = 1; i < path.waypoints.size(); ++i) {
+			const Waypoint& waypoint = path.waypoints[i];
+			if (waypoint.teleport) {
+				pos = waypoint.pos;
+				place(camera, pos, direction);
+				settle(camera, volume, chunkMgr, stats);
+				moved = false;
+				continue;
+			}
+			const glm::vec3 delta = waypoint.pos - pos;
+			const float length = glm::length(delta);
+			if (length <= 0.0f) {
+				continue;
+			}
+			direction = delta / length;
+			const float step = path.speed * (float)FrameSeconds;
+			const int steps = (int)glm::ceil(length / step);
+			for (int s = 1; s <= steps; ++s) {
+				place(camera, pos + direction * glm::min(length, step * (float)s), direction);
+				frame(camera, volume, chunkMgr, stats);
+			}
+			pos = waypoint.pos;
+			moved = true;
+		}
+		if (moved) {
+			// the time it takes to complete the view once the camera stopped
+			settle(camera, volume, chunkMgr, stats);
+		}
+	}
+
+	void run(benchmark::State& state, const CameraPath& path) {
+		const int threads = (int)state.range(0);
+		for (auto _ : state) {
+			state.PauseTiming();
+			CountingPager pager(_volumeCache, std::make_shared<voxelworld::ChunkPersister>());
+			pager.setSeed(1);
+			voxel::PagedVolume volume(&pager, VolumeMemory, ChunkSideLength);
+			pager.init(&volume, _worldParams, _biomes);
+
+			core::ThreadPool threadPool(threads, "Streaming");
+			threadPool.init();
+			std::unique_ptr<CountingChunkMgr> chunkMgr(new CountingChunkMgr(threadPool));
+			chunkMgr->init(nullptr, &volume);
+			chunkMgr->updateViewDistance(FarPlane);
+			core::AtomicBool cancel(false);
+			for (int i = 0; i < threads; ++i) {
+				threadPool.enqueue([&] () {
+					while (!cancel) {
+						chunkMgr->extractScheduledMesh();
+					}
+				});
+			}
+
+			video::Camera camera;
+			camera.setNearPlane(0.1f);
+			camera.setFarPlane(FarPlane);
+			camera.init(glm::ivec2(0), glm::ivec2(1024, 768), glm::ivec2(1024, 768));
+
+			Stats stats;
+			state.ResumeTiming();
+
+			const uint64_t start = core::TimeProvider::highResTime();
+			replay(path, camera, volume, *chunkMgr, stats);
+			const double seconds = (double)(core::TimeProvider::highResTime() - start) / (double)core::TimeProvider::highResTimeResolution();
+
+			state.PauseTiming();
+			cancel = true;
+			chunkMgr->shutdown();
+			threadPool.shutdown(true);
+
+			state.counters["frames"] = (double)stats.frames;
+			state.counters["view_complete_ms"] = stats.settles > 0 ? stats.settleMillis / (double)stats.settles : 0.0;
+			state.counters["incomplete_views"] = (double)stats.incompleteViews;
+			state.counters["page_ins"] = (double)(int)pager.pageIns;
+			state.counters["page_ins_per_sec"] = (double)(int)pager.pageIns / seconds;
+			state.counters["extractions"] = (double)chunkMgr->uploads;
+			state.counters["extractions_per_sec"] = (double)chunkMgr->uploads / seconds;
+			state.counters["uploaded_bytes"] = (double)chunkMgr->uploadedBytes;
+			state.counters["pending_extractions_max"] = (double)stats.maxPendingExtractions;
+			state.counters["pending_extractions_avg"] = (double)stats.sumPendingExtractions / (double)core_max(1, stats.frames);
+			state.counters["extracted_meshes_max"] = (double)stats.maxExtractedMeshes;
+			state.counters["memory_peak"] = benchmark::Counter((double)stats.peakMemory, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+			// memory over time - sampled at each quarter of the replayed frames
+			const char *quarters[] = {"memory_25", "memory_50", "memory_75", "memory_100"};
+			for (int i = 0; i < lengthof(quarters); ++i) {
+				const size_t idx = (stats.memory.size() * (i + 1)) / 4;
+				const uint64_t mem = stats.memory.empty() ? 0u : stats.memory[core_min(idx, stats.memory.size() - 1)];
+				state.counters[quarters[i]] = benchmark::Counter((double)mem, benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+			}
+			volume.flushAll();
+			pager.shutdown();
+			state.ResumeTiming();
+		}
+	}
+
+public:
+	void onCleanupApp() override {
+		if (_volumeCache) {
+			_volumeCache->shutdown();
+		}
+	}
+
+	bool onInitApp() override {
+		voxel::initDefaultMaterialColors();
+		core::Var::get(cfg::VoxelMeshSize, "32", core::CV_READONLY);
+		_worldParams = io::filesystem()->load("worldparams.lua");
+		_biomes = io::filesystem()->load("biomes.lua");
+		_volumeCache = std::make_shared<voxelformat::VolumeCache>();
+		return _volumeCache->init();
+	}
+};
+
+BENCHMARK_DEFINE_F(WorldStreamingBenchmark, flyover) (benchmark::State& state) {
+	CameraPath path;
+	path.speed = 96.0f;
+	path.waypoints.push_back(Waypoint{glm::vec3(0.0f, 160.0f, 0.0f), false});
+	path.waypoints.push_back(Waypoint{glm::vec3(1024.0f, 160.0f, 0.0f), false});
+	path.waypoints.push_back(Waypoint{glm::vec3(1024.0f, 160.0f, 1024.0f), false});
+	run(state, path);
+}
+
+BENCHMARK_DEFINE_F(WorldStreamingBenchmark, walk) (benchmark::State& state) {
+	CameraPath path;
+	path.speed = 6.0f;
+	path.waypoints.push_back(Waypoint{glm::vec3(0.0f, 70.0f, 0.0f), false});
+	path.waypoints.push_back(Waypoint{glm::vec3(64.0f, 70.0f, 0.0f), false});
+	path.waypoints.push_back(Waypoint{glm::vec3(64.0f, 70.0f, 64.0f), false});
+	path.waypoints.push_back(Waypoint{glm::vec3(128.0f, 70.0f, 64.0f), false});
+	run(state, path);
+}
+
+BENCHMARK_DEFINE_F(WorldStreamingBenchmark, teleport) (benchmark::State& state) {
+	CameraPath path;
+	path.speed = 0.0f;
+	path.waypoints.push_back(Waypoint{glm::vec3(0.0f, 100.0f, 0.0f), true});
+	path.waypoints.push_back(Waypoint{glm::vec3(4096.0f, 100.0f, 0.0f), true});
+	path.waypoints.push_back(Waypoint{glm::vec3(-4096.0f, 100.0f, 4096.0f), true});
+	path.waypoints.push_back(Waypoint{glm::vec3(8192.0f, 100.0f, -4096.0f), true});
+	run(state, path);
+}
+
+BENCHMARK_REGISTER_F(WorldStreamingBenchmark, flyover)->Arg(1)->Arg(4)->Iterations(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(WorldStreamingBenchmark, walk)->Arg(1)->Arg(4)->Iterations(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_REGISTER_F(WorldStreamingBenchmark, teleport)->Arg(1)->Arg(4)->Iterations(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
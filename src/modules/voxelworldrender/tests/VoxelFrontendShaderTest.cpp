@@ -15,7 +15,8 @@ TEST_P(VoxelFrontendShaderTest, testWorldShader) {
 		return;
 	}
 	shader::WorldShader shader;
-	EXPECT_TRUE(shader.setup());
+	ASSERT_TRUE(shader.setup());
+	EXPECT_TRUE(shader.link());
 	shader.shutdown();
 }
 
@@ -24,7 +25,8 @@ TEST_P(VoxelFrontendShaderTest, testWaterShader) {
 		return;
 	}
 	shader::WaterShader shader;
-	EXPECT_TRUE(shader.setup());
+	ASSERT_TRUE(shader.setup());
+	EXPECT_TRUE(shader.link());
 	shader.shutdown();
 }
 
@@ -27,6 +27,10 @@ void WorldChunkMgr::updateViewDistance(float viewDistance) {
 	_maxAllowedDistance = glm::pow(viewDistance + (float)maxCullingThreshold, 2);
 }
 
+void WorldChunkMgr::setWorldCache(const voxelworld::WorldCachePtr& worldCache) {
+	_meshExtractor.setWorldCache(worldCache);
+}
+
 bool WorldChunkMgr::init(shader::WorldShader* worldShader, voxel::PagedVolume* volume) {
 	_worldShader = worldShader;
 	if (!_meshExtractor.init(volume)) {
@@ -49,6 +53,40 @@ void WorldChunkMgr::reset() {
 	_octree.clear();
 }
 
+bool WorldChunkMgr::uploadMesh(ChunkBuffer& chunkBuffer, const voxel::Mesh& mesh) {
+	core_trace_scoped(WorldRendererUploadMesh);
+	video::Buffer& buffer = chunkBuffer._buffer;
+	chunkBuffer._vbo = buffer.create();
+	if (chunkBuffer._vbo == -1) {
+		Log::error("Failed to create vertex buffer");
+		return false;
+	}
+	const int locationPos = _worldShader->getLocationPos();
+	const video::Attribute& posAttrib = voxelrender::getPositionVertexAttribute(chunkBuffer._vbo, locationPos, _worldShader->getAttributeComponents(locationPos));
+	if (!buffer.addAttribute(posAttrib)) {
+		Log::error("Failed to add position attribute");
+		return false;
+	}
+	const int locationInfo = _worldShader->getLocationInfo();
+	const video::Attribute& infoAttrib = voxelrender::getInfoVertexAttribute(chunkBuffer._vbo, locationInfo, _worldShader->getAttributeComponents(locationInfo));
+	if (!buffer.addAttribute(infoAttrib)) {
+		Log::error("Failed to add info attribute");
+		return false;
+	}
+	chunkBuffer._ibo = buffer.create(nullptr, 0, video::BufferType::IndexBuffer);
+	if (chunkBuffer._ibo == -1) {
+		Log::error("Failed to create index buffer");
+		return false;
+	}
+	chunkBuffer._compressedIndexSize = mesh.compressedIndexSize();
+
+	const voxel::VertexArray& vertices = mesh.getVertexVector();
+	const uint8_t* indices = mesh.compressedIndices();
+	buffer.update(chunkBuffer._vbo, &vertices.front(), vertices.size() * sizeof(voxel::VertexArray::value_type));
+	buffer.update(chunkBuffer._ibo, indices, mesh.getNoOfIndices() * chunkBuffer._compressedIndexSize);
+	return true;
+}
+
 void WorldChunkMgr::handleMeshQueue() {
 	voxel::Mesh mesh;
 	if (!_meshExtractor.pop(mesh)) {
@@ -75,35 +113,9 @@ void WorldChunkMgr::handleMeshQueue() {
 		return;
 	}
 
-	video::Buffer& buffer = freeChunkBuffer->_buffer;
-	freeChunkBuffer->_vbo = buffer.create();
-	if (freeChunkBuffer->_vbo == -1) {
-		Log::error("Failed to create vertex buffer");
+	if (!uploadMesh(*freeChunkBuffer, mesh)) {
 		return;
 	}
-	const int locationPos = _worldShader->getLocationPos();
-	const video::Attribute& posAttrib = voxelrender::getPositionVertexAttribute(freeChunkBuffer->_vbo, locationPos, _worldShader->getAttributeComponents(locationPos));
-	if (!buffer.addAttribute(posAttrib)) {
-		Log::error("Failed to add position attribute");
-		return;
-	}
-	const int locationInfo = _worldShader->getLocationInfo();
-	const video::Attribute& infoAttrib = voxelrender::getInfoVertexAttribute(freeChunkBuffer->_vbo, locationInfo, _worldShader->getAttributeComponents(locationInfo));
-	if (!buffer.addAttribute(infoAttrib)) {
-		Log::error("Failed to add info attribute");
-		return;
-	}
-	freeChunkBuffer->_ibo = buffer.create(nullptr, 0, video::BufferType::IndexBuffer);
-	if (freeChunkBuffer->_ibo == -1) {
-		Log::error("Failed to create index buffer");
-		return;
-	}
-	freeChunkBuffer->_compressedIndexSize = mesh.compressedIndexSize();
-
-	const voxel::VertexArray& vertices = mesh.getVertexVector();
-	const uint8_t* indices = mesh.compressedIndices();
-	buffer.update(freeChunkBuffer->_vbo, &vertices.front(), vertices.size() * sizeof(voxel::VertexArray::value_type));
-	buffer.update(freeChunkBuffer->_ibo, indices, mesh.getNoOfIndices() * freeChunkBuffer->_compressedIndexSize);
 
 	const glm::ivec3& size = _meshExtractor.meshSize();
 	const glm::ivec3& mins = mesh.getOffset();
@@ -152,13 +164,10 @@ void WorldChunkMgr::cull(const video::Camera& camera) {
 	// don't cull objects that might cast shadows
 	aabb.shift(camera.forward() * -10.0f);
 
-	size_t index = 0;
-	Tree::Contents contents;
-	_octree.query(math::AABB<int>(aabb.mins(), aabb.maxs()), contents);
-
-	for (ChunkBuffer* chunkBuffer : contents) {
+	int index = 0;
+	_octree.query(math::AABB<int>(aabb.mins(), aabb.maxs()), [&] (ChunkBuffer* chunkBuffer) {
 		_visibleBuffers.visible[index++] = chunkBuffer;
-	}
+	});
 	_visibleBuffers.size = index;
 }
 
@@ -69,8 +69,13 @@ protected:
 
 	void cull(const video::Camera &camera);
 	void handleMeshQueue();
+	/**
+	 * @brief Uploads the extracted mesh into the buffers of the given chunk buffer
+	 */
+	virtual bool uploadMesh(ChunkBuffer& chunkBuffer, const voxel::Mesh& mesh);
 public:
 	WorldChunkMgr(core::ThreadPool& threadPool);
+	virtual ~WorldChunkMgr() {}
 
 	int renderTerrain();
 
@@ -81,6 +86,10 @@ public:
 	void update(double deltaFrameSeconds, const video::Camera &camera, const glm::vec3& focusPos);
 
 	void updateViewDistance(float viewDistance);
+	/**
+	 * @sa WorldMeshExtractor::setWorldCache()
+	 */
+	void setWorldCache(const voxelworld::WorldCachePtr& worldCache);
 	bool init(shader::WorldShader* worldShader, voxel::PagedVolume* volume);
 	void shutdown();
 	void reset();
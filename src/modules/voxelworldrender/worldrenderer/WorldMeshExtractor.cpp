@@ -19,13 +19,16 @@ bool WorldMeshExtractor::init(voxel::PagedVolume *volume) {
 	return true;
 }
 
+void WorldMeshExtractor::setWorldCache(const voxelworld::WorldCachePtr& worldCache) {
+	_worldCache = worldCache;
+}
+
 void WorldMeshExtractor::shutdown() {
 	_pendingExtraction.clear();
 	_pendingExtraction.abortWait();
-	_extracted.clear();
 	_extracted.abortWait();
-	_positionsExtracted.clear();
 	_extracted.clear();
+	_positionsExtracted.clear();
 	_volume = nullptr;
 }
 
@@ -36,6 +39,7 @@ void WorldMeshExtractor::reset() {
 	_extracted.clear();
 	_positionsExtracted.clear();
 	_pendingExtraction.clear();
+	_scheduledExtractions = (uint32_t)(int)_finishedExtractions;
 }
 
 bool WorldMeshExtractor::pop(voxel::Mesh& item) {
@@ -83,6 +87,7 @@ bool WorldMeshExtractor::scheduleMeshExtraction(const glm::ivec3& p) {
 	}
 	Log::trace("mesh extraction for %i:%i:%i (%i:%i:%i)",
 			p.x, p.y, p.z, pos.x, pos.y, pos.z);
+	++_scheduledExtractions;
 	_pendingExtraction.push(pos);
 	return true;
 }
@@ -102,10 +107,20 @@ void WorldMeshExtractor::extractScheduledMesh() {
 	const int factor = 64;
 	const int vertices = region.getWidthInVoxels() * region.getDepthInVoxels() * factor;
 	voxel::Mesh mesh(vertices, vertices);
-	voxel::extractCubicMesh(_volume, region, &mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
+	// the cached meshes are only valid for the generated voxels - the extraction also looks at the neighbours
+	voxel::Region neighbours(region);
+	neighbours.grow(1);
+	const bool cacheable = _worldCache && !_volume->modified(neighbours);
+	if (!cacheable || !_worldCache->loadMesh(region, mesh)) {
+		voxel::extractCubicMesh(_volume, region, &mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
+		if (cacheable) {
+			_worldCache->storeMesh(region, mesh);
+		}
+	}
 	if (!mesh.isEmpty()) {
 		_extracted.push(std::move(mesh));
 	}
+	++_finishedExtractions;
 }
 
 }
\ No newline at end of file
@@ -7,8 +7,10 @@
 #include "voxel/Mesh.h"
 #include "core/concurrent/ThreadPool.h"
 #include "core/Var.h"
-#include "core/collection/ConcurrentQueue.h"
+#include "core/collection/ConcurrentPriorityQueue.h"
+#include "core/collection/MPMCQueue.h"
 #include "voxel/PagedVolume.h"
+#include "voxelworld/WorldCache.h"
 #include "core/concurrent/Atomic.h"
 
 #include <unordered_set>
@@ -22,7 +24,11 @@ typedef std::unordered_set<glm::ivec3, std::hash<glm::ivec3> > PositionSet;
 
 class WorldMeshExtractor {
 private:
-	core::ConcurrentQueue<voxel::Mesh> _extracted;
+	/**
+	 * @brief The amount of extracted meshes that may wait for @c pop() before the workers block
+	 */
+	static constexpr size_t MaxExtractedMeshes = 256u;
+	core::MPMCQueue<voxel::Mesh> _extracted { MaxExtractedMeshes };
 	glm::ivec3 _pendingExtractionSortPosition { 0, 0, 0 };
 	struct CloseToPoint {
 		glm::ivec2 _refPoint;
@@ -37,11 +43,14 @@ private:
 		}
 	};
 
-	core::ConcurrentQueue<glm::ivec3, CloseToPoint> _pendingExtraction { CloseToPoint(_pendingExtractionSortPosition) };
+	core::ConcurrentPriorityQueue<glm::ivec3, CloseToPoint> _pendingExtraction { CloseToPoint(_pendingExtractionSortPosition) };
 	// fast lookup for positions that are already extracted
 	PositionSet _positionsExtracted;
 	core::VarPtr _meshSize;
 	voxel::PagedVolume *_volume = nullptr;
+	voxelworld::WorldCachePtr _worldCache;
+	uint32_t _scheduledExtractions = 0u;
+	core::AtomicInt _finishedExtractions { 0 };
 
 public:
 	WorldMeshExtractor();
@@ -76,6 +85,21 @@ public:
 
 	void reset();
 
+	/**
+	 * @return The amount of mesh extractions that are waiting for a worker
+	 */
+	size_t pendingExtractions() const;
+
+	/**
+	 * @return The amount of extracted meshes that were not yet fetched by @c pop()
+	 */
+	size_t extractedMeshes() const;
+
+	/**
+	 * @return @c true if all scheduled extractions are done and the extracted meshes were fetched by @c pop()
+	 */
+	bool idle() const;
+
 	/**
 	 * @brief Cuts the given world coordinate down to mesh tile vectors
 	 */
@@ -83,8 +107,26 @@ public:
 
 	glm::ivec3 meshSize() const;
 
+	/**
+	 * @brief Extracted meshes are looked up in and stored to the given cache
+	 * @note Only use this if the volume is not modified after it was generated
+	 */
+	void setWorldCache(const voxelworld::WorldCachePtr& worldCache);
+
 	bool init(voxel::PagedVolume *volume);
 	void shutdown();
 };
 
-}
\ No newline at end of file
+inline size_t WorldMeshExtractor::pendingExtractions() const {
+	return _pendingExtraction.size();
+}
+
+inline size_t WorldMeshExtractor::extractedMeshes() const {
+	return _extracted.size();
+}
+
+inline bool WorldMeshExtractor::idle() const {
+	return (int)_scheduledExtractions <= (int)_finishedExtractions && _extracted.empty();
+}
+
+}
@@ -6,11 +6,13 @@
 #include "core/Color.h"
 #include "video/ScopedLineWidth.h"
 #include "core/collection/Array.h"
+#include "core/TimeProvider.h"
 #include "testcore/TestAppMain.h"
 #include <SDL.h>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/common.hpp>
 
 TestOctree::TestOctree(const metric::MetricPtr& metric, const io::FilesystemPtr& filesystem, const core::EventBusPtr& eventBus, const core::TimeProviderPtr& timeProvider) :
 		Super(metric, filesystem, eventBus, timeProvider) {
@@ -41,7 +43,9 @@ void TestOctree::insert() {
 	for (int i = 0; i < (int)decltype(pos)::length(); ++i) {
 		pos[i] = _random.random(mins[i] + 1, maxs[i] - 1);
 	}
-	if (_octree.insert(Wrapper(pos))) {
+	const Wrapper wrapper(pos, _nextId++);
+	if (_octree.insert(wrapper)) {
+		_items.push_back(wrapper);
 		_dirty = true;
 	} else {
 		Log::info("Failed to add element for %i:%i:%i", pos.x, pos.y, pos.z);
@@ -50,10 +54,42 @@ void TestOctree::insert() {
 
 void TestOctree::clear() {
 	_octree.clear();
+	_items.clear();
 	_results.clear();
 	_dirty = true;
 }
 
+void TestOctree::benchmark() {
+	core_trace_scoped(TestOctreeBenchmark);
+	const double resolution = (double)core::TimeProvider::highResTimeResolution() / 1000.0;
+	const math::AABB<int>& aabb = _octree.aabb();
+	const glm::ivec3 mins = aabb.mins() + 1;
+	const glm::ivec3 maxs = aabb.maxs() - 2;
+
+	// move every item by a small random offset - only those that leave the loose bounds are relocated
+	uint64_t start = core::TimeProvider::highResTime();
+	for (Wrapper& wrapper : _items) {
+		const glm::ivec3 delta(_random.random(-8, 8), _random.random(-8, 8), _random.random(-8, 8));
+		const glm::ivec3 pos = glm::clamp(wrapper.aabb().mins() + delta, mins, maxs);
+		const math::AABB<int> moved(pos, pos + 1);
+		_octree.update(wrapper, moved);
+		wrapper.setAABB(moved);
+	}
+	_updateMillis = (double)(core::TimeProvider::highResTime() - start) / resolution;
+
+	start = core::TimeProvider::highResTime();
+	int found = 0;
+	for (int i = 0; i < 100; ++i) {
+		_octree.query(_queryAABB, [&] (const Wrapper&) {
+			++found;
+		});
+	}
+	_queryMillis = (double)(core::TimeProvider::highResTime() - start) / resolution;
+	Log::info("Updated %i items in %fms, 100 queries in %fms (found: %i)",
+			(int)_items.size(), _updateMillis, _queryMillis, found / 100);
+	_dirty = true;
+}
+
 app::AppState TestOctree::onInit() {
 	app::AppState state = Super::onInit();
 	if (state != app::AppState::Running) {
@@ -149,6 +185,19 @@ void TestOctree::onRenderUI() {
 		insert();
 	}
 	ImGui::Separator();
+	ImGui::InputInt("Items", &_benchmarkItems);
+	ImGui::SameLine();
+	if (ImGui::Button("Insert Items")) {
+		for (int i = 0; i < _benchmarkItems; ++i) {
+			insert();
+		}
+	}
+	if (ImGui::Button("Benchmark")) {
+		benchmark();
+	}
+	ImGui::SameLine();
+	ImGui::Text("Update: %.3fms, Query (x100): %.3fms", _updateMillis, _queryMillis);
+	ImGui::Separator();
 	ImGui::Checkbox("Render AABBs", &_renderAABBs);
 	ImGui::Checkbox("Render Items", &_renderItems);
 	ImGui::Separator();
@@ -16,13 +16,20 @@ private:
 	class Wrapper {
 	private:
 		math::AABB<int> _aabb;
+		int _id;
 	public:
-		Wrapper(const glm::ivec3& pos) :
-				_aabb(pos, pos + 1) {
+		Wrapper(const glm::ivec3& pos, int id) :
+				_aabb(pos, pos + 1), _id(id) {
 		}
 		inline math::AABB<int> aabb() const {
 			return _aabb;
 		}
+		inline void setAABB(const math::AABB<int>& aabb) {
+			_aabb = aabb;
+		}
+		inline bool operator==(const Wrapper& rhs) const {
+			return _id == rhs._id;
+		}
 	};
 
 	using Tree = math::Octree<Wrapper>;
@@ -47,6 +54,12 @@ private:
 	int32_t _queryMeshes = -1;
 
 	std::vector<math::AABB<int> > _itemVector;
+	// the inserted items with their current bounds
+	std::vector<Wrapper> _items;
+	int _nextId = 0;
+	int _benchmarkItems = 1000;
+	double _updateMillis = 0.0;
+	double _queryMillis = 0.0;
 	int _itemIndex = -1;
 	Tree::Contents _results;
 
@@ -57,6 +70,7 @@ private:
 	void handleDirtyState();
 	void clear();
 	void insert();
+	void benchmark();
 	void doRender() override;
 public:
 	TestOctree(const metric::MetricPtr& metric, const io::FilesystemPtr& filesystem, const core::EventBusPtr& eventBus, const core::TimeProviderPtr& timeProvider);
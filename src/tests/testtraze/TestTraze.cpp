@@ -202,8 +202,9 @@ void TestTraze::onEvent(const traze::SpawnEvent& event) {
 void TestTraze::onEvent(const traze::NewGridEvent& event) {
 	core::SharedPtr<voxel::RawVolume> v = event.get();
 	if (_spawnTime > 0.0 && _nowSeconds - _spawnTime < 4.0) {
-		const voxel::Voxel voxel = voxel::createRandomColorVoxel(voxel::VoxelType::Generic);
-		v->setVoxel(glm::ivec3(_spawnPosition.y, 0, _spawnPosition.x), voxel);
+		const glm::ivec3 spawn(_spawnPosition.y, 0, _spawnPosition.x);
+		const voxel::Voxel voxel = voxel::createColorVoxel(voxel::VoxelType::Generic, spawn);
+		v->setVoxel(spawn, voxel);
 		v->setVoxel(glm::ivec3(_spawnPosition.y, 1, _spawnPosition.x), voxel);
 	}
 	voxel::RawVolume* volume = _rawVolumeRenderer.volume(PlayFieldVolume);
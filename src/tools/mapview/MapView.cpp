@@ -23,6 +23,10 @@
 #include "attrib/Attributes.h"
 #include "attrib/ContainerProvider.h"
 #include "audio/SoundManager.h"
+#include "core/StandardLib.h"
+#include "core/StringUtil.h"
+#include "core/concurrent/Concurrency.h"
+#include "image/Image.h"
 #include <SDL.h>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/string_cast.hpp>
@@ -33,11 +37,14 @@ MapView::MapView(const metric::MetricPtr& metric, const animation::AnimationCach
 		const io::FilesystemPtr& filesystem, const core::EventBusPtr& eventBus,
 		const core::TimeProviderPtr& timeProvider, const voxelworld::WorldMgrPtr& worldMgr,
 		const voxelworld::WorldPagerPtr& worldPager,
+		const voxelworld::WorldCachePtr& worldCache,
 		const voxelformat::VolumeCachePtr& volumeCache,
 		const voxelformat::MeshCachePtr& meshCache,
 		const audio::SoundManagerPtr& soundManager) :
 		Super(metric, filesystem, eventBus, timeProvider),
-		_animationCache(animationCache), _worldMgr(worldMgr), _worldPager(worldPager), _movement(soundManager),
+		_animationCache(animationCache), _worldMgr(worldMgr), _worldPager(worldPager), _worldCache(worldCache),
+		_overviewMap(worldPager, core::halfcpus()),
+		_movement(soundManager),
 		_stockDataProvider(stockDataProvider), _volumeCache(volumeCache), _meshCache(meshCache),
 		_camera(_worldRenderer), _soundManager(soundManager) {
 	init(ORGANISATION, "mapview");
@@ -69,6 +76,35 @@ app::AppState MapView::onConstruct() {
 		_lineModeRendering = args[0] == "true";
 	}).setHelp("Toggle line rendering mode");
 
+	command::Command::registerCommand("overviewmap", [&] (const command::CmdArgs& args) {
+		const int zoom = args.size() > 0 ? glm::clamp(core::string::toInt(args[0]), 0, voxelworld::OverviewMap::MaxZoom) : 4;
+		const int tilesPerSide = args.size() > 1 ? core_max(1, core::string::toInt(args[1])) : 4;
+		const glm::vec3& pos = _entity->position();
+		const int halfSize = voxelworld::OverviewMap::voxelsPerTile(zoom) * tilesPerSide / 2;
+		core::DynamicArray<voxelworld::OverviewMap::TilePtr> tiles;
+		const int columns = _overviewMap.tiles(zoom, glm::ivec2(pos.x - halfSize, pos.z - halfSize),
+				glm::ivec2(pos.x + halfSize - 1, pos.z + halfSize - 1), tiles);
+		const int rows = (int)tiles.size() / columns;
+		const int width = columns * voxelworld::OverviewMap::TileSize;
+		const int height = rows * voxelworld::OverviewMap::TileSize;
+		core::DynamicArray<glm::u8vec4> pixels;
+		pixels.resize((size_t)width * height);
+		for (size_t i = 0; i < tiles.size(); ++i) {
+			const int tileX = (int)i % columns * voxelworld::OverviewMap::TileSize;
+			const int tileZ = (int)i / columns * voxelworld::OverviewMap::TileSize;
+			for (int z = 0; z < voxelworld::OverviewMap::TileSize; ++z) {
+				core_memcpy(&pixels[(size_t)(tileZ + z) * width + tileX], &tiles[i]->colors[z * voxelworld::OverviewMap::TileSize],
+						voxelworld::OverviewMap::TileSize * sizeof(glm::u8vec4));
+			}
+		}
+		const core::String& file = filesystem()->homePath() + core::string::format("overviewmap-%i.png", zoom);
+		if (!image::Image::writePng(file.c_str(), (const uint8_t*)pixels.data(), width, height, 4)) {
+			Log::error("Failed to write %s", file.c_str());
+			return;
+		}
+		Log::info("Wrote %s with %i tiles", file.c_str(), (int)tiles.size());
+	}).setHelp("Write a png of the overview map around the current position - parameters: [zoom] [tiles per side]");
+
 	_meshSize = core::Var::get(cfg::VoxelMeshSize, "32", core::CV_READONLY);
 
 	_soundManager->construct();
@@ -146,6 +182,12 @@ app::AppState MapView::onInit() {
 		return app::AppState::InitFailure;
 	}
 
+	if (!_worldCache->init()) {
+		Log::warn("Failed to initialize the world cache");
+	}
+	_worldPager->setWorldCache(_worldCache);
+	_worldRenderer.setWorldCache(_worldCache);
+
 	if (!_worldPager->init(_worldMgr->volumeData(), filesystem()->load("worldparams.lua"), filesystem()->load("biomes.lua"))) {
 		Log::error("Failed to init world pager");
 		return app::AppState::InitFailure;
@@ -154,6 +196,11 @@ app::AppState MapView::onInit() {
 	_worldMgr->setSeed(1);
 	_worldPager->setSeed(1);
 
+	if (!_overviewMap.init()) {
+		Log::error("Failed to init the overview map");
+		return app::AppState::InitFailure;
+	}
+
 	if (!_worldRenderer.init(_worldMgr->volumeData(), glm::ivec2(0), _frameBufferDimension)) {
 		Log::error("Failed to init world renderer");
 		return app::AppState::InitFailure;
@@ -429,8 +476,10 @@ app::AppState MapView::onCleanup() {
 	_camera.shutdown();
 	_entity = frontend::ClientEntityPtr();
 	const app::AppState state = Super::onCleanup();
+	_overviewMap.shutdown();
 	_worldPager->shutdown();
 	_worldMgr->shutdown();
+	_worldCache->shutdown();
 	_floorResolver.shutdown();
 	_meshCache->shutdown();
 	compute::shutdown();
@@ -456,6 +505,7 @@ int main(int argc, char *argv[]) {
 	const voxelformat::VolumeCachePtr& volumeCache = std::make_shared<voxelformat::VolumeCache>();
 	const voxelworld::ChunkPersisterPtr& chunkPersister = std::make_shared<voxelworld::ChunkPersister>();
 	const voxelworld::WorldPagerPtr& worldPager = core::make_shared<voxelworld::WorldPager>(volumeCache, chunkPersister);
+	const voxelworld::WorldCachePtr& worldCache = std::make_shared<voxelworld::WorldCache>();
 	const voxelworld::WorldMgrPtr& worldMgr = std::make_shared<voxelworld::WorldMgr>(worldPager);
 	const io::FilesystemPtr& filesystem = std::make_shared<io::Filesystem>();
 	const core::TimeProviderPtr& timeProvider = std::make_shared<core::TimeProvider>();
@@ -463,6 +513,6 @@ int main(int argc, char *argv[]) {
 	const stock::StockDataProviderPtr& stockDataProvider = std::make_shared<stock::StockDataProvider>();
 	const audio::SoundManagerPtr& soundMgr = core::make_shared<audio::SoundManager>(filesystem);
 	MapView app(metric, animationCache, stockDataProvider, filesystem, eventBus, timeProvider,
-			worldMgr, worldPager, volumeCache, meshCache, soundMgr);
+			worldMgr, worldPager, worldCache, volumeCache, meshCache, soundMgr);
 	return app.startMainLoop(argc, argv);
 }
@@ -20,6 +20,8 @@
 #include "video/Buffer.h"
 #include "voxelworld/WorldMgr.h"
 #include "voxelworld/WorldPager.h"
+#include "voxelworld/WorldCache.h"
+#include "voxelworld/OverviewMap.h"
 #include "stock/Stock.h"
 #include "stock/StockDataProvider.h"
 #include "testcore/DepthBufferRenderer.h"
@@ -36,6 +38,8 @@ protected:
 	voxelworldrender::WorldRenderer _worldRenderer;
 	voxelworld::WorldMgrPtr _worldMgr;
 	voxelworld::WorldPagerPtr _worldPager;
+	voxelworld::WorldCachePtr _worldCache;
+	voxelworld::OverviewMap _overviewMap;
 	render::Axis _axis;
 	core::VarPtr _rotationSpeed;
 	frontend::ClientEntityPtr _entity;
@@ -78,6 +82,7 @@ public:
 			const io::FilesystemPtr& filesystem, const core::EventBusPtr& eventBus,
 			const core::TimeProviderPtr& timeProvider, const voxelworld::WorldMgrPtr& world,
 			const voxelworld::WorldPagerPtr& worldPager,
+			const voxelworld::WorldCachePtr& worldCache,
 			const voxelformat::VolumeCachePtr& volumeCache,
 			const voxelformat::MeshCachePtr& meshCache,
 			const audio::SoundManagerPtr& soundManager);
@@ -25,7 +25,8 @@ static const char *NoiseTypeStr[] = {
 	"voronoi",
 	"swissTurbulence",
 	"jordanTurbulence",
-	"poissonDiskDistribution"
+	"poissonDiskDistribution",
+	"seamless noise"
 };
 static_assert(lengthof(NoiseTypeStr) == (int)NoiseType::Max, "String array size doesn't match noise types");
 
@@ -25,6 +25,7 @@ enum class NoiseType {
 	swissTurbulence,
 	jordanTurbulence,
 	poissonDiskDistribution,
+	seamlessNoise,
 
 	Max
 };
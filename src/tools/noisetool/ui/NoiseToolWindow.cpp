@@ -78,11 +78,11 @@ bool NoiseToolWindow::init() {
 
 void NoiseToolWindow::updateForNoiseType(NoiseType type) {
 	setActive("enabledistance", type == NoiseType::voronoi);
-	setActive("seed", type == NoiseType::voronoi);
+	setActive("seed", type == NoiseType::voronoi || type == NoiseType::seamlessNoise);
 	setActive("separation", type == NoiseType::poissonDiskDistribution);
 	setActive("lacunarity", type == NoiseType::fbm || type == NoiseType::ridgedMFTime || type == NoiseType::ridgedMF || type == NoiseType::worleyNoiseFbm || type == NoiseType::swissTurbulence);
-	setActive("octaves", type == NoiseType::fbm || type == NoiseType::ridgedMFTime || type == NoiseType::ridgedMF || type == NoiseType::iqNoise || type == NoiseType::worleyNoiseFbm || type == NoiseType::swissTurbulence || type == NoiseType::jordanTurbulence);
-	setActive("gain", type == NoiseType::fbm || type == NoiseType::ridgedMFTime || type == NoiseType::ridgedMF || type == NoiseType::iqNoise || type == NoiseType::worleyNoiseFbm || type == NoiseType::swissTurbulence);
+	setActive("octaves", type == NoiseType::fbm || type == NoiseType::ridgedMFTime || type == NoiseType::ridgedMF || type == NoiseType::iqNoise || type == NoiseType::worleyNoiseFbm || type == NoiseType::swissTurbulence || type == NoiseType::jordanTurbulence || type == NoiseType::seamlessNoise);
+	setActive("gain", type == NoiseType::fbm || type == NoiseType::ridgedMFTime || type == NoiseType::ridgedMF || type == NoiseType::iqNoise || type == NoiseType::worleyNoiseFbm || type == NoiseType::swissTurbulence || type == NoiseType::seamlessNoise);
 	setActive("ridgedoffset", type == NoiseType::ridgedMFTime || type == NoiseType::ridgedMF);
 	setActive("offset", true);
 	setActive("frequency", true);
@@ -147,6 +147,7 @@ float NoiseToolWindow::getNoise(int x, int y, const NoiseData& data) {
 		// float gain0, float gain, float warp0, float warp, float damp0, float damp, float damp_scale;
 		return _noise.jordanTurbulence(position, 0.0f, data.octaves, data.lacunarity, data.gain);
 	case NoiseType::poissonDiskDistribution:
+	case NoiseType::seamlessNoise:
 	case NoiseType::Max:
 		break;
 	}
@@ -219,6 +220,11 @@ void NoiseToolWindow::generateImage(NoiseType type) {
 	data.ridgedOffset = getFloat("ridgedoffset");
 	data.noiseType = type;
 
+	if (type == NoiseType::seamlessNoise) {
+		generateSeamlessImage(data);
+		return;
+	}
+
 	_noiseTool->threadPool().enqueue([this, data] () {
 		const size_t noiseBufferSize = _noiseWidth * _noiseHeight * BPP;
 		const size_t graphBufferSize = _noiseWidth * _graphHeight * BPP;
@@ -267,6 +273,44 @@ void NoiseToolWindow::generateImage(NoiseType type) {
 	});
 }
 
+void NoiseToolWindow::generateSeamlessImage(const NoiseData& data) {
+	core_trace_scoped(GenerateSeamlessImage);
+	const size_t noiseBufferSize = _noiseWidth * _noiseHeight * BPP;
+	const size_t graphBufferSize = _noiseWidth * _graphHeight * BPP;
+	QueueData qd;
+	qd.data = data;
+	qd.data.millis = core::TimeProvider::systemMillis();
+	qd.noiseBuffer = new uint8_t[noiseBufferSize];
+	qd.graphBuffer = new uint8_t[graphBufferSize];
+	core_memset(qd.noiseBuffer, 255, noiseBufferSize);
+	core_memcpy(qd.graphBuffer, _graphBufferBackground, graphBufferSize);
+
+	// the texture is square and has three components - the tiles are generated on the
+	// thread pool, so this must not be called from one of its tasks
+	const int components = 3;
+	const int size = core_min(_noiseWidth, _noiseHeight);
+	uint8_t* seamless = new uint8_t[size * size * components];
+	_noise.seamlessNoise(_noiseTool->threadPool(), seamless, size, data.octaves, data.gain, data.frequency, 1.0f, data.seed);
+
+	const int h = _graphHeight - 1;
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			const uint8_t* src = &seamless[(y * size + x) * components];
+			uint8_t* buf = &qd.noiseBuffer[index(x, y)];
+			core_memcpy(buf, src, components);
+			if (y == 0) {
+				const int gy = h - (src[0] * h / 255);
+				uint8_t* gbuf = &qd.graphBuffer[index(x, gy)];
+				*((uint32_t*)gbuf) = core::Color::getRGBA(core::Color::Red);
+			}
+		}
+	}
+	delete[] seamless;
+
+	qd.data.endmillis = core::TimeProvider::systemMillis();
+	_queue.push(qd);
+}
+
 void NoiseToolWindow::update() {
 	QueueData qd;
 	if (!_queue.pop(qd)) {
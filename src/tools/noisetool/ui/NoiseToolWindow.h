@@ -7,7 +7,7 @@
 #include "ui/turbobadger/Window.h"
 #include "ui/turbobadger/ui_widgets.h"
 #include "core/Common.h"
-#include "core/collection/ConcurrentQueue.h"
+#include "core/collection/MPMCQueue.h"
 #include <unordered_map>
 #include "noise/Noise.h"
 #include "../NoiseData.h"
@@ -31,12 +31,8 @@ private:
 		NoiseData data;
 		uint8_t *noiseBuffer;
 		uint8_t *graphBuffer;
-
-		inline bool operator<(const QueueData& rhs) const {
-			return noiseBuffer < rhs.noiseBuffer;
-		}
 	};
-	core::ConcurrentQueue<QueueData> _queue;
+	core::MPMCQueue<QueueData> _queue;
 
 	int _noiseWidth = 768;
 	int _noiseHeight = 1024;
@@ -51,6 +47,10 @@ private:
 	void generateImage();
 	void updateForNoiseType(NoiseType type);
 	void generateImage(NoiseType type);
+	/**
+	 * @brief Generates the seamless noise with the parallel tiles of @c noise::Noise::seamlessNoise()
+	 */
+	void generateSeamlessImage(const NoiseData& data);
 	void generateAll();
 public:
 	NoiseToolWindow(NoiseTool* tool);
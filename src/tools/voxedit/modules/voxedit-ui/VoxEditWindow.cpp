@@ -23,6 +23,7 @@
 #include "voxedit-util/SceneManager.h"
 #include "voxelformat/VolumeFormat.h"
 #include "ui/turbobadger/UIApp.h"
+#include <chrono>
 
 static PaletteWidgetFactory paletteWidget_wf;
 static LayerWidgetFactory layerWidget_wf;
@@ -496,8 +497,20 @@ void VoxEditWindow::updateStatusBar() {
 	}
 }
 
+void VoxEditWindow::updateScreenshot() {
+	if (!_screenshot.valid() || _screenshot.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return;
+	}
+	if (_screenshot.get()) {
+		Log::info("Screenshot created at '%s'", _screenshotFile.c_str());
+	} else {
+		Log::warn("Failed to save screenshot '%s'", _screenshotFile.c_str());
+	}
+}
+
 void VoxEditWindow::update() {
 	updateStatusBar();
+	updateScreenshot();
 	_scene->update();
 	if (_sceneTop != nullptr) {
 		_sceneTop->update();
@@ -1148,11 +1161,16 @@ bool VoxEditWindow::saveScreenshot(const core::String& file) {
 		getApp()->saveDialog([this] (const core::String file) {saveScreenshot(file); }, "png");
 		return true;
 	}
-	if (!_scene->saveImage(file.c_str())) {
+	if (_screenshot.valid()) {
+		Log::warn("Screenshot '%s' is still written", _screenshotFile.c_str());
+		return false;
+	}
+	_screenshot = _scene->saveImage(file.c_str());
+	if (!_screenshot.valid()) {
 		Log::warn("Failed to save screenshot");
 		return false;
 	}
-	Log::info("Screenshot created at '%s'", file.c_str());
+	_screenshotFile = file;
 	return true;
 }
 
@@ -14,6 +14,7 @@
 #include "core/collection/List.h"
 #include "math/Axis.h"
 #include "voxelgenerator/TreeContext.h"
+#include <future>
 
 class Viewport;
 class PaletteWidget;
@@ -118,6 +119,12 @@ private:
 
 	core::String _lastExecutedCommand;
 
+	/**
+	 * @brief The screenshot that is written in the background - the result is reported in update()
+	 */
+	std::future<bool> _screenshot;
+	core::String _screenshotFile;
+
 	tb::TBGenericStringItemSource _treeItems;
 	tb::TBGenericStringItemSource _fileItems;
 	tb::TBGenericStringItemSource _animationItems;
@@ -145,6 +152,7 @@ private:
 	void quit();
 
 	void updateStatusBar();
+	void updateScreenshot();
 
 	void afterLoad(const core::String& file);
 public:
@@ -22,10 +22,10 @@ AbstractViewport::~AbstractViewport() {
 	_edgeShader.shutdown();
 }
 
-bool AbstractViewport::saveImage(const char* filename) {
+std::future<bool> AbstractViewport::saveImage(const char* filename) {
 	core_assert(_texture->format() == video::TextureFormat::RGBA);
 	if (_texture->format() != video::TextureFormat::RGBA) {
-		return false;
+		return std::future<bool>();
 	}
 
 	core_trace_scoped(EditorSceneRenderFramebuffer);
@@ -37,12 +37,13 @@ bool AbstractViewport::saveImage(const char* filename) {
 	if (!video::readTexture(video::TextureUnit::Upload,
 			_texture->type(), _texture->format(), _texture,
 			_texture->width(), _texture->height(), &pixels)) {
-		return false;
+		return std::future<bool>();
 	}
 	image::Image::flipVerticalRGBA(pixels, _texture->width(), _texture->height());
-	const bool val = image::Image::writePng(filename, pixels, _texture->width(), _texture->height(), 4);
+	// the png encoding is done in the background
+	std::future<bool> future = image::Image::writePngAsync(filename, pixels, _texture->width(), _texture->height(), 4);
 	SDL_free(pixels);
-	return val;
+	return future;
 }
 
 void AbstractViewport::resetCamera() {
@@ -8,6 +8,7 @@
 #include "video/FrameBuffer.h"
 #include "ViewportController.h"
 #include "RenderShaders.h"
+#include <future>
 
 namespace voxedit {
 
@@ -34,7 +35,11 @@ public:
 			ViewportController::RenderMode renderMode = ViewportController::RenderMode::Editor);
 	void update();
 	void resetCamera();
-	bool saveImage(const char* filename);
+	/**
+	 * @brief Renders the scene and writes it as png in the background
+	 * @return The result of the write - or an invalid future if the scene couldn't be rendered
+	 */
+	std::future<bool> saveImage(const char* filename);
 
 	video::Camera& camera();
 	ViewportController& controller();
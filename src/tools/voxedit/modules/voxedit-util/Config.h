@@ -13,5 +13,6 @@ constexpr const char *VoxEditDiffuseColor = "ve_diffusecolor";
 constexpr const char *VoxEditLastPalette = "ve_lastpalette";
 constexpr const char *VoxEditModelSpace = "ve_modelspace";
 constexpr const char *VoxEditCameraZoomSpeed = "ve_camzoomspeed";
+constexpr const char *VoxEditTraceReuse = "ve_tracereuse";
 
 }
@@ -52,6 +52,7 @@
 #include "attrib/ShadowAttributes.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtc/epsilon.hpp>
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtx/transform.hpp>
 
@@ -345,6 +346,7 @@ void SceneManager::modified(int layerId, const voxel::Region& modifiedRegion, bo
 	}
 	if (modifiedRegion.isValid()) {
 		queueRegionExtraction(layerId, modifiedRegion);
+		_occupancyBricks[layerId].markDirty(modifiedRegion);
 	}
 	_dirty = true;
 	_needAutoSave = true;
@@ -554,6 +556,7 @@ void SceneManager::resetSceneState() {
 	_mementoHandler.markUndo(layerId, _layerMgr.layer(layerId).name, _volumeRenderer.volume(layerId));
 	_dirty = false;
 	_result = voxel::PickResult();
+	_lastTraceVolume = nullptr;
 	setCursorPosition(cursorPosition(), true);
 	resetLastTrace();
 }
@@ -606,6 +609,7 @@ bool SceneManager::setNewVolume(int idx, voxel::RawVolume* volume, bool deleteMe
 	}
 	const voxel::Region& region = volume->region();
 	delete _volumeRenderer.setVolume(idx, volume, deleteMesh);
+	_occupancyBricks[idx].clear();
 
 	updateAABBMesh();
 	if (volume != nullptr) {
@@ -616,6 +620,7 @@ bool SceneManager::setNewVolume(int idx, voxel::RawVolume* volume, bool deleteMe
 
 	_dirty = false;
 	_result = voxel::PickResult();
+	_lastTraceVolume = nullptr;
 	setCursorPosition(cursorPosition(), true);
 	glm::ivec3 center = region.getCenter();
 	center.y = region.getLowerY();
@@ -881,6 +886,7 @@ void SceneManager::construct() {
 
 	core::Var::get(cfg::VoxEditLastPalette, "nippon");
 	_modelSpace = core::Var::get(cfg::VoxEditModelSpace, "1");
+	_traceReuse = core::Var::get(cfg::VoxEditTraceReuse, "1", -1, "Reuse the last mouse trace result if neither the ray nor the volume changed");
 
 	for (int i = 0; i < lengthof(DIRECTIONS); ++i) {
 		command::Command::registerActionButton(
@@ -1806,6 +1812,27 @@ void SceneManager::setCursorPosition(glm::ivec3 pos, bool force) {
 	updateLockedPlane(math::Axis::Z);
 }
 
+bool SceneManager::canReuseLastTrace(const voxel::RawVolume* model, const glm::vec3& origin, const glm::vec3& dirWithLength) const {
+	if (!_traceReuse->boolVal()) {
+		return false;
+	}
+	// the locked axis trace depends on the cursor position
+	if (_lockedAxis != math::Axis::None) {
+		return false;
+	}
+	if (_lastTraceVolume != model) {
+		return false;
+	}
+	const int layerId = _layerMgr.activeLayer();
+	if (_lastTraceGeneration != _occupancyBricks[layerId].generation()) {
+		return false;
+	}
+	if (glm::any(glm::epsilonNotEqual(_lastTraceOrigin, origin, 0.0001f))) {
+		return false;
+	}
+	return glm::all(glm::epsilonEqual(_lastTraceDirection, dirWithLength, 0.0001f));
+}
+
 bool SceneManager::trace(bool force) {
 	if (!_traceViaMouse) {
 		return false;
@@ -1816,78 +1843,118 @@ bool SceneManager::trace(bool force) {
 	if (_camera == nullptr) {
 		return false;
 	}
-	const voxel::RawVolume* model = modelVolume();
+	const int layerId = _layerMgr.activeLayer();
+	const voxel::RawVolume* model = volume(layerId);
 	if (model == nullptr) {
 		return false;
 	}
 
-	Log::debug("Execute new trace for %i:%i (%i:%i)",
-			_mouseCursor.x, _mouseCursor.y, _lastRaytraceX, _lastRaytraceY);
-
 	core_trace_scoped(EditorSceneOnProcessUpdateRay);
 	_lastRaytraceX = _mouseCursor.x;
 	_lastRaytraceY = _mouseCursor.y;
 
+	voxel::OccupancyBricks& bricks = _occupancyBricks[layerId];
+	bricks.sync(model);
+
 	const video::Ray& ray = _camera->mouseRay(_mouseCursor);
 	const glm::vec3& dirWithLength = ray.direction * _camera->farPlane();
-	static constexpr voxel::Voxel air;
-
-	_result.didHit = false;
-	_result.validPreviousPosition = false;
-	_result.firstValidPosition = false;
-	_result.direction = ray.direction;
-	_result.hitFace = voxel::FaceNames::Max;
-	raycastWithDirection(model, ray.origin, dirWithLength, [&] (voxel::RawVolume::Sampler& sampler) {
-		if (!_result.firstValidPosition && sampler.currentPositionValid()) {
-			_result.firstPosition = sampler.position();
-			_result.firstValidPosition = true;
-		}
-
-		if (sampler.voxel() != air) {
-			_result.didHit = true;
-			_result.hitVoxel = sampler.position();
-			const glm::ivec3& dir = glm::ivec3(ray.origin) - _result.hitVoxel;
-			if (dir.x < 0) {
-				_result.hitFace = voxel::FaceNames::NegativeX;
-			} else if (dir.x > 0) {
-				_result.hitFace = voxel::FaceNames::PositiveX;
-			} else if (dir.y < 0) {
-				_result.hitFace = voxel::FaceNames::NegativeY;
-			} else if (dir.y > 0) {
-				_result.hitFace = voxel::FaceNames::PositiveY;
-			} else if (dir.z < 0) {
-				_result.hitFace = voxel::FaceNames::NegativeZ;
-			} else if (dir.z > 0) {
-				_result.hitFace = voxel::FaceNames::PositiveZ;
+
+	if (canReuseLastTrace(model, ray.origin, dirWithLength)) {
+		Log::debug("Reuse the last trace for %i:%i", _mouseCursor.x, _mouseCursor.y);
+	} else {
+		Log::debug("Execute new trace for %i:%i", _mouseCursor.x, _mouseCursor.y);
+		_lastTraceOrigin = ray.origin;
+		_lastTraceDirection = dirWithLength;
+		_lastTraceGeneration = bricks.generation();
+		_lastTraceVolume = model;
+
+		_result.didHit = false;
+		_result.validPreviousPosition = false;
+		_result.firstValidPosition = false;
+		_result.direction = ray.direction;
+		_result.hitFace = voxel::FaceNames::Max;
+
+		const voxel::Region& region = model->region();
+		// handles a voxel that is known to be air - returns false if the trace should end
+		auto visitAir = [&] (const glm::ivec3& pos, bool validPosition) {
+			if (!validPosition) {
+				return true;
+			}
+			if (!_result.firstValidPosition) {
+				_result.firstPosition = pos;
+				_result.firstValidPosition = true;
 			}
-			return false;
-		}
-		if (sampler.currentPositionValid()) {
 			// while having an axis locked, we should end the trace if we hit the plane
 			if (_lockedAxis != math::Axis::None) {
 				const glm::ivec3& cursorPos = cursorPosition();
 				if ((_lockedAxis & math::Axis::X) != math::Axis::None) {
-					if (sampler.position()[0] == cursorPos[0]) {
+					if (pos[0] == cursorPos[0]) {
 						return false;
 					}
 				}
 				if ((_lockedAxis & math::Axis::Y) != math::Axis::None) {
-					if (sampler.position()[1] == cursorPos[1]) {
+					if (pos[1] == cursorPos[1]) {
 						return false;
 					}
 				}
 				if ((_lockedAxis & math::Axis::Z) != math::Axis::None) {
-					if (sampler.position()[2] == cursorPos[2]) {
+					if (pos[2] == cursorPos[2]) {
 						return false;
 					}
 				}
 			}
 
 			_result.validPreviousPosition = true;
-			_result.previousPosition = sampler.position();
+			_result.previousPosition = pos;
+			return true;
+		};
+
+		static constexpr voxel::Voxel air;
+		auto visitVoxel = [&] (voxel::RawVolume::Sampler& sampler) {
+			if (sampler.voxel() != air) {
+				if (!_result.firstValidPosition && sampler.currentPositionValid()) {
+					_result.firstPosition = sampler.position();
+					_result.firstValidPosition = true;
+				}
+				_result.didHit = true;
+				_result.hitVoxel = sampler.position();
+				const glm::ivec3& dir = glm::ivec3(ray.origin) - _result.hitVoxel;
+				if (dir.x < 0) {
+					_result.hitFace = voxel::FaceNames::NegativeX;
+				} else if (dir.x > 0) {
+					_result.hitFace = voxel::FaceNames::PositiveX;
+				} else if (dir.y < 0) {
+					_result.hitFace = voxel::FaceNames::NegativeY;
+				} else if (dir.y > 0) {
+					_result.hitFace = voxel::FaceNames::PositiveY;
+				} else if (dir.z < 0) {
+					_result.hitFace = voxel::FaceNames::NegativeZ;
+				} else if (dir.z > 0) {
+					_result.hitFace = voxel::FaceNames::PositiveZ;
+				}
+				return false;
+			}
+			return visitAir(sampler.position(), sampler.currentPositionValid());
+		};
+		if (_lockedAxis != math::Axis::None) {
+			// the locked axis plane check needs every single voxel along the ray
+			voxel::raycastWithDirection(model, ray.origin, dirWithLength, visitVoxel);
+		} else {
+			raycastWithDirection(model, bricks, ray.origin, dirWithLength, visitVoxel, [&] (const glm::ivec3& first, const glm::ivec3& last) {
+				// a span of empty voxels is either completely inside or completely outside of the region
+				if (!region.containsPoint(first)) {
+					return true;
+				}
+				if (!_result.firstValidPosition) {
+					_result.firstPosition = first;
+					_result.firstValidPosition = true;
+				}
+				_result.validPreviousPosition = true;
+				_result.previousPosition = last;
+				return true;
+			});
 		}
-		return true;
-	});
+	}
 
 	if (_modifier.modifierTypeRequiresExistingVoxel()) {
 		if (_result.didHit) {
@@ -1957,6 +2024,8 @@ void SceneManager::onLayerSwapped(int layerId1, int layerId2) {
 	if (!_volumeRenderer.swap(layerId1, layerId2)) {
 		Log::error("Failed to swap volumes for layer %i and layer %i", layerId1, layerId2);
 	}
+	_occupancyBricks[layerId1].clear();
+	_occupancyBricks[layerId2].clear();
 }
 
 void SceneManager::onLayerHide(int layerId) {
@@ -2024,6 +2093,7 @@ void SceneManager::onLayerAdded(int layerId, const Layer& layer, voxel::RawVolum
 
 void SceneManager::onLayerDeleted(int layerId, const Layer& layer) {
 	voxel::RawVolume* v = _volumeRenderer.setVolume(layerId, nullptr);
+	_occupancyBricks[layerId].clear();
 	if (v != nullptr) {
 		Log::debug("Deleted layer %i with name %s", layerId, layer.name.c_str());
 		// Add two states here - one with the filled layer and one with the empty layer.
@@ -7,6 +7,7 @@
 #include "animation/AnimationSystem.h"
 #include "core/collection/DynamicArray.h"
 #include "voxelutil/Picking.h"
+#include "voxelutil/OccupancyBricks.h"
 #include "voxel/RawVolume.h"
 #include "voxelgenerator/TreeContext.h"
 #include "voxelgenerator/LSystem.h"
@@ -111,6 +112,7 @@ private:
 	core::VarPtr _diffuseColor;
 	core::VarPtr _cameraZoomSpeed;
 	core::VarPtr _modelSpace;
+	core::VarPtr _traceReuse;
 
 	math::Axis _lockedAxis = math::Axis::None;
 
@@ -139,6 +141,17 @@ private:
 	int _lastRaytraceX = -1;
 	int _lastRaytraceY = -1;
 
+	/**
+	 * coarse occupancy information per layer to skip empty areas while tracing the mouse ray
+	 */
+	voxel::OccupancyBricks _occupancyBricks[voxelrender::RawVolumeRenderer::MAX_VOLUMES];
+	// the state of the last executed trace to be able to reuse the result if nothing changed
+	glm::vec3 _lastTraceOrigin { 0.0f };
+	glm::vec3 _lastTraceDirection { 0.0f };
+	uint32_t _lastTraceGeneration = 0u;
+	const voxel::RawVolume* _lastTraceVolume = nullptr;
+	bool canReuseLastTrace(const voxel::RawVolume* model, const glm::vec3& origin, const glm::vec3& dirWithLength) const;
+
 	// layer animation speed
 	double _animationSpeed = 0.0;
 	int _currentAnimationLayer = 0;
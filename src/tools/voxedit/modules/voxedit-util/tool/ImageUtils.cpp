@@ -41,9 +41,9 @@ void importHeightmap(voxel::RawVolumeWrapper& volume, const image::ImagePtr& ima
 				}
 				voxel::Voxel voxel;
 				if (y < pixelValue) {
-					voxel = voxel::createRandomColorVoxel(voxel::VoxelType::Dirt);
+					voxel = voxel::createColorVoxel(voxel::VoxelType::Dirt, regionPos);
 				} else if (y == pixelValue) {
-					voxel = voxel::createRandomColorVoxel(voxel::VoxelType::Grass);
+					voxel = voxel::createColorVoxel(voxel::VoxelType::Grass, regionPos);
 				}
 				volume.setVoxel(regionPos, voxel);
 			}